@@ -10,6 +10,9 @@
  */
 #include "cluster_config.h"
 
+#include "sendbuffer.h"
+
+#include <platform/compress.h>
 #include <subdoc/operations.h>
 
 #include <nlohmann/json.hpp>
@@ -29,26 +32,53 @@ std::ostream& operator<<(std::ostream& os, const ClustermapVersion& version) {
     return os;
 }
 
+/// @return the Snappy compressed copy of config, or an empty string if the
+///         configuration is too small to bother or doesn't compress
+static std::string compressConfig(std::string_view config) {
+    if (config.size() <= SendBuffer::MinimumDataSize) {
+        return {};
+    }
+    cb::compression::Buffer deflated;
+    if (!cb::compression::deflate(
+                cb::compression::Algorithm::Snappy, config, deflated) ||
+        deflated.size() >= config.size()) {
+        return {};
+    }
+    return std::string(deflated.data(), deflated.size());
+}
+
+ClusterConfiguration::Configuration::Configuration(ClustermapVersion version,
+                                                   std::string_view config)
+    : version(version), config(config), compressed(compressConfig(config)) {
+}
+
+std::pair<std::string_view, protocol_binary_datatype_t>
+ClusterConfiguration::Configuration::getPayload(bool snappy) const {
+    if (snappy && !compressed.empty()) {
+        return {compressed,
+                protocol_binary_datatype_t(PROTOCOL_BINARY_DATATYPE_JSON |
+                                           PROTOCOL_BINARY_DATATYPE_SNAPPY)};
+    }
+    return {config, PROTOCOL_BINARY_DATATYPE_JSON};
+}
+
 void ClusterConfiguration::reset() {
     config.lock()->reset();
 }
 
 void ClusterConfiguration::setConfiguration(
-        std::unique_ptr<Configuration> configuration) {
+        std::shared_ptr<const Configuration> configuration) {
     *config.lock() = std::move(configuration);
 }
 
-std::unique_ptr<ClusterConfiguration::Configuration>
+std::shared_ptr<const ClusterConfiguration::Configuration>
 ClusterConfiguration::maybeGetConfiguration(const ClustermapVersion& version,
                                             bool dedupe) const {
-    auto locked = config.lock();
-    if (!*locked) {
-        return {};
-    }
-
-    auto& active = *locked->get();
-    if (version < active.version || !dedupe) {
-        return std::make_unique<Configuration>(active.version, active.config);
+    // Only a reference is taken under the lock; the configuration itself is
+    // immutable so it may be read (and sent) after the lock is released.
+    auto active = *config.lock();
+    if (active && (version < active->version || !dedupe)) {
+        return active;
     }
 
     return {};
@@ -11,11 +11,14 @@
 #pragma once
 
 #include <folly/Synchronized.h>
+#include <memcached/protocol_binary.h>
 #include <nlohmann/json_fwd.hpp>
 #include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <utility>
 
 class Connection;
 
@@ -60,21 +63,40 @@ protected:
 
 /**
  * A class to hold a cluster configuration object for a given bucket.
+ *
+ * The configuration is immutable once set, and shared (reference counted)
+ * by everyone sending it to clients. During a rebalance every client gets
+ * the map in Not My VBucket responses, so it isn't copied for each of them:
+ * the payload may be chained to the connection's output stream as is (see
+ * ClustermapSendBuffer).
  */
 class ClusterConfiguration {
 public:
     struct Configuration {
-        Configuration(ClustermapVersion version, std::string_view config)
-            : version(version), config(config) {
-        }
+        Configuration(ClustermapVersion version, std::string_view config);
+
+        /**
+         * Get the payload to send to a client
+         *
+         * @param snappy if the client has enabled Snappy
+         * @return the payload (the Snappy compressed copy of the
+         *         configuration if the client has enabled Snappy and
+         *         compressing it is worthwhile) and its datatype
+         */
+        std::pair<std::string_view, protocol_binary_datatype_t> getPayload(
+                bool snappy) const;
+
         const ClustermapVersion version;
         const std::string config;
+        /// Snappy compressed copy of config (built once when the
+        /// configuration is set), or empty if it isn't worth compressing
+        const std::string compressed;
     };
 
-    void setConfiguration(std::unique_ptr<Configuration> configuration);
+    void setConfiguration(std::shared_ptr<const Configuration> configuration);
 
     /// Get the configuration if it is newer than the provided version
-    std::unique_ptr<Configuration> maybeGetConfiguration(
+    std::shared_ptr<const Configuration> maybeGetConfiguration(
             const ClustermapVersion& version, bool dedupe = true) const;
 
     /**
@@ -84,7 +106,8 @@ public:
     void reset();
 
 protected:
-    folly::Synchronized<std::unique_ptr<Configuration>, std::mutex> config;
+    folly::Synchronized<std::shared_ptr<const Configuration>, std::mutex>
+            config;
 };
 
 std::string to_string(const ClustermapVersion& version);
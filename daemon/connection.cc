@@ -874,6 +874,7 @@ bool Connection::executeCommandsCallback() {
     const auto stop = std::chrono::steady_clock::now();
     const auto ns = duration_cast<nanoseconds>(stop - start);
     scheduler_info[getThread().index].add(duration_cast<microseconds>(ns));
+    getThread().addBusyTime(ns);
     addCpuTime(ns);
 
     if (state != State::running) {
@@ -1251,22 +1252,60 @@ void Connection::copyToOutputStream(std::string_view data) {
         return;
     }
 
-    if (bufferevent_write(bev.get(), data.data(), data.size()) == -1) {
-        throw std::bad_alloc();
-    }
-
-    updateSendBytes(data.size());
+    std::array<std::string_view, 1> fragments{{data}};
+    copyToOutputStream(fragments);
 }
 
 void Connection::copyToOutputStream(gsl::span<std::string_view> data) {
-    size_t nb = 0;
+    const auto nb = copyToOutputBuffer(
+            *bufferevent_get_output(bev.get()), data, outputChunkSpace);
+    updateSendBytes(nb);
+}
+
+std::size_t Connection::copyToOutputBuffer(evbuffer& output,
+                                           gsl::span<std::string_view> data,
+                                           std::size_t& chunkSpace) {
+    std::size_t nb = 0;
     for (const auto& d : data) {
-        if (bufferevent_write(bev.get(), d.data(), d.size()) == -1) {
-            throw std::bad_alloc();
-        }
         nb += d.size();
     }
-    updateSendBytes(nb);
+    if (nb == 0) {
+        return 0;
+    }
+
+    if (nb > OutputChunkSize) {
+        // Gets a chain of its own anyway
+        for (const auto& d : data) {
+            if (evbuffer_add(&output, d.data(), d.size()) == -1) {
+                throw std::bad_alloc();
+            }
+        }
+        chunkSpace = 0;
+        return nb;
+    }
+
+    // libevent sizes a new chain for the reservation, so reserve a whole
+    // chunk unless the fragments fit in the current one. The hint may be
+    // stale (the buffer was drained, or appended to elsewhere); then libevent
+    // allocates a chain just for the fragments, and the hint corrects itself.
+    evbuffer_iovec vec{};
+    const auto reserve = chunkSpace >= nb ? nb : OutputChunkSize;
+    if (evbuffer_reserve_space(&output, reserve, &vec, 1) != 1) {
+        throw std::bad_alloc();
+    }
+    // The reservation spans all the free space of the chain
+    chunkSpace = vec.iov_len - nb;
+
+    auto* dest = static_cast<char*>(vec.iov_base);
+    for (const auto& d : data) {
+        std::copy(d.begin(), d.end(), dest);
+        dest += d.size();
+    }
+    vec.iov_len = nb;
+    if (evbuffer_commit_space(&output, &vec, 1) == -1) {
+        throw std::bad_alloc();
+    }
+    return nb;
 }
 
 static void sendbuffer_cleanup_cb(const void*, size_t, void* extra) {
@@ -1292,6 +1331,8 @@ void Connection::chainDataToOutputStream(std::unique_ptr<SendBuffer> buffer) {
     // (sendbuffer_cleanup_cb) will free the memory.
     // Move the ownership of the buffer!
     (void)buffer.release();
+    // Copies after this go in a new chain
+    outputChunkSpace = 0;
     updateSendBytes(data.size());
 }
 
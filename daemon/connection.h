@@ -361,12 +361,41 @@ public:
     /**
      * Copy the provided data to the end of the output stream.
      *
+     * The fragments are copied into the output stream with a single
+     * (contiguous) reservation, packed into chunks of at least
+     * OutputChunkSize bytes; see copyToOutputBuffer().
+     *
      * @param data The data to send
      * @throws std::bad_alloc if we failed to insert the data into the output
      *                        stream.
      */
     void copyToOutputStream(gsl::span<std::string_view> data);
 
+    /**
+     * The size of the chunks (evbuffer chains) small responses are packed
+     * into in the output stream. Larger chunks mean fewer allocations, and
+     * fewer iovecs for libevent to writev() when flushing the stream.
+     */
+    static constexpr std::size_t OutputChunkSize = 16 * 1024;
+
+    /**
+     * Copy the fragments to the end of the output buffer. Unless larger than
+     * OutputChunkSize, the fragments are copied into the free space of the
+     * last chain of the buffer if they fit, otherwise into a new chain of
+     * OutputChunkSize bytes (which the following responses are packed into)
+     * with a single reserve / commit, instead of one evbuffer_add each.
+     *
+     * @param output The buffer to append to
+     * @param data The data to append
+     * @param chunkSpace A hint of the free space in the last chain of the
+     *        buffer; updated by the call
+     * @return the number of bytes appended
+     * @throws std::bad_alloc if we failed to insert the data into the buffer
+     */
+    static std::size_t copyToOutputBuffer(evbuffer& output,
+                                          gsl::span<std::string_view> data,
+                                          std::size_t& chunkSpace);
+
     /**
      * Copy the provided data to the end of the output stream.
      *
@@ -962,6 +991,9 @@ protected:
 
     /// The bufferevent structure for the object
     cb::libevent::unique_bufferevent_ptr bev;
+    /// A hint of the free space in the last chain of the output buffer (see
+    /// copyToOutputBuffer)
+    std::size_t outputChunkSpace = 0;
     /// Total number of bytes received on the network
     size_t totalRecv = 0;
     /// Total number of bytes sent to the network
@@ -104,6 +104,7 @@ void conn_destroy(Connection* c) {
         cb_assert(iter != conns.end());
         conns.erase(iter);
     });
+    --c->getThread().numConnections;
     // Finally free it
     delete c;
 }
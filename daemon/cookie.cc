@@ -20,6 +20,7 @@
 #include "mcbp_executors.h"
 #include "memcached.h"
 #include "opentelemetry.h"
+#include "sendbuffer.h"
 #include "settings.h"
 
 #include <logger/logger.h>
@@ -242,13 +243,20 @@ void Cookie::sendNotMyVBucket() {
                     pushed, Settings::instance().isDedupeNmvbMaps());
 
     if (config) {
+        const auto [payload, datatype] =
+                config->getPayload(connection.isSnappyEnabled());
+        std::unique_ptr<SendBuffer> sendbuffer;
+        if (payload.size() > SendBuffer::MinimumDataSize) {
+            sendbuffer =
+                    std::make_unique<ClustermapSendBuffer>(config, payload);
+        }
         connection.sendResponse(*this,
                                 cb::mcbp::Status::NotMyVbucket,
                                 {},
                                 {},
-                                {config->config.data(), config->config.size()},
-                                PROTOCOL_BINARY_DATATYPE_JSON,
-                                {});
+                                payload,
+                                datatype,
+                                std::move(sendbuffer));
         connection.setPushedClustermapRevno(config->version);
     } else {
         // We don't have a vbucket map, or we've already sent it to the
@@ -334,8 +342,12 @@ const DocKey Cookie::getRequestKey() const {
 
 std::string Cookie::getPrintableRequestKey() const {
     const auto key = getRequest().getKey();
+    return getPrintableKey(
+            {reinterpret_cast<const char*>(key.data()), key.size()});
+}
 
-    std::string buffer{reinterpret_cast<const char*>(key.data()), key.size()};
+std::string Cookie::getPrintableKey(std::string_view key) {
+    std::string buffer{key};
     for (auto& ii : buffer) {
         if (!std::isgraph(ii)) {
             ii = '.';
@@ -261,6 +261,12 @@ public:
      */
     std::string getPrintableRequestKey() const;
 
+    /**
+     * Get a printable (and tagged as user data) copy of a key. Replace all
+     * non-printable charachters with '.'
+     */
+    static std::string getPrintableKey(std::string_view key);
+
     /**
      * Get a printable representation of the key's collection ID
      */
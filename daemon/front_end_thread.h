@@ -22,6 +22,8 @@
 #include <subdoc/operations.h>
 #include <array>
 #include <atomic>
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <queue>
@@ -48,17 +50,54 @@ struct FrontEndThread {
     folly::EventBase eventBase;
 
     /**
-     * Dispatches a new connection to the worker thread by using round
-     * robin.
+     * Dispatches a new connection to a worker thread picked by the
+     * connection_placement policy.
      *
      * @param sfd the socket to use
      * @param descr The description of the port it is listening to
      * @param ssl the OpenSSL SSL structure to use (if this is a connection
      *            using SSL)
+     * @param acceptor the thread which accepted the connection (if it was
+     *                 accepted by a per thread listening socket) which
+     *                 keeps the connection with round robin placement
      */
     static void dispatch(SOCKET sfd,
                          std::shared_ptr<ListeningPort> descr,
-                         uniqueSslPtr ssl);
+                         uniqueSslPtr ssl,
+                         FrontEndThread* acceptor = nullptr);
+
+    /// Call the callback for each of the front end threads
+    static void forEach(std::function<void(FrontEndThread&)> callback);
+
+    /**
+     * Get the load of the thread used by the least_loaded connection
+     * placement: the number of connections it serves, where each
+     * connection counts for up to two if the thread was busy serving
+     * connections for the entire last sampling interval.
+     */
+    double getLoad() const {
+        return numConnections.load(std::memory_order_relaxed) *
+               (1.0 + busyFraction.load(std::memory_order_relaxed));
+    }
+
+    /// Account time spent serving a connection
+    void addBusyTime(std::chrono::nanoseconds ns) {
+        busyTime.fetch_add(ns.count(), std::memory_order_relaxed);
+    }
+
+    /**
+     * Update busyFraction from the busy time accounted since the previous
+     * sample (called for all threads by one dispatcher at a time, every
+     * BusySampleInterval)
+     */
+    void sampleBusyTime(std::chrono::steady_clock::time_point now);
+
+    /**
+     * The number of connections served by (or dispatched to) this thread.
+     * Incremented by dispatch() and decremented when the connection is
+     * destroyed.
+     */
+    std::atomic<size_t> numConnections{0};
 
     /// Mutex to lock protect access to this object.
     std::mutex mutex;
@@ -103,6 +142,16 @@ struct FrontEndThread {
 protected:
     void dispatch_new_connections();
 
+    /// Nanoseconds spent serving connections since the thread started
+    std::atomic<uint64_t> busyTime{0};
+
+    /// The fraction of the last sampling interval spent serving connections
+    std::atomic<double> busyFraction{0};
+
+    /// busyTime and the time of the previous sample
+    uint64_t lastBusyTime = 0;
+    std::chrono::steady_clock::time_point lastBusySample;
+
     /**
      * The dispatcher accepts new clients and needs to dispatch them
      * to the worker threads. In order to do so we use the ConnectionQueue
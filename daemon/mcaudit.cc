@@ -338,6 +338,10 @@ void addSessionTerminated(const Connection& c) {
 namespace document {
 
 void add(Cookie& cookie, Operation operation) {
+    add(cookie, operation, cookie.getRequestKey());
+}
+
+void add(Cookie& cookie, Operation operation, const DocKey& key) {
     uint32_t id = 0;
     switch (operation) {
     case Operation::Read:
@@ -367,8 +371,9 @@ void add(Cookie& cookie, Operation operation) {
     auto root = create_memcached_audit_object(
             connection, connection.getUser(), cookie.getEffectiveUser());
     root["bucket"] = connection.getBucket().name;
-    root["collection_id"] = cookie.getPrintableRequestCollectionID();
-    root["key"] = cookie.getPrintableRequestKey();
+    root["collection_id"] = key.getCollectionID().to_string();
+    root["key"] = Cookie::getPrintableKey(
+            {reinterpret_cast<const char*>(key.data()), key.size()});
 
     switch (operation) {
     case Operation::Read:
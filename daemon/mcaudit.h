@@ -20,6 +20,7 @@
 class Cookie;
 class Connection;
 class StatCollector;
+struct DocKey;
 
 /**
  * Send an audit event for an authentication failure
@@ -122,6 +123,10 @@ namespace document {
 enum class Operation;
 
 void add(Cookie& c, Operation operation);
+
+/// Add a document audit event for the provided key (for commands which
+/// operate on other keys than the one in the key field of the request)
+void add(Cookie& c, Operation operation, const DocKey& key);
 } // namespace document
 } // namespace cb::audit
 
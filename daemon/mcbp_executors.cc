@@ -33,6 +33,7 @@
 #include "protocol/mcbp/get_context.h"
 #include "protocol/mcbp/get_locked_context.h"
 #include "protocol/mcbp/get_meta_context.h"
+#include "protocol/mcbp/get_multi_context.h"
 #include "protocol/mcbp/ifconfig_context.h"
 #include "protocol/mcbp/mutation_context.h"
 #include "protocol/mcbp/rbac_reload_command_context.h"
@@ -61,6 +62,10 @@ static void process_bin_get_meta(Cookie& cookie) {
     cookie.obtainContext<GetMetaCommandContext>(cookie).drive();
 }
 
+static void get_multi_executor(Cookie& cookie) {
+    cookie.obtainContext<GetMultiCommandContext>(cookie).drive();
+}
+
 static void get_locked_executor(Cookie& cookie) {
     cookie.obtainContext<GetLockedCommandContext>(cookie).drive();
 }
@@ -738,6 +743,7 @@ void initialize_mbcp_lookup_map() {
     setup_handler(cb::mcbp::ClientOpcode::SelectBucket, select_bucket_executor);
     setup_handler(cb::mcbp::ClientOpcode::GetErrorMap, get_errmap_executor);
     setup_handler(cb::mcbp::ClientOpcode::GetLocked, get_locked_executor);
+    setup_handler(cb::mcbp::ClientOpcode::GetMulti, get_multi_executor);
     setup_handler(cb::mcbp::ClientOpcode::UnlockKey, unlock_executor);
     setup_handler(cb::mcbp::ClientOpcode::GetFailoverLog,
                   dcp_get_failover_log_executor);
@@ -183,6 +183,9 @@ McbpPrivilegeChains::McbpPrivilegeChains() {
           require<Privilege::NodeManagement>);
     setup(cb::mcbp::ClientOpcode::SetParam, require<Privilege::NodeManagement>);
     setup(cb::mcbp::ClientOpcode::GetReplica, require<Privilege::Read>);
+    // GetMulti may operate on multiple collections so the privileges are
+    // checked for each key as part of executing the command
+    setup(cb::mcbp::ClientOpcode::GetMulti, empty);
 
     /* Bucket engine */
     setup(cb::mcbp::ClientOpcode::CreateBucket,
@@ -266,6 +269,12 @@ McbpPrivilegeChains::McbpPrivilegeChains() {
      * Command to get all keys
      */
     setup(cb::mcbp::ClientOpcode::GetKeys, require<Privilege::Read>);
+    // The range scan commands check the Read privilege for the collection
+    // being scanned in the engine (the collection isn't part of the key);
+    // continue and cancel check it again for the collection of the scan
+    setup(cb::mcbp::ClientOpcode::RangeScanCreate, empty);
+    setup(cb::mcbp::ClientOpcode::RangeScanContinue, empty);
+    setup(cb::mcbp::ClientOpcode::RangeScanCancel, empty);
 
     /**
      * Commands for the Sub-document API.
@@ -41,8 +41,10 @@ static bool is_valid_xattr_blob(Cookie& cookie,
 }
 
 bool is_document_key_valid(Cookie& cookie) {
-    const auto& req = cookie.getRequest();
-    const auto& key = req.getKey();
+    return is_document_key_valid(cookie, cookie.getRequest().getKey());
+}
+
+bool is_document_key_valid(Cookie& cookie, cb::const_byte_buffer key) {
     if (!cookie.getConnection().isCollectionsSupported()) {
         return true;
     }
@@ -1287,6 +1289,61 @@ static Status get_validator(Cookie& cookie) {
     return Status::Success;
 }
 
+static Status get_multi_validator(Cookie& cookie) {
+    auto status = McbpValidator::verify_header(cookie,
+                                               0,
+                                               ExpectedKeyLen::Zero,
+                                               ExpectedValueLen::NonZero,
+                                               ExpectedCas::NotSet,
+                                               PROTOCOL_BINARY_RAW_BYTES);
+    if (status != Status::Success) {
+        return status;
+    }
+
+    const auto maxKeyLen = cookie.getConnection().isCollectionsSupported()
+                                   ? MaxCollectionsKeyLen
+                                   : KEY_MAX_LENGTH;
+    using cb::mcbp::request::GetMultiKeySpec;
+    const auto value = cookie.getRequest().getValue();
+    std::size_t offset = 0;
+    std::size_t nkeys = 0;
+    while (offset < value.size()) {
+        if (value.size() - offset < sizeof(GetMultiKeySpec)) {
+            cookie.setErrorContext("Truncated key spec");
+            return Status::Einval;
+        }
+        const auto* spec = reinterpret_cast<const GetMultiKeySpec*>(
+                value.data() + offset);
+        offset += sizeof(GetMultiKeySpec);
+        const auto keylen = spec->getKeylen();
+        if (keylen == 0) {
+            cookie.setErrorContext("Key spec must include key");
+            return Status::Einval;
+        }
+        if (keylen > maxKeyLen) {
+            cookie.setErrorContext("Key length exceeds " +
+                                   std::to_string(maxKeyLen));
+            return Status::Einval;
+        }
+        if (value.size() - offset < keylen) {
+            cookie.setErrorContext("Key exceeds the value");
+            return Status::Einval;
+        }
+        if (!is_document_key_valid(cookie,
+                                   {value.data() + offset, keylen})) {
+            return Status::Einval;
+        }
+        offset += keylen;
+        if (++nkeys > GetMultiMaxKeys) {
+            cookie.setErrorContext("Too many keys, max is " +
+                                   std::to_string(GetMultiMaxKeys));
+            return Status::Einval;
+        }
+    }
+
+    return Status::Success;
+}
+
 static Status gat_validator(Cookie& cookie) {
     auto status =
             McbpValidator::verify_header(cookie,
@@ -2112,6 +2169,39 @@ static Status get_keys_validator(Cookie& cookie) {
     return Status::Success;
 }
 
+static Status range_scan_create_validator(Cookie& cookie) {
+    // The value is a JSON object describing the scan, which is validated
+    // by the engine (which needs to parse it anyway)
+    return McbpValidator::verify_header(
+            cookie,
+            0,
+            ExpectedKeyLen::Zero,
+            ExpectedValueLen::NonZero,
+            ExpectedCas::NotSet,
+            PROTOCOL_BINARY_RAW_BYTES | PROTOCOL_BINARY_DATATYPE_JSON);
+}
+
+static Status range_scan_continue_validator(Cookie& cookie) {
+    return McbpValidator::verify_header(
+            cookie,
+            sizeof(cb::mcbp::request::RangeScanContinuePayload),
+            ExpectedKeyLen::Zero,
+            ExpectedValueLen::Zero,
+            ExpectedCas::NotSet,
+            PROTOCOL_BINARY_RAW_BYTES);
+}
+
+static Status range_scan_cancel_validator(Cookie& cookie) {
+    // The extras only contain the id of the scan
+    return McbpValidator::verify_header(
+            cookie,
+            sizeof(cb::mcbp::request::RangeScanId),
+            ExpectedKeyLen::Zero,
+            ExpectedValueLen::Zero,
+            ExpectedCas::NotSet,
+            PROTOCOL_BINARY_RAW_BYTES);
+}
+
 static Status set_param_validator(Cookie& cookie) {
     using cb::mcbp::request::SetParamPayload;
     auto status = McbpValidator::verify_header(cookie,
@@ -2409,8 +2499,15 @@ McbpValidator::McbpValidator() {
           enable_disable_traffic_validator);
     setup(cb::mcbp::ClientOpcode::Ifconfig, ifconfig_validator);
     setup(cb::mcbp::ClientOpcode::GetKeys, get_keys_validator);
+    setup(cb::mcbp::ClientOpcode::RangeScanCreate,
+          range_scan_create_validator);
+    setup(cb::mcbp::ClientOpcode::RangeScanContinue,
+          range_scan_continue_validator);
+    setup(cb::mcbp::ClientOpcode::RangeScanCancel,
+          range_scan_cancel_validator);
     setup(cb::mcbp::ClientOpcode::SetParam, set_param_validator);
     setup(cb::mcbp::ClientOpcode::GetReplica, get_validator);
+    setup(cb::mcbp::ClientOpcode::GetMulti, get_multi_validator);
     setup(cb::mcbp::ClientOpcode::ReturnMeta, return_meta_validator);
     setup(cb::mcbp::ClientOpcode::SeqnoPersistence,
           seqno_persistence_validator);
@@ -17,6 +17,7 @@
 #include <mcbp/protocol/datatype.h>
 #include <mcbp/protocol/opcode.h>
 #include <mcbp/protocol/status.h>
+#include <platform/sized_buffer.h>
 #include <array>
 #include <functional>
 
@@ -69,3 +70,15 @@ protected:
  * @return true if the keylen represents a valid key for the connection
  */
 bool is_document_key_valid(Cookie& cookie);
+
+/**
+ * Validate a key carried somewhere other than the key field of the request
+ * (for instance one of the keys in the value of a GetMulti request)
+ * @param cookie non const reference as failure will update the error context
+ * @param key the key to validate
+ * @return true if the key represents a valid key for the connection
+ */
+bool is_document_key_valid(Cookie& cookie, cb::const_byte_buffer key);
+
+/// The maximum number of keys which may be requested in a single GetMulti
+static constexpr std::size_t GetMultiMaxKeys = 4096;
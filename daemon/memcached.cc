@@ -713,7 +713,10 @@ static void startExecutorPool() {
                          ThreadPoolConfig::ThreadCount(
                                  Settings::instance().getNumWriterThreads()),
                          Settings::instance().getNumAuxIoThreads(),
-                         Settings::instance().getNumNonIoThreads());
+                         Settings::instance().getNumNonIoThreads(),
+                         Settings::instance().isExecutorNumaAffinityEnabled());
+    ExecutorPool::get()->setWorkStealingQuota(
+            Settings::instance().getExecutorWorkStealingQuota());
     ExecutorPool::get()->registerTaskable(NoBucketTaskable::instance());
 
     // MB-47484 Set up the settings callback for the executor pool now that
@@ -761,6 +764,12 @@ static void startExecutorPool() {
                     return true;
                 });
             });
+    settings.addChangeListener(
+            "executor_work_stealing_quota",
+            [](const std::string&, Settings& s) -> void {
+                ExecutorPool::get()->setWorkStealingQuota(
+                        s.getExecutorWorkStealingQuota());
+            });
 }
 
 int memcached_main(int argc, char** argv) {
@@ -978,14 +987,15 @@ int memcached_main(int argc, char** argv) {
     }
 #endif
 
+    /* start up worker threads if MT mode (before the interfaces, which may
+     * have a listening socket per worker thread) */
+    worker_threads_init();
+
     LOG_INFO_RAW("Starting network interface manager");
     networkInterfaceManager = std::make_unique<NetworkInterfaceManager>(
             *main_base, prometheus_auth_callback);
     networkInterfaceManager->createBootstrapInterface();
 
-    /* start up worker threads if MT mode */
-    worker_threads_init();
-
     LOG_INFO(R"(Starting Phosphor tracing with config: "{}")",
              Settings::instance().getPhosphorConfig());
     initializeTracing(Settings::instance().getPhosphorConfig());
@@ -1040,12 +1050,14 @@ int memcached_main(int argc, char** argv) {
     LOG_INFO_RAW("Shutting down audit daemon");
     shutdown_audit();
 
-    LOG_INFO_RAW("Shutting down client worker threads");
-    threads_shutdown();
-
+    // Release the server sockets while the worker threads are running, as
+    // the per thread listening sockets use their event bases
     LOG_INFO_RAW("Releasing server sockets");
     networkInterfaceManager.reset();
 
+    LOG_INFO_RAW("Shutting down client worker threads");
+    threads_shutdown();
+
     LOG_INFO_RAW("Releasing bucket resources");
     cleanup_buckets();
 
@@ -9,6 +9,7 @@
 #include "network_interface_manager.h"
 
 #include "connection.h"
+#include "front_end_thread.h"
 #include "listening_port.h"
 #include "log_macros.h"
 #include "memcached.h"
@@ -24,6 +25,7 @@
 #include <platform/dirutils.h>
 #include <platform/strerror.h>
 #include <statistics/prometheus.h>
+#include <cstring>
 
 std::unique_ptr<NetworkInterfaceManager> networkInterfaceManager;
 
@@ -291,6 +293,49 @@ static SOCKET new_server_socket(struct addrinfo* ai) {
     return sfd;
 }
 
+std::vector<std::pair<SOCKET, FrontEndThread*>>
+NetworkInterfaceManager::createPerThreadSockets(SOCKET sfd,
+                                                const addrinfo& ai,
+                                                in_port_t port) {
+    // Bind the other sockets to the port the first socket got (the
+    // requested port may be 0)
+    sockaddr_storage addr{};
+    std::memcpy(&addr, ai.ai_addr, ai.ai_addrlen);
+    if (addr.ss_family == AF_INET) {
+        reinterpret_cast<sockaddr_in&>(addr).sin_port = htons(port);
+    } else {
+        reinterpret_cast<sockaddr_in6&>(addr).sin6_port = htons(port);
+    }
+
+    std::vector<std::pair<SOCKET, FrontEndThread*>> ret;
+    FrontEndThread::forEach([&](FrontEndThread& thread) {
+        if (ret.empty()) {
+            ret.emplace_back(sfd, &thread);
+            return;
+        }
+        addrinfo copy = ai;
+        copy.ai_addr = reinterpret_cast<sockaddr*>(&addr);
+        auto shard = new_server_socket(&copy);
+        if (shard == INVALID_SOCKET) {
+            LOG_WARNING("Failed to create listening socket for thread {}",
+                        thread.index);
+            return;
+        }
+        if (bind(shard, copy.ai_addr, (socklen_t)copy.ai_addrlen) ==
+            SOCKET_ERROR) {
+            // The thread still gets clients from the other threads'
+            // sockets through the connection placement
+            LOG_WARNING("Failed to bind listening socket for thread {}: {}",
+                        thread.index,
+                        cb_strerror(cb::net::get_socket_error()));
+            safe_close(shard);
+            return;
+        }
+        ret.emplace_back(shard, &thread);
+    });
+    return ret;
+}
+
 std::pair<nlohmann::json, nlohmann::json>
 NetworkInterfaceManager::createInterface(
         const NetworkInterfaceDescription& description) {
@@ -331,6 +376,14 @@ NetworkInterfaceManager::createInterface(
     nlohmann::json errors = nlohmann::json::array();
     nlohmann::json ret = nlohmann::json::array();
 
+#ifdef __linux__
+    const bool perThreadListeners =
+            Settings::instance().isPerThreadListenersEnabled();
+#else
+    // Only Linux balances the clients across SO_REUSEPORT sockets
+    const bool perThreadListeners = false;
+#endif
+
     // getaddrinfo may return multiple entries for a given name/port pair.
     // Iterate over all of them and try to set up a listen object.
     // We need at least _one_ entry per requested configuration (IPv4/6) in
@@ -359,15 +412,25 @@ NetworkInterfaceManager::createInterface(
             continue;
         }
 
-        auto inter = std::make_shared<ListeningPort>(
-                description.getTag(),
-                host,
-                cb::net::getSockNameAsJson(sfd)["port"].get<in_port_t>(),
-                next->ai_addr->sa_family,
-                description.isSystem(),
-                description.isTls());
-        listen_conn.emplace_back(ServerSocket::create(sfd, eventBase, inter));
-        stats.curr_conns.fetch_add(1, std::memory_order_relaxed);
+        const auto port =
+                cb::net::getSockNameAsJson(sfd)["port"].get<in_port_t>();
+        auto inter = std::make_shared<ListeningPort>(description.getTag(),
+                                                     host,
+                                                     port,
+                                                     next->ai_addr->sa_family,
+                                                     description.isSystem(),
+                                                     description.isTls());
+        if (perThreadListeners) {
+            auto sockets = createPerThreadSockets(sfd, *next, port);
+            stats.curr_conns.fetch_add(sockets.size(),
+                                       std::memory_order_relaxed);
+            listen_conn.emplace_back(
+                    ServerSocket::create(std::move(sockets), inter));
+        } else {
+            listen_conn.emplace_back(
+                    ServerSocket::create(sfd, eventBase, inter));
+            stats.curr_conns.fetch_add(1, std::memory_order_relaxed);
+        }
         ret.push_back(listen_conn.back()->toJson());
     }
 
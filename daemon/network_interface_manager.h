@@ -24,6 +24,8 @@
 #include <queue>
 
 class NetworkInterfaceDescription;
+struct FrontEndThread;
+struct addrinfo;
 
 namespace cb::mcbp {
 enum class Status : uint16_t;
@@ -84,6 +86,19 @@ protected:
     std::pair<nlohmann::json, nlohmann::json> createInterface(
             const NetworkInterfaceDescription& description);
 
+    /**
+     * Create the listening sockets for each of the front end threads for
+     * the address of the (bound) socket sfd, which is used by the first
+     * thread. Threads whose socket can't be created or bound are left out.
+     *
+     * @param sfd The socket bound to the address
+     * @param ai The address
+     * @param port The port sfd is bound to
+     * @return the sockets (bound) and the thread to serve each
+     */
+    std::vector<std::pair<SOCKET, FrontEndThread*>> createPerThreadSockets(
+            SOCKET sfd, const addrinfo& ai, in_port_t port);
+
     folly::EventBase& eventBase;
     const cb::prometheus::AuthCallback authCallback;
     std::vector<std::unique_ptr<ServerSocket>> listen_conn;
@@ -14,10 +14,11 @@
 #include <daemon/mcaudit.h>
 #include <daemon/memcached.h>
 #include <daemon/one_shot_task.h>
+#include <daemon/sendbuffer.h>
 #include <daemon/session_cas.h>
 #include <executor/executorpool.h>
+#include <gsl/gsl-lite.hpp>
 #include <logger/logger.h>
-#include <mcbp/protocol/framebuilder.h>
 #include <mcbp/protocol/request.h>
 #include <memcached/protocol_binary.h>
 
@@ -58,12 +59,21 @@ void get_cluster_config_executor(Cookie& cookie) {
 
     auto active = bucket.clusterConfiguration.maybeGetConfiguration({});
     if (active) {
-        cookie.sendResponse(cb::mcbp::Status::Success,
-                            {},
-                            {},
-                            {active->config.data(), active->config.size()},
-                            cb::mcbp::Datatype::JSON,
-                            0);
+        const auto [payload, datatype] =
+                active->getPayload(connection.isSnappyEnabled());
+        std::unique_ptr<SendBuffer> sendbuffer;
+        if (payload.size() > SendBuffer::MinimumDataSize) {
+            sendbuffer =
+                    std::make_unique<ClustermapSendBuffer>(active, payload);
+        }
+        cookie.setCas(0);
+        connection.sendResponse(cookie,
+                                cb::mcbp::Status::Success,
+                                {},
+                                {},
+                                payload,
+                                connection.getEnabledDatatypes(datatype),
+                                std::move(sendbuffer));
         connection.setPushedClustermapRevno(active->version);
     } else {
         cookie.sendResponse(cb::mcbp::Status::KeyEnoent);
@@ -121,7 +131,7 @@ static void push_cluster_config(unsigned int bucketIndex,
                 return;
             }
 
-            std::unique_ptr<ClusterConfiguration::Configuration> active;
+            std::shared_ptr<const ClusterConfiguration::Configuration> active;
             if (bucketIndex == 0) {
                 active =
                         all_buckets[0]
@@ -166,25 +176,35 @@ static void push_cluster_config(unsigned int bucketIndex,
             cb::mcbp::request::SetClusterConfigPayload version;
             version.setEpoch(active->version.getEpoch());
             version.setRevision(active->version.getRevno());
-            size_t needed = sizeof(Request) + // packet header
-                            sizeof(version) + // rev data in extdata
-                            name.size() + // the name of the bucket
-                            active->config.size(); // The actual payload
-            std::string buffer;
-            buffer.resize(needed);
-            RequestBuilder builder(buffer);
-            builder.setMagic(Magic::ServerRequest);
-            builder.setDatatype(cb::mcbp::Datatype::JSON);
-            builder.setOpcode(ServerOpcode::ClustermapChangeNotification);
-            builder.setExtras(version.getBuffer());
-            builder.setKey({reinterpret_cast<const uint8_t*>(name.data()),
-                            name.size()});
-            builder.setValue(
-                    {reinterpret_cast<const uint8_t*>(active->config.data()),
-                     active->config.size()});
+            const auto extras = version.getBuffer();
+            const auto [payload, datatype] =
+                    active->getPayload(connection.isSnappyEnabled());
+
+            Request request = {};
+            request.setMagic(Magic::ServerRequest);
+            request.setOpcode(ServerOpcode::ClustermapChangeNotification);
+            request.setExtlen(gsl::narrow<uint8_t>(extras.size()));
+            request.setKeylen(gsl::narrow<uint16_t>(name.size()));
+            request.setBodylen(gsl::narrow<uint32_t>(
+                    extras.size() + name.size() + payload.size()));
+            request.setDatatype(cb::mcbp::Datatype(datatype));
 
-            // Inject our packet into the stream!
-            connection.copyToOutputStream(builder.getFrame()->getFrame());
+            // Inject our packet into the stream! The (shared) configuration
+            // is chained rather than copied if it is large
+            const std::string_view header{
+                    reinterpret_cast<const char*>(&request), sizeof(request)};
+            const std::string_view extrasView{
+                    reinterpret_cast<const char*>(extras.data()),
+                    extras.size()};
+            if (payload.size() > SendBuffer::MinimumDataSize) {
+                connection.copyToOutputStream(header, extrasView, name);
+                connection.chainDataToOutputStream(
+                        std::make_unique<ClustermapSendBuffer>(active,
+                                                               payload));
+            } else {
+                connection.copyToOutputStream(
+                        header, extrasView, name, payload);
+            }
         });
     } catch (const std::exception& e) {
         LOG_WARNING("Failed to push cluster config. Received exception: {}",
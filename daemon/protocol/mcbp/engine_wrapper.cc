@@ -205,6 +205,30 @@ cb::EngineErrorItemPair bucket_get(Cookie& cookie,
     return ret;
 }
 
+cb::engine_errc bucket_get_multi(Cookie& cookie,
+                                 const std::vector<DocKey>& keys,
+                                 Vbid vbucket,
+                                 std::vector<cb::EngineErrorItemPair>& results,
+                                 DocStateFilter documentStateFilter) {
+    auto& c = cookie.getConnection();
+    auto ret = c.getBucketEngine().get_multi(
+            cookie, keys, vbucket, documentStateFilter, results);
+    if (ret == cb::engine_errc::disconnect) {
+        LOG_WARNING(
+                "{}: {} bucket_get_multi return cb::engine_errc::disconnect",
+                c.getId(),
+                c.getDescription());
+        c.setTerminationReason("Engine forced disconnect");
+    }
+    LOG_TRACE("bucket_get_multi() nkeys:{} vbucket:{} docStateFilter:{} -> {}",
+              keys.size(),
+              vbucket,
+              documentStateFilter,
+              ret);
+
+    return ret;
+}
+
 BucketCompressionMode bucket_get_compression_mode(Cookie& cookie) {
     auto& c = cookie.getConnection();
     return c.getBucketEngine().getCompressionMode();
@@ -83,6 +83,13 @@ cb::EngineErrorItemPair bucket_get(
         Vbid vbucket,
         DocStateFilter documentStateFilter = DocStateFilter::Alive);
 
+cb::engine_errc bucket_get_multi(
+        Cookie& cookie,
+        const std::vector<DocKey>& keys,
+        Vbid vbucket,
+        std::vector<cb::EngineErrorItemPair>& results,
+        DocStateFilter documentStateFilter = DocStateFilter::Alive);
+
 cb::EngineErrorItemPair bucket_get_if(
         Cookie& cookie,
         const DocKey& key,
@@ -16,7 +16,10 @@
 #include <daemon/debug_helpers.h>
 #include <daemon/mcaudit.h>
 #include <daemon/memcached.h>
+#include <daemon/one_shot_task.h>
 #include <daemon/sendbuffer.h>
+#include <daemon/settings.h>
+#include <executor/executorpool.h>
 #include <gsl/gsl-lite.hpp>
 #include <logger/logger.h>
 #include <xattr/utils.h>
@@ -54,6 +57,36 @@ cb::engine_errc GetCommandContext::getItem() {
 }
 
 cb::engine_errc GetCommandContext::inflateItem() {
+    const auto threshold = Settings::instance().getBackgroundInflateThreshold();
+    if (threshold != 0 &&
+        cb::compression::get_uncompressed_length(
+                cb::compression::Algorithm::Snappy, payload) >= threshold) {
+        // Inflating a large document would stall the other clients of this
+        // thread; inflate it on an executor thread and wait to be notified
+        state = State::InflateItemComplete;
+        ExecutorPool::get()->schedule(std::make_shared<OneShotTask>(
+                TaskId::Core_InflateItemTask, "Inflate item", [this]() {
+                    inflateStatus = doInflateItem();
+                    ::notifyIoComplete(cookie, cb::engine_errc::success);
+                }));
+        return cb::engine_errc::would_block;
+    }
+
+    const auto ret = doInflateItem();
+    if (ret == cb::engine_errc::success) {
+        state = State::SendResponse;
+    }
+    return ret;
+}
+
+cb::engine_errc GetCommandContext::inflateItemComplete() {
+    if (inflateStatus == cb::engine_errc::success) {
+        state = State::SendResponse;
+    }
+    return inflateStatus;
+}
+
+cb::engine_errc GetCommandContext::doInflateItem() {
     try {
         if (!cookie.inflateSnappy(payload, buffer)) {
             LOG_WARNING("{}: Failed to inflate item", connection.getId());
@@ -61,11 +94,19 @@ cb::engine_errc GetCommandContext::inflateItem() {
         }
         payload = buffer;
         info.datatype &= ~PROTOCOL_BINARY_DATATYPE_SNAPPY;
+        if (mcbp::datatype::is_xattr(info.datatype)) {
+            payload = cb::xattr::get_body(payload);
+            info.datatype &= ~PROTOCOL_BINARY_DATATYPE_XATTR;
+        }
     } catch (const std::bad_alloc&) {
         return cb::engine_errc::no_memory;
+    } catch (const std::exception& e) {
+        LOG_WARNING("{}: Failed to inflate item: {}",
+                    connection.getId(),
+                    e.what());
+        return cb::engine_errc::failed;
     }
 
-    state = State::SendResponse;
     return cb::engine_errc::success;
 }
 
@@ -159,6 +200,9 @@ cb::engine_errc GetCommandContext::step() {
         case State::InflateItem:
             ret = inflateItem();
             break;
+        case State::InflateItemComplete:
+            ret = inflateItemComplete();
+            break;
         case State::SendResponse:
             ret = sendResponse();
             break;
@@ -30,6 +30,7 @@ public:
         GetItem,
         NoSuchItem,
         InflateItem,
+        InflateItemComplete,
         SendResponse,
         Done
     };
@@ -95,14 +96,37 @@ protected:
     cb::engine_errc noSuchItem();
 
     /**
-     * Inflate the document before progressing to State::SendResponse
+     * Inflate the document before progressing to State::SendResponse.
+     * Documents which are at least background_inflate_threshold once
+     * inflated are inflated by a task on an executor thread, progressing
+     * to State::InflateItemComplete once the task notifies the cookie.
      *
      * @return cb::engine_errc::failed if inflate failed
      *         cb::engine_errc::no_memory if we're out of memory
+     *         cb::engine_errc::would_block if the inflate task was scheduled
      *         cb::engine_errc::success to go to the next state
      */
     cb::engine_errc inflateItem();
 
+    /**
+     * The inflate task completed; progress to State::SendResponse if it
+     * was successful.
+     *
+     * @return the status of the inflate task
+     */
+    cb::engine_errc inflateItemComplete();
+
+    /**
+     * Inflate the document into the buffer, and strip off the XATTRs (if
+     * any) so that the payload is the body. May be called from an
+     * executor thread (the cookie is blocked while it runs).
+     *
+     * @return cb::engine_errc::failed if inflate failed
+     *         cb::engine_errc::no_memory if we're out of memory
+     *         cb::engine_errc::success if the payload is the inflated body
+     */
+    cb::engine_errc doInflateItem();
+
     /**
      * Craft up the response message and send it to the client. Given that
      * the command context object lives until we start the next command
@@ -122,5 +146,7 @@ private:
 
     std::string_view payload;
     cb::compression::Buffer buffer;
+    /// The status of the inflate task
+    cb::engine_errc inflateStatus = cb::engine_errc::success;
     State state;
 };
@@ -0,0 +1,299 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2021-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#include "get_multi_context.h"
+
+#include "engine_wrapper.h"
+
+#include <daemon/buckets.h>
+#include <daemon/cookie.h>
+#include <daemon/mcaudit.h>
+#include <daemon/memcached.h>
+#include <daemon/sendbuffer.h>
+#include <daemon/stats.h>
+#include <gsl/gsl-lite.hpp>
+#include <logger/logger.h>
+#include <memcached/protocol_binary.h>
+#include <utilities/engine_errc_2_mcbp.h>
+#include <xattr/utils.h>
+
+#include <algorithm>
+#include <numeric>
+
+GetMultiCommandContext::GetMultiCommandContext(Cookie& cookie)
+    : SteppableCommandContext(cookie) {
+    // The validator checked that the value is a well formed sequence of
+    // key specs, and the request stays around until we're done
+    using cb::mcbp::request::GetMultiKeySpec;
+    const auto value = cookie.getRequest().getValue();
+    std::size_t offset = 0;
+    while (offset < value.size()) {
+        const auto* spec = reinterpret_cast<const GetMultiKeySpec*>(
+                value.data() + offset);
+        offset += sizeof(GetMultiKeySpec);
+        entries.emplace_back(spec->getVBucket(),
+                             connection.makeDocKey(
+                                     {value.data() + offset,
+                                      spec->getKeylen()}));
+        offset += spec->getKeylen();
+    }
+
+    byVBucket.resize(entries.size());
+    std::iota(byVBucket.begin(), byVBucket.end(), 0);
+    std::stable_sort(byVBucket.begin(),
+                     byVBucket.end(),
+                     [this](std::size_t a, std::size_t b) {
+                         return entries[a].vbid < entries[b].vbid;
+                     });
+}
+
+cb::engine_errc GetMultiCommandContext::checkAccess() {
+    state = State::GetItems;
+
+    const bool scoped = cookie.getPrivilegeContext().hasScopePrivileges() ||
+                        cookie.getEffectiveUser().has_value();
+    if (!scoped) {
+        if (cookie.checkPrivilege(cb::rbac::Privilege::Read).success()) {
+            return cb::engine_errc::success;
+        }
+        return cb::engine_errc::no_access;
+    }
+
+    // The privileges depend on the collection of each key. Requests rarely
+    // span more than a handful of collections so cache the outcome in a
+    // small vector instead of looking up the scope for every key.
+    std::vector<std::pair<CollectionID, cb::mcbp::Status>> access;
+    auto& engine = connection.getBucket().getEngine();
+    for (auto& entry : entries) {
+        const auto cid = entry.key.getCollectionID();
+        auto iter = std::find_if(
+                access.begin(), access.end(), [cid](const auto& e) {
+                    return e.first == cid;
+                });
+        if (iter == access.end()) {
+            auto status = cb::mcbp::Status::Success;
+            ScopeID sid{ScopeID::Default};
+            if (!cid.isDefaultCollection()) {
+                auto res = engine.get_scope_id(cookie, entry.key, entry.vbid);
+                if (res.result == cb::engine_errc::success) {
+                    sid = res.getScopeId();
+                } else {
+                    status = cb::mcbp::to_status(res.result);
+                }
+            }
+            if (status == cb::mcbp::Status::Success) {
+                switch (cookie.testPrivilege(
+                                      cb::rbac::Privilege::Read, sid, cid)
+                                .getStatus()) {
+                case cb::rbac::PrivilegeAccess::Status::Ok:
+                    break;
+                case cb::rbac::PrivilegeAccess::Status::Fail:
+                    status = cb::mcbp::Status::Eaccess;
+                    break;
+                case cb::rbac::PrivilegeAccess::Status::FailNoPrivileges:
+                    status = cb::mcbp::Status::UnknownCollection;
+                    break;
+                }
+            }
+            iter = access.emplace(access.end(), cid, status);
+        }
+
+        if (iter->second != cb::mcbp::Status::Success) {
+            setStatus(entry, iter->second);
+        }
+    }
+
+    return cb::engine_errc::success;
+}
+
+void GetMultiCommandContext::setStatus(Entry& entry, cb::mcbp::Status status) {
+    entry.pending = false;
+    entry.status = status;
+    if (status == cb::mcbp::Status::KeyEnoent) {
+        STATS_MISS(&connection, get);
+    }
+}
+
+void GetMultiCommandContext::setResult(Entry& entry,
+                                       cb::EngineErrorItemPair&& result) {
+    if (result.first != cb::engine_errc::success) {
+        setStatus(entry, cb::mcbp::to_status(result.first));
+        return;
+    }
+
+    entry.pending = false;
+    entry.item = std::move(result.second);
+    if (!bucket_get_item_info(connection, entry.item.get(), &entry.info)) {
+        LOG_WARNING("{}: Failed to get item info", connection.getId());
+        entry.item.reset();
+        entry.status = cb::mcbp::Status::Einternal;
+        return;
+    }
+
+    entry.payload = {static_cast<const char*>(entry.info.value[0].iov_base),
+                     entry.info.value[0].iov_len};
+
+    if (mcbp::datatype::is_snappy(entry.info.datatype) &&
+        (mcbp::datatype::is_xattr(entry.info.datatype) ||
+         !connection.isSnappyEnabled())) {
+        entry.inflated = std::make_unique<cb::compression::Buffer>();
+        if (!cookie.inflateSnappy(entry.payload, *entry.inflated)) {
+            LOG_WARNING("{}: Failed to inflate item", connection.getId());
+            entry.item.reset();
+            entry.inflated.reset();
+            entry.payload = {};
+            entry.status = cb::mcbp::Status::Einternal;
+            return;
+        }
+        entry.payload = *entry.inflated;
+        entry.info.datatype &= ~PROTOCOL_BINARY_DATATYPE_SNAPPY;
+    }
+
+    if (mcbp::datatype::is_xattr(entry.info.datatype)) {
+        entry.payload = cb::xattr::get_body(entry.payload);
+        entry.info.datatype &= ~PROTOCOL_BINARY_DATATYPE_XATTR;
+    }
+    entry.info.datatype = connection.getEnabledDatatypes(entry.info.datatype);
+
+    cb::audit::document::add(
+            cookie, cb::audit::document::Operation::Read, entry.key);
+    STATS_HIT(&connection, get);
+}
+
+cb::engine_errc GetMultiCommandContext::getItems() {
+    while (nextVBucket < byVBucket.size()) {
+        const auto vbid = entries[byVBucket[nextVBucket]].vbid;
+        auto end = nextVBucket;
+        keys.clear();
+        keyIndexes.clear();
+        while (end < byVBucket.size() &&
+               entries[byVBucket[end]].vbid == vbid) {
+            const auto idx = byVBucket[end++];
+            if (entries[idx].pending) {
+                keys.emplace_back(entries[idx].key);
+                keyIndexes.emplace_back(idx);
+            }
+        }
+
+        if (!keys.empty()) {
+            auto ret = bucket_get_multi(cookie, keys, vbid, results);
+            if (ret == cb::engine_errc::not_my_vbucket) {
+                // Let the client know that it should try these keys
+                // elsewhere, but return the rest of the keys
+                for (const auto idx : keyIndexes) {
+                    setStatus(entries[idx], cb::mcbp::Status::NotMyVbucket);
+                }
+            } else if (ret == cb::engine_errc::success ||
+                       ret == cb::engine_errc::would_block) {
+                if (results.size() != keyIndexes.size()) {
+                    // The engine must return one result per key. An engine
+                    // which blocked without doing so leaves every key in
+                    // this vbucket pending for the retry.
+                    if (ret == cb::engine_errc::success) {
+                        LOG_WARNING(
+                                "{}: GetMultiCommandContext::getItems(): "
+                                "engine returned {} results for {} keys",
+                                connection.getId(),
+                                results.size(),
+                                keyIndexes.size());
+                        ret = cb::engine_errc::failed;
+                    }
+                    results.clear();
+                    return ret;
+                }
+                for (std::size_t ii = 0; ii < keyIndexes.size(); ++ii) {
+                    if (results[ii].first != cb::engine_errc::would_block) {
+                        setResult(entries[keyIndexes[ii]],
+                                  std::move(results[ii]));
+                    }
+                }
+                results.clear();
+                if (ret == cb::engine_errc::would_block) {
+                    // We'll be notified once the remaining keys in this
+                    // vbucket may be retried
+                    return ret;
+                }
+            } else {
+                return ret;
+            }
+        }
+        nextVBucket = end;
+    }
+
+    state = State::SendResponse;
+    return cb::engine_errc::success;
+}
+
+cb::engine_errc GetMultiCommandContext::sendResponse() {
+    using cb::mcbp::response::GetMultiEntryHeader;
+    std::size_t total = 0;
+    for (const auto& entry : entries) {
+        total += sizeof(GetMultiEntryHeader) + entry.payload.size();
+    }
+
+    cookie.setResponseStatus(cb::mcbp::Status::Success);
+    connection.sendResponseHeaders(cookie,
+                                   cb::mcbp::Status::Success,
+                                   {},
+                                   {},
+                                   total,
+                                   PROTOCOL_BINARY_RAW_BYTES);
+
+    for (auto& entry : entries) {
+        const GetMultiEntryHeader header(
+                entry.status,
+                entry.item ? entry.info.datatype : PROTOCOL_BINARY_RAW_BYTES,
+                entry.item ? entry.info.flags : 0,
+                entry.item ? entry.info.cas : 0,
+                gsl::narrow<uint32_t>(entry.payload.size()));
+        if (entry.payload.size() > SendBuffer::MinimumDataSize) {
+            connection.copyToOutputStream(header.getBuffer());
+            // Chain the value directly from the item (or the inflated
+            // buffer) instead of copying it
+            if (entry.inflated) {
+                connection.chainDataToOutputStream(
+                        std::make_unique<CompressionSendBuffer>(
+                                *entry.inflated, entry.payload));
+            } else {
+                connection.chainDataToOutputStream(
+                        std::make_unique<ItemSendBuffer>(
+                                std::move(entry.item),
+                                entry.payload,
+                                connection.getBucket()));
+            }
+        } else {
+            connection.copyToOutputStream(header.getBuffer(), entry.payload);
+        }
+    }
+
+    state = State::Done;
+    return cb::engine_errc::success;
+}
+
+cb::engine_errc GetMultiCommandContext::step() {
+    auto ret = cb::engine_errc::success;
+    do {
+        switch (state) {
+        case State::CheckAccess:
+            ret = checkAccess();
+            break;
+        case State::GetItems:
+            ret = getItems();
+            break;
+        case State::SendResponse:
+            ret = sendResponse();
+            break;
+        case State::Done:
+            return cb::engine_errc::success;
+        }
+    } while (ret == cb::engine_errc::success);
+
+    return ret;
+}
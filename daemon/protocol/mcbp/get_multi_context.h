@@ -0,0 +1,117 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2021-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#pragma once
+
+#include "steppable_command_context.h"
+
+#include <mcbp/protocol/status.h>
+#include <memcached/dockey.h>
+#include <memcached/engine.h>
+#include <platform/compress.h>
+
+#include <memory>
+#include <vector>
+
+/**
+ * The GetMultiCommandContext is a state machine used by the memcached
+ * core to implement the GetMulti operation.
+ *
+ * The keys in the request are grouped by vbucket and each group is looked
+ * up with a single call to the engine (which may look up all of the keys
+ * while holding the vbucket and collection locks once, and put all of the
+ * keys it needs to fetch from disk into a single background fetch). All of
+ * the documents are returned in a single response message.
+ */
+class GetMultiCommandContext : public SteppableCommandContext {
+public:
+    // The internal states. Look at the function headers below to
+    // for the functions with the same name to figure out what each
+    // state does
+    enum class State : uint8_t { CheckAccess, GetItems, SendResponse, Done };
+
+    explicit GetMultiCommandContext(Cookie& cookie);
+
+protected:
+    cb::engine_errc step() override;
+
+    /**
+     * Verify that the connection may read the documents. If the user holds
+     * the Read privilege for the entire bucket we only need a single check,
+     * otherwise each key is checked against the privileges for its
+     * collection and keys the user can't access get an error status (the
+     * rest of the keys are still returned).
+     *
+     * @return cb::engine_errc::success to progress to State::GetItems,
+     *         cb::engine_errc::no_access if the user can't read the bucket
+     */
+    cb::engine_errc checkAccess();
+
+    /**
+     * Look up all of the keys which are still unresolved, one vbucket at
+     * a time. If the engine needs to block for some of the keys in a
+     * vbucket we return cb::engine_errc::would_block and retry only those
+     * keys once the engine notifies us.
+     *
+     * @return cb::engine_errc::would_block if the engine needs to block,
+     *         cb::engine_errc::success to progress to State::SendResponse,
+     *         or a standard engine error code if something goes wrong
+     */
+    cb::engine_errc getItems();
+
+    /**
+     * Craft up the response message (one GetMultiEntryHeader followed by
+     * the value for each of the keys) and send it to the client. Large
+     * values are chained into the output stream directly from the item
+     * (or the inflated buffer) instead of being copied.
+     *
+     * @return cb::engine_errc::success
+     */
+    cb::engine_errc sendResponse();
+
+private:
+    struct Entry {
+        Entry(Vbid vbid, DocKey key) : vbid(vbid), key(key) {
+        }
+
+        const Vbid vbid;
+        const DocKey key;
+        /// Set to false once the key is resolved (found or failed)
+        bool pending = true;
+        cb::mcbp::Status status = cb::mcbp::Status::Success;
+        cb::unique_item_ptr item;
+        item_info info;
+        std::string_view payload;
+        /// Holds the inflated document if we had to inflate it
+        std::unique_ptr<cb::compression::Buffer> inflated;
+    };
+
+    /// Resolve the entry with the result from the engine
+    void setResult(Entry& entry, cb::EngineErrorItemPair&& result);
+
+    /// Mark the entry as resolved with the provided (failure) status
+    void setStatus(Entry& entry, cb::mcbp::Status status);
+
+    /// The requested keys, in the order they were requested
+    std::vector<Entry> entries;
+
+    /// Indexes into entries, ordered by vbucket
+    std::vector<std::size_t> byVBucket;
+
+    /// Index in byVBucket of the first entry of the next vbucket to look up
+    std::size_t nextVBucket = 0;
+
+    /// Reused buffers for the keys (and results) of a single engine call
+    std::vector<DocKey> keys;
+    std::vector<std::size_t> keyIndexes;
+    std::vector<cb::EngineErrorItemPair> results;
+
+    State state = State::CheckAccess;
+};
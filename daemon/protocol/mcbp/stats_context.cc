@@ -168,7 +168,9 @@ static cb::engine_errc stat_reset_executor(const std::string& arg,
  * Handler for the <code>stats sched</code> used to get the
  * histogram for the scheduler histogram.
  *
- * @param arg - should be empty
+ * @param arg - empty, "aggregate" for the histogram of all of the threads
+ *              or "connections" for the number of connections served by
+ *              each thread
  * @param cookie the command context
  */
 static cb::engine_errc stat_sched_executor(const std::string& arg,
@@ -195,6 +197,16 @@ static cb::engine_errc stat_sched_executor(const std::string& arg,
         return cb::engine_errc::success;
     }
 
+    if (arg == "connections") {
+        // As counted for the least_loaded connection_placement
+        FrontEndThread::forEach([&cookie](FrontEndThread& thread) {
+            append_stats(std::to_string(thread.index),
+                         std::to_string(thread.numConnections.load()),
+                         &cookie);
+        });
+        return cb::engine_errc::success;
+    }
+
     return cb::engine_errc::invalid_arguments;
 }
 
@@ -10,6 +10,8 @@
  */
 #pragma once
 
+#include "cluster_config.h"
+
 #include <memcached/engine.h>
 #include <platform/compression/buffer.h>
 class Bucket;
@@ -86,3 +88,20 @@ protected:
     cb::compression::Allocator allocator;
     char* data;
 };
+
+/**
+ * Specialized class to send (part of) a cluster configuration without
+ * copying it; the configuration is kept alive until libevent is done
+ * sending the data.
+ */
+class ClustermapSendBuffer : public SendBuffer {
+public:
+    ClustermapSendBuffer(
+            std::shared_ptr<const ClusterConfiguration::Configuration> config,
+            std::string_view view)
+        : SendBuffer(view), config(std::move(config)) {
+    }
+
+protected:
+    std::shared_ptr<const ClusterConfiguration::Configuration> config;
+};
@@ -42,10 +42,13 @@ public:
      * @param sfd The socket to operate on
      * @param b The event base to use (the caller owns the event base)
      * @param interf The interface object containing properties to use
+     * @param acceptor The front end thread owning the event base if this
+     *                 is one of its per thread listening sockets
      */
     LibeventServerSocketImpl(SOCKET sfd,
                              folly::EventBase& b,
-                             std::shared_ptr<ListeningPort> interf);
+                             std::shared_ptr<ListeningPort> interf,
+                             FrontEndThread* acceptor = nullptr);
 
     ~LibeventServerSocketImpl() override;
 
@@ -81,6 +84,9 @@ protected:
 
     std::shared_ptr<ListeningPort> interface;
 
+    /// The front end thread accepting clients (nullptr for the listen thread)
+    FrontEndThread* const acceptor;
+
     /// The sockets name (used for debug)
     const std::string sockname;
 
@@ -123,10 +129,14 @@ void LibeventServerSocketImpl::listen_event_handler(evutil_socket_t,
 }
 
 LibeventServerSocketImpl::LibeventServerSocketImpl(
-        SOCKET fd, folly::EventBase& b, std::shared_ptr<ListeningPort> interf)
+        SOCKET fd,
+        folly::EventBase& b,
+        std::shared_ptr<ListeningPort> interf,
+        FrontEndThread* acceptor)
     : sfd(fd),
       uuid(to_string(cb::uuid::random())),
       interface(std::move(interf)),
+      acceptor(acceptor),
       sockname(cb::net::getsockname(fd)),
       ev(event_new(b.getLibeventBase(),
                    sfd,
@@ -257,7 +267,7 @@ void LibeventServerSocketImpl::acceptNewClient() {
         return;
     }
 
-    FrontEndThread::dispatch(client, interface, std::move(ssl));
+    FrontEndThread::dispatch(client, interface, std::move(ssl), acceptor);
 }
 
 nlohmann::json LibeventServerSocketImpl::toJson() const {
@@ -282,9 +292,66 @@ nlohmann::json LibeventServerSocketImpl::toJson() const {
     return ret;
 }
 
+/**
+ * The per thread listening sockets of an interface, presented as a single
+ * ServerSocket (with a single uuid) so that the interface is listed and
+ * deleted as one.
+ */
+class PerThreadServerSocketImpl : public ServerSocket {
+public:
+    PerThreadServerSocketImpl(
+            std::vector<std::pair<SOCKET, FrontEndThread*>> sockets,
+            std::shared_ptr<ListeningPort> interf)
+        : uuid(to_string(cb::uuid::random())), interface(std::move(interf)) {
+        for (const auto& [sfd, thread] : sockets) {
+            shards.emplace_back(
+                    thread,
+                    std::make_unique<LibeventServerSocketImpl>(
+                            sfd, thread->eventBase, interface, thread));
+        }
+    }
+
+    ~PerThreadServerSocketImpl() override {
+        // Release each socket in its thread so that it isn't released
+        // while the thread is accepting a client from it
+        for (auto& [thread, shard] : shards) {
+            thread->eventBase.runImmediatelyOrRunInEventBaseThreadAndWait(
+                    [&shard = shard]() { shard.reset(); });
+        }
+    }
+
+    const ListeningPort& getInterfaceDescription() const override {
+        return *interface;
+    }
+
+    nlohmann::json toJson() const override {
+        auto ret = shards.front().second->toJson();
+        ret["uuid"] = uuid;
+        return ret;
+    }
+
+    const std::string& getUuid() const override {
+        return uuid;
+    }
+
+protected:
+    const std::string uuid;
+    std::shared_ptr<ListeningPort> interface;
+    std::vector<std::pair<FrontEndThread*,
+                          std::unique_ptr<LibeventServerSocketImpl>>>
+            shards;
+};
+
 std::unique_ptr<ServerSocket> ServerSocket::create(
         SOCKET sfd,
         folly::EventBase& b,
         std::shared_ptr<ListeningPort> interf) {
     return std::make_unique<LibeventServerSocketImpl>(sfd, b, interf);
 }
+
+std::unique_ptr<ServerSocket> ServerSocket::create(
+        std::vector<std::pair<SOCKET, FrontEndThread*>> sockets,
+        std::shared_ptr<ListeningPort> interf) {
+    return std::make_unique<PerThreadServerSocketImpl>(std::move(sockets),
+                                                       std::move(interf));
+}
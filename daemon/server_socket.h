@@ -13,12 +13,15 @@
 #include <platform/socket.h>
 #include <atomic>
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace folly {
 class EventBase;
 }
 
 class ListeningPort;
+struct FrontEndThread;
 
 /**
  * The ServerSocket represents the socket used to accept new clients.
@@ -39,6 +42,19 @@ public:
             folly::EventBase& b,
             std::shared_ptr<ListeningPort> interf);
 
+    /**
+     * Create a new instance accepting clients from one socket per front end
+     * thread (all bound to the same address with SO_REUSEPORT); each socket
+     * is served by the event base of its thread, and the clients it accepts
+     * are dispatched with the thread as the acceptor.
+     *
+     * @param sockets The sockets to operate on and the thread serving each
+     * @param interf The interface object containing properties to use
+     */
+    static std::unique_ptr<ServerSocket> create(
+            std::vector<std::pair<SOCKET, FrontEndThread*>> sockets,
+            std::shared_ptr<ListeningPort> interf);
+
     virtual ~ServerSocket() = default;
 
     virtual const ListeningPort& getInterfaceDescription() const = 0;
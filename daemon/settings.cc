@@ -147,6 +147,25 @@ static void handle_active_external_users_push_interval(
     }
 }
 
+static void handle_prometheus_high_cardinality_cache_time(
+        Settings& s, const nlohmann::json& obj) {
+    switch (obj.type()) {
+    case nlohmann::json::value_t::number_unsigned:
+        s.setPrometheusHighCardinalityCacheTime(
+                std::chrono::seconds(obj.get<int>()));
+        break;
+    case nlohmann::json::value_t::string:
+        s.setPrometheusHighCardinalityCacheTime(
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                        cb::text2time(obj.get<std::string>())));
+        break;
+    default:
+        cb::throwJsonTypeError(
+                R"("prometheus_high_cardinality_cache_time" must be a number )"
+                R"(or string)");
+    }
+}
+
 static void handle_max_concurrent_commands_per_connection(
         Settings& s, const nlohmann::json& obj) {
     if (!obj.is_number_unsigned()) {
@@ -187,6 +206,41 @@ static void handle_stdin_listener(Settings& s, const nlohmann::json& obj) {
     s.setStdinListenerEnabled(obj.get<bool>());
 }
 
+/**
+ * Handle the "per_thread_listeners" tag in the settings
+ *
+ *  The value must be a boolean value
+ *
+ * @param s the settings object to update
+ * @param obj the object in the configuration
+ */
+static void handle_per_thread_listeners(Settings& s,
+                                        const nlohmann::json& obj) {
+    s.setPerThreadListenersEnabled(obj.get<bool>());
+}
+
+/**
+ * Handle the "connection_placement" tag in the settings
+ *
+ *  The value must be "round_robin" or "least_loaded"
+ *
+ * @param s the settings object to update
+ * @param obj the object in the configuration
+ */
+static void handle_connection_placement(Settings& s,
+                                        const nlohmann::json& obj) {
+    const auto value = obj.get<std::string>();
+    if (value == "round_robin") {
+        s.setConnectionPlacement(ConnectionPlacement::RoundRobin);
+    } else if (value == "least_loaded") {
+        s.setConnectionPlacement(ConnectionPlacement::LeastLoaded);
+    } else {
+        throw std::invalid_argument(
+                R"(connection_placement must be "round_robin" or )"
+                R"("least_loaded")");
+    }
+}
+
 /**
  * Handle "default_reqs_per_event", "reqs_per_event_high_priority",
  * "reqs_per_event_med_priority" and "reqs_per_event_low_priority" tag in
@@ -332,6 +386,15 @@ static void handle_max_send_queue_size(Settings& s, const nlohmann::json& obj) {
     s.setMaxSendQueueSize(obj.get<size_t>() * 1024 * 1024);
 }
 
+static void handle_background_inflate_threshold(Settings& s,
+                                                const nlohmann::json& obj) {
+    if (!obj.is_number_unsigned()) {
+        cb::throwJsonTypeError(
+                R"("background_inflate_threshold" must be an unsigned number)");
+    }
+    s.setBackgroundInflateThreshold(obj.get<size_t>());
+}
+
 static void handle_max_connections(Settings& s, const nlohmann::json& obj) {
     if (!obj.is_number_unsigned()) {
         cb::throwJsonTypeError(
@@ -520,6 +583,27 @@ static void handle_num_nonio_threads(Settings& s, const nlohmann::json& obj) {
     }
 }
 
+static void handle_executor_work_stealing_quota(Settings& s,
+                                                const nlohmann::json& obj) {
+    if (!obj.is_number_unsigned()) {
+        cb::throwJsonTypeError(
+                R"("executor_work_stealing_quota" must be an unsigned number)");
+    }
+    const auto val = obj.get<size_t>();
+    if (val > 100) {
+        throw std::invalid_argument(fmt::format(
+                R"("executor_work_stealing_quota" must be in the range )"
+                R"([0,100]! Value:{})",
+                val));
+    }
+    s.setExecutorWorkStealingQuota(val);
+}
+
+static void handle_executor_numa_affinity(Settings& s,
+                                          const nlohmann::json& obj) {
+    s.setExecutorNumaAffinityEnabled(obj.get<bool>());
+}
+
 static void handle_num_storage_threads(Settings& s, const nlohmann::json& obj) {
     if (obj.is_number_unsigned()) {
         s.setNumStorageThreads(obj.get<size_t>());
@@ -657,11 +741,15 @@ void Settings::reconfigure(const nlohmann::json& json) {
             {"breakpad", handle_breakpad},
             {"max_packet_size", handle_max_packet_size},
             {"max_send_queue_size", handle_max_send_queue_size},
+            {"background_inflate_threshold",
+             handle_background_inflate_threshold},
             {"max_connections", handle_max_connections},
             {"system_connections", handle_system_connections},
             {"sasl_mechanisms", handle_sasl_mechanisms},
             {"ssl_sasl_mechanisms", handle_ssl_sasl_mechanisms},
             {"stdin_listener", handle_stdin_listener},
+            {"per_thread_listeners", handle_per_thread_listeners},
+            {"connection_placement", handle_connection_placement},
             {"dedupe_nmvb_maps", handle_dedupe_nmvb_maps},
             {"xattr_enabled", handle_xattr_enabled},
             {"client_cert_auth", handle_client_cert_auth},
@@ -672,6 +760,9 @@ void Settings::reconfigure(const nlohmann::json& json) {
             {"num_storage_threads", handle_num_storage_threads},
             {"num_auxio_threads", handle_num_auxio_threads},
             {"num_nonio_threads", handle_num_nonio_threads},
+            {"executor_work_stealing_quota",
+             handle_executor_work_stealing_quota},
+            {"executor_numa_affinity", handle_executor_numa_affinity},
             {"tracing_enabled", handle_tracing_enabled},
             {"enforce_tenant_limits_enabled",
              handle_enforce_tenant_limits_enabled},
@@ -683,6 +774,8 @@ void Settings::reconfigure(const nlohmann::json& json) {
              handle_max_concurrent_commands_per_connection},
             {"phosphor_config", handle_phosphor_config},
             {"prometheus", handle_prometheus},
+            {"prometheus_high_cardinality_cache_time",
+             handle_prometheus_high_cardinality_cache_time},
             {"portnumber_file", handle_portnumber_file},
             {"parent_identifier", handle_parent_identifier},
             {"whitelist_localhost_interface",
@@ -749,6 +842,19 @@ void Settings::updateSettings(const Settings& other, bool apply) {
                     "stdin_listener can't be changed dynamically");
         }
     }
+    if (other.has.executor_numa_affinity) {
+        if (other.executor_numa_affinity.load() !=
+            executor_numa_affinity.load()) {
+            throw std::invalid_argument(
+                    "executor_numa_affinity can't be changed dynamically");
+        }
+    }
+    if (other.has.per_thread_listeners) {
+        if (other.per_thread_listeners.load() != per_thread_listeners.load()) {
+            throw std::invalid_argument(
+                    "per_thread_listeners can't be changed dynamically");
+        }
+    }
 
     if (other.has.logger) {
         if (other.logger_settings != logger_settings)
@@ -880,6 +986,17 @@ void Settings::updateSettings(const Settings& other, bool apply) {
         }
     }
 
+    if (other.has.background_inflate_threshold) {
+        if (other.background_inflate_threshold !=
+            background_inflate_threshold) {
+            LOG_INFO("Change background inflate threshold from {} to {}",
+                     background_inflate_threshold.load(),
+                     other.background_inflate_threshold.load());
+            setBackgroundInflateThreshold(
+                    other.background_inflate_threshold.load());
+        }
+    }
+
     if (other.has.client_cert_auth) {
         const auto m = client_cert_mapper.to_string();
         const auto o = other.client_cert_mapper.to_string();
@@ -902,6 +1019,17 @@ void Settings::updateSettings(const Settings& other, bool apply) {
         }
     }
 
+    if (other.has.connection_placement) {
+        if (other.connection_placement != connection_placement) {
+            LOG_INFO("Change connection placement to {}",
+                     other.connection_placement.load() ==
+                                     ConnectionPlacement::LeastLoaded
+                             ? "least_loaded"
+                             : "round_robin");
+            setConnectionPlacement(other.connection_placement.load());
+        }
+    }
+
     if (other.has.max_connections) {
         if (other.max_connections != max_connections) {
             LOG_INFO(R"(Change max connections from {} to {})",
@@ -1131,6 +1259,27 @@ void Settings::updateSettings(const Settings& other, bool apply) {
         setNumNonIoThreads(other.getNumNonIoThreads());
     }
 
+    if (other.has.executor_work_stealing_quota &&
+        other.getExecutorWorkStealingQuota() !=
+                getExecutorWorkStealingQuota()) {
+        LOG_INFO("Change executor work stealing quota from: {}% to {}%",
+                 getExecutorWorkStealingQuota(),
+                 other.getExecutorWorkStealingQuota());
+        setExecutorWorkStealingQuota(other.getExecutorWorkStealingQuota());
+    }
+
+    if (other.has.prometheus_high_cardinality_cache_time &&
+        other.getPrometheusHighCardinalityCacheTime() !=
+                getPrometheusHighCardinalityCacheTime()) {
+        LOG_INFO(
+                "Change Prometheus High cardinality cache time from {}ms to "
+                "{}ms",
+                getPrometheusHighCardinalityCacheTime().count(),
+                other.getPrometheusHighCardinalityCacheTime().count());
+        setPrometheusHighCardinalityCacheTime(
+                other.getPrometheusHighCardinalityCacheTime());
+    }
+
     if (other.has.prometheus_config) {
         auto nval = *other.prometheus_config.rlock();
         if (nval != *prometheus_config.rlock()) {
@@ -35,6 +35,15 @@ enum class EventPriority {
     Default
 };
 
+/// How FrontEndThread::dispatch picks the thread to serve a new connection
+enum class ConnectionPlacement {
+    /// Cycle through the threads (or keep the connection on the thread which
+    /// accepted it when each thread has its own listening sockets)
+    RoundRobin,
+    /// Pick the thread with the lowest load (see FrontEndThread::getLoad)
+    LeastLoaded
+};
+
 /**
  * Globally accessible settings as derived from the commandline / JSON config
  * file.
@@ -182,6 +191,40 @@ public:
         notify_changed("stdin_listener");
     }
 
+    /**
+     * Should each front end thread have its own (SO_REUSEPORT) listening
+     * socket for each interface, rather than all of the interfaces being
+     * served by the listen thread?
+     *
+     * @return true if enabled, false otherwise
+     */
+    bool isPerThreadListenersEnabled() const {
+        return per_thread_listeners.load();
+    }
+
+    /**
+     * Set if each front end thread should have its own listening sockets
+     *
+     * @param enabled the new value
+     */
+    void setPerThreadListenersEnabled(bool enabled) {
+        per_thread_listeners.store(enabled);
+        has.per_thread_listeners = true;
+        notify_changed("per_thread_listeners");
+    }
+
+    /// Get the policy used to pick the thread to serve a new connection
+    ConnectionPlacement getConnectionPlacement() const {
+        return connection_placement.load();
+    }
+
+    /// Set the policy used to pick the thread to serve a new connection
+    void setConnectionPlacement(ConnectionPlacement placement) {
+        connection_placement.store(placement);
+        has.connection_placement = true;
+        notify_changed("connection_placement");
+    }
+
     cb::logger::Config getLoggerConfig() const {
         auto config = logger_settings;
         // log_level is synthesised from settings.verbose.
@@ -458,6 +501,22 @@ public:
         notify_changed("max_send_queue_size");
     }
 
+    /// Get the (inflated) size of a document from which the front end
+    /// threads inflate it (and strip its XATTRs) on an executor thread
+    /// rather than on the front end thread (0 = never)
+    size_t getBackgroundInflateThreshold() const {
+        return background_inflate_threshold.load(std::memory_order_acquire);
+    }
+
+    /// Set the (inflated) size of a document from which the front end
+    /// threads inflate it on an executor thread (0 = never)
+    void setBackgroundInflateThreshold(size_t threshold) {
+        background_inflate_threshold.store(threshold,
+                                           std::memory_order_release);
+        has.background_inflate_threshold = true;
+        notify_changed("background_inflate_threshold");
+    }
+
     void reconfigureClientCertAuth(
             std::unique_ptr<cb::x509::ClientCertConfig> config) {
         client_cert_mapper.reconfigure(std::move(config));
@@ -714,6 +773,44 @@ public:
         notify_changed("num_nonio_threads");
     }
 
+    /// Get the percentage of each executor thread pool's threads which may
+    /// run the ready tasks of other (busy) thread pools
+    size_t getExecutorWorkStealingQuota() const {
+        return executor_work_stealing_quota.load(std::memory_order_acquire);
+    }
+
+    void setExecutorWorkStealingQuota(size_t val) {
+        executor_work_stealing_quota.store(val, std::memory_order_release);
+        has.executor_work_stealing_quota = true;
+        notify_changed("executor_work_stealing_quota");
+    }
+
+    /// Should the executor threads be pinned to NUMA nodes?
+    bool isExecutorNumaAffinityEnabled() const {
+        return executor_numa_affinity.load();
+    }
+
+    void setExecutorNumaAffinityEnabled(bool enabled) {
+        executor_numa_affinity.store(enabled);
+        has.executor_numa_affinity = true;
+        notify_changed("executor_numa_affinity");
+    }
+
+    /// Get how long the metrics collected for a High cardinality Prometheus
+    /// scrape may be reused by later scrapes
+    std::chrono::milliseconds getPrometheusHighCardinalityCacheTime() const {
+        return prometheus_high_cardinality_cache_time.load(
+                std::memory_order_acquire);
+    }
+
+    void setPrometheusHighCardinalityCacheTime(
+            const std::chrono::milliseconds time) {
+        prometheus_high_cardinality_cache_time.store(time,
+                                                     std::memory_order_release);
+        has.prometheus_high_cardinality_cache_time = true;
+        notify_changed("prometheus_high_cardinality_cache_time");
+    }
+
     std::pair<in_port_t, sa_family_t> getPrometheusConfig() {
         return *prometheus_config.rlock();
     }
@@ -851,6 +948,10 @@ protected:
     /// limit is set to 40MB (2x the max document size)
     std::atomic<size_t> max_send_queue_size{40 * 1024 * 1024};
 
+    /// The inflated size of a document from which it is inflated on an
+    /// executor thread rather than the front end thread (1MB by default)
+    std::atomic<size_t> background_inflate_threshold{1024 * 1024};
+
     /// ssl client authentication
     cb::x509::ClientCertMapper client_cert_mapper;
 
@@ -888,6 +989,15 @@ protected:
      */
     std::atomic_bool stdin_listener{true};
 
+    /**
+     * Should each front end thread have its own listening sockets
+     */
+    std::atomic_bool per_thread_listeners{false};
+
+    /// The policy used to pick the thread to serve a new connection
+    std::atomic<ConnectionPlacement> connection_placement{
+            ConnectionPlacement::RoundRobin};
+
     /**
      * Should we allow for using the external authentication service or not
      */
@@ -932,8 +1042,21 @@ protected:
     std::atomic<int> num_auxio_threads{0};
     std::atomic<int> num_nonio_threads{0};
 
+    /// Percentage of each executor thread pool's threads which may run the
+    /// tasks of other thread pools (0 = disabled)
+    std::atomic<size_t> executor_work_stealing_quota{0};
+
+    /// Should the executor threads be pinned to NUMA nodes
+    std::atomic_bool executor_numa_affinity{false};
+
     folly::Synchronized<std::pair<in_port_t, sa_family_t>> prometheus_config;
 
+    /// How long High cardinality Prometheus metrics may be reused between
+    /// scrapes (0 = collect them for every scrape)
+    std::atomic<std::chrono::milliseconds>
+            prometheus_high_cardinality_cache_time{
+                    std::chrono::milliseconds{0}};
+
     /// Number of storage backend threads
     std::atomic<int> num_storage_threads{0};
 
@@ -974,6 +1097,7 @@ public:
         bool breakpad = false;
         bool max_packet_size = false;
         bool max_send_queue_size = false;
+        bool background_inflate_threshold = false;
         bool client_cert_auth = false;
         bool sasl_mechanisms = false;
         bool ssl_sasl_mechanisms = false;
@@ -984,6 +1108,8 @@ public:
         bool opcode_attributes_override = false;
         bool tracing_enabled = false;
         bool stdin_listener = false;
+        bool per_thread_listeners = false;
+        bool connection_placement = false;
         bool scramsha_fallback_salt = false;
         bool external_auth_service = false;
         bool active_external_users_push_interval = false;
@@ -995,10 +1121,13 @@ public:
         bool num_writer_threads = false;
         bool num_auxio_threads = false;
         bool num_nonio_threads = false;
+        bool executor_work_stealing_quota = false;
+        bool executor_numa_affinity = false;
         bool num_storage_threads = false;
         bool portnumber_file = false;
         bool parent_identifier = false;
         bool prometheus_config = false;
+        bool prometheus_high_cardinality_cache_time = false;
         bool phosphor_config = false;
         bool enforce_tenant_limits_enabled = false;
         bool whitelist_localhost_interface = false;
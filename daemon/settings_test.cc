@@ -496,6 +496,57 @@ TEST_F(SettingsTest, StdinListener) {
     }
 }
 
+TEST_F(SettingsTest, PerThreadListeners) {
+    nonBooleanValuesShouldFail("per_thread_listeners");
+
+    nlohmann::json obj;
+    obj["per_thread_listeners"] = true;
+    try {
+        Settings settings(obj);
+        EXPECT_TRUE(settings.isPerThreadListenersEnabled());
+        EXPECT_TRUE(settings.has.per_thread_listeners);
+    } catch (std::exception& exception) {
+        FAIL() << exception.what();
+    }
+
+    obj["per_thread_listeners"] = false;
+    try {
+        Settings settings(obj);
+        EXPECT_FALSE(settings.isPerThreadListenersEnabled());
+        EXPECT_TRUE(settings.has.per_thread_listeners);
+    } catch (std::exception& exception) {
+        FAIL() << exception.what();
+    }
+}
+
+TEST_F(SettingsTest, ConnectionPlacement) {
+    nonStringValuesShouldFail("connection_placement");
+
+    nlohmann::json obj;
+    obj["connection_placement"] = "least_loaded";
+    try {
+        Settings settings(obj);
+        EXPECT_EQ(ConnectionPlacement::LeastLoaded,
+                  settings.getConnectionPlacement());
+        EXPECT_TRUE(settings.has.connection_placement);
+    } catch (std::exception& exception) {
+        FAIL() << exception.what();
+    }
+
+    obj["connection_placement"] = "round_robin";
+    try {
+        Settings settings(obj);
+        EXPECT_EQ(ConnectionPlacement::RoundRobin,
+                  settings.getConnectionPlacement());
+        EXPECT_TRUE(settings.has.connection_placement);
+    } catch (std::exception& exception) {
+        FAIL() << exception.what();
+    }
+
+    obj["connection_placement"] = "random";
+    expectFail<std::invalid_argument>(obj);
+}
+
 TEST_F(SettingsTest, DefaultReqsPerEvent) {
     nonNumericValuesShouldFail("default_reqs_per_event");
 
@@ -708,6 +759,69 @@ TEST_F(SettingsTest, max_packet_size) {
     }
 }
 
+TEST_F(SettingsTest, background_inflate_threshold) {
+    nonNumericValuesShouldFail("background_inflate_threshold");
+
+    nlohmann::json obj;
+    obj["background_inflate_threshold"] = 4096;
+    Settings settings(obj);
+    EXPECT_EQ(4096, settings.getBackgroundInflateThreshold());
+    EXPECT_TRUE(settings.has.background_inflate_threshold);
+}
+
+TEST_F(SettingsTest, ExecutorWorkStealingQuota) {
+    nonNumericValuesShouldFail("executor_work_stealing_quota");
+
+    nlohmann::json obj;
+    obj["executor_work_stealing_quota"] = 50;
+    Settings settings(obj);
+    EXPECT_EQ(50, settings.getExecutorWorkStealingQuota());
+    EXPECT_TRUE(settings.has.executor_work_stealing_quota);
+
+    obj["executor_work_stealing_quota"] = 101;
+    expectFail<std::invalid_argument>(obj);
+}
+
+TEST_F(SettingsTest, PrometheusHighCardinalityCacheTime) {
+    nlohmann::json obj;
+    obj["prometheus_high_cardinality_cache_time"] = 10;
+    Settings settings(obj);
+    EXPECT_EQ(std::chrono::seconds(10),
+              settings.getPrometheusHighCardinalityCacheTime());
+    EXPECT_TRUE(settings.has.prometheus_high_cardinality_cache_time);
+
+    obj["prometheus_high_cardinality_cache_time"] = "500 ms";
+    Settings msSettings(obj);
+    EXPECT_EQ(std::chrono::milliseconds(500),
+              msSettings.getPrometheusHighCardinalityCacheTime());
+
+    obj["prometheus_high_cardinality_cache_time"] = true;
+    expectFail<nlohmann::json::exception>(obj);
+}
+
+TEST_F(SettingsTest, ExecutorNumaAffinity) {
+    nonBooleanValuesShouldFail("executor_numa_affinity");
+
+    nlohmann::json obj;
+    obj["executor_numa_affinity"] = true;
+    try {
+        Settings settings(obj);
+        EXPECT_TRUE(settings.isExecutorNumaAffinityEnabled());
+        EXPECT_TRUE(settings.has.executor_numa_affinity);
+    } catch (std::exception& exception) {
+        FAIL() << exception.what();
+    }
+
+    obj["executor_numa_affinity"] = false;
+    try {
+        Settings settings(obj);
+        EXPECT_FALSE(settings.isExecutorNumaAffinityEnabled());
+        EXPECT_TRUE(settings.has.executor_numa_affinity);
+    } catch (std::exception& exception) {
+        FAIL() << exception.what();
+    }
+}
+
 TEST_F(SettingsTest, max_connections) {
     nonNumericValuesShouldFail("max_connections");
 
@@ -1029,6 +1143,37 @@ TEST(SettingsUpdateTest, ThreadsIsNotDynamic) {
                  std::invalid_argument);
 }
 
+TEST(SettingsUpdateTest, PerThreadListenersIsNotDynamic) {
+    Settings updated;
+    Settings settings;
+    // setting it to the same value should work
+    settings.setPerThreadListenersEnabled(true);
+    updated.setPerThreadListenersEnabled(true);
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+
+    // Changing it should fail
+    updated.setPerThreadListenersEnabled(false);
+    EXPECT_THROW(settings.updateSettings(updated, false),
+                 std::invalid_argument);
+}
+
+TEST(SettingsUpdateTest, ConnectionPlacementIsDynamic) {
+    Settings settings;
+    Settings updated;
+    // setting it to the same value should work
+    updated.setConnectionPlacement(settings.getConnectionPlacement());
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+
+    // Changing it should also work
+    updated.setConnectionPlacement(ConnectionPlacement::LeastLoaded);
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+    EXPECT_EQ(ConnectionPlacement::RoundRobin,
+              settings.getConnectionPlacement());
+    EXPECT_NO_THROW(settings.updateSettings(updated, true));
+    EXPECT_EQ(ConnectionPlacement::LeastLoaded,
+              settings.getConnectionPlacement());
+}
+
 TEST(SettingsUpdateTest, UpdatingLoggerSettingsShouldFail) {
     Settings settings;
     Settings updated;
@@ -1242,6 +1387,64 @@ TEST(SettingsUpdateTest, MaxPacketSizeIsDynamic) {
     EXPECT_EQ(updated.getMaxPacketSize(), settings.getMaxPacketSize());
 }
 
+TEST(SettingsUpdateTest, BackgroundInflateThresholdIsDynamic) {
+    Settings settings;
+    Settings updated;
+    // setting it to the same value should work
+    auto old = settings.getBackgroundInflateThreshold();
+    updated.setBackgroundInflateThreshold(old);
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+
+    // changing it should work
+    updated.setBackgroundInflateThreshold(0);
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+    EXPECT_EQ(old, settings.getBackgroundInflateThreshold());
+    EXPECT_NO_THROW(settings.updateSettings(updated));
+    EXPECT_EQ(0, settings.getBackgroundInflateThreshold());
+}
+
+TEST(SettingsUpdateTest, ExecutorWorkStealingQuotaIsDynamic) {
+    Settings settings;
+    Settings updated;
+    // setting it to the same value should work
+    auto old = settings.getExecutorWorkStealingQuota();
+    updated.setExecutorWorkStealingQuota(old);
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+
+    // changing it should work
+    updated.setExecutorWorkStealingQuota(25);
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+    EXPECT_EQ(old, settings.getExecutorWorkStealingQuota());
+    EXPECT_NO_THROW(settings.updateSettings(updated));
+    EXPECT_EQ(25, settings.getExecutorWorkStealingQuota());
+}
+
+TEST(SettingsUpdateTest, PrometheusHighCardinalityCacheTimeIsDynamic) {
+    Settings settings;
+    Settings updated;
+    updated.setPrometheusHighCardinalityCacheTime(std::chrono::seconds(5));
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+    EXPECT_EQ(std::chrono::milliseconds(0),
+              settings.getPrometheusHighCardinalityCacheTime());
+    EXPECT_NO_THROW(settings.updateSettings(updated));
+    EXPECT_EQ(std::chrono::seconds(5),
+              settings.getPrometheusHighCardinalityCacheTime());
+}
+
+TEST(SettingsUpdateTest, ExecutorNumaAffinityIsNotDynamic) {
+    Settings updated;
+    Settings settings;
+    // setting it to the same value should work
+    settings.setExecutorNumaAffinityEnabled(true);
+    updated.setExecutorNumaAffinityEnabled(true);
+    EXPECT_NO_THROW(settings.updateSettings(updated, false));
+
+    // Changing it should fail
+    updated.setExecutorNumaAffinityEnabled(false);
+    EXPECT_THROW(settings.updateSettings(updated, false),
+                 std::invalid_argument);
+}
+
 TEST(SettingsUpdateTest, SaslMechanismsIsDynamic) {
     Settings settings;
     Settings updated;
@@ -26,6 +26,7 @@
 #include <platform/socket.h>
 #include <platform/strerror.h>
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <cstdlib>
@@ -129,6 +130,7 @@ void FrontEndThread::dispatch_new_connections() {
             if (system) {
                 --stats.system_conns;
             }
+            --numConnections;
             safe_close(entry.sock);
         }
     }
@@ -174,15 +176,71 @@ void scheduleDcpStep(Cookie& cookie) {
     });
 }
 
+/// How often the busy time of the front end threads is sampled for the
+/// least_loaded connection placement
+static constexpr std::chrono::milliseconds BusySampleInterval{100};
+
+void FrontEndThread::sampleBusyTime(std::chrono::steady_clock::time_point now) {
+    const auto busy = busyTime.load(std::memory_order_relaxed);
+    const auto elapsed =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    now - lastBusySample)
+                    .count();
+    if (elapsed > 0) {
+        busyFraction.store(
+                std::min(1.0, double(busy - lastBusyTime) / double(elapsed)),
+                std::memory_order_relaxed);
+    }
+    lastBusyTime = busy;
+    lastBusySample = now;
+}
+
+/// Pick the thread with the lowest load, preferring the acceptor (if any) or
+/// else the first thread with the lowest load
+static FrontEndThread& getLeastLoadedThread(FrontEndThread* acceptor) {
+    static std::atomic<std::chrono::steady_clock::rep> nextSample{0};
+    const auto now = std::chrono::steady_clock::now();
+    auto next = nextSample.load();
+    // Only one dispatcher samples the threads per interval
+    if (now.time_since_epoch().count() >= next &&
+        nextSample.compare_exchange_strong(
+                next, (now + BusySampleInterval).time_since_epoch().count())) {
+        FrontEndThread::forEach(
+                [now](auto& thread) { thread.sampleBusyTime(now); });
+    }
+
+    auto* ret = acceptor ? acceptor : &threads.front();
+    auto lowest = ret->getLoad();
+    for (auto& thread : threads) {
+        const auto load = thread.getLoad();
+        if (load < lowest) {
+            ret = &thread;
+            lowest = load;
+        }
+    }
+    return *ret;
+}
+
 void FrontEndThread::dispatch(SOCKET sfd,
                               std::shared_ptr<ListeningPort> descr,
-                              uniqueSslPtr ssl) {
-    // Which thread we assigned a connection to most recently.
-    static std::atomic<size_t> last_thread = 0;
-    size_t tid = (last_thread + 1) % Settings::instance().getNumWorkerThreads();
-    auto& thread = threads[tid];
-    last_thread = tid;
+                              uniqueSslPtr ssl,
+                              FrontEndThread* acceptor) {
+    FrontEndThread* selected = acceptor;
+    if (Settings::instance().getConnectionPlacement() ==
+        ConnectionPlacement::LeastLoaded) {
+        selected = &getLeastLoadedThread(acceptor);
+    } else if (!selected) {
+        // Which thread we assigned a connection to most recently.
+        static std::atomic<size_t> last_thread = 0;
+        size_t tid =
+                (last_thread + 1) % Settings::instance().getNumWorkerThreads();
+        selected = &threads[tid];
+        last_thread = tid;
+    }
+    auto& thread = *selected;
+    const bool system = descr->system;
 
+    ++thread.numConnections;
     try {
         thread.new_conn_queue.push(sfd, std::move(descr), move(ssl));
         thread.eventBase.runInEventBaseThread([&thread]() {
@@ -199,13 +257,20 @@ void FrontEndThread::dispatch(SOCKET sfd,
         LOG_WARNING("dispatch_conn_new: Failed to dispatch new connection: {}",
                     e.what());
 
-        if (descr->system) {
+        --thread.numConnections;
+        if (system) {
             --stats.system_conns;
         }
         safe_close(sfd);
     }
 }
 
+void FrontEndThread::forEach(std::function<void(FrontEndThread&)> callback) {
+    for (auto& thread : threads) {
+        callback(thread);
+    }
+}
+
 /******************************* GLOBAL STATS ******************************/
 
 void threadlocal_stats_reset(std::vector<thread_stats>& thread_stats) {
@@ -104,6 +104,7 @@ static const cb::mcbp::ClientOpcode timings_retrievals[] = {
         cb::mcbp::ClientOpcode::GetLocked,
         cb::mcbp::ClientOpcode::GetRandomKey,
         cb::mcbp::ClientOpcode::GetReplica,
+        cb::mcbp::ClientOpcode::GetMulti,
         cb::mcbp::ClientOpcode::SubdocMultiLookup,
         cb::mcbp::ClientOpcode::SubdocGet,
         cb::mcbp::ClientOpcode::SubdocExists};
@@ -149,7 +150,10 @@ Hdr1sfMicroSecHistogram& Timings::get_or_create_timing_histogram(
     if (!timings[opcode]) {
         std::lock_guard<std::mutex> allocLock(histogram_mutex);
         if (!timings[opcode]) {
-            timings[opcode] = new Hdr1sfMicroSecHistogram();
+            // Every front-end thread records into these; shard them to
+            // avoid the threads contending on the histogram's lock.
+            timings[opcode] = new Hdr1sfMicroSecHistogram(
+                    HdrHistogram::Recording::Sharded);
         }
     }
     return *(timings[opcode].load());
@@ -16,6 +16,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <mutex>
 #include <thread>
@@ -25,13 +27,20 @@
 #define hashsize(n) ((size_t)1<<(n))
 #define hashmask(n) (hashsize(n)-1)
 
+/*
+ * Number of (power of 2) lock stripes protecting the hash chains. Must not
+ * exceed the number of buckets in the initial table (so that every item in
+ * a bucket of the old table maps to the same stripe while expanding).
+ */
+#define ASSOC_LOCK_POWER 10
+
 struct Assoc {
     explicit Assoc(unsigned int hp) : hashpower(hp) {
         primary_hashtable.resize(hashsize(hashpower));
     }
 
     /* how many powers of 2's worth of buckets we use */
-    unsigned int hashpower;
+    std::atomic<unsigned int> hashpower;
 
 
     /* Main hash table. This is where we look except during expansion. */
@@ -44,21 +53,41 @@ struct Assoc {
     std::vector<hash_item*> old_hashtable;
 
     /* Number of items in the hash table. */
-    unsigned int hash_items{0};
+    std::atomic<unsigned int> hash_items{0};
 
     /* Flag: Are we in the middle of expanding now? */
-    bool expanding{false};
+    std::atomic<bool> expanding{false};
 
     /*
      * During expansion we migrate values with bucket granularity; this is how
      * far we've gotten so far. Ranges from 0 .. hashsize(hashpower - 1) - 1.
      */
-    unsigned int expand_bucket{0};
+    std::atomic<unsigned int> expand_bucket{0};
 
     /*
-     * serialise access to the hashtable
+     * serialise access to the hash chains; a bucket is protected by the
+     * stripe selected by the low order bits of the hash. The tables
+     * themselves (and hashpower) are only swapped / resized while holding
+     * every stripe.
      */
-    std::mutex mutex;
+    std::array<std::mutex, hashsize(ASSOC_LOCK_POWER)> stripes;
+
+    std::mutex& getStripe(uint32_t hash) {
+        return stripes[hash & hashmask(ASSOC_LOCK_POWER)];
+    }
+
+    /* Acquire (and release) every stripe, in order */
+    void lockAll() {
+        for (auto& m : stripes) {
+            m.lock();
+        }
+    }
+
+    void unlockAll() {
+        for (auto& m : stripes) {
+            m.unlock();
+        }
+    }
 };
 
 /* One hashtable for all */
@@ -99,7 +128,7 @@ hash_item *assoc_find(uint32_t hash, const hash_key *key) {
     unsigned int oldbucket;
     hash_item *ret = nullptr;
     int depth = 0;
-    std::lock_guard<std::mutex> guard(global_assoc->mutex);
+    std::lock_guard<std::mutex> guard(global_assoc->getStripe(hash));
     if (global_assoc->expanding &&
         (oldbucket = (hash & hashmask(global_assoc->hashpower - 1))) >= global_assoc->expand_bucket)
     {
@@ -126,7 +155,7 @@ hash_item *assoc_find(uint32_t hash, const hash_key *key) {
 /*
     returns the address of the item pointer before the key.  if *item == 0,
     the item wasn't found
-    assoc->lock is assumed to be held by the caller.
+    the stripe for hash is assumed to be held by the caller.
 */
 static hash_item** _hashitem_before(uint32_t hash, const hash_key* key) {
     hash_item **pos;
@@ -159,7 +188,7 @@ static void assoc_maintenance_thread(void *arg);
 
 /*
     grows the hashtable to the next power of 2.
-    assoc->lock is assumed to be held by the caller.
+    every stripe is assumed to be held by the caller.
 */
 static void assoc_expand() {
     global_assoc->old_hashtable.swap(global_assoc->primary_hashtable);
@@ -193,32 +222,49 @@ static void assoc_expand() {
     }
 }
 
+/* Start expanding the table if it has grown too large (and isn't already) */
+static void assoc_maybe_expand() {
+    auto needsExpand = [] {
+        return !global_assoc->expanding &&
+               global_assoc->hash_items >
+                       (hashsize(global_assoc->hashpower) * 3) / 2;
+    };
+    if (!needsExpand()) {
+        return;
+    }
+    global_assoc->lockAll();
+    if (needsExpand()) {
+        assoc_expand();
+    }
+    global_assoc->unlockAll();
+}
+
 /* Note: this isn't an assoc_update.  The key must not already exist to call this */
 int assoc_insert(uint32_t hash, hash_item *it) {
     unsigned int oldbucket;
 
     cb_assert(assoc_find(hash, item_get_key(it)) == nullptr);  /* shouldn't have duplicately named things defined */
 
-    std::lock_guard<std::mutex> guard(global_assoc->mutex);
-    if (global_assoc->expanding &&
-        (oldbucket = (hash & hashmask(global_assoc->hashpower - 1))) >= global_assoc->expand_bucket)
     {
-        it->h_next = global_assoc->old_hashtable[oldbucket];
-        global_assoc->old_hashtable[oldbucket] = it;
-    } else {
-        it->h_next = global_assoc->primary_hashtable[hash & hashmask(global_assoc->hashpower)];
-        global_assoc->primary_hashtable[hash & hashmask(global_assoc->hashpower)] = it;
+        std::lock_guard<std::mutex> guard(global_assoc->getStripe(hash));
+        if (global_assoc->expanding &&
+            (oldbucket = (hash & hashmask(global_assoc->hashpower - 1))) >= global_assoc->expand_bucket)
+        {
+            it->h_next = global_assoc->old_hashtable[oldbucket];
+            global_assoc->old_hashtable[oldbucket] = it;
+        } else {
+            it->h_next = global_assoc->primary_hashtable[hash & hashmask(global_assoc->hashpower)];
+            global_assoc->primary_hashtable[hash & hashmask(global_assoc->hashpower)] = it;
+        }
     }
 
     global_assoc->hash_items++;
-    if (! global_assoc->expanding && global_assoc->hash_items > (hashsize(global_assoc->hashpower) * 3) / 2) {
-        assoc_expand();
-    }
+    assoc_maybe_expand();
     return 1;
 }
 
 void assoc_delete(uint32_t hash, const hash_key *key) {
-    std::lock_guard<std::mutex> guard(global_assoc->mutex);
+    std::lock_guard<std::mutex> guard(global_assoc->getStripe(hash));
     hash_item **before = _hashitem_before(hash, key);
 
     if (*before) {
@@ -243,13 +289,22 @@ static void assoc_maintenance_thread(void *arg) {
     bool done = false;
     do {
         int ii;
-        std::lock_guard<std::mutex> guard(global_assoc->mutex);
 
-        for (ii = 0; ii < hash_bulk_move && global_assoc->expanding; ++ii) {
+        for (ii = 0; ii < hash_bulk_move &&
+                     global_assoc->expand_bucket <
+                             hashsize(global_assoc->hashpower - 1);
+             ++ii) {
             hash_item *it, *next;
             int bucket;
 
-            for (it = global_assoc->old_hashtable[global_assoc->expand_bucket];
+            /*
+             * Every item in the old bucket (and both of the primary buckets
+             * it splits into) shares the same stripe.
+             */
+            const unsigned int old_bucket = global_assoc->expand_bucket;
+            std::lock_guard<std::mutex> guard(
+                    global_assoc->getStripe(old_bucket));
+            for (it = global_assoc->old_hashtable[old_bucket];
                  nullptr != it; it = next) {
                 next = it->h_next;
                 const hash_key* key = item_get_key(it);
@@ -260,14 +315,18 @@ static void assoc_maintenance_thread(void *arg) {
                 global_assoc->primary_hashtable[bucket] = it;
             }
 
-            global_assoc->old_hashtable[global_assoc->expand_bucket] = nullptr;
+            global_assoc->old_hashtable[old_bucket] = nullptr;
             global_assoc->expand_bucket++;
-            if (global_assoc->expand_bucket == hashsize(global_assoc->hashpower - 1)) {
-                global_assoc->expanding = false;
-                global_assoc->old_hashtable.resize(0);
-                global_assoc->old_hashtable.shrink_to_fit();
-                LOG_INFO_RAW("Hash table expansion done");
-            }
+        }
+
+        if (global_assoc->expand_bucket ==
+            hashsize(global_assoc->hashpower - 1)) {
+            global_assoc->lockAll();
+            global_assoc->expanding = false;
+            global_assoc->old_hashtable.resize(0);
+            global_assoc->old_hashtable.shrink_to_fit();
+            global_assoc->unlockAll();
+            LOG_INFO_RAW("Hash table expansion done");
         }
         if (!global_assoc->expanding) {
             done = true;
@@ -276,6 +335,5 @@ static void assoc_maintenance_thread(void *arg) {
 }
 
 bool assoc_expanding() {
-    std::lock_guard<std::mutex> guard(global_assoc->mutex);
     return global_assoc->expanding;
 }
@@ -38,7 +38,7 @@ struct default_engine;
 
 struct config {
    size_t verbose;
-   rel_time_t oldest_live;
+   std::atomic<rel_time_t> oldest_live;
    bool evict_to_free;
    size_t maxbytes;
    bool preallocate;
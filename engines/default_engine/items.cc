@@ -20,12 +20,15 @@
 /* Forward Declarations */
 static void item_link_q(struct default_engine *engine, hash_item *it);
 static void item_unlink_q(struct default_engine *engine, hash_item *it);
+static void do_item_link_q(struct default_engine *engine, hash_item *it);
+static void do_item_unlink_q(struct default_engine *engine, hash_item *it);
 static hash_item *do_item_alloc(struct default_engine *engine,
                                 const hash_key *key,
                                 const int flags, const rel_time_t exptime,
                                 const int nbytes,
                                 const void *cookie,
-                                uint8_t datatype);
+                                uint8_t datatype,
+                                const std::mutex* held_lock);
 static hash_item* do_item_get(struct default_engine* engine,
                               const hash_key* key,
                               const DocStateFilter document_state);
@@ -33,6 +36,8 @@ static int do_item_link(struct default_engine* engine,
                         CookieIface* cookie,
                         hash_item* it);
 static void do_item_unlink(struct default_engine *engine, hash_item *it);
+static void do_item_unlink_lru_locked(struct default_engine* engine,
+                                      hash_item* it);
 static cb::engine_errc do_safe_item_unlink(struct default_engine* engine,
                                            hash_item* it);
 static void do_item_release(struct default_engine *engine, hash_item *it);
@@ -63,8 +68,46 @@ static void hash_key_copy_to_item(hash_item* dst, const hash_key* src);
 static const int search_items = 50;
 
 void item_stats_reset(struct default_engine *engine) {
-    std::lock_guard<std::mutex> guard(engine->items.lock);
-    memset(engine->items.itemstats, 0, sizeof(engine->items.itemstats));
+    for (int i = 0; i < POWER_LARGEST; i++) {
+        std::lock_guard<std::mutex> guard(engine->items.lru_locks[i]);
+        memset(&engine->items.itemstats[i], 0, sizeof(itemstats_t));
+    }
+}
+
+/* The lock protecting all items with the given key */
+static std::mutex& item_lock(struct default_engine* engine,
+                             const hash_key* key) {
+    const auto hash =
+            crc32c(hash_key_get_key(key), hash_key_get_key_len(key), 0);
+    return engine->items.item_locks[hash & (ITEM_LOCK_STRIPES - 1)];
+}
+
+/* Cursors (used by the scrubber to walk an LRU) have no key and no value */
+static bool item_is_cursor(const hash_item* it) {
+    return item_get_key(it)->header.len == 0 && it->nbytes == 0;
+}
+
+/*
+ * Try to acquire the item lock for it, for use when walking an LRU (i.e.
+ * when already holding an LRU lock, which is the wrong lock order to block
+ * on an item lock).
+ * @param held_lock the item lock the caller already holds, or nullptr
+ * @return true if the caller may access the item (guard owns the lock, or
+ *         it is held_lock), false if the lock is busy or it is a cursor.
+ */
+static bool item_try_lock(struct default_engine* engine,
+                          const hash_item* it,
+                          const std::mutex* held_lock,
+                          std::unique_lock<std::mutex>& guard) {
+    if (item_is_cursor(it)) {
+        return false;
+    }
+    auto& lock = item_lock(engine, item_get_key(it));
+    if (&lock == held_lock) {
+        return true;
+    }
+    guard = std::unique_lock<std::mutex>(lock, std::try_to_lock);
+    return guard.owns_lock();
 }
 
 
@@ -77,7 +120,7 @@ static size_t ITEM_ntotal(struct default_engine *engine,
 
 /* Get the next CAS id for a new item. */
 static uint64_t get_cas_id() {
-    static uint64_t cas_id = 0;
+    static std::atomic<uint64_t> cas_id{0};
     return ++cas_id;
 }
 
@@ -100,7 +143,8 @@ hash_item *do_item_alloc(struct default_engine *engine,
                          const rel_time_t exptime,
                          const int nbytes,
                          const void *cookie,
-                         uint8_t datatype) {
+                         uint8_t datatype,
+                         const std::mutex* held_lock) {
     hash_item *it = nullptr;
     int tries = search_items;
     hash_item *search;
@@ -118,9 +162,24 @@ hash_item *do_item_alloc(struct default_engine *engine,
     oldest_live = engine->config.oldest_live;
     current_time = engine->server.core->get_current_time();
 
+    /*
+     * Only this slab class' LRU is locked; items found in it are only
+     * inspected if their item lock can be acquired without waiting.
+     */
+    std::lock_guard<std::mutex> lru_guard(engine->items.lru_locks[id]);
+
     for (search = engine->items.tails[id];
          tries > 0 && search != nullptr;
          tries--, search=search->prev) {
+        /* Cheap check (without the item lock) if it may be reclaimed */
+        if (!((search->time < oldest_live) ||
+              (search->exptime != 0 && search->exptime < current_time))) {
+            continue;
+        }
+        std::unique_lock<std::mutex> item_guard;
+        if (!item_try_lock(engine, search, held_lock, item_guard)) {
+            continue;
+        }
         if (search->refcount == 0 &&
             ((search->time < oldest_live) || /* dead by flush */
              (search->exptime != 0 && search->exptime < current_time)) &&
@@ -133,7 +192,7 @@ hash_item *do_item_alloc(struct default_engine *engine,
             engine->items.itemstats[id].reclaimed++;
             it->refcount = 1;
             slabs_adjust_mem_requested(engine, it->slabs_clsid, ITEM_ntotal(engine, it), ntotal);
-            do_item_unlink(engine, it);
+            do_item_unlink_lru_locked(engine, it);
             /* Initialize the item block: */
             it->slabs_clsid = 0;
             it->refcount = 0;
@@ -171,6 +230,10 @@ hash_item *do_item_alloc(struct default_engine *engine,
         }
 
         for (search = engine->items.tails[id]; tries > 0 && search != nullptr; tries--, search=search->prev) {
+            std::unique_lock<std::mutex> item_guard;
+            if (!item_try_lock(engine, search, held_lock, item_guard)) {
+                continue;
+            }
             if (search->refcount == 0 && search->locktime <= current_time) {
                 if (search->exptime == 0 || search->exptime > current_time) {
                     engine->items.itemstats[id].evicted++;
@@ -183,7 +246,7 @@ hash_item *do_item_alloc(struct default_engine *engine,
                     engine->items.itemstats[id].reclaimed++;
                     engine->stats.reclaimed++;
                 }
-                do_item_unlink(engine, search);
+                do_item_unlink_lru_locked(engine, search);
                 break;
             }
         }
@@ -199,10 +262,14 @@ hash_item *do_item_alloc(struct default_engine *engine,
              */
             tries = search_items;
             for (search = engine->items.tails[id]; tries > 0 && search != nullptr; tries--, search=search->prev) {
+                std::unique_lock<std::mutex> item_guard;
+                if (!item_try_lock(engine, search, held_lock, item_guard)) {
+                    continue;
+                }
                 if (search->refcount != 0 && search->time + TAIL_REPAIR_TIME < current_time) {
                     engine->items.itemstats[id].tailrepairs++;
                     search->refcount = 0;
-                    do_item_unlink(engine, search);
+                    do_item_unlink_lru_locked(engine, search);
                     break;
                 }
             }
@@ -236,8 +303,6 @@ static void item_free(struct default_engine *engine, hash_item *it) {
     size_t ntotal = ITEM_ntotal(engine, it);
     unsigned int clsid;
     cb_assert((it->iflag & ITEM_LINKED) == 0);
-    cb_assert(it != engine->items.heads[it->slabs_clsid]);
-    cb_assert(it != engine->items.tails[it->slabs_clsid]);
     cb_assert(it->refcount == 0 || engine->scrubber.force_delete);
 
     /* so slab size changer can tell later if item is already free or not */
@@ -248,7 +313,8 @@ static void item_free(struct default_engine *engine, hash_item *it) {
     slabs_free(engine, it, ntotal, clsid);
 }
 
-static void item_link_q(struct default_engine *engine, hash_item *it) { /* item is the new head */
+/* LRU lock of its class is assumed to be held by the caller */
+static void do_item_link_q(struct default_engine *engine, hash_item *it) { /* item is the new head */
     hash_item **head, **tail;
     cb_assert(it->slabs_clsid < POWER_LARGEST);
     cb_assert((it->iflag & ITEM_SLABBED) == 0);
@@ -266,7 +332,8 @@ static void item_link_q(struct default_engine *engine, hash_item *it) { /* item
     return;
 }
 
-static void item_unlink_q(struct default_engine *engine, hash_item *it) {
+/* LRU lock of its class is assumed to be held by the caller */
+static void do_item_unlink_q(struct default_engine *engine, hash_item *it) {
     hash_item **head, **tail;
     cb_assert(it->slabs_clsid < POWER_LARGEST);
     head = &engine->items.heads[it->slabs_clsid];
@@ -289,6 +356,18 @@ static void item_unlink_q(struct default_engine *engine, hash_item *it) {
     return;
 }
 
+static void item_link_q(struct default_engine *engine, hash_item *it) {
+    std::lock_guard<std::mutex> guard(
+            engine->items.lru_locks[it->slabs_clsid]);
+    do_item_link_q(engine, it);
+}
+
+static void item_unlink_q(struct default_engine *engine, hash_item *it) {
+    std::lock_guard<std::mutex> guard(
+            engine->items.lru_locks[it->slabs_clsid]);
+    do_item_unlink_q(engine, it);
+}
+
 int do_item_link(struct default_engine* engine,
                  CookieIface* cookie,
                  hash_item* it) {
@@ -331,7 +410,9 @@ int do_item_link(struct default_engine* engine,
     return 1;
 }
 
-void do_item_unlink(struct default_engine *engine, hash_item *it) {
+static void do_item_unlink_impl(struct default_engine* engine,
+                                hash_item* it,
+                                bool lru_locked) {
     const hash_key* key = item_get_key(it);
     if ((it->iflag & ITEM_LINKED) != 0) {
         it->iflag &= ~ITEM_LINKED;
@@ -339,13 +420,26 @@ void do_item_unlink(struct default_engine *engine, hash_item *it) {
         engine->stats.curr_items -= 1;
         assoc_delete(crc32c(hash_key_get_key(key), hash_key_get_key_len(key), 0),
                      key);
-        item_unlink_q(engine, it);
+        if (lru_locked) {
+            do_item_unlink_q(engine, it);
+        } else {
+            item_unlink_q(engine, it);
+        }
         if (it->refcount == 0 || engine->scrubber.force_delete) {
             item_free(engine, it);
         }
     }
 }
 
+void do_item_unlink(struct default_engine *engine, hash_item *it) {
+    do_item_unlink_impl(engine, it, false);
+}
+
+/* As do_item_unlink, when the LRU lock of its class is already held */
+void do_item_unlink_lru_locked(struct default_engine* engine, hash_item* it) {
+    do_item_unlink_impl(engine, it, true);
+}
+
 cb::engine_errc do_safe_item_unlink(struct default_engine* engine,
                                     hash_item* it) {
     const hash_key* key = item_get_key(it);
@@ -394,9 +488,11 @@ void do_item_update(struct default_engine *engine, hash_item *it) {
         cb_assert((it->iflag & ITEM_SLABBED) == 0);
 
         if ((it->iflag & ITEM_LINKED) != 0) {
-            item_unlink_q(engine, it);
+            std::lock_guard<std::mutex> guard(
+                    engine->items.lru_locks[it->slabs_clsid]);
+            do_item_unlink_q(engine, it);
             it->time = current_time;
-            item_link_q(engine, it);
+            do_item_link_q(engine, it);
         }
     }
 }
@@ -416,20 +512,28 @@ static void do_item_stats(struct default_engine* engine,
                           const CookieIface* c) {
     int i;
     rel_time_t current_time = engine->server.core->get_current_time();
+    const rel_time_t oldest_live = engine->config.oldest_live;
     for (i = 0; i < POWER_LARGEST; i++) {
+        std::lock_guard<std::mutex> guard(engine->items.lru_locks[i]);
         if (engine->items.tails[i] != nullptr) {
             const char *prefix = "items";
             int search = search_items;
-            while (search > 0 &&
-                   engine->items.tails[i] != nullptr &&
-                   ((engine->config.oldest_live != 0 && /* Item flushd */
-                     engine->config.oldest_live <= current_time &&
-                     engine->items.tails[i]->time <= engine->config.oldest_live) ||
-                    (engine->items.tails[i]->exptime != 0 && /* and not expired */
-                     engine->items.tails[i]->exptime < current_time))) {
+            while (search > 0 && engine->items.tails[i] != nullptr) {
+                hash_item* tail = engine->items.tails[i];
+                std::unique_lock<std::mutex> item_guard;
+                if (!item_try_lock(engine, tail, nullptr, item_guard)) {
+                    break;
+                }
+                if (!((oldest_live != 0 && /* Item flushd */
+                       oldest_live <= current_time &&
+                       tail->time <= oldest_live) ||
+                      (tail->exptime != 0 && /* and not expired */
+                       tail->exptime < current_time))) {
+                    break;
+                }
                 --search;
-                if (engine->items.tails[i]->refcount == 0) {
-                    do_item_unlink(engine, engine->items.tails[i]);
+                if (tail->refcount == 0) {
+                    do_item_unlink_lru_locked(engine, tail);
                 } else {
                     break;
                 }
@@ -474,6 +578,7 @@ static void do_item_stats_sizes(struct default_engine* engine,
 
         /* build the histogram */
         for (i = 0; i < POWER_LARGEST; i++) {
+            std::lock_guard<std::mutex> guard(engine->items.lru_locks[i]);
             hash_item *iter = engine->items.heads[i];
             while (iter) {
                 size_t ntotal = ITEM_ntotal(engine, iter);
@@ -517,12 +622,12 @@ hash_item* do_item_get(struct default_engine* engine,
     if (it != nullptr && engine->config.oldest_live != 0 &&
         engine->config.oldest_live <= current_time &&
         it->time <= engine->config.oldest_live) {
-        do_item_unlink(engine, it);           /* MTSAFE - items.lock held */
+        do_item_unlink(engine, it);           /* MTSAFE - item lock held */
         it = nullptr;
     }
 
     if (it != nullptr && it->exptime != 0 && it->exptime <= current_time) {
-        do_item_unlink(engine, it);           /* MTSAFE - items.lock held */
+        do_item_unlink(engine, it);           /* MTSAFE - item lock held */
         it = nullptr;
     }
 
@@ -586,7 +691,7 @@ static cb::engine_errc do_store_item(struct default_engine* engine,
             /* it and old_it may belong to different classes. */
             /* I'm updating the stats for the one that's getting pushed out */
             if (preserveTtl) {
-                it->exptime = old_it->exptime;
+                it->exptime = old_it->exptime.load();
             }
             do_item_replace(engine, cookie, old_it, it);
             stored = cb::engine_errc::success;
@@ -607,7 +712,7 @@ static cb::engine_errc do_store_item(struct default_engine* engine,
             stored = cb::engine_errc::success;
             if (old_it != nullptr) {
                 if (preserveTtl) {
-                    it->exptime = old_it->exptime;
+                    it->exptime = old_it->exptime.load();
                 }
                 do_item_replace(engine, cookie, old_it, it);
             } else {
@@ -647,11 +752,8 @@ hash_item* item_alloc(struct default_engine* engine,
         return nullptr;
     }
 
-    {
-        std::lock_guard<std::mutex> guard(engine->items.lock);
-        it = do_item_alloc(
-                engine, &hkey, flags, exptime, nbytes, cookie, datatype);
-    }
+    it = do_item_alloc(
+            engine, &hkey, flags, exptime, nbytes, cookie, datatype, nullptr);
     hash_key_destroy(&hkey);
     return it;
 }
@@ -682,7 +784,7 @@ hash_item* item_get(struct default_engine* engine,
                     const CookieIface* cookie,
                     const hash_key& key,
                     const DocStateFilter state) {
-    std::lock_guard<std::mutex> guard(engine->items.lock);
+    std::lock_guard<std::mutex> guard(item_lock(engine, &key));
     return do_item_get(engine, &key, state);
 }
 
@@ -691,7 +793,7 @@ hash_item* item_get(struct default_engine* engine,
  * needed.
  */
 void item_release(struct default_engine *engine, hash_item *item) {
-    std::lock_guard<std::mutex> guard(engine->items.lock);
+    std::lock_guard<std::mutex> guard(item_lock(engine, item_get_key(item)));
     do_item_release(engine, item);
 }
 
@@ -699,12 +801,12 @@ void item_release(struct default_engine *engine, hash_item *item) {
  * Unlinks an item from the LRU and hashtable.
  */
 void item_unlink(struct default_engine *engine, hash_item *item) {
-    std::lock_guard<std::mutex> guard(engine->items.lock);
+    std::lock_guard<std::mutex> guard(item_lock(engine, item_get_key(item)));
     do_item_unlink(engine, item);
 }
 
 cb::engine_errc safe_item_unlink(struct default_engine* engine, hash_item* it) {
-    std::lock_guard<std::mutex> guard(engine->items.lock);
+    std::lock_guard<std::mutex> guard(item_lock(engine, item_get_key(it)));
     return do_safe_item_unlink(engine, it);
 }
 
@@ -725,7 +827,7 @@ cb::engine_errc store_item(struct default_engine* engine,
         item->iflag |= ITEM_ZOMBIE;
     }
 
-    std::lock_guard<std::mutex> guard(engine->items.lock);
+    std::lock_guard<std::mutex> guard(item_lock(engine, item_get_key(item)));
     ret = do_store_item(
             engine, item, operation, cookie, &stored_item, preserveTtl);
     if (ret == cb::engine_errc::success) {
@@ -740,6 +842,7 @@ cb::engine_errc do_item_get_locked(struct default_engine* engine,
                                    hash_item** it,
                                    const hash_key* hkey,
                                    rel_time_t locktime) {
+    const auto& held_lock = item_lock(engine, hkey);
     hash_item* item = do_item_get(engine, hkey, DocStateFilter::Alive);
     if (item == nullptr) {
         return cb::engine_errc::no_such_key;
@@ -778,7 +881,8 @@ cb::engine_errc do_item_get_locked(struct default_engine* engine,
         // Unfortunately I can't return the actual object as that'll cause
         // the item's cas to be masked out ;-)
         auto* clone = do_item_alloc(engine, hkey, item->flags, item->exptime,
-                                    item->nbytes, cookie, item->datatype);
+                                    item->nbytes, cookie, item->datatype,
+                                    &held_lock);
         if (clone == nullptr) {
             do_item_release(engine, item);
             return cb::engine_errc::temporary_failure;
@@ -799,14 +903,16 @@ cb::engine_errc do_item_get_locked(struct default_engine* engine,
         // Multiple entities holds a reference to the object. We
         // need to do a copy/replace.
         auto* clone1 = do_item_alloc(engine, hkey, item->flags, item->exptime,
-                                     item->nbytes, cookie, item->datatype);
+                                     item->nbytes, cookie, item->datatype,
+                                     &held_lock);
         if (clone1 == nullptr) {
             do_item_release(engine, item);
             return cb::engine_errc::temporary_failure;
         }
 
         auto* clone2 = do_item_alloc(engine, hkey, item->flags, item->exptime,
-                                     item->nbytes, cookie, item->datatype);
+                                     item->nbytes, cookie, item->datatype,
+                                     &held_lock);
         if (clone2 == nullptr) {
             do_item_release(engine, item);
             do_item_release(engine, clone1);
@@ -844,7 +950,7 @@ cb::engine_errc item_get_locked(struct default_engine* engine,
 
     cb::engine_errc ret;
     {
-        std::lock_guard<std::mutex> guard(engine->items.lock);
+        std::lock_guard<std::mutex> guard(item_lock(engine, &hkey));
         ret = do_item_get_locked(engine, cookie, it, &hkey, locktime);
     }
     hash_key_destroy(&hkey);
@@ -856,6 +962,7 @@ static cb::engine_errc do_item_unlock(struct default_engine* engine,
                                       CookieIface* cookie,
                                       const hash_key* hkey,
                                       uint64_t cas) {
+    const auto& held_lock = item_lock(engine, hkey);
     hash_item* item = do_item_get(engine, hkey, DocStateFilter::Alive);
     if (item == nullptr) {
         return cb::engine_errc::no_such_key;
@@ -885,7 +992,8 @@ static cb::engine_errc do_item_unlock(struct default_engine* engine,
     } else {
         // Someone else holds a reference to the object.
         auto* clone = do_item_alloc(engine, hkey, item->flags, item->exptime,
-                                    item->nbytes, cookie, item->datatype);
+                                    item->nbytes, cookie, item->datatype,
+                                    &held_lock);
         if (clone == nullptr) {
             do_item_release(engine, item);
             return cb::engine_errc::temporary_failure;
@@ -914,7 +1022,7 @@ cb::engine_errc item_unlock(struct default_engine* engine,
 
     cb::engine_errc ret;
     {
-        std::lock_guard<std::mutex> guard(engine->items.lock);
+        std::lock_guard<std::mutex> guard(item_lock(engine, &hkey));
         ret = do_item_unlock(engine, cookie, &hkey, cas);
     }
     hash_key_destroy(&hkey);
@@ -927,6 +1035,7 @@ cb::engine_errc do_item_get_and_touch(struct default_engine* engine,
                                       hash_item** it,
                                       const hash_key* hkey,
                                       rel_time_t exptime) {
+    const auto& held_lock = item_lock(engine, hkey);
     hash_item* item = do_item_get(engine, hkey, DocStateFilter::Alive);
     if (item == nullptr) {
         return cb::engine_errc::no_such_key;
@@ -960,7 +1069,8 @@ cb::engine_errc do_item_get_and_touch(struct default_engine* engine,
         // Multiple entities holds a reference to the object. We
         // need to do a copy/replace.
         auto* clone = do_item_alloc(engine, hkey, item->flags, exptime,
-                                    item->nbytes, cookie, item->datatype);
+                                    item->nbytes, cookie, item->datatype,
+                                    &held_lock);
         if (clone == nullptr) {
             do_item_release(engine, item);
             return cb::engine_errc::temporary_failure;
@@ -991,7 +1101,7 @@ cb::engine_errc item_get_and_touch(struct default_engine* engine,
 
     cb::engine_errc ret;
     {
-        std::lock_guard<std::mutex> guard(engine->items.lock);
+        std::lock_guard<std::mutex> guard(item_lock(engine, &hkey));
         ret = do_item_get_and_touch(engine, cookie, it, &hkey, exptime);
     }
     hash_key_destroy(&hkey);
@@ -1003,27 +1113,30 @@ cb::engine_errc item_get_and_touch(struct default_engine* engine,
  * Flushes expired items after a flush_all call
  */
 void item_flush_expired(struct default_engine *engine) {
-    std::lock_guard<std::mutex> guard(engine->items.lock);
-
     rel_time_t now = engine->server.core->get_current_time();
     if (now > engine->config.oldest_live) {
         engine->config.oldest_live = now - 1;
     }
+    const rel_time_t oldest_live = engine->config.oldest_live;
 
-    for (auto& head : engine->items.heads) {
+    for (int i = 0; i < POWER_LARGEST; i++) {
+        std::lock_guard<std::mutex> guard(engine->items.lru_locks[i]);
         hash_item *iter, *next;
         /*
          * The LRU is sorted in decreasing time order, and an item's
          * timestamp is never newer than its last access time, so we
          * only need to walk back until we hit an item older than the
          * oldest_live time.
-         * The oldest_live checking will auto-expire the remaining items.
+         * The oldest_live checking will auto-expire the remaining items
+         * (including any we skip here as they're currently locked).
          */
-        for (iter = head; iter != nullptr; iter = next) {
-            if (iter->time >= engine->config.oldest_live) {
+        for (iter = engine->items.heads[i]; iter != nullptr; iter = next) {
+            if (iter->time >= oldest_live) {
                 next = iter->next;
-                if ((iter->iflag & ITEM_SLABBED) == 0) {
-                    do_item_unlink(engine, iter);
+                std::unique_lock<std::mutex> item_guard;
+                if ((iter->iflag & ITEM_SLABBED) == 0 &&
+                    item_try_lock(engine, iter, nullptr, item_guard)) {
+                    do_item_unlink_lru_locked(engine, iter);
                 }
             } else {
                 /* We've hit the first old item. Continue to the next queue. */
@@ -1036,14 +1149,12 @@ void item_flush_expired(struct default_engine *engine) {
 void item_stats(struct default_engine* engine,
                 const AddStatFn& add_stat,
                 const CookieIface* cookie) {
-    std::lock_guard<std::mutex> guard(engine->items.lock);
     do_item_stats(engine, add_stat, cookie);
 }
 
 void item_stats_sizes(struct default_engine* engine,
                       const AddStatFn& add_stat,
                       const CookieIface* cookie) {
-    std::lock_guard<std::mutex> guard(engine->items.lock);
     do_item_stats_sizes(engine, add_stat, cookie);
 }
 
@@ -1073,9 +1184,17 @@ static bool do_item_walk_cursor(struct default_engine* engine,
         /* Move cursor */
         hash_item *ptr = cursor->prev;
         bool done = false;
+        const bool is_cursor = item_is_cursor(ptr);
+
+        std::unique_lock<std::mutex> item_guard;
+        if (!is_cursor && !item_try_lock(engine, ptr, nullptr, item_guard)) {
+            /* The item is busy; let the caller drop the LRU lock and
+               come back to it */
+            return true;
+        }
 
         ++ii;
-        item_unlink_q(engine, cursor);
+        do_item_unlink_q(engine, cursor);
 
         if (ptr == engine->items.heads[cursor->slabs_clsid]) {
             done = true;
@@ -1088,7 +1207,7 @@ static bool do_item_walk_cursor(struct default_engine* engine,
         }
 
         /* Ignore cursors */
-        if (item_get_key(ptr)->header.len == 0 && ptr->nbytes == 0) {
+        if (is_cursor) {
             --ii;
         } else {
             *error = itemfunc(engine, ptr, itemdata);
@@ -1124,7 +1243,7 @@ static cb::engine_errc item_scrub(struct default_engine* engine,
 
     if (engine->scrubber.force_delete || (item->refcount == 0 &&
        (item->exptime != 0 && item->exptime < current_time))) {
-        do_item_unlink(engine, item);
+        do_item_unlink_lru_locked(engine, item);
         engine->scrubber.cleaned++;
     }
     return cb::engine_errc::success;
@@ -1135,7 +1254,8 @@ static void item_scrub_class(struct default_engine *engine,
     cb::engine_errc ret;
     bool more;
     do {
-        std::lock_guard<std::mutex> guard(engine->items.lock);
+        std::lock_guard<std::mutex> guard(
+                engine->items.lru_locks[cursor->slabs_clsid]);
         more = do_item_walk_cursor(engine, cursor, 200, item_scrub, nullptr, &ret);
         if (ret != cb::engine_errc::success) {
             break;
@@ -1145,14 +1265,19 @@ static void item_scrub_class(struct default_engine *engine,
 
 void item_scrubber_main(struct default_engine *engine)
 {
-    hash_item cursor;
+    /* The (empty) key must follow the item for item_is_cursor() */
+    struct {
+        hash_item item;
+        hash_key_header key{};
+    } scrub_cursor;
+    hash_item& cursor = scrub_cursor.item;
     int ii;
 
     cursor.refcount = 1;
     for (ii = 0; ii < POWER_LARGEST; ++ii) {
         bool skip = false;
         {
-            std::lock_guard<std::mutex> guard(engine->items.lock);
+            std::lock_guard<std::mutex> guard(engine->items.lru_locks[ii]);
             if (engine->items.heads[ii] == nullptr) {
                 skip = true;
             } else {
@@ -4,9 +4,11 @@
 #include "slabs.h"
 
 #include <gsl/gsl-lite.hpp>
+#include <array>
 #include <atomic>
 #include <cstddef>
 #include <cstring>
+#include <mutex>
 
 class CookieIface;
 
@@ -29,8 +31,11 @@ using hash_item = struct _hash_item {
     /** least recent access */
     rel_time_t time{0};
 
-    /** When the item will expire (relative to process startup) */
-    rel_time_t exptime{0};
+    /**
+     * When the item will expire (relative to process startup). Atomic as
+     * LRU walkers peek at it before trying to acquire the item lock.
+     */
+    std::atomic<rel_time_t> exptime{0};
 
     /**
      * When the current lock for the object expire. If locktime < "current
@@ -149,15 +154,33 @@ typedef struct {
     unsigned int reclaimed;
 } itemstats_t;
 
+/*
+ * Number of locks the items are partitioned over (by the hash of their key).
+ * Must be a power of 2.
+ */
+#define ITEM_LOCK_STRIPES 1024
+
 struct items {
    hash_item *heads[POWER_LARGEST];
    hash_item *tails[POWER_LARGEST];
    itemstats_t itemstats[POWER_LARGEST];
    unsigned int sizes[POWER_LARGEST];
    /*
-    * serialise access to the items data
+    * serialise access to the LRU of each slab class; lru_locks[id] protects
+    * heads[id], tails[id], itemstats[id] and sizes[id] (and the LRU links
+    * of the items in that class).
+   */
+   std::array<std::mutex, POWER_LARGEST> lru_locks;
+   /*
+    * serialise access to the items of a given key (linking / unlinking it,
+    * its refcount and lock / expiry metadata). Selected by the hash of the
+    * key, see item_lock().
+    *
+    * Lock order: item lock -> LRU lock -> slabs locks. The LRU walkers
+    * (eviction, scrubber, flush) which need an item lock while holding
+    * an LRU lock only ever try_lock it and skip the item if busy.
    */
-   std::mutex lock;
+   std::array<std::mutex, ITEM_LOCK_STRIPES> item_locks;
 };
 
 /**
@@ -180,6 +180,7 @@ static int do_slabs_newslab(struct default_engine *engine, const unsigned int id
     slabclass_t *p = &engine->slabs.slabclass[id];
     int len = p->size * p->perslab;
     char *ptr;
+    std::lock_guard<std::mutex> guard(engine->slabs.lock);
 
     if ((engine->slabs.mem_limit && engine->slabs.mem_malloced + len > engine->slabs.mem_limit && p->slabs > 0) ||
         (grow_slab_list(engine, id) == 0) ||
@@ -210,6 +211,7 @@ static void *do_slabs_alloc(struct default_engine *engine, const size_t size, un
     p = &engine->slabs.slabclass[id];
 
 #ifdef USE_SYSTEM_MALLOC
+    std::lock_guard<std::mutex> guard(engine->slabs.lock);
     if (engine->slabs.mem_limit && engine->slabs.mem_malloced + size > engine->slabs.mem_limit) {
         MEMCACHED_SLABS_ALLOCATE_FAILED(size, id);
         return 0;
@@ -256,6 +258,7 @@ static void do_slabs_free(struct default_engine *engine, void *ptr, const size_t
     p = &engine->slabs.slabclass[id];
 
 #ifdef USE_SYSTEM_MALLOC
+    std::lock_guard<std::mutex> guard(engine->slabs.lock);
     engine->slabs.mem_malloced -= size;
     cb_free(ptr);
     return;
@@ -333,6 +336,7 @@ static void do_slabs_stats(struct default_engine* engine,
 
     for(i = POWER_SMALLEST; i <= engine->slabs.power_largest; i++) {
         slabclass_t *p = &engine->slabs.slabclass[i];
+        std::lock_guard<std::mutex> guard(engine->slabs.class_locks[i]);
         if (p->slabs != 0) {
             uint32_t perslab, slabs;
             slabs = p->slabs;
@@ -361,9 +365,14 @@ static void do_slabs_stats(struct default_engine* engine,
 
     /* add overall slab stats and append terminator */
 
+    uint64_t mem_malloced;
+    {
+        std::lock_guard<std::mutex> guard(engine->slabs.lock);
+        mem_malloced = engine->slabs.mem_malloced;
+    }
     add_statistics(cookie, add_stats, nullptr, -1, "active_slabs", "%d", total);
     add_statistics(cookie, add_stats, nullptr, -1, "total_malloced", "%" PRIu64,
-                   (uint64_t)engine->slabs.mem_malloced);
+                   mem_malloced);
 }
 
 static void *memory_allocate(struct default_engine *engine, size_t size) {
@@ -395,33 +404,41 @@ static void *memory_allocate(struct default_engine *engine, size_t size) {
     return ret;
 }
 
+/*
+ * The class lock to use for the given id; out of range ids are rejected by
+ * the do_ functions (without touching the class) so any lock will do.
+ */
+static std::mutex& slabs_class_lock(struct default_engine* engine,
+                                    unsigned int id) {
+    return engine->slabs.class_locks[id < MAX_NUMBER_OF_SLAB_CLASSES ? id : 0];
+}
+
 void *slabs_alloc(struct default_engine *engine, size_t size, unsigned int id) {
-    std::lock_guard<std::mutex> guard(engine->slabs.lock);
+    std::lock_guard<std::mutex> guard(slabs_class_lock(engine, id));
     return do_slabs_alloc(engine, size, id);
 }
 
 void slabs_free(struct default_engine *engine, void *ptr, size_t size, unsigned int id) {
-    std::lock_guard<std::mutex> guard(engine->slabs.lock);
+    std::lock_guard<std::mutex> guard(slabs_class_lock(engine, id));
     do_slabs_free(engine, ptr, size, id);
 }
 
 void slabs_stats(struct default_engine* engine,
                  const AddStatFn& add_stats,
                  const CookieIface* c) {
-    std::lock_guard<std::mutex> guard(engine->slabs.lock);
     do_slabs_stats(engine, add_stats, c);
 }
 
 void slabs_adjust_mem_requested(struct default_engine *engine, unsigned int id, size_t old, size_t ntotal)
 {
     slabclass_t *p;
-    std::lock_guard<std::mutex> guard(engine->slabs.lock);
     if (id < POWER_SMALLEST || id > engine->slabs.power_largest) {
         throw std::invalid_argument(
                 "slabs_adjust_mem_requested: Internal error! Invalid slab "
                 "class");
     }
 
+    std::lock_guard<std::mutex> guard(engine->slabs.class_locks[id]);
     p = &engine->slabs.slabclass[id];
     p->requested = p->requested - old + ntotal;
 }
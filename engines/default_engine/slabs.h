@@ -4,6 +4,7 @@
 #include <memcached/engine_common.h>
 #include <memcached/engine_error.h>
 
+#include <array>
 #include <mutex>
 
 /* Slab sizing definitions. */
@@ -52,7 +53,16 @@ struct slabs {
    } allocs;
 
    /**
-    * Access to the slab allocator is protected by this lock
+    * Access to each slab class (its freelist and end page) is protected by
+    * the lock of the same index, so allocations of different sizes don't
+    * contend with each other.
+    */
+   std::array<std::mutex, MAX_NUMBER_OF_SLAB_CLASSES> class_locks;
+
+   /**
+    * Access to the memory pool shared by all slab classes (mem_malloced,
+    * mem_current, allocs etc) is protected by this lock. It may be acquired
+    * while holding a class lock, but not the other way around.
     */
    std::mutex lock;
 };
@@ -10,10 +10,13 @@
  */
 
 /*
- * Benchmarks relating to the CheckpointIterator class.
+ * Benchmarks relating to the CheckpointIterator class and the checkpoint
+ * key index.
  */
 
+#include "checkpoint.h"
 #include "checkpoint_iterator.h"
+#include "module_tests/test_helpers.h"
 #include <platform/atomic.h>
 
 #include <benchmark/benchmark.h>
@@ -53,3 +56,80 @@ static void BM_CheckpointIteratorCompare(benchmark::State& state) {
 
 // Register the function as a benchmark
 BENCHMARK(BM_CheckpointIteratorCompare);
+
+/**
+ * Populate the queue (after a dummy item, like a Checkpoint) and the index
+ * with one item per key.
+ */
+static std::vector<StoredDocKey> populateCheckpointIndex(
+        CheckpointQueue& queue, CheckpointIndex& index, size_t numKeys) {
+    std::vector<StoredDocKey> keys;
+    keys.reserve(numKeys);
+    for (size_t ii = 0; ii < numKeys; ++ii) {
+        keys.emplace_back(makeStoredDocKey("checkpoint_key_" +
+                                           std::to_string(ii)));
+        queue.push_back(makeCommittedItem(keys.back(), "value"));
+        index.insertOrAssign(keys.back(), IndexEntry(std::prev(queue.end())));
+    }
+    return keys;
+}
+
+/**
+ * Benchmark the key index on the queueDirty de-dup path: each mutation of a
+ * key already in the checkpoint looks up the key (comparing it against the
+ * queued item) and moves the index entry to the newly queued instance.
+ */
+static void BM_CheckpointIndexQueueDirtyDedup(benchmark::State& state) {
+    const auto numKeys = size_t(state.range(0));
+    CheckpointQueue queue{MemoryTrackingAllocator<queued_item>()};
+    queue.push_back(queued_item{});
+    CheckpointIndex index(queue, CheckpointIndex::allocator_type());
+    const auto keys = populateCheckpointIndex(queue, index, numKeys);
+
+    size_t next = 0;
+    while (state.KeepRunning()) {
+        auto* entry = index.find(keys[next]);
+        // Move the existing item to the back of the queue, which is where a
+        // de-dup puts the new instance of the key
+        queue.splice(queue.end(), queue, entry->getPosition());
+        *entry = IndexEntry(std::prev(queue.end()));
+        next = (next + 1) % numKeys;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["IndexBytes"] =
+            double(index.get_allocator().getBytesAllocated());
+}
+
+/**
+ * Benchmark the key index on the queueDirty new key path (a lookup which
+ * misses followed by an insert), including the growth of the index.
+ */
+static void BM_CheckpointIndexQueueDirtyNewKey(benchmark::State& state) {
+    const auto numKeys = size_t(state.range(0));
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        CheckpointQueue queue{MemoryTrackingAllocator<queued_item>()};
+        queue.push_back(queued_item{});
+        CheckpointIndex index(queue, CheckpointIndex::allocator_type());
+        std::vector<StoredDocKey> keys;
+        for (size_t ii = 0; ii < numKeys; ++ii) {
+            keys.emplace_back(makeStoredDocKey("checkpoint_key_" +
+                                               std::to_string(ii)));
+            queue.push_back(makeCommittedItem(keys.back(), "value"));
+        }
+        state.ResumeTiming();
+
+        auto pos = std::next(queue.begin());
+        for (const auto& key : keys) {
+            if (!index.find(key)) {
+                index.insertOrAssign(key, IndexEntry(pos));
+            }
+            ++pos;
+        }
+        benchmark::DoNotOptimize(index.size());
+    }
+    state.SetItemsProcessed(state.iterations() * numKeys);
+}
+
+BENCHMARK(BM_CheckpointIndexQueueDirtyDedup)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_CheckpointIndexQueueDirtyNewKey)->Range(1 << 10, 1 << 16);
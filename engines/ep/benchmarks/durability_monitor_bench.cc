@@ -0,0 +1,96 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+/*
+ * Benchmarks relating to the DurabilityMonitor classes.
+ */
+
+#include "durability/active_durability_monitor.h"
+#include "engine_fixture.h"
+#include "item.h"
+#include "kv_bucket.h"
+#include "vbucket.h"
+
+#include "../tests/module_tests/test_helpers.h"
+
+#include <executor/fake_executorpool.h>
+#include <folly/portability/GTest.h>
+#include <nlohmann/json.hpp>
+
+class DurabilityMonitorBench : public EngineFixture {
+protected:
+    void SetUp(const benchmark::State& state) override {
+        EngineFixture::SetUp(state);
+        engine->getKVBucket()->setVBucketState(vbid, vbucket_state_active);
+    }
+
+    void TearDown(const benchmark::State& state) override {
+        ASSERT_EQ(cb::engine_errc::success,
+                  engine->getKVBucket()->deleteVBucket(vbid, nullptr));
+        executorPool->runNextTask(AUXIO_TASK_IDX,
+                                  "Removing (dead) vb:0 from memory and disk");
+        EngineFixture::TearDown(state);
+    }
+};
+
+/*
+ * Throughput of tracking SyncWrites and processing the seqno-acks for them:
+ * adds state.range(0) SyncWrites to an ActiveDM with a 2-replica topology,
+ * then each replica acks every SyncWrite individually.
+ *
+ * PersistToMajority is used (and nothing is persisted) so the active never
+ * acks and none of the SyncWrites complete; this keeps the benchmark to
+ * the DurabilityMonitor itself (tracked container and replica Positions)
+ * rather than the VBucket commit path.
+ */
+BENCHMARK_DEFINE_F(DurabilityMonitorBench, TrackAndAck)
+(benchmark::State& state) {
+    const auto numSyncWrites = state.range(0);
+    auto& vb = *engine->getKVBucket()->getVBucket(vbid);
+    const cb::durability::Requirements reqs{
+            cb::durability::Level::PersistToMajority,
+            cb::durability::Timeout::Infinity()};
+
+    std::vector<queued_item> items;
+    for (int64_t seqno = 1; seqno <= numSyncWrites; ++seqno) {
+        auto item = makePendingItem(
+                makeStoredDocKey("key" + std::to_string(seqno)), "value", reqs);
+        item->setBySeqno(seqno);
+        items.push_back(item);
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto adm = std::make_unique<ActiveDurabilityMonitor>(
+                engine->getEpStats(),
+                vb,
+                std::make_unique<NoopEventDrivenDurabilityTimeout>());
+        adm->setReplicationTopology(nlohmann::json::array(
+                {{"active", "replica1", "replica2"}}));
+        state.ResumeTiming();
+
+        for (const auto& item : items) {
+            adm->addSyncWrite(nullptr, item);
+        }
+        for (int64_t seqno = 1; seqno <= numSyncWrites; ++seqno) {
+            adm->seqnoAckReceived("replica1", seqno);
+            adm->seqnoAckReceived("replica2", seqno);
+        }
+
+        state.PauseTiming();
+        adm.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * numSyncWrites);
+}
+
+BENCHMARK_REGISTER_F(DurabilityMonitorBench, TrackAndAck)
+        ->Range(16, 16384);
@@ -19,12 +19,14 @@
 #include <benchmark/benchmark.h>
 #include <executor/executorpool.h>
 #include <executor/folly_executorpool.h>
+#include <executor/futurequeue.h>
 #include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/executors/IOThreadPoolExecutor.h>
 #include <folly/futures/Future.h>
 #include <mock/mock_global_task.h>
 #include <relaxed_atomic.h>
 #include <random>
+#include <thread>
 
 /**
  * Implementation of Taskable which does absolutely nothing. Used in the below
@@ -307,6 +309,118 @@ public:
         shutdownPool(state);
     }
 
+    /**
+     * Benchmark a storm of wakes and snoozes against a large number of
+     * sleeping tasks, without waiting for the woken tasks to run. This models
+     * front-end threads notifying (for example) DCP stream tasks, which run
+     * briefly and go back to sleep.
+     *
+     * Each iteration wakes one of the thread's tasks and snoozes another
+     * forever, so the cost measured is dominated by moving tasks within the
+     * pool's future queue rather than by running them.
+     *
+     * Argument specifies how many Tasks exist (spread across all threads).
+     */
+    void bench_WakeSnoozeStorm(benchmark::State& state) {
+        setupPool(state, 1);
+
+        const auto tasksPerThread = state.range(0) / state.threads();
+        ASSERT_LE(2, tasksPerThread) << "Must have at least 2 tasks per thread";
+
+        // Each task goes back to sleep (forever) when it runs.
+        auto taskFn = [](LambdaTask& task) {
+            task.snooze(INT_MAX);
+            return true;
+        };
+        std::vector<ExTask> tasks;
+        for (int i = 0; i < tasksPerThread; i++) {
+            tasks.push_back(std::make_shared<LambdaTask>(
+                    taskable, TaskId::ItemPager, INT_MAX, false, taskFn));
+            getPool()->schedule(tasks.back());
+        }
+
+        std::random_device randomDevice;
+        std::mt19937_64 generator(randomDevice());
+        std::uniform_int_distribution<size_t> taskDistribution(
+                0, tasks.size() - 1);
+
+        int64_t operations = 0;
+        while (state.KeepRunning()) {
+            getPool()->wake(tasks[taskDistribution(generator)]->getId());
+            getPool()->snooze(tasks[taskDistribution(generator)]->getId(),
+                              INT_MAX);
+            operations += 2;
+        }
+
+        // Cancel all tasks so they don't run during pool shutdown.
+        for (auto& t : tasks) {
+            t->cancel();
+        }
+
+        state.SetItemsProcessed(operations);
+
+        shutdownPool(state);
+    }
+
+    /**
+     * Benchmark a backlogged task group. Measure how long it takes to run a
+     * burst of AuxIO tasks (each sleeping for a short time, as if waiting on
+     * disk) against a single AuxIO thread, while the Writer threads are
+     * idle. The average time from scheduling a task until it starts running
+     * is reported as the SchedLatency_us counter.
+     *
+     * Argument specifies the work stealing quota (see
+     * ExecutorPool::setWorkStealingQuota) - with a non-zero quota the idle
+     * Writer threads help to run the AuxIO backlog.
+     */
+    void bench_BackloggedGroup(benchmark::State& state) {
+        using namespace std::chrono;
+        const int tasksPerBurst = 64;
+        const auto taskDuration = microseconds(50);
+
+        pool = std::make_unique<T>(8,
+                                   ThreadPoolConfig::ThreadCount(1),
+                                   ThreadPoolConfig::ThreadCount(4),
+                                   1,
+                                   1);
+        pool->registerTaskable(taskable);
+        pool->setWorkStealingQuota(state.range(0));
+
+        folly::Baton burstDone;
+        std::atomic<int> remaining{0};
+        std::atomic<int64_t> totalLatency{0};
+        auto taskFn = [&](LambdaTask& task) {
+            totalLatency += duration_cast<nanoseconds>(steady_clock::now() -
+                                                       task.getWaketime())
+                                    .count();
+            std::this_thread::sleep_for(taskDuration);
+            if (--remaining == 0) {
+                burstDone.post();
+            }
+            return false;
+        };
+
+        while (state.KeepRunning()) {
+            remaining = tasksPerBurst;
+            for (int i = 0; i < tasksPerBurst; i++) {
+                pool->schedule(std::make_shared<LambdaTask>(
+                        taskable, TaskId::AccessScanner, 0, true, taskFn));
+            }
+            burstDone.wait();
+            burstDone.reset();
+        }
+
+        const auto tasksRun = state.iterations() * tasksPerBurst;
+        state.SetItemsProcessed(tasksRun);
+        if (tasksRun) {
+            state.counters["SchedLatency_us"] =
+                    double(totalLatency) / tasksRun / 1000;
+        }
+
+        pool->unregisterTaskable(taskable, false);
+        pool.reset();
+    }
+
 private:
     std::unique_ptr<T> pool;
     /// Semaphore used to coordinate pool creation/usage.
@@ -361,6 +475,72 @@ BENCHMARK_TEMPLATE_DEFINE_F(ExecutorPoolFixture,
     bench_TimeoutAddCancel(state);
 }
 
+BENCHMARK_TEMPLATE_DEFINE_F(ExecutorPoolFixture,
+                            BackloggedGroup_CB3,
+                            CB3ExecutorPool)
+(benchmark::State& state) {
+    bench_BackloggedGroup(state);
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(ExecutorPoolFixture,
+                            BackloggedGroup_Folly,
+                            FollyExecutorPool)
+(benchmark::State& state) {
+    bench_BackloggedGroup(state);
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(ExecutorPoolFixture,
+                            WakeSnoozeStorm_CB3,
+                            CB3ExecutorPool)
+(benchmark::State& state) {
+    bench_WakeSnoozeStorm(state);
+}
+
+BENCHMARK_TEMPLATE_DEFINE_F(ExecutorPoolFixture,
+                            WakeSnoozeStorm_Folly,
+                            FollyExecutorPool)
+(benchmark::State& state) {
+    bench_WakeSnoozeStorm(state);
+}
+
+/**
+ * Benchmark the FutureQueue (as used by CB3ExecutorPool) directly: a storm of
+ * wakes (wakeTime set to now) and snoozes (wakeTime set to a random time in
+ * the next 30 seconds) of random tasks, with the soonest task being checked
+ * after each, as a CB3 thread would.
+ *
+ * Argument specifies how many Tasks are in the queue.
+ */
+static void FutureQueueWakeSnoozeStorm(benchmark::State& state) {
+    NullTaskable taskable;
+    FutureQueue queue;
+    std::vector<ExTask> tasks;
+    for (int i = 0; i < state.range(0); i++) {
+        tasks.push_back(std::make_shared<LambdaTask>(
+                taskable,
+                TaskId::ItemPager,
+                INT_MAX,
+                false,
+                [](LambdaTask&) { return false; }));
+        queue.push(tasks.back());
+    }
+
+    std::mt19937_64 generator(state.range(0));
+    std::uniform_int_distribution<size_t> taskDistribution(0, tasks.size() - 1);
+    std::uniform_real_distribution<> snoozeDistribution(0.0, 30.0);
+
+    int64_t operations = 0;
+    while (state.KeepRunning()) {
+        queue.updateWaketime(tasks[taskDistribution(generator)],
+                             std::chrono::steady_clock::now());
+        queue.snooze(tasks[taskDistribution(generator)],
+                     snoozeDistribution(generator));
+        benchmark::DoNotOptimize(queue.top());
+        operations += 2;
+    }
+    state.SetItemsProcessed(operations);
+}
+
 /**
  * Benchmark fixture using Folly's CPUThreadPoolPoolExecutor &
  * IOThreadPoolExecutor directly (without any higher-level GlobalTask
@@ -596,3 +776,28 @@ BENCHMARK_REGISTER_F(PureFollyExecutorBench, TimeoutAddCancel)
         ->Range(1000, 30000)
         ->ArgName("Timeouts")
         ->UseRealTime();
+
+// CB3ExecutorPool doesn't support work stealing, so only measure it without.
+BENCHMARK_REGISTER_F(ExecutorPoolFixture, BackloggedGroup_CB3)
+        ->Arg(0)
+        ->ArgName("StealQuota")
+        ->UseRealTime();
+BENCHMARK_REGISTER_F(ExecutorPoolFixture, BackloggedGroup_Folly)
+        ->Arg(0)
+        ->Arg(50)
+        ->Arg(100)
+        ->ArgName("StealQuota")
+        ->UseRealTime();
+
+BENCHMARK_REGISTER_F(ExecutorPoolFixture, WakeSnoozeStorm_CB3)
+        ->ThreadRange(1, 16)
+        ->Range(1000, 30000)
+        ->ArgName("Tasks")
+        ->UseRealTime();
+BENCHMARK_REGISTER_F(ExecutorPoolFixture, WakeSnoozeStorm_Folly)
+        ->ThreadRange(1, 16)
+        ->Range(1000, 30000)
+        ->ArgName("Tasks")
+        ->UseRealTime();
+
+BENCHMARK(FutureQueueWakeSnoozeStorm)->Range(1000, 30000)->ArgName("Tasks");
@@ -24,11 +24,18 @@
 // Benchmarks inserting items into a HashTable
 class HashTableBench : public benchmark::Fixture {
 public:
-    HashTableBench()
+    explicit HashTableBench(
+            HashTable::Layout layout = HashTable::Layout::Chained,
+            HashTable::ResizeAlgorithm resizeAlgorithm =
+                    HashTable::ResizeAlgorithm::Blocking,
+            std::unique_ptr<AbstractStoredValueFactory> svFactory = {})
         : ht(stats,
-             std::make_unique<StoredValueFactory>(stats),
+             svFactory ? std::move(svFactory)
+                       : std::make_unique<StoredValueFactory>(stats),
              Configuration().getHtSize(),
-             Configuration().getHtLocks()) {
+             Configuration().getHtLocks(),
+             layout,
+             resizeAlgorithm) {
     }
 
     void SetUp(benchmark::State& state) override {
@@ -117,6 +124,192 @@ public:
         }
     }
 
+    /// Benchmark body for finding items in the HashTable (see FindForRead).
+    void runFindForRead(benchmark::State& state) {
+        // Populate the HashTable with numItems.
+        if (state.thread_index() == 0) {
+            sharedItems = createUniqueItems(
+                    "Thread" + std::to_string(state.thread_index()) + "::", 50);
+            for (auto& item : sharedItems) {
+                ASSERT_EQ(MutationStatus::WasClean, ht.set(item));
+            }
+        }
+
+        // Benchmark - find them.
+        while (state.KeepRunning()) {
+            auto& key = sharedItems[state.iterations() % numItems].getKey();
+            benchmark::DoNotOptimize(ht.findForRead(key));
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    /// Benchmark body for finding items for write in the HashTable (see
+    /// FindForWrite).
+    void runFindForWrite(benchmark::State& state) {
+        // Populate the HashTable with numItems.
+        if (state.thread_index() == 0) {
+            sharedItems = createUniqueItems(
+                    "Thread" + std::to_string(state.thread_index()) + "::", 50);
+            for (auto& item : sharedItems) {
+                ASSERT_EQ(MutationStatus::WasClean, ht.set(item));
+            }
+        }
+
+        // Benchmark - find them.
+        while (state.KeepRunning()) {
+            auto& key = sharedItems[state.iterations() % numItems].getKey();
+            benchmark::DoNotOptimize(ht.findForWrite(key));
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    /// Benchmark body for inserting items into the HashTable (see Insert).
+    void runInsert(benchmark::State& state) {
+        // To ensure we insert and not replace items, create a per-thread items
+        // vector so each thread inserts a different set of items.
+        auto items = createUniqueItems(
+                "Thread" + std::to_string(state.thread_index()) + "::");
+
+        while (state.KeepRunning()) {
+            const auto index = state.iterations() % numItems;
+            ASSERT_EQ(MutationStatus::WasClean, ht.set(items[index]));
+
+            // Once a thread gets to the end of it's items; pause timing and
+            // let the *last* thread clear them all - this is to avoid
+            // measuring any of the ht.clear() cost indirectly when other
+            // threads are trying to insert.
+            // Note: state.iterations() starts at 0; hence checking for
+            // state.iterations() % numItems (aka 'index') is zero to represent
+            // we wrapped.
+            if (index == 0) {
+                state.PauseTiming();
+                waitForAllThreadsThenExecuteOnce(state,
+                                                 [this]() { ht.clear(); });
+                state.ResumeTiming();
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    /// Benchmark body for deleting items from the HashTable (see Delete).
+    void runDelete(benchmark::State& state) {
+        auto items = createUniqueItems(
+                "Thread" + std::to_string(state.thread_index()) + "::");
+
+        while (state.KeepRunning()) {
+            const auto index = state.iterations() % numItems;
+
+            // Populate the HashTable every numItems iterations.
+            //
+            // Once a thread deletes all of it's items; pause timing and let
+            // the *last* thread re-populate the HashTable (so we can continue
+            // to delete)
+            // - this is to avoid measuring any of the re-populate cost while
+            // other threads are trying to delete.
+            if (index == 1) {
+                state.PauseTiming();
+                waitForAllThreadsThenExecuteOnce(state, [this, &items]() {
+                    // re-populate HashTable.
+                    for (auto& item : items) {
+                        ASSERT_EQ(MutationStatus::WasClean, ht.set(item));
+                    }
+                });
+                state.ResumeTiming();
+            }
+
+            auto& key = items[index].getKey();
+            {
+                auto result = ht.findForWrite(key);
+                ASSERT_TRUE(result.storedValue);
+                ht.unlocked_del(result.lock, result.storedValue);
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    /// Benchmark body for replacing existing items (see Replace).
+    void runReplace(benchmark::State& state) {
+        // Populate the HashTable with numItems.
+        auto items = createUniqueItems(
+                "Thread" + std::to_string(state.thread_index()) + "::");
+        for (auto& item : items) {
+            ASSERT_EQ(MutationStatus::WasClean, ht.set(item));
+        }
+
+        // Benchmark - update them.
+        while (state.KeepRunning()) {
+            ASSERT_EQ(MutationStatus::WasDirty,
+                      ht.set(items[state.iterations() % numItems]));
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    /// Benchmark body for finding items and reading their value (see
+    /// ReadValue).
+    void runReadValue(benchmark::State& state) {
+        // Populate the HashTable with numItems.
+        if (state.thread_index() == 0) {
+            sharedItems = createUniqueItems("ReadValue::");
+            for (auto& item : sharedItems) {
+                ASSERT_EQ(MutationStatus::WasClean, ht.set(item));
+            }
+        }
+
+        // Benchmark - find them and touch the value.
+        while (state.KeepRunning()) {
+            auto& key = sharedItems[state.iterations() % numItems].getKey();
+            auto result = ht.findForRead(key);
+            benchmark::DoNotOptimize(
+                    result.storedValue->getValue()->getData()[0]);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    /**
+     * Benchmark body for concurrent get / set while the HashTable is being
+     * resized (see GetSetDuringResize).
+     */
+    void runGetSetDuringResize(benchmark::State& state) {
+        // Populate the HashTable with numItems.
+        if (state.thread_index() == 0) {
+            sharedItems = createUniqueItems("GetSetDuringResize::");
+            for (auto& item : sharedItems) {
+                ASSERT_EQ(MutationStatus::WasClean, ht.set(item));
+            }
+        }
+
+        // Alternate between two sizes which are multiples of the number of
+        // locks (so the incremental algorithm can be used).
+        const auto locks = ht.getNumLocks();
+        const std::array<size_t, 2> sizes{{locks * 256, locks * 4096}};
+        const size_t resizeInterval = numItems / 10;
+
+        while (state.KeepRunning()) {
+            const auto index = state.iterations() % numItems;
+            if (state.thread_index() == 0 && index % resizeInterval == 0) {
+                ht.resize(sizes[(index / resizeInterval) % 2]);
+                // Emulate the HashtableResizerTask completing the resize.
+                while (ht.migrateBuckets(1024)) {
+                }
+            }
+
+            const auto& item = sharedItems[index];
+            if (index % 2) {
+                benchmark::DoNotOptimize(ht.findForRead(item.getKey()));
+            } else {
+                ASSERT_EQ(MutationStatus::WasDirty, ht.set(item));
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
     auto& getValFact() {
         return ht.valFact;
     }
@@ -143,22 +336,7 @@ public:
 // high percentage in a real-world, but want to measure any performance impact
 // in having such items present in the HashTable.
 BENCHMARK_DEFINE_F(HashTableBench, FindForRead)(benchmark::State& state) {
-    // Populate the HashTable with numItems.
-    if (state.thread_index() == 0) {
-        sharedItems = createUniqueItems(
-                "Thread" + std::to_string(state.thread_index()) + "::", 50);
-        for (auto& item : sharedItems) {
-            ASSERT_EQ(MutationStatus::WasClean, ht.set(item));
-        }
-    }
-
-    // Benchmark - find them.
-    while (state.KeepRunning()) {
-        auto& key = sharedItems[state.iterations() % numItems].getKey();
-        benchmark::DoNotOptimize(ht.findForRead(key));
-    }
-
-    state.SetItemsProcessed(state.iterations());
+    runFindForRead(state);
 }
 
 // Benchmark finding items (for write) in the HashTable.
@@ -166,104 +344,26 @@ BENCHMARK_DEFINE_F(HashTableBench, FindForRead)(benchmark::State& state) {
 // high percentage in a real-world, but want to measure any performance impact
 // in having such items present in the HashTable.
 BENCHMARK_DEFINE_F(HashTableBench, FindForWrite)(benchmark::State& state) {
-    // Populate the HashTable with numItems.
-    if (state.thread_index() == 0) {
-        sharedItems = createUniqueItems(
-                "Thread" + std::to_string(state.thread_index()) + "::", 50);
-        for (auto& item : sharedItems) {
-            ASSERT_EQ(MutationStatus::WasClean, ht.set(item));
-        }
-    }
-
-    // Benchmark - find them.
-    while (state.KeepRunning()) {
-        auto& key = sharedItems[state.iterations() % numItems].getKey();
-        benchmark::DoNotOptimize(ht.findForWrite(key));
-    }
-
-    state.SetItemsProcessed(state.iterations());
+    runFindForWrite(state);
 }
 
 // Benchmark inserting an item into the HashTable.
 BENCHMARK_DEFINE_F(HashTableBench, Insert)(benchmark::State& state) {
-    // To ensure we insert and not replace items, create a per-thread items
-    // vector so each thread inserts a different set of items.
-    auto items = createUniqueItems("Thread" +
-                                   std::to_string(state.thread_index()) + "::");
-
-    while (state.KeepRunning()) {
-        const auto index = state.iterations() % numItems;
-        ASSERT_EQ(MutationStatus::WasClean, ht.set(items[index]));
-
-        // Once a thread gets to the end of it's items; pause timing and let
-        // the *last* thread clear them all - this is to avoid measuring any
-        // of the ht.clear() cost indirectly when other threads are trying to
-        // insert.
-        // Note: state.iterations() starts at 0; hence checking for
-        // state.iterations() % numItems (aka 'index') is zero to represent we
-        // wrapped.
-        if (index == 0) {
-            state.PauseTiming();
-            waitForAllThreadsThenExecuteOnce(state, [this]() { ht.clear(); });
-            state.ResumeTiming();
-        }
-    }
-
-    state.SetItemsProcessed(state.iterations());
+    runInsert(state);
 }
 
 // Benchmark replacing an existing item in the HashTable.
 BENCHMARK_DEFINE_F(HashTableBench, Replace)(benchmark::State& state) {
-    // Populate the HashTable with numItems.
-    auto items = createUniqueItems("Thread" +
-                                   std::to_string(state.thread_index()) + "::");
-    for (auto& item : items) {
-        ASSERT_EQ(MutationStatus::WasClean, ht.set(item));
-    }
-
-    // Benchmark - update them.
-    while (state.KeepRunning()) {
-        ASSERT_EQ(MutationStatus::WasDirty,
-                  ht.set(items[state.iterations() % numItems]));
-    }
+    runReplace(state);
+}
 
-    state.SetItemsProcessed(state.iterations());
+// Benchmark finding items in the HashTable and reading their value.
+BENCHMARK_DEFINE_F(HashTableBench, ReadValue)(benchmark::State& state) {
+    runReadValue(state);
 }
 
 BENCHMARK_DEFINE_F(HashTableBench, Delete)(benchmark::State& state) {
-    auto items = createUniqueItems("Thread" +
-                                   std::to_string(state.thread_index()) + "::");
-
-    while (state.KeepRunning()) {
-        const auto index = state.iterations() % numItems;
-
-        // Populate the HashTable every numItems iterations.
-        //
-        // Once a thread deletes all of it's items; pause timing and let
-        // the *last* thread re-populate the HashTable (so we can continue to
-        // delete)
-        // - this is to avoid measuring any of the re-populate cost while
-        // other threads are trying to delete.
-        if (index == 1) {
-            state.PauseTiming();
-            waitForAllThreadsThenExecuteOnce(state, [this, &items]() {
-                // re-populate HashTable.
-                for (auto& item : items) {
-                    ASSERT_EQ(MutationStatus::WasClean, ht.set(item));
-                }
-            });
-            state.ResumeTiming();
-        }
-
-        auto& key = items[index].getKey();
-        {
-            auto result = ht.findForWrite(key);
-            ASSERT_TRUE(result.storedValue);
-            ht.unlocked_del(result.lock, result.storedValue);
-        }
-    }
-
-    state.SetItemsProcessed(state.iterations());
+    runDelete(state);
 }
 
 // Benchmark inserting an item into the HashTable.
@@ -366,6 +466,88 @@ BENCHMARK_DEFINE_F(HashTableBench, HTStatsEpilogue)(benchmark::State& state) {
     state.SetItemsProcessed(state.iterations());
 }
 
+// Variant of the benchmarks above with the HashTable using the TagGroups
+// layout; resized to the same number of items per bucket that
+// HashTable::resize() would pick.
+class HashTableTagGroupsBench : public HashTableBench {
+public:
+    HashTableTagGroupsBench() : HashTableBench(HashTable::Layout::TagGroups) {
+    }
+
+    void SetUp(benchmark::State& state) override {
+        if (state.thread_index() == 0) {
+            ht.resize(numItems / HashTable::tagGroupLoadFactor);
+        }
+    }
+};
+
+BENCHMARK_DEFINE_F(HashTableTagGroupsBench, FindForRead)
+(benchmark::State& state) {
+    runFindForRead(state);
+}
+
+BENCHMARK_DEFINE_F(HashTableTagGroupsBench, FindForWrite)
+(benchmark::State& state) {
+    runFindForWrite(state);
+}
+
+BENCHMARK_DEFINE_F(HashTableTagGroupsBench, Insert)(benchmark::State& state) {
+    runInsert(state);
+}
+
+BENCHMARK_DEFINE_F(HashTableTagGroupsBench, Delete)(benchmark::State& state) {
+    runDelete(state);
+}
+
+// Benchmark get / set throughput while a (blocking) resize is repeatedly
+// performed by one of the threads.
+BENCHMARK_DEFINE_F(HashTableBench, GetSetDuringResize)
+(benchmark::State& state) {
+    runGetSetDuringResize(state);
+}
+
+// Variant of GetSetDuringResize with the HashTable using the incremental
+// resize algorithm.
+class HashTableIncrementalResizeBench : public HashTableBench {
+public:
+    HashTableIncrementalResizeBench()
+        : HashTableBench(HashTable::Layout::Chained,
+                         HashTable::ResizeAlgorithm::Incremental) {
+    }
+};
+
+BENCHMARK_DEFINE_F(HashTableIncrementalResizeBench, GetSetDuringResize)
+(benchmark::State& state) {
+    runGetSetDuringResize(state);
+}
+
+// Variant of the benchmarks above with the HashTable storing (small) values
+// inline in the StoredValue.
+class HashTableInlineValueBench : public HashTableBench {
+public:
+    HashTableInlineValueBench()
+        : HashTableBench(HashTable::Layout::Chained,
+                         HashTable::ResizeAlgorithm::Blocking,
+                         std::make_unique<InlineValueStoredValueFactory>(
+                                 stats, /*maxInlineValueSize*/ 64)) {
+    }
+};
+
+BENCHMARK_DEFINE_F(HashTableInlineValueBench, Insert)
+(benchmark::State& state) {
+    runInsert(state);
+}
+
+BENCHMARK_DEFINE_F(HashTableInlineValueBench, Replace)
+(benchmark::State& state) {
+    runReplace(state);
+}
+
+BENCHMARK_DEFINE_F(HashTableInlineValueBench, ReadValue)
+(benchmark::State& state) {
+    runReadValue(state);
+}
+
 BENCHMARK_DEFINE_F(HashTableBench, Clear)(benchmark::State& state) {
     // Benchmark - measure how long it takes to clear the HashTable.
     // Need to create Items each iteration so they have a ref-count of
@@ -444,6 +626,39 @@ BENCHMARK_REGISTER_F(HashTableBench, Replace)
 BENCHMARK_REGISTER_F(HashTableBench, Delete)
         ->ThreadPerCpu()
         ->Iterations(HashTableBench::numItems);
+BENCHMARK_REGISTER_F(HashTableBench, ReadValue)
+        ->ThreadPerCpu()
+        ->Iterations(HashTableBench::numItems);
+
+BENCHMARK_REGISTER_F(HashTableInlineValueBench, Insert)
+        ->ThreadPerCpu()
+        ->Iterations(HashTableBench::numItems);
+BENCHMARK_REGISTER_F(HashTableInlineValueBench, Replace)
+        ->ThreadPerCpu()
+        ->Iterations(HashTableBench::numItems);
+BENCHMARK_REGISTER_F(HashTableInlineValueBench, ReadValue)
+        ->ThreadPerCpu()
+        ->Iterations(HashTableBench::numItems);
+
+BENCHMARK_REGISTER_F(HashTableTagGroupsBench, FindForRead)
+        ->ThreadPerCpu()
+        ->Iterations(HashTableBench::numItems);
+BENCHMARK_REGISTER_F(HashTableTagGroupsBench, FindForWrite)
+        ->ThreadPerCpu()
+        ->Iterations(HashTableBench::numItems);
+BENCHMARK_REGISTER_F(HashTableTagGroupsBench, Insert)
+        ->ThreadPerCpu()
+        ->Iterations(HashTableBench::numItems);
+BENCHMARK_REGISTER_F(HashTableTagGroupsBench, Delete)
+        ->ThreadPerCpu()
+        ->Iterations(HashTableBench::numItems);
+
+BENCHMARK_REGISTER_F(HashTableBench, GetSetDuringResize)
+        ->ThreadPerCpu()
+        ->Iterations(HashTableBench::numItems);
+BENCHMARK_REGISTER_F(HashTableIncrementalResizeBench, GetSetDuringResize)
+        ->ThreadPerCpu()
+        ->Iterations(HashTableBench::numItems);
 
 BENCHMARK_REGISTER_F(HashTableBench, MultiCollectionInsert)
         ->ThreadPerCpu()
@@ -14,6 +14,8 @@
  */
 
 #include "item.h"
+#include "stats.h"
+#include "stored_value_factories.h"
 
 #include <benchmark/benchmark.h>
 
@@ -43,3 +45,45 @@ static void BM_CompareQueuedItemsBySeqnoAndKey(benchmark::State& state) {
 }
 // Register the function as a benchmark
 BENCHMARK(BM_CompareQueuedItemsBySeqnoAndKey);
+
+/**
+ * Benchmark creating a StoredValue from an Item, reading its value and then
+ * deleting it, for values of state.range(0) bytes. Compares a StoredValue with
+ * an out-of-line Blob (StoredValueFactory) against one with the value inline
+ * (InlineValueStoredValueFactory).
+ */
+template <typename Factory>
+static void BM_StoredValueCreateReadDelete(benchmark::State& state,
+                                           Factory factory) {
+    const auto valueSize = state.range(0);
+    std::vector<Item> items;
+    for (size_t i = 0; i < 1000; i++) {
+        auto key = std::string("key_") + std::to_string(i);
+        items.emplace_back(DocKey(key, DocKeyEncodesCollectionId::No),
+                           0,
+                           0,
+                           std::string(valueSize, 'x').data(),
+                           valueSize);
+    }
+
+    while (state.KeepRunning()) {
+        const auto& item = items[state.iterations() % items.size()];
+        auto sv = factory(item, {});
+        benchmark::DoNotOptimize(sv->getValue()->getData()[0]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_StoredValueOutOfLineValue(benchmark::State& state) {
+    EPStats stats;
+    BM_StoredValueCreateReadDelete(state, StoredValueFactory(stats));
+}
+
+static void BM_StoredValueInlineValue(benchmark::State& state) {
+    EPStats stats;
+    BM_StoredValueCreateReadDelete(
+            state, InlineValueStoredValueFactory(stats, state.range(0)));
+}
+
+BENCHMARK(BM_StoredValueOutOfLineValue)->RangeMultiplier(4)->Range(4, 256);
+BENCHMARK(BM_StoredValueInlineValue)->RangeMultiplier(4)->Range(4, 256);
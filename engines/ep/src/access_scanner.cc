@@ -16,6 +16,7 @@
 #include "hash_table.h"
 #include "kv_bucket.h"
 #include "mutation_log.h"
+#include "sorted_access_log.h"
 #include "stats.h"
 #include "vb_count_visitor.h"
 
@@ -52,12 +53,21 @@ public:
         prev = name + ".old";
         next = name + ".next";
 
-        log = std::make_unique<MutationLog>(next, conf.getAlogBlockSize());
-        log->open();
-        if (!log->isOpen()) {
-            EP_LOG_WARN("Failed to open access log: '{}'", next);
-            log.reset();
+        if (conf.getAlogFormat() == "sorted") {
+            try {
+                sortedLog = std::make_unique<SortedAccessLogWriter>(next);
+            } catch (const MutationLog::WriteException& e) {
+                EP_LOG_WARN("Failed to open access log: {}", e.what());
+            }
         } else {
+            log = std::make_unique<MutationLog>(next, conf.getAlogBlockSize());
+            log->open();
+            if (!log->isOpen()) {
+                EP_LOG_WARN("Failed to open access log: '{}'", next);
+                log.reset();
+            }
+        }
+        if (isLogOpen()) {
             EP_LOG_INFO(
                     "Attempting to generate new access file "
                     "'{}'",
@@ -67,7 +77,7 @@ public:
 
     bool visit(const HashTable::HashBucketLock& lh, StoredValue& v) override {
         // Record resident, Committed HashTable items as 'accessed'.
-        if (log && v.isResident() && v.isCommitted()) {
+        if (isLogOpen() && v.isResident() && v.isCommitted()) {
             if (v.isExpired(startTime) || v.isDeleted()) {
                 EP_LOG_DEBUG("Skipping expired/deleted item: {}",
                              v.getBySeqno());
@@ -84,6 +94,10 @@ public:
             for (auto& it : accessed) {
                 log->newItem(vbid, it);
             }
+        } else if (sortedLog != nullptr) {
+            for (auto& it : accessed) {
+                sortedLog->newItem(it);
+            }
         }
         accessed.clear();
     }
@@ -91,7 +105,7 @@ public:
     void visitBucket(VBucket& vb) override {
         update(vb.getId());
 
-        if (log == nullptr) {
+        if (!isLogOpen()) {
             return;
         }
         HashTable::Position ht_start;
@@ -99,22 +113,50 @@ public:
             while (ht_start != vb.ht.endPosition()) {
                 ht_start = vb.ht.pauseResumeVisit(*this, ht_start);
                 update(vb.getId());
-                log->commit1();
-                log->commit2();
+                if (log) {
+                    log->commit1();
+                    log->commit2();
+                }
                 items_scanned = 0;
             }
+            if (sortedLog) {
+                // The sorted log holds the vBucket's keys until they're all
+                // known, to write them in order
+                try {
+                    sortedLog->finishVBucket(vb.getId());
+                } catch (const MutationLog::WriteException& e) {
+                    EP_LOG_WARN("Failed to write access log: {}", e.what());
+                    sortedLog.reset();
+                    remove(next.c_str());
+                }
+            }
         }
     }
 
     void complete() override {
 
-        if (log == nullptr) {
+        if (!isLogOpen()) {
             updateStateFinalizer(false);
         } else {
-            size_t num_items = log->itemsLogged[int(MutationLogType::New)];
-            log->commit1();
-            log->commit2();
-            log.reset();
+            size_t num_items;
+            if (log) {
+                num_items = log->itemsLogged[int(MutationLogType::New)];
+                log->commit1();
+                log->commit2();
+                log.reset();
+            } else {
+                num_items = sortedLog->getNumKeys();
+                try {
+                    sortedLog->close();
+                } catch (const MutationLog::WriteException& e) {
+                    EP_LOG_WARN("Failed to write access log: {}", e.what());
+                    sortedLog.reset();
+                    remove(next.c_str());
+                    updateStateFinalizer(false);
+                    return;
+                }
+                sortedLog.reset();
+            }
             stats.alogRuntime.store(ep_real_time() - startTime);
             stats.alogNumItems.store(num_items);
             stats.accessScannerHisto.add(
@@ -180,6 +222,10 @@ public:
     }
 
 private:
+    bool isLogOpen() const {
+        return log || sortedLog;
+    }
+
     /**
      * Finalizer method called at the end of completing a visit.
      * @param created_log: Did we successfully create a MutationLog object on
@@ -213,6 +259,7 @@ private:
     std::vector<StoredDocKey> accessed;
 
     std::unique_ptr<MutationLog> log;
+    std::unique_ptr<SortedAccessLogWriter> sortedLog;
     std::atomic<bool> &stateFinalizer;
     AccessScanner &as;
 
@@ -56,12 +56,42 @@ void BgFetcher::stop() {
     ExecutorPool::get()->cancel(taskId);
 }
 
-void BgFetcher::addPendingVB(Vbid vbid) {
+void BgFetcher::addPendingVB(Vbid vbid, size_t numItems) {
     queue.pushUnique(vbid);
-    ++stats.numRemainingBgItems;
+    stats.numRemainingBgItems += numItems;
+    const auto batchSize = coalescingBatchSize.load();
+    const auto pending = pendingItems.fetch_add(numItems);
+    if (coalescingMaxWindow.load().count() != 0 && pending < batchSize &&
+        pending + numItems >= batchSize) {
+        // A fetch may be waiting for the batch to fill
+        std::lock_guard<std::mutex> guard(batchMutex);
+        batchCond.notify_one();
+    }
     wakeUpTaskIfSnoozed();
 }
 
+std::chrono::microseconds BgFetcher::getCoalescingWindow() const {
+    if (pendingItems >= coalescingBatchSize) {
+        return std::chrono::microseconds::zero();
+    }
+    return std::min(coalescingMaxWindow.load(),
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                            fetchLatency / 4));
+}
+
+void BgFetcher::waitForBatch() {
+    waitForBatchHook();
+    const auto window = getCoalescingWindow();
+    if (window.count() == 0) {
+        return;
+    }
+    TRACE_EVENT1("BgFetcher", "waitForBatch", "window_us", window.count());
+    std::unique_lock<std::mutex> lock(batchMutex);
+    batchCond.wait_for(lock, window, [this]() {
+        return pendingItems >= coalescingBatchSize;
+    });
+}
+
 void BgFetcher::wakeUpTaskIfSnoozed() {
     bool expected = false;
     if (pendingFetch.compare_exchange_strong(expected, true)) {
@@ -89,6 +119,10 @@ size_t BgFetcher::doFetch(Vbid vbId, vb_bgfetch_queue_t& itemsToFetch) {
 
     store.getROUnderlying(vbId)->getMulti(vbId, itemsToFetch);
 
+    const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - startTime);
+    fetchLatency = (fetchLatency * 7 + latency) / 8;
+
     std::vector<bgfetched_item_t> fetchedItems;
     for (const auto& fetch : itemsToFetch) {
         auto& key = fetch.first;
@@ -130,6 +164,11 @@ bool BgFetcher::run(GlobalTask *task) {
     task->snooze(INT_MAX);
     pendingFetch.store(false);
 
+    // At moderate load each wakeup only has one or two items to fetch; hold
+    // the fetch briefly so more items are read from disk in one getMulti
+    waitForBatch();
+    pendingItems.store(0);
+
     size_t num_fetched_items = 0;
 
     // Take size so we will yield after processing what was originally in the
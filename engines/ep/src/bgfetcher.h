@@ -14,6 +14,9 @@
 #include "testing_hook.h"
 #include "vb_ready_queue.h"
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 
 // Forward declarations.
 class EPStats;
@@ -54,15 +57,44 @@ public:
 
     /**
      * Add a Vbid to pendingVbs and notify the task if necessary
+     *
+     * @param vbId The vBucket with pending fetches
+     * @param numItems The number of fetches queued for the vBucket
+     */
+    void addPendingVB(Vbid vbId, size_t numItems = 1);
+
+    /// Set the longest time a fetch waits for more items to be queued
+    /// (0 = fetch as soon as woken)
+    void setCoalescingMaxWindow(std::chrono::microseconds window) {
+        coalescingMaxWindow.store(window);
+    }
+
+    /// Set the number of pending items for which a fetch doesn't wait
+    void setCoalescingBatchSize(size_t size) {
+        coalescingBatchSize.store(size);
+    }
+
+    /**
+     * Get how long the next fetch waits for more items to be queued, so
+     * that they're read from disk in one getMulti: a quarter of the average
+     * getMulti duration (so waiting adds at most a quarter to the latency
+     * of the fetches), capped by the max window. No wait if a batch of
+     * items is already pending.
      */
-    void addPendingVB(Vbid vbId);
+    std::chrono::microseconds getCoalescingWindow() const;
 
     // Test hook called before we complete a bg fetch
     TestingHook<> preCompleteHook;
 
+    // Test hook called when a fetch starts its coalescing window
+    TestingHook<> waitForBatchHook;
+
 private:
     size_t doFetch(Vbid vbId, vb_bgfetch_queue_t& items);
 
+    /// Wait for the coalescing window, or until a batch of items is pending
+    void waitForBatch();
+
     /// If the BGFetch task is currently snoozed (not scheduled to
     /// run), wake it up. Has no effect the if the task has already
     /// been woken.
@@ -75,4 +107,18 @@ private:
     std::atomic<bool> pendingFetch;
 
     VBReadyQueue queue;
+
+    /// The number of items queued since the last fetch started
+    std::atomic<size_t> pendingItems{0};
+
+    std::atomic<std::chrono::microseconds> coalescingMaxWindow{
+            std::chrono::microseconds::zero()};
+    std::atomic<size_t> coalescingBatchSize{1};
+
+    /// Moving average of the duration of getMulti (only used by the task)
+    std::chrono::nanoseconds fetchLatency{0};
+
+    /// Notified when a batch of items is pending
+    std::mutex batchMutex;
+    std::condition_variable batchCond;
 };
@@ -33,8 +33,21 @@ Blob* Blob::Copy(const Blob& other) {
     return t;
 }
 
-Blob::Blob(const char* start, const size_t len)
-    : size(static_cast<uint32_t>(len)), age(0) {
+Blob* Blob::NewEmbedded(void* where, const char* start, const size_t len) {
+    return new (where) Blob(start, len, /*embedded*/ true);
+}
+
+void Blob::assignEmbedded(const Blob& other) {
+    ObjectRegistry::onDeleteBlob(this);
+    size = (other.size.load() & ~embeddedBit) | embeddedBit;
+    age = 0;
+    std::memcpy(data, other.data, other.valueSize());
+    ObjectRegistry::onCreateBlob(this);
+}
+
+Blob::Blob(const char* start, const size_t len, bool embedded)
+    : size(static_cast<uint32_t>(len) | (embedded ? embeddedBit : 0)),
+      age(0) {
     if (start != nullptr) {
         std::memcpy(data, start, len);
 #ifdef VALGRIND
@@ -49,7 +62,7 @@ Blob::Blob(const size_t len) : Blob(nullptr, len) {
 }
 
 Blob::Blob(const Blob& other)
-    : size(other.size.load()),
+    : size(other.size.load() & ~embeddedBit),
       // While this is a copy, it is a new allocation therefore reset age.
       age(0) {
     std::memcpy(data, other.data, other.valueSize());
@@ -47,6 +47,48 @@ public:
      */
     static Blob* Copy(const Blob& other);
 
+    /**
+     * Header which immediately precedes an embedded Blob, describing the
+     * allocation the Blob is embedded in.
+     */
+    struct EmbeddedHeader {
+        /// Offset of the embedded Blob from the start of the allocation.
+        uint32_t offset;
+        /// Size of the whole allocation (as passed to operator new).
+        uint32_t allocationSize;
+    };
+
+    /**
+     * Create a new Blob holding the given data, embedded in a larger
+     * allocation owned by some other object (for example a StoredValue which
+     * keeps small values inline).
+     *
+     * The caller must have initialised the EmbeddedHeader immediately
+     * preceding `where`. Ownership of the whole allocation passes to the
+     * Blob: when the last reference to it is released the allocation
+     * described by the header is freed, hence the owner must hold its own
+     * reference to the Blob for as long as it uses the allocation.
+     *
+     * @param where memory (of at least getAllocationSize(len) bytes) to
+     *        create the Blob in
+     * @param start the beginning of the data to copy into this blob
+     * @param len the amount of data to copy in
+     */
+    static Blob* NewEmbedded(void* where, const char* start, const size_t len);
+
+    /**
+     * Overwrite the contents of this embedded Blob with a copy of the given
+     * Blob. Only valid if no other object references this Blob (other than
+     * the owner of the allocation it is embedded in), and if the allocation
+     * has room for other.valueSize() bytes.
+     */
+    void assignEmbedded(const Blob& other);
+
+    /// @returns the number of bytes required for a Blob of the given size.
+    static size_t getAllocationSize(size_t len) {
+        return sizeof(Blob) + len - sizeof(Blob(nullptr, 0).data);
+    }
+
     // Actual accessorish things.
 
     /**
@@ -60,7 +102,7 @@ public:
      * Get the size of this Blob's value.
      */
     size_t valueSize() const {
-        return size & ~(0x80000000);
+        return size & ~(uncompressibleBit | embeddedBit);
     }
 
     /**
@@ -102,7 +144,26 @@ public:
      * This should be fine given that the maximum value we support is 20 MiB
      */
     void setUncompressible() {
-        size |= 0x80000000;
+        size |= uncompressibleBit;
+    }
+
+    /**
+     * Is this Blob embedded in another object's allocation (see NewEmbedded)?
+     */
+    bool isEmbedded() const {
+        return size & embeddedBit;
+    }
+
+    /**
+     * Get the number of bytes reserved for this embedded Blob - from the
+     * start of the Blob to the end of the allocation it is embedded in,
+     * which may be more than getSize() if the current value is smaller than
+     * the space reserved for it. Only valid if isEmbedded().
+     */
+    size_t getEmbeddedReservedSize() const {
+        const auto& header =
+                reinterpret_cast<const EmbeddedHeader*>(this)[-1];
+        return header.allocationSize - header.offset;
     }
 
     /**
@@ -121,6 +182,14 @@ public:
         // We actually know the size of the allocation, so use that to
         // optimise deletion.
         auto* blob = reinterpret_cast<Blob*>(ptr);
+        if (blob->isEmbedded()) {
+            // The Blob owns the allocation it is embedded in; free all of it.
+            const auto& header =
+                    reinterpret_cast<const EmbeddedHeader*>(ptr)[-1];
+            ::operator delete(static_cast<char*>(ptr) - header.offset,
+                              header.allocationSize);
+            return;
+        }
         auto size = Blob::getAllocationSize(blob->valueSize());
         ::operator delete(blob, size);
     }
@@ -143,6 +212,10 @@ private:
     //Ensure Blob size of 12 bytes by padding by 3.
     static constexpr int paddingSize{3};
 
+    // Flags stored in the (otherwise unused) high bits of size.
+    static constexpr uint32_t uncompressibleBit = 0x80000000;
+    static constexpr uint32_t embeddedBit = 0x40000000;
+
 protected:
     /* Constructor.
      * @param start If non-NULL, pointer to array which will be copied into
@@ -150,19 +223,18 @@ protected:
      * @param len   Size of the data the Blob object will hold, and size of
      *              the data at {start}.
      */
-    explicit Blob(const char* start, const size_t len);
+    explicit Blob(const char* start,
+                  const size_t len,
+                  bool embedded = false);
 
     explicit Blob(const size_t len);
 
     explicit Blob(const Blob& other);
 
-    static size_t getAllocationSize(size_t len) {
-        return sizeof(Blob) + len - sizeof(Blob(nullptr, 0).data);
-    }
-
     // Size of the value. The highest bit is used to represent if the
     // value is compressible or not. If set, then the value is not
-    // compressible. This needs to be an atomic variable as there could
+    // compressible. The second highest bit is set for embedded Blobs.
+    // This needs to be an atomic variable as there could
     // be a data race between threads that update the size
     // (e.g, the setUncompressible API) and the ones that read the size
     std::atomic<uint32_t> size;
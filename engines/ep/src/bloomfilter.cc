@@ -13,9 +13,13 @@
 
 #include "bloomfilter.h"
 
+#include <platform/crc32c.h>
 #include <platform/murmurhash3.h>
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <stdexcept>
 
 #if __x86_64__ || __ppc64__
 #define MURMURHASH_3 MurmurHash3_x64_128
@@ -23,25 +27,87 @@
 #define MURMURHASH_3 MurmurHash3_x86_128
 #endif
 
+namespace {
+/// Header of a serialised BloomFilter; followed by the filter's bits and
+/// a crc32c of the header and bits.
+struct SerialisedHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t layout;
+    uint16_t reserved;
+    uint32_t noOfHashes;
+    uint32_t reserved2;
+    uint64_t filterSize;
+    uint64_t keyCounter;
+    uint64_t vbUuid;
+    uint64_t persistedSeqno;
+};
+
+// Stored in native byte order, so a filter written on a machine of the
+// other endianness is rejected.
+constexpr uint32_t serialisedMagic = 0x42466c74; // "BFlt"
+constexpr uint8_t serialisedVersion = 1;
+} // namespace
+
+BloomFilter::Layout BloomFilter::layoutFromString(std::string_view layout) {
+    if (layout == "classic") {
+        return Layout::Classic;
+    }
+    if (layout == "blocked") {
+        return Layout::Blocked;
+    }
+    throw std::invalid_argument(
+            "BloomFilter::layoutFromString: Invalid layout:" +
+            std::string(layout));
+}
+
 BloomFilter::BloomFilter(size_t key_count,
                          double false_positive_prob,
-                         bfilter_status_t new_status)
-    : filterSize(estimateFilterSize(key_count, false_positive_prob)),
-      noOfHashes(estimateNoOfHashes(key_count)),
+                         bfilter_status_t new_status,
+                         Layout layout)
+    : layout(layout),
+      filterSize(estimateFilterSize(key_count, false_positive_prob)),
+      noOfHashes(estimateNoOfHashes(key_count, false_positive_prob)),
+      keyCounter(0),
+      status(new_status) {
+    if (layout == Layout::Classic) {
+        bitArray.resize(filterSize, false);
+    } else {
+        blocks.resize(filterSize / Block::Bits);
+    }
+}
+
+BloomFilter::BloomFilter(Layout layout, size_t filterSize, size_t noOfHashes)
+    : layout(layout),
+      filterSize(filterSize),
+      noOfHashes(noOfHashes),
       keyCounter(0),
-      status(new_status),
-      bitArray(filterSize, false) {
+      status(BFILTER_ENABLED) {
 }
 
 BloomFilter::~BloomFilter() = default;
 
 size_t BloomFilter::estimateFilterSize(size_t key_count,
                                        double false_positive_prob) {
-    return round(-(((double)(key_count) * log(false_positive_prob))
+    size_t bits = round(-(((double)(key_count) * log(false_positive_prob))
                                                     / (pow(log(2.0), 2))));
+    if (layout == Layout::Blocked) {
+        // Round up to whole blocks.
+        bits = std::max(size_t(1), (bits + Block::Bits - 1) / Block::Bits) *
+               Block::Bits;
+    }
+    return bits;
 }
 
-size_t BloomFilter::estimateNoOfHashes(size_t key_count) {
+size_t BloomFilter::estimateNoOfHashes(size_t key_count,
+                                       double false_positive_prob) {
+    if (layout == Layout::Blocked) {
+        // The filter size has been rounded up to whole blocks, so use the
+        // optimal number of hashes for the requested probability (which is
+        // what the unrounded size would give), instead of over-saturating
+        // each block.
+        return std::max(1L, std::lround(-std::log2(false_positive_prob)));
+    }
     return round(((double) filterSize / key_count) * (log(2.0)));
 }
 
@@ -53,6 +119,63 @@ uint64_t BloomFilter::hashDocKey(const DocKey& key, uint32_t iteration) {
     return result;
 }
 
+size_t BloomFilter::getBlockMasks(
+        const DocKey& key, std::array<uint64_t, Block::Words>& masks) const {
+    // One 128-bit hash per key: the first half selects the block, the second
+    // half generates the bit positions within it (by double hashing).
+    std::array<uint64_t, 2> result;
+    auto hashable = key.getIdAndKey();
+    MURMURHASH_3(hashable.second.data(),
+                 hashable.second.size(),
+                 uint32_t(hashable.first),
+                 result.data());
+
+    uint32_t bit = uint32_t(result[1]);
+    const uint32_t step = uint32_t(result[1] >> 32) | 1;
+    masks.fill(0);
+    for (size_t i = 0; i < noOfHashes; i++) {
+        const auto pos = bit % Block::Bits;
+        masks[pos / 64] |= uint64_t(1) << (pos % 64);
+        bit += step;
+    }
+    return result[0] % blocks.size();
+}
+
+void BloomFilter::addKeyBlocked(const DocKey& key) {
+    if (blocks.empty()) {
+        return;
+    }
+    std::array<uint64_t, Block::Words> masks;
+    auto& block = blocks[getBlockMasks(key, masks)];
+    uint64_t newBits = 0;
+    for (size_t w = 0; w < Block::Words; w++) {
+        newBits |= masks[w] & ~block.words[w];
+        block.words[w] |= masks[w];
+    }
+    if (newBits) {
+        keyCounter++;
+    }
+}
+
+bool BloomFilter::maybeKeyExistsBlocked(const DocKey& key) const {
+    if (blocks.empty()) {
+        return true;
+    }
+    std::array<uint64_t, Block::Words> masks;
+    const auto& block = blocks[getBlockMasks(key, masks)];
+    // Branch-free test of all words, which the compiler can vectorise.
+    uint64_t missing = 0;
+    for (size_t w = 0; w < Block::Words; w++) {
+        missing |= masks[w] & ~block.words[w];
+    }
+    return missing == 0;
+}
+
+void BloomFilter::clearBits() {
+    bitArray.clear();
+    blocks.clear();
+}
+
 void BloomFilter::setStatus(bfilter_status_t to) {
     switch (status) {
         case BFILTER_DISABLED:
@@ -63,7 +186,7 @@ void BloomFilter::setStatus(bfilter_status_t to) {
         case BFILTER_PENDING:
             if (to == BFILTER_DISABLED) {
                 status = to;
-                bitArray.clear();
+                clearBits();
             } else if (to == BFILTER_COMPACTING) {
                 status = to;
             }
@@ -71,7 +194,7 @@ void BloomFilter::setStatus(bfilter_status_t to) {
         case BFILTER_COMPACTING:
             if (to == BFILTER_DISABLED) {
                 status = to;
-                bitArray.clear();
+                clearBits();
             } else if (to == BFILTER_ENABLED) {
                 status = to;
             }
@@ -79,7 +202,7 @@ void BloomFilter::setStatus(bfilter_status_t to) {
         case BFILTER_ENABLED:
             if (to == BFILTER_DISABLED) {
                 status = to;
-                bitArray.clear();
+                clearBits();
             } else if (to == BFILTER_COMPACTING) {
                 status = to;
             }
@@ -107,6 +230,10 @@ std::string BloomFilter::getStatusString() {
 
 void BloomFilter::addKey(const DocKey& key) {
     if (status == BFILTER_COMPACTING || status == BFILTER_ENABLED) {
+        if (layout == Layout::Blocked) {
+            addKeyBlocked(key);
+            return;
+        }
         bool overlap = true;
         for (uint32_t i = 0; i < noOfHashes; i++) {
             uint64_t result = hashDocKey(key, i);
@@ -123,6 +250,9 @@ void BloomFilter::addKey(const DocKey& key) {
 
 bool BloomFilter::maybeKeyExists(const DocKey& key) {
     if (status == BFILTER_COMPACTING || status == BFILTER_ENABLED) {
+        if (layout == Layout::Blocked) {
+            return maybeKeyExistsBlocked(key);
+        }
         for (uint32_t i = 0; i < noOfHashes; i++) {
             uint64_t result = hashDocKey(key, i);
             if (bitArray[result % filterSize] == 0) {
@@ -163,3 +293,95 @@ size_t BloomFilter::getMemoryFootprint() const {
     // filterSize is measured in bits.
     return sizeof(BloomFilter) + (filterSize / 8);
 }
+
+std::string BloomFilter::serialise(uint64_t vbUuid,
+                                   uint64_t persistedSeqno) const {
+    if (status != BFILTER_ENABLED) {
+        throw std::logic_error(
+                "BloomFilter::serialise: Filter is not enabled, status:" +
+                std::to_string(status));
+    }
+    SerialisedHeader header{};
+    header.magic = serialisedMagic;
+    header.version = serialisedVersion;
+    header.layout = uint8_t(layout);
+    header.noOfHashes = noOfHashes;
+    header.filterSize = filterSize;
+    header.keyCounter = keyCounter;
+    header.vbUuid = vbUuid;
+    header.persistedSeqno = persistedSeqno;
+
+    const size_t bitBytes = (filterSize + 7) / 8;
+    std::string data(sizeof(header) + bitBytes + sizeof(uint32_t), '\0');
+    std::memcpy(data.data(), &header, sizeof(header));
+    auto* bits = data.data() + sizeof(header);
+    if (layout == Layout::Blocked) {
+        std::memcpy(bits, blocks.data(), bitBytes);
+    } else {
+        for (size_t i = 0; i < filterSize; i++) {
+            if (bitArray[i]) {
+                bits[i / 8] |= char(1 << (i % 8));
+            }
+        }
+    }
+    const uint32_t crc = crc32c(reinterpret_cast<const uint8_t*>(data.data()),
+                                sizeof(header) + bitBytes,
+                                0);
+    std::memcpy(bits + bitBytes, &crc, sizeof(crc));
+    return data;
+}
+
+std::unique_ptr<BloomFilter> BloomFilter::deserialise(std::string_view data,
+                                                      uint64_t vbUuid,
+                                                      uint64_t persistedSeqno) {
+    SerialisedHeader header;
+    if (data.size() < sizeof(header) + sizeof(uint32_t)) {
+        return {};
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != serialisedMagic ||
+        header.version != serialisedVersion ||
+        header.layout > uint8_t(Layout::Blocked) ||
+        header.vbUuid != vbUuid || header.persistedSeqno != persistedSeqno) {
+        return {};
+    }
+    const auto layout = Layout(header.layout);
+    const size_t bitBytes = (header.filterSize + 7) / 8;
+    if (data.size() != sizeof(header) + bitBytes + sizeof(uint32_t) ||
+        (layout == Layout::Blocked &&
+         (header.filterSize == 0 || header.filterSize % Block::Bits))) {
+        return {};
+    }
+    uint32_t crc;
+    std::memcpy(&crc, data.data() + sizeof(header) + bitBytes, sizeof(crc));
+    if (crc != crc32c(reinterpret_cast<const uint8_t*>(data.data()),
+                      sizeof(header) + bitBytes,
+                      0)) {
+        return {};
+    }
+
+    std::unique_ptr<BloomFilter> filter{
+            new BloomFilter(layout, header.filterSize, header.noOfHashes)};
+    filter->keyCounter = header.keyCounter;
+    const auto* bits = data.data() + sizeof(header);
+    if (layout == Layout::Blocked) {
+        filter->blocks.resize(header.filterSize / Block::Bits);
+        std::memcpy(filter->blocks.data(), bits, bitBytes);
+    } else {
+        filter->bitArray.resize(header.filterSize);
+        for (size_t i = 0; i < header.filterSize; i++) {
+            filter->bitArray[i] = (bits[i / 8] >> (i % 8)) & 1;
+        }
+    }
+    return filter;
+}
+
+std::string to_string(BloomFilter::Layout layout) {
+    switch (layout) {
+    case BloomFilter::Layout::Classic:
+        return "classic";
+    case BloomFilter::Layout::Blocked:
+        return "blocked";
+    }
+    return "<unknown>";
+}
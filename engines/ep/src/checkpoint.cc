@@ -11,7 +11,10 @@
 
 #include <gsl/gsl-lite.hpp>
 #include <platform/checked_snprintf.h>
+#include <algorithm>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "bucket_logger.h"
@@ -51,6 +54,89 @@ std::string to_string(QueueDirtyStatus value) {
                                 std::to_string(int(value)));
 }
 
+CheckpointIndex::CheckpointIndex(const CheckpointQueue& queue,
+                                 const allocator_type& allocator)
+    : queue(queue), slots(allocator) {
+}
+
+uint64_t CheckpointIndex::hashKey(const DocKey& key) {
+    const uint64_t hash = std::hash<std::string_view>{}(
+            {reinterpret_cast<const char*>(key.data()), key.size()});
+    // 0 marks an empty slot
+    return hash ? hash : 1;
+}
+
+CheckpointIndex::Slot& CheckpointIndex::findSlot(const DocKey& key,
+                                                 uint64_t hash) {
+    const auto mask = slots.size() - 1;
+    for (auto idx = hash & mask;; idx = (idx + 1) & mask) {
+        auto& slot = slots[idx];
+        if (slot.hash == 0) {
+            return slot;
+        }
+        if (slot.hash != hash) {
+            continue;
+        }
+
+        CheckpointQueue::const_iterator pos = slot.entry.getPosition();
+        if (pos == queue.begin() || pos == queue.end()) {
+            // Invalidated (expelled) entry, the hash is all we have
+            return slot;
+        }
+        const auto& existing = (*pos)->getKey();
+        if (existing.size() == key.size() &&
+            std::equal(existing.data(),
+                       existing.data() + existing.size(),
+                       key.data())) {
+            return slot;
+        }
+    }
+}
+
+IndexEntry* CheckpointIndex::find(const DocKey& key) {
+    if (numEntries == 0) {
+        return nullptr;
+    }
+    auto& slot = findSlot(key, hashKey(key));
+    return slot.hash ? &slot.entry : nullptr;
+}
+
+bool CheckpointIndex::insertOrAssign(const DocKey& key,
+                                     const IndexEntry& entry) {
+    if ((numEntries + 1) * 4 > slots.size() * 3) {
+        grow();
+    }
+
+    const auto hash = hashKey(key);
+    auto& slot = findSlot(key, hash);
+    slot.entry = entry;
+    if (slot.hash) {
+        return false;
+    }
+    slot.hash = hash;
+    ++numEntries;
+    return true;
+}
+
+void CheckpointIndex::grow() {
+    std::vector<Slot, allocator_type> old(slots.get_allocator());
+    old.swap(slots);
+    slots.resize(old.empty() ? initialCapacity : old.size() * 2);
+
+    // The keys are unique so they only need to be placed, not compared
+    const auto mask = slots.size() - 1;
+    for (const auto& slot : old) {
+        if (slot.hash == 0) {
+            continue;
+        }
+        auto idx = slot.hash & mask;
+        while (slots[idx].hash != 0) {
+            idx = (idx + 1) & mask;
+        }
+        slots[idx] = slot;
+    }
+}
+
 Checkpoint::Checkpoint(CheckpointManager& manager,
                        EPStats& st,
                        uint64_t id,
@@ -72,8 +158,8 @@ Checkpoint::Checkpoint(CheckpointManager& manager,
       numItems(0),
       numMetaItems(0),
       toWrite(queueAllocator),
-      committedKeyIndex(keyIndexAllocator),
-      preparedKeyIndex(keyIndexAllocator),
+      committedKeyIndex(toWrite, keyIndexAllocator),
+      preparedKeyIndex(toWrite, keyIndexAllocator),
       keyIndexMemUsage(st, &manager.estimatedMemUsage),
       queuedItemsMemUsage(st, &manager.estimatedMemUsage),
       queueMemOverhead(st, &manager.estimatedMemUsage),
@@ -140,9 +226,7 @@ QueueDirtyResult Checkpoint::queueDirty(const queued_item& qi) {
         addItemToCheckpoint(qi);
     } else {
         // Check in the appropriate key index if an item already exists.
-        auto& keyIndex =
-                qi->isCommitted() ? committedKeyIndex : preparedKeyIndex;
-        auto it = keyIndex.find(makeIndexKey(qi));
+        auto* indexEntry = getKeyIndex(qi).find(qi->getKey());
 
         // Before de-duplication could discard a delete, store the largest
         // "rev-seqno" encountered
@@ -151,12 +235,10 @@ QueueDirtyResult Checkpoint::queueDirty(const queued_item& qi) {
             maxDeletedRevSeqno = qi->getRevSeqno();
         }
 
-        if (it != keyIndex.end()) {
+        if (indexEntry) {
             // Case: key is in the index, need to execute the de-dup path
 
-            const auto& indexEntry = it->second;
-
-            if (indexEntry.getPosition() == toWrite.begin() ||
+            if (indexEntry->getPosition() == toWrite.begin() ||
                 qi->getOperation() == queue_op::commit_sync_write) {
                 // Case: sync mutation expelled or new item is a Commit
 
@@ -169,7 +251,7 @@ QueueDirtyResult Checkpoint::queueDirty(const queued_item& qi) {
                 // a mutation) then we must also place the op in a new
                 // checkpoint.
                 return {QueueDirtyStatus::FailureDuplicateItem, 0};
-            } else if (indexEntry.getPosition() == toWrite.end()) {
+            } else if (indexEntry->getPosition() == toWrite.end()) {
                 // Case: normal mutation expelled
 
                 // Always return PersistAgain because if the old item has been
@@ -195,10 +277,10 @@ QueueDirtyResult Checkpoint::queueDirty(const queued_item& qi) {
                 // Note: In this case the index entry points to a valid position
                 // in toWrite, so we can make our de-dup checks.
                 const auto existingSeqno =
-                        (*indexEntry.getPosition())->getBySeqno();
+                        (*indexEntry->getPosition())->getBySeqno();
                 Expects(highestExpelledSeqno < existingSeqno);
 
-                const auto oldPos = it->second.getPosition();
+                const auto oldPos = indexEntry->getPosition();
                 const auto& oldItem = *oldPos;
                 if (!(canDedup(oldItem, qi))) {
                     return {QueueDirtyStatus::FailureDuplicateItem, 0};
@@ -345,8 +427,11 @@ QueueDirtyResult Checkpoint::queueDirty(const queued_item& qi) {
                     rv.successExistingByteDiff = qi->size() - oldItem->size();
                 }
 
-                // Queue the new item and remove the dedup'ed one
+                // Queue the new item and remove the dedup'ed one. The index
+                // entry must move to the new item first, as the index compares
+                // keys against the item an entry points to.
                 addItemToCheckpoint(qi);
+                *indexEntry = IndexEntry(--toWrite.end());
                 removeItemFromCheckpoint(oldPos);
             }
         } else {
@@ -377,16 +462,10 @@ QueueDirtyResult Checkpoint::queueDirty(const queued_item& qi) {
         const auto entry = IndexEntry(--toWrite.end());
         // Set the index of the key to the new item that is pushed back into
         // the list.
-        auto& keyIndex =
-                qi->isCommitted() ? committedKeyIndex : preparedKeyIndex;
-        auto result = keyIndex.emplace(makeIndexKey(qi), entry);
-        if (!result.second) {
-            // Did not manage to insert - so update the value directly
-            result.first->second = entry;
-        }
+        getKeyIndex(qi).insertOrAssign(qi->getKey(), entry);
 
         if (rv.status == QueueDirtyStatus::SuccessNewItem) {
-            const auto indexKeyUsage = qi->getKey().size() + sizeof(IndexEntry);
+            const auto indexKeyUsage = sizeof(CheckpointIndex::Slot);
             stats.coreLocal.get()->memOverhead.fetch_add(indexKeyUsage);
             // Update the total keyIndex memory usage which is used when the
             // checkpoint is destructed to manually account for the freed mem.
@@ -525,19 +604,17 @@ CheckpointQueue Checkpoint::expelItems(const ChkptQueueIterator& last,
         // keyIndex entry must be invalidated.
         for (const auto& expelled : expelledItems) {
             if (!expelled->isCheckPointMetaItem()) {
-                auto& keyIndex = expelled->isCommitted() ? committedKeyIndex
-                                                         : preparedKeyIndex;
-
-                auto it = keyIndex.find(makeIndexKey(expelled));
-                Expects(it != keyIndex.end());
+                auto* indexEntry =
+                        getKeyIndex(expelled).find(expelled->getKey());
+                Expects(indexEntry);
 
                 // An IndexEntry is invalidated by placing the underlying
                 // iterator to one of the following special positions:
                 // - toWrite::end(), if the expelled item is a normal mutation
                 // - toWrite::begin(), if the expelled item is sync mutation
-                it->second.invalidate(expelled->isAnySyncWriteOp()
-                                              ? toWrite.begin()
-                                              : toWrite.end());
+                indexEntry->invalidate(expelled->isAnySyncWriteOp()
+                                               ? toWrite.begin()
+                                               : toWrite.end());
             }
         }
     }
@@ -550,9 +627,6 @@ CheckpointQueue Checkpoint::expelItems(const ChkptQueueIterator& last,
     return expelledItems;
 }
 
-CheckpointIndexKeyType Checkpoint::makeIndexKey(const queued_item& item) const {
-    return CheckpointIndexKeyType(item->getKey(), keyIndexKeyAllocator);
-}
 
 void Checkpoint::addStats(const AddStatFn& add_stat,
                           const CookieIface* cookie) {
@@ -18,7 +18,6 @@
 #include <platform/monotonic.h>
 
 #include <folly/Synchronized.h>
-#include <folly/container/F14Map.h>
 #include <memcached/engine_common.h>
 #include <platform/non_negative_counter.h>
 #include <optional>
@@ -27,6 +26,7 @@
 #include <map>
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 /**
  * The state of a given checkpoint.
@@ -37,6 +37,8 @@ const char* to_string(enum checkpoint_state);
 
 class IndexEntry {
 public:
+    IndexEntry() = default;
+
     IndexEntry(const CheckpointQueue::iterator& it) : position(it) {
     }
 
@@ -59,18 +61,85 @@ private:
 };
 
 /**
- * The checkpoint index maps a key to a checkpoint index_entry.
+ * The checkpoint index maps a key to the IndexEntry of the (newest) instance
+ * of the key queued in the checkpoint.
+ *
+ * The index is an open-addressed (linear probing) table which stores only a
+ * 64-bit hash of each key next to its IndexEntry; the full key is compared
+ * against the queued item the entry points to. That saves the copy of every
+ * key (and the node allocation per key) a node based map needs, which for
+ * small documents is as much as the items themselves.
+ *
+ * Entries invalidated by expelling don't point to an item any more, so they
+ * are matched on the hash alone. A collision there only makes queueDirty
+ * take the conservative path for a key it believes was expelled (persist
+ * again, or a new checkpoint for a SyncWrite).
+ *
+ * Entries are never removed, the index is freed with the checkpoint.
  */
-using CheckpointIndexKeyType = StoredDocKeyT<MemoryTrackingAllocator>;
-using CheckpointIndexValueType =
-        std::pair<const CheckpointIndexKeyType, IndexEntry>;
+class CheckpointIndex {
+public:
+    struct Slot {
+        /// Hash of the key, 0 for an empty slot
+        uint64_t hash{0};
+        IndexEntry entry;
+    };
+
+    using allocator_type = MemoryTrackingAllocator<Slot>;
+
+    /**
+     * @param queue The queue the entries point into; entries pointing to
+     *        queue.begin() or queue.end() are invalidated entries.
+     * @param allocator Allocator tracking the memory used by the index
+     */
+    CheckpointIndex(const CheckpointQueue& queue,
+                    const allocator_type& allocator);
+
+    /**
+     * @return the entry for the key, or nullptr if the key is not in the
+     *         index. The pointer is invalidated by the next insertOrAssign.
+     */
+    IndexEntry* find(const DocKey& key);
+
+    /**
+     * Set the entry for the key.
+     *
+     * @return true if the key was added, false if the entry of the key
+     *         already in the index was updated
+     */
+    bool insertOrAssign(const DocKey& key, const IndexEntry& entry);
+
+    /// @return the number of keys in the index
+    size_t size() const {
+        return numEntries;
+    }
+
+    allocator_type get_allocator() const {
+        return slots.get_allocator();
+    }
+
+    /// @return the (non-zero) hash the index uses for the key
+    static uint64_t hashKey(const DocKey& key);
+
+private:
+    /**
+     * @return the slot holding the key, or the empty slot where the key
+     *         belongs if it isn't in the index
+     */
+    Slot& findSlot(const DocKey& key, uint64_t hash);
+
+    /// Double the capacity (the table is kept at most 3/4 full)
+    void grow();
 
-using checkpoint_index =
-        folly::F14NodeMap<CheckpointIndexKeyType,
-                          IndexEntry,
-                          std::hash<CheckpointIndexKeyType>,
-                          std::equal_to<>,
-                          MemoryTrackingAllocator<CheckpointIndexValueType>>;
+    const CheckpointQueue& queue;
+    std::vector<Slot, allocator_type> slots;
+    size_t numEntries{0};
+
+    /// Capacity allocated by the first insert (a power of two)
+    static constexpr size_t initialCapacity = 16;
+};
+
+using checkpoint_index = CheckpointIndex;
 
 class Checkpoint;
 class CheckpointManager;
@@ -483,7 +552,7 @@ public:
      */
     size_t getMemOverheadAllocatorBytes() const {
         return sizeof(Checkpoint) + getKeyIndexAllocatorBytes() +
-               getKeyIndexKeyAllocatorBytes() + getWriteQueueAllocatorBytes();
+               getWriteQueueAllocatorBytes();
     }
 
     /**
@@ -542,9 +611,13 @@ public:
         return maxDeletedRevSeqno;
     }
 
-    /// @return bytes allocated to keys stored in the keyIndex as a signed type
+    /**
+     * @return bytes allocated to keys stored in the keyIndex as a signed type.
+     * The keyIndex doesn't copy the keys any more (see CheckpointIndex), this
+     * is always 0 and only remains for the stats which report it.
+     */
     ssize_t getKeyIndexKeyAllocatorBytes() const {
-        return keyIndexKeyAllocator.getBytesAllocated();
+        return 0;
     }
 
     /// @return bytes allocated to keyIndex as a signed type
@@ -614,11 +687,10 @@ public:
     static constexpr uint8_t per_item_queue_overhead = 3 * sizeof(uintptr_t);
 
 private:
-    /**
-     * Make a CheckpointIndexKey for inserting items into or finding items in
-     * the key index(es).
-     */
-    CheckpointIndexKeyType makeIndexKey(const queued_item& item) const;
+    /// @return the key index for the (non-meta) item
+    CheckpointIndex& getKeyIndex(const queued_item& item) {
+        return item->isCommitted() ? committedKeyIndex : preparedKeyIndex;
+    }
 
     // Pointer to the CheckpointManager that owns this Checkpoint.
     // Will be made null when removing the checkpoint from the manager.
@@ -650,10 +722,7 @@ private:
     MemoryTrackingAllocator<queued_item> queueAllocator;
 
     // Allocator used for tracking memory used by keyIndex
-    checkpoint_index::allocator_type keyIndexAllocator;
-
-    // Allocator used for tracking memory used by keys stored in the keyIndex
-    checkpoint_index::key_type::allocator_type keyIndexKeyAllocator;
+    CheckpointIndex::allocator_type keyIndexAllocator;
 
     CheckpointQueue toWrite;
 
@@ -668,8 +737,8 @@ private:
      * Currently an abort exists in the same namespace as a prepare so we will
      * mimic that here and not allow prepares and aborts in the same checkpoint.
      */
-    checkpoint_index committedKeyIndex;
-    checkpoint_index preparedKeyIndex;
+    CheckpointIndex committedKeyIndex;
+    CheckpointIndex preparedKeyIndex;
 
     /**
      * Helper class for local memory-counters that need to reflect their updates
@@ -710,7 +779,7 @@ private:
     };
 
     // Record the memory overhead of maintaining the keyIndex and metaKeyIndex.
-    // This includes each item's key size and sizeof(index_entry).
+    // This is sizeof(CheckpointIndex::Slot) per key in the index.
     MemoryCounter keyIndexMemUsage;
 
     // Records the memory consumption of all items in the checkpoint queue.
@@ -312,6 +312,17 @@ public:
         return key;
     }
 
+    /**
+     * Re-target the handle at another key without dropping the read lock,
+     * allowing a batch of keys to be looked up under one lock acquisition.
+     *
+     * @param newKey the key to use for subsequent lookups
+     */
+    void setKey(DocKey newKey) {
+        itr = manifest->getManifestEntry(newKey);
+        key = newKey;
+    }
+
     /**
      * @param a seqno to check, the seqno should belong to the document
      *        identified by the key returned by ::getKey()
@@ -13,6 +13,7 @@
 
 #include "checkpoint.h"
 #include "checkpoint_manager.h"
+#include "dcp/dcpconnmap.h"
 #include "dcp/producer.h"
 #include "dcp/response.h"
 #include "ep_time.h"
@@ -410,19 +411,22 @@ bool ActiveStream::backfillReceived(std::unique_ptr<Item> itm,
     if (!itm) {
         return false;
     }
+    return backfillReceived(queued_item(std::move(itm)), backfill_source);
+}
 
+bool ActiveStream::backfillReceived(queued_item qi,
+                                    backfill_source_t backfill_source) {
     // Should the item replicate?
-    if (!shouldProcessItem(*itm)) {
+    if (!shouldProcessItem(*qi)) {
         return true; // skipped, but return true as it's not a failure
     }
 
     // Is the item accepted by the stream filter (e.g matching collection?)
-    if (!filter.checkAndUpdate(*itm)) {
+    if (!filter.checkAndUpdate(*qi)) {
         // Skip this item, but continue backfill at next item.
         return true;
     }
 
-    queued_item qi(std::move(itm));
     // We need to send a mutation instead of a commit if this Item is a
     // commit as we may have de-duped the preceding prepare and the replica
     // needs to know what to commit.
@@ -1025,7 +1029,31 @@ std::unique_ptr<DcpResponse> ActiveStream::makeResponseFromItem(
             const auto wasInflated = finalItem->removeBodyAndOrXattrs(
                     includeValue, includeXattributes, includeDeletedUserXattrs);
 
-            if (isSnappyEnabled()) {
+            // If the value is unchanged (only its compression needs changing)
+            // then other streams of the vBucket likely need the same
+            // conversion; share it via the value conversion cache.
+            const bool compress = isSnappyEnabled();
+            if (finalItem->getValue().get().get() ==
+                        item->getValue().get().get() &&
+                finalItem->getNBytes() > 0 &&
+                (!compress || isForceValueCompressionEnabled())) {
+                auto& cache = engine->getDcpConnMap().getValueConversionCache();
+                const auto converted = compress
+                                               ? cache.getCompressed(*finalItem)
+                                               : cache.getInflated(*finalItem);
+                if (converted) {
+                    finalItem->replaceValue(converted->value.get());
+                    finalItem->setDataType(converted->datatype);
+                } else if (compress) {
+                    log(spdlog::level::level_enum::warn,
+                        "{} Failed to snappy compress an uncompressed value",
+                        logPrefix);
+                } else {
+                    log(spdlog::level::level_enum::warn,
+                        "{} Failed to snappy uncompress a compressed value",
+                        logPrefix);
+                }
+            } else if (isSnappyEnabled()) {
                 if (isForceValueCompressionEnabled()) {
                     if (finalItem->getNBytes() > 0) {
                         bool compressionFailed = false;
@@ -225,6 +225,19 @@ public:
     bool backfillReceived(std::unique_ptr<Item> itm,
                           backfill_source_t backfill_source);
 
+    /**
+     * As backfillReceived(std::unique_ptr<Item>), but the caller may keep a
+     * reference to the item, so that an item which isn't accepted (false
+     * returned as the backfill buffer is full) can be retried later without
+     * reading it again.
+     */
+    bool backfillReceived(queued_item qi, backfill_source_t backfill_source);
+
+    /// @return the producer of this stream (which may no longer exist)
+    std::weak_ptr<DcpProducer> getProducer() const {
+        return producerPtr;
+    }
+
     /**
      * @param runtime The total runtime the backfill took, measured as active
      * time executing (i.e. total BackfillManagerTask::run() durations for
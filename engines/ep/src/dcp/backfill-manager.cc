@@ -115,6 +115,7 @@ BackfillManager::BackfillManager(KVBucket& kvBucket,
     scanBuffer.maxItems = scanItemLimit;
 
     buffer.bytesRead = 0;
+    buffer.bytesPrefetched = 0;
     buffer.maxBytes = backfillByteLimit;
     buffer.nextReadSize = 0;
     buffer.full = false;
@@ -137,6 +138,10 @@ void BackfillManager::addStats(DcpProducer& conn,
                                const CookieIface* c) {
     std::lock_guard<std::mutex> lh(lock);
     conn.addStat("backfill_buffer_bytes_read", buffer.bytesRead, add_stat, c);
+    conn.addStat("backfill_buffer_bytes_prefetched",
+                 buffer.bytesPrefetched,
+                 add_stat,
+                 c);
     conn.addStat(
             "backfill_buffer_next_read_size", buffer.nextReadSize, add_stat, c);
     conn.addStat("backfill_buffer_max_bytes", buffer.maxBytes, add_stat, c);
@@ -247,6 +252,42 @@ bool BackfillManager::bytesCheckAndRead(size_t bytes) {
     return true;
 }
 
+bool BackfillManager::bytesCheckAndPrefetch(size_t bytes) {
+    std::lock_guard<std::mutex> lh(lock);
+
+    // As bytesCheckAndRead, a read into an empty buffer is always allowed.
+    // Prefetched items aren't charged to the scan buffer, as they aren't
+    // read by scan() - their stream charges them when it takes them.
+    const auto used = buffer.bytesRead + buffer.bytesPrefetched;
+    if (used != 0 && used + bytes > buffer.maxBytes) {
+        if (buffer.bytesPrefetched == 0) {
+            // Only sent bytes can free the buffer; flag it full so bytesSent
+            // wakes us. (Prefetched bytes are freed by the streams taking
+            // them, which flagging it full would stop.)
+            buffer.full = true;
+            buffer.nextReadSize = bytes;
+        }
+        return false;
+    }
+
+    buffer.bytesPrefetched += bytes;
+    return true;
+}
+
+void BackfillManager::bytesPrefetchReleased(size_t bytes) {
+    std::lock_guard<std::mutex> lh(lock);
+    if (bytes > buffer.bytesPrefetched) {
+        throw std::invalid_argument(
+                "BackfillManager::bytesPrefetchReleased: bytes "
+                "(which is " +
+                std::to_string(bytes) +
+                ") is greater than "
+                "buffer.bytesPrefetched (which is " +
+                std::to_string(buffer.bytesPrefetched) + ")");
+    }
+    buffer.bytesPrefetched -= bytes;
+}
+
 void BackfillManager::bytesSent(size_t bytes) {
     std::lock_guard<std::mutex> lh(lock);
     if (bytes > buffer.bytesRead) {
@@ -313,7 +354,6 @@ backfill_status_t BackfillManager::backfill() {
         for (auto a_itr = activeBackfills.begin();
              a_itr != activeBackfills.end();) {
             if ((*a_itr)->isStreamDead()) {
-                (*a_itr)->cancel();
                 toDelete.push_back(std::move(*a_itr));
                 a_itr = activeBackfills.erase(a_itr);
                 backfillTracker.decrNumRunningBackfills();
@@ -322,11 +362,14 @@ backfill_status_t BackfillManager::backfill() {
             }
         }
 
+        // Cancel without the lock, as cancelling a prefetching backfill
+        // releases its bytes from the buffer
         lh.unlock();
         bool reschedule = !toDelete.empty();
         while (!toDelete.empty()) {
             UniqueDCPBackfillPtr backfill = std::move(toDelete.front());
             toDelete.pop_front();
+            backfill->cancel();
         }
         return reschedule ? backfill_success : backfill_snooze;
     }
@@ -340,6 +383,7 @@ backfill_status_t BackfillManager::backfill() {
         return backfill_snooze;
     }
 
+    taskWoken = false;
     lh.unlock();
     backfill_status_t status = backfill->run();
     lh.lock();
@@ -347,6 +391,8 @@ backfill_status_t BackfillManager::backfill() {
     scanBuffer.bytesRead = 0;
     scanBuffer.itemsRead = 0;
 
+    waitingInARow = (status == backfill_waiting) ? waitingInARow + 1 : 0;
+
     switch (status) {
         case backfill_success:
             switch (scheduleOrder) {
@@ -382,6 +428,17 @@ backfill_status_t BackfillManager::backfill() {
                                            std::move(backfill));
             break;
         }
+        case backfill_waiting:
+            // Keep it active, but once every active backfill is waiting
+            // snooze until one is notified its data is ready (wakeUpTask),
+            // unless that has happened since the backfill was run.
+            activeBackfills.push_back(std::move(backfill));
+            if (waitingInARow >= activeBackfills.size() &&
+                initializingBackfills.empty() && !taskWoken && managerTask) {
+                waitingInARow = 0;
+                managerTask->snooze(sleepTime);
+            }
+            break;
     }
 
     return backfill_success;
@@ -430,6 +487,7 @@ BackfillManager::dequeueNextBackfill(std::unique_lock<std::mutex>&) {
 
 void BackfillManager::wakeUpTask() {
     std::lock_guard<std::mutex> lh(lock);
+    taskWoken = true;
     if (managerTask) {
         ExecutorPool::get()->wake(managerTask->getId());
     }
@@ -34,6 +34,8 @@
  * - dcp_scan_byte_limit
  * - dcp_scan_item_limit
  * - dcp_backfill_byte_limit
+ * - dcp_backfill_prefetch_bytes (items read ahead of the streams are charged
+ *   to the same buffer)
  *
  * Implementation
  * --------------
@@ -56,7 +58,9 @@
  * - active - Backfills which are actively being run. These backfills are run
  *            in queue order as long as no backfills exist in
  *            initializingBackfills. The order these are executed in depends on
- *            scheduleOrder.
+ *            scheduleOrder. Backfills waiting for data (backfill_waiting)
+ *            stay here; once all of them are waiting the BackfillManagerTask
+ *            snoozes until woken.
  * - snoozing - Backfills which are not ready to run at present. They will be
  *              periodically be re-considered for running (and moving to
  *              activeBackfills)
@@ -206,6 +210,26 @@ public:
      */
     bool bytesCheckAndRead(size_t bytes);
 
+    /**
+     * Checks if an item read ahead of its stream (by a BackfillPrefetcher)
+     * can fit into the backfill buffer, alongside the bytes read and the
+     * bytes already prefetched, and reserves the space if so. The item is
+     * charged via bytesCheckAndRead as usual once the stream takes it, after
+     * which the reservation is released (bytesPrefetchReleased).
+     *
+     * @param bytes read size
+     *
+     * @return true if the space was reserved
+     *         false if the buffer is full (prefetching must pause)
+     */
+    bool bytesCheckAndPrefetch(size_t bytes);
+
+    /**
+     * Release space reserved by bytesCheckAndPrefetch, once the item has been
+     * taken by the stream (or discarded).
+     */
+    void bytesPrefetchReleased(size_t bytes);
+
     /**
      * Notify the BackfillManager that the given number of bytes have been
      * sent (consumed) by the DcpProducer to the client. Reduces the amount
@@ -230,6 +254,16 @@ public:
                snoozingBackfills.size() + pendingBackfills.size();
     }
 
+    /**
+     * Get the bytes reserved in the backfill buffer by prefetchers.
+     *
+     * Only used within tests.
+     */
+    size_t getBytesPrefetched() const {
+        std::lock_guard<std::mutex> lh(lock);
+        return buffer.bytesPrefetched;
+    }
+
     std::string to_string(ScheduleOrder order);
 
     /// The name of the BackfillManager, used for logging etc
@@ -239,6 +273,8 @@ protected:
     //! The buffer is the total bytes used by all backfills for this connection
     struct {
         size_t bytesRead;
+        /// Bytes reserved for items read ahead of their streams
+        size_t bytesPrefetched;
         size_t maxBytes;
         size_t nextReadSize;
         bool full;
@@ -282,7 +318,7 @@ private:
     std::pair<UniqueDCPBackfillPtr, Source> dequeueNextBackfill(
             std::unique_lock<std::mutex>&);
 
-    std::mutex lock;
+    mutable std::mutex lock;
 
     // List of backfills which have just been scheduled (added to Backfill
     // Manager) and not yet been run.
@@ -316,4 +352,11 @@ private:
     BackfillTrackingIface& backfillTracker;
     ExTask managerTask;
     ScheduleOrder scheduleOrder{ScheduleOrder::RoundRobin};
+
+    // The number of backfills run in a row which were waiting for data
+    // (backfill_waiting). Once every active backfill is waiting the
+    // managerTask snoozes until woken.
+    size_t waitingInARow{0};
+    // Set by wakeUpTask; cleared before running a backfill
+    bool taskWoken{false};
 };
@@ -25,7 +25,13 @@ class ScanContext;
 enum backfill_status_t {
     backfill_success,
     backfill_finished,
-    backfill_snooze
+    backfill_snooze,
+    /**
+     * The backfill is waiting for data which isn't ready yet (e.g. being read
+     * by a BackfillPrefetcher); it stays active, and the BackfillManager is
+     * woken (via DcpProducer::notifyBackfillManager) once the data is ready
+     */
+    backfill_waiting
 };
 
 /**
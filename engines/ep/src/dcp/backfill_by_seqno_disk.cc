@@ -14,6 +14,8 @@
 #include "collections/vbucket_manifest.h"
 #include "collections/vbucket_manifest_handles.h"
 #include "dcp/active_stream_impl.h"
+#include "dcp/backfill_prefetcher.h"
+#include "ep_engine.h"
 #include "kv_bucket.h"
 #include "kvstore/kvstore.h"
 #include "vbucket_state.h"
@@ -32,6 +34,13 @@ DCPBackfillBySeqnoDisk::DCPBackfillBySeqnoDisk(KVBucket& bucket,
       DCPBackfillBySeqno(startSeqno, endSeqno) {
 }
 
+DCPBackfillBySeqnoDisk::~DCPBackfillBySeqnoDisk() {
+    // The prefetch task mustn't use the scan context once it's destroyed
+    if (prefetcher) {
+        prefetcher->stop();
+    }
+}
+
 backfill_status_t DCPBackfillBySeqnoDisk::create() {
     auto stream = streamPtr.lock();
     if (!stream) {
@@ -62,9 +71,17 @@ backfill_status_t DCPBackfillBySeqnoDisk::create() {
 
     auto valFilter = stream->getValueFilter();
 
+    const auto& config = bucket.getEPEngine().getConfiguration();
+    const auto prefetchBytes = std::min(config.getDcpBackfillPrefetchBytes(),
+                                        config.getDcpBackfillByteLimit());
+    if (prefetchBytes) {
+        prefetcher = std::make_shared<BackfillPrefetcher>(
+                bucket.getEPEngine(), stream->getProducer(), prefetchBytes);
+    }
+
     auto scanCtx = kvstore->initBySeqnoScanContext(
-            std::make_unique<DiskCallback>(stream),
-            std::make_unique<CacheCallback>(bucket, stream),
+            std::make_unique<DiskCallback>(stream, prefetcher),
+            std::make_unique<CacheCallback>(bucket, stream, prefetcher),
             getVBucketId(),
             startSeqno,
             DocumentFilter::ALL_ITEMS,
@@ -150,6 +167,11 @@ backfill_status_t DCPBackfillBySeqnoDisk::create() {
 
     this->scanCtx = std::move(scanCtx);
 
+    if (prefetcher && state == backfill_state_scanning) {
+        prefetcher->start(*kvstore,
+                          dynamic_cast<BySeqnoScanContext&>(*this->scanCtx));
+    }
+
     return backfill_success;
 }
 
@@ -169,7 +191,19 @@ backfill_status_t DCPBackfillBySeqnoDisk::scan() {
     Expects(kvstore);
 
     auto& bySeqnoCtx = dynamic_cast<BySeqnoScanContext&>(*scanCtx);
-    switch (kvstore->scan(bySeqnoCtx)) {
+    scan_error_t status;
+    if (prefetcher) {
+        const auto drained = prefetcher->drain(*stream);
+        if (!drained) {
+            // The next items are still being read; the prefetcher wakes the
+            // BackfillManager once they are ready
+            return backfill_waiting;
+        }
+        status = *drained;
+    } else {
+        status = kvstore->scan(bySeqnoCtx);
+    }
+    switch (status) {
     case scan_success:
         stream->setBackfillScanLastRead(scanCtx->lastReadSeqno);
         transitionState(backfill_state_completing);
@@ -189,6 +223,9 @@ backfill_status_t DCPBackfillBySeqnoDisk::scan() {
                     bySeqnoCtx.startSeqno,
                     bySeqnoCtx.maxSeqno,
                     bySeqnoCtx.lastReadSeqno);
+        if (prefetcher) {
+            prefetcher->stop();
+        }
         scanCtx.reset();
         stream->setDead(cb::mcbp::DcpStreamEndStatus::BackfillFail);
         return backfill_finished;
@@ -197,6 +234,10 @@ backfill_status_t DCPBackfillBySeqnoDisk::scan() {
 }
 
 void DCPBackfillBySeqnoDisk::complete(bool cancelled) {
+    if (prefetcher) {
+        prefetcher->stop();
+    }
+
     auto stream = streamPtr.lock();
     if (!stream) {
         EP_LOG_WARN(
@@ -18,6 +18,7 @@
 namespace Collections::VB {
 class Filter;
 }
+class BackfillPrefetcher;
 class BySeqnoScanContext;
 class KVBucket;
 class KVStoreIface;
@@ -37,6 +38,8 @@ public:
                            uint64_t startSeqno,
                            uint64_t endSeqno);
 
+    ~DCPBackfillBySeqnoDisk() override;
+
     // explicitly state how we want run to be called as it technically exists
     // from both parent classes
     backfill_status_t run() override {
@@ -103,4 +106,10 @@ private:
     bool markLegacyDiskSnapshot(ActiveStream& stream,
                                 BySeqnoScanContext& scanCtx,
                                 const KVStoreIface& kvs);
+
+    /**
+     * Reads ahead of the stream when dcp_backfill_prefetch_bytes is non-zero
+     * (the scan callbacks pass the items to it rather than the stream)
+     */
+    std::shared_ptr<BackfillPrefetcher> prefetcher;
 };
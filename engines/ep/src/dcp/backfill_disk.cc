@@ -12,12 +12,15 @@
 #include "dcp/backfill_disk.h"
 #include "active_stream.h"
 #include "collections/vbucket_manifest_handles.h"
+#include "dcp/backfill_prefetcher.h"
 #include "ep_engine.h"
 #include "kv_bucket.h"
 #include "kvstore/kvstore.h"
 
-CacheCallback::CacheCallback(KVBucket& bucket, std::shared_ptr<ActiveStream> s)
-    : bucket(bucket), streamPtr(s) {
+CacheCallback::CacheCallback(KVBucket& bucket,
+                             std::shared_ptr<ActiveStream> s,
+                             std::shared_ptr<BackfillPrefetcher> prefetcher)
+    : bucket(bucket), streamPtr(s), prefetcher(std::move(prefetcher)) {
     if (s == nullptr) {
         throw std::invalid_argument("CacheCallback(): stream is NULL");
     }
@@ -72,8 +75,14 @@ void CacheCallback::callback(CacheLookup& lookup) {
     auto gv = get(*vb, lookup, *stream_);
     if (gv.getStatus() == cb::engine_errc::success) {
         if (gv.item->getBySeqno() == lookup.getBySeqno()) {
-            if (stream_->backfillReceived(std::move(gv.item),
-                                          BACKFILL_FROM_MEMORY)) {
+            const bool received =
+                    prefetcher ? prefetcher->push(
+                                         queued_item(std::move(gv.item)),
+                                         BACKFILL_FROM_MEMORY)
+                               : stream_->backfillReceived(
+                                         std::move(gv.item),
+                                         BACKFILL_FROM_MEMORY);
+            if (received) {
                 setStatus(cb::engine_errc::key_already_exists);
                 return;
             }
@@ -84,7 +93,9 @@ void CacheCallback::callback(CacheLookup& lookup) {
     setStatus(cb::engine_errc::success);
 }
 
-DiskCallback::DiskCallback(std::shared_ptr<ActiveStream> s) : streamPtr(s) {
+DiskCallback::DiskCallback(std::shared_ptr<ActiveStream> s,
+                           std::shared_ptr<BackfillPrefetcher> prefetcher)
+    : streamPtr(s), prefetcher(std::move(prefetcher)) {
     if (s == nullptr) {
         throw std::invalid_argument("DiskCallback(): stream is NULL");
     }
@@ -105,7 +116,12 @@ void DiskCallback::callback(GetValue& val) {
     // evict this before any cached item if they get into memory pressure.
     val.item->setFreqCounterValue(0);
 
-    if (!stream_->backfillReceived(std::move(val.item), BACKFILL_FROM_DISK)) {
+    const bool received =
+            prefetcher ? prefetcher->push(queued_item(std::move(val.item)),
+                                          BACKFILL_FROM_DISK)
+                       : stream_->backfillReceived(std::move(val.item),
+                                                   BACKFILL_FROM_DISK);
+    if (!received) {
         setStatus(cb::engine_errc::no_memory); // Pause the backfill
     } else {
         setStatus(cb::engine_errc::success);
@@ -17,6 +17,7 @@
 #include <mutex>
 
 class ActiveStream;
+class BackfillPrefetcher;
 class KVBucket;
 class VBucket;
 enum class ValueFilter;
@@ -29,10 +30,15 @@ enum backfill_state_t {
     backfill_state_done
 };
 
-/* Callback to get the items that are found to be in the cache */
+/*
+ * Callback to get the items that are found to be in the cache. The items are
+ * passed to the stream, or to the prefetcher if one is given.
+ */
 class CacheCallback : public StatusCallback<CacheLookup> {
 public:
-    CacheCallback(KVBucket& bucket, std::shared_ptr<ActiveStream> s);
+    CacheCallback(KVBucket& bucket,
+                  std::shared_ptr<ActiveStream> s,
+                  std::shared_ptr<BackfillPrefetcher> prefetcher = {});
 
     void callback(CacheLookup& lookup) override;
 
@@ -46,17 +52,23 @@ private:
 
     KVBucket& bucket;
     std::weak_ptr<ActiveStream> streamPtr;
+    std::shared_ptr<BackfillPrefetcher> prefetcher;
 };
 
-/* Callback to get the items that are found to be in the disk */
+/*
+ * Callback to get the items that are found to be in the disk. The items are
+ * passed to the stream, or to the prefetcher if one is given.
+ */
 class DiskCallback : public StatusCallback<GetValue> {
 public:
-    explicit DiskCallback(std::shared_ptr<ActiveStream> s);
+    explicit DiskCallback(std::shared_ptr<ActiveStream> s,
+                          std::shared_ptr<BackfillPrefetcher> prefetcher = {});
 
     void callback(GetValue& val) override;
 
 private:
     std::weak_ptr<ActiveStream> streamPtr;
+    std::shared_ptr<BackfillPrefetcher> prefetcher;
 };
 
 class DCPBackfillDisk : public virtual DCPBackfill {
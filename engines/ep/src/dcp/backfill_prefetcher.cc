@@ -0,0 +1,295 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "dcp/backfill_prefetcher.h"
+
+#include "dcp/active_stream.h"
+#include "dcp/producer.h"
+#include "ep_engine.h"
+#include "item.h"
+#include "kvstore/kvstore.h"
+
+#include <executor/executorpool.h>
+#include <executor/globaltask.h>
+#include <phosphor/phosphor.h>
+
+#include <climits>
+#include <utility>
+
+/**
+ * The I/O stage of a BackfillPrefetcher; runs prefetch passes while the
+ * window has space, and snoozes until woken once it's full.
+ */
+class BackfillPrefetchTask : public GlobalTask {
+public:
+    BackfillPrefetchTask(EventuallyPersistentEngine& e,
+                         std::weak_ptr<BackfillPrefetcher> prefetcher)
+        : GlobalTask(&e, TaskId::BackfillPrefetchTask, 0, false),
+          prefetcher(std::move(prefetcher)) {
+    }
+
+    bool run() override {
+        TRACE_EVENT0("ep-engine/task", "BackfillPrefetchTask");
+        auto locked = prefetcher.lock();
+        if (!locked) {
+            return false;
+        }
+        return locked->prefetch();
+    }
+
+    std::string getDescription() const override {
+        return "Prefetching backfill items";
+    }
+
+    std::chrono::microseconds maxExpectedDuration() const override {
+        // A pass reads at most a window of items, like a backfill scan()
+        // reads at most dcp_scan_byte_limit
+        return std::chrono::milliseconds(300);
+    }
+
+    /**
+     * Set when the task has been woken (and cleared when it runs), to avoid
+     * waking it repeatedly and a lost wakeup (see BgFetcher::run)
+     */
+    std::atomic<bool> pendingWake{false};
+
+private:
+    std::weak_ptr<BackfillPrefetcher> prefetcher;
+};
+
+BackfillPrefetcher::BackfillPrefetcher(EventuallyPersistentEngine& engine,
+                                       std::weak_ptr<DcpProducer> producer,
+                                       size_t maxBytes)
+    : engine(engine), producer(std::move(producer)), maxBytes(maxBytes) {
+}
+
+BackfillPrefetcher::~BackfillPrefetcher() {
+    stop();
+}
+
+void BackfillPrefetcher::start(const KVStoreIface& kvstore,
+                               BySeqnoScanContext& scanCtx) {
+    {
+        std::lock_guard<std::mutex> guard(scanMutex);
+        this->kvstore = &kvstore;
+        this->scanCtx = &scanCtx;
+    }
+    task = std::make_shared<BackfillPrefetchTask>(engine, weak_from_this());
+    ExecutorPool::get()->schedule(task);
+}
+
+void BackfillPrefetcher::stop() {
+    {
+        // Waits for a pass in progress, so the scan context isn't used
+        // after this
+        std::lock_guard<std::mutex> guard(scanMutex);
+        stopped = true;
+        scanCtx = nullptr;
+        kvstore = nullptr;
+    }
+    if (task) {
+        ExecutorPool::get()->cancel(task->getId());
+    }
+    size_t bytes;
+    {
+        std::lock_guard<std::mutex> guard(windowMutex);
+        bytes = window.bytes;
+        window.items.clear();
+        window.bytes = 0;
+    }
+    if (bytes) {
+        releaseBytes(bytes);
+    }
+}
+
+bool BackfillPrefetcher::push(queued_item item, backfill_source_t source) {
+    const auto size = item->size();
+    {
+        std::lock_guard<std::mutex> guard(windowMutex);
+        if (!window.items.empty() && window.bytes + size > maxBytes) {
+            return false;
+        }
+    }
+
+    // The item must also fit in the backfill buffer, which it's charged to
+    // until the stream takes it. (Only the scan pushes, so the window can't
+    // have filled up meanwhile.)
+    auto producerLocked = producer.lock();
+    if (!producerLocked ||
+        !producerLocked->recordBackfillManagerBytesPrefetched(size)) {
+        return false;
+    }
+
+    bool notify;
+    {
+        std::lock_guard<std::mutex> guard(windowMutex);
+        window.bytes += size;
+        window.items.push_back({std::move(item), source, size});
+        notify = std::exchange(window.drainWaiting, false);
+    }
+    if (notify) {
+        producerLocked->notifyBackfillManager();
+    }
+    return true;
+}
+
+std::optional<scan_error_t> BackfillPrefetcher::drain(ActiveStream& stream) {
+    while (true) {
+        // Hand over the items already read
+        while (true) {
+            Window::Entry entry{};
+            {
+                std::lock_guard<std::mutex> guard(windowMutex);
+                if (window.items.empty()) {
+                    break;
+                }
+                entry = window.items.front();
+            }
+
+            if (!stream.backfillReceived(entry.item, entry.source)) {
+                // Paused; the item is handed over again by the next drain
+                maybeWakeTask();
+                return scan_again;
+            }
+
+            {
+                std::lock_guard<std::mutex> guard(windowMutex);
+                window.items.pop_front();
+                window.bytes -= entry.size;
+            }
+            // The stream has charged the item to the backfill buffer
+            releaseBytes(entry.size);
+            maybeWakeTask();
+        }
+
+        // The window is empty. If the task is running a pass, yield rather
+        // than block this thread until the pass pushes an item
+        std::unique_lock<std::mutex> scanLock(scanMutex, std::try_to_lock);
+        if (!scanLock.owns_lock()) {
+            std::unique_lock<std::mutex> windowLock(windowMutex);
+            if (!window.items.empty()) {
+                continue;
+            }
+            if (window.prefetching) {
+                // The pass wakes the BackfillManager once it pushes an item
+                // or ends (which clear the flag under windowMutex, so the
+                // wake can't be missed)
+                window.drainWaiting = true;
+                return std::nullopt;
+            }
+            // The pass has ended (or scanMutex is held by stop())
+            windowLock.unlock();
+            scanLock.lock();
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(windowMutex);
+            if (!window.items.empty()) {
+                continue;
+            }
+        }
+        if (scanResult) {
+            return *scanResult;
+        }
+        if (stopped) {
+            return scan_failed;
+        }
+        runScanLocked();
+
+        std::lock_guard<std::mutex> guard(windowMutex);
+        if (window.items.empty() && !scanResult) {
+            // Nothing fitted in the backfill buffer; it's either flagged
+            // full (and resumes us once bytes are sent) or held by other
+            // windows, which their backfills hand over
+            return scan_again;
+        }
+    }
+}
+
+bool BackfillPrefetcher::prefetch() {
+    auto& prefetchTask = static_cast<BackfillPrefetchTask&>(*task);
+    // Snooze before clearing pendingWake so a wake during the pass isn't
+    // lost
+    prefetchTask.snooze(INT_MAX);
+    prefetchTask.pendingWake.store(false);
+
+    // Flag the pass before taking scanMutex, so a drain which finds it
+    // locked yields for the items rather than running a pass itself
+    {
+        std::lock_guard<std::mutex> guard(windowMutex);
+        window.prefetching = true;
+    }
+
+    bool runAgain = false;
+    {
+        std::lock_guard<std::mutex> guard(scanMutex);
+        if (!stopped && !scanResult) {
+            runScanLocked();
+            runAgain = !scanResult;
+        }
+    }
+
+    bool notify;
+    {
+        std::lock_guard<std::mutex> guard(windowMutex);
+        window.prefetching = false;
+        notify = std::exchange(window.drainWaiting, false);
+    }
+    if (notify) {
+        notifyBackfillManager();
+    }
+    return runAgain;
+}
+
+void BackfillPrefetcher::runScanLocked() {
+    switch (kvstore->scan(*scanCtx)) {
+    case scan_success:
+        scanResult = scan_success;
+        break;
+    case scan_again:
+        // The window is full
+        break;
+    case scan_failed:
+        scanResult = scan_failed;
+        break;
+    }
+}
+
+void BackfillPrefetcher::maybeWakeTask() {
+    if (!task) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> guard(windowMutex);
+        if (window.bytes >= maxBytes / 2) {
+            return;
+        }
+    }
+    auto& prefetchTask = static_cast<BackfillPrefetchTask&>(*task);
+    bool expected = false;
+    if (prefetchTask.pendingWake.compare_exchange_strong(expected, true)) {
+        ExecutorPool::get()->wake(task->getId());
+    }
+}
+
+void BackfillPrefetcher::releaseBytes(size_t bytes) {
+    auto producerLocked = producer.lock();
+    if (producerLocked) {
+        producerLocked->recordBackfillManagerPrefetchReleased(bytes);
+    }
+}
+
+void BackfillPrefetcher::notifyBackfillManager() {
+    auto producerLocked = producer.lock();
+    if (producerLocked) {
+        producerLocked->notifyBackfillManager();
+    }
+}
@@ -0,0 +1,162 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+#include "dcp/stream.h"
+#include "ep_types.h"
+#include "kvstore/kvstore_iface.h"
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+class ActiveStream;
+class BySeqnoScanContext;
+class DcpProducer;
+class EventuallyPersistentEngine;
+class GlobalTask;
+
+/**
+ * BackfillPrefetcher splits a by-seqno disk backfill into two stages: an I/O
+ * stage (the BackfillPrefetchTask, on an AuxIO thread) which runs the KVStore
+ * scan and reads a bounded window of items ahead, and the stream stage
+ * (DCPBackfillBySeqnoDisk::scan, run by the BackfillManagerTask) which hands
+ * the items already read to the stream to be turned into DcpResponses. The
+ * two stages overlap, so the backfill isn't bound by the latency of reading
+ * one document at a time.
+ *
+ * The scan callbacks push the items into the window (in seqno order) and
+ * pause the scan once the window is full. The items in the window are
+ * charged to the producer's BackfillManager buffer (bytesCheckAndPrefetch),
+ * so the read-ahead of all the producer's backfills is bounded by
+ * dcp_backfill_byte_limit, and the scan also pauses once that is exhausted.
+ * The stream stage drains the window through ActiveStream::backfillReceived,
+ * so the items are then accounted against (and paused by) the backfill and
+ * scan buffers as usual; an item the stream doesn't accept stays at the
+ * front of the window.
+ *
+ * The scan context is only used with scanMutex held; the window has its own
+ * lock, so the stream stage takes the items as the task reads them. If the
+ * stream stage empties the window while a prefetch pass is in progress it
+ * yields (the backfill is waiting) and the pass wakes the BackfillManager
+ * once it pushes an item (or ends); otherwise it runs a pass itself, so it
+ * never waits for the task to be scheduled.
+ */
+class BackfillPrefetcher
+    : public std::enable_shared_from_this<BackfillPrefetcher> {
+public:
+    /**
+     * @param engine The engine to run the prefetch task for
+     * @param producer The producer whose BackfillManager buffer the window
+     *        is charged to (and which is woken when items are ready)
+     * @param maxBytes The size of the window; a single item is always
+     *        accepted into an empty window
+     */
+    BackfillPrefetcher(EventuallyPersistentEngine& engine,
+                       std::weak_ptr<DcpProducer> producer,
+                       size_t maxBytes);
+
+    ~BackfillPrefetcher();
+
+    /**
+     * Start prefetching from the scan (whose callbacks push into this
+     * prefetcher). The scan context must remain valid until stop().
+     */
+    void start(const KVStoreIface& kvstore, BySeqnoScanContext& scanCtx);
+
+    /**
+     * Stop prefetching and cancel the prefetch task. The scan context isn't
+     * used after this returns.
+     */
+    void stop();
+
+    /**
+     * Add an item read by the scan to the window.
+     *
+     * @return false if the window (or the backfill buffer) is full; the
+     *         scan must pause (and read the item again when resumed)
+     */
+    bool push(queued_item item, backfill_source_t source);
+
+    /**
+     * Hand the items in the window to the stream, until the stream pauses
+     * the backfill or the scan is complete.
+     *
+     * @return scan_again if the stream (or the backfill buffer) paused the
+     *         backfill, std::nullopt if the window is empty while a prefetch
+     *         pass is in progress (the backfill should wait; the
+     *         BackfillManager is woken once the pass pushes an item or ends),
+     *         else the result of the scan (scan_success or scan_failed) once
+     *         every item was handed to the stream
+     */
+    std::optional<scan_error_t> drain(ActiveStream& stream);
+
+    /**
+     * Run a prefetch pass (called by the prefetch task).
+     *
+     * @return true if the task should run again (it snoozes until woken by
+     *         drain), false if the scan is complete or stopped
+     */
+    bool prefetch();
+
+    /// @return the bytes in the window
+    size_t getBytes() const {
+        std::lock_guard<std::mutex> guard(windowMutex);
+        return window.bytes;
+    }
+
+protected:
+    /// Run the scan until the window is full or the scan completes.
+    void runScanLocked();
+
+    /// Wake the prefetch task if the window drained below half
+    void maybeWakeTask();
+
+    /// Release bytes taken out of the window from the backfill buffer
+    void releaseBytes(size_t bytes);
+
+    /// Wake the BackfillManager (a drain is waiting for items)
+    void notifyBackfillManager();
+
+    EventuallyPersistentEngine& engine;
+    const std::weak_ptr<DcpProducer> producer;
+    const size_t maxBytes;
+
+    struct Window {
+        struct Entry {
+            queued_item item;
+            backfill_source_t source;
+            size_t size;
+        };
+        std::deque<Entry> items;
+        size_t bytes{0};
+        /// Set while the task runs a prefetch pass (or waits to)
+        bool prefetching{false};
+        /// Set when a drain yielded waiting for the pass to push an item
+        bool drainWaiting{false};
+    };
+    /// Protects the window
+    mutable std::mutex windowMutex;
+    Window window;
+
+    /// Protects the members below, and the use of the scan context
+    std::mutex scanMutex;
+    const KVStoreIface* kvstore{nullptr};
+    BySeqnoScanContext* scanCtx{nullptr};
+    /// The result of the scan once it has completed (or failed)
+    std::optional<scan_error_t> scanResult;
+    bool stopped{false};
+
+    /// The prefetch task; set by start() and not changed after
+    std::shared_ptr<GlobalTask> task;
+};
@@ -1686,6 +1686,26 @@ void DcpConsumer::setFlowControlBufSize(uint32_t newSize)
     flowControl.setFlowControlBufSize(newSize);
 }
 
+uint64_t DcpConsumer::getFlowControlProcessedBytes() const {
+    return flowControl.getAckedBytes() + flowControl.getFreedBytes();
+}
+
+size_t DcpConsumer::getBufferedBytes() {
+    // As addStats, copy the streams so the map isn't locked while the
+    // buffer of each stream is locked.
+    std::vector<PassiveStreamMap::mapped_type> valid_streams;
+    streams.for_each(
+            [&valid_streams](const PassiveStreamMap::value_type& element) {
+                valid_streams.push_back(element.second);
+            });
+
+    size_t bytes = 0;
+    for (const auto& stream : valid_streams) {
+        bytes += stream->getBufferBytes();
+    }
+    return bytes;
+}
+
 const std::string& DcpConsumer::getControlMsgKey()
 {
     return connBufferCtrlMsg;
@@ -274,6 +274,15 @@ public:
 
     void setFlowControlBufSize(uint32_t newSize);
 
+    /**
+     * @return the total bytes processed from the flow control buffer (acked
+     *         and not yet acked) since the connection was created
+     */
+    uint64_t getFlowControlProcessedBytes() const;
+
+    /// @return the bytes buffered by the streams, waiting to be processed
+    size_t getBufferedBytes();
+
     static const std::string& getControlMsgKey();
 
     bool isStreamPresent(Vbid vbucket);
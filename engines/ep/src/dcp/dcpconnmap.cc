@@ -43,7 +43,11 @@ private:
 
 DcpConnMap::DcpConnMap(EventuallyPersistentEngine &e)
     : ConnMap(e),
-      aggrDcpConsumerBufferSize(0) {
+      aggrDcpConsumerBufferSize(0),
+      valueConversionCache(
+              e.getConfiguration().getDcpValueConversionCacheSlots(),
+              e.getConfiguration().getDcpValueConversionCacheMaxValueSize(),
+              e.getConfiguration().getDcpValueConversionCacheMaxBytes()) {
     backfills.running = 0;
     updateMaxRunningBackfills(engine.getEpStats().getMaxDataSize());
     minCompressionRatioForProducer.store(
@@ -485,6 +489,18 @@ void DcpConnMap::addStats(const AddStatFn& add_stat, const CookieIface* c) {
     std::lock_guard<std::mutex> lh(connsLock);
     add_casted_stat("ep_dcp_dead_conn_count", deadConnections.size(), add_stat,
                     c);
+    add_casted_stat("ep_dcp_value_conversion_cache_hits",
+                    valueConversionCache.getHits(),
+                    add_stat,
+                    c);
+    add_casted_stat("ep_dcp_value_conversion_cache_misses",
+                    valueConversionCache.getMisses(),
+                    add_stat,
+                    c);
+    add_casted_stat("ep_dcp_value_conversion_cache_bytes",
+                    valueConversionCache.getBytes(),
+                    add_stat,
+                    c);
 }
 
 void DcpConnMap::updateMinCompressionRatioForProducers(float value) {
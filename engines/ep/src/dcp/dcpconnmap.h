@@ -14,6 +14,7 @@
 #include "backfill.h"
 #include "conn_store_fwd.h"
 #include "connmap.h"
+#include "dcp/value_conversion_cache.h"
 #include "ep_types.h"
 
 #include <memcached/engine.h>
@@ -146,6 +147,11 @@ public:
 
     float getMinCompressionRatio();
 
+    /// @return the cache of converted values shared by the ActiveStreams
+    DcpValueConversionCache& getValueConversionCache() {
+        return valueConversionCache;
+    }
+
     std::shared_ptr<ConnHandler> findByName(const std::string& name);
 
     bool isConnections() override;
@@ -240,5 +246,7 @@ protected:
     /* Total memory used by all DCP consumer buffers */
     std::atomic<size_t> aggrDcpConsumerBufferSize;
 
+    DcpValueConversionCache valueConversionCache;
+
     class DcpConfigChangeListener;
 };
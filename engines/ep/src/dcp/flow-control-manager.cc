@@ -28,6 +28,9 @@ size_t DcpFlowControlManager::newConsumerConn(DcpConsumer *) {
 
 void DcpFlowControlManager::handleDisconnect(DcpConsumer *) {}
 
+void DcpFlowControlManager::maybeResizeBuffers() {
+}
+
 bool DcpFlowControlManager::isEnabled() const
 {
     return false;
@@ -217,3 +220,209 @@ void DcpFlowControlManagerAggressive::resizeBuffers_UNLOCKED(size_t bufferSize)
         iter.second->setFlowControlBufSize(bufferSize);
     }
 }
+
+DcpFlowControlManagerAdaptive::DcpFlowControlManagerAdaptive(
+        EventuallyPersistentEngine& engine)
+    : DcpFlowControlManager(engine),
+      pidReset([this](PIDControllerImpl& pid) {
+          const auto& conf = engine_.getConfiguration();
+          // Read and compare the PID against the engine config
+          auto sp = conf.getDcpFlowControlAdaptiveBacklogTarget();
+          auto p = conf.getDcpFlowControlAdaptivePidP();
+          auto i = conf.getDcpFlowControlAdaptivePidI();
+          auto d = conf.getDcpFlowControlAdaptivePidD();
+          auto dt = std::chrono::milliseconds{
+                  conf.getDcpFlowControlAdaptivePidDt()};
+          if (sp != pid.getSetPoint() || p != pid.getKp() || i != pid.getKi() ||
+              d != pid.getKd() || dt != pid.getDt()) {
+              pid.reset(sp, p, i, d, dt);
+              return true;
+          }
+          return false;
+      }),
+      nextResize(0) {
+}
+
+DcpFlowControlManagerAdaptive::~DcpFlowControlManagerAdaptive() = default;
+
+size_t DcpFlowControlManagerAdaptive::newConsumerConn(
+        DcpConsumer* consumerConn) {
+    std::lock_guard<std::mutex> lh(dcpConsumersMapMutex);
+
+    if (consumerConn == nullptr) {
+        throw std::invalid_argument(
+                "DcpFlowControlManagerAdaptive::newConsumerConn: resp is NULL");
+    }
+
+    /* Start with the aggressive policy's share; the size then follows the
+       consumer's drain rate */
+    const auto& config = engine_.getConfiguration();
+    const double aggrFrac =
+            static_cast<double>(config.getDcpConnBufferSizeAggressivePerc()) /
+            100;
+    const auto totalConns = dcpConsumersMap.size() + 1;
+    size_t bufferSize =
+            (aggrFrac * engine_.getEpStats().getMaxDataSize()) / totalConns;
+    setBufSizeWithinBounds(consumerConn, bufferSize);
+
+    /* The other buffers may have grown into the aggregate limit; the new
+       buffer only gets what's left of it */
+    size_t aggrBufferSize = 0;
+    for (const auto& entry : dcpConsumersMap) {
+        aggrBufferSize += entry.second.conn.getFlowControlBufSize();
+    }
+    const auto limit = getAggrBufferSizeLimit();
+    const size_t headroom = limit > aggrBufferSize ? limit - aggrBufferSize : 0;
+    if (bufferSize > headroom) {
+        bufferSize = std::max(headroom, config.getDcpConnBufferSize());
+        if (bufferSize > headroom) {
+            /* Not even room for the minimum; as the aggressive policy, shrink
+               the other buffers to their share of the limit (they regrow
+               within it if they keep draining) */
+            size_t share = limit / totalConns;
+            setBufSizeWithinBounds(consumerConn, share);
+            for (auto& entry : dcpConsumersMap) {
+                auto& conn = entry.second.conn;
+                if (conn.getFlowControlBufSize() > share) {
+                    EP_LOG_DEBUG(
+                            "{} Conn flow control buffer resized from {} to "
+                            "{} for a new connection",
+                            conn.logHeader(),
+                            conn.getFlowControlBufSize(),
+                            share);
+                    conn.setFlowControlBufSize(share);
+                }
+            }
+        }
+    }
+    EP_LOG_DEBUG("{} Conn flow control buffer is {}",
+                 consumerConn->logHeader(),
+                 bufferSize);
+
+    /* Add this connection to the list of connections; it's under construction
+       so has processed nothing yet */
+    const auto now = std::chrono::steady_clock::now();
+    dcpConsumersMap.erase(consumerConn->getCookie());
+    dcpConsumersMap.emplace(consumerConn->getCookie(),
+                            Consumer(*consumerConn, makePID(now), 0));
+    return bufferSize;
+}
+
+void DcpFlowControlManagerAdaptive::handleDisconnect(
+        DcpConsumer* consumerConn) {
+    std::lock_guard<std::mutex> lh(dcpConsumersMapMutex);
+    dcpConsumersMap.erase(consumerConn->getCookie());
+}
+
+void DcpFlowControlManagerAdaptive::maybeResizeBuffers() {
+    maybeResizeBuffers(std::chrono::steady_clock::now());
+}
+
+bool DcpFlowControlManagerAdaptive::isEnabled() const {
+    return true;
+}
+
+void DcpFlowControlManagerAdaptive::maybeResizeBuffers(
+        std::chrono::steady_clock::time_point now) {
+    // Called on every consumer step, so only one caller per interval takes
+    // the lock
+    auto next = nextResize.load();
+    if (now.time_since_epoch().count() < next) {
+        return;
+    }
+    const auto dt = std::chrono::milliseconds{
+            engine_.getConfiguration().getDcpFlowControlAdaptivePidDt()};
+    if (!nextResize.compare_exchange_strong(
+                next, (now + dt).time_since_epoch().count())) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lh(dcpConsumersMapMutex);
+    size_t aggrBufferSize = 0;
+    for (auto& entry : dcpConsumersMap) {
+        aggrBufferSize += entry.second.conn.getFlowControlBufSize();
+    }
+    const auto limit = getAggrBufferSizeLimit();
+
+    for (auto& entry : dcpConsumersMap) {
+        auto& consumer = entry.second;
+        const size_t bufferSize = consumer.conn.getFlowControlBufSize();
+        if (bufferSize == 0) {
+            // Still being created (see newConsumerConn)
+            continue;
+        }
+        const size_t headroom =
+                limit > aggrBufferSize ? limit - aggrBufferSize : 0;
+        const auto newSize = computeBufferSize(consumer, now, headroom);
+
+        // Ignore small changes, each change is a control message to the
+        // producer
+        const size_t change = newSize > bufferSize ? newSize - bufferSize
+                                                   : bufferSize - newSize;
+        if (change <= bufferSize / 16) {
+            continue;
+        }
+        EP_LOG_DEBUG("{} Conn flow control buffer resized from {} to {}",
+                     consumer.conn.logHeader(),
+                     bufferSize,
+                     newSize);
+        consumer.conn.setFlowControlBufSize(newSize);
+        aggrBufferSize = aggrBufferSize - bufferSize + newSize;
+    }
+}
+
+size_t DcpFlowControlManagerAdaptive::computeBufferSize(
+        Consumer& consumer,
+        std::chrono::steady_clock::time_point now,
+        size_t headroom) {
+    const size_t bufferSize = consumer.conn.getFlowControlBufSize();
+    const auto processedBytes = consumer.conn.getFlowControlProcessedBytes();
+    const auto processed = processedBytes - consumer.processedBytes;
+    consumer.processedBytes = processedBytes;
+
+    // The fraction of the buffer stuck in the consumer's stream buffers
+    const auto backlog =
+            static_cast<float>(consumer.conn.getBufferedBytes()) / bufferSize;
+
+    // Positive when the backlog is below the target (grow), negative when
+    // above it (shrink)
+    const auto output = consumer.pid.step(backlog, now, pidReset);
+
+    double newSize = bufferSize;
+    if (output > 0) {
+        if (processed < bufferSize) {
+            // The buffer isn't limiting the throughput; no point growing it.
+            // Reset so the integral doesn't wind up while idle.
+            consumer.pid.reset();
+            return bufferSize;
+        }
+        newSize *= 1.0 + std::min(output, 1.0f);
+        newSize = std::min(newSize, 2.0 * processed);
+        newSize = std::min(newSize, static_cast<double>(bufferSize + headroom));
+    } else {
+        newSize *= 1.0 + std::max(output, -0.5f);
+    }
+
+    auto result = static_cast<size_t>(newSize);
+    setBufSizeWithinBounds(&consumer.conn, result);
+    return result;
+}
+
+PIDControllerImpl DcpFlowControlManagerAdaptive::makePID(
+        std::chrono::steady_clock::time_point now) const {
+    const auto& conf = engine_.getConfiguration();
+    return {conf.getDcpFlowControlAdaptiveBacklogTarget(),
+            conf.getDcpFlowControlAdaptivePidP(),
+            conf.getDcpFlowControlAdaptivePidI(),
+            conf.getDcpFlowControlAdaptivePidD(),
+            std::chrono::milliseconds{conf.getDcpFlowControlAdaptivePidDt()},
+            now};
+}
+
+size_t DcpFlowControlManagerAdaptive::getAggrBufferSizeLimit() const {
+    const auto& config = engine_.getConfiguration();
+    const double threshold =
+            static_cast<double>(config.getDcpConnBufferSizeAggrMemThreshold()) /
+            100;
+    return threshold * engine_.getEpStats().getMaxDataSize();
+}
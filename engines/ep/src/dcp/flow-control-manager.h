@@ -11,8 +11,10 @@
 #pragma once
 
 #include "memcached/types.h"
+#include "pid_controller.h"
 
 #include <atomic>
+#include <chrono>
 #include <map>
 #include <mutex>
 
@@ -43,6 +45,10 @@ public:
     /* To be called when a consumer connection is deleted */
     virtual void handleDisconnect(DcpConsumer *);
 
+    /* To be called by a consumer connection before it handles flow control;
+       lets the policy resize the flow control buffers */
+    virtual void maybeResizeBuffers();
+
     /* Will indicate if flow control is enabled */
     virtual bool isEnabled() const;
 
@@ -126,3 +132,82 @@ private:
     /* Fraction of memQuota for all dcp consumer connection buffers */
     std::atomic<double> dcpConnBufferSizeAggrFrac;
 };
+
+/**
+ * In this policy the flow control buffer size of each connection follows how
+ * quickly the consumer drains it. A connection starts with the aggressive
+ * policy's share of memory. Every dcp_flow_control_adaptive_pid_dt the size of
+ * each connection is adjusted by a PID controller whose process variable is
+ * the fraction of the buffer waiting in the consumer's stream buffers (the
+ * backlog), with a set point of dcp_flow_control_adaptive_backlog_target:
+ *
+ * - Below the target, and if the consumer processed at least a buffer's worth
+ *   of bytes in the interval (so the buffer limits the throughput), the buffer
+ *   grows; up to twice the bytes processed in the interval.
+ * - Above the target (the consumer is stalled, for example backing off for
+ *   memory) the buffer shrinks, limiting the memory it can buffer.
+ *
+ * Sizes are kept within dcp_conn_buffer_size and dcp_conn_buffer_size_max,
+ * and the sum of all buffers within dcp_conn_buffer_size_aggr_mem_threshold
+ * of the bucket quota. A new connection only gets the headroom left under
+ * that limit (at least dcp_conn_buffer_size); if there isn't room for the
+ * minimum, the other buffers are shrunk to their share of the limit.
+ */
+class DcpFlowControlManagerAdaptive : public DcpFlowControlManager {
+public:
+    explicit DcpFlowControlManagerAdaptive(EventuallyPersistentEngine& engine);
+
+    ~DcpFlowControlManagerAdaptive() override;
+
+    size_t newConsumerConn(DcpConsumer* consumerConn) override;
+
+    void handleDisconnect(DcpConsumer* consumerConn) override;
+
+    void maybeResizeBuffers() override;
+
+    bool isEnabled() const override;
+
+    /**
+     * Resize the buffers if dt has elapsed since the last resize.
+     * @param now The current time
+     */
+    void maybeResizeBuffers(std::chrono::steady_clock::time_point now);
+
+protected:
+    struct Consumer {
+        Consumer(DcpConsumer& conn,
+                 PIDControllerImpl pid,
+                 uint64_t processedBytes)
+            : conn(conn), pid(std::move(pid)), processedBytes(processedBytes) {
+        }
+        DcpConsumer& conn;
+        PIDControllerImpl pid;
+        /// Bytes processed by the consumer at the last resize
+        uint64_t processedBytes;
+    };
+
+    /**
+     * Compute the new buffer size of the consumer.
+     * @param headroom The bytes the buffer may grow by
+     */
+    size_t computeBufferSize(Consumer& consumer,
+                             std::chrono::steady_clock::time_point now,
+                             size_t headroom);
+
+    /// @return a PID for a new consumer, configured from the configuration
+    PIDControllerImpl makePID(std::chrono::steady_clock::time_point now) const;
+
+    /// @return the limit of the sum of all buffers
+    size_t getAggrBufferSizeLimit() const;
+
+    /// Resets a PID if its configuration has changed
+    std::function<bool(PIDControllerImpl&)> pidReset;
+
+    /* Mutex to ensure dcpConsumersMap is thread safe */
+    std::mutex dcpConsumersMapMutex;
+    /* All DCP Consumers with flow control buffer */
+    std::map<const CookieIface*, Consumer> dcpConsumersMap;
+
+    /// When the buffers are next resized (a steady_clock rep)
+    std::atomic<std::chrono::steady_clock::rep> nextResize;
+};
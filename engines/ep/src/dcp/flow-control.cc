@@ -23,6 +23,7 @@ FlowControl::FlowControl(EventuallyPersistentEngine& engine,
       engine_(engine),
       enabled(engine.getDcpFlowControlManager().isEnabled()),
       pendingControl(true),
+      bufferSize(0),
       lastBufferAck(ep_current_time()),
       ackedBytes(0),
       freedBytes(0) {
@@ -39,6 +40,10 @@ FlowControl::~FlowControl() {
 cb::engine_errc FlowControl::handleFlowCtl(
         DcpMessageProducersIface& producers) {
     if (enabled) {
+        // Give the policy a chance to resize the buffer; a new size is sent
+        // to the producer below.
+        engine_.getDcpFlowControlManager().maybeResizeBuffers();
+
         cb::engine_errc ret;
         uint32_t ackable_bytes = freedBytes.load();
         std::unique_lock<std::mutex> lh(bufferSizeLock);
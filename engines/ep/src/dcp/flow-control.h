@@ -48,6 +48,10 @@ public:
         return freedBytes.load();
     }
 
+    uint64_t getAckedBytes() const {
+        return ackedBytes.load();
+    }
+
     bool isEnabled() const {
         return enabled;
     }
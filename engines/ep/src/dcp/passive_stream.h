@@ -114,6 +114,12 @@ public:
         return buffer.messages.size();
     }
 
+    /// @return the bytes of the messages buffered for processing
+    size_t getBufferBytes() const {
+        std::lock_guard<std::mutex> lh(buffer.bufMutex);
+        return buffer.bytes;
+    }
+
 protected:
     bool transitionState(StreamState newState);
 
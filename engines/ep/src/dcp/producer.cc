@@ -1409,6 +1409,16 @@ void DcpProducer::recordBackfillManagerBytesSent(size_t bytes) {
     }
 }
 
+bool DcpProducer::recordBackfillManagerBytesPrefetched(size_t bytes) {
+    return backfillMgr && backfillMgr->bytesCheckAndPrefetch(bytes);
+}
+
+void DcpProducer::recordBackfillManagerPrefetchReleased(size_t bytes) {
+    if (backfillMgr) {
+        backfillMgr->bytesPrefetchReleased(bytes);
+    }
+}
+
 bool DcpProducer::scheduleBackfillManager(VBucket& vb,
                                           std::shared_ptr<ActiveStream> s,
                                           uint64_t start,
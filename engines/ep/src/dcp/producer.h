@@ -204,6 +204,20 @@ public:
      */
     void recordBackfillManagerBytesSent(size_t bytes);
 
+    /**
+     * Reserve space in the Backfill buffer for an item read ahead of its
+     * stream by a BackfillPrefetcher.
+     *
+     * @returns True if the space was reserved, else false (and prefetching
+     *          should be paused)
+     */
+    bool recordBackfillManagerBytesPrefetched(size_t bytes);
+
+    /**
+     * Release space reserved by recordBackfillManagerBytesPrefetched.
+     */
+    void recordBackfillManagerPrefetchReleased(size_t bytes);
+
     virtual bool scheduleBackfillManager(VBucket& vb,
                                          std::shared_ptr<ActiveStream> s,
                                          uint64_t start,
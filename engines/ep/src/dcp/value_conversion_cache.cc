@@ -0,0 +1,147 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "dcp/value_conversion_cache.h"
+
+#include "item.h"
+
+#include <folly/hash/Hash.h>
+#include <folly/lang/Assume.h>
+#include <mcbp/protocol/datatype.h>
+#include <platform/compress.h>
+
+DcpValueConversionCache::DcpValueConversionCache(size_t numSlots,
+                                                 size_t maxValueSize,
+                                                 size_t maxBytes)
+    : slots(numSlots), maxValueSize(maxValueSize), maxBytes(maxBytes) {
+}
+
+std::optional<DcpValueConversionCache::Result>
+DcpValueConversionCache::getCompressed(const Item& item) {
+    return get(item, Conversion::Compress);
+}
+
+std::optional<DcpValueConversionCache::Result>
+DcpValueConversionCache::getInflated(const Item& item) {
+    return get(item, Conversion::Inflate);
+}
+
+std::optional<DcpValueConversionCache::Result> DcpValueConversionCache::get(
+        const Item& item, Conversion conversion) {
+    const auto& original = item.getValue();
+    if (slots.empty() || !original || item.getNBytes() > maxValueSize) {
+        return convert(item, conversion);
+    }
+
+    // Blobs are aligned, so mix the address rather than use its low bits
+    const auto hash = folly::hash::twang_mix64(
+            reinterpret_cast<uintptr_t>(original.get().get()));
+    auto& slot = slots[hash % slots.size()];
+    {
+        auto locked = slot.lock();
+        if (locked->original.get().get() == original.get().get() &&
+            locked->conversion == conversion) {
+            ++hits;
+            return locked->result;
+        }
+    }
+
+    // Convert without the slot locked; if two streams miss on the same value
+    // at once both convert it, and the last one is cached
+    ++misses;
+    auto result = convert(item, conversion);
+    if (!result) {
+        return result;
+    }
+
+    // The entry pins the original and (if it's a new Blob) the converted value
+    auto size = original->getSize();
+    if (result->value.get().get() != original.get().get()) {
+        size += result->value->getSize();
+    }
+    if (reserve(size)) {
+        auto locked = slot.lock();
+        bytes -= locked->bytes;
+        locked->original = original;
+        locked->conversion = conversion;
+        locked->result = *result;
+        locked->bytes = size;
+    }
+    return result;
+}
+
+bool DcpValueConversionCache::reserve(size_t size) {
+    if (size > maxBytes) {
+        return false;
+    }
+    bytes += size;
+
+    // Evict one slot at a time (never holding two slot locks), visiting each
+    // slot at most once
+    for (size_t ii = 0; bytes > maxBytes && ii < slots.size(); ++ii) {
+        auto locked = slots[evictCursor++ % slots.size()].lock();
+        bytes -= locked->bytes;
+        *locked = Slot{};
+    }
+
+    if (bytes > maxBytes) {
+        // Concurrent inserts have reserved the space
+        bytes -= size;
+        return false;
+    }
+    return true;
+}
+
+static value_t newValue(const cb::compression::Buffer& buffer) {
+    return value_t(TaggedPtr<Blob>(Blob::New(buffer.data(), buffer.size()),
+                                   TaggedPtrBase::NoTagValue));
+}
+
+std::optional<DcpValueConversionCache::Result>
+DcpValueConversionCache::convert(const Item& item, Conversion conversion) {
+    const auto datatype = item.getDataType();
+    const bool snappy = mcbp::datatype::is_snappy(datatype);
+    const std::string_view value{item.getData(), item.getNBytes()};
+
+    switch (conversion) {
+    case Conversion::Compress: {
+        if (snappy) {
+            return Result{item.getValue(), datatype};
+        }
+        cb::compression::Buffer deflated;
+        if (!cb::compression::deflate(
+                    cb::compression::Algorithm::Snappy, value, deflated)) {
+            return std::nullopt;
+        }
+        if (deflated.size() > value.size()) {
+            // As Item::compressValue, not worth compressing but a success
+            return Result{item.getValue(), datatype};
+        }
+        return Result{newValue(deflated),
+                      protocol_binary_datatype_t(
+                              datatype | PROTOCOL_BINARY_DATATYPE_SNAPPY)};
+    }
+    case Conversion::Inflate: {
+        if (!snappy) {
+            return Result{item.getValue(), datatype};
+        }
+        cb::compression::Buffer inflated;
+        if (!cb::compression::inflate(
+                    cb::compression::Algorithm::Snappy, value, inflated)) {
+            return std::nullopt;
+        }
+        return Result{newValue(inflated),
+                      protocol_binary_datatype_t(
+                              datatype & ~PROTOCOL_BINARY_DATATYPE_SNAPPY)};
+    }
+    }
+    folly::assume_unreachable();
+}
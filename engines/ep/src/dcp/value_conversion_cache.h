@@ -0,0 +1,139 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+#include "blob.h"
+
+#include <folly/Synchronized.h>
+#include <memcached/types.h>
+#include <relaxed_atomic.h>
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+class Item;
+
+/**
+ * Cache of the Snappy compressed / inflated form of recently streamed values,
+ * shared by every ActiveStream of a bucket.
+ *
+ * Each DCP stream converts a value to the compression its connection asks for
+ * (compressing for force_value_compression, inflating when Snappy isn't
+ * enabled). Several streams of a vBucket (replicas, XDCR, indexes, ...)
+ * typically send the same items at around the same time, so the first stream
+ * to convert a value caches the result and the others send the same Blob; the
+ * send path references the Blob (ItemSendBuffer) instead of copying it.
+ *
+ * The cache is direct-mapped on the address of the original Blob. Each slot
+ * holds a reference to the original Blob (so the address can't be reused
+ * while it's cached) and the converted Blob; a newer conversion mapping to
+ * the same slot replaces it.
+ *
+ * The Blobs referenced by the cache are pinned in memory (an original may
+ * have been ejected / expelled from the HashTable / CheckpointManager), so the
+ * total size of the cached Blobs is bounded by maxBytes; inserting an entry
+ * which would exceed it evicts entries round robin from the other slots.
+ */
+class DcpValueConversionCache {
+public:
+    /// The result of a conversion
+    struct Result {
+        /// The converted value; the original value if the conversion isn't
+        /// worth it (the compressed value isn't smaller)
+        value_t value;
+        protocol_binary_datatype_t datatype;
+    };
+
+    /**
+     * @param numSlots The number of slots (0 disables caching; every value
+     *        is converted by the caller)
+     * @param maxValueSize Values larger than this aren't cached
+     * @param maxBytes The maximum total size of the Blobs referenced by the
+     *        cache
+     */
+    DcpValueConversionCache(size_t numSlots,
+                            size_t maxValueSize,
+                            size_t maxBytes);
+
+    /**
+     * Get the value of the item Snappy compressed; from the cache if another
+     * stream has already compressed it, else compressing it.
+     *
+     * @return the compressed value (and datatype), or std::nullopt if the
+     *         compression failed
+     */
+    std::optional<Result> getCompressed(const Item& item);
+
+    /**
+     * Get the value of the item inflated; from the cache if another stream
+     * has already inflated it, else inflating it.
+     *
+     * @return the inflated value (and datatype), or std::nullopt if the
+     *         value couldn't be inflated
+     */
+    std::optional<Result> getInflated(const Item& item);
+
+    size_t getHits() const {
+        return hits;
+    }
+
+    size_t getMisses() const {
+        return misses;
+    }
+
+    /// @return the total size of the Blobs referenced by the cache
+    size_t getBytes() const {
+        return bytes;
+    }
+
+protected:
+    enum class Conversion : uint8_t { Compress, Inflate };
+
+    std::optional<Result> get(const Item& item, Conversion conversion);
+
+    /// Convert the value of the item (without the cache)
+    static std::optional<Result> convert(const Item& item,
+                                         Conversion conversion);
+
+    /**
+     * Account size bytes for a new entry, evicting entries until the cache
+     * is within maxBytes.
+     *
+     * @return false (accounting nothing) if the entry doesn't fit
+     */
+    bool reserve(size_t size);
+
+    struct Slot {
+        /// The value converted; the slot is empty if null
+        value_t original;
+        Conversion conversion{Conversion::Compress};
+        Result result;
+        /// The size of the Blobs referenced by the slot
+        size_t bytes{0};
+    };
+
+    std::vector<folly::Synchronized<Slot, std::mutex>> slots;
+    const size_t maxValueSize;
+    const size_t maxBytes;
+
+    /// The total size of the Blobs referenced by the slots (including
+    /// reservations for entries being inserted)
+    std::atomic<size_t> bytes{0};
+
+    /// The next slot reserve() evicts
+    std::atomic<size_t> evictCursor{0};
+
+    cb::RelaxedAtomic<size_t> hits{0};
+    cb::RelaxedAtomic<size_t> misses{0};
+};
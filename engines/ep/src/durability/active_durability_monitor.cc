@@ -501,9 +501,9 @@ void ActiveDurabilityMonitor::addStatsForChain(
                     addStat,
                     cookie);
 
-    for (const auto& entry : chain.positions) {
-        const auto* node = entry.first.c_str();
-        const auto& pos = entry.second;
+    for (size_t id = 0; id < chain.nodes.size(); ++id) {
+        const auto* node = chain.nodes[id].c_str();
+        const auto& pos = chain.positions[id];
 
         add_casted_stat(
                 fmt::format("vb_{}:replication_chain_{}:{}:last_write_seqno",
@@ -612,7 +612,7 @@ void ActiveDurabilityMonitor::unresolveCompletedSyncWriteQueue() {
     // Second, whack them back into trackedWrites. The container should be in
     // seqno order so we will just put them at the front of trackedWrites.
     auto s = state.wlock();
-    s->trackedWrites.splice(s->trackedWrites.begin(), writesToTrack);
+    s->trackedWrites.prepend(std::move(writesToTrack));
 
     Expects(resolvedQueue->empty());
 }
@@ -667,26 +667,33 @@ ActiveDurabilityMonitor::State::State(
     highCompletedSeqno.setLabel(prefix + "highCompletedSeqno");
 }
 
+ActiveDurabilityMonitor::State::ChainNode
+ActiveDurabilityMonitor::State::resolveNode(const std::string& node) const {
+    Expects(firstChain.get());
+    ChainNode ret;
+    ret.first = firstChain->getNodeId(node);
+    if (secondChain) {
+        ret.second = secondChain->getNodeId(node);
+    }
+    return ret;
+}
+
 ActiveDurabilityMonitor::Container::iterator
-ActiveDurabilityMonitor::State::getNodeNext(const std::string& node) {
+ActiveDurabilityMonitor::State::getNodeNext(const ChainNode& node) {
     Expects(firstChain.get());
     // Note: Container::end could be the new position when the pointed SyncWrite
     //     is removed from Container and the iterator repositioned.
     //     In that case next=Container::begin
-    auto firstChainItr = firstChain->positions.find(node);
-    if (firstChainItr != firstChain->positions.end()) {
-        const auto& it = firstChainItr->second.it;
+    if (node.inFirstChain()) {
+        const auto& it = firstChain->positions[node.first].it;
         return (it == trackedWrites.end()) ? trackedWrites.begin()
                                            : std::next(it);
     }
 
-    if (secondChain) {
-        auto secondChainItr = secondChain->positions.find(node);
-        if (secondChainItr != secondChain->positions.end()) {
-            const auto& it = secondChainItr->second.it;
-            return (it == trackedWrites.end()) ? trackedWrites.begin()
-                                               : std::next(it);
-        }
+    if (node.inSecondChain()) {
+        const auto& it = secondChain->positions[node.second].it;
+        return (it == trackedWrites.end()) ? trackedWrites.begin()
+                                           : std::next(it);
     }
 
     // Node not found, return the trackedWrites.end(), stl style.
@@ -694,59 +701,40 @@ ActiveDurabilityMonitor::State::getNodeNext(const std::string& node) {
 }
 
 ActiveDurabilityMonitor::Container::iterator
-ActiveDurabilityMonitor::State::advanceNodePosition(const std::string& node) {
+ActiveDurabilityMonitor::State::advanceNodePosition(const ChainNode& node) {
     // We must have at least a firstChain
     Expects(firstChain.get());
 
     // But the node may not be in it if we have a secondChain
-    auto firstChainItr = firstChain->positions.find(node);
-    auto firstChainFound = firstChainItr != firstChain->positions.end();
-    if (!firstChainFound && !secondChain) {
+    if (!node.valid()) {
         // Attempting to advance for a node we don't know about, panic
         throwException<std::logic_error>(
                 __func__,
-                "Attempting to advance positions for an invalid node " + node);
-    }
-
-    std::unordered_map<std::string, Position<Container>>::iterator
-            secondChainItr;
-    auto secondChainFound = false;
-    if (secondChain) {
-        secondChainItr = secondChain->positions.find(node);
-        secondChainFound = secondChainItr != secondChain->positions.end();
-        if (!firstChainFound && !secondChainFound) {
-            throwException<std::logic_error>(
-                    __func__,
-                    "Attempting to advance positions for an invalid node " +
-                            node +
-                            ". Node is not in firstChain or secondChain");
-        }
+                "Attempting to advance positions for an invalid node. Node is "
+                "not in firstChain or secondChain");
     }
 
     // Node may be in both chains (or only one) so we need to advance only the
     // correct chain.
-    if (firstChainFound) {
-        auto& pos = const_cast<Position<Container>&>(firstChainItr->second);
+    if (node.inFirstChain()) {
+        auto& pos = firstChain->positions[node.first];
         // We only ack if we do not have this node in the secondChain because
         // we only want to ack once
-        advanceAndAckForPosition(pos, node, !secondChainFound /*should ack*/);
-        if (!secondChainFound) {
+        advanceAndAckForPosition(
+                pos, node, !node.inSecondChain() /*should ack*/);
+        if (!node.inSecondChain()) {
             return pos.it;
         }
     }
 
-    if (secondChainFound) {
-        // Update second chain itr
-        auto& pos = const_cast<Position<Container>&>(secondChainItr->second);
-        advanceAndAckForPosition(pos, node, true /* should ack*/);
-        return pos.it;
-    }
-
-    folly::assume_unreachable();
+    // Update second chain itr
+    auto& pos = secondChain->positions[node.second];
+    advanceAndAckForPosition(pos, node, true /* should ack*/);
+    return pos.it;
 }
 
 void ActiveDurabilityMonitor::State::advanceAndAckForPosition(
-        Position<Container>& pos, const std::string& node, bool shouldAck) {
+        Position<Container>& pos, const ChainNode& node, bool shouldAck) {
     if (pos.it == trackedWrites.end()) {
         pos.it = trackedWrites.begin();
     } else {
@@ -762,7 +750,7 @@ void ActiveDurabilityMonitor::State::advanceAndAckForPosition(
 
     // Update the SyncWrite ack-counters, necessary for DurReqs verification
     if (shouldAck) {
-        pos.it->ack(node);
+        pos.it->ack(node.inFirstChain(), node.inSecondChain());
     }
 
     // Add a trace event for the ACK from this node (assuming we have a cookie
@@ -773,7 +761,7 @@ void ActiveDurabilityMonitor::State::advanceAndAckForPosition(
     auto* cookie = pos.it->getCookie();
     if (cookie) {
         const auto ackTime = std::chrono::steady_clock::now();
-        const auto event = (node == getActive())
+        const auto event = (node.first == ReplicationChain::ActiveNode)
                                    ? cb::tracing::Code::SyncWriteAckLocal
                                    : cb::tracing::Code::SyncWriteAckRemote;
         TracerStopwatch ackTimer(cookie, event);
@@ -782,17 +770,14 @@ void ActiveDurabilityMonitor::State::advanceAndAckForPosition(
     }
 }
 
-void ActiveDurabilityMonitor::State::updateNodeAck(const std::string& node,
-                                                   int64_t seqno) {
+void ActiveDurabilityMonitor::State::updateNodeAck(
+        const std::string& node, const ChainNode& chainNode, int64_t seqno) {
     // We must have at least a firstChain
     Expects(firstChain.get());
 
     // But the node may not be in it.
-    auto firstChainItr = firstChain->positions.find(node);
-    auto firstChainFound = firstChainItr != firstChain->positions.end();
-    if (firstChainFound) {
-        auto& firstChainPos =
-                const_cast<Position<Container>&>(firstChainItr->second);
+    if (chainNode.inFirstChain()) {
+        auto& firstChainPos = firstChain->positions[chainNode.first];
         if (firstChainPos.lastAckSeqno > seqno) {
             EP_LOG_WARN(
                     "({}) Node {} acked seqno:{} lower than previous ack "
@@ -807,28 +792,22 @@ void ActiveDurabilityMonitor::State::updateNodeAck(const std::string& node,
         }
     }
 
-    bool secondChainFound = false;
-    if (secondChain) {
-        auto secondChainItr = secondChain->positions.find(node);
-        if (secondChainItr != secondChain->positions.end()) {
-            secondChainFound = true;
-            auto& secondChainPos =
-                    const_cast<Position<Container>&>(secondChainItr->second);
-            if (secondChainPos.lastAckSeqno > seqno) {
-                EP_LOG_WARN(
-                        "({}) Node {} acked seqno:{} lower than previous ack "
-                        "seqno:{} (second chain)",
-                        adm.vb.getId(),
-                        node,
-                        seqno,
-                        int64_t(secondChainPos.lastAckSeqno));
-            } else {
-                secondChainPos.lastAckSeqno = seqno;
-            }
+    if (chainNode.inSecondChain()) {
+        auto& secondChainPos = secondChain->positions[chainNode.second];
+        if (secondChainPos.lastAckSeqno > seqno) {
+            EP_LOG_WARN(
+                    "({}) Node {} acked seqno:{} lower than previous ack "
+                    "seqno:{} (second chain)",
+                    adm.vb.getId(),
+                    node,
+                    seqno,
+                    int64_t(secondChainPos.lastAckSeqno));
+        } else {
+            secondChainPos.lastAckSeqno = seqno;
         }
     }
 
-    if (!firstChainFound && !secondChainFound) {
+    if (!chainNode.valid()) {
         // We didn't find the node in either of our chains, but we still need to
         // track the ack for this node in case we are about to get a topology
         // change in which this node will exist.
@@ -853,17 +832,13 @@ const std::string& ActiveDurabilityMonitor::State::getActive() const {
 
 int64_t ActiveDurabilityMonitor::State::getNodeWriteSeqno(
         const std::string& node) const {
-    Expects(firstChain.get());
-    auto firstChainItr = firstChain->positions.find(node);
-    if (firstChainItr != firstChain->positions.end()) {
-        return firstChainItr->second.lastWriteSeqno;
+    const auto chainNode = resolveNode(node);
+    if (chainNode.inFirstChain()) {
+        return firstChain->positions[chainNode.first].lastWriteSeqno;
     }
 
-    if (secondChain) {
-        auto secondChainItr = secondChain->positions.find(node);
-        if (secondChainItr != secondChain->positions.end()) {
-            return secondChainItr->second.lastWriteSeqno;
-        }
+    if (chainNode.inSecondChain()) {
+        return secondChain->positions[chainNode.second].lastWriteSeqno;
     }
 
     throwException<std::invalid_argument>(__func__,
@@ -872,17 +847,13 @@ int64_t ActiveDurabilityMonitor::State::getNodeWriteSeqno(
 
 int64_t ActiveDurabilityMonitor::State::getNodeAckSeqno(
         const std::string& node) const {
-    Expects(firstChain.get());
-    auto firstChainItr = firstChain->positions.find(node);
-    if (firstChainItr != firstChain->positions.end()) {
-        return firstChainItr->second.lastAckSeqno;
+    const auto chainNode = resolveNode(node);
+    if (chainNode.inFirstChain()) {
+        return firstChain->positions[chainNode.first].lastAckSeqno;
     }
 
-    if (secondChain) {
-        auto secondChainItr = secondChain->positions.find(node);
-        if (secondChainItr != secondChain->positions.end()) {
-            return secondChainItr->second.lastAckSeqno;
-        }
+    if (chainNode.inSecondChain()) {
+        return secondChain->positions[chainNode.second].lastAckSeqno;
     }
 
     throwException<std::invalid_argument>(__func__,
@@ -923,24 +894,22 @@ ActiveDurabilityMonitor::State::removeSyncWrite(Container::iterator it,
     // Note: O(N) with N=<number of iterators>, max(N)=6
     //     (max 2 chains, 3 replicas, 1 iterator per replica)
     Expects(firstChain.get());
-    for (const auto& entry : firstChain->positions) {
-        const auto& nodePos = entry.second;
+    for (auto& nodePos : firstChain->positions) {
         if (nodePos.it == it) {
-            const_cast<Position<Container>&>(nodePos).it = prev;
+            nodePos.it = prev;
         }
     }
 
     if (secondChain) {
-        for (const auto& entry : secondChain->positions) {
-            const auto& nodePos = entry.second;
+        for (auto& nodePos : secondChain->positions) {
             if (nodePos.it == it) {
-                const_cast<Position<Container>&>(nodePos).it = prev;
+                nodePos.it = prev;
             }
         }
     }
 
-    Container removed;
-    removed.splice(removed.end(), trackedWrites, it);
+    auto removed = std::move(*it);
+    trackedWrites.erase(it);
 
     if (removingFirstElement) {
         // If first element was removed, then a new SyncWrite (or possibly none
@@ -949,7 +918,7 @@ ActiveDurabilityMonitor::State::removeSyncWrite(Container::iterator it,
         scheduleTimeoutCallback();
     }
 
-    return std::move(removed.front());
+    return removed;
 }
 
 void ActiveDurabilityMonitor::commit(const ActiveSyncWrite& sw) {
@@ -1069,16 +1038,16 @@ void ActiveDurabilityMonitor::eraseSyncWrite(const DocKey& key, int64_t seqno) {
         // We really should have a first chain at this point, the only case
         // where we shouldn't should be an upgrade, but better safe than sorry!
         for (auto& position : s->firstChain->positions) {
-            if (position.second.it == toErase) {
-                position.second.it = valid;
+            if (position.it == toErase) {
+                position.it = valid;
             }
         }
     }
 
     if (s->secondChain) {
         for (auto& position : s->secondChain->positions) {
-            if (position.second.it == toErase) {
-                position.second.it = valid;
+            if (position.it == toErase) {
+                position.it = valid;
             }
         }
     }
@@ -1163,15 +1132,19 @@ void ActiveDurabilityMonitor::State::processSeqnoAck(const std::string& node,
         return;
     }
 
+    // Resolve the node once; the per-SyncWrite work below then only deals
+    // with NodeIds.
+    const auto chainNode = resolveNode(node);
+
     // We should never ack for the active
-    Expects(firstChain->active != node);
+    Expects(chainNode.first != ReplicationChain::ActiveNode);
 
     // Note: process up to the ack'ed seqno
     ActiveDurabilityMonitor::Container::iterator next;
-    while ((next = getNodeNext(node)) != trackedWrites.end() &&
+    while ((next = getNodeNext(chainNode)) != trackedWrites.end() &&
            next->getBySeqno() <= seqno) {
         // Update replica tracking
-        const auto& posIt = advanceNodePosition(node);
+        const auto& posIt = advanceNodePosition(chainNode);
 
         // Check if Durability Requirements satisfied now, and add for commit
         if (posIt->isSatisfied()) {
@@ -1182,7 +1155,7 @@ void ActiveDurabilityMonitor::State::processSeqnoAck(const std::string& node,
     }
 
     // We keep track of the actual ack'ed seqno
-    updateNodeAck(node, seqno);
+    updateNodeAck(node, chainNode, seqno);
 }
 
 std::unordered_set<int64_t> ActiveDurabilityMonitor::getTrackedSeqnos() const {
@@ -1219,9 +1192,9 @@ void ActiveDurabilityMonitor::chainToOstream(
     os << "Chain[" << &rc << "] name:" << to_string(rc.name)
        << " majority:" << int(rc.majority) << " active:" << rc.active
        << " maxAllowedReplicas:" << rc.maxAllowedReplicas << " positions:[\n";
-    for (const auto& pos : rc.positions) {
-        os << "    " << pos.first << ": "
-           << to_string(pos.second, trackedWritesEnd) << "\n";
+    for (size_t id = 0; id < rc.nodes.size(); ++id) {
+        os << "    " << rc.nodes[id] << ": "
+           << to_string(rc.positions[id], trackedWritesEnd) << "\n";
     }
     os << "]";
 }
@@ -1282,32 +1255,15 @@ ActiveDurabilityMonitor::State::makeChain(
             return ptr;
         }
 
-        auto firstChainItr = firstChain->positions.find(firstChain->active);
-        if (firstChainItr == firstChain->positions.end()) {
-            // Sanity - we should never make a chain in this state
-            throwException<std::logic_error>(
-                    __func__,
-                    "did not find the "
-                    "active node for the first chain in the "
-                    "first chain.");
-        }
-
-        auto newChainItr = ptr->positions.find(ptr->active);
-        if (newChainItr == ptr->positions.end()) {
-            // Sanity - we should never make a chain in this state
-            throwException<std::logic_error>(
-                    __func__,
-                    "did not find the "
-                    "active node for the first chain in the "
-                    "new chain.");
-        }
-
         // We set the lastWriteSeqno (HPS) on the new chain regardless of
         // whether not the firstChain active has changed. If it does, this is
         // ns_server renaming us. Any other change would involve a change of
         // the vBucket state.
-        newChainItr->second.lastWriteSeqno =
-                firstChainItr->second.lastWriteSeqno;
+        // Note: The active is always the first node of a chain (the chain
+        // ctor rejects an undefined active).
+        ptr->positions[ReplicationChain::ActiveNode].lastWriteSeqno =
+                firstChain->positions[ReplicationChain::ActiveNode]
+                        .lastWriteSeqno;
     }
 
     return ptr;
@@ -1406,7 +1362,7 @@ void ActiveDurabilityMonitor::State::transitionFromNullTopology(
         auto fence = std::max(static_cast<uint64_t>(highPreparedSeqno),
                               adm.vb.getPersistenceSeqno());
         auto& activePos =
-                newFirstChain.positions.find(newFirstChain.active)->second;
+                newFirstChain.positions[ReplicationChain::ActiveNode];
         auto it = trackedWrites.begin();
         while (it != trackedWrites.end()) {
             if (it->getBySeqno() <= static_cast<int64_t>(fence)) {
@@ -1452,10 +1408,10 @@ void ActiveDurabilityMonitor::State::copyChainPositions(
 
 void ActiveDurabilityMonitor::State::copyChainPositionsInner(
         ReplicationChain& oldChain, ReplicationChain& newChain) {
-    for (const auto& node : oldChain.positions) {
-        auto newNode = newChain.positions.find(node.first);
-        if (newNode != newChain.positions.end()) {
-            newNode->second = node.second;
+    for (size_t id = 0; id < oldChain.nodes.size(); ++id) {
+        const auto newId = newChain.getNodeId(oldChain.nodes[id]);
+        if (newId != ReplicationChain::NoNode) {
+            newChain.positions[newId] = oldChain.positions[id];
         }
     }
 }
@@ -1473,9 +1429,8 @@ void ActiveDurabilityMonitor::State::abortNoLongerPossibleSyncWrites(
     // topology change.
     if (!(newFirstChain.isDurabilityPossible() &&
           (!newSecondChain || newSecondChain->isDurabilityPossible()))) {
-        // We can't use a for loop with iterators here because they will be
-        // modified to point to invalid memory as we use std::list.splice in
-        // removeSyncWrite.
+        // We can't use a for loop with iterators here because removeSyncWrite
+        // erases the element the iterator points to.
         auto itr = trackedWrites.begin();
         while (itr != trackedWrites.end()) {
             if (!itr->getDurabilityReqs().getTimeout().isInfinite()) {
@@ -1496,8 +1451,8 @@ void ActiveDurabilityMonitor::State::abortNoLongerPossibleSyncWrites(
 void ActiveDurabilityMonitor::State::performQueuedAckForChain(
         const ActiveDurabilityMonitor::ReplicationChain& chain,
         ResolvedQueue& toCommit) {
-    for (const auto& node : chain.positions) {
-        auto existingAck = queuedSeqnoAcks.find(node.first);
+    for (const auto& node : chain.nodes) {
+        auto existingAck = queuedSeqnoAcks.find(node);
         if (existingAck != queuedSeqnoAcks.end()) {
             processSeqnoAck(existingAck->first, existingAck->second, toCommit);
 
@@ -1635,13 +1590,12 @@ void ActiveDurabilityMonitor::State::updateHighPreparedSeqno(
         return;
     }
 
-    const auto& active = getActive();
+    const auto active = resolveNode(getActive());
     // Check if Durability Requirements are satisfied for the Prepare currently
     // tracked for Active, and add for commit in case.
-    auto removeForCommitIfSatisfied =
-            [this, &active, &completed]() mutable -> void {
+    auto removeForCommitIfSatisfied = [this, &completed]() mutable -> void {
         Expects(firstChain.get());
-        const auto& pos = firstChain->positions.at(active);
+        const auto& pos = firstChain->positions[ReplicationChain::ActiveNode];
         Expects(pos.it != trackedWrites.end());
         if (pos.it->isSatisfied()) {
             completed.enqueue(
@@ -13,6 +13,7 @@
 #include "durability_monitor.h"
 #include "ep_types.h"
 #include "memcached/engine_error.h"
+#include "tracked_writes_container.h"
 #include "utilities/testing_hook.h"
 
 #include <folly/SynchronizedPtr.h>
@@ -101,7 +102,8 @@ class ActiveDurabilityMonitor : public DurabilityMonitor {
 public:
     struct ReplicationChain;
     // Container type used for State::trackedWrites
-    using Container = std::list<DurabilityMonitor::ActiveSyncWrite>;
+    using Container =
+            TrackedWritesContainer<DurabilityMonitor::ActiveSyncWrite>;
 
     /**
      * Construct an ActiveDM for the given vBucket.
@@ -136,21 +136,27 @@ void DurabilityMonitor::ActiveSyncWrite::ack(const std::string& node) {
 
     // The node to ack may be in the firstChain, secondChain, or both, but we
     // don't know which.
-    bool acked = false;
-    if (firstChain.chainPtr->positions.find(node) !=
-        firstChain.chainPtr->positions.end()) {
-        firstChain.ackCount++;
-        acked = true;
+    const auto noNode = ActiveDurabilityMonitor::ReplicationChain::NoNode;
+    const bool inFirstChain = firstChain.chainPtr->getNodeId(node) != noNode;
+    const bool inSecondChain =
+            secondChain && secondChain.chainPtr->getNodeId(node) != noNode;
+    if (!inFirstChain && !inSecondChain) {
+        throw std::logic_error("SyncWrite::ack: Node not valid: " + node);
     }
+    ack(inFirstChain, inSecondChain);
+}
 
-    if (secondChain && secondChain.chainPtr->positions.find(node) !=
-                               secondChain.chainPtr->positions.end()) {
-        secondChain.ackCount++;
-        acked = true;
+void DurabilityMonitor::ActiveSyncWrite::ack(bool inFirstChain,
+                                             bool inSecondChain) {
+    if (!firstChain) {
+        throw std::logic_error(
+                "SyncWrite::ack: Acking without a ReplicationChain");
     }
-
-    if (!acked) {
-        throw std::logic_error("SyncWrite::ack: Node not valid: " + node);
+    if (inFirstChain) {
+        firstChain.ackCount++;
+    }
+    if (inSecondChain && secondChain) {
+        secondChain.ackCount++;
     }
 }
 
@@ -167,15 +173,17 @@ bool DurabilityMonitor::ActiveSyncWrite::isSatisfied() const {
     auto firstChainSatisfied =
             firstChain.ackCount >= firstChain.chainPtr->majority;
     auto firstChainActiveSatisfied = firstChain.chainPtr->hasAcked(
-            firstChain.chainPtr->active, this->getBySeqno());
+            ActiveDurabilityMonitor::ReplicationChain::ActiveNode,
+            this->getBySeqno());
     auto secondChainSatisfied =
             !secondChain ||
             secondChain.ackCount >= secondChain.chainPtr->majority;
     auto secondChainActiveSatisfied =
             !secondChain ||
             (secondChain.chainPtr->active == firstChain.chainPtr->active ||
-             secondChain.chainPtr->hasAcked(secondChain.chainPtr->active,
-                                            this->getBySeqno()));
+             secondChain.chainPtr->hasAcked(
+                     ActiveDurabilityMonitor::ReplicationChain::ActiveNode,
+                     this->getBySeqno()));
 
     // MB-35190: A SyncWrite must always be satisfied on the active, even
     // if it is a majority level prepare.
@@ -200,13 +208,13 @@ bool DurabilityMonitor::ActiveSyncWrite::isExpired(
 uint8_t DurabilityMonitor::ActiveSyncWrite::getAckCountForNewChain(
         const ActiveDurabilityMonitor::ReplicationChain& chain) {
     auto ackCount = 0;
-    for (const auto& pos : chain.positions) {
+    for (const auto& node : chain.nodes) {
         // We only bump the ackCount if this SyncWrite was acked in either the
         // first or second chain in the old topology (if they exist).
         if (((this->firstChain &&
-              this->firstChain.chainPtr->hasAcked(pos.first, getBySeqno())) ||
+              this->firstChain.chainPtr->hasAcked(node, getBySeqno())) ||
              (this->secondChain &&
-              this->secondChain.chainPtr->hasAcked(pos.first, getBySeqno())))) {
+              this->secondChain.chainPtr->hasAcked(node, getBySeqno())))) {
             ackCount++;
         }
     }
@@ -268,12 +276,13 @@ std::ostream& operator<<(std::ostream& os,
        << " #1stChainAcks:" << sw.firstChain.ackCount << " 1stChainAcks:[";
     std::string acks;
     if (sw.firstChain) {
-        for (const auto& ack : sw.firstChain.chainPtr->positions) {
-            if (sw.firstChain.chainPtr->hasAcked(ack.first, sw.getBySeqno())) {
+        const auto& chain = *sw.firstChain.chainPtr;
+        for (size_t id = 0; id < chain.nodes.size(); ++id) {
+            if (chain.hasAcked(id, sw.getBySeqno())) {
                 if (!acks.empty()) {
                     acks += ",";
                 }
-                acks += ack.first;
+                acks += chain.nodes[id];
             }
         }
     }
@@ -281,12 +290,13 @@ std::ostream& operator<<(std::ostream& os,
        << " 2ndChainAcks:[";
     acks = "";
     if (sw.secondChain) {
-        for (const auto& ack : sw.secondChain.chainPtr->positions) {
-            if (sw.secondChain.chainPtr->hasAcked(ack.first, sw.getBySeqno())) {
+        const auto& chain = *sw.secondChain.chainPtr;
+        for (size_t id = 0; id < chain.nodes.size(); ++id) {
+            if (chain.hasAcked(id, sw.getBySeqno())) {
                 if (!acks.empty()) {
                     acks += ",";
                 }
-                acks += ack.first;
+                acks += chain.nodes[id];
             }
         }
     }
@@ -315,14 +325,15 @@ ActiveDurabilityMonitor::ReplicationChain::ReplicationChain(
             continue;
         }
         // This check ensures that there is no duplicate in the given chain
-        auto result = positions.emplace(node, Position<Container>(it));
-        if (!result.second) {
+        if (getNodeId(node) != NoNode) {
             throw std::invalid_argument(
                     "ReplicationChain::ReplicationChain: Duplicate node: " +
                     node);
         }
-        result.first->second.lastAckSeqno.setLabel(node + "::lastAckSeqno");
-        result.first->second.lastWriteSeqno.setLabel(node + "::lastWriteSeqno");
+        this->nodes.push_back(node);
+        auto& pos = positions.emplace_back(it);
+        pos.lastAckSeqno.setLabel(node + "::lastAckSeqno");
+        pos.lastWriteSeqno.setLabel(node + "::lastWriteSeqno");
     }
 }
 
@@ -330,6 +341,18 @@ size_t ActiveDurabilityMonitor::ReplicationChain::size() const {
     return positions.size();
 }
 
+ActiveDurabilityMonitor::ReplicationChain::NodeId
+ActiveDurabilityMonitor::ReplicationChain::getNodeId(
+        const std::string& node) const {
+    // Chains have at most 4 nodes, a linear search beats hashing the name.
+    for (size_t id = 0; id < nodes.size(); ++id) {
+        if (nodes[id] == node) {
+            return NodeId(id);
+        }
+    }
+    return NoNode;
+}
+
 bool ActiveDurabilityMonitor::ReplicationChain::isDurabilityPossible() const {
     Expects(size());
     Expects(majority);
@@ -353,16 +376,21 @@ std::string to_string(DurabilityMonitor::ReplicationChainName name) {
     folly::assume_unreachable();
 }
 
+bool ActiveDurabilityMonitor::ReplicationChain::hasAcked(
+        NodeId node, int64_t bySeqno) const {
+    return positions[node].lastWriteSeqno >= bySeqno;
+}
+
 bool ActiveDurabilityMonitor::ReplicationChain::hasAcked(
         const std::string& node, int64_t bySeqno) const {
-    auto itr = positions.find(node);
+    const auto id = getNodeId(node);
 
     // Replica has not acked for this chain if we do not know about it.
-    if (itr == positions.end()) {
+    if (id == NoNode) {
         return false;
     }
 
-    return itr->second.lastWriteSeqno >= bySeqno;
+    return hasAcked(id, bySeqno);
 }
 
 bool operator>(const SnapshotEndInfo& a, const SnapshotEndInfo& b) {
@@ -24,6 +24,7 @@
 #include <platform/monotonic.h>
 
 #include <chrono>
+#include <limits>
 #include <queue>
 #include <unordered_map>
 #include <unordered_set>
@@ -178,6 +179,15 @@ public:
      */
     void ack(const std::string& node);
 
+    /**
+     * Notify this SyncWrite that it has been ack'ed by a node which has
+     * already been resolved against this SyncWrite's chains.
+     *
+     * @param inFirstChain the node is in the first chain
+     * @param inSecondChain the node is in the second chain
+     */
+    void ack(bool inFirstChain, bool inSecondChain);
+
     /**
      * @return true if the Durability Requirements are satisfied for this
      *     SyncWrite, false otherwise
@@ -349,16 +359,37 @@ struct ActiveDurabilityMonitor::ReplicationChain {
                      const Container::iterator& initPos,
                      size_t maxAllowedReplicas);
 
+    /**
+     * Id of a node within the chain; the index of the node in nodes and
+     * positions. Node names are resolved to ids once per operation (e.g. per
+     * seqno-ack) so per-SyncWrite processing doesn't need to look up or
+     * compare node names.
+     */
+    using NodeId = uint8_t;
+
+    /// NodeId returned for a node which is not in the chain.
+    static constexpr NodeId NoNode = std::numeric_limits<NodeId>::max();
+
+    /// The active is always the first node of the chain.
+    static constexpr NodeId ActiveNode = 0;
+
     size_t size() const;
 
     bool isDurabilityPossible() const;
 
+    /// @returns the id of the given node, or NoNode if not in this chain.
+    NodeId getNodeId(const std::string& node) const;
+
     // Check if the given node has acked at least the given seqno
+    bool hasAcked(NodeId node, int64_t bySeqno) const;
     bool hasAcked(const std::string& node, int64_t bySeqno) const;
 
-    // Index of node Positions. The key is the node id.
+    // The (defined) nodes in the chain, indexed by NodeId.
+    std::vector<std::string> nodes;
+
+    // Node Positions, indexed by NodeId.
     // A Position embeds the seqno-state of the tracked node.
-    std::unordered_map<std::string, Position<Container>> positions;
+    std::vector<Position<Container>> positions;
 
     // Majority in the arithmetic definition:
     //     chain-size / 2 + 1
@@ -448,6 +479,28 @@ struct ActiveDurabilityMonitor::State {
      */
     void addSyncWrite(const CookieIface* cookie, queued_item item);
 
+    /**
+     * A node resolved to its NodeId in each of the current chains
+     * (ReplicationChain::NoNode if the node is not in that chain).
+     */
+    struct ChainNode {
+        bool inFirstChain() const {
+            return first != ReplicationChain::NoNode;
+        }
+        bool inSecondChain() const {
+            return second != ReplicationChain::NoNode;
+        }
+        bool valid() const {
+            return inFirstChain() || inSecondChain();
+        }
+
+        ReplicationChain::NodeId first = ReplicationChain::NoNode;
+        ReplicationChain::NodeId second = ReplicationChain::NoNode;
+    };
+
+    /// Resolve the given node against the current chains.
+    ChainNode resolveNode(const std::string& node) const;
+
     /**
      * Returns the next position for a node iterator.
      *
@@ -455,7 +508,7 @@ struct ActiveDurabilityMonitor::State {
      * @return the iterator to the next position for the given node. Returns
      *         trackedWrites.end() if the node is not found.
      */
-    Container::iterator getNodeNext(const std::string& node);
+    Container::iterator getNodeNext(const ChainNode& node);
 
     /**
      * Advance a node tracking to the next Position in the tracked
@@ -468,7 +521,7 @@ struct ActiveDurabilityMonitor::State {
      *         given node.
      * @throws std::logic_error if the node is not found
      */
-    Container::iterator advanceNodePosition(const std::string& node);
+    Container::iterator advanceNodePosition(const ChainNode& node);
 
     /**
      * This function updates the tracking with the last seqno ack'ed by
@@ -482,9 +535,12 @@ struct ActiveDurabilityMonitor::State {
      * ns_server will give us a second chain.
      *
      * @param node
+     * @param chainNode node resolved against the current chains
      * @param seqno New ack seqno
      */
-    void updateNodeAck(const std::string& node, int64_t seqno);
+    void updateNodeAck(const std::string& node,
+                       const ChainNode& chainNode,
+                       int64_t seqno);
 
     /**
      * Updates a node memory/disk tracking as driven by the new ack-seqno.
@@ -681,7 +737,7 @@ private:
      *        node exists in both the first and second chain.
      */
     void advanceAndAckForPosition(Position<Container>& pos,
-                                  const std::string& node,
+                                  const ChainNode& node,
                                   bool shouldAck);
 
     /**
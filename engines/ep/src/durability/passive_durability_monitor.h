@@ -13,6 +13,7 @@
 #include "durability_monitor.h"
 #include "ep_types.h"
 #include "storeddockey_fwd.h"
+#include "tracked_writes_container.h"
 #include "utilities/testing_hook.h"
 
 #include <folly/SynchronizedPtr.h>
@@ -39,7 +40,7 @@ class VBucket;
 class PassiveDurabilityMonitor : public DurabilityMonitor {
 public:
     // Container type used for State::trackedWrites
-    using Container = std::list<SyncWrite>;
+    using Container = TrackedWritesContainer<SyncWrite>;
 
     explicit PassiveDurabilityMonitor(VBucket& vb);
 
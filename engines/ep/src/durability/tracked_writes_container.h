@@ -0,0 +1,320 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#pragma once
+
+#include <gsl/gsl-lite.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+/**
+ * The container used by the DurabilityMonitors to track in-flight SyncWrites
+ * (trackedWrites).
+ *
+ * A ring buffer of slots, where each element is addressed by the (monotonic)
+ * index it was inserted at. SyncWrites are appended in seqno order, so the
+ * index order is the seqno order. Compared to std::list this avoids a heap
+ * allocation per SyncWrite and keeps neighbouring SyncWrites adjacent in
+ * memory, which is what the seqno-ack processing walks over.
+ *
+ * Iterators are (container, index) pairs; like std::list iterators they
+ * remain valid until the element they point to is erased - in particular
+ * they are not invalidated by emplace_back(), prepend(), erase() of other
+ * elements, or by the buffer growing. end() is a distinguished sentinel, so
+ * an iterator equal to end() stays at end() when elements are appended.
+ *
+ * Unlike std::list, *references* to elements are invalidated when the buffer
+ * grows (as with std::vector). Code must hold iterators (e.g. Positions)
+ * rather than references across insertions.
+ *
+ * Elements erased from the middle (SyncWrites completing out of order, e.g. a
+ * Majority write completing behind a PersistToMajority one) leave an empty
+ * slot behind which iteration skips; empty slots are reclaimed once they
+ * reach either end of the buffer.
+ */
+template <class T>
+class TrackedWritesContainer {
+    template <bool Const>
+    class Iterator;
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    TrackedWritesContainer() = default;
+
+    // Iterators refer to the container, so it cannot be copied or moved.
+    TrackedWritesContainer(const TrackedWritesContainer&) = delete;
+    TrackedWritesContainer& operator=(const TrackedWritesContainer&) = delete;
+
+    iterator begin() {
+        return {this, nextLive(head)};
+    }
+    const_iterator begin() const {
+        return {this, nextLive(head)};
+    }
+    iterator end() {
+        return {this, End};
+    }
+    const_iterator end() const {
+        return {this, End};
+    }
+
+    T& front() {
+        Expects(!empty());
+        return *slot(head);
+    }
+    const T& front() const {
+        Expects(!empty());
+        return *slot(head);
+    }
+    T& back() {
+        Expects(!empty());
+        return *slot(tail - 1);
+    }
+    const T& back() const {
+        Expects(!empty());
+        return *slot(tail - 1);
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    template <class... Args>
+    T& emplace_back(Args&&... args) {
+        if (tail - head == slots.size()) {
+            grow();
+        }
+        auto& elem = slot(tail).emplace(std::forward<Args>(args)...);
+        ++tail;
+        ++count;
+        return elem;
+    }
+
+    void push_back(T&& elem) {
+        emplace_back(std::move(elem));
+    }
+
+    void push_back(const T& elem) {
+        emplace_back(elem);
+    }
+
+    /**
+     * Move all of the elements of other in front of the elements of this
+     * container, preserving their order. Existing iterators into this
+     * container remain valid; other is left empty.
+     */
+    void prepend(TrackedWritesContainer&& other) {
+        for (auto idx = other.tail; idx != other.head; --idx) {
+            auto& elem = other.slot(idx - 1);
+            if (!elem) {
+                continue;
+            }
+            if (tail - head == slots.size()) {
+                grow();
+            }
+            --head;
+            slot(head).emplace(std::move(*elem));
+            ++count;
+        }
+        other.clear();
+    }
+
+    /**
+     * Erase the element at the given iterator.
+     * @return an iterator to the element following the erased one.
+     */
+    iterator erase(const_iterator it) {
+        Expects(it.container == this);
+        Expects(it.index != End);
+        const auto next = nextLive(it.index + 1);
+        slot(it.index).reset();
+        --count;
+
+        // Reclaim any empty slots at the ends of the buffer.
+        while (head != tail && !slot(head)) {
+            ++head;
+        }
+        while (tail != head && !slot(tail - 1)) {
+            --tail;
+        }
+        if (empty() && slots.size() > MaxRetainedCapacity) {
+            // Don't keep the memory of a burst of SyncWrites around.
+            slots = std::vector<std::optional<T>>();
+        }
+        return {this, next};
+    }
+
+    void clear() {
+        slots = std::vector<std::optional<T>>();
+        head = tail = Origin;
+        count = 0;
+    }
+
+private:
+    /// Index used by end().
+    static constexpr uint64_t End = std::numeric_limits<uint64_t>::max();
+
+    /// Index of the first element of an empty container; leaves room below
+    /// for prepend().
+    static constexpr uint64_t Origin = uint64_t(1) << 62;
+
+    static constexpr size_t InitialCapacity = 8;
+
+    /// Capacity above which the buffer is released when it becomes empty.
+    static constexpr size_t MaxRetainedCapacity = 1024;
+
+    std::optional<T>& slot(uint64_t index) {
+        return slots[index & (slots.size() - 1)];
+    }
+    const std::optional<T>& slot(uint64_t index) const {
+        return slots[index & (slots.size() - 1)];
+    }
+
+    /// @returns the index of the first element at or after index, or End.
+    uint64_t nextLive(uint64_t index) const {
+        for (; index < tail; ++index) {
+            if (slot(index)) {
+                return index;
+            }
+        }
+        return End;
+    }
+
+    /// @returns the index of the last element before index (End meaning the
+    ///          last element of the container).
+    uint64_t prevLive(uint64_t index) const {
+        if (index == End) {
+            index = tail;
+        }
+        while (index != head) {
+            --index;
+            if (slot(index)) {
+                return index;
+            }
+        }
+        return End;
+    }
+
+    /// Double the capacity, keeping every element at its current index.
+    void grow() {
+        std::vector<std::optional<T>> newSlots(
+                std::max(InitialCapacity, slots.size() * 2));
+        const auto newMask = newSlots.size() - 1;
+        for (auto idx = head; idx != tail; ++idx) {
+            auto& elem = slot(idx);
+            if (elem) {
+                // Note: emplace as T may not be move-assignable.
+                newSlots[idx & newMask].emplace(std::move(*elem));
+            }
+        }
+        slots = std::move(newSlots);
+    }
+
+    /// Slots of the ring; the size is always zero or a power of two.
+    std::vector<std::optional<T>> slots;
+    /// Index of the first element (or tail if empty).
+    uint64_t head = Origin;
+    /// Index one past the last element.
+    uint64_t tail = Origin;
+    /// Number of elements (i.e. non-empty slots between head and tail).
+    size_t count = 0;
+};
+
+template <class T>
+template <bool Const>
+class TrackedWritesContainer<T>::Iterator {
+    using ContainerPtr = std::conditional_t<Const,
+                                            const TrackedWritesContainer*,
+                                            TrackedWritesContainer*>;
+
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    Iterator() = default;
+
+    /// Conversion from iterator to const_iterator.
+    template <bool C = Const, class = std::enable_if_t<C>>
+    Iterator(const Iterator<false>& other)
+        : container(other.container), index(other.index) {
+    }
+
+    reference operator*() const {
+        return *container->slot(index);
+    }
+
+    pointer operator->() const {
+        return &**this;
+    }
+
+    Iterator& operator++() {
+        index = container->nextLive(index + 1);
+        return *this;
+    }
+
+    Iterator operator++(int) {
+        auto ret = *this;
+        ++*this;
+        return ret;
+    }
+
+    Iterator& operator--() {
+        index = container->prevLive(index);
+        return *this;
+    }
+
+    Iterator operator--(int) {
+        auto ret = *this;
+        --*this;
+        return ret;
+    }
+
+    template <bool OtherConst>
+    bool operator==(const Iterator<OtherConst>& other) const {
+        return index == other.index && container == other.container;
+    }
+
+    template <bool OtherConst>
+    bool operator!=(const Iterator<OtherConst>& other) const {
+        return !(*this == other);
+    }
+
+private:
+    Iterator(ContainerPtr container, uint64_t index)
+        : container(container), index(index) {
+    }
+
+    friend class TrackedWritesContainer;
+    friend class Iterator<!Const>;
+
+    ContainerPtr container = nullptr;
+    uint64_t index = End;
+};
@@ -27,6 +27,8 @@
 #include "kvstore/kvstore.h"
 #include "kvstore/persistence_callback.h"
 #include "kvstore/kvstore_transaction_context.h"
+#include "range_scans/range_scan_create_task.h"
+#include "range_scans/range_scan_timeout_task.h"
 #include "replicationthrottle.h"
 #include "rollback_result.h"
 #include "tasks.h"
@@ -35,7 +37,9 @@
 #include "vbucket_state.h"
 #include "warmup.h"
 #include <executor/executorpool.h>
+#include <mcbp/protocol/unsigned_leb128.h>
 
+#include <platform/dirutils.h>
 #include <platform/timeutils.h>
 #include <statistics/cbstat_collector.h>
 #include <statistics/collector.h>
@@ -178,7 +182,10 @@ bool BloomFilterCallback::initTempFilter(Vbid vbucketId) {
         estimated_count = initial_estimation;
     }
 
-    vb->initTempFilter(estimated_count, config.getBfilterFpProb());
+    vb->initTempFilter(
+            estimated_count,
+            config.getBfilterFpProb(),
+            BloomFilter::layoutFromString(config.getBfilterLayout()));
 
     return true;
 }
@@ -215,6 +222,11 @@ public:
             bucket.setAccessScannerSleeptime(value, false);
         } else if (key == "alog_task_time") {
             bucket.resetAccessScannerStartTime();
+        } else if (key == "bgfetch_coalescing_max_window") {
+            bucket.setBgFetchCoalescingMaxWindow(
+                    std::chrono::microseconds(value));
+        } else if (key == "bgfetch_coalescing_batch_size") {
+            bucket.setBgFetchCoalescingBatchSize(value);
         } else {
             EP_LOG_WARN("Failed to change value for unknown variable, {}", key);
         }
@@ -239,7 +251,7 @@ private:
 };
 
 EPBucket::EPBucket(EventuallyPersistentEngine& theEngine)
-    : KVBucket(theEngine) {
+    : KVBucket(theEngine), readyRangeScans(*this) {
     auto& config = engine.getConfiguration();
     const std::string& policy = config.getItemEvictionPolicy();
     if (policy.compare("value_only") == 0) {
@@ -270,6 +282,15 @@ EPBucket::EPBucket(EventuallyPersistentEngine& theEngine)
     for (size_t i = 0; i < bgFetcherLimit; i++) {
         bgFetchers.emplace_back(std::make_unique<BgFetcher>(*this));
     }
+    setBgFetchCoalescingMaxWindow(
+            std::chrono::microseconds(config.getBgfetchCoalescingMaxWindow()));
+    config.addValueChangedListener(
+            "bgfetch_coalescing_max_window",
+            std::make_unique<ValueChangedListener>(*this));
+    setBgFetchCoalescingBatchSize(config.getBgfetchCoalescingBatchSize());
+    config.addValueChangedListener(
+            "bgfetch_coalescing_batch_size",
+            std::make_unique<ValueChangedListener>(*this));
 
     setFlusherBatchSplitTrigger(config.getFlusherTotalBatchLimit());
     config.addValueChangedListener(
@@ -318,6 +339,8 @@ void EPBucket::deinitialize() {
     stopFlusher();
     stopBgFetcher();
 
+    saveBloomFilters();
+
     KVBucket::deinitialize();
 
     // Perform a snapshot of the stats before shutting down so we can
@@ -335,6 +358,117 @@ void EPBucket::deinitialize() {
     });
 }
 
+/**
+ * HashTable visitor which adds the key of every item to the vBucket's bloom
+ * filter.
+ */
+class AddKeysToFilterVisitor : public HashTableVisitor {
+public:
+    explicit AddKeysToFilterVisitor(VBucket& vb) : vb(vb) {
+    }
+
+    bool visit(const HashTable::HashBucketLock& lh, StoredValue& v) override {
+        if (!v.isTempItem()) {
+            vb.addToFilter(v.getKey());
+        }
+        return true;
+    }
+
+private:
+    VBucket& vb;
+};
+
+std::string EPBucket::getBloomFilterPath(Vbid vbid) const {
+    return engine.getConfiguration().getDbname() + "/" +
+           std::to_string(vbid.get()) + ".bloomfilter";
+}
+
+void EPBucket::saveBloomFilters() {
+    auto& config = engine.getConfiguration();
+    if (!config.isBfilterEnabled() || !config.isBfilterPersist()) {
+        return;
+    }
+
+    for (auto vbid : vbMap.getBuckets()) {
+        auto vb = getVBucket(vbid);
+        if (!vb) {
+            continue;
+        }
+        if (getItemEvictionPolicy() == EvictionPolicy::Full) {
+            // With full eviction the filter only tracks keys which are not
+            // resident; after warmup any key may be non-resident so add the
+            // keys of all resident items.
+            AddKeysToFilterVisitor visitor(*vb);
+            vb->ht.visit(visitor);
+        }
+        const auto data = vb->serialiseFilter(vb->failovers->getLatestUUID(),
+                                              vb->getPersistenceSeqno());
+        if (data.empty()) {
+            continue;
+        }
+
+        // Write to a temporary file and rename, so a partially written
+        // filter is never picked up.
+        const auto fname = getBloomFilterPath(vbid);
+        const auto tmpName = fname + ".tmp";
+        FILE* file = fopen(tmpName.c_str(), "wb");
+        if (file == nullptr) {
+            EP_LOG_WARN("EPBucket::saveBloomFilters: Failed to open '{}': {}",
+                        tmpName,
+                        strerror(errno));
+            continue;
+        }
+        const bool written =
+                fwrite(data.data(), 1, data.size(), file) == data.size();
+        if (fclose(file) != 0 || !written ||
+            rename(tmpName.c_str(), fname.c_str()) != 0) {
+            EP_LOG_WARN("EPBucket::saveBloomFilters: Failed to write '{}': {}",
+                        fname,
+                        strerror(errno));
+            remove(tmpName.c_str());
+        }
+    }
+}
+
+void EPBucket::loadBloomFilter(VBucket& vb, uint64_t persistedSeqno) {
+    const auto fname = getBloomFilterPath(vb.getId());
+    if (!cb::io::isFile(fname)) {
+        return;
+    }
+
+    auto& config = engine.getConfiguration();
+    if (config.isBfilterEnabled() && config.isBfilterPersist()) {
+        try {
+            if (vb.restoreFilter(cb::io::loadFile(fname),
+                                 vb.failovers->getLatestUUID(),
+                                 persistedSeqno)) {
+                EP_LOG_INFO("{} Restored bloom filter from '{}'",
+                            vb.getId(),
+                            fname);
+            } else {
+                EP_LOG_INFO(
+                        "{} Ignoring bloom filter '{}' as it doesn't match "
+                        "the on-disk data",
+                        vb.getId(),
+                        fname);
+            }
+        } catch (const std::exception& e) {
+            EP_LOG_WARN(
+                    "EPBucket::loadBloomFilter: Failed to load '{}': {}",
+                    fname,
+                    e.what());
+        }
+    }
+
+    // The filter is only valid for the on-disk state at shutdown; remove it
+    // so it can never be applied to a later state.
+    if (remove(fname.c_str()) != 0) {
+        EP_LOG_WARN("EPBucket::loadBloomFilter: Failed to remove '{}': {}",
+                    fname,
+                    strerror(errno));
+    }
+}
+
 /**
  * @returns true if the item `candidate` can be de-duplicated (skipped) because
  * `lastFlushed` already supercedes it.
@@ -1011,6 +1145,19 @@ bool EPBucket::startBgFetcher() {
     return true;
 }
 
+void EPBucket::setBgFetchCoalescingMaxWindow(
+        std::chrono::microseconds window) {
+    for (const auto& bgFetcher : bgFetchers) {
+        bgFetcher->setCoalescingMaxWindow(window);
+    }
+}
+
+void EPBucket::setBgFetchCoalescingBatchSize(size_t size) {
+    for (const auto& bgFetcher : bgFetchers) {
+        bgFetcher->setCoalescingBatchSize(size);
+    }
+}
+
 void EPBucket::stopBgFetcher() {
     EP_LOG_INFO_RAW("Stopping bg fetchers");
 
@@ -2246,6 +2393,271 @@ bool EPBucket::isByIdScanSupported() const {
     return getStorageProperties().hasByIdScan();
 }
 
+std::pair<cb::engine_errc, cb::rangescan::Id> EPBucket::createRangeScan(
+        Vbid vbid,
+        const CookieIface* cookie,
+        CollectionID cid,
+        std::optional<std::string_view> start,
+        std::optional<std::string_view> end,
+        cb::rangescan::KeyOnly keyOnly,
+        std::optional<cb::rangescan::SamplingConfiguration> samplingConfig) {
+    // This is the second call for the cookie once the RangeScanCreateTask
+    // has created the scan, collect its id
+    if (engine.getEngineSpecific(cookie)) {
+        engine.storeEngineSpecific(cookie, nullptr);
+        auto locked = createdRangeScans.wlock();
+        auto itr = locked->find(cookie);
+        if (itr == locked->end()) {
+            // Discarded by the RangeScanTimeoutTask
+            return {cb::engine_errc::failed, {}};
+        }
+        const auto id = itr->second.id;
+        locked->erase(itr);
+        return {cb::engine_errc::success, id};
+    }
+
+    auto vb = getVBucket(vbid);
+    if (!vb) {
+        return {cb::engine_errc::not_my_vbucket, {}};
+    }
+
+    folly::SharedMutex::ReadHolder rlh(vb->getStateLock());
+    if (vb->getState() != vbucket_state_active) {
+        return {cb::engine_errc::not_my_vbucket, {}};
+    }
+
+    size_t collectionItemCount = 0;
+    {
+        auto cHandle = vb->lockCollections();
+        if (!cHandle.exists(cid)) {
+            engine.setUnknownCollectionErrorContext(cookie,
+                                                    cHandle.getManifestUid());
+            return {cb::engine_errc::unknown_collection, {}};
+        }
+        collectionItemCount = cHandle.getItemCount(cid);
+    }
+
+    // The start/end of the collection in the by-id index. Like
+    // DCPBackfillByIdDisk the end key is the collection prefix with the
+    // last (stop) byte incremented.
+    cb::mcbp::unsigned_leb128<CollectionIDType> prefix(uint32_t{cid});
+    std::array<uint8_t,
+               cb::mcbp::unsigned_leb128<CollectionIDType>::getMaxSize()>
+            prefixEnd;
+    std::copy(prefix.begin(), prefix.end(), prefixEnd.begin());
+    prefixEnd[prefix.size() - 1]++;
+
+    DiskDocKey startKey =
+            start ? DiskDocKey{StoredDocKey{std::string{*start}, cid}}
+                  : DiskDocKey{{prefix.data(),
+                                prefix.size(),
+                                DocKeyEncodesCollectionId::Yes}};
+    DiskDocKey endKey =
+            end ? DiskDocKey{StoredDocKey{std::string{*end}, cid}}
+                : DiskDocKey{{prefixEnd.data(),
+                              prefix.size(),
+                              DocKeyEncodesCollectionId::Yes}};
+    if (!(startKey < endKey)) {
+        return {cb::engine_errc::invalid_arguments, {}};
+    }
+
+    // Opening the scan context reads from disk, so it's done on an AuxIO
+    // thread
+    ExecutorPool::get()->schedule(std::make_shared<RangeScanCreateTask>(
+            *this,
+            vbid,
+            cookie,
+            cid,
+            std::move(startKey),
+            std::move(endKey),
+            keyOnly,
+            getValueFilterForCompressionMode(cookie),
+            samplingConfig,
+            collectionItemCount));
+    return {cb::engine_errc::would_block, {}};
+}
+
+cb::engine_errc EPBucket::continueRangeScan(
+        Vbid vbid,
+        const cb::rangescan::Id& id,
+        const CookieIface* cookie,
+        const cb::rangescan::ContinueLimits& limits,
+        cb::mcbp::Status& status,
+        std::string& data) {
+    auto vb = getVBucket(vbid);
+    if (!vb) {
+        return cb::engine_errc::not_my_vbucket;
+    }
+
+    auto& rangeScans = static_cast<EPVBucket&>(*vb).getRangeScans();
+    auto scan = rangeScans.getScan(id);
+    if (!scan) {
+        return cb::engine_errc::no_such_key;
+    }
+    const auto rv = checkRangeScanAccess(*scan, cookie);
+    if (rv != cb::engine_errc::success) {
+        return rv;
+    }
+
+    if (scan->takeContinueResult(*cookie, status, data)) {
+        if (status != cb::mcbp::Status::RangeScanMore) {
+            // Complete, cancelled or failed; nothing more to continue
+            rangeScans.eraseScan(id);
+        }
+        return cb::engine_errc::success;
+    }
+
+    // Never buffer more than the configured maximum for a single continue
+    auto continueLimits = limits;
+    const auto maxBytes =
+            engine.getConfiguration().getRangeScanMaxContinueBytes();
+    continueLimits.bytes = continueLimits.bytes
+                                   ? std::min(continueLimits.bytes, maxBytes)
+                                   : maxBytes;
+
+    const auto prepared = scan->prepareToContinue(*cookie, continueLimits);
+    if (prepared != cb::engine_errc::success) {
+        return prepared;
+    }
+    readyRangeScans.addScan(std::move(scan));
+    return cb::engine_errc::would_block;
+}
+
+cb::engine_errc EPBucket::cancelRangeScan(Vbid vbid,
+                                          const cb::rangescan::Id& id,
+                                          const CookieIface* cookie) {
+    auto vb = getVBucket(vbid);
+    if (!vb) {
+        return cb::engine_errc::not_my_vbucket;
+    }
+
+    auto& rangeScans = static_cast<EPVBucket&>(*vb).getRangeScans();
+    auto scan = rangeScans.getScan(id);
+    if (!scan) {
+        return cb::engine_errc::no_such_key;
+    }
+    const auto rv = checkRangeScanAccess(*scan, cookie);
+    if (rv != cb::engine_errc::success) {
+        return rv;
+    }
+
+    // A scan with a continue in progress is removed once the continue
+    // returns RangeScanCancelled
+    if (scan->cancel()) {
+        rangeScans.eraseScan(id);
+    }
+    return cb::engine_errc::success;
+}
+
+cb::engine_errc EPBucket::checkRangeScanAccess(const RangeScan& scan,
+                                               const CookieIface* cookie) {
+    // A scan is only visible to the connection which created it
+    if (scan.getConnectionId() != cookie->getConnectionId()) {
+        return cb::engine_errc::no_such_key;
+    }
+    // The privileges of the connection may have changed since the create
+    return engine.checkPrivilege(
+            cookie, cb::rbac::Privilege::Read, scan.getCollectionID());
+}
+
+void EPBucket::setCreatedRangeScan(const CookieIface* cookie,
+                                   cb::rangescan::Id id) {
+    createdRangeScans.wlock()->insert_or_assign(
+            cookie,
+            CreatedRangeScan{id, cookie->getConnectionId(), ep_current_time()});
+    // The engine specific only flags that the scan was created, see
+    // createdRangeScans
+    engine.storeEngineSpecific(cookie, this);
+}
+
+void EPBucket::cancelRangeScansForConnection(uint32_t connectionId) {
+    cancelRangeScans([connectionId](const RangeScan& scan) {
+        return scan.getConnectionId() == connectionId;
+    });
+    createdRangeScans.withWLock([connectionId](auto& created) {
+        for (auto itr = created.begin(); itr != created.end();) {
+            if (itr->second.connectionId == connectionId) {
+                itr = created.erase(itr);
+            } else {
+                ++itr;
+            }
+        }
+    });
+}
+
+size_t EPBucket::cancelIdleRangeScans() {
+    const auto timeout = engine.getConfiguration().getRangeScanIdleTimeout();
+    const auto now = ep_current_time();
+    if (now < timeout) {
+        return 0;
+    }
+    const rel_time_t idleSince = now - timeout;
+    const auto cancelled = cancelRangeScans([idleSince](const RangeScan& scan) {
+        return scan.isIdleSince(idleSince);
+    });
+    // The id of a scan created for a connection which disconnected before
+    // the create completed is never collected
+    createdRangeScans.withWLock([idleSince](auto& created) {
+        for (auto itr = created.begin(); itr != created.end();) {
+            if (itr->second.created < idleSince) {
+                itr = created.erase(itr);
+            } else {
+                ++itr;
+            }
+        }
+    });
+    if (cancelled) {
+        EP_LOG_INFO("EPBucket::cancelIdleRangeScans: cancelled {} scans idle "
+                    "for more than {}s",
+                    cancelled,
+                    timeout);
+    }
+    return cancelled;
+}
+
+size_t EPBucket::cancelRangeScans(
+        const std::function<bool(const RangeScan&)>& predicate) {
+    if (numRangeScans == 0) {
+        return 0;
+    }
+
+    size_t cancelled = 0;
+    for (auto vbid : vbMap.getBuckets()) {
+        auto vb = getVBucket(vbid);
+        if (vb) {
+            auto& rangeScans = static_cast<EPVBucket&>(*vb).getRangeScans();
+            cancelled += rangeScans.cancelScans(predicate);
+        }
+    }
+    return cancelled;
+}
+
+void EPBucket::scheduleRangeScanTimeoutTask() {
+    bool expected = false;
+    if (rangeScanTimeoutTaskScheduled.compare_exchange_strong(expected,
+                                                              true)) {
+        ExecutorPool::get()->schedule(
+                std::make_shared<RangeScanTimeoutTask>(*this));
+    }
+}
+
+bool EPBucket::hasRangeScans() const {
+    return numRangeScans || !createdRangeScans.rlock()->empty();
+}
+
+bool EPBucket::rangeScanTimeoutTaskShouldRun() {
+    if (hasRangeScans()) {
+        return true;
+    }
+    rangeScanTimeoutTaskScheduled = false;
+    // A scan created since the check above may have found the task still
+    // scheduled; keep running for it unless it scheduled a new task.
+    bool expected = false;
+    return hasRangeScans() &&
+           rangeScanTimeoutTaskScheduled.compare_exchange_strong(expected,
+                                                                 true);
+}
+
 bool EPBucket::isValidBucketDurabilityLevel(cb::durability::Level level) const {
     switch (level) {
     case cb::durability::Level::None:
@@ -13,6 +13,7 @@
 
 #include "kv_bucket.h"
 #include "kvstore/kvstore.h"
+#include "range_scans/range_scan_owner.h"
 #include "utilities/testing_hook.h"
 
 class BgFetcher;
@@ -82,6 +83,11 @@ public:
 
     size_t getFlusherBatchSplitTrigger();
 
+    /// Set the coalescing window of the BgFetchers (see
+    /// BgFetcher::getCoalescingWindow)
+    void setBgFetchCoalescingMaxWindow(std::chrono::microseconds window);
+    void setBgFetchCoalescingBatchSize(size_t size);
+
     /**
      * Persist whatever flush-batch previously queued into KVStore.
      *
@@ -223,6 +229,67 @@ public:
         return true;
     }
 
+    std::pair<cb::engine_errc, cb::rangescan::Id> createRangeScan(
+            Vbid vbid,
+            const CookieIface* cookie,
+            CollectionID cid,
+            std::optional<std::string_view> start,
+            std::optional<std::string_view> end,
+            cb::rangescan::KeyOnly keyOnly,
+            std::optional<cb::rangescan::SamplingConfiguration> samplingConfig)
+            override;
+
+    cb::engine_errc continueRangeScan(
+            Vbid vbid,
+            const cb::rangescan::Id& id,
+            const CookieIface* cookie,
+            const cb::rangescan::ContinueLimits& limits,
+            cb::mcbp::Status& status,
+            std::string& data) override;
+
+    cb::engine_errc cancelRangeScan(Vbid vbid,
+                                    const cb::rangescan::Id& id,
+                                    const CookieIface* cookie) override;
+
+    void cancelRangeScansForConnection(uint32_t connectionId) override;
+
+    ReadyRangeScans& getReadyRangeScans() {
+        return readyRangeScans;
+    }
+
+    /// @return the number of RangeScan objects in the bucket
+    std::atomic<size_t>& getNumRangeScans() {
+        return numRangeScans;
+    }
+
+    /**
+     * Record the id of the scan a RangeScanCreateTask created for the cookie,
+     * for createRangeScan to return once the cookie is notified.
+     */
+    void setCreatedRangeScan(const CookieIface* cookie, cb::rangescan::Id id);
+
+    /**
+     * Schedule the RangeScanTimeoutTask (called when a scan is created), if
+     * it isn't already scheduled.
+     */
+    void scheduleRangeScanTimeoutTask();
+
+    /**
+     * Called by the RangeScanTimeoutTask after each run.
+     *
+     * @return true if the task should run again, false if the bucket has no
+     *         more range scans (a new task is scheduled for the next scan)
+     */
+    bool rangeScanTimeoutTaskShouldRun();
+
+    /**
+     * Cancel the range scans which have been idle for longer than
+     * range_scan_idle_timeout.
+     *
+     * @return the number of scans cancelled
+     */
+    size_t cancelIdleRangeScans();
+
     void setRetainErroneousTombstones(bool value) {
         retainErroneousTombstones = value;
     }
@@ -282,6 +349,17 @@ public:
             const CookieIface* cookie,
             std::unique_ptr<Collections::Manifest>& newManifest) override;
 
+    /**
+     * Restore the bloom filter of the given (warming up) vBucket from the
+     * file written at the last shutdown, if bloom filter persistence is
+     * enabled and the file matches the vBucket's on-disk state. The file is
+     * removed whether or not it could be used.
+     *
+     * @param vb vBucket to restore the filter of
+     * @param persistedSeqno high seqno of the vBucket's on-disk data
+     */
+    void loadBloomFilter(VBucket& vb, uint64_t persistedSeqno);
+
     BgFetcher& getBgFetcher(Vbid vbid);
     Flusher* getFlusher(Vbid vbid);
 
@@ -379,6 +457,16 @@ protected:
      */
     void initializeShards();
 
+    /**
+     * Write the bloom filter of each vBucket to disk (if bloom filter
+     * persistence is enabled), for loadBloomFilter() to restore at warmup.
+     * Must be called once the flusher has been stopped.
+     */
+    void saveBloomFilters();
+
+    /// @returns the path of the persisted bloom filter of the given vBucket.
+    std::string getBloomFilterPath(Vbid vbid) const;
+
     /**
      * Schedule a new CompactTask or request any existing task is rescheduled
      */
@@ -420,6 +508,51 @@ protected:
     folly::Synchronized<std::unordered_map<Vbid, std::shared_ptr<CompactTask>>>
             compactionTasks;
 
+    /**
+     * Cancel the range scans (of every vBucket) which match the predicate.
+     *
+     * @return the number of scans cancelled
+     */
+    size_t cancelRangeScans(
+            const std::function<bool(const RangeScan&)>& predicate);
+
+    /// The range scans waiting for a RangeScanContinueTask
+    ReadyRangeScans readyRangeScans;
+
+    /// The number of RangeScan objects, so that the vBuckets are only
+    /// visited to cancel scans when there are some
+    std::atomic<size_t> numRangeScans{0};
+
+    /// @return true if there are scans (or created scan ids) to time out
+    bool hasRangeScans() const;
+
+    /**
+     * Check the connection may continue / cancel the scan: it must be the
+     * connection which created the scan, and still have the Read privilege
+     * for the scanned collection.
+     */
+    cb::engine_errc checkRangeScanAccess(const RangeScan& scan,
+                                         const CookieIface* cookie);
+
+    struct CreatedRangeScan {
+        cb::rangescan::Id id;
+        uint32_t connectionId;
+        rel_time_t created;
+    };
+    /**
+     * The ids of the scans created by a RangeScanCreateTask which the cookie
+     * hasn't collected yet. They're kept here rather than in the cookie's
+     * engine specific so an id isn't leaked if the connection goes away
+     * before collecting it; such ids are discarded when the connection
+     * disconnects or by the RangeScanTimeoutTask.
+     */
+    folly::Synchronized<
+            std::unordered_map<const CookieIface*, CreatedRangeScan>>
+            createdRangeScans;
+
+    /// Is a RangeScanTimeoutTask scheduled
+    std::atomic<bool> rangeScanTimeoutTaskScheduled{false};
+
     /**
      * Testing hook called from EPBucket::compactionCompletionCallback function
      * before we update the stats.
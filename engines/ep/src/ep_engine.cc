@@ -38,6 +38,7 @@
 #include "hash_table_stat_visitor.h"
 #include "htresizer.h"
 #include "kvstore/kvstore.h"
+#include "range_scans/range_scan_types.h"
 #include "replicationthrottle.h"
 #include "server_document_iface_border_guard.h"
 #include "stats-info.h"
@@ -64,6 +65,7 @@
 #include <memcached/util.h>
 #include <nlohmann/json.hpp>
 #include <phosphor/phosphor.h>
+#include <platform/base64.h>
 #include <platform/cb_arena_malloc.h>
 #include <platform/checked_snprintf.h>
 #include <platform/compress.h>
@@ -291,6 +293,30 @@ cb::EngineErrorItemPair EventuallyPersistentEngine::get(
     return acquireEngine(this)->getInner(&cookie, key, vbucket, options);
 }
 
+cb::engine_errc EventuallyPersistentEngine::get_multi(
+        const CookieIface& cookie,
+        const std::vector<DocKey>& keys,
+        Vbid vbucket,
+        DocStateFilter documentStateFilter,
+        std::vector<cb::EngineErrorItemPair>& results) {
+    auto options = static_cast<get_options_t>(
+            QUEUE_BG_FETCH | HONOR_STATES | TRACK_REFERENCE | DELETE_TEMP |
+            HIDE_LOCKED_CAS | TRACK_STATISTICS);
+
+    switch (documentStateFilter) {
+    case DocStateFilter::Alive:
+        break;
+    case DocStateFilter::Deleted:
+        // See get()
+        return cb::engine_errc::not_supported;
+    case DocStateFilter::AliveOrDeleted:
+        options = static_cast<get_options_t>(options | GET_DELETED_VALUE);
+        break;
+    }
+    return acquireEngine(this)->getMultiInner(
+            &cookie, keys, vbucket, options, results);
+}
+
 cb::EngineErrorItemPair EventuallyPersistentEngine::get_if(
         const CookieIface& cookie,
         const DocKey& key,
@@ -623,6 +649,16 @@ cb::engine_errc EventuallyPersistentEngine::setFlushParam(
             getConfiguration().setExpPagerStime(std::stoull(val));
         } else if (key == "exp_pager_initial_run_time") {
             getConfiguration().setExpPagerInitialRunTime(std::stoll(val));
+        } else if (key == "bgfetch_coalescing_max_window") {
+            getConfiguration().setBgfetchCoalescingMaxWindow(std::stoull(val));
+        } else if (key == "bgfetch_coalescing_batch_size") {
+            getConfiguration().setBgfetchCoalescingBatchSize(std::stoull(val));
+        } else if (key == "range_scan_idle_timeout") {
+            getConfiguration().setRangeScanIdleTimeout(std::stoull(val));
+        } else if (key == "range_scan_max_continue_bytes") {
+            getConfiguration().setRangeScanMaxContinueBytes(std::stoull(val));
+        } else if (key == "range_scan_max_continue_tasks") {
+            getConfiguration().setRangeScanMaxContinueTasks(std::stoull(val));
         } else if (key == "flusher_total_batch_limit") {
             getConfiguration().setFlusherTotalBatchLimit(std::stoll(val));
         } else if (key == "getl_default_timeout") {
@@ -639,6 +675,8 @@ cb::engine_errc EventuallyPersistentEngine::setFlushParam(
             getConfiguration().setAccessScannerEnabled(cb_stob(val));
         } else if (key == "alog_path") {
             getConfiguration().setAlogPath(val);
+        } else if (key == "alog_format") {
+            getConfiguration().setAlogFormat(val);
         } else if (key == "alog_max_stored_items") {
             getConfiguration().setAlogMaxStoredItems(std::stoull(val));
         } else if (key == "alog_resident_ratio_threshold") {
@@ -1180,6 +1218,12 @@ cb::engine_errc EventuallyPersistentEngine::processUnknownCommandInner(
         return getRandomKey(cookie, request, response);
     case cb::mcbp::ClientOpcode::GetKeys:
         return getAllKeys(cookie, request, response);
+    case cb::mcbp::ClientOpcode::RangeScanCreate:
+        return createRangeScan(cookie, request, response);
+    case cb::mcbp::ClientOpcode::RangeScanContinue:
+        return continueRangeScan(cookie, request, response);
+    case cb::mcbp::ClientOpcode::RangeScanCancel:
+        return cancelRangeScan(cookie, request, response);
     default:
         res = cb::mcbp::Status::UnknownCommand;
     }
@@ -2154,6 +2198,9 @@ cb::engine_errc EventuallyPersistentEngine::initialize(
     } else if (!flowCtlPolicy.compare("aggressive")) {
         dcpFlowControlManager_ =
                 std::make_unique<DcpFlowControlManagerAggressive>(*this);
+    } else if (!flowCtlPolicy.compare("adaptive")) {
+        dcpFlowControlManager_ =
+                std::make_unique<DcpFlowControlManagerAdaptive>(*this);
     } else {
         /* Flow control is not enabled */
         dcpFlowControlManager_ = std::make_unique<DcpFlowControlManager>(*this);
@@ -2403,6 +2450,47 @@ cb::EngineErrorItemPair EventuallyPersistentEngine::getInner(
     return cb::makeEngineErrorItemPair(cb::engine_errc(ret));
 }
 
+cb::engine_errc EventuallyPersistentEngine::getMultiInner(
+        const CookieIface* cookie,
+        const std::vector<DocKey>& keys,
+        Vbid vbucket,
+        get_options_t options,
+        std::vector<cb::EngineErrorItemPair>& results) {
+    ScopeTimer<HdrMicroSecStopwatch, TracerStopwatch> timer(
+            std::forward_as_tuple(stats.getCmdHisto),
+            std::forward_as_tuple(cookie, cb::tracing::Code::Get));
+
+    std::vector<GetValue> values;
+    auto ret = kvBucket->getMulti(keys, vbucket, cookie, options, values);
+    if (ret != cb::engine_errc::success &&
+        ret != cb::engine_errc::would_block) {
+        if (ret == cb::engine_errc::not_my_vbucket && isDegradedMode()) {
+            return cb::engine_errc::temporary_failure;
+        }
+        return ret;
+    }
+
+    results.clear();
+    results.reserve(values.size());
+    for (auto& gv : values) {
+        const auto status = gv.getStatus();
+        if (status == cb::engine_errc::success) {
+            if (options & TRACK_STATISTICS) {
+                ++stats.numOpsGet;
+            }
+            results.emplace_back(cb::makeEngineErrorItemPair(
+                    cb::engine_errc::success, gv.item.release(), this));
+        } else if (status == cb::engine_errc::no_such_key &&
+                   isDegradedMode()) {
+            results.emplace_back(cb::makeEngineErrorItemPair(
+                    cb::engine_errc::temporary_failure));
+        } else {
+            results.emplace_back(cb::makeEngineErrorItemPair(status));
+        }
+    }
+    return ret;
+}
+
 cb::EngineErrorItemPair EventuallyPersistentEngine::getAndTouchInner(
         const CookieIface* cookie,
         const DocKey& key,
@@ -3577,6 +3665,22 @@ cb::engine_errc EventuallyPersistentEngine::doHashStats(
                         buf.data(), buf.size(), "vb_%d:resized", vbid.get());
                 add_casted_stat(
                         buf.data(), vb.ht.getNumResizes(), add_stat, cookie);
+                checked_snprintf(buf.data(),
+                                 buf.size(),
+                                 "vb_%d:resize_migrated",
+                                 vbid.get());
+                add_casted_stat(buf.data(),
+                                vb.ht.getNumResizeMigratedBuckets(),
+                                add_stat,
+                                cookie);
+                checked_snprintf(buf.data(),
+                                 buf.size(),
+                                 "vb_%d:resize_pending",
+                                 vbid.get());
+                add_casted_stat(buf.data(),
+                                vb.ht.getNumResizePendingBuckets(),
+                                add_stat,
+                                cookie);
                 checked_snprintf(
                         buf.data(), buf.size(), "vb_%d:mem_size", vbid.get());
                 add_casted_stat(
@@ -6381,6 +6485,153 @@ cb::engine_errc EventuallyPersistentEngine::getAllKeys(
     return cb::engine_errc::would_block;
 }
 
+/**
+ * The value of a RangeScanCreate request is a JSON object:
+ *
+ *     {"collection": "<hex cid, default 0>",
+ *      "key_only": <bool, default false>,
+ *      "range": {"start": "<base64 key>", "end": "<base64 key>"},
+ *      "sampling": {"samples": <count>, "seed": <uint32>}}
+ *
+ * Both "start" (inclusive) and "end" (exclusive) are optional and default to
+ * the start and end of the collection. "range" and "sampling" are mutually
+ * exclusive.
+ */
+cb::engine_errc EventuallyPersistentEngine::createRangeScan(
+        const CookieIface* cookie,
+        const cb::mcbp::Request& request,
+        const AddResponseFn& response) {
+    CollectionID cid = CollectionID::Default;
+    auto keyOnly = cb::rangescan::KeyOnly::No;
+    std::optional<std::string> start;
+    std::optional<std::string> end;
+    std::optional<cb::rangescan::SamplingConfiguration> sampling;
+
+    const auto decodeKey = [](const nlohmann::json& json) {
+        const auto decoded = cb::base64::decode(json.get<std::string>());
+        return std::string{decoded.begin(), decoded.end()};
+    };
+
+    try {
+        const auto json = nlohmann::json::parse(request.getValueString());
+        if (json.contains("collection")) {
+            cid = makeCollectionID(json["collection"].get<std::string>());
+        }
+        if (json.value("key_only", false)) {
+            keyOnly = cb::rangescan::KeyOnly::Yes;
+        }
+        if (json.contains("range") && json.contains("sampling")) {
+            setErrorContext(cookie,
+                            "range and sampling are mutually exclusive");
+            return cb::engine_errc::invalid_arguments;
+        }
+        if (json.contains("range")) {
+            const auto& range = json["range"];
+            if (range.contains("start")) {
+                start = decodeKey(range["start"]);
+            }
+            if (range.contains("end")) {
+                end = decodeKey(range["end"]);
+            }
+        }
+        if (json.contains("sampling")) {
+            const auto& config = json["sampling"];
+            sampling = cb::rangescan::SamplingConfiguration{
+                    config.at("samples").get<size_t>(),
+                    config.value("seed", uint32_t{0})};
+            if (sampling->samples == 0) {
+                setErrorContext(cookie, "sampling.samples must be non-zero");
+                return cb::engine_errc::invalid_arguments;
+            }
+        }
+    } catch (const std::exception& e) {
+        setErrorContext(cookie,
+                        std::string{"Invalid range scan configuration: "} +
+                                e.what());
+        return cb::engine_errc::invalid_arguments;
+    }
+
+    auto rv = checkPrivilege(cookie, cb::rbac::Privilege::Read, cid);
+    if (rv != cb::engine_errc::success) {
+        return rv;
+    }
+
+    auto [status, id] = getKVBucket()->createRangeScan(request.getVBucket(),
+                                                       cookie,
+                                                       cid,
+                                                       start,
+                                                       end,
+                                                       keyOnly,
+                                                       sampling);
+    if (status != cb::engine_errc::success) {
+        return status;
+    }
+
+    return sendResponse(response,
+                        {}, // key
+                        {}, // extra
+                        {reinterpret_cast<const char*>(id.data()), id.size()},
+                        PROTOCOL_BINARY_RAW_BYTES,
+                        cb::mcbp::Status::Success,
+                        0,
+                        cookie);
+}
+
+cb::engine_errc EventuallyPersistentEngine::continueRangeScan(
+        const CookieIface* cookie,
+        const cb::mcbp::Request& request,
+        const AddResponseFn& response) {
+    const auto& payload = request.getCommandSpecifics<
+            cb::mcbp::request::RangeScanContinuePayload>();
+    cb::rangescan::Id id;
+    std::copy(payload.getId().begin(), payload.getId().end(), id.begin());
+
+    const cb::rangescan::ContinueLimits limits{
+            payload.getItemLimit(),
+            std::chrono::milliseconds(payload.getTimeLimit()),
+            payload.getByteLimit()};
+
+    auto status = cb::mcbp::Status::Success;
+    std::string data;
+    auto rv = getKVBucket()->continueRangeScan(
+            request.getVBucket(), id, cookie, limits, status, data);
+    if (rv != cb::engine_errc::success) {
+        return rv;
+    }
+
+    return sendResponse(response,
+                        {}, // key
+                        {}, // extra
+                        data,
+                        PROTOCOL_BINARY_RAW_BYTES,
+                        status,
+                        0,
+                        cookie);
+}
+
+cb::engine_errc EventuallyPersistentEngine::cancelRangeScan(
+        const CookieIface* cookie,
+        const cb::mcbp::Request& request,
+        const AddResponseFn& response) {
+    const auto extras = request.getExtdata();
+    cb::rangescan::Id id;
+    std::copy(extras.begin(), extras.end(), id.begin());
+
+    auto rv = getKVBucket()->cancelRangeScan(request.getVBucket(), id, cookie);
+    if (rv != cb::engine_errc::success) {
+        return rv;
+    }
+
+    return sendResponse(response,
+                        {}, // key
+                        {}, // extra
+                        {}, // body
+                        PROTOCOL_BINARY_RAW_BYTES,
+                        cb::mcbp::Status::Success,
+                        0,
+                        cookie);
+}
+
 ConnectionPriority EventuallyPersistentEngine::getDCPPriority(
         const CookieIface* cookie) {
     NonBucketAllocationGuard guard;
@@ -6547,6 +6798,9 @@ ConnHandler& EventuallyPersistentEngine::getConnHandler(
 
 void EventuallyPersistentEngine::handleDisconnect(const CookieIface* cookie) {
     dcpConnMap_->disconnect(cookie);
+    if (kvBucket) {
+        kvBucket->cancelRangeScansForConnection(cookie->getConnectionId());
+    }
 }
 
 void EventuallyPersistentEngine::initiate_shutdown() {
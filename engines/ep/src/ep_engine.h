@@ -128,6 +128,12 @@ public:
                                 const DocKey& key,
                                 Vbid vbucket,
                                 DocStateFilter documentStateFilter) override;
+    cb::engine_errc get_multi(
+            const CookieIface& cookie,
+            const std::vector<DocKey>& keys,
+            Vbid vbucket,
+            DocStateFilter documentStateFilter,
+            std::vector<cb::EngineErrorItemPair>& results) override;
     cb::EngineErrorItemPair get_if(
             const CookieIface& cookie,
             const DocKey& key,
@@ -433,6 +439,13 @@ public:
                                      Vbid vbucket,
                                      get_options_t options);
 
+    cb::engine_errc getMultiInner(
+            const CookieIface* cookie,
+            const std::vector<DocKey>& keys,
+            Vbid vbucket,
+            get_options_t options,
+            std::vector<cb::EngineErrorItemPair>& results);
+
     /**
      * Fetch an item only if the specified filter predicate returns true.
      *
@@ -525,6 +538,18 @@ public:
                                const cb::mcbp::Request& request,
                                const AddResponseFn& response);
 
+    cb::engine_errc createRangeScan(const CookieIface* cookie,
+                                    const cb::mcbp::Request& request,
+                                    const AddResponseFn& response);
+
+    cb::engine_errc continueRangeScan(const CookieIface* cookie,
+                                      const cb::mcbp::Request& request,
+                                      const AddResponseFn& response);
+
+    cb::engine_errc cancelRangeScan(const CookieIface* cookie,
+                                    const cb::mcbp::Request& request,
+                                    const AddResponseFn& response);
+
     ConnectionPriority getDCPPriority(const CookieIface* cookie);
 
     void setDCPPriority(const CookieIface* cookie, ConnectionPriority priority);
@@ -868,6 +893,14 @@ public:
                                    std::optional<ScopeID> sid,
                                    std::optional<CollectionID> cid) const;
 
+    /**
+     * Check the access for the given privilege for the collection (setting
+     * the error context if the collection is unknown)
+     */
+    cb::engine_errc checkPrivilege(const CookieIface* cookie,
+                                   cb::rbac::Privilege priv,
+                                   CollectionID) const;
+
     /**
      * Test the access for the given privilege for the bucket.scope.collection
      * This differs from checkPrivilege in that the error case has no side
@@ -920,10 +953,6 @@ protected:
                                        Vbid vbid,
                                        bool sync);
 
-    cb::engine_errc checkPrivilege(const CookieIface* cookie,
-                                   cb::rbac::Privilege priv,
-                                   CollectionID) const;
-
     /**
      * Check the access for the given privilege for the given key
      */
@@ -37,6 +37,16 @@
 #include <folly/lang/Assume.h>
 #include <platform/histogram.h>
 
+static std::unique_ptr<AbstractStoredValueFactory> makeStoredValueFactory(
+        EPStats& st, Configuration& config) {
+    const auto maxInlineValueSize = config.getHtInlineValueMaxSize();
+    if (maxInlineValueSize) {
+        return std::make_unique<InlineValueStoredValueFactory>(
+                st, maxInlineValueSize);
+    }
+    return std::make_unique<StoredValueFactory>(st);
+}
+
 EPVBucket::EPVBucket(Vbid i,
                      vbucket_state_t newState,
                      EPStats& st,
@@ -73,7 +83,7 @@ EPVBucket::EPVBucket(Vbid i,
               lastSnapEnd,
               std::move(table),
               flusherCb,
-              std::make_unique<StoredValueFactory>(st),
+              makeStoredValueFactory(st, config),
               std::move(newSeqnoCb),
               syncWriteResolvedCb,
               syncWriteCb,
@@ -797,6 +807,59 @@ void EPVBucket::bgFetch(HashTable::HashBucketLock&& hbl,
                  uint64_t(bgfetch_size));
 }
 
+std::vector<cb::engine_errc> EPVBucket::bgFetchMulti(
+        const std::vector<DocKey>& keys,
+        const CookieIface* cookie,
+        EventuallyPersistentEngine& engine) {
+    std::vector<cb::engine_errc> status(keys.size(),
+                                        cb::engine_errc::would_block);
+    // The index of the key and the token (cas of the SV) to fetch it with
+    std::vector<std::pair<size_t, uint64_t>> fetches;
+    fetches.reserve(keys.size());
+    for (size_t ii = 0; ii < keys.size(); ++ii) {
+        auto res = ht.findOnlyCommitted(keys[ii]);
+        if (res.storedValue) {
+            fetches.emplace_back(ii, res.storedValue->getCas());
+            continue;
+        }
+        auto rv = addTempStoredValue(res.lock, keys[ii]);
+        switch (rv.status) {
+        case TempAddStatus::NoMem:
+            status[ii] = cb::engine_errc::no_memory;
+            break;
+        case TempAddStatus::BgFetch:
+            fetches.emplace_back(ii, rv.storedValue->getCas());
+            break;
+        }
+    }
+
+    if (fetches.empty()) {
+        return status;
+    }
+
+    // Add all of the fetches under a single acquisition of the lock so that
+    // the BgFetcher picks them all up in the same batch, and notify the
+    // cookie once when the last one completes.
+    const auto filter = dynamic_cast<EPBucket&>(*bucket)
+                                .getValueFilterForCompressionMode(cookie);
+    auto group = std::make_shared<BGFetchNotifyGroup>(fetches.size());
+    const auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lh(pendingBGFetchesLock);
+        for (const auto& [index, token] : fetches) {
+            auto fetch = std::make_unique<FrontEndBGFetchItem>(
+                    now, filter, cookie, token);
+            fetch->notifyGroup = group;
+            pendingBGFetches[DiskDocKey{keys[index], /*pending*/ false}]
+                    .addBgFetch(std::move(fetch));
+        }
+    }
+    getBgFetcher().addPendingVB(getId(), fetches.size());
+    EP_LOG_DEBUG("Queued {} background fetches for a batched get",
+                 fetches.size());
+    return status;
+}
+
 /* [TBD]: Get rid of std::unique_lock<std::mutex> lock */
 cb::engine_errc EPVBucket::addTempItemAndBGFetch(
         HashTable::HashBucketLock&& hbl,
@@ -11,6 +11,7 @@
 #pragma once
 
 #include "dcp/backfill_by_seqno_disk.h"
+#include "range_scans/range_scan_owner.h"
 #include "vbucket.h"
 #include "vbucket_bgfetch_item.h"
 
@@ -61,6 +62,11 @@ public:
             const FrontEndBGFetchItem& fetched_item,
             const std::chrono::steady_clock::time_point startTime) override;
 
+    std::vector<cb::engine_errc> bgFetchMulti(
+            const std::vector<DocKey>& keys,
+            const CookieIface* cookie,
+            EventuallyPersistentEngine& engine) override;
+
     /**
      * Expire an item found during compaction that required a BGFetch
      *
@@ -268,6 +274,15 @@ public:
 
     void notifyFlusher() override;
 
+    void cancelRangeScans() override {
+        rangeScans.cancelAllScans();
+    }
+
+    /// @return the range scans of this vBucket
+    VB::RangeScanOwner& getRangeScans() {
+        return rangeScans;
+    }
+
 protected:
     /**
      * queue a background fetch of the specified item.
@@ -393,5 +408,8 @@ private:
      */
     std::atomic<uint64_t> deferredDeletionFileRevision;
 
+    /// The range scans created on this vBucket
+    VB::RangeScanOwner rangeScans;
+
     friend class EPVBucketTest;
 };
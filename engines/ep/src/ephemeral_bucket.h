@@ -132,6 +132,35 @@ public:
         return false;
     }
 
+    std::pair<cb::engine_errc, cb::rangescan::Id> createRangeScan(
+            Vbid,
+            const CookieIface*,
+            CollectionID,
+            std::optional<std::string_view>,
+            std::optional<std::string_view>,
+            cb::rangescan::KeyOnly,
+            std::optional<cb::rangescan::SamplingConfiguration>) override {
+        return {cb::engine_errc::not_supported, {}};
+    }
+
+    cb::engine_errc continueRangeScan(Vbid,
+                                      const cb::rangescan::Id&,
+                                      const CookieIface*,
+                                      const cb::rangescan::ContinueLimits&,
+                                      cb::mcbp::Status&,
+                                      std::string&) override {
+        return cb::engine_errc::not_supported;
+    }
+
+    cb::engine_errc cancelRangeScan(Vbid,
+                                    const cb::rangescan::Id&,
+                                    const CookieIface*) override {
+        return cb::engine_errc::not_supported;
+    }
+
+    void cancelRangeScansForConnection(uint32_t) override {
+    }
+
     bool isByIdScanSupported() const override {
         return false;
     }
@@ -865,6 +865,15 @@ void EphemeralVBucket::bgFetch(HashTable::HashBucketLock&& hbl,
             std::string(reinterpret_cast<const char*>(key.data()), key.size()));
 }
 
+std::vector<cb::engine_errc> EphemeralVBucket::bgFetchMulti(
+        const std::vector<DocKey>& keys,
+        const CookieIface* cookie,
+        EventuallyPersistentEngine& engine) {
+    throw std::logic_error(
+            "EphemeralVBucket::bgFetchMulti() is not valid. Called on " +
+            getId().to_string());
+}
+
 cb::engine_errc EphemeralVBucket::addTempItemAndBGFetch(
         HashTable::HashBucketLock&& hbl,
         const DocKey& key,
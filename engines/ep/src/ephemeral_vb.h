@@ -54,6 +54,11 @@ public:
             const FrontEndBGFetchItem& fetched_item,
             const std::chrono::steady_clock::time_point startTime) override;
 
+    std::vector<cb::engine_errc> bgFetchMulti(
+            const std::vector<DocKey>& keys,
+            const CookieIface* cookie,
+            EventuallyPersistentEngine& engine) override;
+
     void resetStats() override;
 
     vb_bgfetch_queue_t getBGFetchItems() override;
@@ -77,6 +77,41 @@ std::string to_string(MutationStatus status) {
     return "<invalid>(" + std::to_string(int(status)) + ")";
 }
 
+HashTable::Layout HashTable::layoutFromString(std::string_view layout) {
+    if (layout == "chained") {
+        return Layout::Chained;
+    }
+    if (layout == "tag_groups") {
+        return Layout::TagGroups;
+    }
+    throw std::invalid_argument(
+            "HashTable::layoutFromString: unknown layout '" +
+            std::string(layout) + "'");
+}
+
+HashTable::ResizeAlgorithm HashTable::resizeAlgorithmFromString(
+        std::string_view algo) {
+    if (algo == "blocking") {
+        return ResizeAlgorithm::Blocking;
+    }
+    if (algo == "incremental") {
+        return ResizeAlgorithm::Incremental;
+    }
+    throw std::invalid_argument(
+            "HashTable::resizeAlgorithmFromString: unknown algorithm '" +
+            std::string(algo) + "'");
+}
+
+std::string to_string(HashTable::Layout layout) {
+    switch (layout) {
+    case HashTable::Layout::Chained:
+        return "chained";
+    case HashTable::Layout::TagGroups:
+        return "tag_groups";
+    }
+    return "<invalid>(" + std::to_string(int(layout)) + ")";
+}
+
 std::ostream& operator<<(std::ostream& os, const HashTable::Position& pos) {
     os << "{lock:" << pos.lock << " bucket:" << pos.hash_bucket << "/" << pos.ht_size << "}";
     return os;
@@ -151,9 +186,13 @@ StoredValue* HashTable::FindUpdateResult::selectSVForRead(
 HashTable::HashTable(EPStats& st,
                      std::unique_ptr<AbstractStoredValueFactory> svFactory,
                      size_t initialSize,
-                     size_t locks)
+                     size_t locks,
+                     Layout layout,
+                     ResizeAlgorithm resizeAlgorithm)
     : initialSize(initialSize),
       size(initialSize),
+      layout(layout),
+      resizeAlgorithm(resizeAlgorithm),
       mutexes(locks),
       stats(st),
       valFact(std::move(svFactory)),
@@ -163,7 +202,12 @@ HashTable::HashTable(EPStats& st,
       numResizes(0),
       maxDeletedRevSeqno(0),
       probabilisticCounter(freqCounterIncFactor) {
+    // Start at a size which allows the first resize to be incremental.
+    size = alignSizeForResize(initialSize);
     values.resize(size);
+    if (layout == Layout::TagGroups) {
+        tagGroups.resize(size);
+    }
     activeState = true;
 }
 
@@ -190,6 +234,7 @@ void HashTable::clear(bool deactivate) {
                     "non-active object");
         }
     }
+    std::lock_guard<std::mutex> resizeGuard(resizeMutex);
     MultiLockHolder mlh(mutexes);
     clear_UNLOCKED(deactivate);
 }
@@ -199,6 +244,15 @@ void HashTable::clear_UNLOCKED(bool deactivate) {
         setActiveState(false);
     }
 
+    // Any elements not yet migrated by an incremental resize need to be
+    // cleared as well; just move them into the new table first.
+    if (isResizeInProgress()) {
+        for (size_t i = 0; i < oldSize; i++) {
+            migrateBucket_UNLOCKED(i);
+        }
+        finishIncrementalResize_UNLOCKED();
+    }
+
     // Account collection sizes so we can adjust the collection mem_used
     std::unordered_map<CollectionID, size_t> memUsedAdjustment;
     for (auto& chain : values) {
@@ -215,6 +269,9 @@ void HashTable::clear_UNLOCKED(bool deactivate) {
 
         chain.reset();
     }
+    for (auto& group : tagGroups) {
+        group.clear();
+    }
 
     for (const auto& [cid, size] : memUsedAdjustment) {
         // Note: can't capture a structured binding, but can if we explicitly
@@ -248,6 +305,11 @@ static bool isCurrently(size_t size, ssize_t a, ssize_t b) {
 
 void HashTable::resize() {
     size_t ni = getNumInMemoryItems();
+    if (layout == Layout::TagGroups) {
+        // Each bucket's tag group indexes multiple items; size for that
+        // higher load factor.
+        ni /= tagGroupLoadFactor;
+    }
     int i(0);
     size_t new_size(0);
 
@@ -265,7 +327,9 @@ void HashTable::resize() {
         new_size = initialSize;
     } else if (0 == i) {
         new_size = prime_size_table[i];
-    }else if (isCurrently(size, prime_size_table[i-1], prime_size_table[i])) {
+    } else if (isCurrently(size,
+                           alignSizeForResize(prime_size_table[i - 1]),
+                           alignSizeForResize(prime_size_table[i]))) {
         // If one of the candidate sizes is the current size, maintain
         // the current size in order to remain stable.
         new_size = size;
@@ -274,7 +338,7 @@ void HashTable::resize() {
         new_size = nearest(ni, prime_size_table[i-1], prime_size_table[i]);
     }
 
-    resize(new_size);
+    resize(alignSizeForResize(new_size));
 }
 
 void HashTable::resize(size_t newSize) {
@@ -289,11 +353,28 @@ void HashTable::resize(size_t newSize) {
         return;
     }
 
-    // Don't resize to the same size, either.
+    std::lock_guard<std::mutex> resizeGuard(resizeMutex);
+
+    // Don't resize to the same size, either. This includes the target size
+    // of an in-progress incremental resize, which is left for
+    // migrateBuckets() to complete a batch at a time.
     if (newSize == size) {
         return;
     }
 
+    // Only one resize may be in progress at once; complete any previous
+    // incremental resize first.
+    completeIncrementalResize();
+
+    if (resizeAlgorithm == ResizeAlgorithm::Incremental &&
+        (size % mutexes.size()) == 0 && (newSize % mutexes.size()) == 0) {
+        beginIncrementalResize(newSize);
+    } else {
+        blockingResize(newSize);
+    }
+}
+
+void HashTable::blockingResize(size_t newSize) {
     TRACE_EVENT2(
             "HashTable", "resize", "size", size.load(), "newSize", newSize);
 
@@ -313,11 +394,11 @@ void HashTable::resize(size_t newSize) {
     ++numResizes;
 
     // Set the new size so all the hashy stuff works.
-    size_t oldSize = size;
+    const size_t prevSize = size;
     size.store(newSize);
 
     // Move existing records into the new space.
-    for (size_t i = 0; i < oldSize; i++) {
+    for (size_t i = 0; i < prevSize; i++) {
         while (values[i]) {
             // unlink the front element from the hash chain at values[i].
             auto v = std::move(values[i]);
@@ -333,9 +414,138 @@ void HashTable::resize(size_t newSize) {
     // Finally assign the new table to values.
     values = std::move(newValues);
 
+    if (layout == Layout::TagGroups) {
+        tagGroups = std::vector<HashTableTagGroup>(newSize);
+        for (size_t i = 0; i < newSize; i++) {
+            rebuildTagGroup(i);
+        }
+    }
+
     stats.coreLocal.get()->memOverhead.fetch_add(memorySize());
 }
 
+void HashTable::beginIncrementalResize(size_t newSize) {
+    TRACE_EVENT2("HashTable",
+                 "beginIncrementalResize",
+                 "size",
+                 size.load(),
+                 "newSize",
+                 newSize);
+
+    // Allocate the new table before acquiring the locks; the only work
+    // performed with all locks held is swapping the tables over.
+    table_type newValues(newSize);
+    std::vector<uint8_t> newBucketMigrated(size);
+    std::vector<HashTableTagGroup> newTagGroups;
+    if (layout == Layout::TagGroups) {
+        newTagGroups.resize(newSize);
+    }
+
+    MultiLockHolder mlh(mutexes);
+    if (visitors.load() > 0) {
+        // As per blockingResize(), do not start a resize while any visitors
+        // are in progress as they may have already visited some of the
+        // buckets in the old table.
+        return;
+    }
+
+    stats.coreLocal.get()->memOverhead.fetch_sub(memorySize());
+    ++numResizes;
+
+    oldValues = std::move(values);
+    values = std::move(newValues);
+    bucketMigrated = std::move(newBucketMigrated);
+    tagGroups = std::move(newTagGroups);
+    numMigratedBuckets = 0;
+    nextBucketToMigrate = 0;
+    oldSize.store(size);
+    size.store(newSize);
+
+    stats.coreLocal.get()->memOverhead.fetch_add(memorySize());
+}
+
+void HashTable::migrateBucket_UNLOCKED(size_t oldBucket) {
+    if (bucketMigrated[oldBucket]) {
+        return;
+    }
+
+    auto& chain = oldValues[oldBucket];
+    while (chain) {
+        // unlink the front element from the old hash chain and re-link it
+        // into the correct place in the new table.
+        auto v = std::move(chain);
+        chain = std::move(v->getNext());
+
+        const auto newBucket = getBucketForHash(v->getKey().hash());
+        v->setNext(std::move(values[newBucket]));
+        values[newBucket] = std::move(v);
+        tagGroupInsert(newBucket, values[newBucket].get().get());
+    }
+    bucketMigrated[oldBucket] = 1;
+    ++numMigratedBuckets;
+}
+
+void HashTable::migrateBucketsForLock(size_t lock) {
+    for (size_t bucket = lock;; bucket += mutexes.size()) {
+        HashBucketLock hbl(bucket, mutexes[lock]);
+        // Re-check under the lock; the resize may have completed.
+        if (bucket >= oldSize) {
+            return;
+        }
+        migrateBucket_UNLOCKED(bucket);
+    }
+}
+
+bool HashTable::migrateBuckets(size_t limit) {
+    std::lock_guard<std::mutex> resizeGuard(resizeMutex);
+    if (!isResizeInProgress()) {
+        return false;
+    }
+
+    for (size_t migrated = 0;
+         migrated < limit && nextBucketToMigrate < oldSize;
+         ++migrated, ++nextBucketToMigrate) {
+        auto hbl = getLockedBucket(nextBucketToMigrate);
+        migrateBucket_UNLOCKED(nextBucketToMigrate);
+    }
+
+    if (numMigratedBuckets < oldSize) {
+        return true;
+    }
+
+    MultiLockHolder mlh(mutexes);
+    finishIncrementalResize_UNLOCKED();
+    return false;
+}
+
+void HashTable::completeIncrementalResize() {
+    if (!isResizeInProgress()) {
+        return;
+    }
+    for (; nextBucketToMigrate < oldSize; ++nextBucketToMigrate) {
+        auto hbl = getLockedBucket(nextBucketToMigrate);
+        migrateBucket_UNLOCKED(nextBucketToMigrate);
+    }
+    MultiLockHolder mlh(mutexes);
+    finishIncrementalResize_UNLOCKED();
+}
+
+void HashTable::finishIncrementalResize_UNLOCKED() {
+    stats.coreLocal.get()->memOverhead.fetch_sub(memorySize());
+    oldSize.store(0);
+    table_type().swap(oldValues);
+    std::vector<uint8_t>().swap(bucketMigrated);
+    stats.coreLocal.get()->memOverhead.fetch_add(memorySize());
+}
+
+size_t HashTable::alignSizeForResize(size_t newSize) const {
+    if (resizeAlgorithm != ResizeAlgorithm::Incremental) {
+        return newSize;
+    }
+    const auto locks = mutexes.size();
+    return ((newSize + locks - 1) / locks) * locks;
+}
+
 HashTable::FindInnerResult HashTable::findInner(const DocKey& key) {
     if (!isActive()) {
         throw std::logic_error(
@@ -347,8 +557,7 @@ HashTable::FindInnerResult HashTable::findInner(const DocKey& key) {
     // and Pending items with the same key.
     StoredValue* foundCmt = nullptr;
     StoredValue* foundPend = nullptr;
-    for (StoredValue* v = values[hbl.getBucketNum()].get().get(); v;
-         v = v->getNext().get().get()) {
+    auto checkKey = [&key, &foundCmt, &foundPend](StoredValue* v) {
         if (v->hasKey(key)) {
             if (v->isPending() || v->isPrepareCompleted()) {
                 Expects(!foundPend);
@@ -358,8 +567,24 @@ HashTable::FindInnerResult HashTable::findInner(const DocKey& key) {
                 foundCmt = v;
             }
         }
+    };
+
+    const auto bucket = hbl.getBucketNum();
+    if (layout == Layout::TagGroups && !tagGroups[bucket].isOverflowed()) {
+        // All StoredValues in this bucket are indexed by the tag group; only
+        // need to check the key of those with a matching tag.
+        const auto& group = tagGroups[bucket];
+        for (auto cand = group.match(HashTableTagGroup::tagForHash(key.hash()));
+             cand;
+             cand &= cand - 1) {
+            checkKey(group.get(folly::findFirstSet(cand) - 1));
+        }
+    } else {
+        for (StoredValue* v = values[bucket].get().get(); v;
+             v = v->getNext().get().get()) {
+            checkKey(v);
+        }
     }
-
     return {std::move(hbl), foundCmt, foundPend};
 }
 
@@ -523,7 +748,9 @@ StoredValue* HashTable::unlocked_addNewStoredValue(const HashBucketLock& hbl,
     valueStats.epilogue(emptyProperties, v.get().get());
 
     values[hbl.getBucketNum()] = std::move(v);
-    return values[hbl.getBucketNum()].get().get();
+    auto* added = values[hbl.getBucketNum()].get().get();
+    tagGroupInsert(hbl.getBucketNum(), added);
+    return added;
 }
 
 HashTable::Statistics::StoredValueProperties::StoredValueProperties(
@@ -831,7 +1058,9 @@ HashTable::unlocked_replaceByCopy(const HashBucketLock& hbl,
     valueStats.epilogue(emptyProperties, newSv.get().get());
 
     values[hbl.getBucketNum()] = std::move(newSv);
-    return {values[hbl.getBucketNum()].get().get(), std::move(releasedSv)};
+    auto* added = values[hbl.getBucketNum()].get().get();
+    tagGroupInsert(hbl.getBucketNum(), added);
+    return {added, std::move(releasedSv)};
 }
 
 HashTable::DeleteResult HashTable::unlocked_softDelete(
@@ -1093,6 +1322,7 @@ StoredValue::UniquePtr HashTable::unlocked_release(
                 "HashTable::unlocked_release_base: StoredValue to be released "
                 "not found in HashTable; possibly HashTable leak");
     }
+    tagGroupErase(hbl.getBucketNum(), released.get().get());
 
     // Update statistics for the item which is now gone.
     const auto preProps = valueStats.prologue(released.get().get());
@@ -1162,13 +1392,13 @@ MutationStatus HashTable::insertFromWarmup(const Item& itm,
 
 bool HashTable::reallocateStoredValue(StoredValue&& sv) {
     // Search the chain and reallocate
-    for (StoredValue::UniquePtr* curr =
-                 &values[getBucketForHash(sv.getKey().hash())];
-         curr->get().get();
+    const auto bucket = getBucketForHash(sv.getKey().hash());
+    for (StoredValue::UniquePtr* curr = &values[bucket]; curr->get().get();
          curr = &curr->get()->getNext()) {
         if (&sv == curr->get().get()) {
             auto newSv = valFact->copyStoredValue(sv, std::move(sv.getNext()));
             curr->swap(newSv);
+            tagGroupReplace(bucket, &sv, curr->get().get());
             return true;
         }
     }
@@ -1182,13 +1412,15 @@ void HashTable::dump() const {
 nlohmann::json HashTable::dumpStoredValuesAsJson() const {
     MultiLockHolder mlh(mutexes);
     auto obj = nlohmann::json::array();
-    for (const auto& chain : values) {
-        if (chain) {
-            for (StoredValue* sv = chain.get().get(); sv != nullptr;
-                 sv = sv->getNext().get().get()) {
-                std::stringstream ss;
-                ss << sv->getKey();
-                obj.push_back(*sv);
+    for (const auto* table : {&values, &oldValues}) {
+        for (const auto& chain : *table) {
+            if (chain) {
+                for (StoredValue* sv = chain.get().get(); sv != nullptr;
+                     sv = sv->getNext().get().get()) {
+                    std::stringstream ss;
+                    ss << sv->getKey();
+                    obj.push_back(*sv);
+                }
             }
         }
     }
@@ -1224,6 +1456,9 @@ void HashTable::visitDepth(HashTableDepthVisitor &visitor) {
     lh.unlock();
 
     for (int l = 0; l < static_cast<int>(mutexes.size()); l++) {
+        if (isResizeInProgress()) {
+            migrateBucketsForLock(l);
+        }
         for (int i = l; i < static_cast<int>(size); i+= mutexes.size()) {
             // (re)acquire mutex on each HashBucket, to minimise any impact
             // on front-end threads.
@@ -1285,6 +1520,11 @@ HashTable::Position HashTable::pauseResumeVisit(HashTableVisitor& visitor,
     size_t hash_bucket = 0;
 
     for (; isActive() && !paused && lock < mutexes.size(); lock++) {
+        // Ensure all elements guarded by this lock are in the new table
+        // before visiting it.
+        if (isResizeInProgress()) {
+            migrateBucketsForLock(lock);
+        }
 
         // If the bucket position is *this* lock, then start from the
         // recorded bucket (as long as we haven't resized).
@@ -1366,6 +1606,7 @@ bool HashTable::unlocked_ejectItem(const HashTable::HashBucketLock&,
         auto removed = hashChainRemoveFirst(
                 values[bucket_num],
                 [vptr](const StoredValue* v) { return v == vptr; });
+        tagGroupErase(bucket_num, vptr);
 
         if (removed->isResident()) {
             ++stats.numValueEjects;
@@ -1383,16 +1624,25 @@ bool HashTable::unlocked_ejectItem(const HashTable::HashBucketLock&,
 
 std::unique_ptr<Item> HashTable::getRandomKey(CollectionID cid,
                                               const HashBucketLock& hbl) {
-    for (StoredValue* v = values.at(hbl.getBucketNum()).get().get(); v;
-         v = v->getNext().get().get()) {
-        if (!v->isTempItem() && !v->isDeleted() && v->isResident() &&
-            !v->isPending() && !v->isPrepareCompleted() &&
-            v->getKey().getCollectionID() == cid) {
-            return v->toItem(Vbid(0));
+    auto searchChain = [cid](StoredValue* chain) -> std::unique_ptr<Item> {
+        for (StoredValue* v = chain; v; v = v->getNext().get().get()) {
+            if (!v->isTempItem() && !v->isDeleted() && v->isResident() &&
+                !v->isPending() && !v->isPrepareCompleted() &&
+                v->getKey().getCollectionID() == cid) {
+                return v->toItem(Vbid(0));
+            }
         }
-    }
+        return nullptr;
+    };
 
-    return nullptr;
+    const size_t bucket = hbl.getBucketNum();
+    auto item = searchChain(values.at(bucket).get().get());
+    // During an incremental resize the old bucket with the same index is
+    // guarded by the same lock; search it too.
+    if (!item && bucket < oldSize) {
+        item = searchChain(oldValues[bucket].get().get());
+    }
+    return item;
 }
 
 bool HashTable::unlocked_restoreValue(
@@ -1434,6 +1684,45 @@ void HashTable::unlocked_restoreMeta(const std::unique_lock<std::mutex>& htLock,
     valueStats.epilogue(preProps, &v);
 }
 
+void HashTable::tagGroupInsert(size_t bucket, StoredValue* sv) {
+    if (layout != Layout::TagGroups) {
+        return;
+    }
+    tagGroups[bucket].insert(
+            HashTableTagGroup::tagForHash(sv->getKey().hash()), sv);
+}
+
+void HashTable::tagGroupErase(size_t bucket, const StoredValue* sv) {
+    if (layout != Layout::TagGroups) {
+        return;
+    }
+    auto& group = tagGroups[bucket];
+    group.erase(HashTableTagGroup::tagForHash(sv->getKey().hash()), sv);
+    if (group.isOverflowed()) {
+        // Chain may now fit in the group again.
+        rebuildTagGroup(bucket);
+    }
+}
+
+void HashTable::tagGroupReplace(size_t bucket,
+                                const StoredValue* from,
+                                StoredValue* to) {
+    if (layout != Layout::TagGroups) {
+        return;
+    }
+    tagGroups[bucket].replace(
+            HashTableTagGroup::tagForHash(to->getKey().hash()), from, to);
+}
+
+void HashTable::rebuildTagGroup(size_t bucket) {
+    auto& group = tagGroups[bucket];
+    group.clear();
+    for (StoredValue* v = values[bucket].get().get(); v;
+         v = v->getNext().get().get()) {
+        group.insert(HashTableTagGroup::tagForHash(v->getKey().hash()), v);
+    }
+}
+
 uint8_t HashTable::generateFreqValue(uint8_t counter) {
     return probabilisticCounter.generateValue(counter);
 }
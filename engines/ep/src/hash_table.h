@@ -12,6 +12,7 @@
 #pragma once
 
 #include "copyable_atomic.h"
+#include "hash_table_tag_group.h"
 #include "probabilistic_counter.h"
 #include "stored-value.h"
 #include "storeddockey.h"
@@ -135,10 +136,26 @@ enum class DeletionDurability : uint8_t {};
  * bucket; then chaining is used (StoredValue::chain_next_or_replacement) to
  * handle any collisions.
  *
- * The HashTable can be resized if it grows too full - this is done by
- * acquiring all the ht_locks, and then allocating a new vector of buckets and
- * re-hashing all elements into the new table. While resizing is occuring all
- * other access to the HashTable is blocked.
+ * The HashTable can be resized if it grows too full. How this is done depends
+ * on the ResizeAlgorithm:
+ *
+ * - Blocking: acquire all the ht_locks, allocate a new vector of buckets and
+ *   re-hash all elements into the new table. While resizing is occuring all
+ *   other access to the HashTable is blocked.
+ *
+ * - Incremental: the new vector of buckets is installed (briefly acquiring
+ *   all ht_locks, but without moving any elements) and the old vector is
+ *   retained as `oldValues`. Elements are then migrated one old bucket at a
+ *   time: on demand by any operation which locks a key's bucket (the key's
+ *   old bucket is migrated first), by visitors (which migrate each lock's
+ *   old buckets before visiting it) and by the HashtableResizerTask via
+ *   migrateBuckets(). Once every old bucket has been migrated the old vector
+ *   is released. No operation is blocked for longer than a single bucket
+ *   migration.
+ *   This relies on both the old and new sizes being a multiple of the number
+ *   of ht_locks - a key's old and new buckets are then guarded by the same
+ *   mutex. Sizes are rounded up to a multiple of the number of locks to
+ *   allow this; if that is not possible the blocking algorithm is used.
  *
  * Support for holding both Committed and Pending items requires that we
  * can represent having for each key, either:
@@ -152,9 +169,62 @@ enum class DeletionDurability : uint8_t {};
  * field. If both Pending or Committed items are present then the Pending item
  * is the first one in the chain; the StoredValue::committed flag is used to
  * distinguish between them.
+ *
+ * Layouts
+ * -------
+ *
+ * By default (Layout::Chained) a lookup walks the bucket's hash chain,
+ * comparing the key of each StoredValue - which typically costs one cache
+ * miss per chained element.
+ *
+ * With Layout::TagGroups each bucket additionally has a cache-line sized
+ * HashTableTagGroup holding a short hash tag and a pointer for each
+ * StoredValue in the chain. A lookup compares all the tags in one SIMD
+ * operation and then only dereferences StoredValues with a matching tag.
+ * As a group can index several StoredValues, the table is sized for a higher
+ * load factor (tagGroupLoadFactor items per bucket) which keeps the memory
+ * overhead similar to the Chained layout. The hash chain still owns the
+ * StoredValues (and is what visitors, resize etc operate on); Committed and
+ * Pending items for the same key share a tag and both appear in the group.
  */
 class HashTable {
 public:
+    /// Layout of the per-bucket index; see "Layouts" above.
+    enum class Layout : uint8_t {
+        /// Lookups walk the hash chain.
+        Chained,
+        /// Lookups use a per-bucket HashTableTagGroup.
+        TagGroups,
+    };
+
+    /**
+     * Target average number of StoredValues per bucket for the TagGroups
+     * layout. Kept below HashTableTagGroup::Slots so that only a small
+     * fraction of buckets overflow their group.
+     */
+    static constexpr size_t tagGroupLoadFactor = 4;
+
+    /**
+     * Convert the "ht_layout" configuration string to a Layout.
+     * @throws std::invalid_argument for an unknown layout.
+     */
+    static Layout layoutFromString(std::string_view layout);
+
+    /// How the HashTable is resized; see "Implementation" above.
+    enum class ResizeAlgorithm : uint8_t {
+        /// Rehash the entire table with all ht_locks held.
+        Blocking,
+        /// Migrate elements into the new table one bucket at a time.
+        Incremental,
+    };
+
+    /**
+     * Convert the "ht_resize_algorithm" configuration string to a
+     * ResizeAlgorithm.
+     * @throws std::invalid_argument for an unknown algorithm.
+     */
+    static ResizeAlgorithm resizeAlgorithmFromString(std::string_view algo);
+
     /**
      * Datatype counts; one element for each combination of datatypes
      * (e.g. JSON, JSON+XATTR, JSON+Snappy, etc...)
@@ -394,20 +464,33 @@ public:
      * @param svFactory Factory to use for constructing stored values
      * @param initialSize the number of hash table buckets to initially create.
      * @param locks the number of locks in the hash table
+     * @param layout the per-bucket index layout to use
+     * @param resizeAlgorithm how to resize the hash table
      */
     HashTable(EPStats& st,
               std::unique_ptr<AbstractStoredValueFactory> svFactory,
               size_t initialSize,
-              size_t locks);
+              size_t locks,
+              Layout layout = Layout::Chained,
+              ResizeAlgorithm resizeAlgorithm = ResizeAlgorithm::Blocking);
 
     ~HashTable();
 
     size_t memorySize() {
         return sizeof(HashTable)
             + (size * sizeof(StoredValue*))
+            + (tagGroups.size() * sizeof(HashTableTagGroup))
+            + (oldValues.size() * (sizeof(StoredValue*) + sizeof(uint8_t)))
             + (mutexes.size() * sizeof(std::mutex));
     }
 
+    /**
+     * Get the per-bucket index layout of this hash table.
+     */
+    Layout getLayout() const {
+        return layout;
+    }
+
     /**
      * Get the number of hash table buckets this hash table has.
      */
@@ -569,9 +652,50 @@ public:
 
     /**
      * Resize to the specified size.
+     *
+     * With ResizeAlgorithm::Incremental this only starts the resize (if a
+     * previous incremental resize is still in progress it is completed
+     * first); the size reported by getSize() changes immediately but the
+     * elements are migrated later - see migrateBuckets().
      */
     void resize(size_t to);
 
+    /**
+     * Migrate up to the given number of buckets of an in-progress
+     * incremental resize; releasing the old table once all buckets have been
+     * migrated. Each bucket is migrated under its own ht_lock.
+     *
+     * @param limit maximum number of old buckets to migrate
+     * @return true if the resize is still in progress (more buckets remain
+     *         to be migrated), false if no resize is in progress.
+     */
+    bool migrateBuckets(size_t limit);
+
+    /**
+     * @return true if an incremental resize is in progress.
+     */
+    bool isResizeInProgress() const {
+        return oldSize.load() != 0;
+    }
+
+    /**
+     * Get the number of buckets migrated so far by the in-progress
+     * incremental resize (zero if none in progress).
+     */
+    size_t getNumResizeMigratedBuckets() const {
+        return isResizeInProgress() ? numMigratedBuckets.load() : 0;
+    }
+
+    /**
+     * Get the number of buckets still to be migrated by the in-progress
+     * incremental resize (zero if none in progress).
+     */
+    size_t getNumResizePendingBuckets() const {
+        const auto total = oldSize.load();
+        const auto migrated = numMigratedBuckets.load();
+        return total > migrated ? total - migrated : 0;
+    }
+
     /**
      * Result of the findForRead() method.
      */
@@ -1331,6 +1455,12 @@ protected:
             int bucket = getBucketForHash(h);
             HashBucketLock rv(bucket, mutexes[mutexForBucket(bucket)]);
             if (bucket == getBucketForHash(h)) {
+                if (isResizeInProgress()) {
+                    // The key may still be in its old bucket (guarded by
+                    // the same mutex); move it into the new table.
+                    migrateBucket_UNLOCKED(
+                            abs(h % static_cast<int>(oldSize)));
+                }
                 return rv;
             }
         }
@@ -1393,6 +1523,29 @@ protected:
     // in `values`
     std::atomic<size_t> size;
     table_type values;
+    const Layout layout;
+    // For Layout::TagGroups, the tag group of each element in `values`;
+    // empty for Layout::Chained.
+    std::vector<HashTableTagGroup> tagGroups;
+
+    const ResizeAlgorithm resizeAlgorithm;
+    // Serialises resize operations (starting, progressing and completing an
+    // incremental resize; blocking resizes). Acquired before any ht_lock.
+    std::mutex resizeMutex;
+    // State of an in-progress incremental resize. oldValues, oldSize and
+    // bucketMigrated are only modified with all ht_locks held; each element
+    // of oldValues / bucketMigrated is guarded by the ht_lock of its bucket.
+    table_type oldValues;
+    // Number of buckets in oldValues; zero if no incremental resize is in
+    // progress.
+    std::atomic<size_t> oldSize{0};
+    // Non-zero for each bucket of oldValues which has been migrated. (Bytes
+    // rather than vector<bool> so buckets under different locks can be
+    // updated concurrently.)
+    std::vector<uint8_t> bucketMigrated;
+    std::atomic<size_t> numMigratedBuckets{0};
+    // Next old bucket migrateBuckets() will attempt; guarded by resizeMutex.
+    size_t nextBucketToMigrate{0};
     // Mutable so that we can make dumpStoredValuesAsJson const
     mutable std::vector<std::mutex> mutexes;
     EPStats&             stats;
@@ -1533,12 +1686,69 @@ protected:
      */
     void updateFreqCounter(StoredValue& v);
 
+    /**
+     * Functions to keep tagGroups in sync with the hash chains; no-ops for
+     * Layout::Chained. Must be called with the bucket's ht_lock held, after
+     * the chain has been modified.
+     */
+    void tagGroupInsert(size_t bucket, StoredValue* sv);
+    void tagGroupErase(size_t bucket, const StoredValue* sv);
+    void tagGroupReplace(size_t bucket,
+                         const StoredValue* from,
+                         StoredValue* to);
+
+    /// Rebuild the tagGroup of the given bucket from its hash chain.
+    void rebuildTagGroup(size_t bucket);
+
+    /**
+     * Round the given size up to a size which supports incremental resize
+     * (a multiple of the number of locks). Returns size unchanged for
+     * ResizeAlgorithm::Blocking.
+     */
+    size_t alignSizeForResize(size_t size) const;
+
+    /// Blocking resize; caller must hold resizeMutex.
+    void blockingResize(size_t newSize);
+
+    /**
+     * Start an incremental resize to newSize, installing a new (empty) table.
+     * Caller must hold resizeMutex.
+     */
+    void beginIncrementalResize(size_t newSize);
+
+    /**
+     * Migrate all elements of the given old bucket into the new table (if
+     * not already migrated). Caller must hold the old bucket's ht_lock (which
+     * is also the lock of every new bucket the elements move to).
+     */
+    void migrateBucket_UNLOCKED(size_t oldBucket);
+
+    /**
+     * Migrate all old buckets guarded by the given lock, acquiring it for
+     * each bucket in turn.
+     */
+    void migrateBucketsForLock(size_t lock);
+
+    /**
+     * Migrate all remaining old buckets and release the old table. Caller
+     * must hold resizeMutex.
+     */
+    void completeIncrementalResize();
+
+    /**
+     * Release the old table; all buckets must have been migrated. Caller must
+     * hold all ht_locks.
+     */
+    void finishIncrementalResize_UNLOCKED();
+
     DISALLOW_COPY_AND_ASSIGN(HashTable);
     friend class HashTableBench;
 };
 
 std::ostream& operator<<(std::ostream& os, const HashTable& ht);
 
+std::string to_string(HashTable::Layout layout);
+
 /**
  * Base class for visiting a hash table.
  */
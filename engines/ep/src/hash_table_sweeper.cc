@@ -0,0 +1,135 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "hash_table_sweeper.h"
+#include "bucket_logger.h"
+#include "ep_engine.h"
+#include "kv_bucket.h"
+#include "vb_visitors.h"
+#include <executor/executorpool.h>
+#include <phosphor/phosphor.h>
+
+#include <algorithm>
+#include <limits>
+
+HashTableSweeperTask::HashTableSweeperTask(EventuallyPersistentEngine* e)
+    : GlobalTask(e, TaskId::HashTableSweeperTask, 0, false),
+      epstore_position(engine->getKVBucket()->startPosition()) {
+}
+
+HashTableSweeperTask::~HashTableSweeperTask() = default;
+
+void HashTableSweeperTask::addParticipant(
+        std::shared_ptr<HashTableSweepParticipant> participant) {
+    participants.push_back(std::move(participant));
+}
+
+bool HashTableSweeperTask::run() {
+    TRACE_EVENT0("ep-engine/task", "HashTableSweeperTask");
+    if (prAdapter || startSweep()) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto deadline = start + getChunkDuration();
+        for (auto* participant : sweepParticipants) {
+            participant->prepareSweepChunk(deadline);
+        }
+
+        epstore_position = engine->getKVBucket()->pauseResumeVisit(
+                *prAdapter, epstore_position);
+        const auto end = std::chrono::steady_clock::now();
+
+        const bool completed =
+                (epstore_position == engine->getKVBucket()->endPosition());
+        for (auto* participant : sweepParticipants) {
+            participant->completeSweepChunk(completed);
+        }
+
+        EP_LOG_DEBUG(
+                "{} for bucket '{}' {} with {} participants. Took {} us.",
+                getDescription(),
+                engine->getName(),
+                completed ? "finished" : "paused",
+                sweepParticipants.size(),
+                std::chrono::duration_cast<std::chrono::microseconds>(end -
+                                                                      start)
+                        .count());
+
+        if (completed) {
+            prAdapter.reset();
+            sweepParticipants.clear();
+        }
+    }
+
+    snooze(getSleepTime());
+    if (engine->getEpStats().isShutdown) {
+        return false;
+    }
+    return true;
+}
+
+bool HashTableSweeperTask::startSweep() {
+    auto composite = std::make_unique<CompositeHTVisitor>();
+    for (const auto& participant : participants) {
+        auto* visitor = participant->startSweep();
+        if (visitor) {
+            composite->addParticipant(*visitor);
+            sweepParticipants.push_back(participant.get());
+        }
+    }
+    if (composite->empty()) {
+        return false;
+    }
+
+    prAdapter = std::make_unique<PauseResumeVBAdapter>(std::move(composite));
+    epstore_position = engine->getKVBucket()->startPosition();
+    return true;
+}
+
+void HashTableSweeperTask::stop() {
+    if (uid) {
+        ExecutorPool::get()->cancel(uid);
+    }
+}
+
+std::string HashTableSweeperTask::getDescription() const {
+    return "HashTable sweeper";
+}
+
+std::chrono::microseconds HashTableSweeperTask::maxExpectedDuration() const {
+    // As the tasks which take part, each chunk is constrained by a chunk
+    // duration, but the ProgressTracker used estimates the time remaining so
+    // apply some headroom.
+    std::chrono::milliseconds chunkDuration{0};
+    for (const auto& participant : participants) {
+        chunkDuration =
+                std::max(chunkDuration, participant->getSweepChunkDuration());
+    }
+    return chunkDuration * 10;
+}
+
+std::chrono::milliseconds HashTableSweeperTask::getChunkDuration() const {
+    auto chunkDuration = std::chrono::milliseconds::max();
+    for (const auto* participant : sweepParticipants) {
+        chunkDuration =
+                std::min(chunkDuration, participant->getSweepChunkDuration());
+    }
+    return chunkDuration;
+}
+
+double HashTableSweeperTask::getSleepTime() const {
+    // Wake for the participant which wants the next chunk soonest, whether or
+    // not it is part of the current sweep (so a participant waiting for the
+    // next sweep isn't delayed by a slow one).
+    double sleepTime = std::numeric_limits<int>::max();
+    for (const auto& participant : participants) {
+        sleepTime = std::min(sleepTime, participant->getSweepSleepTime());
+    }
+    return sleepTime;
+}
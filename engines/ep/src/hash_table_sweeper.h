@@ -0,0 +1,108 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#pragma once
+
+#include "kv_bucket_iface.h"
+#include <executor/globaltask.h>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+class PauseResumeVBAdapter;
+class VBucketAwareHTVisitor;
+
+/**
+ * A background task which takes part in the shared sweep of the
+ * HashTableSweeperTask, instead of visiting every HashTable itself.
+ */
+class HashTableSweepParticipant {
+public:
+    virtual ~HashTableSweepParticipant() = default;
+
+    /**
+     * Called when a sweep is about to start.
+     *
+     * @return the visitor to take part in the sweep with (which must remain
+     *         valid until the sweep completes), or nullptr to sit the sweep
+     *         out
+     */
+    virtual VBucketAwareHTVisitor* startSweep() = 0;
+
+    /// Called before each chunk of a sweep the participant takes part in, to
+    /// prepare its visitor for the chunk
+    virtual void prepareSweepChunk(
+            std::chrono::steady_clock::time_point deadline) = 0;
+
+    /// Called after each chunk of a sweep the participant takes part in;
+    /// completed is true if it was the last chunk of the sweep
+    virtual void completeSweepChunk(bool completed) = 0;
+
+    /// @return how long the participant allows each chunk to run for
+    virtual std::chrono::milliseconds getSweepChunkDuration() const = 0;
+
+    /// @return how long (in seconds) the participant wants to sleep before
+    ///         the next chunk
+    virtual double getSweepSleepTime() const = 0;
+};
+
+/**
+ * Task which sweeps the HashTables of every vBucket on behalf of several
+ * background tasks at once (see ht_sweeper_enabled), so each StoredValue is
+ * read from memory once rather than once per task.
+ *
+ * Each participant keeps its own cadence: a sweep only includes the
+ * participants which ask to join it when it starts, and the task sleeps for
+ * the shortest time any participant asks for. A chunk of the sweep runs for
+ * the shortest chunk duration of the participants in the sweep.
+ */
+class HashTableSweeperTask : public GlobalTask {
+public:
+    explicit HashTableSweeperTask(EventuallyPersistentEngine* e);
+
+    ~HashTableSweeperTask() override;
+
+    /// Add a participant; must be called before the task is scheduled
+    void addParticipant(std::shared_ptr<HashTableSweepParticipant> participant);
+
+    bool run() override;
+
+    void stop();
+
+    std::string getDescription() const override;
+
+    std::chrono::microseconds maxExpectedDuration() const override;
+
+private:
+    /// Start a new sweep with the participants which want to join it.
+    /// @return true if any did
+    bool startSweep();
+
+    /// @return the chunk duration of the current sweep
+    std::chrono::milliseconds getChunkDuration() const;
+
+    /// @return how long to sleep before the next chunk
+    double getSleepTime() const;
+
+    std::vector<std::shared_ptr<HashTableSweepParticipant>> participants;
+
+    /// The participants of the current sweep
+    std::vector<HashTableSweepParticipant*> sweepParticipants;
+
+    // Opaque marker indicating how far through the epStore we have visited.
+    KVBucketIface::Position epstore_position;
+
+    /**
+     * Visitor adapter (of a CompositeHTVisitor) which supports pausing &
+     * resuming. Null between sweeps.
+     */
+    std::unique_ptr<PauseResumeVBAdapter> prAdapter;
+};
@@ -0,0 +1,161 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+#include <folly/lang/Bits.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+class StoredValue;
+
+/**
+ * A cache-line sized index over the StoredValues of a single HashTable
+ * bucket, used by HashTable::Layout::TagGroups.
+ *
+ * Each group holds up to Slots (hash tag, StoredValue*) pairs. The tag is a
+ * 7-bit fragment of the key's hash (with the top bit set so an empty slot is
+ * always zero), which allows a lookup to compare all tags of the bucket in a
+ * single SIMD (or SWAR) operation and only dereference StoredValues whose tag
+ * matches - typically exactly one - instead of walking the hash chain and
+ * taking a cache miss per chained element.
+ *
+ * The hash chain (HashTable::values) remains the owner of all StoredValues;
+ * the group is purely an accelerator. If a bucket has more StoredValues than
+ * the group can index the group is marked as overflowed and lookups fall
+ * back to walking the chain until the group is rebuilt.
+ *
+ * All methods must be called with the owning bucket's ht_lock held.
+ */
+class alignas(64) HashTableTagGroup {
+public:
+    /// Number of StoredValues a group can index.
+    static constexpr size_t Slots = 7;
+
+    /// Compute the tag for the given key hash. Never returns zero.
+    static uint8_t tagForHash(uint32_t hash) {
+        // The bucket is selected by (hash % size) which consumes the low
+        // order bits; use the high order bits for the tag to keep the two
+        // as independent as possible.
+        return uint8_t(hash >> 25) | 0x80;
+    }
+
+    /**
+     * Returns a bitmask of the slots whose tag equals the given tag; bit N
+     * set means slot N is a candidate. Candidates must be confirmed by
+     * comparing the full key.
+     */
+    uint32_t match(uint8_t tag) const {
+#if defined(__SSE2__)
+        const auto needle = _mm_set1_epi8(static_cast<char>(tag));
+        const auto haystack =
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(tags.data()));
+        return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(needle, haystack))) &
+               slotMask;
+#else
+        // SWAR equivalent; find the zero bytes of (tags ^ broadcast(tag)).
+        // May report false positives for bytes above a true match (due to
+        // borrow propagation); these are filtered out by the key compare.
+        uint64_t word;
+        std::memcpy(&word, tags.data(), sizeof(word));
+        word ^= 0x0101010101010101ULL * tag;
+        const uint64_t zeros = (word - 0x0101010101010101ULL) & ~word &
+                               0x8080808080808080ULL;
+        uint32_t mask = 0;
+        for (uint64_t bits = zeros; bits; bits &= bits - 1) {
+            mask |= 1u << (folly::findFirstSet(bits) / 8 - 1);
+        }
+        return mask & slotMask;
+#endif
+    }
+
+    /// @returns the StoredValue indexed at the given slot.
+    StoredValue* get(size_t slot) const {
+        return values[slot];
+    }
+
+    /**
+     * Add the given StoredValue to the group. If there is no free slot the
+     * group is marked as overflowed.
+     */
+    void insert(uint8_t tag, StoredValue* sv) {
+        const auto free = match(0);
+        if (free == 0) {
+            tags[overflowIndex] = 1;
+            return;
+        }
+        const auto slot = folly::findFirstSet(free) - 1;
+        tags[slot] = tag;
+        values[slot] = sv;
+    }
+
+    /**
+     * Remove the given StoredValue from the group (if indexed).
+     * @returns true if the StoredValue was found and removed.
+     */
+    bool erase(uint8_t tag, const StoredValue* sv) {
+        for (auto cand = match(tag); cand; cand &= cand - 1) {
+            const auto slot = folly::findFirstSet(cand) - 1;
+            if (values[slot] == sv) {
+                tags[slot] = 0;
+                values[slot] = nullptr;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Replace the StoredValue indexed by `from` with `to` (both must have the
+     * same key and hence the same tag).
+     * @returns true if `from` was found and replaced.
+     */
+    bool replace(uint8_t tag, const StoredValue* from, StoredValue* to) {
+        for (auto cand = match(tag); cand; cand &= cand - 1) {
+            const auto slot = folly::findFirstSet(cand) - 1;
+            if (values[slot] == from) {
+                values[slot] = to;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @returns true if the group does not index every StoredValue in the
+    ///          bucket, and hence the hash chain must be searched.
+    bool isOverflowed() const {
+        return tags[overflowIndex] != 0;
+    }
+
+    /// Reset to the empty (non-overflowed) state.
+    void clear() {
+        tags.fill(0);
+        values.fill(nullptr);
+    }
+
+private:
+    static constexpr uint32_t slotMask = (1u << Slots) - 1;
+    static constexpr size_t overflowIndex = Slots;
+
+    /// Tags for each slot (zero if empty); the final byte is the overflow
+    /// flag.
+    std::array<uint8_t, Slots + 1> tags{};
+    std::array<StoredValue*, Slots> values{};
+};
+
+static_assert(sizeof(HashTableTagGroup) == 64,
+              "HashTableTagGroup should occupy exactly one cache line");
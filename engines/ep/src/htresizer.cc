@@ -28,7 +28,16 @@ public:
 
     void visitBucket(VBucket& vb) override {
         vb.ht.resize();
+
+        // If an incremental resize is in progress then migrate the remaining
+        // buckets. Each bucket is migrated under its own lock, so front-end
+        // operations are delayed by at most a single bucket migration.
+        while (vb.ht.migrateBuckets(migrationBatchSize)) {
+        }
     }
+
+private:
+    static constexpr size_t migrationBatchSize = 1024;
 };
 
 HashtableResizerTask::HashtableResizerTask(KVBucketIface& s, double sleepTime)
@@ -43,10 +52,10 @@ bool HashtableResizerTask::run() {
     TRACE_EVENT0("ep-engine/task", "HashtableResizerTask");
     auto pv = std::make_unique<ResizingVisitor>();
 
-    // [per-VBucket Task] While a Hashtable is resizing no user
-    // requests can be performed (the resizing process needs to
-    // acquire all HT locks). As such we are sensitive to the duration
-    // of this task - we want to log anything which has a
+    // [per-VBucket Task] While a Hashtable is resizing with the blocking
+    // algorithm no user requests can be performed (the resizing process
+    // needs to acquire all HT locks). As such we are sensitive to the
+    // duration of this task - we want to log anything which has a
     // non-negligible impact on frontend operations.
     const auto maxExpectedDurationForVisitorTask =
             std::chrono::milliseconds(100);
@@ -25,6 +25,8 @@ ItemCompressorTask::ItemCompressorTask(EventuallyPersistentEngine* e,
       epstore_position(engine->getKVBucket()->startPosition()) {
 }
 
+ItemCompressorTask::~ItemCompressorTask() = default;
+
 bool ItemCompressorTask::run() {
     TRACE_EVENT0("ep-engine/task", "ItemCompressorTask");
     if (engine->getCompressionMode() == BucketCompressionMode::Active) {
@@ -116,6 +118,39 @@ void ItemCompressorTask::stop() {
     }
 }
 
+VBucketAwareHTVisitor* ItemCompressorTask::startSweep() {
+    if (engine->getCompressionMode() != BucketCompressionMode::Active) {
+        return nullptr;
+    }
+    sweepVisitor = std::make_unique<ItemCompressorVisitor>();
+    return sweepVisitor.get();
+}
+
+void ItemCompressorTask::prepareSweepChunk(
+        std::chrono::steady_clock::time_point deadline) {
+    sweepVisitor->setDeadline(deadline);
+    sweepVisitor->clearStats();
+    sweepVisitor->setCompressionMode(engine->getCompressionMode());
+    sweepVisitor->setMinCompressionRatio(engine->getMinCompressionRatio());
+}
+
+void ItemCompressorTask::completeSweepChunk(bool completed) {
+    stats.compressorNumCompressed.fetch_add(
+            sweepVisitor->getCompressedCount());
+    stats.compressorNumVisited.fetch_add(sweepVisitor->getVisitedCount());
+    if (completed) {
+        sweepVisitor.reset();
+    }
+}
+
+std::chrono::milliseconds ItemCompressorTask::getSweepChunkDuration() const {
+    return getChunkDuration();
+}
+
+double ItemCompressorTask::getSweepSleepTime() const {
+    return getSleepTime();
+}
+
 std::string ItemCompressorTask::getDescription() const {
     return "Item Compressor";
 }
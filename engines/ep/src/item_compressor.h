@@ -10,6 +10,7 @@
  */
 #pragma once
 
+#include "hash_table_sweeper.h"
 #include "kv_bucket_iface.h"
 #include <executor/globaltask.h>
 
@@ -20,10 +21,13 @@ class PauseResumeVBAdapter;
 /**
  * Task responsible for compressing items in memory.
  */
-class ItemCompressorTask : public GlobalTask {
+class ItemCompressorTask : public GlobalTask,
+                           public HashTableSweepParticipant {
 public:
     ItemCompressorTask(EventuallyPersistentEngine* e, EPStats& stats_);
 
+    ~ItemCompressorTask() override;
+
     bool run() override;
 
     void stop();
@@ -32,6 +36,15 @@ public:
 
     std::chrono::microseconds maxExpectedDuration() const override;
 
+    // HashTableSweepParticipant interface; used instead of run() when the
+    // task takes part in the sweep of the HashTableSweeperTask.
+    VBucketAwareHTVisitor* startSweep() override;
+    void prepareSweepChunk(
+            std::chrono::steady_clock::time_point deadline) override;
+    void completeSweepChunk(bool completed) override;
+    std::chrono::milliseconds getSweepChunkDuration() const override;
+    double getSweepSleepTime() const override;
+
 private:
     /// Duration (in seconds) the compressor should sleep for between
     /// iterations.
@@ -56,4 +69,7 @@ private:
      * complete pass.
      */
     std::unique_ptr<PauseResumeVBAdapter> prAdapter;
+
+    /// The visitor taking part in the current HashTableSweeperTask sweep
+    std::unique_ptr<ItemCompressorVisitor> sweepVisitor;
 };
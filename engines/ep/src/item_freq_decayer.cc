@@ -126,6 +126,40 @@ void ItemFreqDecayerTask::wakeup() {
     }
 }
 
+VBucketAwareHTVisitor* ItemFreqDecayerTask::startSweep() {
+    // As run(), only sweep once woken (when a frequency counter saturates)
+    if (!notified) {
+        return nullptr;
+    }
+    ++(engine->getEpStats().freqDecayerRuns);
+    sweepVisitor = std::make_unique<ItemFreqDecayerVisitor>(percentage);
+    completed = false;
+    return sweepVisitor.get();
+}
+
+void ItemFreqDecayerTask::prepareSweepChunk(
+        std::chrono::steady_clock::time_point deadline) {
+    sweepVisitor->setDeadline(deadline);
+    sweepVisitor->clearStats();
+}
+
+void ItemFreqDecayerTask::completeSweepChunk(bool finished) {
+    completed = finished;
+    if (finished) {
+        sweepVisitor.reset();
+        notified.store(false);
+    }
+}
+
+std::chrono::milliseconds ItemFreqDecayerTask::getSweepChunkDuration() const {
+    return getChunkDuration();
+}
+
+double ItemFreqDecayerTask::getSweepSleepTime() const {
+    // Once woken keep sweeping until every item has been decayed
+    return notified ? 0 : std::numeric_limits<int>::max();
+}
+
 std::string ItemFreqDecayerTask::getDescription() const {
     return "Item frequency count decayer task";
 }
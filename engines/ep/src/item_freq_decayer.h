@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include "hash_table_sweeper.h"
 #include "kv_bucket_iface.h"
 #include <executor/globaltask.h>
 
@@ -22,7 +23,8 @@ class PauseResumeVBAdapter;
  * documents in a given hash table, decaying the frequency count of each
  * document by a given percentage.
  */
-class ItemFreqDecayerTask : public GlobalTask {
+class ItemFreqDecayerTask : public GlobalTask,
+                            public HashTableSweepParticipant {
 public:
     ItemFreqDecayerTask(EventuallyPersistentEngine* e, uint16_t percentage_);
 
@@ -40,6 +42,15 @@ public:
     // Made virtual so can be overridden in mock version used in testing.
     virtual void wakeup();
 
+    // HashTableSweepParticipant interface; used instead of run() when the
+    // task takes part in the sweep of the HashTableSweeperTask.
+    VBucketAwareHTVisitor* startSweep() override;
+    void prepareSweepChunk(
+            std::chrono::steady_clock::time_point deadline) override;
+    void completeSweepChunk(bool completed) override;
+    std::chrono::milliseconds getSweepChunkDuration() const override;
+    double getSweepSleepTime() const override;
+
 protected:
     // bool used to indicate whether the task's visitor has finished visiting
     // all the documents in the given hash table.
@@ -69,4 +80,7 @@ private:
      * complete pass.
      */
     std::unique_ptr<PauseResumeVBAdapter> prAdapter;
+
+    /// The visitor taking part in the current HashTableSweeperTask sweep
+    std::unique_ptr<ItemFreqDecayerVisitor> sweepVisitor;
 };
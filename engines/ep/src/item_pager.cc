@@ -275,6 +275,8 @@ ExpiredItemPager::ExpiredItemPager(EventuallyPersistentEngine* e,
     snooze(calculateWakeTimeFromCfg(*cfg).count());
 }
 
+ExpiredItemPager::~ExpiredItemPager() = default;
+
 void ExpiredItemPager::updateSleepTime(std::chrono::seconds sleepTime) {
     auto cfg = config.wlock();
     cfg->sleepTime = sleepTime;
@@ -360,7 +362,12 @@ bool ExpiredItemPager::run() {
     // create multiple paging visitors, as configured
     const auto concurrentVisitors = pagerSemaphore->getCapacity();
 
-    if (pagerSemaphore->try_acquire(concurrentVisitors)) {
+    if (const auto sweeper = sweeperId.load()) {
+        // The HashTableSweeperTask expires the items in its next sweep (if
+        // the previous one is still in progress it just carries on)
+        sweepRequested = true;
+        ExecutorPool::get()->wake(sweeper);
+    } else if (pagerSemaphore->try_acquire(concurrentVisitors)) {
         // acquired token, PagingVisitor::complete() will call
         // pagerSemaphore->signal() to release it.
         ++stats.expiryPagerRuns;
@@ -410,6 +417,54 @@ bool ExpiredItemPager::run() {
     return true;
 }
 
+void ExpiredItemPager::setSweeper(const HashTableSweeperTask& sweeper) {
+    sweeperId = sweeper.getId();
+}
+
+VBucketAwareHTVisitor* ExpiredItemPager::startSweep() {
+    if (!sweepRequested) {
+        return nullptr;
+    }
+    if (!isEnabled()) {
+        // Disabled since the sweep was requested
+        sweepRequested = false;
+        return nullptr;
+    }
+    ++stats.expiryPagerRuns;
+    sweepStart = std::chrono::steady_clock::now();
+    sweepVisitor = std::make_unique<ExpiredItemSweepVisitor>(
+            *engine->getKVBucket(), stats);
+    return sweepVisitor.get();
+}
+
+void ExpiredItemPager::prepareSweepChunk(
+        std::chrono::steady_clock::time_point deadline) {
+    sweepVisitor->setDeadline(deadline);
+    sweepVisitor->clearStats();
+}
+
+void ExpiredItemPager::completeSweepChunk(bool completed) {
+    // Expire what the chunk collected in the vBucket it paused in
+    sweepVisitor->processExpired();
+    if (completed) {
+        stats.expiryPagerHisto.add(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - sweepStart));
+        sweepVisitor.reset();
+        sweepRequested = false;
+    }
+}
+
+std::chrono::milliseconds ExpiredItemPager::getSweepChunkDuration() const {
+    // As the PagingVisitor's maxChunkDuration
+    return std::chrono::milliseconds(25);
+}
+
+double ExpiredItemPager::getSweepSleepTime() const {
+    // Once requested keep sweeping until every item has been checked
+    return sweepRequested ? 0 : std::numeric_limits<int>::max();
+}
+
 void ExpiredItemPager::updateExpPagerTime(double sleepSecs) {
     struct timeval _waketime;
     gettimeofday(&_waketime, nullptr);
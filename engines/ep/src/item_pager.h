@@ -10,10 +10,13 @@
  */
 #pragma once
 
+#include "hash_table_sweeper.h"
+
 #include <executor/globaltask.h>
 
 #include <folly/Synchronized.h>
 #include <memcached/types.h> // for ssize_t
+#include <atomic>
 #include <chrono>
 #include <memory>
 
@@ -22,6 +25,7 @@ typedef std::pair<int64_t, int64_t> row_range_t;
 // Forward declaration.
 class EPStats;
 class EventuallyPersistentEngine;
+class ExpiredItemSweepVisitor;
 class VBucketFilter;
 
 namespace cb {
@@ -137,6 +141,7 @@ private:
  * items value which saves memory and disk space.
  */
 class ExpiredItemPager : public GlobalTask,
+                         public HashTableSweepParticipant,
                          public std::enable_shared_from_this<ExpiredItemPager> {
 public:
 
@@ -153,6 +158,8 @@ public:
                      ssize_t taskTime,
                      int numConcurrentExpiryPagers);
 
+    ~ExpiredItemPager() override;
+
     /**
      * Update the periodic sleep interval of the task.
      */
@@ -199,6 +206,21 @@ public:
         return std::chrono::milliseconds(25);
     }
 
+    /**
+     * Expire items in the sweep of the given HashTableSweeperTask instead of
+     * with PagingVisitors of its own; run() then only requests a sweep.
+     */
+    void setSweeper(const HashTableSweeperTask& sweeper);
+
+    // HashTableSweepParticipant interface; used instead of the PagingVisitors
+    // when the task takes part in the sweep of the HashTableSweeperTask.
+    VBucketAwareHTVisitor* startSweep() override;
+    void prepareSweepChunk(
+            std::chrono::steady_clock::time_point deadline) override;
+    void completeSweepChunk(bool completed) override;
+    std::chrono::milliseconds getSweepChunkDuration() const override;
+    double getSweepSleepTime() const override;
+
 private:
     struct Config {
         std::chrono::seconds sleepTime = std::chrono::seconds(0);
@@ -218,4 +240,17 @@ private:
     EPStats                        &stats;
     // used to avoid creating more paging visitors while any are still running
     std::shared_ptr<cb::Semaphore> pagerSemaphore;
+
+    // Id of the HashTableSweeperTask expiring items for us, 0 if none
+    std::atomic<size_t> sweeperId{0};
+
+    // Set by run() when the next HashTableSweeperTask sweep should expire
+    // items; cleared once that sweep completes
+    std::atomic<bool> sweepRequested{false};
+
+    /// The visitor taking part in the current HashTableSweeperTask sweep
+    std::unique_ptr<ExpiredItemSweepVisitor> sweepVisitor;
+
+    /// When the current HashTableSweeperTask sweep started
+    std::chrono::steady_clock::time_point sweepStart;
 };
@@ -29,6 +29,7 @@
 #include "ext_meta_parser.h"
 #include "failover-table.h"
 #include "flusher.h"
+#include "hash_table_sweeper.h"
 #include "htresizer.h"
 #include "item.h"
 #include "item_compressor.h"
@@ -496,6 +497,12 @@ bool KVBucket::initialize() {
     ExecutorPool::get()->schedule(defragmenterTask);
 #endif
 
+    std::shared_ptr<HashTableSweeperTask> sweeper;
+    if (config.isHtSweeperEnabled()) {
+        sweeper = std::make_shared<HashTableSweeperTask>(&engine);
+        hashTableSweeperTask = sweeper;
+    }
+
     enableItemCompressor();
 
     /*
@@ -505,9 +512,17 @@ bool KVBucket::initialize() {
      * seconds and will only be woken up when the frequency counter of an
      * item in the hash table becomes saturated.
      */
-    itemFreqDecayerTask = std::make_shared<ItemFreqDecayerTask>(
+    auto decayer = std::make_shared<ItemFreqDecayerTask>(
             &engine, config.getItemFreqDecayerPercent());
-    ExecutorPool::get()->schedule(itemFreqDecayerTask);
+    itemFreqDecayerTask = decayer;
+    if (sweeper) {
+        sweeper->addParticipant(decayer);
+        sweeper->addParticipant(expiryPagerTask);
+        expiryPagerTask->setSweeper(*sweeper);
+        ExecutorPool::get()->schedule(hashTableSweeperTask);
+    } else {
+        ExecutorPool::get()->schedule(itemFreqDecayerTask);
+    }
 
     return true;
 }
@@ -526,6 +541,8 @@ KVBucket::~KVBucket() {
     itemCompressorTask.reset();
     EP_LOG_INFO_RAW("Deleting itemFreqDecayerTask");
     itemFreqDecayerTask.reset();
+    EP_LOG_INFO_RAW("Deleting hashTableSweeperTask");
+    hashTableSweeperTask.reset();
     EP_LOG_INFO_RAW("Deleted KvBucket.");
 }
 
@@ -968,6 +985,9 @@ void KVBucket::setVBucketState_UNLOCKED(
                     engine, vb, std::move(connectionsToRespondTo));
             ExecutorPool::get()->schedule(notifyTask);
         }
+
+        // Range scans may only read from an active vBucket
+        vb->cancelRangeScans();
     }
 
     auto oldstate = vbMap.setState_UNLOCKED(*vb, to, meta, vbStateLock);
@@ -1067,8 +1087,10 @@ cb::engine_errc KVBucket::createVBucket_UNLOCKED(
     if (config.isBfilterEnabled()) {
         // Initialize bloom filters upon vbucket creation during
         // bucket creation and rebalance
-        newvb->createFilter(config.getBfilterKeyCount(),
-                            config.getBfilterFpProb());
+        newvb->createFilter(
+                config.getBfilterKeyCount(),
+                config.getBfilterFpProb(),
+                BloomFilter::layoutFromString(config.getBfilterLayout()));
     }
 
     // Before adding the VB to the map, notify KVStore of the create
@@ -1138,6 +1160,7 @@ cb::engine_errc KVBucket::deleteVBucket(Vbid vbid, const CookieIface* c) {
         // try and change the disk revision e.g. deleteAll and compaction).
         auto lockedVB = getLockedVBucket(vbid);
         vbMap.setState(*lockedVB, vbucket_state_dead, nullptr);
+        lockedVB->cancelRangeScans();
         getRWUnderlying(vbid)->abortCompactionIfRunning(lockedVB.getLock(),
                                                         vbid);
         engine.getDcpConnMap().vbucketStateChanged(vbid, vbucket_state_dead);
@@ -1579,6 +1602,90 @@ GetValue KVBucket::getInternal(const DocKey& key,
     }
 }
 
+cb::engine_errc KVBucket::getMulti(const std::vector<DocKey>& keys,
+                                   Vbid vbucket,
+                                   const CookieIface* cookie,
+                                   get_options_t options,
+                                   std::vector<GetValue>& values) {
+    values.clear();
+    if (keys.empty()) {
+        return cb::engine_errc::success;
+    }
+
+    VBucketPtr vb = getVBucket(vbucket);
+    if (!vb) {
+        ++stats.numNotMyVBuckets;
+        return cb::engine_errc::not_my_vbucket;
+    }
+
+    folly::SharedMutex::ReadHolder rlh(vb->getStateLock());
+    if (options & HONOR_STATES) {
+        const auto vbState = vb->getState();
+        if (vbState == vbucket_state_dead ||
+            vbState == vbucket_state_replica) {
+            ++stats.numNotMyVBuckets;
+            return cb::engine_errc::not_my_vbucket;
+        }
+        if (vbState == vbucket_state_pending && vb->addPendingOp(cookie)) {
+            // Every key must be retried once the vbucket leaves pending
+            values.assign(keys.size(),
+                          GetValue(nullptr, cb::engine_errc::would_block));
+            return cb::engine_errc::would_block;
+        }
+    }
+
+    // The background fetches are queued in one go below so that the cookie
+    // is only notified once for the entire batch
+    const auto lookupOptions = static_cast<get_options_t>(
+            options & ~QUEUE_BG_FETCH);
+    std::vector<DocKey> fetchKeys;
+    std::vector<size_t> fetchIndexes;
+    values.reserve(keys.size());
+    {
+        // hold one collections read handle for all of the keys
+        auto cHandle = vb->lockCollections(keys.front());
+        for (const auto& key : keys) {
+            cHandle.setKey(key);
+            if (!cHandle.valid()) {
+                engine.setUnknownCollectionErrorContext(
+                        cookie, cHandle.getManifestUid());
+                values.emplace_back(nullptr,
+                                    cb::engine_errc::unknown_collection);
+                continue;
+            }
+
+            auto result = vb->getInternal(cookie,
+                                          engine,
+                                          lookupOptions,
+                                          VBucket::GetKeyOnly::No,
+                                          cHandle);
+            if (result.getStatus() == cb::engine_errc::would_block) {
+                fetchKeys.emplace_back(key);
+                fetchIndexes.emplace_back(values.size());
+            } else {
+                cHandle.incrementOpsGet();
+            }
+            values.emplace_back(std::move(result));
+        }
+    }
+
+    if (fetchKeys.empty() || !(options & QUEUE_BG_FETCH)) {
+        return fetchKeys.empty() ? cb::engine_errc::success
+                                 : cb::engine_errc::would_block;
+    }
+
+    const auto status = vb->bgFetchMulti(fetchKeys, cookie, engine);
+    bool blocked = false;
+    for (size_t ii = 0; ii < status.size(); ++ii) {
+        if (status[ii] == cb::engine_errc::would_block) {
+            blocked = true;
+        } else {
+            values[fetchIndexes[ii]] = GetValue(nullptr, status[ii]);
+        }
+    }
+    return blocked ? cb::engine_errc::would_block : cb::engine_errc::success;
+}
+
 GetValue KVBucket::getRandomKey(CollectionID cid, const CookieIface* cookie) {
     size_t max = vbMap.getSize();
     const Vbid::id_type start = labs(getRandom()) % max;
@@ -2187,6 +2294,10 @@ void KVBucket::disableItemPager() {
 void KVBucket::wakeItemFreqDecayerTask() {
     auto& t = dynamic_cast<ItemFreqDecayerTask&>(*itemFreqDecayerTask);
     t.wakeup();
+    if (hashTableSweeperTask) {
+        // The decayer joins the sweeper's next sweep
+        ExecutorPool::get()->wake(hashTableSweeperTask->getId());
+    }
 }
 
 void KVBucket::enableAccessScannerTask() {
@@ -2270,8 +2381,14 @@ void KVBucket::resetAccessScannerStartTime() {
 }
 
 void KVBucket::enableItemCompressor() {
-    itemCompressorTask = std::make_shared<ItemCompressorTask>(&engine, stats);
-    ExecutorPool::get()->schedule(itemCompressorTask);
+    auto compressor = std::make_shared<ItemCompressorTask>(&engine, stats);
+    itemCompressorTask = compressor;
+    if (hashTableSweeperTask) {
+        dynamic_cast<HashTableSweeperTask&>(*hashTableSweeperTask)
+                .addParticipant(compressor);
+    } else {
+        ExecutorPool::get()->schedule(itemCompressorTask);
+    }
 }
 
 void KVBucket::setAllBloomFilters(bool to) {
@@ -140,6 +140,12 @@ public:
                  const CookieIface* cookie,
                  get_options_t options) override;
 
+    cb::engine_errc getMulti(const std::vector<DocKey>& keys,
+                             Vbid vbucket,
+                             const CookieIface* cookie,
+                             get_options_t options,
+                             std::vector<GetValue>& values) override;
+
     GetValue getRandomKey(CollectionID cid, const CookieIface* cookie) override;
 
     GetValue getReplica(const DocKey& key,
@@ -1037,6 +1043,11 @@ protected:
     // stored in the hash table.  This is required to ensure that all the
     // frequency counts do not become saturated.
     ExTask itemFreqDecayerTask;
+    // With ht_sweeper_enabled, sweeps the hash tables on behalf of the
+    // itemCompressorTask and itemFreqDecayerTask (which are then not
+    // scheduled themselves) and of the expiryPagerTask (which then only
+    // requests a sweep when it runs).
+    ExTask hashTableSweeperTask;
     size_t                          compactionWriteQueueCap;
 
     // Responsible for enforcing the Durability Timeout for the SyncWrites
@@ -13,6 +13,7 @@
 
 #include "kvstore/kvstore_fwd.h"
 #include "permitted_vb_states.h"
+#include "range_scans/range_scan_types.h"
 #include "rollback_result.h"
 #include "vbucket_fwd.h"
 #include "vbucket_notify_context.h"
@@ -157,6 +158,30 @@ public:
                          const CookieIface* cookie,
                          get_options_t options) = 0;
 
+    /**
+     * Retrieve a batch of values from the same vbucket. The vbucket state
+     * and collections locks are acquired once for the whole batch, and all
+     * of the keys which need to be read from disk are fetched with a single
+     * notification of the cookie once every fetch has completed.
+     *
+     * @param keys    the keys to fetch
+     * @param vbucket the vbucket from which to retrieve the keys
+     * @param cookie  the connection cookie
+     * @param options options specified for retrieval
+     * @param values  populated with one GetValue per key (in the same order
+     *                as the keys). Keys waiting on a background fetch have
+     *                the status cb::engine_errc::would_block
+     *
+     * @return cb::engine_errc::success, or cb::engine_errc::would_block if
+     *         any of the keys are being fetched from disk, or an error which
+     *         applies to all of the keys (for example not_my_vbucket)
+     */
+    virtual cb::engine_errc getMulti(const std::vector<DocKey>& keys,
+                                     Vbid vbucket,
+                                     const CookieIface* cookie,
+                                     get_options_t options,
+                                     std::vector<GetValue>& values) = 0;
+
     /**
      * Retrieve a value randomly from the store.
      *
@@ -167,6 +192,79 @@ public:
     virtual GetValue getRandomKey(CollectionID cid,
                                   const CookieIface* cookie) = 0;
 
+    /**
+     * Create a range scan of the keys (or documents) of a collection, either
+     * the keys in [start, end) or a random sample of the keys.
+     *
+     * @param vbid vBucket to scan (must be active)
+     * @param cookie the connection cookie
+     * @param cid the collection to scan
+     * @param start the first key of the range, or the start of the
+     *        collection if not set
+     * @param end the end of the range (exclusive), or the end of the
+     *        collection if not set
+     * @param keyOnly should the scan return only the keys
+     * @param samplingConfig set for a random sample scan
+     * @return would_block while the scan is created (the cookie is notified
+     *         once it's done), success and the id of the new scan on the
+     *         call after the notification, or an error
+     */
+    virtual std::pair<cb::engine_errc, cb::rangescan::Id> createRangeScan(
+            Vbid vbid,
+            const CookieIface* cookie,
+            CollectionID cid,
+            std::optional<std::string_view> start,
+            std::optional<std::string_view> end,
+            cb::rangescan::KeyOnly keyOnly,
+            std::optional<cb::rangescan::SamplingConfiguration>
+                    samplingConfig) = 0;
+
+    /**
+     * Continue a range scan. The first call queues the continue and returns
+     * would_block, once the cookie is notified the next call returns the
+     * result of the continue.
+     *
+     * @param vbid vBucket of the scan
+     * @param id the id of the scan
+     * @param cookie the connection cookie
+     * @param limits the limits of the continue
+     * @param status set to the status of the continue (RangeScanMore,
+     *        RangeScanComplete, RangeScanCancelled or an error)
+     * @param data set to the keys (or documents) read by the continue
+     * @return success if status and data are set, would_block, no_such_key
+     *         if the scan doesn't exist (or belongs to another connection),
+     *         or an error (for example the connection doesn't have the Read
+     *         privilege for the scanned collection)
+     */
+    virtual cb::engine_errc continueRangeScan(
+            Vbid vbid,
+            const cb::rangescan::Id& id,
+            const CookieIface* cookie,
+            const cb::rangescan::ContinueLimits& limits,
+            cb::mcbp::Status& status,
+            std::string& data) = 0;
+
+    /**
+     * Cancel a range scan.
+     *
+     * @param vbid vBucket of the scan
+     * @param id the id of the scan
+     * @param cookie the connection cookie
+     * @return success, no_such_key if the scan doesn't exist (or belongs to
+     *         another connection), or an error if the connection doesn't
+     *         have the Read privilege for the scanned collection
+     */
+    virtual cb::engine_errc cancelRangeScan(Vbid vbid,
+                                            const cb::rangescan::Id& id,
+                                            const CookieIface* cookie) = 0;
+
+    /**
+     * Cancel the range scans created by a connection (which disconnected).
+     *
+     * @param connectionId the id of the connection
+     */
+    virtual void cancelRangeScansForConnection(uint32_t connectionId) = 0;
+
     /**
      * Retrieve a value from a vbucket in replica state.
      *
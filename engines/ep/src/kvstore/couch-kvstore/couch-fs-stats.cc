@@ -170,3 +170,12 @@ void StatsOps::destructor(couch_file_handle h) {
     delete sf;
 }
 
+
+std::pair<FileOpsInterface*, couch_file_handle> StatsOps::getWrappedFile(
+        FileOpsInterface::FHStats* fileStats) {
+    auto* sf = dynamic_cast<StatFile*>(fileStats);
+    if (!sf) {
+        return {nullptr, nullptr};
+    }
+    return {sf->orig_ops, sf->orig_handle};
+}
@@ -13,6 +13,7 @@
 
 #include <atomic>
 #include <memory>
+#include <utility>
 
 #include <libcouchstore/couch_db.h>
 
@@ -65,6 +66,19 @@ public:
     FHStats* get_stats(couch_file_handle handle) override;
     void destructor(couch_file_handle handle) override;
 
+    /**
+     * Returns the wrapped ops and handle of a file opened through StatsOps,
+     * for example to use an operation the wrapped ops have in addition to
+     * FileOpsInterface.
+     *
+     * @param fileStats The stats of the file, as returned by
+     *        couchstore_get_db_filestats()
+     * @return the wrapped ops and handle, or {nullptr, nullptr} if the file
+     *         wasn't opened through StatsOps
+     */
+    static std::pair<FileOpsInterface*, couch_file_handle> getWrappedFile(
+            FileOpsInterface::FHStats* fileStats);
+
 protected:
     FileStats& stats;
     FileOpsInterface& wrapped_ops;
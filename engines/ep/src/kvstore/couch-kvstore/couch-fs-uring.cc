@@ -0,0 +1,425 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "couch-fs-uring.h"
+
+#include <liburing.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <system_error>
+
+namespace {
+/// The io_uring of the calling thread
+class ThreadRing {
+public:
+    ThreadRing() {
+        // The completion queue is twice the size of the submission queue,
+        // and every submission is reaped before the next, so submitting
+        // can't fail for lack of completion queue space.
+        initialized = io_uring_queue_init(UringOps::QueueDepth, &ring, 0) == 0;
+    }
+
+    ~ThreadRing() {
+        if (initialized) {
+            io_uring_queue_exit(&ring);
+        }
+    }
+
+    /// @return the ring, or nullptr if io_uring isn't available
+    static io_uring* get() {
+        thread_local ThreadRing threadRing;
+        return threadRing.initialized ? &threadRing.ring : nullptr;
+    }
+
+private:
+    io_uring ring;
+    bool initialized{false};
+};
+
+/**
+ * Submit the prepared entries and wait for all of them to complete, calling
+ * completed(userData, result) for each.
+ */
+template <typename Callback>
+void submitAndReap(io_uring* ring, unsigned count, Callback completed) {
+    unsigned submitted = 0;
+    while (submitted < count) {
+        const int ret = io_uring_submit(ring);
+        if (ret < 0) {
+            if (ret == -EINTR) {
+                continue;
+            }
+            throw std::system_error(
+                    -ret, std::system_category(), "UringOps: io_uring_submit");
+        }
+        submitted += ret;
+    }
+
+    for (unsigned ii = 0; ii < count; ++ii) {
+        io_uring_cqe* cqe = nullptr;
+        int ret;
+        while ((ret = io_uring_wait_cqe(ring, &cqe)) == -EINTR) {
+        }
+        if (ret < 0) {
+            throw std::system_error(-ret,
+                                    std::system_category(),
+                                    "UringOps: io_uring_wait_cqe");
+        }
+        completed(reinterpret_cast<uintptr_t>(io_uring_cqe_get_data(cqe)),
+                  cqe->res);
+        io_uring_cqe_seen(ring, cqe);
+    }
+}
+
+/// pwrite(2) all of the buffer, retrying short writes
+bool pwriteAll(int fd, const uint8_t* buf, size_t nbytes, cs_off_t offset) {
+    while (nbytes > 0) {
+        const auto written = ::pwrite(fd, buf, nbytes, offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        buf += written;
+        nbytes -= written;
+        offset += written;
+    }
+    return true;
+}
+} // namespace
+
+FileOpsInterface& getCouchstoreUringOps() {
+    static UringOps ops;
+    return ops;
+}
+
+couch_file_handle UringOps::constructor(couchstore_error_info_t*) {
+    return reinterpret_cast<couch_file_handle>(new File);
+}
+
+couchstore_error_t UringOps::open(couchstore_error_info_t* errinfo,
+                                  couch_file_handle* handle,
+                                  const char* path,
+                                  int oflag) {
+    auto* file = reinterpret_cast<File*>(*handle);
+    int fd;
+    do {
+        fd = ::open(path, oflag | O_CLOEXEC, 0666);
+    } while (fd == -1 && errno == EINTR);
+
+    if (fd == -1) {
+        errinfo->error = errno;
+        if (errno == ENOENT) {
+            return COUCHSTORE_ERROR_NO_SUCH_FILE;
+        }
+        return COUCHSTORE_ERROR_OPEN_FILE;
+    }
+    file->fd = fd;
+    return COUCHSTORE_SUCCESS;
+}
+
+couchstore_error_t UringOps::close(couchstore_error_info_t* errinfo,
+                                   couch_file_handle handle) {
+    auto* file = reinterpret_cast<File*>(handle);
+    if (file->fd == -1) {
+        return COUCHSTORE_SUCCESS;
+    }
+
+    auto status = submitWrites(errinfo, *file, false);
+    if (::close(file->fd) == -1 && status == COUCHSTORE_SUCCESS) {
+        errinfo->error = errno;
+        status = COUCHSTORE_ERROR_FILE_CLOSE;
+    }
+    file->fd = -1;
+    return status;
+}
+
+couchstore_error_t UringOps::set_periodic_sync(couch_file_handle handle,
+                                               uint64_t period_bytes) {
+    reinterpret_cast<File*>(handle)->periodicSyncBytes = period_bytes;
+    return COUCHSTORE_SUCCESS;
+}
+
+// Tracing, write validation and mprotect are debugging aids of couchstore's
+// own file ops and aren't supported by the io_uring ops; the flags are
+// ignored so that files can still be opened with them set.
+couchstore_error_t UringOps::set_tracing_enabled(couch_file_handle) {
+    return COUCHSTORE_SUCCESS;
+}
+
+couchstore_error_t UringOps::set_write_validation_enabled(couch_file_handle) {
+    return COUCHSTORE_SUCCESS;
+}
+
+couchstore_error_t UringOps::set_mprotect_enabled(couch_file_handle) {
+    return COUCHSTORE_SUCCESS;
+}
+
+ssize_t UringOps::pread(couchstore_error_info_t* errinfo,
+                        couch_file_handle handle,
+                        void* buf,
+                        size_t nbytes,
+                        cs_off_t offset) {
+    auto* file = reinterpret_cast<File*>(handle);
+    // The read may be of data which is still queued
+    const auto status = submitWrites(errinfo, *file, false);
+    if (status != COUCHSTORE_SUCCESS) {
+        return status;
+    }
+
+    ssize_t bytesRead;
+    do {
+        bytesRead = ::pread(file->fd, buf, nbytes, offset);
+    } while (bytesRead == -1 && errno == EINTR);
+    if (bytesRead < 0) {
+        errinfo->error = errno;
+        return COUCHSTORE_ERROR_READ;
+    }
+    return bytesRead;
+}
+
+ssize_t UringOps::pwrite(couchstore_error_info_t* errinfo,
+                         couch_file_handle handle,
+                         const void* buf,
+                         size_t nbytes,
+                         cs_off_t offset) {
+    auto* file = reinterpret_cast<File*>(handle);
+    const auto* data = static_cast<const uint8_t*>(buf);
+
+    auto& queue = file->queuedWrites;
+    if (!queue.empty() &&
+        queue.back().offset + cs_off_t(queue.back().data.size()) == offset) {
+        // Couchstore appends, so most writes extend the previous one
+        queue.back().data.insert(queue.back().data.end(), data, data + nbytes);
+    } else {
+        queue.push_back({offset, {data, data + nbytes}});
+    }
+    file->queuedWriteBytes += nbytes;
+    file->bytesSinceSync += nbytes;
+
+    couchstore_error_t status = COUCHSTORE_SUCCESS;
+    if (file->periodicSyncBytes &&
+        file->bytesSinceSync >= file->periodicSyncBytes) {
+        status = submitWrites(errinfo, *file, true);
+    } else if (queue.size() >= QueueDepth - 1 ||
+               file->queuedWriteBytes >= MaxQueuedWriteBytes) {
+        status = submitWrites(errinfo, *file, false);
+    }
+    if (status != COUCHSTORE_SUCCESS) {
+        return status;
+    }
+    return nbytes;
+}
+
+cs_off_t UringOps::goto_eof(couchstore_error_info_t* errinfo,
+                            couch_file_handle handle) {
+    auto* file = reinterpret_cast<File*>(handle);
+    const auto status = submitWrites(errinfo, *file, false);
+    if (status != COUCHSTORE_SUCCESS) {
+        return status;
+    }
+
+    struct stat st;
+    if (fstat(file->fd, &st) == -1) {
+        errinfo->error = errno;
+        return COUCHSTORE_ERROR_READ;
+    }
+    return st.st_size;
+}
+
+couchstore_error_t UringOps::sync(couchstore_error_info_t* errinfo,
+                                  couch_file_handle handle) {
+    return submitWrites(errinfo, *reinterpret_cast<File*>(handle), true);
+}
+
+couchstore_error_t UringOps::advise(couchstore_error_info_t*,
+                                    couch_file_handle handle,
+                                    cs_off_t offset,
+                                    cs_off_t len,
+                                    couchstore_file_advice_t advice) {
+    int posixAdvice;
+    switch (advice) {
+    case COUCHSTORE_FILE_ADVICE_NORMAL:
+        posixAdvice = POSIX_FADV_NORMAL;
+        break;
+    case COUCHSTORE_FILE_ADVICE_SEQUENTIAL:
+        posixAdvice = POSIX_FADV_SEQUENTIAL;
+        break;
+    case COUCHSTORE_FILE_ADVICE_RANDOM:
+        posixAdvice = POSIX_FADV_RANDOM;
+        break;
+    case COUCHSTORE_FILE_ADVICE_WILLNEED:
+        posixAdvice = POSIX_FADV_WILLNEED;
+        break;
+    case COUCHSTORE_FILE_ADVICE_DONTNEED:
+        posixAdvice = POSIX_FADV_DONTNEED;
+        break;
+    default:
+        return COUCHSTORE_SUCCESS;
+    }
+
+    // Advice is only a hint, so a failure isn't an error
+    const auto* file = reinterpret_cast<File*>(handle);
+    posix_fadvise(file->fd, offset, len, posixAdvice);
+    return COUCHSTORE_SUCCESS;
+}
+
+FileOpsInterface::FHStats* UringOps::get_stats(couch_file_handle) {
+    return nullptr;
+}
+
+void UringOps::destructor(couch_file_handle handle) {
+    delete reinterpret_cast<File*>(handle);
+}
+
+bool UringOps::readAhead(couch_file_handle handle,
+                         std::vector<ReadRange> ranges) {
+    auto* ring = ThreadRing::get();
+    if (!ring) {
+        return false;
+    }
+
+    const auto* file = reinterpret_cast<File*>(handle);
+    // Reading in file order gives the device the best chance to merge
+    std::sort(ranges.begin(),
+              ranges.end(),
+              [](const auto& a, const auto& b) { return a.offset < b.offset; });
+
+    // The data is discarded, so the scratch buffer is left uninitialized and
+    // is only as big as the (first submission of the) ranges
+    size_t scratchSize = 0;
+    for (const auto& range : ranges) {
+        scratchSize += std::min(range.size, MaxReadAheadBytes);
+        if (scratchSize >= MaxReadAheadBytes) {
+            scratchSize = MaxReadAheadBytes;
+            break;
+        }
+    }
+    std::unique_ptr<uint8_t[]> scratch(new uint8_t[scratchSize]);
+
+    auto next = ranges.begin();
+    while (next != ranges.end()) {
+        // Prepare as many ranges as fit in the queue and the scratch buffer.
+        // A range bigger than the buffer is only partially read ahead.
+        unsigned count = 0;
+        size_t bytes = 0;
+        for (; next != ranges.end() && count < QueueDepth; ++next) {
+            const auto size = std::min(next->size, MaxReadAheadBytes);
+            if (bytes + size > MaxReadAheadBytes) {
+                break;
+            }
+            auto* sqe = io_uring_get_sqe(ring);
+            io_uring_prep_read(
+                    sqe, file->fd, scratch.get() + bytes, size, next->offset);
+            bytes += size;
+            ++count;
+        }
+        submitAndReap(ring, count, [](uintptr_t, int) {});
+    }
+    return true;
+}
+
+couchstore_error_t UringOps::submitWrites(couchstore_error_info_t* errinfo,
+                                          File& file,
+                                          bool sync) {
+    auto& queue = file.queuedWrites;
+    if (queue.empty() && !sync) {
+        return COUCHSTORE_SUCCESS;
+    }
+
+    // The bytes of each queued write completed by the ring
+    std::vector<size_t> written(queue.size(), 0);
+    bool synced = false;
+    int error = 0;
+
+    auto* ring = ThreadRing::get();
+    if (ring) {
+        // The user data of a write is its index + 1, and of the sync is 0
+        auto completed = [&written, &synced, &error](uintptr_t data,
+                                                     int res) {
+            if (res == -ECANCELED) {
+                // An earlier entry of the chain was short; finished below
+                return;
+            }
+            if (res < 0) {
+                error = -res;
+            } else if (data == 0) {
+                synced = true;
+            } else {
+                written[data - 1] = res;
+            }
+        };
+
+        size_t next = 0;
+        do {
+            const auto count =
+                    std::min(queue.size() - next, size_t(QueueDepth - 1));
+            const bool last = next + count == queue.size();
+            for (size_t ii = next; ii < next + count; ++ii) {
+                auto* sqe = io_uring_get_sqe(ring);
+                io_uring_prep_write(sqe,
+                                    file.fd,
+                                    queue[ii].data.data(),
+                                    queue[ii].data.size(),
+                                    queue[ii].offset);
+                io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(ii + 1));
+                if (last && sync) {
+                    // Link so the sync only runs once the writes are done
+                    io_uring_sqe_set_flags(sqe, IOSQE_IO_LINK);
+                }
+            }
+            unsigned entries = count;
+            if (last && sync) {
+                auto* sqe = io_uring_get_sqe(ring);
+                io_uring_prep_fsync(sqe, file.fd, IORING_FSYNC_DATASYNC);
+                io_uring_sqe_set_data(sqe, nullptr);
+                ++entries;
+            }
+            submitAndReap(ring, entries, completed);
+            next += count;
+        } while (next < queue.size());
+    }
+
+    // Finish anything the ring didn't (or there's no ring)
+    for (size_t ii = 0; ii < queue.size() && error == 0; ++ii) {
+        const auto& write = queue[ii];
+        const auto done = written[ii];
+        if (done < write.data.size() &&
+            !pwriteAll(file.fd,
+                       write.data.data() + done,
+                       write.data.size() - done,
+                       write.offset + done)) {
+            error = errno;
+        }
+    }
+    if (error == 0 && sync && !synced && fdatasync(file.fd) == -1) {
+        error = errno;
+    }
+
+    queue.clear();
+    file.queuedWriteBytes = 0;
+    if (sync) {
+        file.bytesSinceSync = 0;
+    }
+
+    if (error) {
+        errinfo->error = error;
+        return COUCHSTORE_ERROR_WRITE;
+    }
+    return COUCHSTORE_SUCCESS;
+}
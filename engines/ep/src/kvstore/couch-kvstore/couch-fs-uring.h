@@ -0,0 +1,134 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+#include <libcouchstore/couch_db.h>
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Returns the (process wide) instance of UringOps. Only available when built
+ * with liburing (EP_USE_LIBURING).
+ */
+FileOpsInterface& getCouchstoreUringOps();
+
+/**
+ * FileOpsInterface implementation which uses io_uring (via liburing) to
+ * submit several file operations with a single syscall. It is used in place
+ * of couchstore's default (POSIX) file ops when couchstore_file_ops is set to
+ * "io_uring", and is wrapped by StatsOps in the same way.
+ *
+ * - pwrite() queues the write (coalescing contiguous writes) and returns
+ *   immediately. The queued writes are submitted by sync() as one linked
+ *   chain ending with an fdatasync, so a flusher commit costs a single
+ *   submission. Queued writes are also submitted (without the sync) before a
+ *   pread(), goto_eof() or close() of the file, and when the queue is full,
+ *   so they are always visible to reads. An error of a queued write is
+ *   returned by the call which submitted it.
+ * - readAhead() reads a set of ranges of a file concurrently, so that the
+ *   following pread()s of them are served from the page cache. getMulti
+ *   uses it to read the bodies of a bgfetch batch with one submission.
+ * - pread() of a single range is a plain pread(2); there is nothing to
+ *   batch it with.
+ *
+ * Each thread has its own ring (created on first use). If a ring can't be
+ * created (for example the kernel doesn't support io_uring) the operations
+ * are performed with the equivalent blocking syscalls.
+ */
+class UringOps : public FileOpsInterface {
+public:
+    /// A range of a file to read ahead
+    struct ReadRange {
+        cs_off_t offset;
+        size_t size;
+    };
+
+    couch_file_handle constructor(couchstore_error_info_t* errinfo) override;
+    couchstore_error_t open(couchstore_error_info_t* errinfo,
+                            couch_file_handle* handle,
+                            const char* path,
+                            int oflag) override;
+    couchstore_error_t close(couchstore_error_info_t* errinfo,
+                             couch_file_handle handle) override;
+    couchstore_error_t set_periodic_sync(couch_file_handle handle,
+                                         uint64_t period_bytes) override;
+    couchstore_error_t set_tracing_enabled(couch_file_handle handle) override;
+    couchstore_error_t set_write_validation_enabled(
+            couch_file_handle handle) override;
+    couchstore_error_t set_mprotect_enabled(couch_file_handle handle) override;
+
+    ssize_t pread(couchstore_error_info_t* errinfo,
+                  couch_file_handle handle,
+                  void* buf,
+                  size_t nbytes,
+                  cs_off_t offset) override;
+    ssize_t pwrite(couchstore_error_info_t* errinfo,
+                   couch_file_handle handle,
+                   const void* buf,
+                   size_t nbytes,
+                   cs_off_t offset) override;
+    cs_off_t goto_eof(couchstore_error_info_t* errinfo,
+                      couch_file_handle handle) override;
+    couchstore_error_t sync(couchstore_error_info_t* errinfo,
+                            couch_file_handle handle) override;
+    couchstore_error_t advise(couchstore_error_info_t* errinfo,
+                              couch_file_handle handle,
+                              cs_off_t offset,
+                              cs_off_t len,
+                              couchstore_file_advice_t advice) override;
+    FHStats* get_stats(couch_file_handle handle) override;
+    void destructor(couch_file_handle handle) override;
+
+    /**
+     * Read the ranges of the file concurrently (discarding the data) so that
+     * they are in the page cache for the following preads. Errors are
+     * ignored; the pread of the range reports them.
+     *
+     * @return false if the ranges couldn't be read ahead (no ring)
+     */
+    bool readAhead(couch_file_handle handle, std::vector<ReadRange> ranges);
+
+    /// The number of entries of each thread's submission queue
+    static constexpr unsigned QueueDepth = 64;
+
+    /// Queued writes are submitted once they reach this many bytes
+    static constexpr size_t MaxQueuedWriteBytes = 4 * 1024 * 1024;
+
+    /// The maximum bytes read ahead by one submission
+    static constexpr size_t MaxReadAheadBytes = 4 * 1024 * 1024;
+
+protected:
+    struct File {
+        int fd{-1};
+        /// Sync once this many bytes were written since the last sync (0: off)
+        uint64_t periodicSyncBytes{0};
+        uint64_t bytesSinceSync{0};
+
+        struct Write {
+            cs_off_t offset;
+            std::vector<uint8_t> data;
+        };
+        /// Writes which have not been submitted yet
+        std::vector<Write> queuedWrites;
+        size_t queuedWriteBytes{0};
+    };
+
+    /**
+     * Submit the queued writes of the file, followed (and linked) by an
+     * fdatasync if sync is true. Any write the ring didn't complete is
+     * finished with pwrite(2).
+     */
+    couchstore_error_t submitWrites(couchstore_error_info_t* errinfo,
+                                    File& file,
+                                    bool sync);
+};
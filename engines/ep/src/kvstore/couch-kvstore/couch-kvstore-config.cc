@@ -65,6 +65,7 @@ CouchKVStoreConfig::CouchKVStoreConfig(Configuration& config,
             std::make_unique<ConfigChangeListener>(*this));
     midpointRollbackOptimisationEnabled =
             config.isCouchstoreMidpointRollbackOptimisation();
+    ioUringFileOps = config.getCouchstoreFileOps() == "io_uring";
 }
 
 CouchKVStoreConfig::CouchKVStoreConfig(uint16_t maxVBuckets,
@@ -80,6 +80,15 @@ public:
 
     void setCouchstoreFileCacheMaxSize(size_t value);
 
+    void setIoUringFileOps(bool value) {
+        ioUringFileOps = value;
+    }
+
+    /// Should couchstore use the io_uring file ops (see UringOps)?
+    bool isIoUringFileOps() const {
+        return ioUringFileOps;
+    }
+
     // WARNING: Not thread safe (i.e. dynamic)
     void setMidpointRollbackOptimisation(bool value) {
         midpointRollbackOptimisationEnabled = value;
@@ -106,4 +115,6 @@ private:
     std::atomic_bool couchstoreMprotectEnabled;
 
     bool midpointRollbackOptimisationEnabled{false};
+
+    bool ioUringFileOps{false};
 };
\ No newline at end of file
@@ -30,6 +30,10 @@
 #include "vbucket_bgfetch_item.h"
 #include "vbucket_state.h"
 
+#ifdef EP_USE_LIBURING
+#include "couch-fs-uring.h"
+#endif
+
 #include <JSON_checker.h>
 #include <gsl/gsl-lite.hpp>
 #include <mcbp/protocol/unsigned_leb128.h>
@@ -40,6 +44,7 @@
 #include <platform/dirutils.h>
 
 #include <spdlog/common.h>
+#include <algorithm>
 #include <charconv>
 #include <memory>
 #include <shared_mutex>
@@ -48,7 +53,9 @@
 static int bySeqnoScanCallback(Db* db, DocInfo* docinfo, void* ctx);
 static int byIdScanCallback(Db* db, DocInfo* docinfo, void* ctx);
 
+struct GetMultiCbCtx;
 static int getMultiCallback(Db* db, DocInfo* docinfo, void* ctx);
+static void getMultiFetchDoc(GetMultiCbCtx& ctx, Db* db, DocInfo* docinfo);
 
 static bool endWithCompact(const std::string &filename) {
     const std::string suffix{".compact"};
@@ -233,6 +240,29 @@ CollectionID CouchKVStore::getCollectionIdFromStatsDocId(std::string_view id) {
                            std::string(id));
 }
 
+/**
+ * A copy of a DocInfo found by couchstore_docinfos_by_id, for a getMulti
+ * which fetches the documents once all of them were found.
+ */
+struct DeferredDocInfo {
+    explicit DeferredDocInfo(const DocInfo& docinfo)
+        : info(docinfo),
+          id(docinfo.id.buf, docinfo.id.size),
+          revMeta(docinfo.rev_meta.buf, docinfo.rev_meta.size) {
+    }
+
+    /// @return the DocInfo, pointing at the copies of its buffers
+    DocInfo* get() {
+        info.id = {id.data(), id.size()};
+        info.rev_meta = {revMeta.data(), revMeta.size()};
+        return &info;
+    }
+
+    DocInfo info;
+    std::string id;
+    std::string revMeta;
+};
+
 struct GetMultiCbCtx {
     GetMultiCbCtx(const CouchKVStore& c, Vbid v, vb_bgfetch_queue_t& f)
         : cks(c), vbId(v), fetches(f) {
@@ -241,6 +271,8 @@ struct GetMultiCbCtx {
     const CouchKVStore& cks;
     Vbid vbId;
     vb_bgfetch_queue_t &fetches;
+    /// If set the callback only collects the DocInfos, to be fetched later
+    std::vector<DeferredDocInfo>* deferred{nullptr};
 };
 
 struct AllKeysCtx {
@@ -354,8 +386,22 @@ CouchRequest::CouchRequest(queued_item it)
 
 CouchRequest::~CouchRequest() = default;
 
+/// @return the FileOps couchstore should use for the configuration
+static FileOpsInterface& getBaseFileOps(const CouchKVStoreConfig& config) {
+    if (config.isIoUringFileOps()) {
+#ifdef EP_USE_LIBURING
+        return getCouchstoreUringOps();
+#else
+        config.getLogger().warn(
+                "CouchKVStore: couchstore_file_ops:io_uring isn't supported "
+                "by this build, using posix");
+#endif
+    }
+    return *couchstore_get_default_file_ops();
+}
+
 CouchKVStore::CouchKVStore(const CouchKVStoreConfig& config)
-    : CouchKVStore(config, *couchstore_get_default_file_ops()) {
+    : CouchKVStore(config, getBaseFileOps(config)) {
 }
 
 CouchKVStore::CouchKVStore(const CouchKVStoreConfig& config,
@@ -670,6 +716,27 @@ void CouchKVStore::getMulti(Vbid vb, vb_bgfetch_queue_t& itms) const {
 
     GetMultiCbCtx ctx(*this, vb, itms);
 
+    // Find all of the documents first, then fetch their bodies in file
+    // order, so a batch of fetches reads the file in one forward pass rather
+    // than seeking back and forth in key order
+    std::vector<DeferredDocInfo> deferred;
+    if (itms.size() > 1) {
+        deferred.reserve(itms.size());
+        ctx.deferred = &deferred;
+    }
+
+#ifdef EP_USE_LIBURING
+    // With the io_uring file ops also read the bodies concurrently before
+    // fetching them (from the page cache)
+    auto [fileOps, fileHandle] =
+            StatsOps::getWrappedFile(couchstore_get_db_filestats(db));
+    auto* uringOps = dynamic_cast<UringOps*>(fileOps);
+    if (uringOps) {
+        deferred.reserve(itms.size());
+        ctx.deferred = &deferred;
+    }
+#endif
+
     errCode = couchstore_docinfos_by_id(
             db, ids.data(), itms.size(), 0, getMultiCallback, &ctx);
     if (errCode != COUCHSTORE_SUCCESS) {
@@ -685,6 +752,38 @@ void CouchKVStore::getMulti(Vbid vb, vb_bgfetch_queue_t& itms) const {
         }
     }
 
+    if (ctx.deferred && errCode == COUCHSTORE_SUCCESS) {
+        std::sort(deferred.begin(),
+                  deferred.end(),
+                  [](const DeferredDocInfo& a, const DeferredDocInfo& b) {
+                      return a.info.bp < b.info.bp;
+                  });
+
+#ifdef EP_USE_LIBURING
+        if (uringOps) {
+            std::vector<UringOps::ReadRange> ranges;
+            for (auto& docinfo : deferred) {
+                auto itr = itms.find(makeDiskDocKey(docinfo.info.id));
+                if (docinfo.info.bp != 0 && itr != itms.end() &&
+                    itr->second.getValueFilter() != ValueFilter::KEYS_ONLY) {
+                    // The body is stored in 4KiB blocks which each start with
+                    // a marker byte, after an 8 byte (length and CRC) header
+                    const auto size = docinfo.info.physical_size;
+                    ranges.push_back({cs_off_t(docinfo.info.bp),
+                                      size + size / 4095 + 16});
+                }
+            }
+            if (!ranges.empty()) {
+                uringOps->readAhead(fileHandle, std::move(ranges));
+            }
+        }
+#endif
+
+        for (auto& docinfo : deferred) {
+            getMultiFetchDoc(ctx, db, docinfo.get());
+        }
+    }
+
     // If available, record how many reads() we did for this getMulti;
     // and the average reads per document.
     auto* stats = couchstore_get_db_filestats(db);
@@ -3511,32 +3610,42 @@ static int getMultiCallback(Db* db, DocInfo* docinfo, void* ctx) {
     }
 
     auto *cbCtx = static_cast<GetMultiCbCtx *>(ctx);
+    if (cbCtx->deferred) {
+        cbCtx->deferred->emplace_back(*docinfo);
+    } else {
+        getMultiFetchDoc(*cbCtx, db, docinfo);
+    }
+    return 0;
+}
+
+/// Fetch the document of the DocInfo found by getMulti
+static void getMultiFetchDoc(GetMultiCbCtx& ctx, Db* db, DocInfo* docinfo) {
     auto key = makeDiskDocKey(docinfo->id);
-    const KVStoreStats& st = cbCtx->cks.getKVStoreStat();
+    const KVStoreStats& st = ctx.cks.getKVStoreStat();
 
-    auto qitr = cbCtx->fetches.find(key);
-    if (qitr == cbCtx->fetches.end()) {
+    auto qitr = ctx.fetches.find(key);
+    if (qitr == ctx.fetches.end()) {
         // this could be a serious race condition in couchstore,
         // log a warning message and continue
-        cbCtx->cks.getLogger().warn(
+        ctx.cks.getLogger().warn(
                 "getMultiCallback: Couchstore returned invalid docinfo, no "
                 "pending bgfetch has been issued for a key in {}, seqno:{}",
-                cbCtx->vbId,
+                ctx.vbId,
                 docinfo->rev_seq);
-        return 0;
+        return;
     }
 
     vb_bgfetch_item_ctx_t& bg_itm_ctx = (*qitr).second;
 
     const auto valueFilter = bg_itm_ctx.getValueFilter();
-    couchstore_error_t errCode = cbCtx->cks.fetchDoc(
-            db, docinfo, bg_itm_ctx.value, cbCtx->vbId, valueFilter);
+    couchstore_error_t errCode = ctx.cks.fetchDoc(
+            db, docinfo, bg_itm_ctx.value, ctx.vbId, valueFilter);
     if (errCode != COUCHSTORE_SUCCESS &&
         (valueFilter != ValueFilter::KEYS_ONLY)) {
         st.numGetFailure++;
     }
 
-    bg_itm_ctx.value.setStatus(cbCtx->cks.couchErr2EngineErr(errCode));
+    bg_itm_ctx.value.setStatus(ctx.cks.couchErr2EngineErr(errCode));
 
     bool return_val_ownership_transferred = false;
     for (auto& fetch : bg_itm_ctx.getRequests()) {
@@ -3550,14 +3659,12 @@ static int getMultiCallback(Db* db, DocInfo* docinfo, void* ctx) {
         }
     }
     if (!return_val_ownership_transferred) {
-        cbCtx->cks.getLogger().warn(
+        ctx.cks.getLogger().warn(
                 "getMultiCallback called with zero items in bgfetched_list, "
                 "{}, seqno:{}",
-                cbCtx->vbId,
+                ctx.vbId,
                 docinfo->rev_seq);
     }
-
-    return 0;
 }
 
 void CouchKVStore::closeDatabaseHandle(Db* db) const {
@@ -1670,9 +1670,50 @@ std::unique_ptr<ByIdScanContext> MagmaKVStore::initByIdScanContext(
         const std::vector<ByIdRange>& ranges,
         DocumentFilter options,
         ValueFilter valOptions) const {
-    throw std::runtime_error(
-            "MagmaKVStore::initByIdScanContext (id scan) unimplemented");
-    return {};
+    auto handle = makeFileHandle(vbid);
+    if (!handle) {
+        logger->warn(
+                "MagmaKVStore::initByIdScanContext {} Failed to get file "
+                "handle",
+                vbid);
+        return nullptr;
+    }
+
+    auto& snapshot = *dynamic_cast<MagmaKVFileHandle&>(*handle).snapshot;
+    auto readState = readVBStateFromDisk(vbid, snapshot);
+    if (!readState.status.IsOK()) {
+        logger->warn(
+                "MagmaKVStore::initByIdScanContext {} failed to read "
+                "vbstate from disk. Status:{}",
+                vbid,
+                readState.status.String());
+        return nullptr;
+    }
+
+    auto [getDroppedStatus, dropped] = getDroppedCollections(vbid, snapshot);
+    if (!getDroppedStatus.OK()) {
+        logger->warn(
+                "MagmaKVStore::initByIdScanContext {} failed to get "
+                "dropped collections from disk. Status:{}",
+                vbid,
+                getDroppedStatus.String());
+    }
+
+    logger->debug("MagmaKVStore::initByIdScanContext {} ranges:{} maxSeqno:{}",
+                  vbid,
+                  ranges.size(),
+                  readState.vbstate.highSeqno);
+
+    return std::make_unique<ByIdScanContext>(
+            std::move(cb),
+            std::move(cl),
+            vbid,
+            std::move(handle),
+            ranges,
+            options,
+            valOptions,
+            dropped,
+            readState.vbstate.highSeqno);
 }
 
 scan_error_t MagmaKVStore::scan(BySeqnoScanContext& ctx) const {
@@ -1837,8 +1878,110 @@ scan_error_t MagmaKVStore::scan(BySeqnoScanContext& ctx) const {
 }
 
 scan_error_t MagmaKVStore::scan(ByIdScanContext& ctx) const {
-    throw std::runtime_error("MagmaKVStore::scan (by id scan) unimplemented");
-    return scan_failed;
+    // The ranges are read with GetRange, which reads the current state of the
+    // key index rather than the snapshot held by the context's file handle.
+    // A scan which pauses and resumes may therefore observe mutations made
+    // after the context was created (each key is still returned at most once
+    // as the scan resumes from the key it paused at).
+    const bool onlyKeys = ctx.valFilter == ValueFilter::KEYS_ONLY;
+    for (auto& range : ctx.ranges) {
+        if (range.rangeScanSuccess) {
+            continue;
+        }
+
+        bool paused = false;
+        auto callback = [&](Slice& keySlice,
+                            Slice& metaSlice,
+                            Slice& valSlice) -> bool {
+            auto diskKey = makeDiskDocKey(keySlice);
+            if (!(diskKey < range.endKey)) {
+                // The end of the range is exclusive, stop scanning
+                return true;
+            }
+
+            const auto seqno = magmakv::getSeqNum(metaSlice);
+            if (magmakv::isDeleted(metaSlice) &&
+                ctx.docFilter == DocumentFilter::NO_DELETES) {
+                return false;
+            }
+
+            ctx.diskBytesRead +=
+                    keySlice.Len() + metaSlice.Len() + valSlice.Len();
+
+            auto docKey = diskKey.getDocKey();
+            if (!docKey.isInSystemCollection()) {
+                if (ctx.docFilter !=
+                            DocumentFilter::ALL_ITEMS_AND_DROPPED_COLLECTIONS &&
+                    ctx.collectionsContext.isLogicallyDeleted(docKey, seqno)) {
+                    ctx.lastReadSeqno = seqno;
+                    return false;
+                }
+
+                CacheLookup lookup(diskKey, seqno, ctx.vbid);
+                ctx.getCacheCallback().callback(lookup);
+                const auto lookupStatus = ctx.getCacheCallback().getStatus();
+                if (lookupStatus ==
+                    static_cast<int>(cb::engine_errc::key_already_exists)) {
+                    ctx.lastReadSeqno = seqno;
+                    return false;
+                }
+                if (lookupStatus ==
+                    static_cast<int>(cb::engine_errc::no_memory)) {
+                    paused = true;
+                    ctx.lastReadKey = diskKey;
+                    return true;
+                }
+            }
+
+            auto itm = makeItem(
+                    ctx.vbid, keySlice, metaSlice, valSlice, ctx.valFilter);
+            if (ctx.valFilter == ValueFilter::VALUES_COMPRESSED &&
+                !magmakv::isCompressed(metaSlice) && !itm->compressValue()) {
+                logger->warn(
+                        "MagmaKVStore::scan failed to compress value - {} "
+                        "key:{} seqno:{}",
+                        ctx.vbid,
+                        cb::UserData{diskKey.to_string()},
+                        seqno);
+                return false;
+            }
+
+            GetValue rv(std::move(itm), cb::engine_errc::success, -1, onlyKeys);
+            ctx.getValueCallback().callback(rv);
+            if (ctx.getValueCallback().getStatus() ==
+                static_cast<int>(cb::engine_errc::no_memory)) {
+                paused = true;
+                ctx.lastReadKey = diskKey;
+                return true;
+            }
+            ctx.lastReadSeqno = seqno;
+            return false;
+        };
+
+        Slice startKeySlice = {
+                reinterpret_cast<const char*>(range.startKey.data()),
+                range.startKey.size()};
+        Slice endKeySlice = {reinterpret_cast<const char*>(range.endKey.data()),
+                             range.endKey.size()};
+        auto status = magma->GetRange(
+                ctx.vbid.get(), startKeySlice, endKeySlice, callback, !onlyKeys);
+        if (!status) {
+            logger->warn("MagmaKVStore::scan {} GetRange failed. Status:{}",
+                         ctx.vbid,
+                         status.String());
+            st.numGetFailure++;
+            return scan_failed;
+        }
+
+        if (paused) {
+            // Resume from the key we paused at
+            range.startKey = ctx.lastReadKey;
+            return scan_again;
+        }
+        range.rangeScanSuccess = true;
+    }
+
+    return scan_success;
 }
 
 void MagmaKVStore::mergeMagmaDbStatsIntoVBState(vbucket_state& vbstate,
@@ -62,6 +62,9 @@ const size_t HEADER_RESERVED(4);
  * The versions of the layout for the mutation log
  *
  * V4 is identical with V3 except that it use the HW enabled CRC32 calculation
+ *
+ * Version 5 is used by the sorted access log (see sorted_access_log.h),
+ * which has a different layout and isn't read by MutationLog.
  */
 enum class MutationLogVersion { V1 = 1, V2 = 2, V3 = 3, V4 = 4, Current = V4 };
 
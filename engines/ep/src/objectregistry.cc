@@ -30,12 +30,29 @@ static bool verifyEngine(EventuallyPersistentEngine* engine) {
     return true;
 }
 
+static size_t getBlobAllocationSize(const Blob* blob) {
+    // Embedded Blobs live inside another object's allocation; they account
+    // for the part of it reserved for the Blob, and the owner (see
+    // getStoredValueAllocationSize) for the rest.
+    if (blob->isEmbedded()) {
+        return blob->getEmbeddedReservedSize();
+    }
+    return cb::ArenaMalloc::malloc_usable_size(blob);
+}
+
+static size_t getStoredValueAllocationSize(const StoredValue* sv) {
+    // The inline value region of the allocation is accounted by the
+    // embedded Blob, so isn't counted twice.
+    return cb::ArenaMalloc::malloc_usable_size(sv) -
+           sv->getInlineValueReservedSize();
+}
+
 void ObjectRegistry::onCreateBlob(const Blob* blob) {
     EventuallyPersistentEngine* engine = th;
     if (verifyEngine(engine)) {
         auto& coreLocalStats = engine->getEpStats().coreLocal.get();
 
-        size_t size = cb::ArenaMalloc::malloc_usable_size(blob);
+        size_t size = getBlobAllocationSize(blob);
         coreLocalStats->blobOverhead.fetch_add(size - blob->getSize());
         coreLocalStats->currentSize.fetch_add(size);
         coreLocalStats->totalValueSize.fetch_add(size);
@@ -48,7 +65,7 @@ void ObjectRegistry::onDeleteBlob(const Blob* blob) {
     if (verifyEngine(engine)) {
         auto& coreLocalStats = engine->getEpStats().coreLocal.get();
 
-        size_t size = cb::ArenaMalloc::malloc_usable_size(blob);
+        size_t size = getBlobAllocationSize(blob);
         coreLocalStats->blobOverhead.fetch_sub(size - blob->getSize());
         coreLocalStats->currentSize.fetch_sub(size);
         coreLocalStats->totalValueSize.fetch_sub(size);
@@ -61,7 +78,7 @@ void ObjectRegistry::onCreateStoredValue(const StoredValue* sv) {
     if (verifyEngine(engine)) {
         auto& coreLocalStats = engine->getEpStats().coreLocal.get();
 
-        size_t size = cb::ArenaMalloc::malloc_usable_size(sv);
+        size_t size = getStoredValueAllocationSize(sv);
         coreLocalStats->numStoredVal++;
         coreLocalStats->totalStoredValSize.fetch_add(size);
     }
@@ -72,7 +89,7 @@ void ObjectRegistry::onDeleteStoredValue(const StoredValue* sv) {
     if (verifyEngine(engine)) {
         auto& coreLocalStats = engine->getEpStats().coreLocal.get();
 
-        size_t size = cb::ArenaMalloc::malloc_usable_size(sv);
+        size_t size = getStoredValueAllocationSize(sv);
         coreLocalStats->totalStoredValSize.fetch_sub(size);
         coreLocalStats->numStoredVal--;
     }
@@ -372,3 +372,57 @@ void PagingVisitor::tearDownHashBucketVisit() {
     // not be used until overwriting with a locked ReadHandle.
     readHandle.unlock();
 }
+
+ExpiredItemSweepVisitor::ExpiredItemSweepVisitor(KVBucket& store,
+                                                 EPStats& stats)
+    : store(store), stats(stats), startTime(ep_real_time()) {
+}
+
+void ExpiredItemSweepVisitor::setDeadline(
+        std::chrono::steady_clock::time_point deadline) {
+    progressTracker.setDeadline(deadline);
+}
+
+bool ExpiredItemSweepVisitor::visit(const HashTable::HashBucketLock& lh,
+                                    StoredValue& v) {
+    ++visitedCount;
+
+    // As PagingVisitor::visit: never expire a prepare, only expire items of
+    // an active vbucket
+    if (!v.isPending() && !v.isPrepareCompleted() &&
+        currentBucket->getState() == vbucket_state_active &&
+        v.isExpired(startTime) && !v.isDeleted()) {
+        expired.push_back(*v.toItem(currentBucket->getId()));
+    }
+
+    // As PagingVisitor::shouldInterrupt, pause while the disk write queue is
+    // too large
+    if (stats.diskQueueSize.load() >= MAX_PERSISTENCE_QUEUE_SIZE) {
+        return false;
+    }
+    return progressTracker.shouldContinueVisiting(visitedCount);
+}
+
+void ExpiredItemSweepVisitor::setCurrentVBucket(VBucket& vb) {
+    // Not under a HashBucketLock; expire the previous vbucket's items
+    processExpired();
+    currentBucket = &vb;
+}
+
+void ExpiredItemSweepVisitor::processExpired() {
+    if (expired.empty()) {
+        return;
+    }
+    const auto now = ep_real_time();
+    for (auto& item : expired) {
+        store.processExpiredItem(item, now, ExpireBy::Pager);
+    }
+    EP_LOG_DEBUG("Purged {} expired items", expired.size());
+    expiredCount += expired.size();
+    expired.clear();
+}
+
+void ExpiredItemSweepVisitor::clearStats() {
+    visitedCount = 0;
+    expiredCount = 0;
+}
@@ -15,6 +15,7 @@
 #include "hash_table.h"
 #include "item_eviction.h"
 #include "item_pager.h"
+#include "progress_tracker.h"
 #include "vb_visitors.h"
 
 #include <atomic>
@@ -186,3 +187,51 @@ private:
     // visits. Will contain a nullptr if we aren't currently locking anything.
     Collections::VB::ReadHandle readHandle;
 };
+
+/**
+ * The expiry pager's visitor when it takes part in the sweep of the
+ * HashTableSweeperTask (see ht_sweeper_enabled). Like a PagingVisitor of type
+ * EXPIRY_PAGER it collects the expired items of active vBuckets; they are
+ * expired outside of the HashBucketLock, when the sweep moves to the next
+ * vBucket and at the end of each chunk (processExpired()).
+ */
+class ExpiredItemSweepVisitor : public VBucketAwareHTVisitor {
+public:
+    ExpiredItemSweepVisitor(KVBucket& store, EPStats& stats);
+
+    // Set the deadline at which point the visitor will pause visiting.
+    void setDeadline(std::chrono::steady_clock::time_point deadline);
+
+    bool visit(const HashTable::HashBucketLock& lh, StoredValue& v) override;
+
+    void setCurrentVBucket(VBucket& vb) override;
+
+    /// Expire the items collected since the last call
+    void processExpired();
+
+    // Resets any held stats to zero.
+    void clearStats();
+
+    // Returns the number of documents that have been visited.
+    size_t getVisitedCount() const {
+        return visitedCount;
+    }
+
+    // Returns the number of documents that have been expired.
+    size_t getExpiredCount() const {
+        return expiredCount;
+    }
+
+private:
+    KVBucket& store;
+    EPStats& stats;
+    // Items which expired before the sweep started are expired
+    const time_t startTime;
+    // Estimates how far we have got, and when we should pause.
+    ProgressTracker progressTracker;
+    // The current vbucket that is being processed
+    VBucket* currentBucket{nullptr};
+    std::list<Item> expired;
+    size_t visitedCount{0};
+    size_t expiredCount{0};
+};
@@ -0,0 +1,326 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "range_scans/range_scan.h"
+
+#include "bucket_logger.h"
+#include "ep_bucket.h"
+#include "ep_engine.h"
+#include "ep_time.h"
+#include "item.h"
+#include "kvstore/kvstore.h"
+#include "vbucket.h"
+
+#include <mcbp/protocol/unsigned_leb128.h>
+#include <gsl/gsl-lite.hpp>
+#include <memcached/protocol_binary.h>
+
+#include <algorithm>
+
+namespace {
+/// Forwards the CacheLookup callback of the KVStore scan to the RangeScan
+class RangeScanCacheCallback : public StatusCallback<CacheLookup> {
+public:
+    explicit RangeScanCacheCallback(RangeScan& scan) : scan(scan) {
+    }
+
+    void callback(CacheLookup& lookup) override {
+        setStatus(scan.handleLookup(lookup));
+    }
+
+private:
+    RangeScan& scan;
+};
+
+/// Forwards the GetValue callback of the KVStore scan to the RangeScan
+class RangeScanDataCallback : public StatusCallback<GetValue> {
+public:
+    explicit RangeScanDataCallback(RangeScan& scan) : scan(scan) {
+    }
+
+    void callback(GetValue& val) override {
+        scan.handleItem(std::move(val.item));
+        setStatus(cb::engine_errc::success);
+    }
+
+private:
+    RangeScan& scan;
+};
+
+void appendLeb128(std::string& buffer, size_t value) {
+    cb::mcbp::unsigned_leb128<uint32_t> leb128(gsl::narrow<uint32_t>(value));
+    buffer.append(reinterpret_cast<const char*>(leb128.data()), leb128.size());
+}
+} // namespace
+
+RangeScan::RangeScan(
+        EPBucket& bucket,
+        const VBucket& vbucket,
+        uint32_t connectionId,
+        CollectionID cid,
+        DiskDocKey start,
+        DiskDocKey end,
+        cb::rangescan::KeyOnly keyOnly,
+        ValueFilter valueFilter,
+        std::optional<cb::rangescan::SamplingConfiguration> samplingConfig,
+        size_t collectionItemCount)
+    : bucket(bucket),
+      id(cb::uuid::random()),
+      vbid(vbucket.getId()),
+      connectionId(connectionId),
+      cid(cid),
+      keyOnly(keyOnly),
+      valueFilter(keyOnly == cb::rangescan::KeyOnly::Yes
+                          ? ValueFilter::KEYS_ONLY
+                          : valueFilter),
+      lastActivity(ep_current_time()) {
+    std::vector<ByIdRange> ranges;
+    ranges.emplace_back(std::move(start), std::move(end));
+
+    scanCtx = bucket.getROUnderlying(vbid)->initByIdScanContext(
+            std::make_unique<RangeScanDataCallback>(*this),
+            std::make_unique<RangeScanCacheCallback>(*this),
+            vbid,
+            ranges,
+            DocumentFilter::NO_DELETES,
+            this->valueFilter);
+    if (!scanCtx) {
+        throw cb::engine_error(
+                cb::engine_errc::failed,
+                fmt::format("RangeScan:: {} failed to create the scan context",
+                            vbid));
+    }
+
+    if (samplingConfig) {
+        // Choose each key with a probability which gives (on average) the
+        // requested number of samples
+        const double probability =
+                collectionItemCount == 0
+                        ? 1.0
+                        : std::min(1.0,
+                                   double(samplingConfig->samples) /
+                                           double(collectionItemCount));
+        sampling.emplace(*samplingConfig, probability);
+    }
+
+    ++bucket.getNumRangeScans();
+    EP_LOG_DEBUG("RangeScan::RangeScan {} created for {} keyOnly:{}",
+                 cb::uuid::to_string(id),
+                 vbid,
+                 isKeyOnly());
+}
+
+RangeScan::~RangeScan() {
+    --bucket.getNumRangeScans();
+}
+
+cb::engine_errc RangeScan::prepareToContinue(
+        const CookieIface& cookie,
+        const cb::rangescan::ContinueLimits& limits) {
+    std::lock_guard<std::mutex> guard(mutex);
+    if (state != State::Idle) {
+        return cb::engine_errc::too_busy;
+    }
+    state = State::Continuing;
+    continueCookie = &cookie;
+    result.reset();
+    lastActivity = ep_current_time();
+    this->limits = limits;
+    return cb::engine_errc::success;
+}
+
+void RangeScan::continueOnIOThread(const KVStoreIface& kvstore) {
+    const CookieIface* cookie;
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        cookie = continueCookie;
+    }
+
+    itemsRead = 0;
+    buffer.clear();
+    deadline = std::chrono::steady_clock::now() + limits.time;
+
+    auto status = cb::mcbp::Status::Einternal;
+    vbucket = bucket.getVBucket(vbid);
+    if (!vbucket) {
+        status = cb::mcbp::Status::NotMyVbucket;
+    } else if (!cancelled) {
+        switch (kvstore.scan(*scanCtx)) {
+        case scan_success:
+            status = cb::mcbp::Status::RangeScanComplete;
+            break;
+        case scan_again:
+            if (cancelled) {
+                status = cb::mcbp::Status::RangeScanCancelled;
+            } else if (sampling && sampling->remaining == 0) {
+                status = cb::mcbp::Status::RangeScanComplete;
+            } else {
+                status = cb::mcbp::Status::RangeScanMore;
+            }
+            break;
+        case scan_failed:
+            EP_LOG_WARN("RangeScan::continueOnIOThread {} {} scan failed",
+                        cb::uuid::to_string(id),
+                        vbid);
+            status = cb::mcbp::Status::Einternal;
+            break;
+        }
+    }
+    vbucket.reset();
+
+    if (cancelled) {
+        status = cb::mcbp::Status::RangeScanCancelled;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        result = Result{cookie, status, std::move(buffer)};
+        continueCookie = nullptr;
+        state = cancelled ? State::Cancelled : State::Idle;
+    }
+    buffer = {};
+
+    bucket.getEPEngine().notifyIOComplete(cookie, cb::engine_errc::success);
+}
+
+bool RangeScan::takeContinueResult(const CookieIface& cookie,
+                                   cb::mcbp::Status& status,
+                                   std::string& data) {
+    std::lock_guard<std::mutex> guard(mutex);
+    if (!result || result->cookie != &cookie) {
+        return false;
+    }
+    status = result->status;
+    data = std::move(result->data);
+    result.reset();
+    lastActivity = ep_current_time();
+    return true;
+}
+
+bool RangeScan::cancel() {
+    cancelled = true;
+    std::lock_guard<std::mutex> guard(mutex);
+    if (state == State::Continuing) {
+        return false;
+    }
+    state = State::Cancelled;
+    return true;
+}
+
+bool RangeScan::isIdleSince(rel_time_t time) const {
+    std::lock_guard<std::mutex> guard(mutex);
+    return state != State::Continuing && lastActivity < time;
+}
+
+bool RangeScan::shouldPause() const {
+    if (cancelled) {
+        return true;
+    }
+    if (limits.items && itemsRead >= limits.items) {
+        return true;
+    }
+    if (limits.bytes && buffer.size() >= limits.bytes) {
+        return true;
+    }
+    return limits.time.count() && std::chrono::steady_clock::now() >= deadline;
+}
+
+bool RangeScan::sampleNextKey() {
+    if (!sampling) {
+        return true;
+    }
+    return sampling->distribution(sampling->prng);
+}
+
+cb::engine_errc RangeScan::handleLookup(CacheLookup& lookup) {
+    // Pausing leaves the scan positioned at this key, so the key is looked
+    // up again by the next continue
+    if (shouldPause() || (sampling && sampling->remaining == 0)) {
+        return cb::engine_errc::no_memory;
+    }
+
+    if (!sampleNextKey()) {
+        return cb::engine_errc::key_already_exists;
+    }
+
+    if (isKeyOnly()) {
+        // The KVStore only reads the metadata for a key only scan
+        return cb::engine_errc::success;
+    }
+
+    // Serve the value from memory if the same revision is resident
+    auto& ht = vbucket->ht;
+    auto res = ht.findForRead(lookup.getKey().getDocKey(),
+                              TrackReference::No,
+                              WantsDeleted::No);
+    if (res.storedValue && res.storedValue->isCommitted() &&
+        res.storedValue->isResident() &&
+        res.storedValue->getBySeqno() == lookup.getBySeqno()) {
+        auto item = res.storedValue->toItem(vbid);
+        res.lock.getHTLock().unlock();
+        handleItem(std::move(item));
+        return cb::engine_errc::key_already_exists;
+    }
+
+    return cb::engine_errc::success;
+}
+
+void RangeScan::handleItem(std::unique_ptr<Item> item) {
+    if (!item) {
+        return;
+    }
+
+    const auto exptime = item->getExptime();
+    if (item->isDeleted() || (exptime != 0 && exptime <= ep_real_time())) {
+        // Skip deleted documents, and documents which expired but the
+        // expiry pager (or compaction) didn't get around to deleting yet
+        return;
+    }
+
+    if (isKeyOnly()) {
+        const auto keyNoCid = item->getKey().makeDocKeyWithoutCollectionID();
+        appendLeb128(buffer, keyNoCid.size());
+        buffer.append(reinterpret_cast<const char*>(keyNoCid.data()),
+                      keyNoCid.size());
+    } else {
+        if (valueFilter == ValueFilter::VALUES_DECOMPRESSED &&
+            mcbp::datatype::is_snappy(item->getDataType())) {
+            item->decompressValue();
+        }
+        appendItem(*item);
+    }
+
+    ++itemsRead;
+    if (sampling) {
+        --sampling->remaining;
+    }
+}
+
+void RangeScan::appendItem(const Item& item) {
+    const cb::mcbp::response::RangeScanDocumentMeta meta(
+            item.getFlags(),
+            gsl::narrow_cast<uint32_t>(item.getExptime()),
+            item.getBySeqno(),
+            item.getCas(),
+            item.getDataType());
+    const auto metaBuffer = meta.getBuffer();
+    const auto keyNoCid = item.getKey().makeDocKeyWithoutCollectionID();
+    const auto value = item.getValueView();
+
+    buffer.reserve(buffer.size() + metaBuffer.size() + keyNoCid.size() +
+                   value.size() + 10);
+    buffer.append(metaBuffer);
+    appendLeb128(buffer, keyNoCid.size());
+    buffer.append(reinterpret_cast<const char*>(keyNoCid.data()),
+                  keyNoCid.size());
+    appendLeb128(buffer, value.size());
+    buffer.append(value);
+}
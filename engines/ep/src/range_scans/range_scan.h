@@ -0,0 +1,233 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+#include "callbacks.h"
+#include "diskdockey.h"
+#include "ep_types.h"
+#include "range_scans/range_scan_types.h"
+#include "vbucket_fwd.h"
+
+#include <mcbp/protocol/status.h>
+#include <memcached/dockey.h>
+#include <memcached/engine_error.h>
+#include <memcached/types.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+
+class ByIdScanContext;
+class CookieIface;
+class EPBucket;
+class Item;
+class KVStoreIface;
+class VBucket;
+enum class ValueFilter;
+
+/**
+ * A RangeScan reads the keys (or documents) of a single collection from the
+ * by-id index of a vBucket, one batch per continue.
+ *
+ * The scan is created by a RangeScanCreateTask (which opens the KVStore
+ * snapshot) and is then driven by the client: each RangeScanContinue queues
+ * the scan for a RangeScanContinueTask which reads from the KVStore until one
+ * of the limits of the continue is reached, then stores the batch and
+ * notifies the cookie. The front-end thread then takes the batch and sends it
+ * to the client. Only one continue may be in progress at a time.
+ *
+ * A scan belongs to the connection which created it. It is cancelled when
+ * that connection disconnects, when the vBucket stops being active (or is
+ * deleted), or once it has been idle for range_scan_idle_timeout.
+ */
+class RangeScan {
+public:
+    /**
+     * Create a scan of [start, end) and open the KVStore scan context.
+     *
+     * @param bucket The bucket owning the vBucket
+     * @param vbucket The vBucket to scan
+     * @param connectionId The id of the connection creating the scan
+     * @param cid The collection being scanned (the keys must belong to it)
+     * @param start The first key of the range (inclusive)
+     * @param end The end of the range (exclusive)
+     * @param keyOnly Return only the keys
+     * @param valueFilter How to read the values (ignored for key only scans)
+     * @param samplingConfig Set for a random sample scan
+     * @param collectionItemCount The number of items in the collection (used
+     *        to calculate the probability of sampling a key)
+     * @throws cb::engine_error if the scan context can't be created
+     */
+    RangeScan(EPBucket& bucket,
+              const VBucket& vbucket,
+              uint32_t connectionId,
+              CollectionID cid,
+              DiskDocKey start,
+              DiskDocKey end,
+              cb::rangescan::KeyOnly keyOnly,
+              ValueFilter valueFilter,
+              std::optional<cb::rangescan::SamplingConfiguration>
+                      samplingConfig,
+              size_t collectionItemCount);
+
+    ~RangeScan();
+
+    cb::rangescan::Id getId() const {
+        return id;
+    }
+
+    Vbid getVBucketId() const {
+        return vbid;
+    }
+
+    uint32_t getConnectionId() const {
+        return connectionId;
+    }
+
+    CollectionID getCollectionID() const {
+        return cid;
+    }
+
+    bool isKeyOnly() const {
+        return keyOnly == cb::rangescan::KeyOnly::Yes;
+    }
+
+    /**
+     * Prepare the scan to be continued for the cookie. A result which was
+     * never collected (for example because the connection which requested it
+     * disconnected) is discarded.
+     *
+     * @param cookie The cookie to notify once the continue completes
+     * @param limits The limits of the continue
+     * @return success if the scan may be queued for a RangeScanContinueTask,
+     *         or too_busy if a continue is already in progress
+     */
+    cb::engine_errc prepareToContinue(const CookieIface& cookie,
+                                      const cb::rangescan::ContinueLimits&
+                                              limits);
+
+    /**
+     * Read the next batch of the scan from the KVStore, store it as the
+     * result of the continue and notify the cookie. Called by the
+     * RangeScanContinueTask.
+     *
+     * @param kvstore The KVStore the scan context was created from
+     */
+    void continueOnIOThread(const KVStoreIface& kvstore);
+
+    /**
+     * Take the result of a completed continue for the cookie.
+     *
+     * @param cookie The cookie which requested the continue
+     * @param status Set to RangeScanMore, RangeScanComplete,
+     *        RangeScanCancelled or an error status
+     * @param data The keys (or documents) read by the continue
+     * @return true if the result was taken, false if there's no completed
+     *         continue for the cookie
+     */
+    bool takeContinueResult(const CookieIface& cookie,
+                            cb::mcbp::Status& status,
+                            std::string& data);
+
+    /**
+     * Cancel the scan.
+     *
+     * @return true if no continue was in progress and the scan may be
+     *         removed immediately, false if a continue is in progress (the
+     *         continue completes with RangeScanCancelled and the scan is
+     *         removed once the result is taken)
+     */
+    bool cancel();
+
+    /**
+     * @return true if no continue is in progress and the client hasn't used
+     *         the scan since the given time
+     */
+    bool isIdleSince(rel_time_t time) const;
+
+    /**
+     * Called (via the scan's CacheLookup callback) for each key before its
+     * value is read.
+     *
+     * @return success to read the document from disk, key_already_exists if
+     *         the key was handled (or skipped) without reading it, or
+     *         no_memory to pause the scan at this key
+     */
+    cb::engine_errc handleLookup(CacheLookup& lookup);
+
+    /// Called (via the scan's GetValue callback) for each document read
+    void handleItem(std::unique_ptr<Item> item);
+
+protected:
+    enum class State : uint8_t { Idle, Continuing, Cancelled };
+
+    /// @return true if the continue must stop before the next key
+    bool shouldPause() const;
+
+    /// Append the key (or document) to the continue buffer
+    void appendItem(const Item& item);
+
+    /// @return true if the next key is chosen by the sample
+    bool sampleNextKey();
+
+    EPBucket& bucket;
+    const cb::rangescan::Id id;
+    const Vbid vbid;
+    const uint32_t connectionId;
+    const CollectionID cid;
+    const cb::rangescan::KeyOnly keyOnly;
+    const ValueFilter valueFilter;
+
+    std::unique_ptr<ByIdScanContext> scanCtx;
+
+    /// Random sampling state, only set for a random sample scan
+    struct Sampling {
+        Sampling(const cb::rangescan::SamplingConfiguration& config,
+                 double probability)
+            : prng(config.seed),
+              distribution(probability),
+              remaining(config.samples) {
+        }
+        std::mt19937 prng;
+        std::bernoulli_distribution distribution;
+        size_t remaining;
+    };
+    std::optional<Sampling> sampling;
+
+    // The state of the continue in progress, only accessed by the
+    // RangeScanContinueTask while it runs the continue
+    cb::rangescan::ContinueLimits limits;
+    std::chrono::steady_clock::time_point deadline;
+    size_t itemsRead{0};
+    std::string buffer;
+    VBucketPtr vbucket;
+
+    /// Set by cancel() so that a running continue stops early
+    std::atomic<bool> cancelled{false};
+
+    /// Protects the members below, which are shared with front-end threads
+    mutable std::mutex mutex;
+    State state{State::Idle};
+    const CookieIface* continueCookie{nullptr};
+    struct Result {
+        const CookieIface* cookie{nullptr};
+        cb::mcbp::Status status{cb::mcbp::Status::Success};
+        std::string data;
+    };
+    std::optional<Result> result;
+    /// When the client last created, continued or collected the scan
+    rel_time_t lastActivity;
+};
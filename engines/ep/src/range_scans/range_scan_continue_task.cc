@@ -0,0 +1,39 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "range_scans/range_scan_continue_task.h"
+
+#include "ep_bucket.h"
+#include "ep_engine.h"
+#include "range_scans/range_scan_owner.h"
+
+#include <phosphor/phosphor.h>
+
+RangeScanContinueTask::RangeScanContinueTask(EPBucket& bucket)
+    : GlobalTask(&bucket.getEPEngine(),
+                 TaskId::RangeScanContinueTask,
+                 0,
+                 false),
+      bucket(bucket) {
+}
+
+bool RangeScanContinueTask::run() {
+    TRACE_EVENT0("ep-engine/task", "RangeScanContinueTask");
+    auto scan = bucket.getReadyRangeScans().takeNextScan();
+    if (!scan) {
+        // Nothing left to do, ReadyRangeScans::addScan will schedule a new
+        // task when needed
+        return false;
+    }
+
+    scan->continueOnIOThread(*bucket.getROUnderlying(scan->getVBucketId()));
+    return true;
+}
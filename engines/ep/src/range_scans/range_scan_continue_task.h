@@ -0,0 +1,40 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+#include <executor/globaltask.h>
+
+class EPBucket;
+
+/**
+ * RangeScanContinueTask runs the continues queued in the bucket's
+ * ReadyRangeScans, one scan per run() until the queue is empty.
+ */
+class RangeScanContinueTask : public GlobalTask {
+public:
+    explicit RangeScanContinueTask(EPBucket& bucket);
+
+    std::string getDescription() const override {
+        return "RangeScanContinueTask";
+    }
+
+    std::chrono::microseconds maxExpectedDuration() const override {
+        // A continue is bounded by the limits of the request (which include
+        // a byte limit), so it should be comparable to a backfill run
+        return std::chrono::milliseconds(100);
+    }
+
+    bool run() override;
+
+private:
+    EPBucket& bucket;
+};
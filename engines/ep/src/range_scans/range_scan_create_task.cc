@@ -0,0 +1,100 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "range_scans/range_scan_create_task.h"
+
+#include "bucket_logger.h"
+#include "ep_bucket.h"
+#include "ep_engine.h"
+#include "ep_vb.h"
+#include "range_scans/range_scan.h"
+
+#include <memcached/cookie_iface.h>
+#include <phosphor/phosphor.h>
+
+RangeScanCreateTask::RangeScanCreateTask(
+        EPBucket& bucket,
+        Vbid vbid,
+        const CookieIface* cookie,
+        CollectionID cid,
+        DiskDocKey start,
+        DiskDocKey end,
+        cb::rangescan::KeyOnly keyOnly,
+        ValueFilter valueFilter,
+        std::optional<cb::rangescan::SamplingConfiguration> samplingConfig,
+        size_t collectionItemCount)
+    : GlobalTask(&bucket.getEPEngine(),
+                 TaskId::RangeScanCreateTask,
+                 0,
+                 false),
+      bucket(bucket),
+      vbid(vbid),
+      cookie(cookie),
+      cid(cid),
+      start(std::move(start)),
+      end(std::move(end)),
+      keyOnly(keyOnly),
+      valueFilter(valueFilter),
+      samplingConfig(std::move(samplingConfig)),
+      collectionItemCount(collectionItemCount) {
+}
+
+std::string RangeScanCreateTask::getDescription() const {
+    return fmt::format("RangeScanCreateTask for {}", vbid);
+}
+
+bool RangeScanCreateTask::run() {
+    TRACE_EVENT0("ep-engine/task", "RangeScanCreateTask");
+    auto [status, id] = create();
+    auto& engine = bucket.getEPEngine();
+    if (status == cb::engine_errc::success) {
+        bucket.setCreatedRangeScan(cookie, id);
+    }
+    // The core only calls back into the engine for success, an error is
+    // returned to the client directly
+    engine.notifyIOComplete(cookie, status);
+    return false;
+}
+
+std::pair<cb::engine_errc, cb::rangescan::Id> RangeScanCreateTask::create() {
+    auto vb = bucket.getVBucket(vbid);
+    if (!vb) {
+        return {cb::engine_errc::not_my_vbucket, {}};
+    }
+
+    std::shared_ptr<RangeScan> scan;
+    try {
+        scan = std::make_shared<RangeScan>(bucket,
+                                           *vb,
+                                           cookie->getConnectionId(),
+                                           cid,
+                                           std::move(start),
+                                           std::move(end),
+                                           keyOnly,
+                                           valueFilter,
+                                           samplingConfig,
+                                           collectionItemCount);
+    } catch (const cb::engine_error& e) {
+        EP_LOG_WARN("RangeScanCreateTask {} failed: {}", vbid, e.what());
+        return {cb::engine_errc(e.code().value()), {}};
+    }
+
+    // The scan is only added if the vBucket is still active; a state change
+    // cancels the scans of the vBucket under the same lock
+    folly::SharedMutex::ReadHolder rlh(vb->getStateLock());
+    if (vb->getState() != vbucket_state_active) {
+        return {cb::engine_errc::not_my_vbucket, {}};
+    }
+    const auto id = scan->getId();
+    static_cast<EPVBucket&>(*vb).getRangeScans().addNewScan(std::move(scan));
+    bucket.scheduleRangeScanTimeoutTask();
+    return {cb::engine_errc::success, id};
+}
@@ -0,0 +1,72 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+#include "diskdockey.h"
+#include "range_scans/range_scan_types.h"
+
+#include <executor/globaltask.h>
+#include <memcached/engine_error.h>
+
+#include <optional>
+
+class CookieIface;
+class EPBucket;
+enum class ValueFilter;
+
+/**
+ * RangeScanCreateTask creates a RangeScan on an AuxIO thread, as opening the
+ * KVStore scan context reads from disk. On success the id of the new scan is
+ * stored as the engine specific data of the cookie (see
+ * EPBucket::createRangeScan), otherwise the cookie is notified with the
+ * error.
+ */
+class RangeScanCreateTask : public GlobalTask {
+public:
+    RangeScanCreateTask(
+            EPBucket& bucket,
+            Vbid vbid,
+            const CookieIface* cookie,
+            CollectionID cid,
+            DiskDocKey start,
+            DiskDocKey end,
+            cb::rangescan::KeyOnly keyOnly,
+            ValueFilter valueFilter,
+            std::optional<cb::rangescan::SamplingConfiguration>
+                    samplingConfig,
+            size_t collectionItemCount);
+
+    std::string getDescription() const override;
+
+    std::chrono::microseconds maxExpectedDuration() const override {
+        // Opening a scan context is a few reads of the file header and index
+        // roots
+        return std::chrono::milliseconds(100);
+    }
+
+    bool run() override;
+
+private:
+    /// Create the scan and add it to the vBucket
+    std::pair<cb::engine_errc, cb::rangescan::Id> create();
+
+    EPBucket& bucket;
+    const Vbid vbid;
+    const CookieIface* cookie;
+    const CollectionID cid;
+    DiskDocKey start;
+    DiskDocKey end;
+    const cb::rangescan::KeyOnly keyOnly;
+    const ValueFilter valueFilter;
+    const std::optional<cb::rangescan::SamplingConfiguration> samplingConfig;
+    const size_t collectionItemCount;
+};
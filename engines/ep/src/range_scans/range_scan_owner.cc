@@ -0,0 +1,102 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "range_scans/range_scan_owner.h"
+
+#include "ep_bucket.h"
+#include "ep_engine.h"
+#include "range_scans/range_scan_continue_task.h"
+
+#include <executor/executorpool.h>
+
+ReadyRangeScans::ReadyRangeScans(EPBucket& bucket) : bucket(bucket) {
+}
+
+size_t ReadyRangeScans::getMaxTasks() const {
+    const auto configured = bucket.getEPEngine()
+                                    .getConfiguration()
+                                    .getRangeScanMaxContinueTasks();
+    if (configured) {
+        return configured;
+    }
+    return std::max(size_t(1), ExecutorPool::get()->getNumAuxIO());
+}
+
+void ReadyRangeScans::addScan(std::shared_ptr<RangeScan> scan) {
+    bool schedule = false;
+    {
+        auto locked = queue.lock();
+        locked->scans.push_back(std::move(scan));
+        if (locked->tasks < getMaxTasks()) {
+            ++locked->tasks;
+            schedule = true;
+        }
+    }
+
+    if (schedule) {
+        ExecutorPool::get()->schedule(
+                std::make_shared<RangeScanContinueTask>(bucket));
+    }
+}
+
+std::shared_ptr<RangeScan> ReadyRangeScans::takeNextScan() {
+    auto locked = queue.lock();
+    if (locked->scans.empty()) {
+        --locked->tasks;
+        return {};
+    }
+    auto scan = std::move(locked->scans.front());
+    locked->scans.pop_front();
+    return scan;
+}
+
+namespace VB {
+
+void RangeScanOwner::addNewScan(std::shared_ptr<RangeScan> scan) {
+    const auto id = scan->getId();
+    rangeScans.wlock()->emplace(id, std::move(scan));
+}
+
+std::shared_ptr<RangeScan> RangeScanOwner::getScan(
+        const cb::rangescan::Id& id) const {
+    auto locked = rangeScans.rlock();
+    auto itr = locked->find(id);
+    if (itr == locked->end()) {
+        return {};
+    }
+    return itr->second;
+}
+
+void RangeScanOwner::eraseScan(const cb::rangescan::Id& id) {
+    rangeScans.wlock()->erase(id);
+}
+
+size_t RangeScanOwner::cancelScans(
+        const std::function<bool(const RangeScan&)>& predicate) {
+    size_t cancelled = 0;
+    auto locked = rangeScans.wlock();
+    for (auto itr = locked->begin(); itr != locked->end();) {
+        if (predicate(*itr->second)) {
+            itr->second->cancel();
+            itr = locked->erase(itr);
+            ++cancelled;
+        } else {
+            ++itr;
+        }
+    }
+    return cancelled;
+}
+
+void RangeScanOwner::cancelAllScans() {
+    cancelScans([](const RangeScan&) { return true; });
+}
+
+} // namespace VB
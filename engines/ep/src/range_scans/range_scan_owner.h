@@ -0,0 +1,104 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+#include "range_scans/range_scan.h"
+
+#include <folly/Synchronized.h>
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+class EPBucket;
+
+/**
+ * ReadyRangeScans is the queue of scans which have a continue request
+ * waiting to be run. Scans are run by RangeScanContinueTasks (on the AuxIO
+ * threads), and the number of tasks is limited so that range scans can't
+ * occupy every AuxIO thread (and starve backfills and bgfetches of
+ * read-ahead I/O). A task runs one continue at a time, taking scans from the
+ * queue until it is empty.
+ */
+class ReadyRangeScans {
+public:
+    explicit ReadyRangeScans(EPBucket& bucket);
+
+    /**
+     * Queue the scan and schedule a RangeScanContinueTask if fewer than the
+     * maximum number of tasks are running.
+     */
+    void addScan(std::shared_ptr<RangeScan> scan);
+
+    /**
+     * Take the next scan to continue. If there are no more scans the caller
+     * (a RangeScanContinueTask) is counted as finished.
+     *
+     * @return the next scan, or nullptr if there are no more scans
+     */
+    std::shared_ptr<RangeScan> takeNextScan();
+
+protected:
+    /// @return the maximum number of RangeScanContinueTasks
+    size_t getMaxTasks() const;
+
+    EPBucket& bucket;
+
+    struct Queue {
+        std::deque<std::shared_ptr<RangeScan>> scans;
+        /// The number of RangeScanContinueTasks scheduled
+        size_t tasks{0};
+    };
+    folly::Synchronized<Queue, std::mutex> queue;
+};
+
+namespace VB {
+
+/**
+ * RangeScanOwner is the collection of range scans which exist in a vBucket,
+ * indexed by their id.
+ */
+class RangeScanOwner {
+public:
+    /// Add a new scan
+    void addNewScan(std::shared_ptr<RangeScan> scan);
+
+    /// @return the scan with the id, or nullptr if there's no such scan
+    std::shared_ptr<RangeScan> getScan(const cb::rangescan::Id& id) const;
+
+    /// Remove the scan with the id (if it exists)
+    void eraseScan(const cb::rangescan::Id& id);
+
+    /**
+     * Cancel and remove the scans which match the predicate. A continue in
+     * progress completes with RangeScanCancelled, but the scan can no longer
+     * be found by the client.
+     *
+     * @return the number of scans cancelled
+     */
+    size_t cancelScans(const std::function<bool(const RangeScan&)>& predicate);
+
+    /// Cancel all of the scans (when the vBucket stops being active)
+    void cancelAllScans();
+
+    size_t size() const {
+        return rangeScans.rlock()->size();
+    }
+
+protected:
+    folly::Synchronized<std::map<cb::rangescan::Id, std::shared_ptr<RangeScan>>>
+            rangeScans;
+};
+
+} // namespace VB
@@ -0,0 +1,37 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "range_scans/range_scan_timeout_task.h"
+
+#include "ep_bucket.h"
+#include "ep_engine.h"
+
+#include <phosphor/phosphor.h>
+
+RangeScanTimeoutTask::RangeScanTimeoutTask(EPBucket& bucket)
+    : GlobalTask(&bucket.getEPEngine(),
+                 TaskId::RangeScanTimeoutTask,
+                 bucket.getEPEngine()
+                         .getConfiguration()
+                         .getRangeScanIdleTimeout(),
+                 false),
+      bucket(bucket) {
+}
+
+bool RangeScanTimeoutTask::run() {
+    TRACE_EVENT0("ep-engine/task", "RangeScanTimeoutTask");
+    bucket.cancelIdleRangeScans();
+    if (!bucket.rangeScanTimeoutTaskShouldRun()) {
+        return false;
+    }
+    snooze(bucket.getEPEngine().getConfiguration().getRangeScanIdleTimeout());
+    return true;
+}
@@ -0,0 +1,42 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+#include <executor/globaltask.h>
+
+class EPBucket;
+
+/**
+ * RangeScanTimeoutTask cancels the range scans which have been idle for
+ * longer than range_scan_idle_timeout, so a client which goes away without
+ * cancelling its scans doesn't pin their KVStore snapshots. The task only
+ * runs while the bucket has range scans (see
+ * EPBucket::scheduleRangeScanTimeoutTask), checking once per timeout period.
+ */
+class RangeScanTimeoutTask : public GlobalTask {
+public:
+    explicit RangeScanTimeoutTask(EPBucket& bucket);
+
+    std::string getDescription() const override {
+        return "Cancel idle range scans";
+    }
+
+    std::chrono::microseconds maxExpectedDuration() const override {
+        // Visits the (small) map of range scans of each vBucket
+        return std::chrono::milliseconds(10);
+    }
+
+    bool run() override;
+
+private:
+    EPBucket& bucket;
+};
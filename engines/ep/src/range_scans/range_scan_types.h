@@ -0,0 +1,45 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+#include <platform/uuid.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace cb::rangescan {
+
+/// The identifier of a scan, returned by RangeScanCreate
+using Id = cb::uuid::uuid_t;
+
+/// Does the scan return only the keys or the documents
+enum class KeyOnly : bool { No, Yes };
+
+/**
+ * A random sample scan returns (approximately) samples keys of the
+ * collection, chosen with a PRNG seeded with seed (so a scan of the same
+ * data with the same seed returns the same keys).
+ */
+struct SamplingConfiguration {
+    size_t samples{0};
+    uint32_t seed{0};
+};
+
+/// The limits of a single continue. 0 means no limit
+struct ContinueLimits {
+    size_t items{0};
+    std::chrono::milliseconds time{0};
+    size_t bytes{0};
+};
+
+} // namespace cb::rangescan
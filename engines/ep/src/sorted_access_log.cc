@@ -0,0 +1,275 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "sorted_access_log.h"
+
+#include <folly/FileUtil.h>
+#include <folly/lang/Bits.h>
+#include <folly/system/MemoryMapping.h>
+#include <gsl/gsl-lite.hpp>
+#include <mcbp/protocol/unsigned_leb128.h>
+#include <platform/crc32c.h>
+#include <platform/dirutils.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+const size_t HeaderSize = 32;
+const size_t IndexEntrySize = 32;
+
+template <typename T>
+void put(uint8_t* buf, size_t& pos, T value) {
+    value = folly::Endian::big(value);
+    std::memcpy(buf + pos, &value, sizeof(value));
+    pos += sizeof(value);
+}
+
+template <typename T>
+T get(const uint8_t* buf, size_t& pos) {
+    T value;
+    std::memcpy(&value, buf + pos, sizeof(value));
+    pos += sizeof(value);
+    return folly::Endian::big(value);
+}
+
+void putLeb128(std::vector<uint8_t>& buf, uint32_t value) {
+    cb::mcbp::unsigned_leb128<uint32_t> leb(value);
+    buf.insert(buf.end(), leb.begin(), leb.end());
+}
+} // namespace
+
+SortedAccessLogWriter::SortedAccessLogWriter(std::string path)
+    : path(std::move(path)) {
+    file = fopen(this->path.c_str(), "wb");
+    if (!file) {
+        throw MutationLog::WriteException("Failed to create '" + this->path +
+                                          "': " + strerror(errno));
+    }
+    // The header is written by close(), once the index is known
+    std::array<uint8_t, HeaderSize> header{};
+    write(header.data(), header.size());
+}
+
+SortedAccessLogWriter::~SortedAccessLogWriter() {
+    if (file) {
+        fclose(file);
+    }
+}
+
+void SortedAccessLogWriter::finishVBucket(Vbid vbid) {
+    if (keys.empty()) {
+        return;
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    regionBuffer.clear();
+    std::string_view prev;
+    for (const auto& key : keys) {
+        const std::string_view current{
+                reinterpret_cast<const char*>(key.data()), key.size()};
+        const size_t shared = std::mismatch(prev.begin(),
+                                            prev.end(),
+                                            current.begin(),
+                                            current.end())
+                                      .first -
+                              prev.begin();
+        putLeb128(regionBuffer, gsl::narrow<uint32_t>(shared));
+        putLeb128(regionBuffer,
+                  gsl::narrow<uint32_t>(current.size() - shared));
+        regionBuffer.insert(
+                regionBuffer.end(), current.begin() + shared, current.end());
+        prev = current;
+    }
+
+    index.push_back({vbid,
+                     crc32c(regionBuffer.data(), regionBuffer.size(), 0),
+                     offset,
+                     regionBuffer.size(),
+                     keys.size()});
+    write(regionBuffer.data(), regionBuffer.size());
+    numKeys += keys.size();
+    keys.clear();
+}
+
+void SortedAccessLogWriter::close() {
+    if (!file) {
+        throw std::logic_error("SortedAccessLogWriter::close: '" + path +
+                               "' is already closed");
+    }
+
+    std::vector<uint8_t> indexBuffer(index.size() * IndexEntrySize);
+    size_t pos = 0;
+    for (const auto& entry : index) {
+        put<uint16_t>(indexBuffer.data(), pos, entry.vbid.get());
+        put<uint16_t>(indexBuffer.data(), pos, 0);
+        put<uint32_t>(indexBuffer.data(), pos, entry.crc);
+        put<uint64_t>(indexBuffer.data(), pos, entry.offset);
+        put<uint64_t>(indexBuffer.data(), pos, entry.size);
+        put<uint64_t>(indexBuffer.data(), pos, entry.numKeys);
+    }
+    const auto indexOffset = offset;
+    write(indexBuffer.data(), indexBuffer.size());
+
+    std::array<uint8_t, HeaderSize> header{};
+    pos = 0;
+    put<uint32_t>(header.data(), pos, SortedAccessLogVersion);
+    put<uint32_t>(header.data(), pos, SortedAccessLogMagic);
+    put<uint32_t>(header.data(), pos, index.size());
+    put<uint32_t>(header.data(),
+                  pos,
+                  crc32c(indexBuffer.data(), indexBuffer.size(), 0));
+    put<uint64_t>(header.data(), pos, numKeys);
+    put<uint64_t>(header.data(), pos, indexOffset);
+    if (fseek(file, 0, SEEK_SET) != 0) {
+        throw MutationLog::WriteException("Failed to seek in '" + path +
+                                          "': " + strerror(errno));
+    }
+    write(header.data(), header.size());
+
+    if (fflush(file) != 0 || folly::fsyncNoInt(fileno(file)) != 0) {
+        throw MutationLog::WriteException("Failed to sync '" + path +
+                                          "': " + strerror(errno));
+    }
+    auto* f = file;
+    file = nullptr;
+    if (fclose(f) != 0) {
+        throw MutationLog::WriteException("Failed to close '" + path +
+                                          "': " + strerror(errno));
+    }
+}
+
+void SortedAccessLogWriter::write(const void* data, size_t size) {
+    if (size && fwrite(data, size, 1, file) != 1) {
+        throw MutationLog::WriteException("Failed to write '" + path +
+                                          "': " + strerror(errno));
+    }
+    offset += size;
+}
+
+SortedAccessLogReader::SortedAccessLogReader(const std::string& path)
+    : path(path) {
+    if (!cb::io::isFile(path)) {
+        throw MutationLog::FileNotFoundException(path);
+    }
+    try {
+        mapping = std::make_unique<folly::MemoryMapping>(path.c_str());
+    } catch (const std::system_error& e) {
+        throw MutationLog::ReadException("Failed to map '" + path +
+                                         "': " + e.what());
+    }
+    const auto data = mapping->range();
+    if (data.size() < HeaderSize) {
+        throw MutationLog::ShortReadException();
+    }
+
+    size_t pos = 0;
+    const auto version = get<uint32_t>(data.data(), pos);
+    const auto magic = get<uint32_t>(data.data(), pos);
+    if (version != SortedAccessLogVersion || magic != SortedAccessLogMagic) {
+        throw MutationLog::ReadException(
+                "Not a sorted access log, version " + std::to_string(version));
+    }
+    const auto numVBuckets = get<uint32_t>(data.data(), pos);
+    const auto indexCrc = get<uint32_t>(data.data(), pos);
+    numKeys = get<uint64_t>(data.data(), pos);
+    const auto indexOffset = get<uint64_t>(data.data(), pos);
+
+    const uint64_t indexSize = uint64_t(numVBuckets) * IndexEntrySize;
+    if (indexOffset < HeaderSize || indexOffset > data.size() ||
+        indexSize != data.size() - indexOffset) {
+        throw MutationLog::ShortReadException();
+    }
+    const auto* indexData = data.data() + indexOffset;
+    if (crc32c(indexData, indexSize, 0) != indexCrc) {
+        throw MutationLog::CRCReadException();
+    }
+
+    pos = 0;
+    index.reserve(numVBuckets);
+    for (uint32_t ii = 0; ii < numVBuckets; ++ii) {
+        IndexEntry entry;
+        entry.vbid = Vbid(get<uint16_t>(indexData, pos));
+        get<uint16_t>(indexData, pos);
+        entry.crc = get<uint32_t>(indexData, pos);
+        entry.offset = get<uint64_t>(indexData, pos);
+        entry.size = get<uint64_t>(indexData, pos);
+        entry.numKeys = get<uint64_t>(indexData, pos);
+        if (entry.offset < HeaderSize || entry.offset > indexOffset ||
+            entry.size > indexOffset - entry.offset) {
+            throw MutationLog::ReadException(
+                    "Region of " + entry.vbid.to_string() + " is outside '" +
+                    path + "'");
+        }
+        index.push_back(entry);
+    }
+
+    // Each region is read from start to end
+    mapping->hintLinearScan();
+}
+
+SortedAccessLogReader::~SortedAccessLogReader() = default;
+
+bool SortedAccessLogReader::isSortedAccessLog(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    std::array<uint8_t, 2 * sizeof(uint32_t)> header;
+    const bool read = fread(header.data(), header.size(), 1, file) == 1;
+    fclose(file);
+    if (!read) {
+        return false;
+    }
+    size_t pos = 0;
+    const auto version = get<uint32_t>(header.data(), pos);
+    const auto magic = get<uint32_t>(header.data(), pos);
+    return version == SortedAccessLogVersion && magic == SortedAccessLogMagic;
+}
+
+void SortedAccessLogReader::forEachKey(
+        size_t idx, const std::function<bool(const StoredDocKey&)>& cb) const {
+    const auto& entry = index.at(idx);
+    const auto* region = mapping->range().data() + entry.offset;
+    if (crc32c(region, entry.size, 0) != entry.crc) {
+        throw MutationLog::CRCReadException();
+    }
+
+    cb::const_byte_buffer remaining{region, entry.size};
+    std::string key;
+    for (uint64_t ii = 0; ii < entry.numKeys; ++ii) {
+        if (remaining.empty()) {
+            throw MutationLog::ShortReadException();
+        }
+        auto [shared, rest] =
+                cb::mcbp::unsigned_leb128<uint32_t>::decode(remaining);
+        if (rest.empty()) {
+            throw MutationLog::ShortReadException();
+        }
+        auto [length, suffix] =
+                cb::mcbp::unsigned_leb128<uint32_t>::decode(rest);
+        if (shared > key.size() || length > suffix.size()) {
+            throw MutationLog::ReadException(
+                    "Invalid key in region of " + entry.vbid.to_string());
+        }
+        key.resize(shared);
+        key.append(reinterpret_cast<const char*>(suffix.data()), length);
+        remaining = {suffix.data() + length, suffix.size() - length};
+
+        if (!cb(StoredDocKey(
+                    DocKey(key, DocKeyEncodesCollectionId::Yes)))) {
+            return;
+        }
+    }
+}
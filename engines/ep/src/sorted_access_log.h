@@ -0,0 +1,186 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#pragma once
+
+/**
+ * Sorted access log
+ *
+ * An alternative layout for the access.log (see MutationLog) which warmup can
+ * load in parallel and in on-disk order. The file holds each vBucket's keys
+ * in a separate region, sorted (in the order of the by-id index, so a batch
+ * of keys is fetched from disk in file order) and prefix compressed; an index
+ * at the end of the file locates the regions. The file is memory mapped when
+ * read, and each region is read independently, so warmup can split a log
+ * across several tasks.
+ *
+ * Layout (integers in network byte order):
+ *
+ *   Header:  uint32 version (SortedAccessLogVersion)
+ *            uint32 magic (SortedAccessLogMagic)
+ *            uint32 number of vBuckets
+ *            uint32 crc32c of the index
+ *            uint64 number of keys
+ *            uint64 offset of the index
+ *   Regions: for each key: leb128 length of the prefix shared with the
+ *            previous key, leb128 length of the rest of the key, the rest of
+ *            the key
+ *   Index:   for each vBucket: uint16 vbid, uint16 reserved, uint32 crc32c of
+ *            the region, uint64 offset, uint64 size, uint64 number of keys
+ *
+ * The version is in the same position as the version of a MutationLog's
+ * LogHeaderBlock, so a MutationLog rejects the file (as an unknown version)
+ * and vice versa.
+ */
+
+#include "mutation_log.h"
+#include "storeddockey.h"
+
+#include <memcached/vbucket.h>
+
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace folly {
+class MemoryMapping;
+}
+
+/// The version of the sorted access log; follows MutationLogVersion::V4
+const uint32_t SortedAccessLogVersion(5);
+const uint32_t SortedAccessLogMagic(0x414c4f47); // "ALOG"
+
+/**
+ * Writes a sorted access log. The keys of each vBucket are added, then the
+ * vBucket is written out with finishVBucket(); the file is only valid once
+ * close() succeeds.
+ */
+class SortedAccessLogWriter {
+public:
+    /**
+     * Create the file.
+     *
+     * @throws MutationLog::WriteException if the file can't be created
+     */
+    explicit SortedAccessLogWriter(std::string path);
+
+    ~SortedAccessLogWriter();
+
+    void newItem(const StoredDocKey& key) {
+        keys.push_back(key);
+    }
+
+    /// Sort and write the keys added since the last call as the region of
+    /// the given vBucket
+    void finishVBucket(Vbid vbid);
+
+    /**
+     * Write the index and the header.
+     *
+     * @throws MutationLog::WriteException if the file couldn't be written
+     */
+    void close();
+
+    size_t getNumKeys() const {
+        return numKeys;
+    }
+
+    const std::string& getLogFile() const {
+        return path;
+    }
+
+protected:
+    void write(const void* data, size_t size);
+
+    struct IndexEntry {
+        Vbid vbid;
+        uint32_t crc;
+        uint64_t offset;
+        uint64_t size;
+        uint64_t numKeys;
+    };
+
+    const std::string path;
+    FILE* file{nullptr};
+    uint64_t offset{0};
+    size_t numKeys{0};
+    std::vector<StoredDocKey> keys;
+    std::vector<IndexEntry> index;
+    std::vector<uint8_t> regionBuffer;
+};
+
+/**
+ * Reads a sorted access log through a memory mapping of the file. The
+ * regions are only read by forEachKey(), which may be called concurrently
+ * (for different regions) by several threads.
+ */
+class SortedAccessLogReader {
+public:
+    /**
+     * Map the file and validate the header and index.
+     *
+     * @throws MutationLog::FileNotFoundException if the file doesn't exist
+     * @throws MutationLog::ReadException if the file isn't a valid sorted
+     *         access log
+     */
+    explicit SortedAccessLogReader(const std::string& path);
+
+    ~SortedAccessLogReader();
+
+    /// @return true if the file exists and has the version of a sorted
+    ///         access log (it may still be invalid)
+    static bool isSortedAccessLog(const std::string& path);
+
+    /// @return the number of vBuckets (regions) in the log
+    size_t getNumVBuckets() const {
+        return index.size();
+    }
+
+    /// @return the vBucket of the idx'th region
+    Vbid getVBucket(size_t idx) const {
+        return index.at(idx).vbid;
+    }
+
+    /// @return the number of keys in the log
+    size_t getNumKeys() const {
+        return numKeys;
+    }
+
+    const std::string& getLogFile() const {
+        return path;
+    }
+
+    /**
+     * Call the callback for each key of the idx'th region, in order, until
+     * it returns false.
+     *
+     * @throws MutationLog::CRCReadException if the region is corrupt (before
+     *         any key is passed to the callback)
+     */
+    void forEachKey(size_t idx,
+                    const std::function<bool(const StoredDocKey&)>& cb) const;
+
+protected:
+    struct IndexEntry {
+        Vbid vbid;
+        uint64_t offset;
+        uint64_t size;
+        uint64_t numKeys;
+        uint32_t crc;
+    };
+
+    const std::string path;
+    std::unique_ptr<folly::MemoryMapping> mapping;
+    std::vector<IndexEntry> index;
+    size_t numKeys{0};
+};
@@ -33,7 +33,8 @@ const int64_t StoredValue::state_temp_init = -5;
 StoredValue::StoredValue(const Item& itm,
                          UniquePtr n,
                          EPStats& stats,
-                         bool isOrdered)
+                         bool isOrdered,
+                         bool inlineValue)
     : value(itm.getValue()),
       chain_next_or_replacement(std::move(n)),
       cas(itm.getCas()),
@@ -44,7 +45,8 @@ StoredValue::StoredValue(const Item& itm,
       datatype(itm.getDataType()),
       ordered(isOrdered),
       deletionSource(0),
-      committed(static_cast<uint8_t>(CommittedState::CommittedViaMutation)) {
+      committed(static_cast<uint8_t>(CommittedState::CommittedViaMutation)),
+      inlineValue(inlineValue) {
     // Initialise bit fields
     setDeletedPriv(itm.isDeleted());
     setResident(!isTempItem());
@@ -57,6 +59,10 @@ StoredValue::StoredValue(const Item& itm,
     // object.
     new (key()) SerialisedDocKey(itm.getKey());
 
+    if (hasInlineValue()) {
+        initInlineValue();
+    }
+
     if (isTempInitialItem()) {
         markClean();
     } else {
@@ -78,7 +84,10 @@ StoredValue::~StoredValue() {
     ObjectRegistry::onDeleteStoredValue(this);
 }
 
-StoredValue::StoredValue(const StoredValue& other, UniquePtr n, EPStats& stats)
+StoredValue::StoredValue(const StoredValue& other,
+                         UniquePtr n,
+                         EPStats& stats,
+                         bool inlineValue)
     : value(other.value), // Implicitly also copies the frequency counter
       chain_next_or_replacement(std::move(n)),
       cas(other.cas),
@@ -89,7 +98,8 @@ StoredValue::StoredValue(const StoredValue& other, UniquePtr n, EPStats& stats)
       flags(other.flags),
       revSeqno(other.revSeqno),
       datatype(other.datatype),
-      ordered(other.ordered) {
+      ordered(other.ordered),
+      inlineValue(inlineValue) {
     setDirty(other.isDirty());
     setDeletedPriv(other.isDeleted());
     setResident(other.isResident());
@@ -101,6 +111,10 @@ StoredValue::StoredValue(const StoredValue& other, UniquePtr n, EPStats& stats)
     StoredDocKey sKey(other.getKey());
     new (key()) SerialisedDocKey(sKey);
 
+    if (hasInlineValue()) {
+        initInlineValue();
+    }
+
     if (isDeleted()) {
         setDeletionSource(other.getDeletionSource());
     }
@@ -135,7 +149,7 @@ void StoredValue::restoreValue(const Item& itm) {
     auto freq = itm.getFreqCounterValue();
     auto age = getAge();
 
-    value = itm.getValue();
+    replaceValueMaybeInline(itm.getValue());
 
     setFreqCounterValue(freq);
     setCommitted(itm.getCommitted());
@@ -182,6 +196,89 @@ size_t StoredValue::getRequiredStorage(const DocKey& key) {
     return sizeof(StoredValue) + SerialisedDocKey::getObjectSize(key.size());
 }
 
+size_t StoredValue::getRequiredStorageWithInlineValue(const DocKey& key,
+                                                      size_t valueCapacity) {
+    return getInlineValueRegionOffset(
+                   SerialisedDocKey::getObjectSize(key.size())) +
+           sizeof(InlineValueRegion) + Blob::getAllocationSize(valueCapacity);
+}
+
+StoredValue::InlineValueRegion& StoredValue::getInlineValueRegion() const {
+    auto* base = reinterpret_cast<char*>(const_cast<StoredValue*>(this));
+    return *reinterpret_cast<InlineValueRegion*>(
+            base + getInlineValueRegionOffset(getKey().getObjectSize()));
+}
+
+size_t StoredValue::getInlineValueReservedSize() const {
+    if (!hasInlineValue()) {
+        return 0;
+    }
+    const auto& header = getInlineValueRegion().header;
+    return header.allocationSize - header.offset;
+}
+
+bool StoredValue::isValueInline() const {
+    return hasInlineValue() && value &&
+           value.get().get() == getInlineValueRegion().owner.get().get();
+}
+
+void StoredValue::initInlineValue() {
+    const size_t capacity = value ? value->valueSize() : 0;
+    const uint32_t blobOffset =
+            getInlineValueRegionOffset(getKey().getObjectSize()) +
+            sizeof(InlineValueRegion);
+
+    auto& region = getInlineValueRegion();
+    region.header.offset = blobOffset;
+    region.header.allocationSize =
+            blobOffset + Blob::getAllocationSize(capacity);
+    auto* blob = Blob::NewEmbedded(
+            reinterpret_cast<char*>(this) + blobOffset, nullptr, capacity);
+    new (&region.owner)
+            value_t(TaggedPtr<Blob>(blob, TaggedPtrBase::NoTagValue));
+    if (value) {
+        // Copy via assignEmbedded to also preserve the Blob's flags.
+        blob->assignEmbedded(*value);
+        replaceValue(region.owner);
+    }
+}
+
+void StoredValue::replaceValueMaybeInline(const value_t& newValue) {
+    if (hasInlineValue() && newValue) {
+        auto& region = getInlineValueRegion();
+        const Blob* embedded = region.owner.get().get();
+        if (newValue.get().get() == embedded) {
+            replaceValue(newValue);
+            return;
+        }
+        // Drop our own reference first, so the refcount tells us if any
+        // Item still references the embedded value.
+        if (isValueInline()) {
+            replaceValue(value_t{});
+        }
+        const size_t capacity = region.header.allocationSize -
+                                region.header.offset -
+                                Blob::getAllocationSize(0);
+        if (region.owner.refCount() == 1 &&
+            newValue->valueSize() <= capacity) {
+            region.owner->assignEmbedded(*newValue);
+            replaceValue(region.owner);
+            return;
+        }
+    }
+    replaceValue(newValue);
+}
+
+void StoredValue::destroyWithInlineValue(StoredValue* sv) {
+    auto& region = sv->getInlineValueRegion();
+    // Take a reference to the embedded Blob (which owns the allocation) so
+    // the allocation outlives the destructors below; it is freed when the
+    // last reference is released - here, or by an Item sharing the value.
+    value_t owner = region.owner;
+    region.owner.~value_t();
+    sv->~StoredValue();
+}
+
 std::unique_ptr<Item> StoredValue::toItem(
         Vbid vbid,
         HideLockedCas hideLockedCas,
@@ -239,6 +336,8 @@ void StoredValue::reallocate() {
 void StoredValue::Deleter::operator()(StoredValue* val) {
     if (val->isOrdered()) {
         delete static_cast<OrderedStoredValue*>(val);
+    } else if (val->hasInlineValue()) {
+        destroyWithInlineValue(val);
     } else {
         delete val;
     }
@@ -349,7 +448,7 @@ void StoredValue::setValueImpl(const Item& itm) {
         setResident(false);
     } else {
         setResident(true);
-        replaceValue(itm.getValue());
+        replaceValueMaybeInline(itm.getValue());
     }
     setCommitted(itm.getCommitted());
 }
@@ -122,6 +122,37 @@ class OrderedStoredValue;
  * ~StoredValue and not the members of the derived class. Instead a custom
  * deleter is associated with StoredValue::UniquePtr, which checks the flag
  * and dispatches to the correct destructor.
+ *
+ * Inline values
+ * =============
+ *
+ * StoredValues created by InlineValueStoredValueFactory (persistent buckets
+ * only) additionally embed a small value in the same allocation, directly
+ * after the key, saving the separate Blob allocation and the pointer chase
+ * to read it:
+ *
+ *               +-------------------+
+ *           {   | StoredValue fixed | value [ptr] points to the embedded Blob
+ *           {   + - - - - - - - - - +
+ *  variable {   | key[]             |
+ *   length  {   + - - - - - - - - - +
+ *           {   | InlineValueRegion | owner [ptr], Blob::EmbeddedHeader
+ *           {   | Blob (embedded)   |
+ *               +-------------------+
+ *
+ * The value is still exposed as a normal (reference-counted) Blob, so Items
+ * created from the StoredValue can share it as usual. The embedded Blob owns
+ * the whole allocation; InlineValueRegion::owner is the StoredValue's
+ * reference to it, so the allocation is freed when both the StoredValue has
+ * been deleted and no Item references the value any longer.
+ *
+ * The capacity of the region is fixed when the StoredValue is created, to the
+ * size of the value it is created with (not ht_inline_value_max_size, so that
+ * small values don't each reserve the maximum). If the value is replaced by a
+ * larger one (or the region is still referenced by an Item) the new value is
+ * stored out-of-line as a separate Blob; when the value is ejected the region
+ * is simply left unused. A later value which fits is copied back into the
+ * region.
  */
 class StoredValue {
 public:
@@ -588,6 +619,27 @@ public:
         setValueTag(tag);
     }
 
+    /**
+     * Does this StoredValue have an inline value region (i.e. was it created
+     * by InlineValueStoredValueFactory)?
+     */
+    bool hasInlineValue() const {
+        return inlineValue;
+    }
+
+    /**
+     * Is the current value stored inline, in the same allocation as this
+     * StoredValue?
+     */
+    bool isValueInline() const;
+
+    /**
+     * @returns the number of bytes of this StoredValue's allocation which are
+     *          reserved for the inline value (and accounted as the embedded
+     *          Blob's), or 0 if it has no inline value region.
+     */
+    size_t getInlineValueReservedSize() const;
+
     /**
      * True if this object is logically deleted.
      */
@@ -726,7 +778,8 @@ public:
 
     /**
      * Return the size in byte of this object; both the fixed fields and the
-     * variable-length key. Doesn't include value size (allocated externally).
+     * variable-length key. Doesn't include value size (allocated externally,
+     * or for an inline value accounted as the size of the embedded Blob).
      */
     inline size_t getObjectSize() const;
 
@@ -759,6 +812,13 @@ public:
     /// Return how many bytes are need to store item given key as a StoredValue
     static size_t getRequiredStorage(const DocKey& key);
 
+    /**
+     * Return how many bytes are needed to store an item with the given key as
+     * a StoredValue with an inline value region of the given capacity.
+     */
+    static size_t getRequiredStorageWithInlineValue(const DocKey& key,
+                                                    size_t valueCapacity);
+
     /**
      * @return the deletion source of the stored value
      */
@@ -831,11 +891,15 @@ protected:
      *           which the new item is being inserted).
      * @param stats EPStats to update for this new StoredValue
      * @param isOrdered Are we constructing an OrderedStoredValue?
+     * @param inlineValue Should the value be stored in an inline value region
+     *        (sized to fit itm's value) after the key? The allocation must be
+     *        at least getRequiredStorageWithInlineValue() bytes.
      */
     StoredValue(const Item& itm,
                 UniquePtr n,
                 EPStats& stats,
-                bool isOrdered);
+                bool isOrdered,
+                bool inlineValue = false);
 
     // Destructor. protected, as needs to be carefully deleted (via
     // StoredValue::Destructor) depending on the value of isOrdered flag.
@@ -851,10 +915,13 @@ protected:
      *           ownership of. (Typically the top of the hash bucket into
      *           which the new item is being inserted).
      * @param stats EPStats to update for this new StoredValue
+     * @param inlineValue Should the value be stored in an inline value region
+     *        (sized to fit other's value) after the key?
      */
     StoredValue(const StoredValue& other,
                 UniquePtr n,
-                EPStats& stats);
+                EPStats& stats,
+                bool inlineValue = false);
 
     /* Do not allow assignment */
     StoredValue& operator=(const StoredValue& other) = delete;
@@ -889,6 +956,42 @@ protected:
      */
     void setValueImpl(const Item& itm);
 
+    /**
+     * Trailer of the allocation of a StoredValue with an inline value; the
+     * embedded Blob immediately follows it.
+     */
+    struct InlineValueRegion {
+        /// This StoredValue's reference to the embedded Blob, which keeps the
+        /// allocation alive while the StoredValue exists.
+        value_t owner;
+        Blob::EmbeddedHeader header;
+    };
+
+    /// Offset of the InlineValueRegion, given the size of the key.
+    static size_t getInlineValueRegionOffset(size_t keyObjectSize) {
+        const size_t align = alignof(InlineValueRegion);
+        return (sizeof(StoredValue) + keyObjectSize + align - 1) & ~(align - 1);
+    }
+
+    /// @returns the inline value region; only valid if hasInlineValue().
+    InlineValueRegion& getInlineValueRegion() const;
+
+    /// Create the inline value region, and move the current value into it.
+    void initInlineValue();
+
+    /**
+     * Replace the value with the given value_t, copying it into the inline
+     * value region if there is one and it has room (and is not referenced
+     * by any Item), otherwise sharing the given Blob.
+     */
+    void replaceValueMaybeInline(const value_t& newValue);
+
+    /**
+     * Delete a StoredValue with an inline value; the allocation is freed once
+     * no Item references the embedded Blob.
+     */
+    static void destroyWithInlineValue(StoredValue* sv);
+
     // name clash with public OSV isStale
     bool isStalePriv() const {
         return bits.test(staleIndex);
@@ -919,6 +1022,7 @@ protected:
     }
 
     friend class StoredValueFactory;
+    friend class InlineValueStoredValueFactory;
 
     /**
      * Granting friendship to StoredValueProtected test fixture to access
@@ -1017,6 +1121,8 @@ protected:
     uint8_t deletionSource : 1;
     /// 3-bit value which encodes the CommittedState of the StoredValue
     uint8_t committed : 3;
+    // inlineValue := true if the allocation has an InlineValueRegion
+    const uint8_t inlineValue : 1;
 
     friend std::ostream& operator<<(std::ostream& os, const StoredValue& sv);
     friend void to_json(nlohmann::json& json, const StoredValue& sv);
@@ -1194,5 +1300,9 @@ size_t StoredValue::getObjectSize() const {
     if (isOrdered()) {
         return sizeof(OrderedStoredValue) + getKey().getObjectSize();
     }
+    if (hasInlineValue()) {
+        return getInlineValueRegionOffset(getKey().getObjectSize()) +
+               sizeof(InlineValueRegion);
+    }
     return sizeof(*this) + getKey().getObjectSize();
 }
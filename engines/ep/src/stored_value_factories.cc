@@ -36,6 +36,46 @@ StoredValue::UniquePtr StoredValueFactory::copyStoredValue(
             TaggedPtrBase::NoTagValue));
 }
 
+StoredValue::UniquePtr InlineValueStoredValueFactory::operator()(
+        const Item& itm, StoredValue::UniquePtr next) {
+    const auto& value = itm.getValue();
+    if (!shouldInline(value)) {
+        return StoredValueFactory(*stats)(itm, std::move(next));
+    }
+    // Allocate a buffer to store the StoredValue, the key and the value.
+    return StoredValue::UniquePtr(TaggedPtr<StoredValue>(
+            new (::operator new(StoredValue::getRequiredStorageWithInlineValue(
+                    itm.getKey(), value->valueSize())))
+                    StoredValue(itm,
+                                std::move(next),
+                                *stats,
+                                /*isOrdered*/ false,
+                                /*inlineValue*/ true),
+            TaggedPtrBase::NoTagValue));
+}
+
+StoredValue::UniquePtr InlineValueStoredValueFactory::copyStoredValue(
+        const StoredValue& other, StoredValue::UniquePtr next) {
+    const auto& value = other.getValue();
+    if (!shouldInline(value)) {
+        return StoredValue::UniquePtr(TaggedPtr<StoredValue>(
+                new (::operator new(
+                        StoredValue::getRequiredStorage(other.getKey())))
+                        StoredValue(other, std::move(next), *stats),
+                TaggedPtrBase::NoTagValue));
+    }
+    // Allocate a buffer to store the copy of the StoredValue, the key and the
+    // value.
+    return StoredValue::UniquePtr(TaggedPtr<StoredValue>(
+            new (::operator new(StoredValue::getRequiredStorageWithInlineValue(
+                    other.getKey(), value->valueSize())))
+                    StoredValue(other,
+                                std::move(next),
+                                *stats,
+                                /*inlineValue*/ true),
+            TaggedPtrBase::NoTagValue));
+}
+
 StoredValue::UniquePtr OrderedStoredValueFactory::operator()(
         const Item& itm, StoredValue::UniquePtr next) {
     // Allocate a buffer to store the OrderStoredValue and any trailing
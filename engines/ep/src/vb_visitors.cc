@@ -34,6 +34,33 @@ CappedDurationVBucketVisitor::shouldInterrupt() {
                    : ExecutionState::Continue;
 }
 
+bool CompositeHTVisitor::visit(const HashTable::HashBucketLock& lh,
+                               StoredValue& v) {
+    bool keepVisiting = true;
+    for (auto* participant : participants) {
+        keepVisiting &= participant->visit(lh, v);
+    }
+    return keepVisiting;
+}
+
+void CompositeHTVisitor::setUpHashBucketVisit() {
+    for (auto* participant : participants) {
+        participant->setUpHashBucketVisit();
+    }
+}
+
+void CompositeHTVisitor::tearDownHashBucketVisit() {
+    for (auto* participant : participants) {
+        participant->tearDownHashBucketVisit();
+    }
+}
+
+void CompositeHTVisitor::setCurrentVBucket(VBucket& vb) {
+    for (auto* participant : participants) {
+        participant->setCurrentVBucket(vb);
+    }
+}
+
 PauseResumeVBAdapter::PauseResumeVBAdapter(
         std::unique_ptr<VBucketAwareHTVisitor> htVisitor)
     : htVisitor(std::move(htVisitor)) {
@@ -18,6 +18,8 @@
 
 #include <folly/Chrono.h>
 
+#include <vector>
+
 using namespace std::chrono_literals;
 
 class HashTableVisitor;
@@ -208,6 +210,39 @@ public:
     }
 };
 
+/**
+ * A VBucketAwareHTVisitor which runs several other visitors (the
+ * participants) in a single pass over the HashTable: each StoredValue is
+ * visited once, under one HashBucketLock, and passed to every participant.
+ *
+ * The participants are not owned, and must outlive the visit. A participant
+ * which asks to pause (returns false from visit()) pauses the whole visit,
+ * after the other participants have visited the current StoredValue, so that
+ * no participant runs beyond its own budget. Participants must not replace
+ * the StoredValue they are given (as the HashTable defragmenter can).
+ */
+class CompositeHTVisitor : public VBucketAwareHTVisitor {
+public:
+    void addParticipant(VBucketAwareHTVisitor& participant) {
+        participants.push_back(&participant);
+    }
+
+    bool empty() const {
+        return participants.empty();
+    }
+
+    bool visit(const HashTable::HashBucketLock& lh, StoredValue& v) override;
+
+    void setUpHashBucketVisit() override;
+
+    void tearDownHashBucketVisit() override;
+
+    void setCurrentVBucket(VBucket& vb) override;
+
+private:
+    std::vector<VBucketAwareHTVisitor*> participants;
+};
+
 /**
  * Adapts a VBucketAwareHTVisitor, recording the position into the
  * HashTable the visit reached when it paused; and resumes Visiting from that
@@ -164,7 +164,13 @@ VBucket::VBucket(Vbid i,
                  bool mightContainXattrs,
                  const nlohmann::json* replTopology,
                  uint64_t maxVisibleSeqno)
-    : ht(st, std::move(valFact), config.getHtSize(), config.getHtLocks()),
+    : ht(st,
+         std::move(valFact),
+         config.getHtSize(),
+         config.getHtLocks(),
+         HashTable::layoutFromString(config.getHtLayout()),
+         HashTable::resizeAlgorithmFromString(
+                 config.getHtResizeAlgorithm())),
       failovers(std::move(table)),
       opsCreate(0),
       opsDelete(0),
@@ -1087,27 +1093,31 @@ bool VBucket::isResidentRatioUnderThreshold(float threshold) {
     }
 }
 
-void VBucket::createFilter(size_t key_count, double probability) {
+void VBucket::createFilter(size_t key_count,
+                           double probability,
+                           BloomFilter::Layout layout) {
     // Create the actual bloom filter upon vbucket creation during
     // scenarios:
     //      - Bucket creation
     //      - Rebalance
     std::lock_guard<std::mutex> lh(bfMutex);
     if (bFilter == nullptr && tempFilter == nullptr) {
-        bFilter = std::make_unique<BloomFilter>(key_count, probability,
-                                        BFILTER_ENABLED);
+        bFilter = std::make_unique<BloomFilter>(
+                key_count, probability, BFILTER_ENABLED, layout);
     } else {
         EP_LOG_WARN("({}) Bloom filter / Temp filter already exist!", id);
     }
 }
 
-void VBucket::initTempFilter(size_t key_count, double probability) {
+void VBucket::initTempFilter(size_t key_count,
+                             double probability,
+                             BloomFilter::Layout layout) {
     // Create a temp bloom filter with status as COMPACTING,
     // if the main filter is found to exist, set its state to
     // COMPACTING as well.
     std::lock_guard<std::mutex> lh(bfMutex);
-    tempFilter = std::make_unique<BloomFilter>(key_count, probability,
-                                     BFILTER_COMPACTING);
+    tempFilter = std::make_unique<BloomFilter>(
+            key_count, probability, BFILTER_COMPACTING, layout);
     if (bFilter) {
         bFilter->setStatus(BFILTER_COMPACTING);
     }
@@ -1241,6 +1251,29 @@ size_t VBucket::getFilterMemoryFootprint() {
     return memFootprint;
 }
 
+std::string VBucket::serialiseFilter(uint64_t vbUuid, uint64_t persistedSeqno) {
+    std::lock_guard<std::mutex> lh(bfMutex);
+    if (!bFilter || tempFilter || bFilter->getStatus() != BFILTER_ENABLED) {
+        return {};
+    }
+    return bFilter->serialise(vbUuid, persistedSeqno);
+}
+
+bool VBucket::restoreFilter(std::string_view data,
+                            uint64_t vbUuid,
+                            uint64_t persistedSeqno) {
+    auto filter = BloomFilter::deserialise(data, vbUuid, persistedSeqno);
+    if (!filter) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lh(bfMutex);
+    if (bFilter || tempFilter) {
+        return false;
+    }
+    bFilter = std::move(filter);
+    return true;
+}
+
 VBNotifyCtx VBucket::queueItem(queued_item& item, const VBQueueItemCtx& ctx) {
     // Set queue time to now. Why not in the ctor of the Item? We only need to
     // do this in certain places for new items as it's used to determine how
@@ -718,8 +718,14 @@ public:
     /**
      * BloomFilter operations for vbucket
      */
-    void createFilter(size_t key_count, double probability);
-    void initTempFilter(size_t key_count, double probability);
+    void createFilter(
+            size_t key_count,
+            double probability,
+            BloomFilter::Layout layout = BloomFilter::Layout::Classic);
+    void initTempFilter(
+            size_t key_count,
+            double probability,
+            BloomFilter::Layout layout = BloomFilter::Layout::Classic);
     void addToFilter(const DocKey& key);
     virtual bool maybeKeyExistsInFilter(const DocKey& key);
     bool isTempFilterAvailable();
@@ -737,6 +743,24 @@ public:
      */
     size_t getFilterMemoryFootprint();
 
+    /**
+     * Serialise the main bloom filter so it can be persisted (see
+     * BloomFilter::serialise).
+     * @returns the serialised filter, or an empty string if there is no
+     *          enabled filter (or compaction is rebuilding it).
+     */
+    std::string serialiseFilter(uint64_t vbUuid, uint64_t persistedSeqno);
+
+    /**
+     * Restore the main bloom filter from data created by serialiseFilter(),
+     * if it is valid for the given vBucket UUID and on-disk high seqno and
+     * no filter exists yet.
+     * @returns true if the filter was restored.
+     */
+    bool restoreFilter(std::string_view data,
+                       uint64_t vbUuid,
+                       uint64_t persistedSeqno);
+
     uint64_t nextHLCCas() {
         return hlc.nextHLC();
     }
@@ -1338,6 +1362,25 @@ public:
                          const Collections::VB::CachingReadHandle& cHandle,
                          ForGetReplicaOp getReplicaItem = ForGetReplicaOp::No);
 
+    /**
+     * Enqueue background fetches for a batch of keys requested by a single
+     * cookie (i.e. the keys a GetMulti found to be non-resident). Keys which
+     * don't have a StoredValue get a temporary item, as for
+     * addTempItemAndBGFetch(). All of the fetches are added to the pending
+     * batch of the vbucket at once, and the cookie is notified only once
+     * when the last of them completes.
+     *
+     * @param keys the keys to be bg fetched
+     * @param cookie the cookie of the requestor
+     * @param engine Reference to ep engine
+     * @return the status for each of the keys; would_block for the keys a
+     *         fetch was queued for
+     */
+    virtual std::vector<cb::engine_errc> bgFetchMulti(
+            const std::vector<DocKey>& keys,
+            const CookieIface* cookie,
+            EventuallyPersistentEngine& engine) = 0;
+
     /**
      * Retrieve the meta data for given key
      *
@@ -1783,6 +1826,15 @@ public:
             // persistence
     };
 
+    /**
+     * Cancel the range scans of this vBucket, called when the vBucket stops
+     * being active (including when it's deleted)
+     */
+    virtual void cancelRangeScans() {
+        // Does nothing by default as only persistent vBuckets support range
+        // scans
+    }
+
 protected:
     /**
      * This function checks for the various states of the value & depending on
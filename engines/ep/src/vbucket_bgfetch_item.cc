@@ -38,6 +38,16 @@ void FrontEndBGFetchItem::complete(
         const DiskDocKey& key) const {
     cb::engine_errc status =
             vb->completeBGFetchForSingleItem(key, *this, startTime);
+    if (notifyGroup) {
+        if (status != cb::engine_errc::success) {
+            auto expected = cb::engine_errc::success;
+            notifyGroup->status.compare_exchange_strong(expected, status);
+        }
+        if (--notifyGroup->outstanding != 0) {
+            return;
+        }
+        status = notifyGroup->status;
+    }
     engine.notifyIOComplete(cookie, status);
 }
 
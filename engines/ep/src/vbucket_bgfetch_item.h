@@ -17,7 +17,9 @@
 #include "trace_helpers.h"
 #include "vbucket_fwd.h"
 
+#include <atomic>
 #include <list>
+#include <memory>
 #include <unordered_map>
 
 class CookieIface;
@@ -77,6 +79,22 @@ public:
     const uint64_t token;
 };
 
+/**
+ * Tracks a set of front end BG Fetches queued for a single cookie by one
+ * batched request (GetMulti), so that the cookie is notified once when the
+ * last of them completes instead of once per key.
+ */
+struct BGFetchNotifyGroup {
+    explicit BGFetchNotifyGroup(size_t outstanding)
+        : outstanding(outstanding) {
+    }
+
+    /// Number of fetches in the group which have not completed yet
+    std::atomic<size_t> outstanding;
+    /// The first failure reported by any of the fetches in the group
+    std::atomic<cb::engine_errc> status{cb::engine_errc::success};
+};
+
 /**
  * BGFetch context class for a front end driven BG Fetch (i.e. for a Get or
  * SetWithMeta etc.).
@@ -112,6 +130,10 @@ public:
     const CookieIface* cookie;
     cb::tracing::SpanId traceSpanId;
     ValueFilter filter;
+
+    /// Set if the fetch is part of a batch which shares a single
+    /// notification of the cookie
+    std::shared_ptr<BGFetchNotifyGroup> notifyGroup;
 };
 
 /**
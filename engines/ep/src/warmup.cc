@@ -25,6 +25,7 @@
 #include "item.h"
 #include "kvstore/kvstore.h"
 #include "mutation_log.h"
+#include "sorted_access_log.h"
 #include "vb_visitors.h"
 #include "vbucket_bgfetch_item.h"
 #include "vbucket_state.h"
@@ -34,11 +35,14 @@
 #include <platform/timeutils.h>
 #include <statistics/cbstat_collector.h>
 #include <utilities/logtags.h>
+#include <algorithm>
 #include <array>
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <random>
+#include <set>
 #include <string>
 #include <utility>
 
@@ -377,25 +381,28 @@ private:
 };
 
 /**
- * Abstract Task to perform a backfill during warmup on a shards vbuckets, in a
- * pause-resume fashion.
+ * Abstract Task to perform a backfill during warmup, in a pause-resume
+ * fashion. A phase of warmup runs several of these tasks (see
+ * Warmup::scheduleBackfillTask()), each of which repeatedly claims a vBucket
+ * from the phase's queues - first from its own shard, then stealing from the
+ * other shards - and loads it.
  *
  * The task will also transition the warmup's state to the next warmup state
- * once threadTaskCount has meet the total number of shards.
+ * once threadTaskCount has meet the number of tasks of the phase.
  */
 class WarmupBackfillTask : public GlobalTask {
 public:
     /**
      * Constructor of WarmupBackfillTask
      * @param bucket EPBucket the task is back filling for
-     * @param shardId of the shard we're performing the backfill on
+     * @param shardId of the shard whose vbuckets the task loads first
      * @param warmup ref to the warmup class the backfill is for
      * @param taskId of the the backfill that is to be performed
      * @param taskDesc description of the task
      * @param threadTaskCount ref to atomic size_t that keeps count of how many
-     * of the per tasks shards have been completed. If this value is equal to
-     * the number of shards the run() method will transition warmup to the next
-     * state.
+     * of the tasks of the phase have been completed. If this value is equal
+     * to the number of tasks the run() method will transition warmup to the
+     * next state.
      */
     WarmupBackfillTask(EPBucket& bucket,
                        size_t shardId,
@@ -408,9 +415,7 @@ public:
           shardId(shardId),
           description(fmt::format("Warmup - {} shard {}", taskDesc, shardId)),
           currentNumBackfillTasks(threadTaskCount),
-          filter(warmup.shardVbIds[shardId]),
-          visitor(bucket, *this),
-          epStorePosition(bucket.startPosition()) {
+          visitor(bucket, *this) {
         warmup.addToTaskSet(uid);
     }
 
@@ -432,7 +437,7 @@ public:
     bool run() override {
         TRACE_EVENT1(
                 "ep-engine/task", "WarmupBackfillTask", "shard", getShardId());
-        if (filter.empty() || engine->getEpStats().isShutdown) {
+        if (engine->getEpStats().isShutdown) {
             // Technically "isShutdown" being true doesn't equate to a
             // successful task finish, however if we are shutting down we want
             // warmup to advance and be considered "done".
@@ -442,8 +447,23 @@ public:
 
         auto& kvBucket = *engine->getKVBucket();
         try {
-            epStorePosition = kvBucket.pauseResumeVisit(
-                    visitor, epStorePosition, &filter);
+            while (true) {
+                if (!currentVbid) {
+                    currentVbid = warmup.claimBackfillVBucket(shardId);
+                    if (!currentVbid) {
+                        // All of the vbuckets have been claimed
+                        finishTask(true);
+                        return false;
+                    }
+                }
+                auto vb = kvBucket.getVBucket(*currentVbid);
+                if (vb && !visitor.visit(*vb)) {
+                    // Paused at the deadline; keep the vbucket and resume
+                    // its scan in the next run
+                    return true;
+                }
+                currentVbid.reset();
+            }
         } catch (std::exception& e) {
             EP_LOG_CRITICAL(
                     "WarmupBackfillTask::run(): caught exception while running "
@@ -452,12 +472,6 @@ public:
             finishTask(false);
             return false;
         }
-        if (epStorePosition == kvBucket.endPosition()) {
-            finishTask(true);
-            return false;
-        }
-
-        return true;
     }
 
     size_t getShardId() const {
@@ -489,10 +503,9 @@ private:
             // completions.
             return;
         }
-        // If this is the last backfill task (all shards have finished) then
-        // move us to the next state.
-        if (++currentNumBackfillTasks ==
-            engine->getKVBucket()->getVBuckets().getNumShards()) {
+        // If this is the last backfill task (all vbuckets have been loaded)
+        // then move us to the next state.
+        if (++currentNumBackfillTasks == warmup.backfillTaskCount) {
             warmup.transition(getNextState());
         }
     }
@@ -500,13 +513,14 @@ private:
     const size_t shardId;
     const std::string description;
     std::atomic<size_t>& currentNumBackfillTasks;
-    VBucketFilter filter;
     WarmupVbucketVisitor visitor;
-    KVBucketIface::Position epStorePosition;
+    /// The vbucket being loaded, if its scan was paused
+    std::optional<Vbid> currentVbid;
 };
 
 bool WarmupVbucketVisitor::visit(VBucket& vb) {
-    auto* kvstore = ep.getROUnderlyingByShard(backfillTask.getShardId());
+    // The vbucket may have been stolen from another shard
+    auto* kvstore = ep.getROUnderlying(vb.getId());
 
     if (!currentScanCtx) {
         auto kvLookup = std::make_unique<LoadStorageKVPairCallback>(
@@ -1412,6 +1426,10 @@ void Warmup::createVBuckets(uint16_t shardId) {
 
         // For each vbucket, set the last persisted seqno checkpoint
         vb->setPersistenceSeqno(vbs.highSeqno);
+
+        // Restore the bloom filter saved at shutdown (if any), to avoid
+        // running without a filter until the next compaction rebuilds it.
+        store.loadBloomFilter(*vb, vbs.highSeqno);
     }
 
     if (++threadtask_count == store.vbMap.getNumShards()) {
@@ -1660,9 +1678,50 @@ void Warmup::populateVBucketMap(uint16_t shardId) {
 
 void Warmup::scheduleBackfillTask(MakeBackfillTaskFn makeBackfillTask) {
     threadtask_count = 0;
-    for (size_t shardId = 0; shardId < store.vbMap.shards.size(); ++shardId) {
-        ExecutorPool::get()->schedule(makeBackfillTask(shardId));
+    const auto numShards = store.vbMap.shards.size();
+    {
+        std::lock_guard<std::mutex> lh(backfillQueuesMutex);
+        backfillQueues.assign(numShards, {});
+        for (size_t shardId = 0; shardId < numShards; ++shardId) {
+            backfillQueues[shardId].assign(shardVbIds[shardId].begin(),
+                                           shardVbIds[shardId].end());
+        }
+    }
+
+    // Split the vbuckets across all of the reader threads rather than running
+    // one task per shard (there are usually far fewer shards than cores), but
+    // always run at least one task per shard.
+    auto numTasks = config.getWarmupBackfillTasks();
+    if (numTasks == 0) {
+        numTasks = ExecutorPool::get()->getNumReaders();
     }
+    backfillTaskCount = std::max(numTasks, numShards);
+    for (size_t task = 0; task < backfillTaskCount; ++task) {
+        ExecutorPool::get()->schedule(makeBackfillTask(task % numShards));
+    }
+}
+
+std::optional<Vbid> Warmup::claimBackfillVBucket(size_t shardId) {
+    std::lock_guard<std::mutex> lh(backfillQueuesMutex);
+    auto& queue = backfillQueues[shardId];
+    if (!queue.empty()) {
+        const auto vbid = queue.front();
+        queue.pop_front();
+        return vbid;
+    }
+
+    // Steal from the shard with the most vbuckets left. Take from the back of
+    // its queue, which holds the vbuckets its own tasks would load last.
+    auto victim = std::max_element(
+            backfillQueues.begin(),
+            backfillQueues.end(),
+            [](const auto& a, const auto& b) { return a.size() < b.size(); });
+    if (victim == backfillQueues.end() || victim->empty()) {
+        return {};
+    }
+    const auto vbid = victim->back();
+    victim->pop_back();
+    return vbid;
 }
 
 void Warmup::scheduleKeyDump() {
@@ -1716,14 +1775,131 @@ void Warmup::checkForAccessLog()
 void Warmup::scheduleLoadingAccessLog()
 {
     threadtask_count = 0;
-    for (size_t i = 0; i < store.vbMap.shards.size(); i++) {
-        ExTask task = std::make_shared<WarmupLoadAccessLog>(store, i, this);
-        ExecutorPool::get()->schedule(task);
+    const auto numShards = store.vbMap.shards.size();
+
+    // A sorted access log is split (by vBucket) across enough tasks to use
+    // all of the reader threads
+    const auto sortedLogTasks = std::max(
+            size_t(1), ExecutorPool::get()->getNumReaders() / numShards);
+    std::vector<size_t> numTasks(numShards, 1);
+    sortedAccessLogs.clear();
+    sortedAccessLogs.resize(numShards);
+    for (size_t i = 0; i < numShards; i++) {
+        auto log = openSortedAccessLog(i);
+        if (log) {
+            sortedAccessLogs[i] = std::make_unique<SortedAccessLogLoad>();
+            sortedAccessLogs[i]->log = std::move(log);
+            numTasks[i] = sortedLogTasks;
+        }
+    }
+    accessLogTaskCount =
+            std::accumulate(numTasks.begin(), numTasks.end(), size_t(0));
+
+    for (size_t i = 0; i < numShards; i++) {
+        for (size_t task = 0; task < numTasks[i]; task++) {
+            ExecutorPool::get()->schedule(
+                    std::make_shared<WarmupLoadAccessLog>(store, i, this));
+        }
+    }
+}
+
+std::unique_ptr<SortedAccessLogReader> Warmup::openSortedAccessLog(
+        uint16_t shardId) {
+    const auto& curr = accessLog[shardId].getLogFile();
+    for (const auto& path : {curr, curr + ".old"}) {
+        if (!cb::io::isFile(path)) {
+            continue;
+        }
+        if (!SortedAccessLogReader::isSortedAccessLog(path)) {
+            return {};
+        }
+        try {
+            return std::make_unique<SortedAccessLogReader>(path);
+        } catch (MutationLog::ReadException& e) {
+            corruptAccessLog = true;
+            EP_LOG_WARN("Error reading warmup access log '{}': {}",
+                        path,
+                        e.what());
+        }
+    }
+    return {};
+}
+
+void Warmup::loadingSortedAccessLog(uint16_t shardId) {
+    auto& load = *sortedAccessLogs[shardId];
+    const auto& log = *load.log;
+    const auto& vbStates = shardVbStates[shardId];
+    const auto batchSize = config.getWarmupBatchSize();
+    LoadStorageKVPairCallback load_cb(store, true, state.getState());
+    WarmupCookie cookie(&store, load_cb);
+    setEstimatedWarmupCount(log.getNumKeys());
+
+    auto stTime = std::chrono::steady_clock::now();
+    size_t numVBuckets = 0;
+    bool stop = false;
+    for (auto idx = load.nextVBucket++; !stop && idx < log.getNumVBuckets();
+         idx = load.nextVBucket++) {
+        const auto vbid = log.getVBucket(idx);
+        auto vb = store.getVBucket(vbid);
+        if (!vb || vbStates.find(vbid) == vbStates.end()) {
+            continue;
+        }
+        ++numVBuckets;
+
+        // The keys are read in order, so each batch is fetched in one pass
+        // over the by-id index
+        std::set<StoredDocKey> batch;
+        auto applyBatch = [&batch, &cookie, vbid]() {
+            const bool ok = batch.empty() ||
+                            batchWarmupCallback(vbid, batch, &cookie);
+            batch.clear();
+            return ok;
+        };
+        try {
+            log.forEachKey(idx, [&](const StoredDocKey& key) {
+                // As MutationLogHarvester::apply, skip keys which are no
+                // longer valid in the VBucket
+                if (vb->ht.findForRead(key,
+                                       TrackReference::No,
+                                       WantsDeleted::No)
+                            .storedValue == nullptr) {
+                    return true;
+                }
+                batch.insert(batch.end(), key);
+                if (batch.size() >= batchSize && !applyBatch()) {
+                    stop = true;
+                }
+                return !stop;
+            });
+            if (!stop && !applyBatch()) {
+                stop = true;
+            }
+        } catch (MutationLog::ReadException& e) {
+            corruptAccessLog = true;
+            EP_LOG_WARN("Error reading warmup access log '{}' for {}: {}",
+                        log.getLogFile(),
+                        vbid,
+                        e.what());
+        }
     }
+
+    EP_LOG_INFO(
+            "{} items of {} vBuckets loaded from access log '{}', completed "
+            "in {}",
+            cookie.loaded,
+            numVBuckets,
+            log.getLogFile(),
+            cb::time2text(std::chrono::steady_clock::now() - stTime));
 }
 
 void Warmup::loadingAccessLog(uint16_t shardId)
 {
+    if (sortedAccessLogs[shardId]) {
+        loadingSortedAccessLog(shardId);
+        accessLogTaskDone();
+        return;
+    }
+
     LoadStorageKVPairCallback load_cb(store, true, state.getState());
     bool success = false;
     auto stTime = std::chrono::steady_clock::now();
@@ -1769,13 +1945,17 @@ void Warmup::loadingAccessLog(uint16_t shardId)
         setEstimatedWarmupCount(estimatedCount);
     }
 
-    if (++threadtask_count == store.vbMap.getNumShards()) {
+    accessLogTaskDone();
+}
+
+void Warmup::accessLogTaskDone() {
+    if (++threadtask_count == accessLogTaskCount) {
+        sortedAccessLogs.clear();
         if (!store.maybeEnableTraffic()) {
             transition(WarmupState::State::LoadingData);
         } else {
             transition(WarmupState::State::Done);
         }
-
     }
 }
 
@@ -18,6 +18,7 @@
 #include <folly/AtomicHashMap.h>
 #include <memcached/engine_common.h>
 #include <memcached/engine_error.h>
+#include <memcached/vbucket.h>
 #include <platform/atomic_duration.h>
 
 #include <atomic>
@@ -25,7 +26,9 @@
 #include <deque>
 #include <iosfwd>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <unordered_set>
 #include <vector>
 
@@ -36,6 +39,7 @@ class EPStats;
 class EPBucket;
 class GetValue;
 class MutationLog;
+class SortedAccessLogReader;
 class VBucketMap;
 class Vbid;
 enum class ValueFilter;
@@ -396,6 +400,28 @@ private:
      */
     void loadingAccessLog(uint16_t shardId);
 
+    /**
+     * Open the sorted access log of the given shard: the current log if it
+     * exists, else the previous one.
+     *
+     * @return the log, or null if the shard's log isn't a (valid) sorted
+     *         access log; it's loaded as a MutationLog
+     */
+    std::unique_ptr<SortedAccessLogReader> openSortedAccessLog(
+            uint16_t shardId);
+
+    /**
+     * Load vBuckets from the sorted access log of the given shard until
+     * every vBucket of the log was claimed by one of the tasks loading it.
+     * The keys of each vBucket are fetched in batches of warmup_batch_size,
+     * in the order they're stored on disk.
+     */
+    void loadingSortedAccessLog(uint16_t shardId);
+
+    /// Called by each task loading an access log once it's done; the last
+    /// one moves warmup on to the next state
+    void accessLogTaskDone();
+
     /* Terminal state of warmup. Updates statistics and marks warmup as
      * completed
      */
@@ -408,12 +434,23 @@ private:
 
     using MakeBackfillTaskFn = std::function<ExTask(size_t)>;
     /**
-     * Helper method to schedule a WarmupBackfillTask for each shard
+     * Helper method to schedule the WarmupBackfillTasks of a phase; at least
+     * one per shard, and by default one per reader thread
+     * (warmup_backfill_tasks).
      * @param makeBackfillTask function that will be call to create a
-     * WarmupBackfillTask for a given shard based on it's shardId.
+     * WarmupBackfillTask whose own shard is the given shardId.
      */
     void scheduleBackfillTask(MakeBackfillTaskFn makeBackfillTask);
 
+    /**
+     * Claim the next vbucket for a WarmupBackfillTask to load: the next one of
+     * the task's own shard, or if that shard has none left, the last one of
+     * the shard with the most left.
+     * @param shardId the task's own shard
+     * @return the vbucket, or nullopt if every vbucket has been claimed
+     */
+    std::optional<Vbid> claimBackfillVBucket(size_t shardId);
+
     void scheduleInitialize();
     void scheduleCreateVBuckets();
     void scheduleLoadingCollectionCounts();
@@ -457,6 +494,13 @@ private:
     /// contains all vBucket IDs which are present for the given shard.
     std::vector<std::vector<Vbid>> shardVbIds;
 
+    /// The vbuckets which the current backfill phase has still to load; one
+    /// queue per shard, in the order of shardVbIds
+    std::vector<std::deque<Vbid>> backfillQueues;
+    std::mutex backfillQueuesMutex;
+    /// The number of tasks running the current backfill phase
+    size_t backfillTaskCount{0};
+
     cb::AtomicDuration<> estimateTime;
     std::atomic<size_t> estimatedItemCount{std::numeric_limits<size_t>::max()};
     bool cleanShutdown{false};
@@ -492,6 +536,18 @@ private:
 
     std::deque<MutationLog> accessLog;
 
+    /// A sorted access log being loaded by one or more tasks
+    struct SortedAccessLogLoad {
+        std::unique_ptr<SortedAccessLogReader> log;
+        /// The index of the next vBucket of the log to be loaded
+        std::atomic<size_t> nextVBucket{0};
+    };
+    /// The sorted access log of each shard; null for shards whose access log
+    /// is loaded as a MutationLog
+    std::vector<std::unique_ptr<SortedAccessLogLoad>> sortedAccessLogs;
+    /// The number of tasks loading the access logs
+    size_t accessLogTaskCount{0};
+
     // To avoid making a number of methods on Warmup public; grant friendship
     // to the various Tasks which run the stages of warmup.
     friend class WarmupInitialize;
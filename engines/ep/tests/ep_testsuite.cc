@@ -6705,7 +6705,10 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "ep_dcp_queue_fill",
               "ep_dcp_total_bytes",
               "ep_dcp_total_uncompressed_data_size",
-              "ep_dcp_total_queue"}},
+              "ep_dcp_total_queue",
+              "ep_dcp_value_conversion_cache_bytes",
+              "ep_dcp_value_conversion_cache_hits",
+              "ep_dcp_value_conversion_cache_misses"}},
             {"hash",
              {"vb_0:counted",
               "vb_0:locks",
@@ -6715,6 +6718,8 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "vb_0:min_depth",
               "vb_0:num_system_items",
               "vb_0:reported",
+              "vb_0:resize_migrated",
+              "vb_0:resize_pending",
               "vb_0:resized",
               "vb_0:size",
               "vb_0:state"}},
@@ -6933,7 +6938,11 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "ep_bfilter_enabled",
               "ep_bfilter_fp_prob",
               "ep_bfilter_key_count",
+              "ep_bfilter_layout",
+              "ep_bfilter_persist",
               "ep_bfilter_residency_threshold",
+              "ep_bgfetch_coalescing_batch_size",
+              "ep_bgfetch_coalescing_max_window",
               "ep_bucket_type",
               "ep_cache_size",
               "ep_chk_expel_enabled",
@@ -6965,6 +6974,11 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "ep_dcp_conn_buffer_size_max",
               "ep_dcp_conn_buffer_size_perc",
               "ep_dcp_enable_noop",
+              "ep_dcp_flow_control_adaptive_backlog_target",
+              "ep_dcp_flow_control_adaptive_pid_d",
+              "ep_dcp_flow_control_adaptive_pid_dt",
+              "ep_dcp_flow_control_adaptive_pid_i",
+              "ep_dcp_flow_control_adaptive_pid_p",
               "ep_dcp_flow_control_policy",
               "ep_dcp_min_compression_ratio",
               "ep_dcp_idle_timeout",
@@ -6976,6 +6990,9 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "ep_dcp_consumer_process_buffered_messages_batch_size",
               "ep_dcp_scan_byte_limit",
               "ep_dcp_scan_item_limit",
+              "ep_dcp_value_conversion_cache_max_bytes",
+              "ep_dcp_value_conversion_cache_max_value_size",
+              "ep_dcp_value_conversion_cache_slots",
               "ep_dcp_takeover_max_time",
               "ep_defragmenter_age_threshold",
               "ep_defragmenter_auto_lower_threshold",
@@ -7004,14 +7021,19 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "ep_couchstore_write_validation",
               "ep_couchstore_mprotect",
               "ep_couchstore_file_cache_max_size",
+              "ep_couchstore_file_ops",
               "ep_couchstore_midpoint_rollback_optimisation",
               "ep_getl_default_timeout",
               "ep_getl_max_timeout",
               "ep_hlc_drift_ahead_threshold_us",
               "ep_hlc_drift_behind_threshold_us",
+              "ep_ht_inline_value_max_size",
+              "ep_ht_layout",
               "ep_ht_locks",
+              "ep_ht_resize_algorithm",
               "ep_ht_resize_interval",
               "ep_ht_size",
+              "ep_ht_sweeper_enabled",
               "ep_item_compressor_chunk_duration",
               "ep_item_compressor_interval",
               "ep_item_eviction_age_percentage",
@@ -7095,6 +7117,7 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "ep_uuid",
               "ep_vbucket_mapping_sanity_checking",
               "ep_vbucket_mapping_sanity_checking_error_mode",
+              "ep_warmup_backfill_tasks",
               "ep_warmup_batch_size",
               "ep_warmup_min_items_threshold",
               "ep_warmup_min_memory_threshold",
@@ -7151,12 +7174,16 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "ep_bfilter_enabled",
               "ep_bfilter_fp_prob",
               "ep_bfilter_key_count",
+              "ep_bfilter_layout",
+              "ep_bfilter_persist",
               "ep_bfilter_residency_threshold",
               "ep_bg_fetch_avg_read_amplification",
               "ep_bg_fetched",
               "ep_bg_meta_fetched",
               "ep_bg_remaining_items",
               "ep_bg_remaining_jobs",
+              "ep_bgfetch_coalescing_batch_size",
+              "ep_bgfetch_coalescing_max_window",
               "ep_blob_num",
               "ep_blob_overhead",
               "ep_bucket_priority",
@@ -7206,6 +7233,11 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "ep_dcp_consumer_process_buffered_messages_batch_size",
               "ep_dcp_consumer_process_buffered_messages_yield_limit",
               "ep_dcp_enable_noop",
+              "ep_dcp_flow_control_adaptive_backlog_target",
+              "ep_dcp_flow_control_adaptive_pid_d",
+              "ep_dcp_flow_control_adaptive_pid_dt",
+              "ep_dcp_flow_control_adaptive_pid_i",
+              "ep_dcp_flow_control_adaptive_pid_p",
               "ep_dcp_flow_control_policy",
               "ep_dcp_idle_timeout",
               "ep_dcp_min_compression_ratio",
@@ -7214,6 +7246,9 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "ep_dcp_producer_snapshot_marker_yield_limit",
               "ep_dcp_scan_byte_limit",
               "ep_dcp_scan_item_limit",
+              "ep_dcp_value_conversion_cache_max_bytes",
+              "ep_dcp_value_conversion_cache_max_value_size",
+              "ep_dcp_value_conversion_cache_slots",
               "ep_dcp_takeover_max_time",
               "ep_defragmenter_age_threshold",
               "ep_defragmenter_auto_lower_threshold",
@@ -7256,14 +7291,19 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "ep_couchstore_write_validation",
               "ep_couchstore_mprotect",
               "ep_couchstore_file_cache_max_size",
+              "ep_couchstore_file_ops",
               "ep_couchstore_midpoint_rollback_optimisation",
               "ep_getl_default_timeout",
               "ep_getl_max_timeout",
               "ep_hlc_drift_ahead_threshold_us",
               "ep_hlc_drift_behind_threshold_us",
+              "ep_ht_inline_value_max_size",
+              "ep_ht_layout",
               "ep_ht_locks",
+              "ep_ht_resize_algorithm",
               "ep_ht_resize_interval",
               "ep_ht_size",
+              "ep_ht_sweeper_enabled",
               "ep_io_bg_fetch_read_count",
               "ep_io_compaction_read_bytes",
               "ep_io_compaction_write_bytes",
@@ -7426,6 +7466,7 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
               "ep_vbucket_del_fail",
               "ep_vbucket_mapping_sanity_checking",
               "ep_vbucket_mapping_sanity_checking_error_mode",
+              "ep_warmup_backfill_tasks",
               "ep_warmup_batch_size",
               "ep_warmup_min_items_threshold",
               "ep_warmup_min_memory_threshold",
@@ -7646,13 +7687,18 @@ static enum test_result test_mb19687_fixed(EngineIface* h) {
         std::initializer_list<std::string_view> persistentConfig = {
                 "ep_access_scanner_enabled",
                 "ep_alog_block_size",
+                "ep_alog_format",
                 "ep_alog_max_stored_items",
                 "ep_alog_path",
                 "ep_alog_resident_ratio_threshold",
                 "ep_alog_sleep_time",
                 "ep_alog_task_time",
+                "ep_dcp_backfill_prefetch_bytes",
                 "ep_item_eviction_policy",
                 "ep_persistent_metadata_purge_age",
+                "ep_range_scan_idle_timeout",
+                "ep_range_scan_max_continue_bytes",
+                "ep_range_scan_max_continue_tasks",
                 "ep_warmup"};
         eng_stats.insert(eng_stats.end(), persistentConfig);
 
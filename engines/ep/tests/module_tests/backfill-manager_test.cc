@@ -378,3 +378,72 @@ TEST_F(BackfillManagerTest, SnoozingQNotifiesTrackerOnDtor) {
     // Test: Destroy the backfill manager while backfill still in snoozingQ.
     backfillMgr.reset();
 }
+
+/*
+ * Check that a Backfill waiting for data (backfill_waiting) stays in the
+ * activeQ and keeps its place in the round-robin order.
+ */
+TEST_F(BackfillManagerTest, WaitingStaysActive) {
+    // Not interested in behaviour of backfillTracker for this test.
+    ignoreBackfillTracker();
+
+    auto backfill0 = std::make_unique<GMockDCPBackfill>();
+    auto backfill1 = std::make_unique<GMockDCPBackfill>();
+
+    {
+        InSequence s;
+        EXPECT_CALL(*backfill0, run())
+                .WillOnce(Return(backfill_waiting))
+                .RetiresOnSaturation();
+        EXPECT_CALL(*backfill1, run())
+                .WillOnce(Return(backfill_waiting))
+                .RetiresOnSaturation();
+        EXPECT_CALL(*backfill0, run())
+                .WillOnce(Return(backfill_finished))
+                .RetiresOnSaturation();
+        EXPECT_CALL(*backfill1, run())
+                .WillOnce(Return(backfill_finished))
+                .RetiresOnSaturation();
+    }
+
+    ASSERT_EQ(BackfillManager::ScheduleResult::Active,
+              backfillMgr->schedule(std::move(backfill0)));
+    ASSERT_EQ(BackfillManager::ScheduleResult::Active,
+              backfillMgr->schedule(std::move(backfill1)));
+    EXPECT_EQ(backfill_success, backfillMgr->backfill());
+    EXPECT_EQ(backfill_success, backfillMgr->backfill());
+    EXPECT_EQ(2, backfillMgr->getNumBackfills());
+    EXPECT_EQ(backfill_success, backfillMgr->backfill());
+    EXPECT_EQ(backfill_success, backfillMgr->backfill());
+    EXPECT_EQ(0, backfillMgr->getNumBackfills());
+}
+
+/*
+ * Check that bytes prefetched ahead of the streams are charged to the
+ * backfill buffer alongside the bytes read, and released once taken.
+ */
+TEST_F(BackfillManagerTest, PrefetchChargedToBuffer) {
+    auto bfm = std::make_shared<BackfillManager>(*engine->getKVBucket(),
+                                                 backfillTracker,
+                                                 "PrefetchChargedToBuffer",
+                                                 1000 /*scanByteLimit*/,
+                                                 10 /*scanItemLimit*/,
+                                                 100 /*backfillByteLimit*/);
+
+    // A prefetch into an empty buffer is always allowed
+    EXPECT_TRUE(bfm->bytesCheckAndPrefetch(60));
+    EXPECT_FALSE(bfm->bytesCheckAndPrefetch(60));
+    EXPECT_EQ(60, bfm->getBytesPrefetched());
+
+    // The stream takes a prefetched item; it's charged as read, and the
+    // reservation released
+    EXPECT_TRUE(bfm->bytesCheckAndRead(30));
+    EXPECT_FALSE(bfm->bytesCheckAndPrefetch(20));
+    bfm->bytesPrefetchReleased(30);
+    EXPECT_TRUE(bfm->bytesCheckAndPrefetch(20));
+    EXPECT_EQ(50, bfm->getBytesPrefetched());
+
+    bfm->bytesPrefetchReleased(50);
+    EXPECT_EQ(0, bfm->getBytesPrefetched());
+    EXPECT_THROW(bfm->bytesPrefetchReleased(1), std::invalid_argument);
+}
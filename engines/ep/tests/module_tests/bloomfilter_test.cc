@@ -94,6 +94,130 @@ TEST_F(BloomFilterTest, FalsePositiveRate) {
                 expectedFalsePositives * 0.1);
 }
 
+// Blocked filters round up to whole 512-bit blocks, and derive the number of
+// hashes from the target false positive probability only.
+TEST_F(BloomFilterTest, BlockedSizeCalculation) {
+    for (size_t keys : {1, 10, 100, 1000, 10000, 100000}) {
+        BloomFilter bf(keys,
+                       0.01,
+                       BFILTER_ENABLED,
+                       BloomFilter::Layout::Blocked);
+        EXPECT_EQ(BloomFilter::Layout::Blocked, bf.getLayout());
+        EXPECT_EQ(0, bf.getFilterSize() % 512) << "For keys=" << keys;
+        EXPECT_LE(keys * 9, bf.getFilterSize()) << "For keys=" << keys;
+        EXPECT_EQ(7, bf.getNoOfHashes()) << "For keys=" << keys;
+    }
+}
+
+TEST_F(BloomFilterTest, BlockedPositiveCheck) {
+    const int numKeys = 10000;
+    BloomFilter bf(
+            numKeys, 0.01, BFILTER_ENABLED, BloomFilter::Layout::Blocked);
+    for (int i = 0; i < numKeys; i++) {
+        bf.addKey(makeStoredDocKey("key_" + std::to_string(i)));
+    }
+
+    for (int i = 0; i < numKeys; i++) {
+        auto key = makeStoredDocKey("key_" + std::to_string(i));
+        EXPECT_TRUE(bf.maybeKeyExists(key)) << "For key:" << key.to_string();
+    }
+    EXPECT_EQ(numKeys, bf.getNumOfKeysInFilter());
+}
+
+// A blocked filter trades a slightly higher false positive rate for touching
+// a single cache line per key; check it remains in the right ballpark.
+TEST_F(BloomFilterTest, BlockedFalsePositiveRate) {
+    const int numKeys = 10000;
+    const double targetFalsePositive = 0.01;
+
+    BloomFilter bf(numKeys,
+                   targetFalsePositive,
+                   BFILTER_ENABLED,
+                   BloomFilter::Layout::Blocked);
+    for (int i = 0; i < numKeys; i++) {
+        bf.addKey(makeStoredDocKey("key_" + std::to_string(i)));
+    }
+
+    int falsePositives = 0;
+    for (int i = 0; i < numKeys; i++) {
+        if (bf.maybeKeyExists(
+                    makeStoredDocKey("key_" + std::to_string(numKeys + i)))) {
+            falsePositives++;
+        }
+    }
+
+    const int expectedFalsePositives = numKeys * targetFalsePositive;
+    EXPECT_LT(0, falsePositives);
+    EXPECT_GT(expectedFalsePositives * 2, falsePositives);
+}
+
+TEST_F(BloomFilterTest, SerialiseRequiresEnabled) {
+    BloomFilter bf(10, 0.01, BFILTER_DISABLED);
+    EXPECT_THROW(bf.serialise(1, 1), std::logic_error);
+}
+
+class BloomFilterSerialiseTest
+    : public ::testing::TestWithParam<BloomFilter::Layout> {
+protected:
+    std::unique_ptr<BloomFilter> makeFilter() {
+        auto bf = std::make_unique<BloomFilter>(
+                numKeys, 0.01, BFILTER_ENABLED, GetParam());
+        for (int i = 0; i < numKeys; i++) {
+            bf->addKey(makeStoredDocKey("key_" + std::to_string(i)));
+        }
+        return bf;
+    }
+
+    static constexpr int numKeys = 1000;
+    static constexpr uint64_t vbUuid = 0xdeadbeef;
+    static constexpr uint64_t seqno = 1234;
+};
+
+TEST_P(BloomFilterSerialiseTest, RoundTrip) {
+    auto bf = makeFilter();
+    const auto data = bf->serialise(vbUuid, seqno);
+
+    auto restored = BloomFilter::deserialise(data, vbUuid, seqno);
+    ASSERT_TRUE(restored);
+    EXPECT_EQ(BFILTER_ENABLED, restored->getStatus());
+    EXPECT_EQ(GetParam(), restored->getLayout());
+    EXPECT_EQ(bf->getFilterSize(), restored->getFilterSize());
+    EXPECT_EQ(bf->getNoOfHashes(), restored->getNoOfHashes());
+    EXPECT_EQ(bf->getNumOfKeysInFilter(), restored->getNumOfKeysInFilter());
+
+    // Every key (and every false positive) must be preserved.
+    for (int i = 0; i < numKeys * 2; i++) {
+        auto key = makeStoredDocKey("key_" + std::to_string(i));
+        EXPECT_EQ(bf->maybeKeyExists(key), restored->maybeKeyExists(key))
+                << "For key:" << key.to_string();
+    }
+}
+
+TEST_P(BloomFilterSerialiseTest, RejectsStale) {
+    const auto data = makeFilter()->serialise(vbUuid, seqno);
+    EXPECT_FALSE(BloomFilter::deserialise(data, vbUuid + 1, seqno));
+    EXPECT_FALSE(BloomFilter::deserialise(data, vbUuid, seqno + 1));
+}
+
+TEST_P(BloomFilterSerialiseTest, RejectsCorrupt) {
+    const auto data = makeFilter()->serialise(vbUuid, seqno);
+    EXPECT_FALSE(BloomFilter::deserialise({}, vbUuid, seqno));
+    EXPECT_FALSE(BloomFilter::deserialise(
+            std::string_view(data).substr(0, data.size() - 1), vbUuid, seqno));
+
+    auto corrupt = data;
+    corrupt[corrupt.size() / 2] ^= 0x1;
+    EXPECT_FALSE(BloomFilter::deserialise(corrupt, vbUuid, seqno));
+}
+
+INSTANTIATE_TEST_SUITE_P(Layouts,
+                         BloomFilterSerialiseTest,
+                         ::testing::Values(BloomFilter::Layout::Classic,
+                                           BloomFilter::Layout::Blocked),
+                         [](const auto& info) {
+                             return to_string(info.param);
+                         });
+
 class BloomFilterDocKeyTest
     : public BloomFilter,
       public ::testing::TestWithParam<std::tuple<CollectionID, CollectionID>> {
@@ -113,22 +113,17 @@ TEST_F(CheckpointRemoverEPTest, CheckpointManagerMemoryUsage) {
     // We should have one checkpoint which is for the state change
     ASSERT_EQ(1, checkpointManager->getNumCheckpoints());
 
-    // Allocator used for tracking memory used by the CheckpointQueue
-    checkpoint_index::allocator_type memoryTrackingAllocator;
-
-    // Allocator used for tracking the memory usage of the keys in the
-    // checkpoint indexes.
-    checkpoint_index::key_type::allocator_type keyIndexKeyTrackingAllocator;
+    // Allocator used for tracking memory used by the checkpoint indexes
+    CheckpointIndex::allocator_type memoryTrackingAllocator;
 
     // Emulate the Checkpoint preparedKeyIndex and committedKeyIndex so we can
     // determine the number of bytes that should be allocated during its use.
-    checkpoint_index committedKeyIndex(memoryTrackingAllocator);
-    checkpoint_index preparedKeyIndex(memoryTrackingAllocator);
-    const auto iterator =
+    auto& queue =
             CheckpointManagerTestIntrospector::public_getOpenCheckpointQueue(
-                    *checkpointManager)
-                    .begin();
-    IndexEntry entry{iterator};
+                    *checkpointManager);
+    CheckpointIndex committedKeyIndex(queue, memoryTrackingAllocator);
+    CheckpointIndex preparedKeyIndex(queue, memoryTrackingAllocator);
+    IndexEntry entry{queue.begin()};
 
     // Check that the expected memory usage of the checkpoints is correct
     size_t expected_size = 0;
@@ -157,16 +152,13 @@ TEST_F(CheckpointRemoverEPTest, CheckpointManagerMemoryUsage) {
     // Add the size of adding to the queue
     new_expected_size += Checkpoint::per_item_queue_overhead;
     // Add to the keyIndex
-    committedKeyIndex.emplace(
-            CheckpointIndexKeyType(item.getKey(), keyIndexKeyTrackingAllocator),
-            entry);
+    committedKeyIndex.insertOrAssign(item.getKey(), entry);
 
-    // As the metaKeyIndex, preparedKeyIndex and committedKeyIndex all share
-    // the same allocator, retrieving the bytes allocated for the keyIndex,
-    // will also include the bytes allocated for the other indexes.
+    // As the preparedKeyIndex and committedKeyIndex share the same
+    // allocator, retrieving the bytes allocated for the keyIndex will also
+    // include the bytes allocated for the other index.
     const size_t keyIndexSize =
-            committedKeyIndex.get_allocator().getBytesAllocated() +
-            keyIndexKeyTrackingAllocator.getBytesAllocated();
+            committedKeyIndex.get_allocator().getBytesAllocated();
     ASSERT_EQ(new_expected_size + keyIndexSize,
               checkpointManager->getMemoryUsage());
 }
@@ -245,25 +237,18 @@ TEST_F(CheckpointRemoverEPTest, CursorDropMemoryFreed) {
 
     createDcpStream(*producer);
 
-    // Allocator used for tracking memory used by the CheckpointQueue
-    checkpoint_index::allocator_type memoryTrackingAllocator;
-
-    // Allocator used for tracking the memory usage of the keys in the
-    // checkpoint indexes.
-    checkpoint_index::key_type::allocator_type keyIndexKeyTrackingAllocator;
+    // Allocator used for tracking memory used by the checkpoint index
+    CheckpointIndex::allocator_type memoryTrackingAllocator;
 
     // Emulate the Checkpoint keyIndex so we can determine the number
     // of bytes that should be allocated during its use.
-    checkpoint_index keyIndex(memoryTrackingAllocator);
-    // Grab the initial size of the keyIndex because on Windows an empty
-    // std::unordered_map allocated 200 bytes.
+    auto& queue =
+            CheckpointManagerTestIntrospector::public_getOpenCheckpointQueue(
+                    *checkpointManager);
+    CheckpointIndex keyIndex(queue, memoryTrackingAllocator);
     const auto initialKeyIndexSize =
             keyIndex.get_allocator().getBytesAllocated();
-    const auto iterator =
-            CheckpointManagerTestIntrospector::public_getOpenCheckpointQueue(
-                    *checkpointManager)
-                    .begin();
-    IndexEntry entry{iterator};
+    IndexEntry entry{queue.begin()};
 
     auto expectedFreedMemoryFromItems = initialSize;
     for (size_t i = 0; i < getMaxCheckpointItems(*vb); i++) {
@@ -273,9 +258,7 @@ TEST_F(CheckpointRemoverEPTest, CursorDropMemoryFreed) {
         // Add the size of adding to the queue
         expectedFreedMemoryFromItems += Checkpoint::per_item_queue_overhead;
         // Add to the emulated keyIndex
-        keyIndex.emplace(CheckpointIndexKeyType(item.getKey(),
-                                                keyIndexKeyTrackingAllocator),
-                         entry);
+        keyIndex.insertOrAssign(item.getKey(), entry);
     }
 
     ASSERT_EQ(1, checkpointManager->getNumCheckpoints());
@@ -306,9 +289,7 @@ TEST_F(CheckpointRemoverEPTest, CursorDropMemoryFreed) {
     expectedFreedMemoryFromItems += Checkpoint::per_item_queue_overhead;
 
     const auto keyIndexSize = keyIndex.get_allocator().getBytesAllocated();
-    expectedFreedMemoryFromItems +=
-            (keyIndexSize - initialKeyIndexSize +
-             keyIndexKeyTrackingAllocator.getBytesAllocated());
+    expectedFreedMemoryFromItems += keyIndexSize - initialKeyIndexSize;
 
     // Manually handle the slow stream, this is the same logic as the checkpoint
     // remover task uses, just without the overhead of setting up the task
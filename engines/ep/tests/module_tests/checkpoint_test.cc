@@ -4086,4 +4086,57 @@ TEST_F(CheckpointConfigTest, CheckpointPeriod) {
     auto& manager = *store->getVBuckets().getBucket(vbid)->checkpointManager;
 
     EXPECT_EQ(1234, manager.getCheckpointConfig().getCheckpointPeriod());
-}
\ No newline at end of file
+}
+
+/**
+ * Test the CheckpointIndex directly: keys are found (compared against the
+ * queued item), entries can be moved and invalidated, and the index keeps
+ * working as it grows.
+ */
+TEST(CheckpointIndexTest, FindInsertGrowInvalidate) {
+    CheckpointQueue queue{MemoryTrackingAllocator<queued_item>()};
+    queue.push_back(queued_item{});
+    CheckpointIndex index(queue, CheckpointIndex::allocator_type());
+
+    const auto key = makeStoredDocKey("key");
+    EXPECT_FALSE(index.find(key));
+    EXPECT_EQ(0, index.get_allocator().getBytesAllocated());
+
+    // Enough keys to grow the index a few times
+    std::vector<StoredDocKey> keys;
+    for (int ii = 0; ii < 1000; ++ii) {
+        keys.emplace_back(makeStoredDocKey("key_" + std::to_string(ii)));
+        queue.push_back(makeCommittedItem(keys.back(), "value"));
+        EXPECT_TRUE(index.insertOrAssign(keys.back(),
+                                         IndexEntry(std::prev(queue.end()))));
+    }
+    EXPECT_EQ(keys.size(), index.size());
+    EXPECT_FALSE(index.find(key));
+
+    auto pos = std::next(queue.begin());
+    for (const auto& k : keys) {
+        auto* entry = index.find(k);
+        ASSERT_TRUE(entry) << k;
+        EXPECT_EQ(pos, entry->getPosition());
+        ++pos;
+    }
+
+    // Moving the entry of an existing key doesn't add a key
+    queue.push_back(makeCommittedItem(keys.front(), "value2"));
+    EXPECT_FALSE(index.insertOrAssign(keys.front(),
+                                      IndexEntry(std::prev(queue.end()))));
+    EXPECT_EQ(keys.size(), index.size());
+    EXPECT_EQ(std::prev(queue.end()), index.find(keys.front())->getPosition());
+
+    // An invalidated (expelled) entry is still found by its key
+    index.find(keys.back())->invalidate(queue.end());
+    auto* entry = index.find(keys.back());
+    ASSERT_TRUE(entry);
+    EXPECT_EQ(queue.end(), entry->getPosition());
+
+    // Only the slots are allocated, not the keys
+    EXPECT_GE(index.get_allocator().getBytesAllocated(),
+              keys.size() * sizeof(CheckpointIndex::Slot));
+    EXPECT_LT(index.get_allocator().getBytesAllocated(),
+              keys.size() * 3 * sizeof(CheckpointIndex::Slot));
+}
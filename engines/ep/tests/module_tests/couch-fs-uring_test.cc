@@ -0,0 +1,118 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#ifdef EP_USE_LIBURING
+
+#include "kvstore/couch-kvstore/couch-fs-uring.h"
+
+#include <folly/portability/GTest.h>
+#include <platform/dirutils.h>
+
+#include <fcntl.h>
+#include <string>
+
+class UringOpsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = cb::io::mkdtemp("couch-fs-uring_test.XXXXXX");
+        handle = ops.constructor(&errinfo);
+        ASSERT_EQ(COUCHSTORE_SUCCESS,
+                  ops.open(&errinfo,
+                           &handle,
+                           (dir + "/file").c_str(),
+                           O_RDWR | O_CREAT));
+    }
+
+    void TearDown() override {
+        EXPECT_EQ(COUCHSTORE_SUCCESS, ops.close(&errinfo, handle));
+        ops.destructor(handle);
+        cb::io::rmrf(dir);
+    }
+
+    std::string read(size_t size, cs_off_t offset) {
+        std::string buffer(size, '\0');
+        const auto bytes =
+                ops.pread(&errinfo, handle, buffer.data(), size, offset);
+        EXPECT_EQ(ssize_t(size), bytes);
+        return buffer;
+    }
+
+    void write(const std::string& data, cs_off_t offset) {
+        EXPECT_EQ(ssize_t(data.size()),
+                  ops.pwrite(&errinfo,
+                             handle,
+                             data.data(),
+                             data.size(),
+                             offset));
+    }
+
+    UringOps& ops = dynamic_cast<UringOps&>(getCouchstoreUringOps());
+    couchstore_error_info_t errinfo{};
+    std::string dir;
+    couch_file_handle handle;
+};
+
+// Queued writes are visible to reads and to goto_eof, before a sync
+TEST_F(UringOpsTest, QueuedWritesAreVisible) {
+    write("hello ", 0);
+    write("world", 6);
+    write("HELLO", 0);
+    EXPECT_EQ(11, ops.goto_eof(&errinfo, handle));
+    EXPECT_EQ("HELLO world", read(11, 0));
+    EXPECT_EQ(COUCHSTORE_SUCCESS, ops.sync(&errinfo, handle));
+    EXPECT_EQ("world", read(5, 6));
+}
+
+// More writes than fit in one submission are all written by the sync
+TEST_F(UringOpsTest, ManyWritesThenSync) {
+    std::string expected;
+    for (unsigned ii = 0; ii < UringOps::QueueDepth * 3; ++ii) {
+        // Leave a gap between writes so they aren't coalesced
+        const std::string data = std::to_string(ii);
+        write(data, ii * 8);
+        expected.resize(ii * 8, '\0');
+        expected.append(data);
+    }
+    EXPECT_EQ(COUCHSTORE_SUCCESS, ops.sync(&errinfo, handle));
+    EXPECT_EQ(cs_off_t(expected.size()), ops.goto_eof(&errinfo, handle));
+    EXPECT_EQ(expected, read(expected.size(), 0));
+}
+
+// A sync with nothing queued succeeds
+TEST_F(UringOpsTest, EmptySync) {
+    EXPECT_EQ(COUCHSTORE_SUCCESS, ops.sync(&errinfo, handle));
+}
+
+// Periodic sync submits the writes once enough bytes were written
+TEST_F(UringOpsTest, PeriodicSync) {
+    EXPECT_EQ(COUCHSTORE_SUCCESS, ops.set_periodic_sync(handle, 8));
+    write("12345678", 0);
+    write("9", 8);
+    EXPECT_EQ("123456789", read(9, 0));
+}
+
+// Read ahead of ranges (including past the end of the file) doesn't change
+// what's read
+TEST_F(UringOpsTest, ReadAhead) {
+    const std::string data(64 * 1024, 'x');
+    write(data, 0);
+    EXPECT_EQ(COUCHSTORE_SUCCESS, ops.sync(&errinfo, handle));
+
+    std::vector<UringOps::ReadRange> ranges;
+    for (cs_off_t offset = 0; offset < 128 * 1024; offset += 1000) {
+        ranges.push_back({offset, 5000});
+    }
+    ranges.push_back({0, UringOps::MaxReadAheadBytes * 2});
+    ops.readAhead(handle, ranges);
+    EXPECT_EQ(data, read(data.size(), 0));
+}
+
+#endif
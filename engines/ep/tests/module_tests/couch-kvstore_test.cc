@@ -37,6 +37,7 @@
 #include <folly/portability/GMock.h>
 #include <platform/dirutils.h>
 
+#include <algorithm>
 #include <fstream>
 #include <memory>
 
@@ -888,6 +889,74 @@ TEST_F(CouchKVStoreErrorInjectionTest, getMulti_open_doc_with_docinfo) {
               itms[DiskDocKey{*items.at(0)}].value.getStatus());
 }
 
+/**
+ * Test that getMulti of several keys reads their bodies in file order (by
+ * DocInfo::bp) rather than in key order.
+ */
+TEST_F(CouchKVStoreErrorInjectionTest, getMulti_reads_in_file_order) {
+    // Write the keys in reverse, so their file order is the reverse of their
+    // key order
+    generate_items(4);
+    std::reverse(items.begin(), items.end());
+    auto ctx = kvstore->begin(vbid, std::make_unique<PersistenceCallback>());
+    for (size_t ii = 0; ii < items.size(); ++ii) {
+        items[ii]->setBySeqno(ii + 1);
+        kvstore->set(*ctx, items[ii]);
+    }
+    flush.proposedVBState.lastSnapEnd = items.size();
+    kvstore->commit(std::move(ctx), flush);
+
+    std::vector<cs_off_t> offsets;
+    EXPECT_CALL(ops, pread(_, _, _, _, _))
+            .WillRepeatedly(Invoke([this, &offsets](
+                                           couchstore_error_info_t* errinfo,
+                                           couch_file_handle handle,
+                                           void* buf,
+                                           size_t nbytes,
+                                           cs_off_t offset) -> ssize_t {
+                offsets.push_back(offset);
+                return ops.get_wrapped()->pread(
+                        errinfo, handle, buf, nbytes, offset);
+            }));
+
+    // A single key is read without deferring its body; the last read of it
+    // is its body
+    std::vector<cs_off_t> bodyOffsets;
+    for (const auto& item : items) {
+        vb_bgfetch_queue_t itms;
+        vb_bgfetch_item_ctx_t itemCtx;
+        itemCtx.addBgFetch(std::make_unique<FrontEndBGFetchItem>(
+                nullptr, ValueFilter::VALUES_DECOMPRESSED, 0));
+        itms[DiskDocKey{*item}] = std::move(itemCtx);
+        offsets.clear();
+        kvstore->getMulti(vbid, itms);
+        ASSERT_EQ(cb::engine_errc::success,
+                  itms[DiskDocKey{*item}].value.getStatus());
+        ASSERT_FALSE(offsets.empty());
+        bodyOffsets.push_back(offsets.back());
+    }
+    // Sanity check - items are in file order, so key order is the reverse
+    ASSERT_TRUE(std::is_sorted(bodyOffsets.begin(), bodyOffsets.end()));
+
+    vb_bgfetch_queue_t itms(make_bgfetch_queue());
+    offsets.clear();
+    kvstore->getMulti(vbid, itms);
+    for (const auto& item : items) {
+        EXPECT_EQ(cb::engine_errc::success,
+                  itms[DiskDocKey{*item}].value.getStatus());
+    }
+
+    // Each body is read once, in file order
+    std::vector<size_t> readOrder;
+    for (const auto bodyOffset : bodyOffsets) {
+        auto itr = std::find(offsets.begin(), offsets.end(), bodyOffset);
+        ASSERT_NE(offsets.end(), itr);
+        EXPECT_EQ(1, std::count(offsets.begin(), offsets.end(), bodyOffset));
+        readOrder.push_back(std::distance(offsets.begin(), itr));
+    }
+    EXPECT_TRUE(std::is_sorted(readOrder.begin(), readOrder.end()));
+}
+
 /**
  * Injects error during CouchKVStore::compactDB/couchstore_compact_db_ex
  */
@@ -24,6 +24,7 @@
 #include "tests/module_tests/test_helpers.h"
 #include "thread_gate.h"
 
+#include <platform/dirutils.h>
 #include <utilities/test_manifest.h>
 
 #include <thread>
@@ -1035,6 +1036,36 @@ TEST_P(STParamCouchstoreBucketTest, CompactionUpdatesBloomFilter) {
     EXPECT_EQ(expected, vb->getFilterSize());
 }
 
+TEST_P(STParamCouchstoreBucketTest, BloomFilterPersistedAcrossWarmup) {
+    engine->getConfiguration().setBfilterPersist(true);
+    setVBucketStateAndRunPersistTask(vbid, vbucket_state_active);
+
+    const int numKeys = 10;
+    for (int i = 0; i < numKeys; i++) {
+        store_item(vbid, makeStoredDocKey("key_" + std::to_string(i)), "v");
+    }
+    flushVBucketToDiskIfPersistent(vbid, numKeys);
+
+    resetEngineAndWarmup("bfilter_persist=true");
+
+    // The filter saved at shutdown should have been restored during warmup
+    // and the file consumed.
+    auto vb = store->getVBucket(vbid);
+    ASSERT_TRUE(vb);
+    EXPECT_EQ("ENABLED", vb->getFilterStatusString());
+    EXPECT_FALSE(cb::io::isFile(test_dbname + "/0.bloomfilter"));
+
+    // Under full eviction all keys are added before saving, so none of them
+    // may be reported as absent.
+    if (fullEviction()) {
+        EXPECT_EQ(numKeys, vb->getNumOfKeysInFilter());
+        for (int i = 0; i < numKeys; i++) {
+            EXPECT_TRUE(vb->maybeKeyExistsInFilter(
+                    makeStoredDocKey("key_" + std::to_string(i))));
+        }
+    }
+}
+
 TEST_P(STParamCouchstoreBucketTest,
        RollbackCompletionCallbackStateAfterCompletionCallbackFailure) {
     replaceCouchKVStoreWithMock();
@@ -3996,6 +3996,138 @@ TEST_P(SingleThreadedBackfillBufferTest, SingleItemBuffer) {
     testBackfill();
 }
 
+/**
+ * Backfill with the by-seqno scan prefetched by a BackfillPrefetcher. The
+ * window is capped at dcp_backfill_byte_limit, so it holds a single item and
+ * the stream must see the same sequence of items as without prefetching.
+ */
+class SingleThreadedBackfillPrefetchTest : public SingleThreadedBackfillTest {
+public:
+    void SetUp() override {
+        config_string +=
+                "dcp_backfill_byte_limit=1;dcp_backfill_prefetch_bytes=1024";
+        SingleThreadedActiveStreamTest::SetUp();
+    }
+
+    void TearDown() override {
+        SingleThreadedActiveStreamTest::TearDown();
+    }
+};
+
+TEST_P(SingleThreadedBackfillPrefetchTest, SingleItemWindow) {
+    testBackfill();
+}
+
+/**
+ * Backfill with a prefetch window of several items. The items read by the
+ * prefetch task are handed to the stream by the next drain, without it
+ * running the scan again.
+ */
+class SingleThreadedBackfillPrefetchWindowTest
+    : public SingleThreadedBackfillTest {
+public:
+    void SetUp() override {
+        config_string += "dcp_backfill_prefetch_bytes=1048576";
+        SingleThreadedActiveStreamTest::SetUp();
+    }
+
+    void TearDown() override {
+        SingleThreadedActiveStreamTest::TearDown();
+    }
+};
+
+TEST_P(SingleThreadedBackfillPrefetchWindowTest, DrainPrefetchedItems) {
+    auto vb = engine->getVBucket(vbid);
+    auto& ckptMgr = *vb->checkpointManager;
+    stream.reset();
+
+    const int numItems = 5;
+    for (int ii = 0; ii < numItems; ++ii) {
+        store_item(vbid, makeStoredDocKey("key" + std::to_string(ii)), "value");
+    }
+    ckptMgr.createNewCheckpoint();
+    flushVBucketToDiskIfPersistent(vbid, numItems);
+    ASSERT_EQ(numItems, ckptMgr.removeClosedUnrefCheckpoints().count);
+
+    stream = producer->mockActiveStreamRequest(0 /*flags*/,
+                                               0 /*opaque*/,
+                                               *vb,
+                                               0 /*st_seqno*/,
+                                               ~0 /*en_seqno*/,
+                                               0x0 /*vb_uuid*/,
+                                               0 /*snap_start_seqno*/,
+                                               ~0 /*snap_end_seqno*/);
+    ASSERT_TRUE(stream->isBackfilling());
+
+    // Create the backfill, which schedules the prefetch task
+    auto& bfm = producer->getBFM();
+    EXPECT_EQ(backfill_status_t::backfill_success, bfm.backfill());
+
+    // The window holds every item, so one pass reads them all and completes
+    // the scan; the task doesn't run again
+    auto& auxIoQ = *task_executor->getLpTaskQ()[AUXIO_TASK_IDX];
+    runNextTask(auxIoQ, "Prefetching backfill items");
+    EXPECT_EQ(0, auxIoQ.getReadyQueueSize() + auxIoQ.getFutureQueueSize());
+    EXPECT_EQ(0, stream->getNumBackfillItems());
+    // The window is charged to the backfill buffer
+    EXPECT_NE(0, bfm.getBytesPrefetched());
+
+    // One drain hands over the prefetched items and completes the scan
+    EXPECT_EQ(backfill_status_t::backfill_success, bfm.backfill());
+    EXPECT_EQ(numItems, stream->getNumBackfillItems());
+    EXPECT_EQ(0, bfm.getBytesPrefetched());
+    EXPECT_EQ(backfill_status_t::backfill_finished, bfm.backfill());
+}
+
+/**
+ * The prefetch window is charged to the producer's backfill buffer, so
+ * prefetching pauses while the buffer is full of items not yet sent.
+ */
+TEST_P(SingleThreadedBackfillPrefetchWindowTest, PausedByBackfillBuffer) {
+    auto vb = engine->getVBucket(vbid);
+    auto& ckptMgr = *vb->checkpointManager;
+    stream.reset();
+
+    const int numItems = 5;
+    for (int ii = 0; ii < numItems; ++ii) {
+        store_item(vbid, makeStoredDocKey("key" + std::to_string(ii)), "value");
+    }
+    ckptMgr.createNewCheckpoint();
+    flushVBucketToDiskIfPersistent(vbid, numItems);
+    ASSERT_EQ(numItems, ckptMgr.removeClosedUnrefCheckpoints().count);
+
+    stream = producer->mockActiveStreamRequest(0 /*flags*/,
+                                               0 /*opaque*/,
+                                               *vb,
+                                               0 /*st_seqno*/,
+                                               ~0 /*en_seqno*/,
+                                               0x0 /*vb_uuid*/,
+                                               0 /*snap_start_seqno*/,
+                                               ~0 /*snap_end_seqno*/);
+    ASSERT_TRUE(stream->isBackfilling());
+
+    auto& bfm = producer->getBFM();
+    EXPECT_EQ(backfill_status_t::backfill_success, bfm.backfill());
+
+    // Fill the backfill buffer; the prefetch task reads nothing ahead
+    const auto bufferSize =
+            engine->getConfiguration().getDcpBackfillByteLimit();
+    producer->setBackfillBufferBytesRead(bufferSize);
+    auto& auxIoQ = *task_executor->getLpTaskQ()[AUXIO_TASK_IDX];
+    runNextTask(auxIoQ, "Prefetching backfill items");
+    EXPECT_EQ(0, bfm.getBytesPrefetched());
+    EXPECT_TRUE(producer->getBackfillBufferFullStatus());
+
+    // Once the buffer is drained the backfill resumes; the drain reads the
+    // items itself as the task is snoozed
+    producer->recordBackfillManagerBytesSent(bufferSize);
+    EXPECT_FALSE(producer->getBackfillBufferFullStatus());
+    EXPECT_EQ(backfill_status_t::backfill_success, bfm.backfill());
+    EXPECT_EQ(numItems, stream->getNumBackfillItems());
+    EXPECT_EQ(0, bfm.getBytesPrefetched());
+    EXPECT_EQ(backfill_status_t::backfill_finished, bfm.backfill());
+}
+
 TEST_P(SingleThreadedPassiveStreamTest, MB42780_DiskToMemoryFromPre65) {
     // Note: We need at least one cursor in the replica checkpoint to hit the
     //  issue. Given that in Ephemeral (a) there is no persistence cursor and
@@ -4427,6 +4559,18 @@ INSTANTIATE_TEST_SUITE_P(AllBucketTypes,
                          STParameterizedBucketTest::allConfigValues(),
                          STParameterizedBucketTest::PrintToStringParamName);
 
+INSTANTIATE_TEST_SUITE_P(
+        Persistent,
+        SingleThreadedBackfillPrefetchTest,
+        STParameterizedBucketTest::persistentAllBackendsConfigValues(),
+        STParameterizedBucketTest::PrintToStringParamName);
+
+INSTANTIATE_TEST_SUITE_P(
+        Persistent,
+        SingleThreadedBackfillPrefetchWindowTest,
+        STParameterizedBucketTest::persistentAllBackendsConfigValues(),
+        STParameterizedBucketTest::PrintToStringParamName);
+
 void STPassiveStreamPersistentTest::SetUp() {
     // Test class is not specific for SyncRepl, but some tests check SR
     // quantities too.
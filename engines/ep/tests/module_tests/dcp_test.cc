@@ -31,9 +31,11 @@
 #include "dcp/active_stream_checkpoint_processor_task.h"
 #include "dcp/dcp-types.h"
 #include "dcp/dcpconnmap.h"
+#include "dcp/flow-control-manager.h"
 #include "dcp/producer.h"
 #include "dcp/response.h"
 #include "dcp/stream.h"
+#include "dcp/value_conversion_cache.h"
 #include "dcp_utils.h"
 #include "ep_time.h"
 #include "evp_engine_test.h"
@@ -796,6 +798,98 @@ TEST_P(CompressionStreamTest, force_value_compression_enabled) {
     EXPECT_EQ(cb::engine_errc::success, destroy_dcp_stream());
 }
 
+/**
+ * Test that streams which need the same compression of an item share one
+ * compressed value, via the DcpValueConversionCache.
+ */
+TEST_P(CompressionStreamTest, force_value_compression_shares_value) {
+    if (isXattr()) {
+        // The body is removed (IncludeValue::No), which isn't cached
+        return;
+    }
+    std::string valueData(
+            "{\"product\": \"car\",\"price\": \"100\"},"
+            "{\"product\": \"bus\",\"price\": \"1000\"},"
+            "{\"product\": \"Train\",\"price\": \"100000\"}");
+
+    auto item = makeCompressibleItem(vbid,
+                                     makeStoredDocKey("key"),
+                                     valueData,
+                                     PROTOCOL_BINARY_DATATYPE_JSON,
+                                     false, // not compressed
+                                     false);
+
+    cookie->setDatatypeSupport(PROTOCOL_BINARY_DATATYPE_SNAPPY);
+    setup_dcp_stream(0,
+                     IncludeValue::Yes,
+                     IncludeXattrs::Yes,
+                     {{"force_value_compression", "true"}});
+    ASSERT_TRUE(stream->isForceValueCompressionEnabled());
+
+    auto& cache = engine->getDcpConnMap().getValueConversionCache();
+    const auto hits = cache.getHits();
+    const auto misses = cache.getMisses();
+
+    queued_item qi(std::move(item));
+    auto first = stream->public_makeResponseFromItem(
+            qi, SendCommitSyncWriteAs::Commit);
+    auto second = stream->public_makeResponseFromItem(
+            qi, SendCommitSyncWriteAs::Commit);
+    const auto& firstItem =
+            dynamic_cast<MutationResponse&>(*first).getItem();
+    const auto& secondItem =
+            dynamic_cast<MutationResponse&>(*second).getItem();
+
+    // Each response has its own Item, but the compressed value is shared
+    ASSERT_NE(firstItem.get(), secondItem.get());
+    EXPECT_TRUE(mcbp::datatype::is_snappy(firstItem->getDataType()));
+    EXPECT_EQ(firstItem->getDataType(), secondItem->getDataType());
+    EXPECT_EQ(firstItem->getValue().get().get(),
+              secondItem->getValue().get().get());
+    EXPECT_EQ(misses + 1, cache.getMisses());
+    EXPECT_EQ(hits + 1, cache.getHits());
+
+    EXPECT_EQ(cb::engine_errc::success, destroy_dcp_stream());
+}
+
+/// The DcpValueConversionCache evicts values to stay within maxBytes
+TEST(DcpValueConversionCacheTest, BoundedByBytes) {
+    const std::string value(1000, 'x');
+    std::vector<queued_item> items;
+    for (int ii = 0; ii < 10; ++ii) {
+        items.push_back(
+                make_STRCPtr<Item>(makeStoredDocKey("key" + std::to_string(ii)),
+                                   0,
+                                   0,
+                                   value.data(),
+                                   value.size()));
+    }
+
+    // Inflating a raw value caches (pins) only the original
+    const auto entrySize = items.front()->getValue()->getSize();
+    DcpValueConversionCache cache(1024, value.size(), 2 * entrySize);
+
+    ASSERT_TRUE(cache.getInflated(*items.front()));
+    EXPECT_EQ(entrySize, cache.getBytes());
+    ASSERT_TRUE(cache.getInflated(*items.front()));
+    EXPECT_EQ(1, cache.getHits());
+    EXPECT_EQ(1, cache.getMisses());
+
+    for (const auto& item : items) {
+        ASSERT_TRUE(cache.getInflated(*item));
+        EXPECT_LE(cache.getBytes(), 2 * entrySize);
+        EXPECT_GE(cache.getBytes(), entrySize);
+    }
+
+    // A value larger than maxBytes isn't cached
+    DcpValueConversionCache small(1024, value.size(), entrySize - 1);
+    ASSERT_TRUE(small.getInflated(*items.front()));
+    ASSERT_TRUE(small.getInflated(*items.front()));
+    EXPECT_EQ(0, small.getBytes());
+    EXPECT_EQ(0, small.getHits());
+    EXPECT_EQ(2, small.getMisses());
+}
+
 TEST_P(CompressionStreamTest,
        NoWithUnderlyingDatatype_CompressionDisabled_ItemCompressed) {
     setup_dcp_stream(
@@ -2820,6 +2914,104 @@ INSTANTIATE_TEST_SUITE_P(FlowControl,
                          FlowControlTest,
                          ::testing::ValuesIn({false, true}));
 
+class AdaptiveFlowControlTest : public KVBucketTest {
+protected:
+    void SetUp() override {
+        // A quota large enough for the buffers to have room to grow within
+        // dcp_conn_buffer_size_aggr_mem_threshold
+        config_string =
+                "dcp_flow_control_policy=adaptive;max_size=1073741824;"
+                "dcp_conn_buffer_size_max=104857600";
+        KVBucketTest::SetUp();
+    }
+};
+
+/**
+ * Test that the adaptive policy grows the buffer of a consumer which drains
+ * it quickly, and leaves alone the buffer of an idle consumer.
+ */
+TEST_F(AdaptiveFlowControlTest, GrowsBufferOfDrainingConsumer) {
+    auto& manager = dynamic_cast<DcpFlowControlManagerAdaptive&>(
+            engine->getDcpFlowControlManager());
+    auto busy = std::make_shared<MockDcpConsumer>(*engine, cookie, "busy");
+    auto* idleCookie = create_mock_cookie(engine.get());
+    auto idle = std::make_shared<MockDcpConsumer>(*engine, idleCookie, "idle");
+
+    const auto initialBusy = busy->getFlowControlBufSize();
+    const auto initialIdle = idle->getFlowControlBufSize();
+    ASSERT_GT(initialBusy, 0);
+    ASSERT_GT(initialIdle, 0);
+
+    // The busy consumer processed twice its buffer with nothing backlogged
+    busy->public_flowControl().incrFreedBytes(initialBusy * 2);
+
+    const auto dt = std::chrono::milliseconds{
+            engine->getConfiguration().getDcpFlowControlAdaptivePidDt()};
+    manager.maybeResizeBuffers(std::chrono::steady_clock::now() + dt * 2);
+
+    EXPECT_GT(busy->getFlowControlBufSize(), initialBusy);
+    EXPECT_LE(busy->getFlowControlBufSize(),
+              engine->getConfiguration().getDcpConnBufferSizeMax());
+    EXPECT_EQ(initialIdle, idle->getFlowControlBufSize());
+
+    idle.reset();
+    destroy_mock_cookie(idleCookie);
+}
+
+/**
+ * Test that new consumers only get the headroom left under
+ * dcp_conn_buffer_size_aggr_mem_threshold once a buffer has grown into it,
+ * and that the existing buffers are shrunk when there isn't room for the
+ * minimum, so the aggregate stays under the threshold.
+ */
+TEST_F(AdaptiveFlowControlTest, NewConsumersStayWithinAggrLimit) {
+    auto& manager = dynamic_cast<DcpFlowControlManagerAdaptive&>(
+            engine->getDcpFlowControlManager());
+    const auto& config = engine->getConfiguration();
+    const size_t limit = config.getDcpConnBufferSizeAggrMemThreshold() *
+                         engine->getEpStats().getMaxDataSize() / 100;
+
+    // Grow the first consumer's buffer as far as it goes
+    auto busy = std::make_shared<MockDcpConsumer>(*engine, cookie, "busy");
+    const auto dt = std::chrono::milliseconds{
+            config.getDcpFlowControlAdaptivePidDt()};
+    auto now = std::chrono::steady_clock::now();
+    for (int ii = 0; ii < 8; ++ii) {
+        busy->public_flowControl().incrFreedBytes(
+                busy->getFlowControlBufSize() * 2);
+        now += dt * 2;
+        manager.maybeResizeBuffers(now);
+    }
+    ASSERT_EQ(config.getDcpConnBufferSizeMax(), busy->getFlowControlBufSize());
+
+    std::vector<std::pair<MockCookie*, std::shared_ptr<MockDcpConsumer>>>
+            consumers;
+    const auto aggrBufferSize = [&busy, &consumers]() {
+        size_t size = busy->getFlowControlBufSize();
+        for (const auto& consumer : consumers) {
+            size += consumer.second->getFlowControlBufSize();
+        }
+        return size;
+    };
+    for (int ii = 0; ii < 6; ++ii) {
+        auto* consumerCookie = create_mock_cookie(engine.get());
+        consumers.emplace_back(
+                consumerCookie,
+                std::make_shared<MockDcpConsumer>(
+                        *engine, consumerCookie, "new" + std::to_string(ii)));
+        EXPECT_GE(consumers.back().second->getFlowControlBufSize(),
+                  config.getDcpConnBufferSize());
+        EXPECT_LE(aggrBufferSize(), limit) << "with " << ii + 2 << " consumers";
+    }
+    // The grown buffer was shrunk to make room
+    EXPECT_LT(busy->getFlowControlBufSize(), config.getDcpConnBufferSizeMax());
+
+    for (auto& consumer : consumers) {
+        consumer.second.reset();
+        destroy_mock_cookie(consumer.first);
+    }
+}
+
 struct PrintToStringCombinedNameXattrOnOff {
     std::string operator()(
             const ::testing::TestParamInfo<::testing::tuple<std::string, bool>>&
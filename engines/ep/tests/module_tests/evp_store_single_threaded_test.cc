@@ -114,6 +114,11 @@ void SingleThreadedKVBucketTest::SetUp() {
     if (config_string.find("checkpoint_removal_mode") == std::string::npos) {
         config_string += ";checkpoint_removal_mode=lazy";
     }
+    // Warmup tests step through the warmup backfill tasks one at a time and
+    // expect one task per shard, rather than one per reader thread.
+    if (config_string.find("warmup_backfill_tasks") == std::string::npos) {
+        config_string += ";warmup_backfill_tasks=1";
+    }
 
     KVBucketTest::SetUp();
 
@@ -151,6 +151,198 @@ TEST_P(EPBucketTest, testRetainErroneousTombstonesConfig) {
     EXPECT_FALSE(store.isRetainErroneousTombstones());
 }
 
+/**
+ * Test that the BgFetcher coalescing window follows the config, and that
+ * fetches queued while it's enabled complete in one run of the BgFetcher.
+ */
+TEST_P(EPBucketTest, BgFetchCoalescingWindow) {
+    Configuration& config = engine->getConfiguration();
+    auto& bgFetcher = getEPBucket().getBgFetcher(vbid);
+
+    // Disabled by default
+    EXPECT_EQ(std::chrono::microseconds::zero(),
+              bgFetcher.getCoalescingWindow());
+
+    std::string msg;
+    ASSERT_EQ(cb::engine_errc::success,
+              engine->setFlushParam(
+                      "bgfetch_coalescing_max_window", "5000", msg));
+    EXPECT_EQ(5000, config.getBgfetchCoalescingMaxWindow());
+    ASSERT_EQ(cb::engine_errc::success,
+              engine->setFlushParam(
+                      "bgfetch_coalescing_batch_size", "2", msg));
+    EXPECT_EQ(2, config.getBgfetchCoalescingBatchSize());
+
+    // No fetch has been timed yet, so there's nothing to base a wait on
+    EXPECT_EQ(std::chrono::microseconds::zero(),
+              bgFetcher.getCoalescingWindow());
+
+    auto key1 = makeStoredDocKey("key1");
+    auto key2 = makeStoredDocKey("key2");
+    auto key3 = makeStoredDocKey("key3");
+    store_item(vbid, key1, "value1");
+    store_item(vbid, key2, "value2");
+    store_item(vbid, key3, "value3");
+    flush_vbucket_to_disk(vbid, 3);
+    evict_key(vbid, key1);
+    evict_key(vbid, key2);
+    evict_key(vbid, key3);
+
+    auto options = get_options_t(QUEUE_BG_FETCH);
+    EXPECT_EQ(cb::engine_errc::would_block,
+              store->get(key1, vbid, cookie, options).getStatus());
+    EXPECT_EQ(cb::engine_errc::would_block,
+              store->get(key2, vbid, cookie, options).getStatus());
+
+    // A full batch is pending, so the fetch doesn't wait
+    EXPECT_EQ(std::chrono::microseconds::zero(),
+              bgFetcher.getCoalescingWindow());
+    auto& stats = engine->getEpStats();
+    auto& batchSizes = stats.getMultiBatchSizeHisto;
+    batchSizes.reset();
+    runBGFetcherTask();
+    EXPECT_EQ(1, batchSizes.getValueCount());
+    EXPECT_EQ(2, batchSizes.getMaxValue());
+
+    EXPECT_EQ(cb::engine_errc::success,
+              store->get(key1, vbid, cookie, options).getStatus());
+    EXPECT_EQ(cb::engine_errc::success,
+              store->get(key2, vbid, cookie, options).getStatus());
+    EXPECT_EQ(0, stats.numRemainingBgItems);
+
+    // Fetch key3 alone, then queue key1 and key2 again once the BgFetcher
+    // has been woken and is in its coalescing window: all three are read in
+    // one more getMulti rather than the first alone
+    evict_key(vbid, key1);
+    evict_key(vbid, key2);
+    ASSERT_EQ(cb::engine_errc::success,
+              engine->setFlushParam(
+                      "bgfetch_coalescing_batch_size", "3", msg));
+    EXPECT_EQ(cb::engine_errc::would_block,
+              store->get(key3, vbid, cookie, options).getStatus());
+    bgFetcher.waitForBatchHook = [this, &key1, &key2, &options]() {
+        EXPECT_EQ(cb::engine_errc::would_block,
+                  store->get(key1, vbid, cookie, options).getStatus());
+        EXPECT_EQ(cb::engine_errc::would_block,
+                  store->get(key2, vbid, cookie, options).getStatus());
+    };
+    runBGFetcherTask();
+
+    EXPECT_EQ(2, batchSizes.getValueCount());
+    EXPECT_EQ(3, batchSizes.getMaxValue());
+    EXPECT_EQ(0, stats.numRemainingBgItems);
+    EXPECT_EQ(cb::engine_errc::success,
+              store->get(key3, vbid, cookie, options).getStatus());
+}
+
+// getMulti tests /////////////////////////////////////////////////////////////
+
+/**
+ * Test that getMulti returns one result per key for a mix of resident,
+ * non-resident and missing keys, and that the non-resident keys are queued
+ * as one batch of background fetches.
+ */
+TEST_P(EPBucketTest, GetMultiResidentNonResidentMissing) {
+    auto resident = makeStoredDocKey("resident");
+    auto nonResident = makeStoredDocKey("nonResident");
+    auto missing = makeStoredDocKey("missing");
+    store_item(vbid, resident, "value1");
+    store_item(vbid, nonResident, "value2");
+    flush_vbucket_to_disk(vbid, 2);
+    evict_key(vbid, nonResident);
+
+    const std::vector<DocKey> keys{resident, nonResident, missing};
+    const auto options = static_cast<get_options_t>(
+            QUEUE_BG_FETCH | HONOR_STATES | TRACK_REFERENCE | DELETE_TEMP |
+            HIDE_LOCKED_CAS | TRACK_STATISTICS);
+    std::vector<GetValue> values;
+    EXPECT_EQ(cb::engine_errc::would_block,
+              store->getMulti(keys, vbid, cookie, options, values));
+    ASSERT_EQ(keys.size(), values.size());
+    ASSERT_EQ(cb::engine_errc::success, values[0].getStatus());
+    EXPECT_EQ("value1", values[0].item->getValue()->to_s());
+    EXPECT_EQ(cb::engine_errc::would_block, values[1].getStatus());
+
+    // A missing key may need a fetch to prove it is missing under full
+    // eviction; every queued fetch is counted individually
+    size_t fetches = 0;
+    for (const auto& gv : values) {
+        if (gv.getStatus() == cb::engine_errc::would_block) {
+            ++fetches;
+        }
+    }
+    if (fullEviction()) {
+        EXPECT_NE(cb::engine_errc::success, values[2].getStatus());
+    } else {
+        EXPECT_EQ(cb::engine_errc::no_such_key, values[2].getStatus());
+    }
+    EXPECT_EQ(fetches, engine->getEpStats().numRemainingBgItems);
+
+    runBGFetcherTask();
+    EXPECT_EQ(0, engine->getEpStats().numRemainingBgItems);
+
+    EXPECT_EQ(cb::engine_errc::success,
+              store->getMulti(keys, vbid, cookie, options, values));
+    ASSERT_EQ(keys.size(), values.size());
+    ASSERT_EQ(cb::engine_errc::success, values[0].getStatus());
+    EXPECT_EQ("value1", values[0].item->getValue()->to_s());
+    ASSERT_EQ(cb::engine_errc::success, values[1].getStatus());
+    EXPECT_EQ("value2", values[1].item->getValue()->to_s());
+    EXPECT_EQ(cb::engine_errc::no_such_key, values[2].getStatus());
+}
+
+// Check an unknown or replica vbucket returns not-my-vbucket with no values.
+TEST_P(EPBucketTest, GetMultiNMVB) {
+    auto key = makeStoredDocKey("key");
+    store_item(vbid, key, "value");
+    const std::vector<DocKey> keys{key};
+    const auto options =
+            static_cast<get_options_t>(QUEUE_BG_FETCH | HONOR_STATES);
+    std::vector<GetValue> values;
+
+    EXPECT_EQ(cb::engine_errc::not_my_vbucket,
+              store->getMulti(
+                      keys, Vbid(vbid.get() + 1), cookie, options, values));
+    EXPECT_TRUE(values.empty());
+
+    store->setVBucketState(vbid, vbucket_state_replica);
+    EXPECT_EQ(cb::engine_errc::not_my_vbucket,
+              store->getMulti(keys, vbid, cookie, options, values));
+    EXPECT_TRUE(values.empty());
+}
+
+// Check a pending vbucket blocks every key of the batch, so the caller has
+// one result per key to retry.
+TEST_P(EPBucketTest, GetMultiPendingVB) {
+    auto key = makeStoredDocKey("key");
+    store_item(vbid, key, "value");
+    store->setVBucketState(vbid, vbucket_state_pending);
+
+    const std::vector<DocKey> keys{key, makeStoredDocKey("missing")};
+    const auto options =
+            static_cast<get_options_t>(QUEUE_BG_FETCH | HONOR_STATES);
+    std::vector<GetValue> values;
+    EXPECT_EQ(cb::engine_errc::would_block,
+              store->getMulti(keys, vbid, cookie, options, values));
+    ASSERT_EQ(keys.size(), values.size());
+    for (const auto& gv : values) {
+        EXPECT_EQ(cb::engine_errc::would_block, gv.getStatus());
+    }
+
+    store->setVBucketState(vbid, vbucket_state_active);
+    values.clear();
+    auto rv = store->getMulti(keys, vbid, cookie, options, values);
+    if (rv == cb::engine_errc::would_block) {
+        // The missing key needed a fetch
+        runBGFetcherTask();
+        rv = store->getMulti(keys, vbid, cookie, options, values);
+    }
+    EXPECT_EQ(cb::engine_errc::success, rv);
+    ASSERT_EQ(keys.size(), values.size());
+    EXPECT_EQ(cb::engine_errc::success, values[0].getStatus());
+    EXPECT_EQ(cb::engine_errc::no_such_key, values[1].getStatus());
+}
+
 // getKeyStats tests //////////////////////////////////////////////////////////
 
 // Check that keystats on ejected items. When ejected should return ewouldblock
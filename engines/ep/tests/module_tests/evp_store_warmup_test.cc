@@ -2874,6 +2874,40 @@ TEST_F(WarmupTest, ConsumerDuringWarmup) {
                               {}));
 }
 
+// With more backfill tasks than shards the vBuckets of all of the shards are
+// shared between the tasks; the first task to run loads the vBuckets of its
+// own shard and then steals those of the other shard.
+TEST_F(WarmupTest, BackfillTasksStealVBuckets) {
+    setVBucketToActiveWithValidTopology();
+    store_item(vbid, makeStoredDocKey("key"), "value");
+    flushVBucketToDiskIfPersistent(vbid, 1);
+    for (const auto id : {Vbid(1), Vbid(2), Vbid(3)}) {
+        setVBucketStateAndRunPersistTask(id, vbucket_state_active);
+        store_item(id, makeStoredDocKey("key"), "value");
+        flushVBucketToDiskIfPersistent(id, 1);
+    }
+
+    // 2 shards, 4 tasks
+    resetEngineAndEnableWarmup("warmup_backfill_tasks=4");
+    auto* warmupPtr = store->getWarmup();
+    auto& readerQueue = *task_executor->getLpTaskQ()[READER_TASK_IDX];
+    while (warmupPtr->getWarmupState() != WarmupState::State::LoadingData) {
+        runNextTask(readerQueue);
+    }
+
+    // One task loads all of the values...
+    runNextTask(readerQueue);
+    EXPECT_EQ(4, engine->getEpStats().warmedUpValues);
+    EXPECT_EQ(WarmupState::State::LoadingData, warmupPtr->getWarmupState());
+
+    // ...and warmup moves on once the other tasks have found nothing left
+    for (int task = 0; task < 3; ++task) {
+        runNextTask(readerQueue);
+    }
+    EXPECT_EQ(WarmupState::State::Done, warmupPtr->getWarmupState());
+    EXPECT_EQ(4, engine->getEpStats().warmedUpValues);
+}
+
 INSTANTIATE_TEST_SUITE_P(FullOrValue,
                          MB_34718_WarmupTest,
                          STParameterizedBucketTest::persistentConfigValues(),
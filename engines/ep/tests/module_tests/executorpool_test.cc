@@ -1937,3 +1937,82 @@ TYPED_TEST(ExecutorPoolEpEngineTest, PoolThreadsAreRegisteredWithPhosphor) {
 
     FAIL();
 }
+
+/// Tests of the work stealing across task groups of FollyExecutorPool.
+class FollyExecutorPoolWorkStealingTest
+    : public ExecutorPoolTest<FollyExecutorPool> {
+protected:
+    void SetUp() override {
+        // One thread of each type, so a single running task keeps a group
+        // busy.
+        makePool(4, 1, 1, 1, 1);
+        pool->registerTaskable(taskable);
+    }
+
+    void TearDown() override {
+        if (!releaseBlocker.ready()) {
+            releaseBlocker.post();
+        }
+        pool->unregisterTaskable(taskable, false);
+    }
+
+    /// Schedule an AuxIO task which occupies the only AuxIO thread until
+    /// releaseBlocker is posted.
+    void blockAuxIOThread() {
+        pool->schedule(std::make_shared<LambdaTask>(
+                taskable, TaskId::AccessScanner, 0, true, [this](LambdaTask&) {
+                    blockerRunning.post();
+                    releaseBlocker.wait();
+                    return false;
+                }));
+        ASSERT_TRUE(blockerRunning.try_wait_for(10s));
+    }
+
+    /// Schedule a second AuxIO task, which posts taskRan when it runs.
+    void scheduleAuxIOTask() {
+        pool->schedule(std::make_shared<LambdaTask>(
+                taskable, TaskId::AccessScanner, 0, true, [this](LambdaTask&) {
+                    taskRan.post();
+                    return false;
+                }));
+    }
+
+    folly::Baton<> blockerRunning;
+    folly::Baton<> releaseBlocker;
+    folly::Baton<> taskRan;
+    ::testing::NiceMock<MockTaskable> taskable;
+};
+
+// Without a quota a task waits for a thread of its own group.
+TEST_F(FollyExecutorPoolWorkStealingTest, DisabledByDefault) {
+    blockAuxIOThread();
+    scheduleAuxIOTask();
+    EXPECT_FALSE(taskRan.try_wait_for(100ms));
+
+    releaseBlocker.post();
+    EXPECT_TRUE(taskRan.try_wait_for(10s));
+    EXPECT_EQ(0, pool->getNumStolenTasks());
+}
+
+// With a quota a task runs on an idle thread of another group while all of
+// the threads of its own group are busy.
+TEST_F(FollyExecutorPoolWorkStealingTest, RunsTaskOnIdleGroup) {
+    pool->setWorkStealingQuota(100);
+    blockAuxIOThread();
+    scheduleAuxIOTask();
+    EXPECT_TRUE(taskRan.try_wait_for(10s));
+    EXPECT_EQ(1, pool->getNumStolenTasks());
+}
+
+// A group doesn't lend more than its quota of threads.
+TEST_F(FollyExecutorPoolWorkStealingTest, QuotaLimitsThreadsLent) {
+    // With a single thread per group, 50% rounds down to no threads.
+    pool->setWorkStealingQuota(50);
+    blockAuxIOThread();
+    scheduleAuxIOTask();
+    EXPECT_FALSE(taskRan.try_wait_for(100ms));
+
+    releaseBlocker.post();
+    EXPECT_TRUE(taskRan.try_wait_for(10s));
+    EXPECT_EQ(0, pool->getNumStolenTasks());
+}
@@ -15,9 +15,13 @@
 #include "tests/module_tests/test_task.h"
 #include <executor/futurequeue.h>
 
+#include <algorithm>
+#include <climits>
+#include <vector>
+
 class FutureQueueTest : public ::testing::TestWithParam<std::string> {
 public:
-    FutureQueue<> queue;
+    FutureQueue queue;
     MockTaskable taskable;
 };
 
@@ -218,3 +222,117 @@ TEST_F(FutureQueueTest, taskNotInQueue) {
     EXPECT_EQ(-1,
               static_cast<TestTask*>(queue.top().get())->order);
 }
+
+/*
+ * Push tasks with wake times spread from the past to the far future (so they
+ * are placed in different levels of the timer wheel), then check they are
+ * popped in wakeTime order.
+ */
+TEST_F(FutureQueueTest, popOrderAcrossLevels) {
+    using namespace std::chrono;
+    const auto now = steady_clock::now();
+    const std::vector<steady_clock::time_point> wakeTimes = {
+            steady_clock::time_point::max(),
+            now + hours(24 * 365),
+            now + seconds(100),
+            now + milliseconds(5),
+            now + nanoseconds(10),
+            now,
+            now - seconds(1),
+            steady_clock::time_point::min(),
+            now + hours(1),
+            now + milliseconds(70),
+            now + nanoseconds(5),
+            now + milliseconds(4097),
+    };
+    for (size_t i = 0; i < wakeTimes.size(); i++) {
+        ExTask task = std::make_shared<TestTask>(
+                taskable, TaskId::PendingOpsNotification, i);
+        task->updateWaketime(wakeTimes[i]);
+        queue.push(task);
+    }
+    queue.assertInvariants();
+
+    auto sorted = wakeTimes;
+    std::sort(sorted.begin(), sorted.end());
+    for (const auto& expected : sorted) {
+        ASSERT_FALSE(queue.empty());
+        EXPECT_EQ(expected, queue.top()->getWaketime());
+        queue.pop();
+        queue.assertInvariants();
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+/*
+ * Tasks with the same tick share a level 0 slot, which must be kept in
+ * wakeTime order - including when a task is moved within its slot.
+ */
+TEST_F(FutureQueueTest, sameTickOrder) {
+    using namespace std::chrono;
+    const steady_clock::time_point base{milliseconds(1000)};
+    const int n = 10;
+    std::vector<ExTask> tasks;
+    for (int i = 0; i < n; i++) {
+        tasks.push_back(std::make_shared<TestTask>(
+                taskable, TaskId::PendingOpsNotification, i));
+        tasks.back()->updateWaketime(base + nanoseconds(1 + (i * 3) % n));
+        queue.push(tasks.back());
+    }
+    queue.assertInvariants();
+    EXPECT_EQ(0, static_cast<TestTask*>(queue.top().get())->order);
+
+    // Move the last task pushed to the front of its slot
+    EXPECT_TRUE(queue.updateWaketime(tasks[n - 1], base));
+    queue.assertInvariants();
+    EXPECT_EQ(n - 1, static_cast<TestTask*>(queue.top().get())->order);
+
+    ExTask lastTask;
+    while (!queue.empty()) {
+        if (lastTask) {
+            EXPECT_LE(lastTask->getWaketime(), queue.top()->getWaketime());
+        }
+        lastTask = queue.top();
+        queue.pop();
+        queue.assertInvariants();
+    }
+}
+
+/*
+ * Wake (updateWaketime to now) and snooze tasks which are in different levels
+ * of the timer wheel, checking the order is maintained.
+ */
+TEST_F(FutureQueueTest, wakeAndSnoozeAcrossLevels) {
+    const int n = 100;
+    std::vector<ExTask> tasks;
+    for (int i = 0; i < n; i++) {
+        tasks.push_back(std::make_shared<TestTask>(
+                taskable, TaskId::PendingOpsNotification, i));
+        // Snooze forever for the odd tasks, and i seconds for the even.
+        queue.snooze(tasks.back(), (i % 2) ? INT_MAX : i);
+        queue.push(tasks.back());
+    }
+    queue.assertInvariants();
+    EXPECT_EQ(0, static_cast<TestTask*>(queue.top().get())->order);
+
+    // Wake a task which was sleeping forever (to just before the top) - it
+    // should become the top.
+    EXPECT_TRUE(queue.updateWaketime(
+            tasks[51], tasks[0]->getWaketime() - std::chrono::nanoseconds(1)));
+    queue.assertInvariants();
+    EXPECT_EQ(51, static_cast<TestTask*>(queue.top().get())->order);
+
+    // Snooze it again, the previous top should return.
+    EXPECT_TRUE(queue.snooze(tasks[51], INT_MAX));
+    queue.assertInvariants();
+    EXPECT_EQ(n, queue.size());
+
+    ExTask lastTask;
+    while (!queue.empty()) {
+        if (lastTask) {
+            EXPECT_LE(lastTask->getWaketime(), queue.top()->getWaketime());
+        }
+        lastTask = queue.top();
+        queue.pop();
+    }
+}
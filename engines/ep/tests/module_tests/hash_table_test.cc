@@ -310,6 +310,270 @@ TEST_F(HashTableTest, AutoResize) {
     verifyFound(h, keys);
 }
 
+// Check that an incremental resize rounds sizes up to a multiple of the
+// number of locks, and that items are found (and migrated) by lookups and
+// visitors while the resize is in progress.
+TEST_F(HashTableTest, IncrementalResize) {
+    HashTable h(global_stats,
+                makeFactory(),
+                5,
+                3,
+                HashTable::Layout::Chained,
+                HashTable::ResizeAlgorithm::Incremental);
+    EXPECT_EQ(6, h.getSize());
+
+    auto keys = generateKeys(1000);
+    storeMany(h, keys);
+
+    h.resize(6144);
+    EXPECT_EQ(6144, h.getSize());
+    EXPECT_TRUE(h.isResizeInProgress());
+    EXPECT_EQ(6, h.getNumResizePendingBuckets());
+    EXPECT_EQ(0, h.getNumResizeMigratedBuckets());
+
+    // Lookups migrate the key's old bucket.
+    verifyFound(h, keys);
+    EXPECT_EQ(6, h.getNumResizeMigratedBuckets());
+    EXPECT_EQ(0, h.getNumResizePendingBuckets());
+    // Still in progress until the old table is released.
+    EXPECT_TRUE(h.isResizeInProgress());
+    EXPECT_FALSE(h.migrateBuckets(1));
+    EXPECT_FALSE(h.isResizeInProgress());
+
+    // Visitors see every item during a resize.
+    h.resize(96);
+    EXPECT_TRUE(h.isResizeInProgress());
+    EXPECT_EQ(1000, count(h));
+    verifyFound(h, keys);
+
+    // Resizing to the size being resized to leaves the resize in progress
+    // (for migrateBuckets() to complete incrementally).
+    h.resize(96);
+    EXPECT_TRUE(h.isResizeInProgress());
+
+    // A resize while one is in progress completes the first.
+    h.resize();
+    EXPECT_EQ(771, h.getSize());
+    verifyFound(h, keys);
+}
+
+TEST_F(HashTableTest, IncrementalResizeMigrateBuckets) {
+    HashTable h(global_stats,
+                makeFactory(),
+                47,
+                47,
+                HashTable::Layout::Chained,
+                HashTable::ResizeAlgorithm::Incremental);
+    auto keys = generateKeys(1000);
+    storeMany(h, keys);
+
+    h.resize(47 * 20);
+    ASSERT_TRUE(h.isResizeInProgress());
+    EXPECT_TRUE(h.migrateBuckets(10));
+    EXPECT_EQ(10, h.getNumResizeMigratedBuckets());
+    EXPECT_EQ(37, h.getNumResizePendingBuckets());
+
+    // Inserts and deletes during the resize.
+    auto moreKeys = generateKeys(1500, 1000);
+    storeMany(h, moreKeys);
+    for (size_t i = 0; i < 500; ++i) {
+        EXPECT_TRUE(del(h, keys[i]));
+    }
+
+    while (h.migrateBuckets(10)) {
+    }
+    EXPECT_FALSE(h.isResizeInProgress());
+    EXPECT_EQ(1000, count(h));
+    verifyFound(h, moreKeys);
+}
+
+// Sizes which are not a multiple of the number of locks fall back to a
+// blocking resize.
+TEST_F(HashTableTest, IncrementalResizeFallback) {
+    HashTable h(global_stats,
+                makeFactory(),
+                6,
+                3,
+                HashTable::Layout::Chained,
+                HashTable::ResizeAlgorithm::Incremental);
+    auto keys = generateKeys(1000);
+    storeMany(h, keys);
+
+    h.resize(6143);
+    EXPECT_EQ(6143, h.getSize());
+    EXPECT_FALSE(h.isResizeInProgress());
+    verifyFound(h, keys);
+}
+
+TEST_F(HashTableTest, IncrementalResizeTagGroups) {
+    HashTable h(global_stats,
+                makeFactory(),
+                6,
+                3,
+                HashTable::Layout::TagGroups,
+                HashTable::ResizeAlgorithm::Incremental);
+    auto keys = generateKeys(1000);
+    storeMany(h, keys);
+
+    h.resize(300);
+    ASSERT_TRUE(h.isResizeInProgress());
+    verifyFound(h, keys);
+    for (const auto& key : keys) {
+        EXPECT_TRUE(del(h, key));
+    }
+    EXPECT_FALSE(h.migrateBuckets(std::numeric_limits<size_t>::max()));
+    EXPECT_EQ(0, count(h));
+}
+
+TEST_F(HashTableTest, ConcurrentAccessIncrementalResize) {
+    HashTable h(global_stats,
+                makeFactory(),
+                5,
+                4,
+                HashTable::Layout::Chained,
+                HashTable::ResizeAlgorithm::Incremental);
+
+    auto keys = generateKeys(2000);
+    h.resize(keys.size());
+    storeMany(h, keys);
+
+    verifyFound(h, keys);
+
+    srand(918475);
+    AccessGenerator gen(keys, h);
+    getCompletedThreads(4, &gen);
+}
+
+// Check find works with TagGroups layout when buckets overflow their tag
+// group (5 buckets, 1000 items) and the chain must be walked.
+TEST_F(HashTableTest, TagGroupsFindOverflowed) {
+    HashTable h(
+            global_stats, makeFactory(), 5, 1, HashTable::Layout::TagGroups);
+    testFind(h);
+}
+
+TEST_F(HashTableTest, TagGroupsForwardDeletions) {
+    size_t initialSize = global_stats.getCurrentSize();
+    HashTable h(
+            global_stats, makeFactory(), 769, 1, HashTable::Layout::TagGroups);
+    const int nkeys = 1000;
+
+    auto keys = generateKeys(nkeys);
+    storeMany(h, keys);
+    EXPECT_EQ(nkeys, count(h));
+    verifyFound(h, keys);
+
+    for (const auto& key : keys) {
+        EXPECT_TRUE(del(h, key));
+        EXPECT_FALSE(h.findForRead(key).storedValue);
+    }
+
+    EXPECT_EQ(0, count(h));
+    EXPECT_EQ(initialSize, global_stats.getCurrentSize());
+}
+
+TEST_F(HashTableTest, TagGroupsResize) {
+    HashTable h(
+            global_stats, makeFactory(), 5, 3, HashTable::Layout::TagGroups);
+
+    auto keys = generateKeys(1000);
+    storeMany(h, keys);
+
+    verifyFound(h, keys);
+
+    h.resize(6143);
+    EXPECT_EQ(6143, h.getSize());
+    verifyFound(h, keys);
+
+    h.resize(97);
+    EXPECT_EQ(97, h.getSize());
+    verifyFound(h, keys);
+}
+
+TEST_F(HashTableTest, TagGroupsAutoResize) {
+    HashTable h(
+            global_stats, makeFactory(), 5, 3, HashTable::Layout::TagGroups);
+
+    auto keys = generateKeys(1000);
+    storeMany(h, keys);
+
+    // Sized for tagGroupLoadFactor items per bucket; 1000 / 4 is nearest
+    // to 193 in the prime table.
+    h.resize();
+    EXPECT_EQ(193, h.getSize());
+    verifyFound(h, keys);
+}
+
+// Check that both a Committed and Pending item for the same key are found
+// via the tag group, and that the group is updated when either is removed.
+TEST_F(HashTableTest, TagGroupsCommittedAndPending) {
+    HashTable h(
+            global_stats, makeFactory(), 47, 1, HashTable::Layout::TagGroups);
+    auto key = makeStoredDocKey("key");
+    store(h, key);
+
+    Item pending(key, 0, 0, "pending", 7);
+    pending.setPendingSyncWrite({});
+    {
+        auto res = h.findForSyncWrite(key);
+        ASSERT_FALSE(res.storedValue);
+        h.unlocked_addNewStoredValue(res.lock, pending);
+    }
+
+    auto* committed = h.findOnlyCommitted(key).storedValue;
+    auto* prepared = h.findOnlyPrepared(key).storedValue;
+    ASSERT_TRUE(committed);
+    ASSERT_TRUE(prepared);
+    EXPECT_NE(committed, prepared);
+    EXPECT_TRUE(prepared->isPending());
+    EXPECT_EQ(committed, h.findForRead(key).storedValue);
+    EXPECT_EQ(prepared, h.findForWrite(key).storedValue);
+
+    {
+        auto res = h.findOnlyPrepared(key);
+        h.unlocked_del(res.lock, res.storedValue);
+    }
+    EXPECT_FALSE(h.findOnlyPrepared(key).storedValue);
+    EXPECT_EQ(committed, h.findForWrite(key).storedValue);
+
+    EXPECT_TRUE(del(h, key));
+    EXPECT_FALSE(h.findForWrite(key).storedValue);
+}
+
+TEST(HashTableTagGroupTest, InsertMatchErase) {
+    HashTableTagGroup group;
+    std::array<StoredValue*, HashTableTagGroup::Slots + 1> svs;
+    for (size_t i = 0; i < svs.size(); ++i) {
+        svs[i] = reinterpret_cast<StoredValue*>(0x1000 + i * 0x10);
+    }
+    const uint8_t tagA = HashTableTagGroup::tagForHash(0x12345678);
+    const uint8_t tagB = HashTableTagGroup::tagForHash(0xfedcba98);
+    ASSERT_NE(tagA, tagB);
+    EXPECT_EQ(0, group.match(tagA));
+
+    group.insert(tagA, svs[0]);
+    group.insert(tagB, svs[1]);
+    auto matchA = group.match(tagA);
+    ASSERT_NE(0, matchA);
+    EXPECT_EQ(svs[0], group.get(folly::findFirstSet(matchA) - 1));
+
+    // Fill all slots; one more insert overflows.
+    for (size_t i = 2; i < HashTableTagGroup::Slots; ++i) {
+        group.insert(tagA, svs[i]);
+    }
+    EXPECT_FALSE(group.isOverflowed());
+    group.insert(tagA, svs[HashTableTagGroup::Slots]);
+    EXPECT_TRUE(group.isOverflowed());
+
+    EXPECT_TRUE(group.erase(tagB, svs[1]));
+    EXPECT_FALSE(group.erase(tagB, svs[1]));
+    EXPECT_TRUE(group.replace(tagA, svs[0], svs[1]));
+
+    group.clear();
+    EXPECT_FALSE(group.isOverflowed());
+    EXPECT_EQ(0, group.match(tagA));
+}
+
 TEST_F(HashTableTest, DepthCounting) {
     HashTable h(global_stats, makeFactory(), 5, 1);
     const int nkeys = 5000;
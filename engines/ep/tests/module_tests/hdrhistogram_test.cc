@@ -325,6 +325,50 @@ TEST(HdrHistogramTest, addValueParallel) {
     EXPECT_EQ(threads.size() * numOfAddIterations * maxVal, count);
 }
 
+// Test that values recorded into a Sharded histogram from multiple threads
+// are all seen by readers, and that reset clears them.
+TEST(HdrHistogramTest, addValueParallelSharded) {
+    unsigned int numOfAddIterations = 5000;
+    unsigned int maxVal = 2;
+    HdrHistogram histogram{1 /*minDiscernible*/,
+                           maxVal /* maxTrackable */,
+                           1 /* sigfigs */,
+                           HdrHistogram::Iterator::IterMode::Recorded,
+                           HdrHistogram::Recording::Sharded};
+
+    std::vector<std::thread> threads(4);
+    boost::barrier bar(threads.size());
+    for (auto& t : threads) {
+        t = std::thread(addValuesThread,
+                        std::ref(histogram),
+                        std::ref(bar),
+                        numOfAddIterations,
+                        maxVal);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    const auto expected = numOfAddIterations * maxVal * threads.size();
+    EXPECT_EQ(expected, histogram.getValueCount());
+    EXPECT_EQ(maxVal - 1, histogram.getMaxValue());
+    EXPECT_EQ(0, histogram.getMinValue());
+
+    // A copy (which records directly) sees the same values.
+    HdrHistogram copy{histogram};
+    EXPECT_EQ(expected, copy.getValueCount());
+    EXPECT_EQ(getValuesOnePerBucket(histogram), getValuesOnePerBucket(copy));
+
+    // Values recorded after a read are seen by the next read.
+    histogram.addValue(1);
+    EXPECT_EQ(expected + 1, histogram.getValueCount());
+
+    histogram.reset();
+    EXPECT_EQ(0, histogram.getValueCount());
+    histogram.addValue(1);
+    EXPECT_EQ(1, histogram.getValueCount());
+}
+
 // Test that when histogram is empty getValueAtPercentile returns 0.
 TEST(HdrHistogramTest, percentileWhenEmptyTest) {
     HdrHistogram histogram{1, 255, 3};
@@ -12,6 +12,7 @@
 #include "item_compressor_test.h"
 #include "item.h"
 #include "item_compressor_visitor.h"
+#include "item_freq_decayer_visitor.h"
 #include "test_helpers.h"
 
 TEST_P(ItemCompressorTest, testCompressionInActiveMode) {
@@ -122,6 +123,44 @@ TEST_P(ItemCompressorTest, testStoreUncompressedInActiveMode) {
     EXPECT_EQ(PROTOCOL_BINARY_DATATYPE_JSON, v->getDatatype());
 }
 
+// Test that the compressor can share a single visit of the HashTable with
+// another visitor (as the HashTableSweeperTask does), and both see each item
+TEST_P(ItemCompressorTest, testCompressionInCompositeVisit) {
+    std::string compressibleValue(
+            "{\"product\": \"car\",\"price\": \"100\"},"
+            "{\"product\": \"bus\",\"price\": \"1000\"},"
+            "{\"product\": \"Train\",\"price\": \"100000\"}");
+
+    auto key = makeStoredDocKey("key");
+    auto item = make_item(vbucket->getId(),
+                          key,
+                          compressibleValue,
+                          0,
+                          PROTOCOL_BINARY_DATATYPE_JSON);
+    ASSERT_EQ(MutationStatus::WasClean, public_processSet(item, 0));
+    findValue(key)->setFreqCounterValue(100);
+
+    ItemCompressorVisitor compressor;
+    compressor.setCompressionMode(BucketCompressionMode::Active);
+    compressor.setMinCompressionRatio(config.getMinCompressionRatio());
+    ItemFreqDecayerVisitor decayer(50);
+
+    auto composite = std::make_unique<CompositeHTVisitor>();
+    composite->addParticipant(compressor);
+    composite->addParticipant(decayer);
+    PauseResumeVBAdapter prAdapter(std::move(composite));
+    EXPECT_TRUE(prAdapter.visit(*vbucket));
+
+    EXPECT_EQ(1, compressor.getVisitedCount());
+    EXPECT_EQ(1, compressor.getCompressedCount());
+    EXPECT_EQ(1, decayer.getVisitedCount());
+
+    StoredValue* v = findValue(key);
+    EXPECT_EQ(PROTOCOL_BINARY_DATATYPE_JSON | PROTOCOL_BINARY_DATATYPE_SNAPPY,
+              v->getDatatype());
+    EXPECT_EQ(50, v->getFreqCounterValue());
+}
+
 INSTANTIATE_TEST_SUITE_P(
         AllVBTypesAllEvictionModes,
         ItemCompressorTest,
@@ -21,9 +21,11 @@
 #include "checkpoint_utils.h"
 #include "ep_bucket.h"
 #include "ep_time.h"
+#include "hash_table_sweeper.h"
 #include "evp_store_single_threaded_test.h"
 #include "item.h"
 #include "item_eviction.h"
+#include "item_pager.h"
 #include "kv_bucket.h"
 #include "kvstore/kvstore.h"
 #include "test_helpers.h"
@@ -1614,6 +1616,50 @@ TEST_P(STExpiryPagerTest, ExpiredItemsDeleted) {
     expiredItemsDeleted();
 }
 
+// Test that when the expiry pager takes part in the sweep of the
+// HashTableSweeperTask (ht_sweeper_enabled), running the pager requests a
+// sweep and the sweep deletes the expired items.
+TEST_P(STExpiryPagerTest, ExpiredItemsDeletedBySweep) {
+    auto key_0 = makeStoredDocKey("key_0");
+    auto key_1 = makeStoredDocKey("key_1");
+    store_item(vbid, key_0, "value");
+    store_item(vbid, key_1, "value", ep_abs_time(ep_current_time() + 10));
+    flushDirectlyIfPersistent(vbid,
+                              {MoreAvailable::No, 2, WakeCkptRemover::No});
+
+    auto& stats = engine->getEpStats();
+    auto pager = std::make_shared<ExpiredItemPager>(
+            engine.get(), stats, 3600, -1, 1);
+    auto sweeper = std::make_shared<HashTableSweeperTask>(engine.get());
+    sweeper->addParticipant(pager);
+    pager->setSweeper(*sweeper);
+    ASSERT_TRUE(pager->enable());
+
+    // Nothing requested a sweep yet
+    const auto pagerRuns = stats.expiryPagerRuns.load();
+    sweeper->run();
+    EXPECT_EQ(pagerRuns, stats.expiryPagerRuns);
+
+    TimeTraveller tt(11);
+    pager->run();
+    EXPECT_EQ(0, pager->getSweepSleepTime());
+    EXPECT_EQ(2, engine->getVBucket(vbid)->getNumItems());
+
+    sweeper->run();
+    EXPECT_EQ(pagerRuns + 1, stats.expiryPagerRuns);
+    EXPECT_EQ(1, stats.expired_pager);
+    // The sweep completed, so the pager doesn't ask for another
+    EXPECT_EQ(std::numeric_limits<int>::max(), pager->getSweepSleepTime());
+
+    flushDirectlyIfPersistent(vbid,
+                              {MoreAvailable::No, 1, WakeCkptRemover::No});
+    EXPECT_EQ(1, engine->getVBucket(vbid)->getNumItems());
+    EXPECT_EQ(cb::engine_errc::success,
+              store->get(key_0, vbid, cookie, QUEUE_BG_FETCH).getStatus());
+
+    pager->disable();
+}
+
 // Test that when an expired system-xattr document is fetched with getMeta
 // it can be successfully expired again
 TEST_P(STExpiryPagerTest, MB_25650) {
@@ -32,6 +32,7 @@ extern "C" {
 }
 
 #include "mutation_log.h"
+#include "sorted_access_log.h"
 #include "tests/module_tests/test_helpers.h"
 
 // Bitfield of available file permissions.
@@ -716,3 +717,94 @@ TEST_F(MutationLogTest, readPreMadHatterAccessLog) {
     auto mlcb = asStdFunction(cb);
     h.apply(&mlcb, mutationLogCB);
 }
+
+TEST_F(MutationLogTest, SortedAccessLog) {
+    {
+        SortedAccessLogWriter writer(tmp_log_filename);
+        writer.newItem(makeStoredDocKey("key2"));
+        writer.newItem(makeStoredDocKey("key10"));
+        writer.newItem(makeStoredDocKey("key1"));
+        writer.newItem(makeStoredDocKey("key2"));
+        writer.finishVBucket(Vbid(3));
+        // No region for a vBucket without keys
+        writer.finishVBucket(Vbid(4));
+        writer.newItem(makeStoredDocKey("other"));
+        writer.finishVBucket(Vbid(7));
+        writer.close();
+        EXPECT_EQ(4, writer.getNumKeys());
+    }
+
+    ASSERT_TRUE(SortedAccessLogReader::isSortedAccessLog(tmp_log_filename));
+    SortedAccessLogReader reader(tmp_log_filename);
+    EXPECT_EQ(4, reader.getNumKeys());
+    ASSERT_EQ(2, reader.getNumVBuckets());
+    EXPECT_EQ(Vbid(3), reader.getVBucket(0));
+    EXPECT_EQ(Vbid(7), reader.getVBucket(1));
+
+    // Each vBucket's keys are sorted, without duplicates
+    std::vector<StoredDocKey> keys;
+    reader.forEachKey(0, [&keys](const StoredDocKey& key) {
+        keys.push_back(key);
+        return true;
+    });
+    EXPECT_EQ(std::vector<StoredDocKey>({makeStoredDocKey("key1"),
+                                         makeStoredDocKey("key10"),
+                                         makeStoredDocKey("key2")}),
+              keys);
+
+    keys.clear();
+    reader.forEachKey(1, [&keys](const StoredDocKey& key) {
+        keys.push_back(key);
+        return false;
+    });
+    EXPECT_EQ(std::vector<StoredDocKey>({makeStoredDocKey("other")}), keys);
+}
+
+TEST_F(MutationLogTest, SortedAccessLogCorrupt) {
+    {
+        SortedAccessLogWriter writer(tmp_log_filename);
+        writer.newItem(makeStoredDocKey("key1"));
+        writer.finishVBucket(Vbid(0));
+        writer.newItem(makeStoredDocKey("key2"));
+        writer.finishVBucket(Vbid(1));
+        writer.close();
+    }
+
+    // Break the first region (which follows the 32 byte header)
+    int file = open(tmp_log_filename.c_str(),
+                    O_RDWR,
+                    FilePerms::Read | FilePerms::Write);
+    EXPECT_EQ(34, lseek(file, 34, SEEK_SET));
+    uint8_t b;
+    EXPECT_EQ(1, read(file, &b, sizeof(b)));
+    EXPECT_EQ(34, lseek(file, 34, SEEK_SET));
+    b = ~b;
+    EXPECT_EQ(1, write(file, &b, sizeof(b)));
+    close(file);
+
+    {
+        // Only the broken region fails
+        SortedAccessLogReader reader(tmp_log_filename);
+        auto cb = [](const StoredDocKey&) { return true; };
+        EXPECT_THROW(reader.forEachKey(0, cb), MutationLog::CRCReadException);
+        EXPECT_NO_THROW(reader.forEachKey(1, cb));
+    }
+
+    // Truncating the file breaks the index
+    EXPECT_EQ(0, truncate(tmp_log_filename.c_str(), 40));
+    EXPECT_THROW(SortedAccessLogReader{tmp_log_filename},
+                 MutationLog::ReadException);
+}
+
+TEST_F(MutationLogTest, SortedAccessLogNotMutationLog) {
+    {
+        MutationLog ml(tmp_log_filename.c_str());
+        ml.open();
+        ml.newItem(Vbid(2), makeStoredDocKey("key1"));
+        ml.commit1();
+        ml.commit2();
+    }
+    EXPECT_FALSE(SortedAccessLogReader::isSortedAccessLog(tmp_log_filename));
+    EXPECT_THROW(SortedAccessLogReader{tmp_log_filename},
+                 MutationLog::ReadException);
+}
@@ -0,0 +1,231 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "evp_store_single_threaded_test.h"
+
+#include "ep_bucket.h"
+#include "ep_engine.h"
+#include "ep_vb.h"
+#include "range_scans/range_scan_owner.h"
+#include "tests/mock/mock_synchronous_ep_engine.h"
+#include "tests/module_tests/test_helpers.h"
+
+#include <gsl/gsl-lite.hpp>
+#include <programs/engine_testapp/mock_cookie.h>
+#include <programs/engine_testapp/mock_server.h>
+
+/**
+ * Tests of RangeScan create, continue and cancel through the KVBucket
+ * interface, running the RangeScan tasks on the single threaded executor.
+ */
+class RangeScanTest : public SingleThreadedEPBucketTest {
+protected:
+    void SetUp() override {
+        SingleThreadedEPBucketTest::SetUp();
+        setVBucketStateAndRunPersistTask(vbid, vbucket_state_active);
+        for (int ii = 0; ii < numKeys; ++ii) {
+            store_item(vbid, makeStoredDocKey("key" + std::to_string(ii)),
+                       "value");
+        }
+        flushVBucketToDiskIfPersistent(vbid, numKeys);
+    }
+
+    /// Queue a create of a key only scan of the default collection
+    cb::engine_errc startCreate() {
+        return store
+                ->createRangeScan(vbid,
+                                  cookie,
+                                  CollectionID::Default,
+                                  {},
+                                  {},
+                                  cb::rangescan::KeyOnly::Yes,
+                                  {})
+                .first;
+    }
+
+    /// Create a key only scan of the default collection
+    cb::rangescan::Id createScan() {
+        EXPECT_EQ(cb::engine_errc::would_block, startCreate());
+        runNextTask(getAuxIOQ(), "RangeScanCreateTask for vb:0");
+        EXPECT_EQ(cb::engine_errc::success, mock_waitfor_cookie(cookie));
+
+        auto [status, id] = store->createRangeScan(vbid,
+                                                   cookie,
+                                                   CollectionID::Default,
+                                                   {},
+                                                   {},
+                                                   cb::rangescan::KeyOnly::Yes,
+                                                   {});
+        EXPECT_EQ(cb::engine_errc::success, status);
+        return id;
+    }
+
+    /// Run one continue of the scan to completion
+    cb::mcbp::Status continueScan(const cb::rangescan::Id& id,
+                                  std::string& data) {
+        auto status = cb::mcbp::Status::Success;
+        const cb::rangescan::ContinueLimits limits;
+        EXPECT_EQ(cb::engine_errc::would_block,
+                  store->continueRangeScan(
+                          vbid, id, cookie, limits, status, data));
+        runNextTask(getAuxIOQ(), "RangeScanContinueTask");
+        EXPECT_EQ(cb::engine_errc::success, mock_waitfor_cookie(cookie));
+        EXPECT_EQ(cb::engine_errc::success,
+                  store->continueRangeScan(
+                          vbid, id, cookie, limits, status, data));
+        return status;
+    }
+
+    TaskQueue& getAuxIOQ() {
+        return *task_executor->getLpTaskQ()[AUXIO_TASK_IDX];
+    }
+
+    VB::RangeScanOwner& getRangeScans() {
+        return static_cast<EPVBucket&>(*store->getVBucket(vbid))
+                .getRangeScans();
+    }
+
+    const int numKeys = 10;
+};
+
+TEST_F(RangeScanTest, CreateContinueComplete) {
+    auto id = createScan();
+    EXPECT_EQ(1, getRangeScans().size());
+
+    std::string data;
+    EXPECT_EQ(cb::mcbp::Status::RangeScanComplete, continueScan(id, data));
+
+    // Every key is returned as a leb128 length and the key
+    int keys = 0;
+    std::string_view remaining = data;
+    while (!remaining.empty()) {
+        const auto length = size_t(uint8_t(remaining.front()));
+        remaining.remove_prefix(1);
+        ASSERT_LE(length, remaining.size());
+        EXPECT_EQ("key", remaining.substr(0, 3));
+        remaining.remove_prefix(length);
+        ++keys;
+    }
+    EXPECT_EQ(numKeys, keys);
+
+    // A complete scan is removed
+    EXPECT_EQ(0, getRangeScans().size());
+    EXPECT_EQ(0, getEPBucket().getNumRangeScans());
+}
+
+TEST_F(RangeScanTest, Cancel) {
+    auto id = createScan();
+    EXPECT_EQ(cb::engine_errc::success, store->cancelRangeScan(vbid, id, cookie));
+    EXPECT_EQ(0, getRangeScans().size());
+    EXPECT_EQ(0, getEPBucket().getNumRangeScans());
+
+    auto status = cb::mcbp::Status::Success;
+    std::string data;
+    EXPECT_EQ(cb::engine_errc::no_such_key,
+              store->continueRangeScan(vbid, id, cookie, {}, status, data));
+    EXPECT_EQ(cb::engine_errc::no_such_key, store->cancelRangeScan(vbid, id, cookie));
+}
+
+// A cancel during a continue completes the continue with RangeScanCancelled
+TEST_F(RangeScanTest, CancelDuringContinue) {
+    auto id = createScan();
+    auto status = cb::mcbp::Status::Success;
+    std::string data;
+    EXPECT_EQ(cb::engine_errc::would_block,
+              store->continueRangeScan(vbid, id, cookie, {}, status, data));
+    EXPECT_EQ(cb::engine_errc::success, store->cancelRangeScan(vbid, id, cookie));
+    EXPECT_EQ(1, getRangeScans().size());
+
+    runNextTask(getAuxIOQ(), "RangeScanContinueTask");
+    EXPECT_EQ(cb::engine_errc::success, mock_waitfor_cookie(cookie));
+    EXPECT_EQ(cb::engine_errc::success,
+              store->continueRangeScan(vbid, id, cookie, {}, status, data));
+    EXPECT_EQ(cb::mcbp::Status::RangeScanCancelled, status);
+    EXPECT_EQ(0, getRangeScans().size());
+}
+
+// A scan is only visible to the connection which created it
+TEST_F(RangeScanTest, OtherConnection) {
+    auto id = createScan();
+    auto* other = create_mock_cookie(engine.get());
+    other->setConnectionId(cookie->getConnectionId() + 1);
+
+    auto status = cb::mcbp::Status::Success;
+    std::string data;
+    EXPECT_EQ(cb::engine_errc::no_such_key,
+              store->continueRangeScan(vbid, id, other, {}, status, data));
+    EXPECT_EQ(cb::engine_errc::no_such_key,
+              store->cancelRangeScan(vbid, id, other));
+    EXPECT_EQ(1, getRangeScans().size());
+    destroy_mock_cookie(other);
+}
+
+TEST_F(RangeScanTest, CancelOnStateChange) {
+    auto id = createScan();
+    setVBucketStateAndRunPersistTask(vbid, vbucket_state_replica);
+    EXPECT_EQ(0, getRangeScans().size());
+    EXPECT_EQ(0, getEPBucket().getNumRangeScans());
+
+    auto status = cb::mcbp::Status::Success;
+    std::string data;
+    EXPECT_EQ(cb::engine_errc::no_such_key,
+              store->continueRangeScan(vbid, id, cookie, {}, status, data));
+}
+
+TEST_F(RangeScanTest, CancelOnDelete) {
+    createScan();
+    ASSERT_EQ(1, getEPBucket().getNumRangeScans());
+    EXPECT_EQ(cb::engine_errc::success, store->deleteVBucket(vbid, nullptr));
+    EXPECT_EQ(0, getEPBucket().getNumRangeScans());
+}
+
+// A vBucket which stops being active while the scan is created gets no scan
+TEST_F(RangeScanTest, StateChangeDuringCreate) {
+    EXPECT_EQ(cb::engine_errc::would_block, startCreate());
+    setVBucketStateAndRunPersistTask(vbid, vbucket_state_replica);
+    runNextTask(getAuxIOQ(), "RangeScanCreateTask for vb:0");
+    EXPECT_EQ(cb::engine_errc::not_my_vbucket, mock_waitfor_cookie(cookie));
+    EXPECT_EQ(0, getRangeScans().size());
+    EXPECT_EQ(0, getEPBucket().getNumRangeScans());
+}
+
+TEST_F(RangeScanTest, CancelOnDisconnect) {
+    createScan();
+    ASSERT_EQ(1, getRangeScans().size());
+    engine->handleDisconnect(cookie);
+    EXPECT_EQ(0, getRangeScans().size());
+}
+
+TEST_F(RangeScanTest, CancelIdle) {
+    auto id = createScan();
+    const auto timeout = gsl::narrow<int>(
+            engine->getConfiguration().getRangeScanIdleTimeout());
+    EXPECT_EQ(0, getEPBucket().cancelIdleRangeScans());
+
+    // A continue restarts the idle time
+    TimeTraveller marty(timeout);
+    std::string data;
+    auto status = cb::mcbp::Status::Success;
+    const cb::rangescan::ContinueLimits limits{1};
+    EXPECT_EQ(cb::engine_errc::would_block,
+              store->continueRangeScan(vbid, id, cookie, limits, status, data));
+    runNextTask(getAuxIOQ(), "RangeScanContinueTask");
+    EXPECT_EQ(cb::engine_errc::success, mock_waitfor_cookie(cookie));
+    EXPECT_EQ(cb::engine_errc::success,
+              store->continueRangeScan(vbid, id, cookie, limits, status, data));
+    EXPECT_EQ(cb::mcbp::Status::RangeScanMore, status);
+
+    TimeTraveller doc(timeout / 2);
+    EXPECT_EQ(0, getEPBucket().cancelIdleRangeScans());
+    TimeTraveller jennifer(timeout);
+    EXPECT_EQ(1, getEPBucket().cancelIdleRangeScans());
+    EXPECT_EQ(0, getRangeScans().size());
+}
@@ -495,3 +495,123 @@ TYPED_TEST(StoredValueProtectedTest, MB_32835) {
 
     EXPECT_EQ(*this->sv, *sv2);
 }
+
+/**
+ * Test fixture for StoredValues created by InlineValueStoredValueFactory.
+ */
+class InlineValueStoredValueTest : public ::testing::Test {
+public:
+    InlineValueStoredValueTest()
+        : factory(stats, /*maxInlineValueSize*/ 16),
+          item(make_item(Vbid(0), makeStoredDocKey("key"), "value")) {
+    }
+
+    void SetUp() override {
+        sv = factory(item, {});
+        ASSERT_TRUE(sv->hasInlineValue());
+        ASSERT_TRUE(sv->isValueInline());
+    }
+
+    static std::string getValue(const StoredValue& sv) {
+        return sv.getValue()->to_s();
+    }
+
+protected:
+    EPStats stats;
+    InlineValueStoredValueFactory factory;
+    Item item;
+    StoredValue::UniquePtr sv;
+};
+
+TEST_F(InlineValueStoredValueTest, Sizes) {
+    EXPECT_NE(item.getValue().get().get(), sv->getValue().get().get())
+            << "Inline value should be a copy of the Item's value";
+    EXPECT_EQ("value", getValue(*sv));
+    EXPECT_EQ(5, sv->valuelen());
+    EXPECT_EQ(StoredValue::getRequiredStorageWithInlineValue(item.getKey(), 5),
+              sv->getObjectSize() + Blob::getAllocationSize(5));
+    EXPECT_EQ(sv->getObjectSize() + 5, sv->size());
+}
+
+// The inline value region is accounted once - by the embedded Blob - and
+// not also as part of the StoredValue.
+TEST_F(InlineValueStoredValueTest, ReservedSize) {
+    const auto reserved = sv->getInlineValueReservedSize();
+    EXPECT_EQ(Blob::getAllocationSize(5), reserved);
+    EXPECT_EQ(reserved, sv->getValue()->getEmbeddedReservedSize());
+    EXPECT_EQ(StoredValue::getRequiredStorageWithInlineValue(item.getKey(), 5),
+              sv->getObjectSize() + reserved);
+
+    // A smaller value reuses the region; the reservation is unchanged.
+    sv->setValue(make_item(Vbid(0), makeStoredDocKey("key"), "abc"));
+    ASSERT_TRUE(sv->isValueInline());
+    EXPECT_EQ(reserved, sv->getInlineValueReservedSize());
+    EXPECT_EQ(reserved, sv->getValue()->getEmbeddedReservedSize());
+    EXPECT_LT(sv->getValue()->getSize(), reserved);
+}
+
+TEST_F(InlineValueStoredValueTest, LargeValueIsNotInline) {
+    auto large = factory(make_item(Vbid(0),
+                                   makeStoredDocKey("key"),
+                                   std::string(17, 'x')),
+                         {});
+    EXPECT_FALSE(large->hasInlineValue());
+    EXPECT_EQ(StoredValue::getRequiredStorage(item.getKey()),
+              large->getObjectSize());
+}
+
+// Growing the value moves it out-of-line; a later value which fits is stored
+// inline again.
+TEST_F(InlineValueStoredValueTest, Growth) {
+    sv->setFreqCounterValue(100);
+    auto grown = make_item(
+            Vbid(0), makeStoredDocKey("key"), std::string(32, 'x'));
+    sv->setValue(grown);
+    EXPECT_FALSE(sv->isValueInline());
+    EXPECT_EQ(grown.getValue().get().get(), sv->getValue().get().get());
+    EXPECT_EQ(100, sv->getFreqCounterValue());
+
+    sv->setValue(make_item(Vbid(0), makeStoredDocKey("key"), "small"));
+    EXPECT_TRUE(sv->isValueInline());
+    EXPECT_EQ("small", getValue(*sv));
+    EXPECT_EQ(100, sv->getFreqCounterValue());
+}
+
+// Ejecting the value leaves the region unused; restoring a value puts it
+// back inline.
+TEST_F(InlineValueStoredValueTest, EjectAndRestore) {
+    sv->ejectValue();
+    EXPECT_FALSE(sv->getValue());
+    EXPECT_FALSE(sv->isValueInline());
+
+    sv->restoreValue(item);
+    EXPECT_TRUE(sv->isResident());
+    EXPECT_TRUE(sv->isValueInline());
+    EXPECT_EQ("value", getValue(*sv));
+}
+
+// An Item created from the StoredValue shares the inline value; it must not
+// be overwritten by a subsequent update, and must outlive the StoredValue.
+TEST_F(InlineValueStoredValueTest, ItemSharesInlineValue) {
+    auto copy = sv->toItem(Vbid(0));
+    EXPECT_EQ(sv->getValue().get().get(), copy->getValue().get().get());
+
+    sv->setValue(make_item(Vbid(0), makeStoredDocKey("key"), "other"));
+    EXPECT_FALSE(sv->isValueInline())
+            << "Inline value region is still referenced by the Item";
+    EXPECT_EQ("other", getValue(*sv));
+    EXPECT_EQ("value", copy->getValue()->to_s());
+
+    sv.reset();
+    EXPECT_EQ("value", copy->getValue()->to_s());
+}
+
+TEST_F(InlineValueStoredValueTest, CopyStoredValue) {
+    sv->setFreqCounterValue(100);
+    auto copy = factory.copyStoredValue(*sv, {});
+    EXPECT_TRUE(copy->isValueInline());
+    EXPECT_NE(sv->getValue().get().get(), copy->getValue().get().get());
+    EXPECT_EQ(*sv, *copy);
+    EXPECT_EQ("value", getValue(*copy));
+    EXPECT_EQ(100, copy->getFreqCounterValue());
+}
@@ -0,0 +1,132 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#include "durability/tracked_writes_container.h"
+
+#include <folly/portability/GTest.h>
+
+#include <string>
+#include <vector>
+
+/// Element type which (like ActiveSyncWrite) is not move-assignable.
+struct Element {
+    explicit Element(int seqno) : seqno(seqno), value(std::to_string(seqno)) {
+    }
+    const int seqno;
+    std::string value;
+};
+
+class TrackedWritesContainerTest : public ::testing::Test {
+protected:
+    void fill(int first, int last) {
+        for (int seqno = first; seqno <= last; ++seqno) {
+            c.emplace_back(seqno);
+        }
+    }
+
+    std::vector<int> contents() const {
+        std::vector<int> ret;
+        for (const auto& e : c) {
+            ret.push_back(e.seqno);
+        }
+        return ret;
+    }
+
+    TrackedWritesContainer<Element> c;
+};
+
+TEST_F(TrackedWritesContainerTest, Empty) {
+    EXPECT_TRUE(c.empty());
+    EXPECT_EQ(0, c.size());
+    EXPECT_EQ(c.begin(), c.end());
+}
+
+TEST_F(TrackedWritesContainerTest, EmplaceBack) {
+    fill(1, 3);
+    EXPECT_EQ(3, c.size());
+    EXPECT_EQ(1, c.front().seqno);
+    EXPECT_EQ(3, c.back().seqno);
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), contents());
+    EXPECT_EQ(3, std::prev(c.end())->seqno);
+}
+
+// Iterators (including end()) must remain valid as elements are appended and
+// the buffer grows.
+TEST_F(TrackedWritesContainerTest, IteratorsStableAcrossGrowth) {
+    const auto end = c.end();
+    fill(1, 10);
+    EXPECT_EQ(end, c.end());
+
+    auto it = std::next(c.begin(), 4);
+    ASSERT_EQ(5, it->seqno);
+    fill(11, 10000);
+    EXPECT_EQ(5, it->seqno);
+    EXPECT_EQ(6, std::next(it)->seqno);
+    EXPECT_EQ(10000, c.size());
+}
+
+// Erasing from the middle leaves other iterators valid and iteration skips
+// the erased element in both directions.
+TEST_F(TrackedWritesContainerTest, EraseMiddle) {
+    fill(1, 5);
+    auto second = std::next(c.begin());
+    auto fourth = std::next(second, 2);
+
+    auto next = c.erase(std::next(second));
+    EXPECT_EQ(fourth, next);
+    EXPECT_EQ(second, std::prev(fourth));
+    EXPECT_EQ((std::vector<int>{1, 2, 4, 5}), contents());
+    EXPECT_EQ(4, c.size());
+
+    // Erase the ends; the remaining elements are unaffected.
+    c.erase(c.begin());
+    EXPECT_EQ(c.end(), c.erase(std::prev(c.end())));
+    EXPECT_EQ((std::vector<int>{2, 4}), contents());
+    EXPECT_EQ(2, c.front().seqno);
+    EXPECT_EQ(4, c.back().seqno);
+    EXPECT_EQ(2, second->seqno);
+    EXPECT_EQ(4, fourth->seqno);
+}
+
+TEST_F(TrackedWritesContainerTest, EraseAll) {
+    fill(1, 2000);
+    while (!c.empty()) {
+        c.erase(c.begin());
+    }
+    EXPECT_EQ(c.begin(), c.end());
+
+    // Usable after being emptied.
+    fill(1, 2);
+    EXPECT_EQ((std::vector<int>{1, 2}), contents());
+}
+
+TEST_F(TrackedWritesContainerTest, Prepend) {
+    fill(3, 4);
+    auto it = c.begin();
+
+    TrackedWritesContainer<Element> other;
+    other.emplace_back(1);
+    other.emplace_back(2);
+    c.prepend(std::move(other));
+
+    EXPECT_TRUE(other.empty());
+    EXPECT_EQ((std::vector<int>{1, 2, 3, 4}), contents());
+    EXPECT_EQ(3, it->seqno);
+    EXPECT_EQ(2, std::prev(it)->seqno);
+}
+
+TEST_F(TrackedWritesContainerTest, ConstIterator) {
+    fill(1, 2);
+    TrackedWritesContainer<Element>::const_iterator cit = c.begin();
+    EXPECT_EQ(cit, c.begin());
+    EXPECT_EQ(c.begin(), cit);
+    const auto& constC = c;
+    EXPECT_EQ(c.end(), constC.end());
+}
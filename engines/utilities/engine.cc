@@ -27,3 +27,33 @@ cb::EngineErrorGetScopeIDResult EngineIface::get_scope_id(
         std::optional<Vbid> vbid) const {
     return cb::EngineErrorGetScopeIDResult(cb::engine_errc::not_supported);
 }
+
+cb::engine_errc EngineIface::get_multi(
+        const CookieIface& cookie,
+        const std::vector<DocKey>& keys,
+        Vbid vbucket,
+        DocStateFilter documentStateFilter,
+        std::vector<cb::EngineErrorItemPair>& results) {
+    results.clear();
+    results.reserve(keys.size());
+    auto ret = cb::engine_errc::success;
+    for (const auto& key : keys) {
+        if (ret == cb::engine_errc::would_block) {
+            results.emplace_back(cb::makeEngineErrorItemPair(ret));
+            continue;
+        }
+        results.emplace_back(get(cookie, key, vbucket, documentStateFilter));
+        switch (results.back().first) {
+        case cb::engine_errc::would_block:
+            ret = cb::engine_errc::would_block;
+            break;
+        case cb::engine_errc::not_my_vbucket:
+        case cb::engine_errc::no_bucket:
+        case cb::engine_errc::disconnect:
+            return results.back().first;
+        default:
+            break;
+        }
+    }
+    return ret;
+}
@@ -95,5 +95,5 @@ private:
             readyQueue;
 
     // sorted by waketime. Guarded by `mutex`.
-    FutureQueue<> futureQueue;
+    FutureQueue futureQueue;
 };
@@ -29,15 +29,20 @@ void ExecutorPool::create(Backend backend,
                           ThreadPoolConfig::ThreadCount maxReaders,
                           ThreadPoolConfig::ThreadCount maxWriters,
                           size_t maxAuxIO,
-                          size_t maxNonIO) {
+                          size_t maxNonIO,
+                          bool numaAffinity) {
     if (getInstance()) {
         throw std::logic_error("ExecutorPool::create() Pool already created");
     }
 
     switch (backend) {
     case Backend::Folly:
-        getInstance() = std::make_unique<FollyExecutorPool>(
-                maxThreads, maxReaders, maxWriters, maxAuxIO, maxNonIO);
+        getInstance() = std::make_unique<FollyExecutorPool>(maxThreads,
+                                                            maxReaders,
+                                                            maxWriters,
+                                                            maxAuxIO,
+                                                            maxNonIO,
+                                                            numaAffinity);
         return;
     case Backend::CB3:
         getInstance() = std::make_unique<CB3ExecutorPool>(
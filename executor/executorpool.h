@@ -39,6 +39,12 @@ public:
         Default = Folly
     };
 
+    /**
+     * Create the singleton instance of ExecutorPool.
+     *
+     * @param numaAffinity Spread the pool threads across the NUMA nodes,
+     *        pinning each thread to the CPUs of one node (Folly backend only)
+     */
     static void create(Backend backend = Backend::Default,
                        size_t maxThreads = 0,
                        ThreadPoolConfig::ThreadCount maxReaders =
@@ -46,7 +52,8 @@ public:
                        ThreadPoolConfig::ThreadCount maxWriters =
                                ThreadPoolConfig::ThreadCount::Default,
                        size_t maxAuxIO = 0,
-                       size_t maxNonIO = 0);
+                       size_t maxNonIO = 0,
+                       bool numaAffinity = false);
 
     /// Is the ExecutorPool created or not
     static bool exists();
@@ -95,6 +102,16 @@ public:
     /// Set the number of Non-IO threads to the specified number.
     virtual void setNumNonIO(uint16_t v) = 0;
 
+    /**
+     * Set the percentage of each task group's threads which may run ready
+     * tasks of other task groups, when the group's own threads are idle and
+     * the other group's are all busy. 0 (the default) keeps each task group
+     * on its own threads.
+     * Only supported by the Folly backend; ignored by the others.
+     */
+    virtual void setWorkStealingQuota(size_t percent) {
+    }
+
     /// @returns the number of threads currently sleeping.
     virtual size_t getNumSleepers() = 0;
 
@@ -20,10 +20,15 @@
 #include <logger/logger.h>
 #include <nlohmann/json.hpp>
 #include <phosphor/phosphor.h>
+#include <platform/strerror.h>
 #include <platform/string_hex.h>
 #include <statistics/cbstat_collector.h>
 #include <statistics/collector.h>
 
+#if HAVE_LIBNUMA
+#include <numa.h>
+#endif
+
 using namespace std::string_literals;
 
 /**
@@ -73,6 +78,41 @@ public:
     folly::PriorityThreadFactory priorityThreadFactory;
 };
 
+#if HAVE_LIBNUMA
+/**
+ * Thread factory wrapper.
+ *
+ * Wraps another thread factory, and pins each created thread to the CPUs of
+ * a NUMA node - cycling through the nodes so the threads of the pool are
+ * spread evenly across them.
+ */
+class CBNumaThreadFactory : public folly::ThreadFactory {
+public:
+    CBNumaThreadFactory(std::shared_ptr<folly::ThreadFactory> threadFactory)
+        : threadFactory(std::move(threadFactory)) {
+    }
+    std::thread newThread(folly::Func&& func) override {
+        const int node = nextNode++ % (numa_max_node() + 1);
+        return threadFactory->newThread(
+                [func = std::move(func), node]() mutable {
+                    if (numa_run_on_node(node) != 0) {
+                        LOG_WARNING(
+                                "CBNumaThreadFactory: Failed to pin thread "
+                                "'{}' to NUMA node {}: {}",
+                                folly::getCurrentThreadName().value_or(""),
+                                node,
+                                cb_strerror());
+                    }
+                    func();
+                });
+    }
+
+private:
+    std::shared_ptr<folly::ThreadFactory> threadFactory;
+    std::atomic<int> nextNode{0};
+};
+#endif
+
 /**
  * Proxy object recorded for each registered (scheduled) Task. Inherits from
  * HHWheelTimer::Callback so we can use this as the Callback object for
@@ -87,6 +127,7 @@ struct FollyExecutorPool::TaskProxy : public folly::HHWheelTimer::Callback {
               ExTask task_)
         : task(std::move(task_)),
           taskId(task->getId()),
+          taskType(GlobalTask::getTaskType(task->getTaskId())),
           executor(executor),
           cpuPool(pool) {
     }
@@ -151,9 +192,14 @@ struct FollyExecutorPool::TaskProxy : public folly::HHWheelTimer::Callback {
         Expects(!scheduledOnCpuPool);
         scheduledOnCpuPool = true;
 
-        // Perform work on the appropriate CPU pool.
-        cpuPool.add([&proxy = *this] {
+        // Perform work on the appropriate CPU pool - normally the pool of the
+        // task's own group, unless the task is lent to another group.
+        const auto group = executor.selectGroupToRun(taskType);
+        auto& pool = (group == taskType) ? cpuPool
+                                         : *executor.getPoolForTaskType(group);
+        pool.add([&proxy = *this, group] {
             Expects(proxy.task.get());
+            proxy.executor.taskStarted(group);
 
             LOG_TRACE("FollyExecutorPool: Run task \"{}\" id {}",
                       proxy.task->getDescription(),
@@ -204,6 +250,8 @@ struct FollyExecutorPool::TaskProxy : public folly::HHWheelTimer::Callback {
                 proxy.task->cancel();
             }
 
+            proxy.executor.taskFinished(proxy.taskType, group);
+
             // Re-schedule this task. All logic needs to be
             // performed in EventBase so scheduling
             // checks are serialised, to avoid lost wakeup /
@@ -318,6 +366,10 @@ struct FollyExecutorPool::TaskProxy : public folly::HHWheelTimer::Callback {
     // entry from taskOwners, and need the taskId for that.
     const size_t taskId;
 
+    // Type of the task (i.e. the task group it belongs to). A copy of data
+    // within `task` for the same reason as taskId.
+    const task_type_t taskType;
+
     // Flag used to block re-scheduling of a task while it's in the process
     // of running on CPU pool. See comments in timeoutExpired().
     bool scheduledOnCpuPool{false};
@@ -667,7 +719,8 @@ FollyExecutorPool::FollyExecutorPool(size_t maxThreads,
                                      ThreadPoolConfig::ThreadCount maxReaders_,
                                      ThreadPoolConfig::ThreadCount maxWriters_,
                                      size_t maxAuxIO_,
-                                     size_t maxNonIO_)
+                                     size_t maxNonIO_,
+                                     bool numaAffinity)
     : ExecutorPool(maxThreads),
       state(std::make_unique<State>()),
       maxReaders(calcNumReaders(maxReaders_)),
@@ -676,17 +729,33 @@ FollyExecutorPool::FollyExecutorPool(size_t maxThreads,
       maxNonIO(calcNumNonIO(maxNonIO_)) {
     LOG_TRACE(
             "FollyExecutorPool ctor: Creating with maxThreads:{} maxReaders:{} "
-            "maxWriters:{} maxAuxIO:{} maxNonIO:{}",
+            "maxWriters:{} maxAuxIO:{} maxNonIO:{} numaAffinity:{}",
             maxThreads,
             maxReaders,
             maxWriters,
             maxAuxIO,
-            maxNonIO);
+            maxNonIO,
+            numaAffinity);
 
     // Disable dynamic thread creation / destruction to match CB3ExecutorPool
     // behaviour. At least AtomicQueue cannot be used when this is set to true.
     FLAGS_dynamic_cputhreadpoolexecutor = false;
 
+#if HAVE_LIBNUMA
+    if (numaAffinity && numa_available() != 0) {
+        LOG_WARNING_RAW(
+                "FollyExecutorPool: NUMA not available - not pinning threads "
+                "to NUMA nodes");
+        numaAffinity = false;
+    }
+#else
+    if (numaAffinity) {
+        LOG_WARNING_RAW(
+                "FollyExecutorPool: Built without libnuma - not pinning "
+                "threads to NUMA nodes");
+    }
+#endif
+
     /*
      * Define a function to create thread factory with a given prefix,
      * and priority where supported.
@@ -697,16 +766,24 @@ FollyExecutorPool::FollyExecutorPool(size_t maxThreads,
      *  - On macOS setpriority(PRIO_PROCESS) affects the entire process (unlike
      *    Linux where it's only the current thread), hence calling
      *    setpriority() would be pointless.
+     *
+     * If requested (and libnuma is available) the threads are also pinned
+     * to NUMA nodes.
      */
-    auto makeThreadFactory = [](std::string prefix, task_type_t taskType) {
-        return std::make_shared<CBRegisteredThreadFactory>(
+    auto makeThreadFactory = [&](std::string prefix, task_type_t taskType) {
+        std::shared_ptr<folly::ThreadFactory> factory =
 #if defined(__linux__)
                 std::make_shared<CBPriorityThreadFactory>(
-                        prefix, ExecutorPool::getThreadPriority(taskType))
+                        prefix, ExecutorPool::getThreadPriority(taskType));
 #else
-                std::make_shared<folly::NamedThreadFactory>(prefix)
+                std::make_shared<folly::NamedThreadFactory>(prefix);
 #endif
-        );
+#if HAVE_LIBNUMA
+        if (numaAffinity) {
+            factory = std::make_shared<CBNumaThreadFactory>(std::move(factory));
+        }
+#endif
+        return std::make_shared<CBRegisteredThreadFactory>(std::move(factory));
     };
 
     futurePool = std::make_unique<folly::IOThreadPoolExecutor>(
@@ -720,6 +797,11 @@ FollyExecutorPool::FollyExecutorPool(size_t maxThreads,
             maxAuxIO, makeThreadFactory("AuxIoPool", AUXIO_TASK_IDX));
     nonIoPool = std::make_unique<folly::CPUThreadPoolExecutor>(
             maxNonIO, makeThreadFactory("NonIoPool", NONIO_TASK_IDX));
+
+    groupLoad[READER_TASK_IDX].threads = maxReaders;
+    groupLoad[WRITER_TASK_IDX].threads = maxWriters;
+    groupLoad[AUXIO_TASK_IDX].threads = maxAuxIO;
+    groupLoad[NONIO_TASK_IDX].threads = maxNonIO;
 }
 
 FollyExecutorPool::~FollyExecutorPool() {
@@ -763,21 +845,29 @@ size_t FollyExecutorPool::getNumNonIO() {
 void FollyExecutorPool::setNumReaders(ThreadPoolConfig::ThreadCount v) {
     maxReaders = calcNumReaders(v);
     readerPool->setNumThreads(maxReaders);
+    groupLoad[READER_TASK_IDX].threads = maxReaders;
 }
 
 void FollyExecutorPool::setNumWriters(ThreadPoolConfig::ThreadCount v) {
     maxWriters = calcNumWriters(v);
     writerPool->setNumThreads(maxWriters);
+    groupLoad[WRITER_TASK_IDX].threads = maxWriters;
 }
 
 void FollyExecutorPool::setNumAuxIO(uint16_t v) {
     maxAuxIO = v;
     auxPool->setNumThreads(maxAuxIO);
+    groupLoad[AUXIO_TASK_IDX].threads = maxAuxIO;
 }
 
 void FollyExecutorPool::setNumNonIO(uint16_t v) {
     maxNonIO = v;
     nonIoPool->setNumThreads(maxNonIO);
+    groupLoad[NONIO_TASK_IDX].threads = maxNonIO;
+}
+
+void FollyExecutorPool::setWorkStealingQuota(size_t percent) {
+    workStealingQuota = std::min(percent, size_t(100));
 }
 
 size_t FollyExecutorPool::getNumSleepers() {
@@ -1115,6 +1205,50 @@ folly::CPUThreadPoolExecutor* FollyExecutorPool::getPoolForTaskType(
     folly::assume_unreachable();
 }
 
+task_type_t FollyExecutorPool::selectGroupToRun(task_type_t type) {
+    auto idleThreads = [this](task_type_t group) {
+        const auto& load = groupLoad[group];
+        return load.threads - load.queued - load.running;
+    };
+
+    auto selected = type;
+    const auto quota = workStealingQuota.load();
+    if (quota && idleThreads(type) <= 0) {
+        // All of the group's own threads are busy - lend the task to the
+        // group with the most idle threads which hasn't yet lent out its
+        // quota of threads.
+        int mostIdle = 0;
+        for (int ii = 0; ii < NUM_TASK_GROUPS; ++ii) {
+            const auto group = task_type_t(ii);
+            const auto& load = groupLoad[group];
+            const int limit = int(load.threads * quota / 100);
+            if (group != type && load.lent < limit &&
+                idleThreads(group) > mostIdle) {
+                mostIdle = idleThreads(group);
+                selected = group;
+            }
+        }
+        if (selected != type) {
+            groupLoad[selected].lent++;
+            numStolenTasks++;
+        }
+    }
+    groupLoad[selected].queued++;
+    return selected;
+}
+
+void FollyExecutorPool::taskStarted(task_type_t group) {
+    groupLoad[group].queued--;
+    groupLoad[group].running++;
+}
+
+void FollyExecutorPool::taskFinished(task_type_t type, task_type_t group) {
+    groupLoad[group].running--;
+    if (group != type) {
+        groupLoad[group].lent--;
+    }
+}
+
 void FollyExecutorPool::rescheduleTaskAfterRun(TaskProxy& proxy) {
     // Should only be called from within EventBase thread.
     auto* eventBase = futurePool->getEventBase();
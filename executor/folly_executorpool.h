@@ -13,6 +13,8 @@
 #include "executorpool.h"
 #include "task_type.h"
 
+#include <array>
+#include <atomic>
 #include <memory>
 
 namespace folly {
@@ -122,6 +124,17 @@ on IO thread>>
  *    design - if the single IO thread / context switches are a bottleneck we
  *    can revisit down the line.
  *
+ * 5. Work stealing across task groups (see setWorkStealingQuota): each task
+ *    group has its own fixed size pool, so by default an idle Writer thread
+ *    cannot help with a backlog of AuxIO tasks. When a quota is set, a task
+ *    which becomes ready while every thread of its own pool is busy is
+ *    instead enqueued on the pool of another task group which has an idle
+ *    thread, as long as that group hasn't already lent out its quota of
+ *    threads. Within a task group the threads already share one queue.
+ *    The decision is made on the IO thread when the task is enqueued, from
+ *    per-group counts of queued and running tasks maintained by the CPU
+ *    threads.
+ *
  * [1] https://github.com/facebook/folly/blob/master/folly/io/async/README.md
  */
 class FollyExecutorPool : public ExecutorPool {
@@ -137,12 +150,15 @@ public:
      * @param maxWriters Number of Writer threads to create.
      * @param maxAuxIO Number of AuxIO threads to create (0 = auto-configure).
      * @param maxNonIO Number of NonIO threads to create (0 = auto-configure).
+     * @param numaAffinity Pin the threads of each pool round-robin to the
+     *                     CPUs of each NUMA node (Linux with libnuma only).
      */
     FollyExecutorPool(size_t maxThreads,
                       ThreadPoolConfig::ThreadCount maxReaders,
                       ThreadPoolConfig::ThreadCount maxWriters,
                       size_t maxAuxIO,
-                      size_t maxNonIO);
+                      size_t maxNonIO,
+                      bool numaAffinity = false);
 
     ~FollyExecutorPool() override;
 
@@ -155,6 +171,7 @@ public:
     void setNumWriters(ThreadPoolConfig::ThreadCount v) override;
     void setNumAuxIO(uint16_t v) override;
     void setNumNonIO(uint16_t v) override;
+    void setWorkStealingQuota(size_t percent) override;
     size_t getNumSleepers() override;
     size_t getNumReadyTasks() override;
 
@@ -178,10 +195,33 @@ public:
                      const CookieIface* cookie,
                      const AddStatFn& add_stat) override;
 
+    /// @returns the number of tasks which have been lent to the pool of
+    /// another task group to run (see setWorkStealingQuota).
+    uint64_t getNumStolenTasks() const {
+        return numStolenTasks;
+    }
+
 private:
     /// @returns the CPU pool to use for the given task type.
     folly::CPUThreadPoolExecutor* getPoolForTaskType(task_type_t type);
 
+    /**
+     * Select the task group whose pool should run a ready task of the given
+     * type - the task's own group unless it can be lent to another group
+     * (see setWorkStealingQuota). Accounts the task as queued on the
+     * selected group.
+     * Should only be called from within the EventBase thread.
+     */
+    task_type_t selectGroupToRun(task_type_t type);
+
+    /// Record that a task queued on the given group's pool has started to
+    /// run.
+    void taskStarted(task_type_t group);
+
+    /// Record that a task of type `type` has finished running on the pool of
+    /// the given group.
+    void taskFinished(task_type_t type, task_type_t group);
+
     /// Reschedule the given task based on it's current sleepTime and if
     /// the task is dead (or should run again).
     void rescheduleTaskAfterRun(TaskProxy& proxy);
@@ -211,6 +251,25 @@ private:
     size_t maxAuxIO;
     size_t maxNonIO;
 
+    /// Load of the pool of a task group, used to decide if the group can run
+    /// tasks of other groups.
+    struct GroupLoad {
+        /// Number of threads in the pool
+        std::atomic<int> threads{0};
+        /// Number of tasks queued on the pool, not yet started
+        std::atomic<int> queued{0};
+        /// Number of tasks running on the pool
+        std::atomic<int> running{0};
+        /// Number of tasks of other groups queued or running on the pool
+        std::atomic<int> lent{0};
+    };
+    std::array<GroupLoad, NUM_TASK_GROUPS> groupLoad;
+
+    /// Percentage of each group's threads which may run other groups' tasks
+    std::atomic<size_t> workStealingQuota{0};
+
+    std::atomic<uint64_t> numStolenTasks{0};
+
     /// Grant friendship to TaskProxy as it needs to be able to re-schedule
     /// itself using the futurePool.
     friend TaskProxy;
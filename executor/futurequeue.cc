@@ -0,0 +1,239 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2016-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+#include "futurequeue.h"
+
+#include <folly/lang/Bits.h>
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+void FutureQueue::push(ExTask task) {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    if (freeNodes.empty()) {
+        freeNodes.emplace_back();
+    }
+    auto it = freeNodes.begin();
+    it->task = std::move(task);
+    index.emplace(it->task->getId(), it);
+    place(freeNodes, it, toTick(it->task->getWaketime()));
+    ++count;
+}
+
+void FutureQueue::pop() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    if (!count) {
+        return;
+    }
+    auto it = findTop();
+    auto range = index.equal_range(it->task->getId());
+    for (auto entry = range.first; entry != range.second; ++entry) {
+        if (entry->second == it) {
+            index.erase(entry);
+            break;
+        }
+    }
+    it->task.reset();
+    const int level = it->level;
+    const int slot = it->slot;
+    freeNodes.splice(freeNodes.end(), wheel[level][slot], it);
+    updateOccupied(level, slot);
+    --count;
+}
+
+ExTask FutureQueue::top() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    if (!count) {
+        return {};
+    }
+    return findTop()->task;
+}
+
+size_t FutureQueue::size() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return count;
+}
+
+bool FutureQueue::empty() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return count == 0;
+}
+
+bool FutureQueue::updateWaketime(
+        const ExTask& task, std::chrono::steady_clock::time_point newTime) {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    task->updateWaketime(newTime);
+    return reposition(task);
+}
+
+bool FutureQueue::snooze(const ExTask& task, const double secs) {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    task->snooze(secs);
+    return reposition(task);
+}
+
+void FutureQueue::assertInvariants() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    auto fail = [this](const std::string& reason) {
+        std::string msg = "FutureQueue::assertInvariants() - " + reason +
+                          ". cursor:" + std::to_string(cursor) +
+                          "\nAll items:\n";
+        for (int level = 0; level < NumLevels; ++level) {
+            for (int slot = 0; slot < NumSlots; ++slot) {
+                for (const auto& node : wheel[level][slot]) {
+                    msg += "\t task:" + node.task->getDescription() +
+                           " wake:" +
+                           std::to_string(
+                                   to_ns_since_epoch(node.task->getWaketime())
+                                           .count()) +
+                           " tick:" + std::to_string(node.tick) +
+                           " level:" + std::to_string(level) +
+                           " slot:" + std::to_string(slot) + "\n";
+                }
+            }
+        }
+        throw std::logic_error(msg);
+    };
+
+    size_t nodes = 0;
+    for (int level = 0; level < NumLevels; ++level) {
+        for (int slot = 0; slot < NumSlots; ++slot) {
+            const auto& list = wheel[level][slot];
+            const bool isOccupied = occupied[level] & (uint64_t(1) << slot);
+            if (isOccupied == list.empty()) {
+                fail("occupied bitmap is wrong for level:" +
+                     std::to_string(level) + " slot:" + std::to_string(slot));
+            }
+            if (level == 0 &&
+                !std::is_sorted(
+                        list.begin(),
+                        list.end(),
+                        [](const Node& a, const Node& b) {
+                            return a.task->getWaketime() <
+                                   b.task->getWaketime();
+                        })) {
+                fail("slot:" + std::to_string(slot) +
+                     " of level 0 isn't in wakeTime order");
+            }
+            for (const auto& node : list) {
+                const auto diff = node.tick ^ cursor;
+                const int expectedLevel =
+                        diff ? (folly::findLastSet(diff) - 1) / SlotBits : 0;
+                const int expectedSlot =
+                        (node.tick >> (expectedLevel * SlotBits)) &
+                        (NumSlots - 1);
+                if (node.tick < cursor || node.level != level ||
+                    node.slot != slot || expectedLevel != level ||
+                    expectedSlot != slot) {
+                    fail("task:" + node.task->getDescription() +
+                         " is in the wrong slot");
+                }
+                ++nodes;
+            }
+        }
+    }
+    if (nodes != count || index.size() != count) {
+        fail("count:" + std::to_string(count) +
+             " doesn't match nodes:" + std::to_string(nodes) +
+             " index:" + std::to_string(index.size()));
+    }
+}
+
+uint64_t FutureQueue::toTick(std::chrono::steady_clock::time_point time) {
+    const auto ns = to_ns_since_epoch(time).count();
+    if (ns <= 0) {
+        return 0;
+    }
+    const auto tickNs = std::chrono::nanoseconds(TickDuration).count();
+    return std::min(uint64_t(ns) / tickNs, MaxTick);
+}
+
+void FutureQueue::place(NodeList& from, NodeList::iterator it, uint64_t tick) {
+    // A task which is already due goes at the cursor.
+    tick = std::max(tick, cursor);
+    const auto diff = tick ^ cursor;
+    const int level = diff ? (folly::findLastSet(diff) - 1) / SlotBits : 0;
+    const int slot = (tick >> (level * SlotBits)) & (NumSlots - 1);
+
+    auto& to = wheel[level][slot];
+    auto pos = to.end();
+    if (level == 0) {
+        // Keep level 0 slots in wakeTime order. A task is usually placed
+        // after the tasks already there, so search from the back (skipping
+        // the node itself if it's being moved within the slot).
+        const auto wakeTime = it->task->getWaketime();
+        while (pos != to.begin()) {
+            const auto prev = std::prev(pos);
+            if (prev != it && !(wakeTime < prev->task->getWaketime())) {
+                break;
+            }
+            pos = prev;
+        }
+    }
+    to.splice(pos, from, it);
+    it->tick = tick;
+    it->level = level;
+    it->slot = slot;
+    occupied[level] |= uint64_t(1) << slot;
+}
+
+void FutureQueue::updateOccupied(int level, int slot) {
+    if (wheel[level][slot].empty()) {
+        occupied[level] &= ~(uint64_t(1) << slot);
+    }
+}
+
+void FutureQueue::cascade(int level) {
+    // All the tasks of the lower levels have gone, so the first occupied slot
+    // of this level holds the soonest tasks. Advance the cursor to the start
+    // of that slot, and spread its tasks over the lower levels.
+    const int slot = folly::findFirstSet(occupied[level]) - 1;
+    const int shift = level * SlotBits;
+    cursor = ((cursor >> (shift + SlotBits)) << (shift + SlotBits)) |
+             (uint64_t(slot) << shift);
+
+    auto& list = wheel[level][slot];
+    occupied[level] &= ~(uint64_t(1) << slot);
+    while (!list.empty()) {
+        place(list, list.begin(), list.front().tick);
+    }
+}
+
+FutureQueue::NodeList::iterator FutureQueue::findTop() {
+    // Cascade until the soonest tasks are in level 0.
+    while (!occupied[0]) {
+        int level = 1;
+        while (!occupied[level]) {
+            ++level;
+        }
+        cascade(level);
+    }
+
+    return wheel[0][folly::findFirstSet(occupied[0]) - 1].begin();
+}
+
+bool FutureQueue::reposition(const ExTask& task) {
+    auto range = index.equal_range(task->getId());
+    if (range.first == range.second) {
+        return false;
+    }
+    const auto tick = toTick(task->getWaketime());
+    for (auto entry = range.first; entry != range.second; ++entry) {
+        auto it = entry->second;
+        const int level = it->level;
+        const int slot = it->slot;
+        place(wheel[level][slot], it, tick);
+        updateOccupied(level, slot);
+    }
+    return true;
+}
@@ -16,141 +16,133 @@
  *
  * FutureQueue provides methods that allow a task's wakeTime to be mutated
  * whilst maintaining the priority ordering.
+ *
+ * The queue is a hierarchical timer wheel, so that push(), snooze() and
+ * updateWaketime() (i.e. a wake) are O(1) rather than O(log n) / O(n) for a
+ * heap - there can be thousands of sleeping tasks (for example one per DCP
+ * stream), which are woken from front-end threads:
+ *
+ *  - Wake times are bucketed into ticks of TickDuration. There are NumLevels
+ *    levels of NumSlots slots; a slot of level L covers NumSlots^L ticks.
+ *  - A task is placed in the level of the most significant (SlotBits wide)
+ *    digit where its tick differs from `cursor`, in the slot of that digit
+ *    of its tick. Tasks which are already due are placed at the cursor.
+ *  - top() looks for the first occupied slot of the lowest occupied level.
+ *    If that isn't level 0, the slot is cascaded: the cursor is advanced to
+ *    the start of the slot and its tasks are placed again, in lower levels.
+ *    A task is cascaded at most NumLevels times, so top() and pop() are
+ *    amortised O(1).
+ *  - All the tasks of a level 0 slot have the same tick; the slot is kept in
+ *    wakeTime order as tasks are placed in it (usually at the back), so the
+ *    ordering is exact and the top is the front of the first slot.
+ *
+ * Each task is located through a map of task id to its node in the wheel,
+ * so snooze() and updateWaketime() move the node without searching for it.
  */
 
 #pragma once
 
-#include <algorithm>
+#include "globaltask.h"
+
+#include <array>
 #include <chrono>
+#include <cstdint>
+#include <list>
 #include <mutex>
-#include <queue>
-
-#include "globaltask.h"
+#include <unordered_map>
 
-template <class C = std::deque<ExTask>, class Compare = CompareByDueDate>
 class FutureQueue {
 public:
-    void push(ExTask task) {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        queue.push(task);
-    }
-
-    void pop() {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        queue.pop();
-    }
-
-    ExTask top() {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        return queue.top();
-    }
-
-    size_t size() {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        return queue.size();
-    }
-
-    bool empty() {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        return queue.empty();
-    }
+    void push(ExTask task);
+
+    void pop();
+
+    /// @returns the task with the soonest wakeTime, or an empty ExTask if the
+    ///          queue is empty.
+    ExTask top();
+
+    size_t size();
+
+    bool empty();
 
     /*
-     * Update the wakeTime of task and ensure the heap property is
-     * maintained.
+     * Update the wakeTime of task and move it to its new position in the
+     * queue.
      * @returns true if 'task' is in the FutureQueue.
      */
     bool updateWaketime(const ExTask& task,
-                        std::chrono::steady_clock::time_point newTime) {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        task->updateWaketime(newTime);
-        // After modifiying the task's wakeTime, rebuild the heap
-        return queue.heapify(task);
-    }
+                        std::chrono::steady_clock::time_point newTime);
 
     /*
-     * snooze the task (by altering its wakeTime) and ensure the
-     * heap property is maintained.
+     * snooze the task (by altering its wakeTime) and move it to its new
+     * position in the queue.
      * @returns true if 'task' is in the FutureQueue.
      */
-    bool snooze(const ExTask& task, const double secs) {
-        std::lock_guard<std::mutex> lock(queueMutex);
-        task->snooze(secs);
-        // After modifiying the task's wakeTime, rebuild the heap
-        return queue.heapify(task);
-    }
+    bool snooze(const ExTask& task, const double secs);
 
     /**
      * Checks that the invariants of the future queue are valid.
      * If not then throws std::logic_error.
      */
-    void assertInvariants() {
-        return queue.verifyHeapProperty();
-    }
+    void assertInvariants();
+
+    /// Duration of one tick of the timer wheel
+    static constexpr std::chrono::milliseconds TickDuration{1};
 
 protected:
-    /*
-     * HeapifiableQueue exposes a method to maintain the heap ordering
-     * of the underlying queue.
-     *
-     * This class is deliberately hidden inside FutureQueue so that any
-     * extensions made to priority_queue can't be accessed without work.
-     * I.e. correct locking and any need to 'heapify'.
-     */
-    class HeapifiableQueue : public std::priority_queue<ExTask, C, Compare> {
-    public:
-        /*
-         * Ensure the heap property is maintained
-         * @returns true if 'task' is in the queue and heapify() did something.
-         */
-        bool heapify(const ExTask& task) {
-            // if the task exists, rebuild
-            if (exists(task)) {
-                if (this->c.back()->getId() == task->getId()) {
-                    std::push_heap(this->c.begin(), this->c.end(), this->comp);
-                } else {
-                    std::make_heap(this->c.begin(), this->c.end(), this->comp);
-                }
-                return true;
-            } else {
-                return false;
-            }
-        }
-
-        void verifyHeapProperty() {
-            auto heap_end = std::is_heap_until(
-                    this->c.begin(), this->c.end(), this->comp);
-            if (heap_end != this->c.end()) {
-                std::string msg;
-                msg += "FutureQueue::verifyHeapProperty() - heap invariant "
-                       "broken. First non-heap is task:" +
-                       (*heap_end)->getDescription() + " wake:" +
-                       std::to_string(
-                               to_ns_since_epoch((*heap_end)->getWaketime())
-                                       .count()) +
-                       "\nAll items:\n";
-
-                for (auto& task : this->c) {
-                    msg += "\t task:" + task->getDescription() + " wake:" +
-                           std::to_string(to_ns_since_epoch(task->getWaketime())
-                                                  .count()) +
-                           "\n";
-                }
-                throw std::logic_error(msg);
-            }
-        }
-
-    protected:
-        bool exists(const ExTask& task) {
-            return std::find_if(this->c.begin(),
-                                this->c.end(),
-                                [&task](const ExTask& qTask) {
-                                    return task->getId() == qTask->getId();
-                                }) != this->c.end();
-        }
-
-    } queue;
-
-    // All access to queue must be done with the queueMutex
+    static constexpr int SlotBits = 6;
+    static constexpr int NumSlots = 1 << SlotBits;
+    /// Enough levels for every tick of a steady_clock::time_point
+    static constexpr int NumLevels = 8;
+    static constexpr uint64_t MaxTick =
+            (uint64_t(1) << (NumLevels * SlotBits)) - 1;
+
+    struct Node {
+        ExTask task;
+        /// The tick the node was placed at
+        uint64_t tick{0};
+        uint8_t level{0};
+        uint8_t slot{0};
+    };
+    using NodeList = std::list<Node>;
+
+    static uint64_t toTick(std::chrono::steady_clock::time_point time);
+
+    /// Move the node `it` from the list `from` to the slot for the given
+    /// tick.
+    void place(NodeList& from, NodeList::iterator it, uint64_t tick);
+
+    /// Clear the occupied bit of a slot if it is empty.
+    void updateOccupied(int level, int slot);
+
+    /// Cascade the first occupied slot of the given level to lower levels.
+    void cascade(int level);
+
+    /// @returns the node of the soonest task. The queue must not be empty.
+    NodeList::iterator findTop();
+
+    /// @returns true if 'task' is in the queue, moving it to its position
+    ///          for its current wakeTime.
+    bool reposition(const ExTask& task);
+
+    std::array<std::array<NodeList, NumSlots>, NumLevels> wheel;
+
+    /// Bitmap of the non-empty slots of each level
+    std::array<uint64_t, NumLevels> occupied{};
+
+    /// The tick which the levels are relative to; never after the tick of
+    /// any task in the queue
+    uint64_t cursor{0};
+
+    /// Nodes not in the wheel, reused by push()
+    NodeList freeNodes;
+
+    /// Map of task id to its node(s) - the same task may be pushed more than
+    /// once.
+    std::unordered_multimap<size_t, NodeList::iterator> index;
+
+    size_t count{0};
+
+    // All access to the wheel must be done with the queueMutex
     std::mutex queueMutex;
 };
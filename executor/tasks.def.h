@@ -59,6 +59,9 @@ TASK(VBucketMemoryAndDiskDeletionTask, AUXIO_TASK_IDX, 0)
 TASK(AccessScanner, AUXIO_TASK_IDX, 2)
 TASK(AccessScannerVisitor, AUXIO_TASK_IDX, 2)
 TASK(BackfillManagerTask, AUXIO_TASK_IDX, 4)
+TASK(BackfillPrefetchTask, AUXIO_TASK_IDX, 4)
+TASK(RangeScanCreateTask, AUXIO_TASK_IDX, 4)
+TASK(RangeScanContinueTask, AUXIO_TASK_IDX, 4)
 TASK(Core_SettingsReloadTask, AUXIO_TASK_IDX, 0)
 
 // Read/Write IO tasks
@@ -94,6 +97,8 @@ TASK(ItemCompressorTask, NONIO_TASK_IDX, 7)
 TASK(EphTombstoneHTCleaner, NONIO_TASK_IDX, 7)
 TASK(EphTombstoneStaleItemDeleter, NONIO_TASK_IDX, 7)
 TASK(ItemFreqDecayerTask, NONIO_TASK_IDX, 7)
+TASK(RangeScanTimeoutTask, NONIO_TASK_IDX, 7)
+TASK(HashTableSweeperTask, NONIO_TASK_IDX, 7)
 TASK(ConnManager, NONIO_TASK_IDX, 8)
 TASK(WorkLoadMonitor, NONIO_TASK_IDX, 10)
 TASK(HashtableResizerTask, NONIO_TASK_IDX, 211)
@@ -106,4 +111,5 @@ TASK(Core_PushClustermapTask, NONIO_TASK_IDX, 10)
 TASK(Core_SaslStartTask, NONIO_TASK_IDX, 10)
 TASK(Core_SaslStepTask, NONIO_TASK_IDX, 10)
 TASK(Core_Ifconfig, NONIO_TASK_IDX, 10)
+TASK(Core_InflateItemTask, NONIO_TASK_IDX, 10)
 TASK(Core_TenantPurger, NONIO_TASK_IDX, 50)
@@ -141,6 +141,13 @@ enum class ClientOpcode : uint8_t {
     StartPersistence = 0x81,
     SetParam = 0x82,
     GetReplica = 0x83,
+    /**
+     * Retrieve a batch of documents (possibly spread over multiple
+     * vbuckets) in a single command. The keys are encoded in the value
+     * (see cb::mcbp::request::GetMultiKeySpec) and the documents are
+     * returned in a single response.
+     */
+    GetMulti = 0x84,
 
     /* Bucket engine */
     CreateBucket = 0x85,
@@ -303,6 +310,16 @@ enum class ClientOpcode : uint8_t {
     // Subdoc additions for Cheshire-Cat
     SubdocReplaceBodyWithXattr = 0xd3,
 
+    /**
+     * Range scans over the by-key index of a collection. Create returns
+     * the identifier of the scan which is used to fetch batches of keys
+     * (or documents) with Continue until the range is exhausted, or to
+     * Cancel the scan.
+     */
+    RangeScanCreate = 0xda,
+    RangeScanContinue = 0xdb,
+    RangeScanCancel = 0xdc,
+
     /* Scrub the data */
     Scrub = 0xf0,
     /* Refresh the ISASL data */
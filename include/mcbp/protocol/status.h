@@ -161,6 +161,18 @@ enum class Status : uint16_t {
     /// The SyncWrite is being re-committed after a change in active node.
     SyncWriteReCommitInProgress = 0xa4,
 
+    /// The range scan was cancelled while a continue was in progress.
+    RangeScanCancelled = 0xa5,
+
+    /**
+     * The range scan continue returned a batch of data and there's more
+     * data in the range (the client should issue another continue).
+     */
+    RangeScanMore = 0xa6,
+
+    /// The range scan continue returned the last batch of data in the range.
+    RangeScanComplete = 0xa7,
+
     /*
      * Sub-document specific responses.
      */
@@ -23,6 +23,7 @@
 #include <string_view>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 namespace cb {
 struct EngineErrorGetCollectionIDResult;
@@ -332,6 +333,36 @@ struct MEMCACHED_PUBLIC_CLASS EngineIface {
                                         Vbid vbucket,
                                         DocStateFilter documentStateFilter) = 0;
 
+    /**
+     * Retrieve a batch of items which all live in the same vbucket.
+     *
+     * The result for keys[i] is stored in results[i]. Keys the engine needs
+     * to block for (e.g. to fetch them from disk) get the status
+     * cb::engine_errc::would_block and the method returns
+     * cb::engine_errc::would_block. The engine notifies the cookie once
+     * (and only once) when all of them may be retried, and the caller
+     * should then retry the blocked keys only. Any other return value
+     * than success or would_block applies to the entire batch (for
+     * instance not_my_vbucket) and results should be ignored.
+     *
+     * The default implementation calls get() for each key, and stops at
+     * the first key which would block (all remaining keys get would_block).
+     *
+     * @param cookie The cookie provided by the frontend
+     * @param keys the keys to look up
+     * @param vbucket the virtual bucket id all of the keys belong to
+     * @param documentStateFilter The documents to return must be in any of
+     *                            these states (see get())
+     * @param results output vector receiving one entry per key
+     * @return cb::engine_errc::success if all keys were resolved
+     */
+    virtual cb::engine_errc get_multi(
+            const CookieIface& cookie,
+            const std::vector<DocKey>& keys,
+            Vbid vbucket,
+            DocStateFilter documentStateFilter,
+            std::vector<cb::EngineErrorItemPair>& results);
+
     /**
      * Optionally retrieve an item. Only non-deleted items may be fetched
      * through this interface (Documents in deleted state may be evicted
@@ -17,6 +17,7 @@
 #ifndef WIN32
 #include <arpa/inet.h>
 #endif
+#include <array>
 #include <cstdint>
 #include <stdexcept>
 #include <string>
@@ -2242,5 +2243,208 @@ public:
 protected:
     CollectionIDType collectionId{0};
 };
+
+/**
+ * The value of a get_multi opcode 0x84 is a sequence of GetMultiKeySpec
+ * entries, each directly followed by keylen bytes of the document key
+ * (which carries the collection-id prefix if the connection negotiated
+ * collections). Data stored in network byte order.
+ */
+class GetMultiKeySpec {
+public:
+    GetMultiKeySpec() = default;
+    GetMultiKeySpec(Vbid vbucket, uint16_t keylen)
+        : vbucket(vbucket.hton()), keylen(htons(keylen)) {
+    }
+
+    Vbid getVBucket() const {
+        return vbucket.ntoh();
+    }
+
+    uint16_t getKeylen() const {
+        return ntohs(keylen);
+    }
+
+    std::string_view getBuffer() const {
+        return {reinterpret_cast<const char*>(this), sizeof(*this)};
+    }
+
+protected:
+    Vbid vbucket{0};
+    uint16_t keylen{0};
+};
+static_assert(sizeof(GetMultiKeySpec) == 4, "Unexpected struct size");
+
+/// The identifier of a range scan (a UUID)
+using RangeScanId = std::array<uint8_t, 16>;
+
+/**
+ * The extras of a range_scan_continue opcode 0xdb (and range_scan_cancel
+ * 0xdc which only carries the id). The id is the value returned by
+ * range_scan_create. A limit of 0 means no limit (the engine may still cap
+ * the number of bytes returned). Data stored in network byte order.
+ */
+class RangeScanContinuePayload {
+public:
+    RangeScanContinuePayload() = default;
+    RangeScanContinuePayload(const RangeScanId& id,
+                             uint32_t itemLimit,
+                             uint32_t timeLimit,
+                             uint32_t byteLimit)
+        : id(id),
+          itemLimit(htonl(itemLimit)),
+          timeLimit(htonl(timeLimit)),
+          byteLimit(htonl(byteLimit)) {
+    }
+
+    const RangeScanId& getId() const {
+        return id;
+    }
+
+    /// The maximum number of keys (or documents) to return
+    uint32_t getItemLimit() const {
+        return ntohl(itemLimit);
+    }
+
+    /// The maximum time (in milliseconds) to spend reading the batch
+    uint32_t getTimeLimit() const {
+        return ntohl(timeLimit);
+    }
+
+    /// The maximum number of bytes to return
+    uint32_t getByteLimit() const {
+        return ntohl(byteLimit);
+    }
+
+    std::string_view getBuffer() const {
+        return {reinterpret_cast<const char*>(this), sizeof(*this)};
+    }
+
+protected:
+    RangeScanId id{};
+    uint32_t itemLimit{0};
+    uint32_t timeLimit{0};
+    uint32_t byteLimit{0};
+};
+static_assert(sizeof(RangeScanContinuePayload) == 28,
+              "Unexpected struct size");
 #pragma pack()
 } // namespace cb::mcbp::request
+
+namespace cb::mcbp::response {
+#pragma pack(1)
+
+/**
+ * The value of a successful get_multi response contains one
+ * GetMultiEntryHeader per requested key (in the order the keys were
+ * requested), each directly followed by valuelen bytes of value. Data
+ * stored in network byte order (flags is stored in network byte order in
+ * the item and copied as is, like the extras of a Get response).
+ */
+class GetMultiEntryHeader {
+public:
+    GetMultiEntryHeader() = default;
+    GetMultiEntryHeader(Status status,
+                        uint8_t datatype,
+                        uint32_t flags,
+                        uint64_t cas,
+                        uint32_t valuelen)
+        : status(htons(uint16_t(status))),
+          datatype(datatype),
+          flags(flags),
+          valuelen(htonl(valuelen)),
+          cas(htonll(cas)) {
+    }
+
+    Status getStatus() const {
+        return Status(ntohs(status));
+    }
+
+    uint8_t getDatatype() const {
+        return datatype;
+    }
+
+    uint32_t getFlags() const {
+        return flags;
+    }
+
+    uint32_t getValuelen() const {
+        return ntohl(valuelen);
+    }
+
+    uint64_t getCas() const {
+        return ntohll(cas);
+    }
+
+    std::string_view getBuffer() const {
+        return {reinterpret_cast<const char*>(this), sizeof(*this)};
+    }
+
+protected:
+    uint16_t status{0};
+    uint8_t datatype{0};
+    uint8_t reserved{0};
+    uint32_t flags{0};
+    uint32_t valuelen{0};
+    uint64_t cas{0};
+};
+static_assert(sizeof(GetMultiEntryHeader) == 20, "Unexpected struct size");
+
+/**
+ * The value of a range_scan_continue response for a scan which returns
+ * documents (not just keys) is a sequence of documents, each encoded as a
+ * RangeScanDocumentMeta followed by the leb128 encoded key length, the key
+ * (without the collection prefix), the leb128 encoded value length and the
+ * value. A scan which returns keys only encodes each key as the leb128
+ * encoded key length followed by the key. Data stored in network byte order
+ * (flags is stored as is, like the extras of a Get response).
+ */
+class RangeScanDocumentMeta {
+public:
+    RangeScanDocumentMeta() = default;
+    RangeScanDocumentMeta(uint32_t flags,
+                          uint32_t expiry,
+                          uint64_t seqno,
+                          uint64_t cas,
+                          uint8_t datatype)
+        : flags(flags),
+          expiry(htonl(expiry)),
+          seqno(htonll(seqno)),
+          cas(htonll(cas)),
+          datatype(datatype) {
+    }
+
+    uint32_t getFlags() const {
+        return flags;
+    }
+
+    uint32_t getExpiry() const {
+        return ntohl(expiry);
+    }
+
+    uint64_t getSeqno() const {
+        return ntohll(seqno);
+    }
+
+    uint64_t getCas() const {
+        return ntohll(cas);
+    }
+
+    uint8_t getDatatype() const {
+        return datatype;
+    }
+
+    std::string_view getBuffer() const {
+        return {reinterpret_cast<const char*>(this), sizeof(*this)};
+    }
+
+protected:
+    uint32_t flags{0};
+    uint32_t expiry{0};
+    uint64_t seqno{0};
+    uint64_t cas{0};
+    uint8_t datatype{0};
+};
+static_assert(sizeof(RangeScanDocumentMeta) == 25, "Unexpected struct size");
+#pragma pack()
+} // namespace cb::mcbp::response
@@ -121,6 +121,7 @@ public:
     [[nodiscard]] nlohmann::json getRunningConfigAsJson() const;
 
 private:
+    class MetricCache;
     class KVCollectable;
 
     // Prometheus exposer takes weak pointers to `Collectable`s
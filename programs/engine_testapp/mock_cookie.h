@@ -108,6 +108,10 @@ public:
         return sfd;
     }
 
+    void setConnectionId(uint32_t id) {
+        sfd = id;
+    }
+
     std::mutex& getMutex();
     void lock();
     void unlock();
@@ -112,6 +112,7 @@ bool is_valid_opcode(ClientOpcode opcode) {
     case ClientOpcode::StartPersistence:
     case ClientOpcode::SetParam:
     case ClientOpcode::GetReplica:
+    case ClientOpcode::GetMulti:
     case ClientOpcode::CreateBucket:
     case ClientOpcode::DeleteBucket:
     case ClientOpcode::ListBuckets:
@@ -149,6 +150,9 @@ bool is_valid_opcode(ClientOpcode opcode) {
     case ClientOpcode::GetRandomKey:
     case ClientOpcode::SeqnoPersistence:
     case ClientOpcode::GetKeys:
+    case ClientOpcode::RangeScanCreate:
+    case ClientOpcode::RangeScanContinue:
+    case ClientOpcode::RangeScanCancel:
     case ClientOpcode::CollectionsSetManifest:
     case ClientOpcode::CollectionsGetManifest:
     case ClientOpcode::CollectionsGetID:
@@ -274,6 +278,7 @@ bool is_supported_opcode(ClientOpcode opcode) {
     case ClientOpcode::StartPersistence:
     case ClientOpcode::SetParam:
     case ClientOpcode::GetReplica:
+    case ClientOpcode::GetMulti:
     case ClientOpcode::CreateBucket:
     case ClientOpcode::DeleteBucket:
     case ClientOpcode::ListBuckets:
@@ -305,6 +310,9 @@ bool is_supported_opcode(ClientOpcode opcode) {
     case ClientOpcode::GetRandomKey:
     case ClientOpcode::SeqnoPersistence:
     case ClientOpcode::GetKeys:
+    case ClientOpcode::RangeScanCreate:
+    case ClientOpcode::RangeScanContinue:
+    case ClientOpcode::RangeScanCancel:
     case ClientOpcode::CollectionsSetManifest:
     case ClientOpcode::CollectionsGetManifest:
     case ClientOpcode::CollectionsGetID:
@@ -484,6 +492,7 @@ bool is_durability_supported(ClientOpcode opcode) {
     case ClientOpcode::StartPersistence:
     case ClientOpcode::SetParam:
     case ClientOpcode::GetReplica:
+    case ClientOpcode::GetMulti:
     case ClientOpcode::CreateBucket:
     case ClientOpcode::DeleteBucket:
     case ClientOpcode::ListBuckets:
@@ -521,6 +530,9 @@ bool is_durability_supported(ClientOpcode opcode) {
     case ClientOpcode::GetRandomKey:
     case ClientOpcode::SeqnoPersistence:
     case ClientOpcode::GetKeys:
+    case ClientOpcode::RangeScanCreate:
+    case ClientOpcode::RangeScanContinue:
+    case ClientOpcode::RangeScanCancel:
     case ClientOpcode::CollectionsSetManifest:
     case ClientOpcode::CollectionsGetManifest:
     case ClientOpcode::CollectionsGetID:
@@ -702,8 +714,12 @@ bool is_reorder_supported(ClientOpcode opcode) {
     case ClientOpcode::SetClusterConfig:
     case ClientOpcode::GetClusterConfig:
     case ClientOpcode::GetRandomKey:
+    case ClientOpcode::GetMulti:
     case ClientOpcode::SeqnoPersistence:
     case ClientOpcode::GetKeys:
+    case ClientOpcode::RangeScanCreate:
+    case ClientOpcode::RangeScanContinue:
+    case ClientOpcode::RangeScanCancel:
     case ClientOpcode::CollectionsSetManifest:
     case ClientOpcode::CollectionsGetManifest:
     case ClientOpcode::CollectionsGetID:
@@ -886,8 +902,12 @@ bool is_collection_command(ClientOpcode opcode) {
     case ClientOpcode::SetClusterConfig:
     case ClientOpcode::GetClusterConfig:
     case ClientOpcode::GetRandomKey:
+    case ClientOpcode::GetMulti:
     case ClientOpcode::SeqnoPersistence:
     case ClientOpcode::GetKeys:
+    case ClientOpcode::RangeScanCreate:
+    case ClientOpcode::RangeScanContinue:
+    case ClientOpcode::RangeScanCancel:
     case ClientOpcode::CollectionsSetManifest:
     case ClientOpcode::CollectionsGetManifest:
     case ClientOpcode::CollectionsGetID:
@@ -1021,6 +1041,7 @@ bool is_deprecated(ClientOpcode opcode) {
     case ClientOpcode::StartPersistence:
     case ClientOpcode::SetParam:
     case ClientOpcode::GetReplica:
+    case ClientOpcode::GetMulti:
     case ClientOpcode::CreateBucket:
     case ClientOpcode::DeleteBucket:
     case ClientOpcode::ListBuckets:
@@ -1054,6 +1075,9 @@ bool is_deprecated(ClientOpcode opcode) {
     case ClientOpcode::GetRandomKey:
     case ClientOpcode::SeqnoPersistence:
     case ClientOpcode::GetKeys:
+    case ClientOpcode::RangeScanCreate:
+    case ClientOpcode::RangeScanContinue:
+    case ClientOpcode::RangeScanCancel:
     case ClientOpcode::CollectionsSetManifest:
     case ClientOpcode::CollectionsGetManifest:
     case ClientOpcode::CollectionsGetID:
@@ -1202,6 +1226,7 @@ bool is_preserve_ttl_supported(ClientOpcode opcode) {
     case ClientOpcode::StartPersistence:
     case ClientOpcode::SetParam:
     case ClientOpcode::GetReplica:
+    case ClientOpcode::GetMulti:
     case ClientOpcode::CreateBucket:
     case ClientOpcode::DeleteBucket:
     case ClientOpcode::ListBuckets:
@@ -1239,6 +1264,9 @@ bool is_preserve_ttl_supported(ClientOpcode opcode) {
     case ClientOpcode::GetRandomKey:
     case ClientOpcode::SeqnoPersistence:
     case ClientOpcode::GetKeys:
+    case ClientOpcode::RangeScanCreate:
+    case ClientOpcode::RangeScanContinue:
+    case ClientOpcode::RangeScanCancel:
     case ClientOpcode::CollectionsSetManifest:
     case ClientOpcode::CollectionsGetManifest:
     case ClientOpcode::CollectionsGetID:
@@ -1477,6 +1505,8 @@ std::string to_string(cb::mcbp::ClientOpcode opcode) {
         return "SET_PARAM";
     case ClientOpcode::GetReplica:
         return "GET_REPLICA";
+    case ClientOpcode::GetMulti:
+        return "GET_MULTI";
     case ClientOpcode::CreateBucket:
         return "CREATE_BUCKET";
     case ClientOpcode::DeleteBucket:
@@ -1593,6 +1623,12 @@ std::string to_string(cb::mcbp::ClientOpcode opcode) {
         return "SUBDOC_GET_COUNT";
     case ClientOpcode::SubdocReplaceBodyWithXattr:
         return "SUBDOC_REPLACE_BODY_WITH_XATTR";
+    case ClientOpcode::RangeScanCreate:
+        return "RANGE_SCAN_CREATE";
+    case ClientOpcode::RangeScanContinue:
+        return "RANGE_SCAN_CONTINUE";
+    case ClientOpcode::RangeScanCancel:
+        return "RANGE_SCAN_CANCEL";
     case ClientOpcode::Scrub:
         return "SCRUB";
     case ClientOpcode::IsaslRefresh:
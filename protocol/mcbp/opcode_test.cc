@@ -113,6 +113,7 @@ const std::map<cb::mcbp::ClientOpcode, std::string> client_blueprint = {
          {ClientOpcode::StartPersistence, "START_PERSISTENCE"},
          {ClientOpcode::SetParam, "SET_PARAM"},
          {ClientOpcode::GetReplica, "GET_REPLICA"},
+         {ClientOpcode::GetMulti, "GET_MULTI"},
          {ClientOpcode::CreateBucket, "CREATE_BUCKET"},
          {ClientOpcode::DeleteBucket, "DELETE_BUCKET"},
          {ClientOpcode::ListBuckets, "LIST_BUCKETS"},
@@ -177,6 +178,9 @@ const std::map<cb::mcbp::ClientOpcode, std::string> client_blueprint = {
          {ClientOpcode::SubdocGetCount, "SUBDOC_GET_COUNT"},
          {ClientOpcode::SubdocReplaceBodyWithXattr,
           "SUBDOC_REPLACE_BODY_WITH_XATTR"},
+         {ClientOpcode::RangeScanCreate, "RANGE_SCAN_CREATE"},
+         {ClientOpcode::RangeScanContinue, "RANGE_SCAN_CONTINUE"},
+         {ClientOpcode::RangeScanCancel, "RANGE_SCAN_CANCEL"},
          {ClientOpcode::Scrub, "SCRUB"},
          {ClientOpcode::IsaslRefresh, "ISASL_REFRESH"},
          {ClientOpcode::SslCertsRefresh, "SSL_CERTS_REFRESH"},
@@ -168,6 +168,7 @@ bool Request::isQuiet() const {
         case ClientOpcode::StartPersistence:
         case ClientOpcode::SetParam:
         case ClientOpcode::GetReplica:
+        case ClientOpcode::GetMulti:
         case ClientOpcode::CreateBucket:
         case ClientOpcode::DeleteBucket:
         case ClientOpcode::ListBuckets:
@@ -201,6 +202,9 @@ bool Request::isQuiet() const {
         case ClientOpcode::GetRandomKey:
         case ClientOpcode::SeqnoPersistence:
         case ClientOpcode::GetKeys:
+        case ClientOpcode::RangeScanCreate:
+        case ClientOpcode::RangeScanContinue:
+        case ClientOpcode::RangeScanCancel:
         case ClientOpcode::CollectionsSetManifest:
         case ClientOpcode::CollectionsGetManifest:
         case ClientOpcode::CollectionsGetID:
@@ -57,6 +57,9 @@ bool is_known(Status status) {
     case Status::SyncWriteInProgress:
     case Status::SyncWriteAmbiguous:
     case Status::SyncWriteReCommitInProgress:
+    case Status::RangeScanCancelled:
+    case Status::RangeScanMore:
+    case Status::RangeScanComplete:
     case Status::SubdocPathEnoent:
     case Status::SubdocPathMismatch:
     case Status::SubdocPathEinval:
@@ -98,6 +101,8 @@ bool isStatusSuccess(Status status) {
     case Status::SubdocMultiPathFailure:
     case Status::SubdocMultiPathFailureDeleted:
     case Status::Rollback:
+    case Status::RangeScanMore:
+    case Status::RangeScanComplete:
         return true;
 
     case Status::KeyEnoent:
@@ -137,6 +142,7 @@ bool isStatusSuccess(Status status) {
     case Status::SyncWriteInProgress:
     case Status::SyncWriteAmbiguous:
     case Status::SyncWriteReCommitInProgress:
+    case Status::RangeScanCancelled:
     case Status::SubdocPathEnoent:
     case Status::SubdocPathMismatch:
     case Status::SubdocPathEinval:
@@ -280,6 +286,12 @@ std::string to_string(cb::mcbp::Status status, bool shortname) {
             return "SyncWriteAmbiguous";
         case Status::SyncWriteReCommitInProgress:
             return "SyncWriteReCommitInProgress";
+        case Status::RangeScanCancelled:
+            return "RangeScanCancelled";
+        case Status::RangeScanMore:
+            return "RangeScanMore";
+        case Status::RangeScanComplete:
+            return "RangeScanComplete";
         case Status::SubdocPathEnoent:
             return "SubdocPathEnoent";
         case Status::SubdocPathMismatch:
@@ -417,6 +429,12 @@ std::string to_string(cb::mcbp::Status status, bool shortname) {
             return "Synchronous write ambiguous";
         case Status::SyncWriteReCommitInProgress:
             return "Synchronous write re-commit in progress";
+        case Status::RangeScanCancelled:
+            return "Range scan cancelled";
+        case Status::RangeScanMore:
+            return "Range scan has more data";
+        case Status::RangeScanComplete:
+            return "Range scan complete";
         case Status::SubdocPathEnoent:
             return "Subdoc: Path not does not exist";
         case Status::SubdocPathMismatch:
@@ -22,6 +22,9 @@
 #include <platform/uuid.h>
 #include <prometheus/exposer.h>
 #include <chrono>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
 
 namespace cb::prometheus {
@@ -86,22 +89,63 @@ nlohmann::json getRunningConfigAsJson() {
     return handle->getRunningConfigAsJson();
 }
 
-class MetricServer::KVCollectable : public ::prometheus::Collectable {
+/**
+ * The metrics collected for one cardinality, shared by the endpoints of that
+ * cardinality (with and without timestamps).
+ *
+ * A collection walks every bucket, vBucket, scope and collection, so rather
+ * than each scrape making its own:
+ *  - scrapes which arrive while a collection is in progress (e.g. both
+ *    endpoints of a cardinality being scraped at once) wait for it and
+ *    share its result, and
+ *  - High cardinality scrapes reuse a collection made within
+ *    prometheus_high_cardinality_cache_time (if non-zero).
+ *
+ * Only whole collections are shared; each one still builds every family
+ * from scratch (there's no incremental collection), and each scrape gets
+ * its own copy of the families.
+ */
+class MetricServer::MetricCache {
 public:
-    KVCollectable(Cardinality cardinality,
-                  IncludeTimestamps timestamps,
-                  GetStatsCallback getStatsCB)
-        : cardinality(cardinality),
-          timestamps(timestamps),
-          getStatsCB(std::move(getStatsCB)) {
+    struct Collection {
+        std::vector<::prometheus::MetricFamily> families;
+        /// Timestamp (ms since epoch) of the samples of the collection
+        int64_t timestampMs = 0;
+        /// When the collection completed
+        std::chrono::steady_clock::time_point completed;
+    };
+
+    MetricCache(Cardinality cardinality, GetStatsCallback getStatsCB)
+        : cardinality(cardinality), getStatsCB(std::move(getStatsCB)) {
     }
-    /**
-     * Gathers high or low cardinality metrics
-     * and returns them in the prometheus required structure.
-     */
-    [[nodiscard]] std::vector<::prometheus::MetricFamily> Collect()
-            const override {
+
+    /// @return the metrics for a scrape, collecting them if the latest
+    ///         collection can't be reused
+    std::shared_ptr<const Collection> get() {
+        using namespace std::chrono;
+        const auto requested = steady_clock::now();
+        std::lock_guard<std::mutex> guard(mutex);
+        if (latest &&
+            (latest->completed >= requested ||
+             steady_clock::now() - latest->completed <= getMaxAge())) {
+            return latest;
+        }
+        latest = collect();
+        return latest;
+    }
+
+private:
+    std::chrono::milliseconds getMaxAge() const {
+        if (cardinality == Cardinality::High) {
+            return Settings::instance().getPrometheusHighCardinalityCacheTime();
+        }
+        return std::chrono::milliseconds{0};
+    }
+
+    std::shared_ptr<const Collection> collect() {
         using namespace std::chrono;
+        auto collection = std::make_shared<Collection>();
+
         // get current time in seconds as double
         double timestamp = duration_cast<duration<double>>(
                                    system_clock::now().time_since_epoch())
@@ -114,10 +158,13 @@ public:
         timestamp = std::round(timestamp);
 
         // convert to ms for prometheus-cpp
-        auto timestampMs = int64_t(timestamp * 1000);
+        collection->timestampMs = int64_t(timestamp * 1000);
 
-        // collect KV stats
+        // collect KV stats. The number of families rarely changes between
+        // collections, so size the map from the previous one to avoid
+        // rehashing as it is populated.
         std::unordered_map<std::string, ::prometheus::MetricFamily> statsMap;
+        statsMap.reserve(familyCountHint);
         PrometheusStatCollector collector(statsMap);
         getStatsCB(collector, cardinality);
 
@@ -125,16 +172,47 @@ public:
         // but during collection it is necessary to frequently look up
         // families by name, so they are stored in a map.
         // Unpack them into a vector.
-        std::vector<::prometheus::MetricFamily> result;
+        collection->families.reserve(statsMap.size());
+        for (auto& statEntry : statsMap) {
+            collection->families.push_back(
+                    std::move(statEntry.second) /* MetricFamily */);
+        }
+        familyCountHint = statsMap.size();
+        collection->completed = steady_clock::now();
+        return collection;
+    }
+
+    const Cardinality cardinality;
+
+    // function to call to generate stats
+    GetStatsCallback getStatsCB;
 
-        result.reserve(statsMap.size());
+    /// Serialises collections, and guards the members below
+    std::mutex mutex;
+    std::shared_ptr<const Collection> latest;
+    size_t familyCountHint = 0;
+};
 
-        for (const auto& statEntry : statsMap) {
-            result.push_back(std::move(statEntry.second) /* MetricFamily */);
-            // only set timestamps if requested
-            if (timestamps == IncludeTimestamps::Yes) {
-                for (auto& clientMetric : result.back().metric) {
-                    clientMetric.timestamp_ms = timestampMs;
+class MetricServer::KVCollectable : public ::prometheus::Collectable {
+public:
+    KVCollectable(IncludeTimestamps timestamps,
+                  std::shared_ptr<MetricCache> cache)
+        : timestamps(timestamps), cache(std::move(cache)) {
+    }
+    /**
+     * Gathers high or low cardinality metrics
+     * and returns them in the prometheus required structure.
+     */
+    [[nodiscard]] std::vector<::prometheus::MetricFamily> Collect()
+            const override {
+        const auto collection = cache->get();
+        // Copy, as the collection may be shared with other scrapes
+        auto result = collection->families;
+        // only set timestamps if requested
+        if (timestamps == IncludeTimestamps::Yes) {
+            for (auto& family : result) {
+                for (auto& clientMetric : family.metric) {
+                    clientMetric.timestamp_ms = collection->timestampMs;
                 }
             }
         }
@@ -143,11 +221,10 @@ public:
     }
 
 private:
-    const Cardinality cardinality;
     const IncludeTimestamps timestamps;
 
-    // function to call on every incoming request to generate stats
-    GetStatsCallback getStatsCB;
+    // The (shared) metrics of the cardinality of this endpoint
+    std::shared_ptr<MetricCache> cache;
 };
 
 MetricServer::MetricServer(in_port_t port,
@@ -174,6 +251,12 @@ MetricServer::MetricServer(in_port_t port,
 
         exposer = std::make_unique<::prometheus::Exposer>(connectionStr);
 
+        // The endpoints of each cardinality share a cache of their metrics
+        const auto lowCardinalityCache =
+                std::make_shared<MetricCache>(Cardinality::Low, getStatsCB);
+        const auto highCardinalityCache =
+                std::make_shared<MetricCache>(Cardinality::High, getStatsCB);
+
         // used to store the newly created KVCollectable into the array
         auto arrayItr = endpoints.begin();
         for (auto [cardinality, timestamps] : {
@@ -183,7 +266,9 @@ MetricServer::MetricServer(in_port_t port,
                      std::make_pair(Cardinality::High, IncludeTimestamps::Yes),
              }) {
             auto ptr = std::make_shared<KVCollectable>(
-                    cardinality, timestamps, getStatsCB);
+                    timestamps,
+                    cardinality == Cardinality::High ? highCardinalityCache
+                                                     : lowCardinalityCache);
 
             // construct the path this endpoint should listen on
             auto path = cardinality == Cardinality::High ? highCardinalityPath
@@ -0,0 +1,145 @@
+/* -*- Mode: C++; tab-width: 4; c-basic-offset: 4; indent-tabs-mode: nil -*- */
+/*
+ *     Copyright 2022-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+
+/*
+ * Benchmarks for the (memcached bucket) default_engine front-end operations,
+ * run with an increasing number of threads to measure how GET / SET scale
+ * with the number of cores.
+ */
+
+#include <benchmark/benchmark.h>
+#include <engines/default_engine/default_engine_public.h>
+#include <memcached/engine.h>
+#include <programs/engine_testapp/mock_cookie.h>
+#include <programs/engine_testapp/mock_server.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+class DefaultEngineBench : public benchmark::Fixture {
+public:
+    void SetUp(const benchmark::State& state) override {
+        if (state.thread_index() == 0) {
+            init_mock_server();
+            EngineIface* handle = nullptr;
+            if (create_memcache_instance(get_mock_server_api, &handle) !=
+                        cb::engine_errc::success ||
+                handle->initialize("cache_size=1073741824") !=
+                        cb::engine_errc::success) {
+                throw std::runtime_error(
+                        "DefaultEngineBench: Failed to create engine");
+            }
+
+            // Populate the keys used by the read benchmarks.
+            auto* cookie = create_mock_cookie(handle);
+            for (size_t ii = 0; ii < numKeys; ii++) {
+                store(*handle, *cookie, makeKey(ii));
+            }
+            destroy_mock_cookie(cookie);
+            engine = handle;
+        } else {
+            // 'engine' setup by thread:0; wait until it has completed.
+            while (!engine.load()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void TearDown(const benchmark::State& state) override {
+        if (state.thread_index() == 0) {
+            engine.exchange(nullptr)->destroy(false);
+        }
+    }
+
+protected:
+    static std::string makeKey(size_t ii) {
+        return "key_" + std::to_string(ii);
+    }
+
+    static void store(EngineIface& handle,
+                      CookieIface& cookie,
+                      const std::string& key) {
+        const DocKey docKey(key, DocKeyEncodesCollectionId::No);
+        auto [item, info] = handle.allocateItem(
+                cookie, docKey, valueSize, 0, 0, 0, 0, Vbid(0));
+        uint64_t cas = 0;
+        handle.store(cookie,
+                     *item,
+                     cas,
+                     StoreSemantics::Set,
+                     {},
+                     DocumentState::Alive,
+                     false);
+    }
+
+    /// Keys for the given thread; each thread uses a different subset.
+    static std::vector<std::string> threadKeys(const benchmark::State& state) {
+        std::vector<std::string> keys;
+        for (size_t ii = state.thread_index(); ii < numKeys;
+             ii += state.threads()) {
+            keys.push_back(makeKey(ii));
+        }
+        return keys;
+    }
+
+    static constexpr size_t numKeys = 100000;
+    static constexpr size_t valueSize = 128;
+
+    static std::atomic<EngineIface*> engine;
+};
+
+std::atomic<EngineIface*> DefaultEngineBench::engine{nullptr};
+
+/// GET (and release) of existing keys.
+BENCHMARK_DEFINE_F(DefaultEngineBench, Get)(benchmark::State& state) {
+    auto* cookie = create_mock_cookie(engine);
+    const auto keys = threadKeys(state);
+    auto itr = keys.begin();
+
+    for (auto _ : state) {
+        auto ret = engine.load()->get(
+                *cookie,
+                DocKey(*itr, DocKeyEncodesCollectionId::No),
+                Vbid(0),
+                DocStateFilter::Alive);
+        benchmark::DoNotOptimize(ret);
+        if (++itr == keys.end()) {
+            itr = keys.begin();
+        }
+    }
+    destroy_mock_cookie(cookie);
+    state.SetItemsProcessed(state.iterations());
+}
+
+/// SET (allocate + store) of existing keys, replacing their value.
+BENCHMARK_DEFINE_F(DefaultEngineBench, Set)(benchmark::State& state) {
+    auto* cookie = create_mock_cookie(engine);
+    const auto keys = threadKeys(state);
+    auto itr = keys.begin();
+
+    for (auto _ : state) {
+        store(*engine.load(), *cookie, *itr);
+        if (++itr == keys.end()) {
+            itr = keys.begin();
+        }
+    }
+    destroy_mock_cookie(cookie);
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(DefaultEngineBench, Get)
+        ->ThreadRange(1, 64)
+        ->UseRealTime();
+BENCHMARK_REGISTER_F(DefaultEngineBench, Set)
+        ->ThreadRange(1, 64)
+        ->UseRealTime();
@@ -197,6 +197,45 @@ void HistogramToJson(benchmark::State& state) {
     }
 }
 
+/*
+ * Multiple threads recording into the same histogram, as the front-end
+ * threads do into the per-opcode Timings histograms.
+ */
+template <HdrHistogram::Recording recording>
+void HistogramSharedAdd(benchmark::State& state) {
+    static HdrHistogram testHisto{1,
+                                  60000000,
+                                  2,
+                                  HdrHistogram::Iterator::IterMode::Percentiles,
+                                  recording};
+
+    // Per-thread values (log normal as GetNextLogNormalValue, which isn't
+    // thread-safe).
+    std::mt19937 randomNumGen(state.thread_index());
+    std::lognormal_distribution<double> distribution(LOG_NORMAL_MEAN,
+                                                     LOG_NORMAL_STD);
+    std::vector<uint64_t> values(1000);
+    for (auto& value : values) {
+        value = static_cast<uint64_t>(
+                LOG_NORMAL_MIN + std::round(distribution(randomNumGen) *
+                                            LOG_NORMAL_SCALE_UP_MULT));
+    }
+
+    auto itr = values.begin();
+    for (auto _ : state) {
+        testHisto.addValue(*itr);
+        if (++itr == values.end()) {
+            itr = values.begin();
+        }
+    }
+
+    if (state.thread_index() == 0) {
+        // Include the cost of merging the shards for a reader.
+        benchmark::DoNotOptimize(testHisto.getValueCount());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
 BENCHMARK_TEMPLATE(HistogramConstructionDestructionHeap, TimingHistogram);
 BENCHMARK_TEMPLATE(HistogramConstructionDestructionHeap, HdrHistogramBench);
 BENCHMARK_TEMPLATE(HistogramConstructionDestructionHeap, HdrHistogramEmpty);
@@ -232,3 +271,10 @@ BENCHMARK_TEMPLATE(HistogramReset, HdrHistogramEmpty);
 
 BENCHMARK_TEMPLATE(HistogramAggregation, TimingHistogram)->Arg(100);
 BENCHMARK_TEMPLATE(HistogramAggregation, HdrHistogramBench)->Arg(100);
+
+BENCHMARK_TEMPLATE(HistogramSharedAdd, HdrHistogram::Recording::Direct)
+        ->ThreadRange(1, 16)
+        ->UseRealTime();
+BENCHMARK_TEMPLATE(HistogramSharedAdd, HdrHistogram::Recording::Sharded)
+        ->ThreadRange(1, 16)
+        ->UseRealTime();
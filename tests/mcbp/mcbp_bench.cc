@@ -14,6 +14,7 @@
 #include <daemon/cookie.h>
 #include <daemon/front_end_thread.h>
 #include <daemon/mcbp_validators.h>
+#include <event2/buffer.h>
 #include <mcbp/protocol/header.h>
 #include <memcached/protocol_binary.h>
 
@@ -94,3 +95,71 @@ BENCHMARK_DEFINE_F(McbpValidatorBench, AddBench)(benchmark::State& state) {
 BENCHMARK_REGISTER_F(McbpValidatorBench, GetBench);
 BENCHMARK_REGISTER_F(McbpValidatorBench, SetBench);
 BENCHMARK_REGISTER_F(McbpValidatorBench, AddBench);
+
+/**
+ * Test the performance of copying small responses (header, extras, key and
+ * value fragments) to a connection's output buffer, draining the buffer
+ * (as writing it to the socket would) every 'batch' responses.
+ */
+class OutputStreamBench : public ::benchmark::Fixture {
+public:
+    void SetUp(benchmark::State& st) override {
+        output.reset(evbuffer_new());
+    }
+
+    void TearDown(benchmark::State& st) override {
+        output.reset();
+    }
+
+protected:
+    struct EvbufferDeleter {
+        void operator()(evbuffer* buffer) {
+            evbuffer_free(buffer);
+        }
+    };
+    std::unique_ptr<evbuffer, EvbufferDeleter> output;
+
+    // The fragments of a Get response with a 10 byte key and 100 byte value
+    std::array<char, sizeof(cb::mcbp::Response)> header{};
+    std::array<char, 4> extras{};
+    std::array<char, 10> key{};
+    std::array<char, 100> value{};
+    std::array<std::string_view, 4> fragments{
+            {{header.data(), header.size()},
+             {extras.data(), extras.size()},
+             {key.data(), key.size()},
+             {value.data(), value.size()}}};
+};
+
+/// One evbuffer_add per fragment (the previous implementation)
+BENCHMARK_DEFINE_F(OutputStreamBench, PerFragment)(benchmark::State& state) {
+    const auto batch = state.range(0);
+    int64_t n = 0;
+    while (state.KeepRunning()) {
+        for (const auto& f : fragments) {
+            evbuffer_add(output.get(), f.data(), f.size());
+        }
+        if (++n % batch == 0) {
+            evbuffer_drain(output.get(), evbuffer_get_length(output.get()));
+        }
+    }
+}
+
+/// Connection::copyToOutputBuffer
+BENCHMARK_DEFINE_F(OutputStreamBench, Coalesced)(benchmark::State& state) {
+    const auto batch = state.range(0);
+    int64_t n = 0;
+    std::size_t chunkSpace = 0;
+    while (state.KeepRunning()) {
+        Connection::copyToOutputBuffer(*output, fragments, chunkSpace);
+        if (++n % batch == 0) {
+            evbuffer_drain(output.get(), evbuffer_get_length(output.get()));
+        }
+    }
+}
+
+BENCHMARK_REGISTER_F(OutputStreamBench, PerFragment)
+        ->Arg(1)
+        ->Arg(64)
+        ->Arg(1024);
+BENCHMARK_REGISTER_F(OutputStreamBench, Coalesced)->Arg(1)->Arg(64)->Arg(1024);
@@ -365,6 +365,93 @@ INSTANTIATE_TEST_SUITE_P(
                                              cb::mcbp::ClientOpcode::GetqMeta),
                            ::testing::Bool()));
 
+class GetMultiValidatorTest : public ::testing::WithParamInterface<bool>,
+                              public ValidatorTest {
+public:
+    GetMultiValidatorTest() : ValidatorTest(GetParam()) {
+    }
+
+    void SetUp() override {
+        ValidatorTest::SetUp();
+        addKey(Vbid(0), "foo");
+        addKey(Vbid(1), "bar");
+        build();
+    }
+
+protected:
+    /// Append a key spec for the key (in the default collection)
+    void addKey(Vbid vbid, std::string key) {
+        if (collectionsEnabled) {
+            key.insert(key.begin(), '\0');
+        }
+        appendSpec(vbid, gsl::narrow<uint16_t>(key.size()));
+        value.append(key);
+    }
+
+    void appendSpec(Vbid vbid, uint16_t keylen) {
+        cb::mcbp::request::GetMultiKeySpec spec(vbid, keylen);
+        value.append(spec.getBuffer());
+    }
+
+    void build() {
+        cb::mcbp::RequestBuilder builder({blob, sizeof(blob)});
+        builder.setMagic(cb::mcbp::Magic::ClientRequest);
+        builder.setOpcode(cb::mcbp::ClientOpcode::GetMulti);
+        builder.setValue(value);
+    }
+
+    cb::mcbp::Status validate() {
+        return ValidatorTest::validate(cb::mcbp::ClientOpcode::GetMulti,
+                                       static_cast<void*>(&request));
+    }
+
+    std::string value;
+};
+
+TEST_P(GetMultiValidatorTest, CorrectMessage) {
+    EXPECT_EQ(cb::mcbp::Status::Success, validate());
+}
+
+TEST_P(GetMultiValidatorTest, NoValue) {
+    value.clear();
+    build();
+    EXPECT_EQ(cb::mcbp::Status::Einval, validate());
+}
+
+TEST_P(GetMultiValidatorTest, InvalidKeylen) {
+    cb::mcbp::RequestBuilder builder({blob, sizeof(blob)}, true);
+    builder.setKey("foo");
+    EXPECT_EQ(cb::mcbp::Status::Einval, validate());
+}
+
+TEST_P(GetMultiValidatorTest, InvalidCas) {
+    request.message.header.request.setCas(1);
+    EXPECT_EQ(cb::mcbp::Status::Einval, validate());
+}
+
+TEST_P(GetMultiValidatorTest, TruncatedSpec) {
+    value.push_back('\0');
+    build();
+    EXPECT_EQ(cb::mcbp::Status::Einval, validate());
+    EXPECT_EQ("Truncated key spec",
+              validate_error_context(cb::mcbp::ClientOpcode::GetMulti));
+}
+
+TEST_P(GetMultiValidatorTest, EmptyKey) {
+    appendSpec(Vbid(0), 0);
+    build();
+    EXPECT_EQ(cb::mcbp::Status::Einval, validate());
+}
+
+TEST_P(GetMultiValidatorTest, KeyExceedsValue) {
+    appendSpec(Vbid(0), 10);
+    value.append("foo");
+    build();
+    EXPECT_EQ(cb::mcbp::Status::Einval, validate());
+    EXPECT_EQ("Key exceeds the value",
+              validate_error_context(cb::mcbp::ClientOpcode::GetMulti));
+}
+
 // Test ADD & ADDQ
 class AddValidatorTest : public ::testing::WithParamInterface<bool>,
                          public ValidatorTest {
@@ -2968,6 +3055,10 @@ TEST_P(GetVBucketValidatorTest, InvalidBodylen) {
     EXPECT_EQ(cb::mcbp::Status::Einval, validate());
 }
 
+INSTANTIATE_TEST_SUITE_P(CollectionsOnOff,
+                         GetMultiValidatorTest,
+                         ::testing::Bool(),
+                         ::testing::PrintToStringParamName());
 INSTANTIATE_TEST_SUITE_P(CollectionsOnOff,
                          AddValidatorTest,
                          ::testing::Bool(),
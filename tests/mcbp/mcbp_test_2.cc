@@ -425,6 +425,110 @@ TEST_P(GetKeysValidatorTest, InvalidBodylen) {
     EXPECT_EQ(cb::mcbp::Status::Einval, validate());
 }
 
+class RangeScanCreateValidatorTest
+    : public ::testing::WithParamInterface<bool>,
+      public ValidatorTest {
+public:
+    RangeScanCreateValidatorTest()
+        : ValidatorTest(GetParam()), req(request.message.header.request) {
+    }
+
+    void SetUp() override {
+        ValidatorTest::SetUp();
+        req.setKeylen(0);
+        req.setBodylen(2);
+        req.setDatatype(cb::mcbp::Datatype::JSON);
+    }
+
+protected:
+    cb::mcbp::Request& req;
+    cb::mcbp::Status validate() {
+        return ValidatorTest::validate(cb::mcbp::ClientOpcode::RangeScanCreate,
+                                       static_cast<void*>(&request));
+    }
+};
+
+TEST_P(RangeScanCreateValidatorTest, CorrectMessage) {
+    EXPECT_EQ(cb::mcbp::Status::Success, validate());
+}
+
+TEST_P(RangeScanCreateValidatorTest, InvalidExtlen) {
+    req.setExtlen(4);
+    req.setBodylen(6);
+    EXPECT_EQ(cb::mcbp::Status::Einval, validate());
+}
+
+TEST_P(RangeScanCreateValidatorTest, InvalidKey) {
+    req.setKeylen(2);
+    req.setBodylen(4);
+    EXPECT_EQ(cb::mcbp::Status::Einval, validate());
+}
+
+TEST_P(RangeScanCreateValidatorTest, InvalidBodylen) {
+    // The configuration must be present
+    req.setBodylen(0);
+    EXPECT_EQ(cb::mcbp::Status::Einval, validate());
+}
+
+TEST_P(RangeScanCreateValidatorTest, InvalidCas) {
+    req.setCas(0xff);
+    EXPECT_EQ(cb::mcbp::Status::Einval, validate());
+}
+
+class RangeScanContinueValidatorTest
+    : public ::testing::WithParamInterface<bool>,
+      public ValidatorTest {
+public:
+    RangeScanContinueValidatorTest()
+        : ValidatorTest(GetParam()), req(request.message.header.request) {
+    }
+
+    void SetUp() override {
+        ValidatorTest::SetUp();
+        req.setKeylen(0);
+        req.setExtlen(sizeof(cb::mcbp::request::RangeScanContinuePayload));
+        req.setBodylen(sizeof(cb::mcbp::request::RangeScanContinuePayload));
+    }
+
+protected:
+    cb::mcbp::Request& req;
+    cb::mcbp::Status validate(
+            cb::mcbp::ClientOpcode opcode =
+                    cb::mcbp::ClientOpcode::RangeScanContinue) {
+        return ValidatorTest::validate(opcode, static_cast<void*>(&request));
+    }
+};
+
+TEST_P(RangeScanContinueValidatorTest, CorrectMessage) {
+    EXPECT_EQ(cb::mcbp::Status::Success, validate());
+}
+
+TEST_P(RangeScanContinueValidatorTest, InvalidExtlen) {
+    req.setExtlen(4);
+    req.setBodylen(4);
+    EXPECT_EQ(cb::mcbp::Status::Einval, validate());
+}
+
+TEST_P(RangeScanContinueValidatorTest, InvalidValue) {
+    req.setBodylen(sizeof(cb::mcbp::request::RangeScanContinuePayload) + 2);
+    EXPECT_EQ(cb::mcbp::Status::Einval, validate());
+}
+
+TEST_P(RangeScanContinueValidatorTest, InvalidDatatype) {
+    req.setDatatype(cb::mcbp::Datatype::JSON);
+    EXPECT_EQ(cb::mcbp::Status::Einval, validate());
+}
+
+TEST_P(RangeScanContinueValidatorTest, Cancel) {
+    // Cancel only carries the id of the scan
+    EXPECT_EQ(cb::mcbp::Status::Einval,
+              validate(cb::mcbp::ClientOpcode::RangeScanCancel));
+    req.setExtlen(sizeof(cb::mcbp::request::RangeScanId));
+    req.setBodylen(sizeof(cb::mcbp::request::RangeScanId));
+    EXPECT_EQ(cb::mcbp::Status::Success,
+              validate(cb::mcbp::ClientOpcode::RangeScanCancel));
+}
+
 class SetParamValidatorTest : public ::testing::WithParamInterface<bool>,
                               public ValidatorTest {
 public:
@@ -870,6 +974,16 @@ INSTANTIATE_TEST_SUITE_P(CollectionsOnOff,
                          ::testing::Bool(),
                          ::testing::PrintToStringParamName());
 
+INSTANTIATE_TEST_SUITE_P(CollectionsOnOff,
+                         RangeScanCreateValidatorTest,
+                         ::testing::Bool(),
+                         ::testing::PrintToStringParamName());
+
+INSTANTIATE_TEST_SUITE_P(CollectionsOnOff,
+                         RangeScanContinueValidatorTest,
+                         ::testing::Bool(),
+                         ::testing::PrintToStringParamName());
+
 INSTANTIATE_TEST_SUITE_P(CollectionsOnOff,
                          SetParamValidatorTest,
                          ::testing::Bool(),
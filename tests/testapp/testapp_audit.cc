@@ -506,6 +506,41 @@ TEST_P(AuditTest, AuditSubdocMultiMutationDelete) {
     EXPECT_EQ(1, getAuditCount(entries, MEMCACHED_AUDIT_DOCUMENT_DELETE));
 }
 
+// A GetMulti logs a DOCUMENT_READ event for each key it reads, with the key
+// tagged as user data
+TEST_P(AuditTest, AuditGetMulti) {
+    auto& conn = getConnection();
+    conn.authenticate("Luke", mcd_env->getPassword("Luke"));
+    conn.selectBucket(bucketName);
+    const std::vector<std::string> keys{"doc1", "doc2"};
+    std::string value;
+    for (const auto& key : keys) {
+        conn.store(key, Vbid(0), "value");
+        cb::mcbp::request::GetMultiKeySpec spec(
+                Vbid(0), static_cast<uint16_t>(key.size()));
+        value.append(spec.getBuffer());
+        value.append(key);
+    }
+
+    BinprotGenericCommand cmd(cb::mcbp::ClientOpcode::GetMulti);
+    cmd.setValue(std::move(value));
+    ASSERT_EQ(cb::mcbp::Status::Success, conn.execute(cmd).getStatus());
+
+    // The delete is a sentinel for the events of the GetMulti
+    conn.remove("doc1", Vbid(0));
+    ASSERT_TRUE(searchAuditLogForID(MEMCACHED_AUDIT_DOCUMENT_DELETE));
+
+    std::vector<std::string> readKeys;
+    for (const auto& entry : readAuditData()) {
+        if (entry.at("id").get<int>() == MEMCACHED_AUDIT_DOCUMENT_READ) {
+            EXPECT_EQ(bucketName, entry.at("bucket").get<std::string>());
+            readKeys.push_back(entry.at("key").get<std::string>());
+        }
+    }
+    EXPECT_EQ(std::vector<std::string>({"<ud>doc1</ud>", "<ud>doc2</ud>"}),
+              readKeys);
+}
+
 TEST_P(AuditTest, AuditConfigReload) {
     auto rsp = adminConnection->execute(
             BinprotGenericCommand{cb::mcbp::ClientOpcode::ConfigReload});
@@ -9,6 +9,9 @@
  */
 
 #include "testapp_xattr.h"
+#include <mcbp/protocol/datatype.h>
+#include <nlohmann/json.hpp>
+#include <platform/compress.h>
 #include <thread>
 
 class ClusterConfigTest : public TestappXattrClientTest {
@@ -114,6 +117,44 @@ TEST_P(ClusterConfigTest, test_MB_17506_dedupe) {
     test_MB_17506(true);
 }
 
+/// A large clustermap is sent Snappy compressed in Not My VBucket responses
+/// to clients which have enabled Snappy, and as plain JSON otherwise
+TEST_P(ClusterConfigTest, NotMyVbucketSnappyClustermap) {
+    memcached_cfg["dedupe_nmvb_maps"] = false;
+    reconfigure();
+
+    nlohmann::json json;
+    json["rev"] = 100;
+    for (int ii = 0; ii < 1024; ++ii) {
+        json["nodes"].push_back("node" + std::to_string(ii) +
+                                ".example.com:11210");
+    }
+    const auto clustermap = json.dump();
+    ASSERT_TRUE(setClusterConfig(token, clustermap, 100).isSuccess());
+
+    BinprotGetCommand command;
+    command.setKey("foo");
+    command.setVBucket(Vbid(1));
+
+    for (const bool snappy : {false, true}) {
+        userConnection->setFeature(cb::mcbp::Feature::SNAPPY, snappy);
+        const auto response = userConnection->execute(command);
+        ASSERT_EQ(cb::mcbp::Status::NotMyVbucket, response.getStatus());
+
+        auto value = response.getDataString();
+        const auto datatype =
+                protocol_binary_datatype_t(response.getDatatype());
+        ASSERT_EQ(snappy, mcbp::datatype::is_snappy(datatype));
+        if (snappy) {
+            cb::compression::Buffer inflated;
+            ASSERT_TRUE(cb::compression::inflate(
+                    cb::compression::Algorithm::Snappy, value, inflated));
+            value = std::string(inflated.data(), inflated.size());
+        }
+        EXPECT_EQ(clustermap, value);
+    }
+}
+
 TEST_P(ClusterConfigTest, Enable_CCCP_Push_Notifications) {
     auto& conn = getConnection();
     // The "connection class" ignore the context part in
@@ -0,0 +1,146 @@
+/*
+ *     Copyright 2026-Present Couchbase, Inc.
+ *
+ *   Use of this software is governed by the Business Source License included
+ *   in the file licenses/BSL-Couchbase.txt.  As of the Change Date specified
+ *   in that file, in accordance with the Business Source License, use of this
+ *   software will be governed by the Apache License, Version 2.0, included in
+ *   the file licenses/APL2.txt.
+ */
+#include "testapp.h"
+#include "testapp_client_test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <thread>
+
+/*
+ * This test batch verifies how new connections are placed on the front end
+ * threads; with per_thread_listeners (on Linux) every thread has its own
+ * SO_REUSEPORT listening socket for the interface.
+ */
+class ConnectionPlacementTest : public TestappClientTest {
+public:
+    static void SetUpTestCase() {
+        auto config = generate_config();
+        config["threads"] = NumThreads;
+#ifdef __linux__
+        config["per_thread_listeners"] = true;
+#endif
+        doSetUpTestCaseWithConfiguration(config);
+    }
+
+protected:
+    void SetUp() override {
+        TestappClientTest::SetUp();
+        initialConnections = getTotalConnections();
+    }
+
+    void TearDown() override {
+        connections.clear();
+        // The server destroys the connections asynchronously; wait for them
+        // to no longer be counted so they don't skew the next test
+        const auto timeout =
+                std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (getTotalConnections() > initialConnections &&
+               std::chrono::steady_clock::now() < timeout) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        memcached_cfg["connection_placement"] = "round_robin";
+        reconfigure();
+        TestappClientTest::TearDown();
+    }
+
+    /// Open a new connection and check that it is served
+    void connect() {
+        connections.emplace_back(getConnection().clone());
+        auto& conn = *connections.back();
+        EXPECT_FALSE(conn.getSaslMechanisms().empty());
+        conn.authenticate("@admin", "password", "PLAIN");
+        conn.selectBucket(bucketName);
+        EXPECT_TRUE(conn.execute(BinprotGenericCommand{
+                                         cb::mcbp::ClientOpcode::Noop})
+                            .isSuccess());
+    }
+
+    /// @return the number of connections counted by each front end thread
+    std::map<std::string, size_t> getThreadConnections() {
+        std::map<std::string, size_t> ret;
+        adminConnection->stats(
+                [&ret](const std::string& key, const std::string& value) {
+                    ret[key] = std::stoul(value);
+                },
+                "worker_thread_info connections");
+        return ret;
+    }
+
+    size_t getTotalConnections() {
+        size_t total = 0;
+        for (const auto& [thread, count] : getThreadConnections()) {
+            (void)thread;
+            total += count;
+        }
+        return total;
+    }
+
+    static constexpr int NumThreads = 4;
+    static constexpr int NumConnections = NumThreads * 4;
+
+    size_t initialConnections = 0;
+    std::vector<std::unique_ptr<MemcachedConnection>> connections;
+};
+
+INSTANTIATE_TEST_SUITE_P(TransportProtocols,
+                         ConnectionPlacementTest,
+                         ::testing::Values(TransportProtocols::McbpPlain),
+                         ::testing::PrintToStringParamName());
+
+/// Test that the connections accepted by the per thread SO_REUSEPORT
+/// listening sockets of an interface are all served
+TEST_P(ConnectionPlacementTest, PerThreadListeners) {
+#ifndef __linux__
+    GTEST_SKIP() << "per_thread_listeners is only supported on Linux";
+#endif
+    const auto before = getThreadConnections();
+    ASSERT_EQ(NumThreads, before.size());
+
+    for (int ii = 0; ii < NumConnections; ++ii) {
+        connect();
+    }
+
+    // Every connection is counted by the thread serving it
+    size_t added = 0;
+    for (const auto& [thread, count] : getThreadConnections()) {
+        added += count - before.at(thread);
+    }
+    EXPECT_EQ(NumConnections, added);
+}
+
+/// Test that with least_loaded placement new connections are spread across
+/// all of the front end threads
+TEST_P(ConnectionPlacementTest, LeastLoaded) {
+    memcached_cfg["connection_placement"] = "least_loaded";
+    reconfigure();
+
+    const auto before = getThreadConnections();
+    ASSERT_EQ(NumThreads, before.size());
+
+    for (int ii = 0; ii < NumConnections; ++ii) {
+        connect();
+    }
+
+    const auto after = getThreadConnections();
+    size_t min = std::numeric_limits<size_t>::max();
+    size_t max = 0;
+    for (const auto& [thread, count] : after) {
+        EXPECT_LT(before.at(thread), count)
+                << "Thread " << thread << " was given no new connections";
+        min = std::min(min, count);
+        max = std::max(max, count);
+    }
+    // The threads are mostly idle, so the connections are close to evenly
+    // spread (a thread's connections weigh more while it is busy)
+    EXPECT_LE(max - min, 2U);
+}
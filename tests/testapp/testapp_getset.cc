@@ -17,6 +17,7 @@
 #include <memcached/limits.h>
 #include <platform/compress.h>
 #include <algorithm>
+#include <thread>
 
 class GetSetTest : public TestappXattrClientTest {
 protected:
@@ -38,8 +39,27 @@ protected:
                     std::string expectedValue);
 
     void doTestGetRandomKey(bool collections);
+
+    /// Set the size from which GET inflates a document on an executor
+    /// thread (background_inflate_threshold)
+    void setBackgroundInflateThreshold(size_t threshold) {
+        memcached_cfg["background_inflate_threshold"] = threshold;
+        reconfigure();
+    }
+
+    /// Check the connection still serves requests after a GET which
+    /// blocked on the background inflate
+    void verifyConnectionServesRequests();
 };
 
+void GetSetTest::verifyConnectionServesRequests() {
+    Document doc;
+    doc.info.id = name + "_after_inflate";
+    doc.value = "value";
+    userConnection->mutate(doc, Vbid(0), MutationType::Set);
+    EXPECT_EQ("value", userConnection->get(doc.info.id, Vbid(0)).value);
+}
+
 void GetSetTest::doTestAppend(bool compressedSource, bool compressedData) {
     // Store an initial source value; along with an XATTR to check it's
     // preserved correctly.
@@ -578,6 +598,75 @@ TEST_P(GetSetTest, TestGetSuccess) {
     EXPECT_EQ(document.value, stored.value);
 }
 
+/**
+ * A GetMulti against a pending vbucket must be parked until the vbucket
+ * leaves pending, and then return every key (not just the ones which
+ * happened to be looked up before the engine blocked).
+ */
+TEST_P(GetSetTest, TestGetMultiPendingVBucket) {
+    if (mcd_env->getTestBucket().getName() == "default_engine") {
+        GTEST_SKIP() << "default_engine has no pending vbucket state";
+    }
+
+    Document doc;
+    doc.info.cas = mcbp::cas::Wildcard;
+    doc.info.datatype = cb::mcbp::Datatype::Raw;
+    doc.info.id = name;
+    doc.value = "value";
+    userConnection->mutate(doc, Vbid(0), MutationType::Set);
+
+    auto& admin = getAdminConnection();
+    admin.selectBucket(bucketName);
+    admin.setVbucket(Vbid(0), vbucket_state_pending, {});
+
+    const std::vector<std::string> keys{name, name + "_miss"};
+    std::string value;
+    for (const auto& key : keys) {
+        cb::mcbp::request::GetMultiKeySpec spec(
+                Vbid(0), gsl::narrow<uint16_t>(key.size()));
+        value.append(spec.getBuffer());
+        value.append(key);
+    }
+    BinprotGenericCommand cmd(cb::mcbp::ClientOpcode::GetMulti);
+    cmd.setValue(std::move(value));
+    userConnection->sendCommand(cmd);
+
+    // Wait for the command to be parked on the vbucket before activating it
+    const auto deadline =
+            std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (admin.stats("")["ep_pending_ops"].get<size_t>() == 0) {
+        ASSERT_LT(std::chrono::steady_clock::now(), deadline)
+                << "Timed out waiting for GetMulti to block";
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    admin.setVbucket(Vbid(0), vbucket_state_active, {});
+
+    BinprotResponse rsp;
+    userConnection->recvResponse(rsp);
+    ASSERT_TRUE(rsp.isSuccess()) << to_string(rsp.getStatus());
+
+    using cb::mcbp::response::GetMultiEntryHeader;
+    const auto payload = rsp.getDataString();
+    std::string_view remaining = payload;
+    std::vector<std::pair<cb::mcbp::Status, std::string>> entries;
+    while (!remaining.empty()) {
+        ASSERT_LE(sizeof(GetMultiEntryHeader), remaining.size());
+        const auto* header =
+                reinterpret_cast<const GetMultiEntryHeader*>(remaining.data());
+        remaining.remove_prefix(sizeof(GetMultiEntryHeader));
+        ASSERT_LE(header->getValuelen(), remaining.size());
+        entries.emplace_back(
+                header->getStatus(),
+                std::string(remaining.substr(0, header->getValuelen())));
+        remaining.remove_prefix(header->getValuelen());
+    }
+
+    ASSERT_EQ(keys.size(), entries.size());
+    EXPECT_EQ(cb::mcbp::Status::Success, entries[0].first);
+    EXPECT_EQ("value", entries[0].second);
+    EXPECT_EQ(cb::mcbp::Status::KeyEnoent, entries[1].first);
+}
+
 TEST_P(GetSetTest, TestAppend) {
     document.info.datatype = cb::mcbp::Datatype::Raw;
     document.value = "a";
@@ -1176,3 +1265,55 @@ TEST_P(GetSetTest, TestGetRandomKey) {
 TEST_P(GetSetTest, TestGetRandomKeyCollections) {
     doTestGetRandomKey(true);
 }
+
+// Test that a Snappy document above background_inflate_threshold is inflated
+// (on an executor thread) for a client which hasn't enabled Snappy.
+TEST_P(GetSetTest, TestBackgroundInflateForNonSnappyClient) {
+    setCompressionMode("passive"); // So server doesn't immediately inflate.
+    setBackgroundInflateThreshold(1024);
+
+    const std::string valueData(4096, 'a');
+    document.info.datatype = cb::mcbp::Datatype::Raw;
+    document.value = valueData;
+    document.compress();
+    userConnection->mutate(document, Vbid(0), MutationType::Set);
+
+    userConnection->setFeature(cb::mcbp::Feature::SNAPPY, false);
+    const auto stored = userConnection->get(name, Vbid(0));
+    EXPECT_TRUE(hasCorrectDatatype(stored, cb::mcbp::Datatype::Raw));
+    EXPECT_EQ(valueData, stored.value);
+
+    verifyConnectionServesRequests();
+
+    // reset the features
+    prepare(*userConnection);
+    setBackgroundInflateThreshold(1024 * 1024);
+}
+
+// Test that the XATTRs of a Snappy document above
+// background_inflate_threshold are stripped after it is inflated (on an
+// executor thread), even for a client which has enabled Snappy.
+TEST_P(GetSetTest, TestBackgroundInflateStripsXattrs) {
+    if (!mcd_env->getTestBucket().supportsOp(
+                cb::mcbp::ClientOpcode::SetWithMeta)) {
+        GTEST_SKIP() << "Can't store a compressed document with XATTRs";
+    }
+    setCompressionMode("passive"); // So server doesn't immediately inflate.
+    setBackgroundInflateThreshold(1024);
+
+    const std::string body(4096, 'a');
+    setBodyAndXattr(body, {{"xattr", "\"X-value\""}}, true);
+
+    const auto stored = userConnection->get(name, Vbid(0));
+    EXPECT_EQ(0,
+              int(stored.info.datatype) & (int(cb::mcbp::Datatype::Xattr) |
+                                           int(cb::mcbp::Datatype::Snappy)));
+    EXPECT_EQ(body, stored.value);
+
+    // The XATTRs are still stored
+    EXPECT_EQ("\"X-value\"", getXattr("xattr").getValue());
+
+    verifyConnectionServesRequests();
+
+    setBackgroundInflateThreshold(1024 * 1024);
+}
@@ -499,3 +499,92 @@ TEST_P(RbacRoleTest, DontAutoselectBucket) {
 
     adminConnection->deleteBucket("larry");
 }
+
+/**
+ * A range scan may only be continued or cancelled by the connection which
+ * created it, while it has the Read privilege for the scanned collection.
+ */
+class RangeScanRbacTest : public RbacTest {
+protected:
+    void SetUp() override {
+        RbacTest::SetUp();
+        if (mcd_env->getTestBucket().getName() == "default_engine") {
+            GTEST_SKIP() << "default_engine doesn't support range scans";
+        }
+        Document doc;
+        doc.info.cas = mcbp::cas::Wildcard;
+        doc.info.datatype = cb::mcbp::Datatype::Raw;
+        doc.info.id = name;
+        doc.value = "value";
+        userConnection->mutate(doc, Vbid(0), MutationType::Set);
+    }
+
+    cb::mcbp::request::RangeScanId createScan(MemcachedConnection& conn) {
+        BinprotGenericCommand cmd(cb::mcbp::ClientOpcode::RangeScanCreate);
+        cmd.setValue(R"({"key_only": true})");
+        const auto rsp = conn.execute(cmd);
+        cb::mcbp::request::RangeScanId id{};
+        EXPECT_TRUE(rsp.isSuccess()) << to_string(rsp.getStatus());
+        const auto data = rsp.getData();
+        EXPECT_EQ(id.size(), data.size());
+        std::copy_n(data.begin(), std::min(id.size(), data.size()), id.begin());
+        return id;
+    }
+
+    static BinprotResponse continueScan(
+            MemcachedConnection& conn,
+            const cb::mcbp::request::RangeScanId& id) {
+        const cb::mcbp::request::RangeScanContinuePayload payload(id, 0, 0, 0);
+        BinprotGenericCommand cmd(cb::mcbp::ClientOpcode::RangeScanContinue);
+        cmd.setExtras(std::string_view{reinterpret_cast<const char*>(&payload),
+                                       sizeof(payload)});
+        return conn.execute(cmd);
+    }
+
+    static BinprotResponse cancelScan(
+            MemcachedConnection& conn,
+            const cb::mcbp::request::RangeScanId& id) {
+        BinprotGenericCommand cmd(cb::mcbp::ClientOpcode::RangeScanCancel);
+        cmd.setExtras(std::string_view{reinterpret_cast<const char*>(id.data()),
+                                       id.size()});
+        return conn.execute(cmd);
+    }
+};
+
+INSTANTIATE_TEST_SUITE_P(TransportProtocols,
+                         RangeScanRbacTest,
+                         ::testing::Values(TransportProtocols::McbpPlain),
+                         ::testing::PrintToStringParamName());
+
+TEST_P(RangeScanRbacTest, OtherConnectionRefused) {
+    const auto id = createScan(*userConnection);
+
+    // The same user on another connection can't see the scan
+    auto other = userConnection->clone();
+    other->authenticate("Luke", mcd_env->getPassword("Luke"));
+    other->selectBucket(bucketName);
+    EXPECT_EQ(cb::mcbp::Status::KeyEnoent,
+              continueScan(*other, id).getStatus());
+    EXPECT_EQ(cb::mcbp::Status::KeyEnoent, cancelScan(*other, id).getStatus());
+
+    // The scan is still there for its own connection
+    EXPECT_EQ(cb::mcbp::Status::Success,
+              cancelScan(*userConnection, id).getStatus());
+}
+
+TEST_P(RangeScanRbacTest, NoReadPrivilegeRefused) {
+    const auto id = createScan(*userConnection);
+
+    userConnection->dropPrivilege(cb::rbac::Privilege::Read);
+    EXPECT_EQ(cb::mcbp::Status::Eaccess,
+              continueScan(*userConnection, id).getStatus());
+    EXPECT_EQ(cb::mcbp::Status::Eaccess,
+              cancelScan(*userConnection, id).getStatus());
+
+    // Reconnect to get the privilege back (the disconnect cancels the scan)
+    userConnection->reconnect();
+    userConnection->authenticate("Luke", mcd_env->getPassword("Luke"));
+    userConnection->selectBucket(bucketName);
+    EXPECT_EQ(cb::mcbp::Status::KeyEnoent,
+              cancelScan(*userConnection, id).getStatus());
+}
@@ -11,9 +11,12 @@
 
 #include "hdrhistogram.h"
 
+#include <folly/SpinLock.h>
+#include <folly/lang/Aligned.h>
 #include <folly/lang/Assume.h>
 #include <nlohmann/json.hpp>
 #include <platform/cb_malloc.h>
+#include <platform/corestore.h>
 #include <spdlog/fmt/fmt.h>
 #include <iostream>
 #include <optional>
@@ -24,19 +27,60 @@ void HdrHistogram::HdrDeleter::operator()(struct hdr_histogram* val) {
     hdr_close_ex(val, cb_free);
 }
 
+struct HdrHistogram::Shards {
+    Shards(uint64_t lowestDiscernibleValue,
+           int64_t highestTrackableValue,
+           int significantFigures)
+        : lowestDiscernibleValue(lowestDiscernibleValue),
+          highestTrackableValue(highestTrackableValue),
+          significantFigures(significantFigures) {
+    }
+
+    /// Record the value(s) into the calling core's shard.
+    bool record(uint64_t v, uint64_t count) {
+        auto shard = perCore.get()->lock();
+        if (!*shard) {
+            // Only allocate shards for cores which actually record values.
+            *shard = HdrHistogram::create(lowestDiscernibleValue,
+                                          highestTrackableValue,
+                                          significantFigures);
+        }
+        return hdr_record_values(shard->get(), v, count);
+    }
+
+    // Parameters the shards are created with.
+    const uint64_t lowestDiscernibleValue;
+    const int64_t highestTrackableValue;
+    const int significantFigures;
+
+    // A shard's lock is only contended when its core is preempted mid-record
+    // or while the shards are being folded by a reader.
+    using Shard = folly::Synchronized<HdrHistogramPtr, folly::SpinLock>;
+    CoreStore<folly::cacheline_aligned<Shard>> perCore;
+};
+
 HdrHistogram::HdrHistogram(uint64_t lowestDiscernibleValue,
                            int64_t highestTrackableValue,
                            int significantFigures,
-                           Iterator::IterMode iterMode)
+                           Iterator::IterMode iterMode,
+                           Recording recording)
     : defaultIterationMode(iterMode) {
     auto handle = histogram.wlock();
     resize(handle,
            lowestDiscernibleValue,
            highestTrackableValue,
            significantFigures);
+    if (recording == Recording::Sharded) {
+        shards = std::make_unique<Shards>(lowestDiscernibleValue,
+                                          highestTrackableValue,
+                                          significantFigures);
+    }
 }
 
+HdrHistogram::~HdrHistogram() = default;
+
 HdrHistogram& HdrHistogram::operator+=(const HdrHistogram& other) {
+    other.foldShards();
     /*
      * Note: folly::acquireLockedPair() takes an exclusive lock on
      * this->histogram as we pass it a non-const ref. Where as it takes a shared
@@ -90,35 +134,71 @@ HdrHistogram& HdrHistogram::operator=(const HdrHistogram& other) {
 }
 
 bool HdrHistogram::addValue(uint64_t v) {
+    if (shards) {
+        return shards->record(v, 1);
+    }
     return hdr_record_value(histogram.rlock()->get(), v);
 }
 
 bool HdrHistogram::addValueAndCount(uint64_t v, uint64_t count) {
+    if (shards) {
+        return shards->record(v, count);
+    }
     return hdr_record_values(histogram.rlock()->get(), v, count);
 }
 
 uint64_t HdrHistogram::getValueCount() const {
+    foldShards();
     return static_cast<uint64_t>(histogram.rlock()->get()->total_count);
 }
 
 uint64_t HdrHistogram::getMinValue() const {
+    foldShards();
     return static_cast<uint64_t>(hdr_min(histogram.rlock()->get()));
 }
 
 uint64_t HdrHistogram::getMaxValue() const {
+    foldShards();
     return static_cast<uint64_t>(hdr_max(histogram.rlock()->get()));
 }
 
 void HdrHistogram::reset() {
-    hdr_reset(histogram.wlock()->get());
+    auto histoLockPtr = histogram.wlock();
+    hdr_reset(histoLockPtr->get());
+    if (shards) {
+        for (auto& shard : shards->perCore) {
+            auto shardLockPtr = shard->lock();
+            if (*shardLockPtr) {
+                hdr_reset(shardLockPtr->get());
+            }
+        }
+    }
 }
 
 uint64_t HdrHistogram::getValueAtPercentile(double percentage) const {
+    foldShards();
     return hdr_value_at_percentile(histogram.rlock()->get(), percentage);
 }
 
+void HdrHistogram::foldShards() const {
+    if (!shards) {
+        return;
+    }
+    // Folding moves values from the shards into the histogram without
+    // changing the (logical) contents, so is permitted on a const histogram.
+    auto histoLockPtr = const_cast<SyncHdrHistogramPtr&>(histogram).wlock();
+    for (auto& shard : shards->perCore) {
+        auto shardLockPtr = shard->lock();
+        if (*shardLockPtr && (*shardLockPtr)->total_count > 0) {
+            hdr_add(histoLockPtr->get(), shardLockPtr->get());
+            hdr_reset(shardLockPtr->get());
+        }
+    }
+}
+
 HdrHistogram::Iterator HdrHistogram::makeLinearIterator(
         int64_t valueUnitsPerBucket) const {
+    foldShards();
     HdrHistogram::Iterator itr(histogram, Iterator::IterMode::Linear);
     hdr_iter_linear_init(&itr, itr.histoRLockPtr->get(), valueUnitsPerBucket);
     // hdr_histogram requires hdr_iter_next to be called before reading any
@@ -130,6 +210,7 @@ HdrHistogram::Iterator HdrHistogram::makeLinearIterator(
 
 HdrHistogram::Iterator HdrHistogram::makeLogIterator(int64_t firstBucketWidth,
                                                      double log_base) const {
+    foldShards();
     HdrHistogram::Iterator itr(histogram, Iterator::IterMode::Log);
     hdr_iter_log_init(
             &itr, itr.histoRLockPtr->get(), firstBucketWidth, log_base);
@@ -139,6 +220,7 @@ HdrHistogram::Iterator HdrHistogram::makeLogIterator(int64_t firstBucketWidth,
 
 HdrHistogram::Iterator HdrHistogram::makePercentileIterator(
         uint32_t ticksPerHalfDist) const {
+    foldShards();
     HdrHistogram::Iterator itr(histogram, Iterator::IterMode::Percentiles);
     hdr_iter_percentile_init(&itr, itr.histoRLockPtr->get(), ticksPerHalfDist);
 
@@ -146,6 +228,7 @@ HdrHistogram::Iterator HdrHistogram::makePercentileIterator(
 }
 
 HdrHistogram::Iterator HdrHistogram::makeRecordedIterator() const {
+    foldShards();
     HdrHistogram::Iterator itr(histogram, Iterator::IterMode::Recorded);
     hdr_iter_recorded_init(&itr, itr.histoRLockPtr->get());
 
@@ -195,6 +278,7 @@ std::string HdrHistogram::Iterator::dumpValues() {
 }
 
 void HdrHistogram::printPercentiles() const {
+    foldShards();
     hdr_percentiles_print(histogram.rlock()->get(), stdout, 5, 1.0, CLASSIC);
 }
 
@@ -384,17 +468,30 @@ std::string HdrHistogram::to_string() const {
 }
 
 size_t HdrHistogram::getMemFootPrint() const {
-    return hdr_get_memory_size(histogram.rlock()->get()) + sizeof(HdrHistogram);
+    auto size = hdr_get_memory_size(histogram.rlock()->get()) +
+                sizeof(HdrHistogram);
+    if (shards) {
+        size += sizeof(Shards);
+        for (auto& shard : shards->perCore) {
+            size += sizeof(shard);
+            auto shardLockPtr = shard->lock();
+            if (*shardLockPtr) {
+                size += hdr_get_memory_size(shardLockPtr->get());
+            }
+        }
+    }
+    return size;
 }
 
 double HdrHistogram::getMean() const {
+    foldShards();
     return hdr_mean(histogram.rlock()->get());
 }
 
-void HdrHistogram::resize(WHistoLockedPtr& histoLockPtr,
-                          uint64_t lowestDiscernibleValue,
-                          int64_t highestTrackableValue,
-                          int significantFigures) {
+HdrHistogram::HdrHistogramPtr HdrHistogram::create(
+        uint64_t lowestDiscernibleValue,
+        int64_t highestTrackableValue,
+        int significantFigures) {
     // hdr_init_ex will also check but will just return EINVAL. Check here
     // first so we can generate amore useful exception message, as this could be
     // a common mistake when adding a new histogram
@@ -424,12 +521,21 @@ void HdrHistogram::resize(WHistoLockedPtr& histoLockPtr,
                             highestTrackableValue,
                             significantFigures));
     }
+    return HdrHistogramPtr(hist);
+}
+
+void HdrHistogram::resize(WHistoLockedPtr& histoLockPtr,
+                          uint64_t lowestDiscernibleValue,
+                          int64_t highestTrackableValue,
+                          int significantFigures) {
+    auto hist = create(
+            lowestDiscernibleValue, highestTrackableValue, significantFigures);
 
     if (*histoLockPtr) {
-        hdr_add(hist, histoLockPtr->get());
+        hdr_add(hist.get(), histoLockPtr->get());
     }
 
-    histoLockPtr->reset(hist);
+    *histoLockPtr = std::move(hist);
 }
 
 std::ostream& operator<<(std::ostream& os,
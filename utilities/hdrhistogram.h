@@ -47,12 +47,34 @@ class HdrHistogram {
         void operator()(struct hdr_histogram* val);
     };
 
-    using SyncHdrHistogramPtr = folly::Synchronized<
-            std::unique_ptr<struct hdr_histogram, HdrDeleter>>;
+    using HdrHistogramPtr = std::unique_ptr<struct hdr_histogram, HdrDeleter>;
+    using SyncHdrHistogramPtr = folly::Synchronized<HdrHistogramPtr>;
     using ConstRHistoLockedPtr = SyncHdrHistogramPtr::ConstRLockedPtr;
     using WHistoLockedPtr = SyncHdrHistogramPtr::WLockedPtr;
 
+    // Per-core shards values are recorded into (see Recording::Sharded).
+    struct Shards;
+
 public:
+    /**
+     * How values added to the histogram are recorded.
+     */
+    enum class Recording : uint8_t {
+        /// Values are recorded directly into the histogram.
+        Direct,
+        /**
+         * Values are recorded into a per-core shard of the histogram, and the
+         * shards are folded into the histogram whenever it is read (counts,
+         * percentiles, iterators, aggregation...).
+         *
+         * Writers never touch the histogram's lock (or each other's cache
+         * lines), which is significant for histograms many threads record
+         * into on a hot path; the cost is the memory for one shard per core
+         * which has recorded a value, and more expensive reads.
+         */
+        Sharded,
+    };
+
     /**
      * Class representing a single histogram bucket.
      *
@@ -213,16 +235,21 @@ public:
      *        between 1 and 5 (inclusive).
      * @param iterMode sets the default iteration mode that should be used
      *        when iterate though this histogram's data.
+     * @param recording how values added to the histogram are recorded.
      */
     HdrHistogram(uint64_t lowestDiscernibleValue,
                  int64_t highestTrackableValue,
                  int significantFigures,
-                 Iterator::IterMode iterMode = Iterator::IterMode::Recorded);
+                 Iterator::IterMode iterMode = Iterator::IterMode::Recorded,
+                 Recording recording = Recording::Direct);
 
     HdrHistogram() : HdrHistogram(1, 1, 1){};
 
+    ~HdrHistogram();
+
     /**
-     * Copy constructor to define how to do a deep copy of a HdrHistogram
+     * Copy constructor to define how to do a deep copy of a HdrHistogram.
+     * The copy records values directly, regardless of how other does.
      * @param other other HdrHistogram to copy
      */
     HdrHistogram(const HdrHistogram& other)
@@ -287,6 +314,9 @@ public:
      * underlying data structure and will wait till all read locks have been
      * released before completing and thus, could result in dead lock
      * situations.
+     * The same applies to every read of a Recording::Sharded histogram, as
+     * the shards are folded in under the write lock; don't read such a
+     * histogram while holding an Iterator over it.
      */
     void reset();
 
@@ -482,6 +512,15 @@ public:
     double getMean() const;
 
 private:
+    /**
+     * Allocate a hdr_histogram with the given parameters.
+     * @throws std::invalid_argument / std::system_error if the parameters are
+     *         invalid.
+     */
+    static HdrHistogramPtr create(uint64_t lowestDiscernibleValue,
+                                  int64_t highestTrackableValue,
+                                  int significantFigures);
+
     void resize(WHistoLockedPtr& histoLockPtr,
                 uint64_t lowestDiscernibleValue,
                 int64_t highestTrackableValue,
@@ -554,6 +593,12 @@ private:
      */
     Iterator getHistogramsIterator() const;
 
+    /**
+     * Move any values recorded into the per-core shards into the histogram
+     * (no-op for Recording::Direct).
+     */
+    void foldShards() const;
+
     /**
      * Variable used to store the default iteration mode of a given histogram.
      */
@@ -563,6 +608,11 @@ private:
      * Synchronized unique pointer to a struct hdr_histogram
      */
     SyncHdrHistogramPtr histogram;
+
+    /**
+     * Per-core shards for a Recording::Sharded histogram, null otherwise.
+     */
+    std::unique_ptr<Shards> shards;
 };
 
 std::ostream& operator<<(std::ostream&,
@@ -576,6 +626,9 @@ class Hdr1sfMicroSecHistogram : public HdrHistogram {
 public:
     Hdr1sfMicroSecHistogram()
         : HdrHistogram(1, 60000000, 1, Iterator::IterMode::Percentiles){};
+    explicit Hdr1sfMicroSecHistogram(Recording recording)
+        : HdrHistogram(
+                  1, 60000000, 1, Iterator::IterMode::Percentiles, recording){};
     bool add(std::chrono::microseconds v, size_t count = 1) {
         return addValueAndCount(static_cast<uint64_t>(v.count()),
                                 static_cast<uint64_t>(count));